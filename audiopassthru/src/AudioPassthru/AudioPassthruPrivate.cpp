@@ -472,7 +472,7 @@ DWORD AudioPassthruPrivate::threadWorker(void)
 				// Apply DFX processing here using data and format vars above. Format will always be 32 bit floating point.
 			//	if (dfxpUniversalModifySamples(cast_handle->dfxp_hdl, (short int *)fp_buffer, (short int *)fp_buffer, numSampleSets, i_check_for_duplicate_buffers) != OKAY)
 				//	return(NOT_OKAY);
-				p_dfx_dsp_->processAudio((short int *)fp_buffer, (short int *)fp_buffer, numSampleSets, i_check_for_duplicate_buffers);
+				p_dfx_dsp_->processAudio(fp_buffer, numSampleSets, i_check_for_duplicate_buffers);
 			}
 
 			/* Check if thread has been signaled to end */
@@ -370,6 +370,7 @@ int PT_DECLSPEC mthConvertRealtypeBufTo16BitIntBufWithClipping(int i_length, rea
  *  For converting a realtype buffer to a specified precision integer buffer.
  *  Note that this version assumes the real values have already
  *  been limited to +/- 1 and does not clip the real before conversion.
+ *  The 16 bit case does saturate, a full scale +1.0 would otherwise wrap to -32768.
  *
  * 
  */
@@ -387,7 +388,14 @@ int PT_DECLSPEC mthConvertRealtypeBufToIntBuf(int i_length, int i_bit_width, int
 	case 16:
 		for(i=0; i<i_length; i++)
 		{
-			sp_buf[i] = (short int)(rp_buf[i] * (float)MTH_16_BIT_REAL_CONVERSION_FACTOR);
+			float r_tmp = rp_buf[i] * (float)MTH_16_BIT_REAL_CONVERSION_FACTOR;
+
+			if( r_tmp >= 32767.0f )
+				sp_buf[i] = 32767;
+			else if( r_tmp <= -32768.0f )
+				sp_buf[i] = -32768;
+			else
+				sp_buf[i] = (short int)r_tmp;
 		}
 		break;
 
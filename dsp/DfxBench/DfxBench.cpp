@@ -0,0 +1,1044 @@
+/*
+FxSound
+Copyright (C) 2025  FxSound LLC
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/* DfxBench.cpp */
+
+/*
+ * Per-stage micro benchmarks for the processing chain in dfxpModifyRealtypeSamples().
+ *
+ *   DfxBench [-quick] [-csv] [-scalar] [-denormals] [-time msecs] [stage filter]
+ *   DfxBench -check [check filter]
+ *
+ * Every stage is swept over buffer size, channel count and sampling rate. Each case
+ * is timed per buffer call, the input is refreshed outside the timed region so every
+ * call sees the same signal. Results are the median and peak time per buffer call,
+ * ns per frame and the load as a percentage of the buffer's real time period.
+ *
+ * The tail stages instead feed a decaying burst followed by silence for a fixed length
+ * of audio, so the filter and reverb states fade through the denormal range while timed.
+ * Their peak shows any cpu spike, run with -denormals to compare against no FTZ/DAZ.
+ *
+ * -check runs the checks instead, which compare a stage against a reference within a stated
+ * tolerance. The exit code is 1 if any of them fails.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+#include "codedefs.h"
+#include "pt_defs.h"
+#include "dfxpDefs.h"
+#include "mth.h"
+#include "com.h"
+#include "GraphicEq.h"
+#include "sos.h"
+#include "BinauralSyn.h"
+#include "spectrum.h"
+#include "realSample.h"
+#include "DfxDsp.h"
+
+extern "C" {
+#include "comSftwr.h"
+#include "c_dsps.h"
+#include "c_max.h"
+}
+
+#define DFX_BENCH_MAX_FRAMES           16384
+#define DFX_BENCH_MAX_CHANNELS         8
+#define DFX_BENCH_DEFAULT_MSECS        100
+#define DFX_BENCH_MIN_ITERATIONS       10
+#define DFX_BENCH_WARMUP_ITERATIONS    3
+
+/* Tail stages, a burst decaying by 80 dB then silence, long enough for the lex reverb to reach denormals */
+#define DFX_BENCH_TAIL_SECS            30.0
+#define DFX_BENCH_TAIL_BURST_SECS      0.5
+#define DFX_BENCH_TAIL_BURST_DECAY     1.0e-4
+
+/* Same internal rate limits as dfxpBeginProcess() */
+#define DFX_BENCH_MAX_INTERNAL_SAMP_FREQ 48000
+#define DFX_BENCH_MAX_SAMP_FREQ          192000
+
+static const int dfxBench_frames[] = { 64, 128, 256, 512, 1024, 2048, 4096, 8192, 16384 };
+static const int dfxBench_quick_frames[] = { 256, 1024, 4096 };
+static const int dfxBench_channels[] = { 1, 2, 6, 8 };
+static const int dfxBench_rates[] = { 44100, 48000, 88200, 96000, 176400, 192000 };
+static const int dfxBench_quick_rates[] = { 44100, 96000, 192000 };
+
+#define DFX_BENCH_ARRAY_SIZE(a) ((int)(sizeof(a)/sizeof((a)[0])))
+
+/* One benchmark case, created per frames/channels/rate combination */
+struct dfxBenchCase {
+	int num_frames;
+	int num_channels;
+	int samp_freq;
+	int internal_rate_ratio;
+
+	std::vector<realtype> source;   /* Interleaved test signal */
+	std::vector<realtype> work;     /* Processed in place */
+	std::vector<short int> int_buf; /* For the int converters, sized for 32 bit samples */
+
+	/* Stage specific state */
+	PT_HANDLE *hp_stage;
+	PT_HANDLE *hp_com[5];
+	std::vector<float> kernel_params;
+	std::vector<float> kernel_state;
+	std::vector<float> kernel_memory;
+	DfxDsp *dfx_dsp;
+	int bits;
+	long tail_frames; /* Frames fed so far by the tail stages */
+};
+
+/* A stage under test. setup returns IS_FALSE if the combination does not apply to the stage */
+struct dfxBenchStage {
+	const char *name;
+	int (*setup)(struct dfxBenchCase *);
+	int (*run)(struct dfxBenchCase *);
+	void (*teardown)(struct dfxBenchCase *);
+	int (*prepare)(struct dfxBenchCase *); /* Untimed, called before each run, NULL copies source to work */
+	double tail_secs; /* Audio length run by the tail stages in place of the measuring time, 0 for the others */
+};
+
+static int dfxBench_InternalRateRatio(int i_samp_freq)
+{
+	if (i_samp_freq <= DFX_BENCH_MAX_INTERNAL_SAMP_FREQ)
+		return(1);
+	if (i_samp_freq < DFX_BENCH_MAX_SAMP_FREQ)
+		return(2);
+	return(4);
+}
+
+/*
+ * FUNCTION: dfxBench_FillSignal()
+ * DESCRIPTION:
+ *   Deterministic test signal, a log swept sine per channel plus low level noise, about -12 dBFS.
+ *   Avoids both silence and denormals so the steady state cost is measured.
+ */
+static void dfxBench_FillSignal(std::vector<realtype> &signal, int i_num_frames, int i_num_channels, int i_samp_freq)
+{
+	unsigned long ul_seed = 0x12345678UL;
+
+	signal.resize(i_num_frames * i_num_channels);
+
+	for (int i = 0; i < i_num_frames; i++)
+	{
+		double d_t = (double)i / (double)i_samp_freq;
+		double d_phase = 2.0 * 3.14159265358979 * 40.0 * 100.0 * (pow(100.0, d_t) - 1.0) / log(100.0);
+
+		for (int ch = 0; ch < i_num_channels; ch++)
+		{
+			ul_seed = ul_seed * 1664525UL + 1013904223UL;
+			double d_noise = ((double)((ul_seed >> 8) & 0xFFFF) / 32768.0 - 1.0) * 0.01;
+
+			signal[i * i_num_channels + ch] = (realtype)(0.25 * sin(d_phase + ch) + d_noise);
+		}
+	}
+}
+
+static int dfxBench_Refresh(struct dfxBenchCase *sp_case)
+{
+	std::copy(sp_case->source.begin(), sp_case->source.end(), sp_case->work.begin());
+	return(OKAY);
+}
+
+/*
+ * FUNCTION: dfxBench_TailPrepare()
+ * DESCRIPTION:
+ *   Input for the tail stages, the test signal under an exponential decay for the first
+ *   DFX_BENCH_TAIL_BURST_SECS of the run, then silence.
+ */
+static int dfxBench_TailPrepare(struct dfxBenchCase *sp_case)
+{
+	long l_burst_frames = (long)(DFX_BENCH_TAIL_BURST_SECS * (double)sp_case->samp_freq);
+	double d_decay = log(DFX_BENCH_TAIL_BURST_DECAY) / (double)l_burst_frames;
+
+	for (int i = 0; i < sp_case->num_frames; i++, sp_case->tail_frames++)
+	{
+		realtype r_gain = (realtype)0.0;
+
+		if (sp_case->tail_frames < l_burst_frames)
+			r_gain = (realtype)exp(d_decay * (double)sp_case->tail_frames);
+
+		for (int ch = 0; ch < sp_case->num_channels; ch++)
+			sp_case->work[i * sp_case->num_channels + ch] = sp_case->source[i * sp_case->num_channels + ch] * r_gain;
+	}
+
+	return(OKAY);
+}
+
+/* Graphic EQ, dispatches to sosProcessBuffer() or sosProcessSurroundBuffer() */
+static int dfxBench_EqSetup(struct dfxBenchCase *sp_case)
+{
+	if ((sp_case->num_channels != 1) && (sp_case->num_channels != 2) && (sp_case->num_channels != 6) && (sp_case->num_channels != 8))
+		return(IS_FALSE);
+
+	if (GraphicEqNew(&(sp_case->hp_stage), DFXP_GRAPHIC_EQ_NUM_BANDS, IS_FALSE, NULL) != OKAY)
+		return(IS_FALSE);
+	GraphicEqSetAppHasHyperBassMode(sp_case->hp_stage, true);
+
+	/* Non flat curve so no section is skipped */
+	for (int band = 0; band < DFXP_GRAPHIC_EQ_NUM_BANDS; band++)
+		GraphicEqSetBandBoostCut(sp_case->hp_stage, band, (realtype)((band % 2) ? 3.0 : -2.0));
+
+	return(IS_TRUE);
+}
+
+static int dfxBench_EqRun(struct dfxBenchCase *sp_case)
+{
+	return(GraphicEqProcess(sp_case->hp_stage, &sp_case->work[0], &sp_case->work[0], sp_case->num_frames,
+		sp_case->num_channels, (realtype)sp_case->samp_freq));
+}
+
+static void dfxBench_EqTeardown(struct dfxBenchCase *sp_case)
+{
+	GraphicEqFreeUp(&(sp_case->hp_stage));
+}
+
+/* Binaural headphone processing, runs at the full device rate */
+static int dfxBench_BinauralSetup(struct dfxBenchCase *sp_case)
+{
+	if ((sp_case->num_channels != 2) && (sp_case->num_channels != 6) && (sp_case->num_channels != 8))
+		return(IS_FALSE);
+
+	if (BinauralSynNew(&(sp_case->hp_stage), BINAURAL_SYN_DEFAULT_NUM_COEFFS) != OKAY)
+		return(IS_FALSE);
+
+	return(IS_TRUE);
+}
+
+/* Same, with the original per sample direct convolution for comparison */
+static int dfxBench_BinauralSetupDirect(struct dfxBenchCase *sp_case)
+{
+	if (dfxBench_BinauralSetup(sp_case) != IS_TRUE)
+		return(IS_FALSE);
+
+	BinauralSynSetProcessingMode(sp_case->hp_stage, BINAURAL_SYN_MODE_DIRECT);
+
+	return(IS_TRUE);
+}
+
+static int dfxBench_BinauralRun(struct dfxBenchCase *sp_case)
+{
+	if (sp_case->num_channels == 2)
+		return(BinauralSynProcessStereoFormat(sp_case->hp_stage, &sp_case->work[0], sp_case->samp_freq,
+			sp_case->num_frames, &sp_case->work[0]));
+
+	return(BinauralSynProcessSurroundFormatWindowsOrdering(sp_case->hp_stage, sp_case->num_channels, sp_case->samp_freq,
+		&sp_case->work[0], sp_case->num_frames, &sp_case->work[0]));
+}
+
+static void dfxBench_BinauralTeardown(struct dfxBenchCase *sp_case)
+{
+	BinauralSynFreeUp(&(sp_case->hp_stage));
+}
+
+/*
+ * Com kernels, run through comProcessWaveBuffer() exactly as dfxpModifyRealtypeSamples() does.
+ * Surround cases use the engine's planar channel groups: front pair, center, sub, rear pair, side pair.
+ * The signal is treated as already reordered, reordering itself is not part of this stage.
+ */
+static const char *dfxBench_com_name;
+
+static int dfxBench_ComGroupChannels(int i_num_channels, int i_group)
+{
+	static const int group_channels[5] = { 2, 1, 1, 2, 2 };
+
+	if (i_num_channels <= 2)
+		return((i_group == 0) ? i_num_channels : 0);
+	if ((i_num_channels == 6) && (i_group == 4))
+		return(0);
+	if ((i_num_channels != 6) && (i_num_channels != 8))
+		return(0);
+
+	return(group_channels[i_group]);
+}
+
+static int dfxBench_ComSetup(struct dfxBenchCase *sp_case)
+{
+	char cp_dsp_dirpath[64] = "";
+	realtype r_internal_freq = (realtype)sp_case->samp_freq / (realtype)sp_case->internal_rate_ratio;
+
+	if ((sp_case->num_channels != 1) && (sp_case->num_channels != 2) && (sp_case->num_channels != 6) && (sp_case->num_channels != 8))
+		return(IS_FALSE);
+
+	for (int group = 0; group < 5; group++)
+	{
+		int i_group_channels = dfxBench_ComGroupChannels(sp_case->num_channels, group);
+
+		sp_case->hp_com[group] = NULL;
+		if (i_group_channels == 0)
+			continue;
+
+		if (comInit(&(sp_case->hp_com[group]), IS_TRUE, 0, 1, 0L, cp_dsp_dirpath, 0, NULL) != OKAY)
+			return(IS_FALSE);
+
+		if (comSoftDspLoadAndRunNonShared(sp_case->hp_com[group], (char *)dfxBench_com_name, r_internal_freq,
+			(i_group_channels == 2) ? IS_TRUE : IS_FALSE, (short)32) != OKAY)
+			return(IS_FALSE);
+	}
+
+	return(IS_TRUE);
+}
+
+static int dfxBench_ComRun(struct dfxBenchCase *sp_case)
+{
+	realtype tmp_float;
+	realtype *rp_channels = &sp_case->work[0];
+
+	for (int group = 0; group < 5; group++)
+	{
+		int i_group_channels = dfxBench_ComGroupChannels(sp_case->num_channels, group);
+		int i_stereo = (i_group_channels == 2) ? IS_TRUE : IS_FALSE;
+
+		if (i_group_channels == 0)
+			continue;
+
+		if (comProcessWaveBuffer(sp_case->hp_com[group], (long *)rp_channels, &tmp_float, (long)sp_case->num_frames,
+			i_stereo, i_stereo, sp_case->internal_rate_ratio, (int)COM_32_BIT_FLOAT_SAMPLES) != OKAY)
+			return(NOT_OKAY_NO_BREAK);
+
+		rp_channels += i_group_channels * sp_case->num_frames;
+	}
+
+	return(OKAY);
+}
+
+static void dfxBench_ComTeardown(struct dfxBenchCase *sp_case)
+{
+	for (int group = 0; group < 5; group++)
+		if (sp_case->hp_com[group] != NULL)
+			comFreeUp(&(sp_case->hp_com[group]));
+}
+
+static int dfxBench_ComSetupPlay(struct dfxBenchCase *sp_case)   { dfxBench_com_name = "ply0"; return(dfxBench_ComSetup(sp_case)); }
+static int dfxBench_ComSetupAural(struct dfxBenchCase *sp_case)  { dfxBench_com_name = "aural0"; return(dfxBench_ComSetup(sp_case)); }
+static int dfxBench_ComSetupLex(struct dfxBenchCase *sp_case)    { dfxBench_com_name = "lex0"; return(dfxBench_ComSetup(sp_case)); }
+static int dfxBench_ComSetupWide(struct dfxBenchCase *sp_case)   { dfxBench_com_name = "wid0"; return(dfxBench_ComSetup(sp_case)); }
+static int dfxBench_ComSetupMaxi(struct dfxBenchCase *sp_case)   { dfxBench_com_name = "max0"; return(dfxBench_ComSetup(sp_case)); }
+
+/* Optimizer in true peak mode, the difference from com/maxi32 is the cost of the oversampled detection */
+static int dfxBench_ComSetupMaxiTruePeak(struct dfxBenchCase *sp_case)
+{
+	dfxBench_com_name = "max0";
+	if (!dfxBench_ComSetup(sp_case))
+		return(IS_FALSE);
+
+	for (int group = 0; group < 5; group++)
+		if ((sp_case->hp_com[group] != NULL) && (comLongIntWrite(sp_case->hp_com[group], MAXIMIZE_TRUE_PEAK_ON, 1L) != OKAY))
+			return(IS_FALSE);
+
+	return(IS_TRUE);
+}
+
+/* Anti aliased rate change alone, down and back up, for the rates above the max internal rate */
+static int dfxBench_ResampleSetup(struct dfxBenchCase *sp_case)
+{
+	char cp_dsp_dirpath[64] = "";
+
+	if ((sp_case->internal_rate_ratio == 1) || (sp_case->num_channels > 2))
+		return(IS_FALSE);
+
+	if (comInit(&(sp_case->hp_com[0]), IS_TRUE, 0, 1, 0L, cp_dsp_dirpath, 0, NULL) != OKAY)
+		return(IS_FALSE);
+
+	return(IS_TRUE);
+}
+
+static int dfxBench_ResampleRun(struct dfxBenchCase *sp_case)
+{
+	long l_num_sets;
+
+	if (comResampleDown(sp_case->hp_com[0], &sp_case->work[0], (long)sp_case->num_frames, sp_case->num_channels,
+		sp_case->internal_rate_ratio, &l_num_sets) != OKAY)
+		return(NOT_OKAY_NO_BREAK);
+
+	if (comResampleUp(sp_case->hp_com[0], &sp_case->work[0], l_num_sets, sp_case->num_channels,
+		sp_case->internal_rate_ratio, (long)sp_case->num_frames) != OKAY)
+		return(NOT_OKAY_NO_BREAK);
+
+	return(OKAY);
+}
+
+static void dfxBench_ResampleTeardown(struct dfxBenchCase *sp_case)
+{
+	comFreeUp(&(sp_case->hp_com[0]));
+}
+
+/*
+ * The 8 tap delay is only registered with comSftwr in DSPFX builds, in DFX it is run from inside
+ * Play32, so it is driven here through its kernel entry points at the internal rate.
+ */
+static int dfxBench_Dly8Setup(struct dfxBenchCase *sp_case)
+{
+	if ((sp_case->num_channels != 1) && (sp_case->num_channels != 2))
+		return(IS_FALSE);
+
+	sp_case->kernel_params.assign(2 * DSPS_MAX_NUM_PARAMS, 0.0f);
+	sp_case->kernel_state.assign(DSPS_NUM_STATE_VARS, 0.0f);
+	sp_case->kernel_memory.assign(DSPS_SOFT_MEM_DELAY_LENGTH, 0.0f);
+
+	/* Stereo mode is read from the parameter block at init time, see comSoftDspLoadAndRunNonShared() */
+	((long *)&sp_case->kernel_params[0])[4] = (sp_case->num_channels == 2) ? 1L : 0L;
+
+	if (dspsDly8Init(&sp_case->kernel_params[0], &sp_case->kernel_memory[0], DSPS_SOFT_MEM_DELAY_LENGTH,
+		&sp_case->kernel_state[0], DSPS_INIT_MEMORY | DSPS_INIT_PARAMS,
+		(float)sp_case->samp_freq / (float)sp_case->internal_rate_ratio) != OKAY)
+		return(IS_FALSE);
+
+	return(IS_TRUE);
+}
+
+static int dfxBench_Dly8Run(struct dfxBenchCase *sp_case)
+{
+	struct hardwareMeterValType meters;
+
+	dspsDly8Process32((long *)&sp_case->work[0], sp_case->num_frames / sp_case->internal_rate_ratio,
+		&sp_case->kernel_params[0], &sp_case->kernel_memory[0], &sp_case->kernel_state[0], &meters, COM_32_BIT_FLOAT_SAMPLES);
+
+	return(OKAY);
+}
+
+static void dfxBench_Dly8Teardown(struct dfxBenchCase *sp_case)
+{
+	sp_case->kernel_params.clear();
+	sp_case->kernel_state.clear();
+	sp_case->kernel_memory.clear();
+}
+
+/* Spectrum analysis, the engine always analyses the front pair */
+static int dfxBench_SpectrumSetup(struct dfxBenchCase *sp_case)
+{
+	if (sp_case->num_channels > 2)
+		return(IS_FALSE);
+
+	if (spectrumNew(&(sp_case->hp_stage), DFXP_SPECTRUM_NUM_BANDS, (realtype)0.0,
+		(realtype)DFXP_SPECTRUM_REFRESH_RATE_MSECS * (realtype)0.001, NULL, IS_FALSE) != OKAY)
+		return(IS_FALSE);
+
+	return(IS_TRUE);
+}
+
+/* Fft mode, the audio thread only stores the samples and the analysis runs where the values are read */
+static int dfxBench_SpectrumSetupFft(struct dfxBenchCase *sp_case)
+{
+	if (dfxBench_SpectrumSetup(sp_case) != IS_TRUE)
+		return(IS_FALSE);
+
+	if (spectrumSetMode(sp_case->hp_stage, SPECTRUM_MODE_FFT, DFXP_SPECTRUM_NUM_BANDS) != OKAY)
+	{
+		spectrumFreeUp(&(sp_case->hp_stage));
+		return(IS_FALSE);
+	}
+
+	return(IS_TRUE);
+}
+
+static int dfxBench_SpectrumRun(struct dfxBenchCase *sp_case)
+{
+	return(spectrumProcess(sp_case->hp_stage, &sp_case->work[0], sp_case->num_frames, sp_case->num_channels,
+		(realtype)sp_case->samp_freq, IS_TRUE));
+}
+
+static void dfxBench_SpectrumTeardown(struct dfxBenchCase *sp_case)
+{
+	spectrumFreeUp(&(sp_case->hp_stage));
+}
+
+/* MthBuffer int <-> float converters used by dfxpModifyShortIntSamples() */
+static int dfxBench_ConvertSetup(struct dfxBenchCase *sp_case)
+{
+	int i_num_samples = sp_case->num_frames * sp_case->num_channels;
+
+	sp_case->int_buf.assign(i_num_samples * 2, 0);
+
+	return(mthConvertRealtypeBufToIntBuf(i_num_samples, sp_case->bits, sp_case->bits,
+		&sp_case->source[0], &sp_case->int_buf[0]) == OKAY);
+}
+
+static int dfxBench_Convert16Setup(struct dfxBenchCase *sp_case) { sp_case->bits = 16; return(dfxBench_ConvertSetup(sp_case)); }
+static int dfxBench_Convert24Setup(struct dfxBenchCase *sp_case) { sp_case->bits = 24; return(dfxBench_ConvertSetup(sp_case)); }
+
+static int dfxBench_IntToFloatRun(struct dfxBenchCase *sp_case)
+{
+	return(mthConvertIntBufToRealtype(sp_case->num_frames * sp_case->num_channels, sp_case->bits, sp_case->bits,
+		&sp_case->int_buf[0], &sp_case->work[0]));
+}
+
+static int dfxBench_FloatToIntRun(struct dfxBenchCase *sp_case)
+{
+	return(mthConvertRealtypeBufToIntBuf(sp_case->num_frames * sp_case->num_channels, sp_case->bits, sp_case->bits,
+		&sp_case->work[0], &sp_case->int_buf[0]));
+}
+
+static void dfxBench_ConvertTeardown(struct dfxBenchCase *sp_case)
+{
+	sp_case->int_buf.clear();
+}
+
+/* Whole chain through the public class, 32 bit float, for comparison with the sum of the stages */
+static int dfxBench_ChainSetup(struct dfxBenchCase *sp_case)
+{
+	sp_case->dfx_dsp = new DfxDsp();
+	sp_case->dfx_dsp->powerOn(true);
+
+	if (sp_case->dfx_dsp->setSignalFormat(32, sp_case->num_channels, sp_case->samp_freq, 32) != OKAY)
+	{
+		delete sp_case->dfx_dsp;
+		sp_case->dfx_dsp = NULL;
+		return(IS_FALSE);
+	}
+
+	return(IS_TRUE);
+}
+
+/* Whole chain with the surround channel groups on worker threads, only differs from chain/float32 above 2 channels */
+static int dfxBench_ChainSetupParallel(struct dfxBenchCase *sp_case)
+{
+	if (sp_case->num_channels <= 2)
+		return(IS_FALSE);
+
+	if (!dfxBench_ChainSetup(sp_case))
+		return(IS_FALSE);
+
+	sp_case->dfx_dsp->parallelSurroundOn(true);
+
+	return(IS_TRUE);
+}
+
+static int dfxBench_ChainRun(struct dfxBenchCase *sp_case)
+{
+	return(sp_case->dfx_dsp->processAudio((short int *)&sp_case->source[0], (short int *)&sp_case->work[0],
+		sp_case->num_frames, IS_FALSE));
+}
+
+/* Tail version, the decaying input is in the work buffer which is processed in place */
+static int dfxBench_ChainTailRun(struct dfxBenchCase *sp_case)
+{
+	return(sp_case->dfx_dsp->processAudio(&sp_case->work[0], sp_case->num_frames, IS_FALSE));
+}
+
+static void dfxBench_ChainTeardown(struct dfxBenchCase *sp_case)
+{
+	delete sp_case->dfx_dsp;
+	sp_case->dfx_dsp = NULL;
+}
+
+static int dfxBench_NoPrepare(struct dfxBenchCase *sp_case)
+{
+	return(OKAY);
+}
+
+static const struct dfxBenchStage dfxBench_stages[] = {
+	{ "eq",               dfxBench_EqSetup,        dfxBench_EqRun,         dfxBench_EqTeardown,        NULL },
+	{ "binaural",         dfxBench_BinauralSetup,  dfxBench_BinauralRun,   dfxBench_BinauralTeardown,  NULL },
+	{ "binaural/direct",  dfxBench_BinauralSetupDirect, dfxBench_BinauralRun, dfxBench_BinauralTeardown, NULL },
+	{ "com/play32",       dfxBench_ComSetupPlay,   dfxBench_ComRun,        dfxBench_ComTeardown,       NULL },
+	{ "com/aural32",      dfxBench_ComSetupAural,  dfxBench_ComRun,        dfxBench_ComTeardown,       NULL },
+	{ "com/lex32",        dfxBench_ComSetupLex,    dfxBench_ComRun,        dfxBench_ComTeardown,       NULL },
+	{ "com/wide32",       dfxBench_ComSetupWide,   dfxBench_ComRun,        dfxBench_ComTeardown,       NULL },
+	{ "com/maxi32",       dfxBench_ComSetupMaxi,   dfxBench_ComRun,        dfxBench_ComTeardown,       NULL },
+	{ "com/maxi32tp",     dfxBench_ComSetupMaxiTruePeak, dfxBench_ComRun,  dfxBench_ComTeardown,       NULL },
+	{ "com/resample",     dfxBench_ResampleSetup,  dfxBench_ResampleRun,   dfxBench_ResampleTeardown,  NULL },
+	{ "kernel/dly832",    dfxBench_Dly8Setup,      dfxBench_Dly8Run,       dfxBench_Dly8Teardown,      NULL },
+	{ "spectrum",         dfxBench_SpectrumSetup,  dfxBench_SpectrumRun,   dfxBench_SpectrumTeardown,  dfxBench_NoPrepare },
+	{ "spectrum/fft",     dfxBench_SpectrumSetupFft, dfxBench_SpectrumRun, dfxBench_SpectrumTeardown,  dfxBench_NoPrepare },
+	{ "mth/int16>float",  dfxBench_Convert16Setup, dfxBench_IntToFloatRun, dfxBench_ConvertTeardown,   dfxBench_NoPrepare },
+	{ "mth/float>int16",  dfxBench_Convert16Setup, dfxBench_FloatToIntRun, dfxBench_ConvertTeardown,   NULL },
+	{ "mth/int24>float",  dfxBench_Convert24Setup, dfxBench_IntToFloatRun, dfxBench_ConvertTeardown,   dfxBench_NoPrepare },
+	{ "mth/float>int24",  dfxBench_Convert24Setup, dfxBench_FloatToIntRun, dfxBench_ConvertTeardown,   NULL },
+	{ "chain/float32",    dfxBench_ChainSetup,     dfxBench_ChainRun,      dfxBench_ChainTeardown,     dfxBench_NoPrepare },
+	{ "chain/parallel",   dfxBench_ChainSetupParallel, dfxBench_ChainRun,  dfxBench_ChainTeardown,     dfxBench_NoPrepare },
+	{ "tail/eq",          dfxBench_EqSetup,        dfxBench_EqRun,         dfxBench_EqTeardown,        dfxBench_TailPrepare, DFX_BENCH_TAIL_SECS },
+	{ "tail/lex32",       dfxBench_ComSetupLex,    dfxBench_ComRun,        dfxBench_ComTeardown,       dfxBench_TailPrepare, DFX_BENCH_TAIL_SECS },
+	{ "tail/chain",       dfxBench_ChainSetup,     dfxBench_ChainTailRun,  dfxBench_ChainTeardown,     dfxBench_TailPrepare, DFX_BENCH_TAIL_SECS },
+};
+
+/*
+ * Checks, run with -check in place of the benchmarks. Each one runs a stage and a reference on the
+ * same material, prints the differences next to its tolerance, and fails above it. DfxBench then
+ * exits with 1.
+ */
+
+/*
+ * Look ahead limiter against the per sample ramp/release limiter it replaced, at the kernel's default
+ * 6 dB gain boost. The new envelope ramps to the window peak, so it reduces the gain a little earlier
+ * on a rising attack, measured at 0.02 dB mean and 0.5 dB 99th percentile. The old ramp
+ * overshoots when a second peak arrives mid ramp, so the largest difference is printed, not checked.
+ */
+#define DFX_BENCH_MAXI_CHECK_SECS        20.0
+#define DFX_BENCH_MAXI_CHECK_BLOCK       512
+#define DFX_BENCH_MAXI_CHECK_MIN_LEVEL   1.0e-3  /* Gain reduction is compared where the delayed input is above this */
+#define DFX_BENCH_MAXI_CHECK_MEAN_DB     0.05    /* Tolerance on the mean |gain reduction difference| */
+#define DFX_BENCH_MAXI_CHECK_P99_DB      1.0     /* and on its 99th percentile */
+#define DFX_BENCH_MAXI_CHECK_OVER        1.0e-6  /* Output over max_output by more than float rounding */
+
+static const int dfxBench_maxi_check_rates[] = { 44100, 48000 };
+
+/* Per channel state of the reference limiter */
+struct dfxBenchMaxiRefType {
+	std::vector<float> dly;
+	int ptr;
+	int ramp_count;
+	float max_abs;
+	float env;
+	float delta;
+};
+
+/*
+ * FUNCTION: dfxBench_MaxiReference()
+ * DESCRIPTION:
+ *   One sample of the maximizer limiter as it was before the block processed version, the envelope
+ *   ramps linearly to each new peak over the look ahead delay and releases exponentially after it.
+ *   Takes the boosted input and returns the limited delay line output.
+ */
+static float dfxBench_MaxiReference(struct dfxBenchMaxiRefType *sp_ref, float r_in, int i_max_delay,
+												float r_release_beta, float r_max_output)
+{
+	float dly_out = sp_ref->dly[sp_ref->ptr];
+	float new_abs = (float)fabs(r_in);
+	float abs_out = (float)fabs(dly_out);
+
+	sp_ref->dly[sp_ref->ptr] = r_in;
+	if (++sp_ref->ptr >= i_max_delay)
+		sp_ref->ptr = 0;
+
+	if (sp_ref->ramp_count)
+	{
+		if (abs_out > sp_ref->env)
+			sp_ref->env = abs_out;
+
+		if (new_abs > sp_ref->max_abs)
+		{
+			float tmp_delta = (new_abs - sp_ref->env) / (float)(i_max_delay + 1);
+
+			sp_ref->max_abs = new_abs;
+			sp_ref->ramp_count = i_max_delay;
+			if (tmp_delta > sp_ref->delta)
+				sp_ref->delta = tmp_delta;
+		}
+		else
+			sp_ref->ramp_count--;
+
+		sp_ref->env += sp_ref->delta;
+	}
+	else
+	{
+		sp_ref->env = sp_ref->env * r_release_beta + (float)MAXI_ENVELOPE_BIAS;
+		if (abs_out > sp_ref->env)
+			sp_ref->env = abs_out;
+
+		if (new_abs > sp_ref->env)
+		{
+			sp_ref->max_abs = new_abs;
+			sp_ref->delta = (new_abs - sp_ref->env) / (float)(i_max_delay + 1);
+			sp_ref->env += sp_ref->delta;
+			sp_ref->ramp_count = i_max_delay;
+		}
+	}
+
+	if (sp_ref->env > r_max_output)
+		return(dly_out * r_max_output / sp_ref->env);
+
+	return(dly_out);
+}
+
+/*
+ * FUNCTION: dfxBench_FillCheckSignal()
+ * DESCRIPTION:
+ *   Stereo material for the limiter check. A three note chord under a slow tremolo with low level
+ *   noise, plus decaying 80 hz bursts every 300 msecs, on the right 100 msecs after the left.
+ */
+static void dfxBench_FillCheckSignal(std::vector<realtype> &signal, long l_num_frames, int i_samp_freq)
+{
+	const double d_two_pi = 2.0 * 3.14159265358979;
+	unsigned long ul_seed = 0x12345678UL;
+
+	signal.resize(2 * l_num_frames);
+
+	for (long l = 0; l < l_num_frames; l++)
+	{
+		double d_t = (double)l / (double)i_samp_freq;
+		double d_tremolo = 0.75 + 0.25 * sin(d_two_pi * 0.5 * d_t);
+
+		for (int ch = 0; ch < 2; ch++)
+		{
+			double d_burst_t = fmod(d_t + 0.1 * (double)ch, 0.3);
+
+			ul_seed = ul_seed * 1664525UL + 1013904223UL;
+
+			signal[2 * l + ch] = (realtype)(d_tremolo * 0.08 * (sin(d_two_pi * 220.0 * d_t + ch) + sin(d_two_pi * 277.2 * d_t) +
+				sin(d_two_pi * 329.6 * d_t - ch)) + ((double)((ul_seed >> 8) & 0xFFFF) / 32768.0 - 1.0) * 0.01 +
+				0.6 * exp(-d_burst_t / 0.05) * sin(d_two_pi * 80.0 * d_burst_t));
+		}
+	}
+}
+
+/*
+ * FUNCTION: dfxBench_CheckMaxiRate()
+ * DESCRIPTION:
+ *   Runs the maximizer kernel and the reference limiter on the check material and compares their
+ *   gain reduction in dB. Also fails if the kernel output goes over max_output. Returns IS_TRUE if within tolerance.
+ */
+static int dfxBench_CheckMaxiRate(int i_samp_freq)
+{
+	int i_max_delay = (int)((double)i_samp_freq * MAXI_LOOK_AHEAD_DELAY);
+	long l_num_frames = (long)(DFX_BENCH_MAXI_CHECK_SECS * (double)i_samp_freq);
+	std::vector<realtype> source;
+	std::vector<float> params(2 * DSPS_MAX_NUM_PARAMS, 0.0f);
+	std::vector<float> state(DSPS_NUM_STATE_VARS, 0.0f);
+	std::vector<float> memory(DSPS_SOFT_MEM_MAXIMIZER_LENGTH, 0.0f);
+	struct hardwareMeterValType meters;
+	struct dspMaxiStructType *sp_maxi = (struct dspMaxiStructType *)&params[0];
+	struct dfxBenchMaxiRefType ref[2];
+	std::vector<double> diffs_db;
+	long l_num_overs = 0;
+
+	dfxBench_FillCheckSignal(source, l_num_frames, i_samp_freq);
+
+	/* Stereo, no quantizing, and a target level high enough that the gain boost never backs off */
+	((long *)&params[0])[4] = 1L;
+	if (dspsMaximizerInit(&params[0], &memory[0], DSPS_SOFT_MEM_MAXIMIZER_LENGTH, &state[0],
+		DSPS_INIT_MEMORY | DSPS_INIT_PARAMS, (float)i_samp_freq) != OKAY)
+		return(IS_FALSE);
+
+	sp_maxi->wet_gain = 1.0f;
+	sp_maxi->dry_gain = 0.0f;
+	sp_maxi->quantize_on_flag = IS_FALSE;
+	sp_maxi->target_level = 1.0e6f;
+	sp_maxi->max_delay = i_max_delay;
+
+	std::vector<realtype> work = source;
+	for (long l = 0; l < l_num_frames; l += DFX_BENCH_MAXI_CHECK_BLOCK)
+	{
+		int i_block = (int)std::min((long)DFX_BENCH_MAXI_CHECK_BLOCK, l_num_frames - l);
+
+		dspsMaximizerProcess32((long *)&work[2 * l], i_block, &params[0], &memory[0], &state[0], &meters,
+			COM_32_BIT_FLOAT_SAMPLES);
+	}
+
+	float r_scale = sp_maxi->gain_boost * sp_maxi->max_output;
+
+	for (int ch = 0; ch < 2; ch++)
+	{
+		ref[ch].dly.assign(i_max_delay, 0.0f);
+		ref[ch].ptr = 0;
+		ref[ch].ramp_count = 0;
+		ref[ch].max_abs = ref[ch].env = ref[ch].delta = 0.0f;
+	}
+
+	for (long l = 0; l < l_num_frames; l++)
+		for (int ch = 0; ch < 2; ch++)
+		{
+			float r_ref_out = dfxBench_MaxiReference(&ref[ch], r_scale * source[2 * l + ch], i_max_delay,
+				sp_maxi->release_time_beta, sp_maxi->max_output);
+			float r_out = work[2 * l + ch];
+			double d_delayed;
+
+			if (fabs(r_out) > sp_maxi->max_output * (1.0 + DFX_BENCH_MAXI_CHECK_OVER))
+				l_num_overs++;
+
+			if (l < i_max_delay)
+				continue;
+
+			d_delayed = fabs((double)r_scale * source[2 * (l - i_max_delay) + ch]);
+			if (d_delayed > DFX_BENCH_MAXI_CHECK_MIN_LEVEL)
+				diffs_db.push_back(fabs(20.0 * log10(fabs((double)r_out) / d_delayed) - 20.0 * log10(fabs((double)r_ref_out) / d_delayed)));
+		}
+
+	std::sort(diffs_db.begin(), diffs_db.end());
+
+	double d_sum = 0.0;
+	for (size_t i = 0; i < diffs_db.size(); i++)
+		d_sum += diffs_db[i];
+
+	double d_mean = d_sum / (double)diffs_db.size();
+	double d_p99 = diffs_db[(diffs_db.size() * 99) / 100];
+	int i_pass = (d_mean <= DFX_BENCH_MAXI_CHECK_MEAN_DB) && (d_p99 <= DFX_BENCH_MAXI_CHECK_P99_DB) && (l_num_overs == 0);
+
+	printf("%-16s %7d  gain reduction vs reference: mean %.4f dB (max %.2f), 99%% %.4f dB (max %.2f), max %.2f dB, overs %ld  %s\n",
+		"maxi/reference", i_samp_freq, d_mean, DFX_BENCH_MAXI_CHECK_MEAN_DB, d_p99, DFX_BENCH_MAXI_CHECK_P99_DB,
+		diffs_db.back(), l_num_overs, i_pass ? "ok" : "FAILED");
+
+	return(i_pass);
+}
+
+static int dfxBench_CheckMaxi(void)
+{
+	int i_pass = IS_TRUE;
+
+	for (int r = 0; r < DFX_BENCH_ARRAY_SIZE(dfxBench_maxi_check_rates); r++)
+		if (!dfxBench_CheckMaxiRate(dfxBench_maxi_check_rates[r]))
+			i_pass = IS_FALSE;
+
+	return(i_pass);
+}
+
+/*
+ * 16 bit output check. The SSE2 surround gather hands its tail to mthConvertRealtypeBufToIntBuf(),
+ * so that is the scalar conversion every 16 bit output ends in. It is run over every length up to
+ * DFX_BENCH_CONVERT_CHECK_MAX_LENGTH with a full scale +1.0 as the last sample.
+ */
+#define DFX_BENCH_CONVERT_CHECK_MAX_LENGTH  67
+
+static const float dfxBench_convert_check_pattern[] = { 1.0f, -1.0f, 0.5f, 1.0f, 0.99999f, -0.25f, -0.99999f };
+
+/* Truncation saturated to the 16 bit range, a full scale +1.0 gives 32767 */
+static short int dfxBench_Saturate16(float r_val)
+{
+	float r_tmp = r_val * (float)MTH_16_BIT_REAL_CONVERSION_FACTOR;
+
+	if (r_tmp >= 32767.0f)
+		return(32767);
+	if (r_tmp <= -32768.0f)
+		return(-32768);
+
+	return((short int)r_tmp);
+}
+
+/*
+ * FUNCTION: dfxBench_CheckConvert16()
+ * DESCRIPTION:
+ *   Converts buffers of every length up to DFX_BENCH_CONVERT_CHECK_MAX_LENGTH to 16 bit with
+ *   mthConvertRealtypeBufToIntBuf(). Every output has to be the saturated truncation of its input,
+ *   so +1.0 gives 32767 and does not wrap.
+ */
+static int dfxBench_CheckConvert16(void)
+{
+	std::vector<realtype> source(DFX_BENCH_CONVERT_CHECK_MAX_LENGTH);
+	std::vector<short int> out(DFX_BENCH_CONVERT_CHECK_MAX_LENGTH);
+	long l_num_diffs = 0;
+	int i_full_scale_out = 0;
+
+	for (int i_length = 1; i_length <= DFX_BENCH_CONVERT_CHECK_MAX_LENGTH; i_length++)
+	{
+		for (int i = 0; i < i_length; i++)
+			source[i] = dfxBench_convert_check_pattern[i % DFX_BENCH_ARRAY_SIZE(dfxBench_convert_check_pattern)];
+		source[i_length - 1] = 1.0f;
+
+		out.assign(DFX_BENCH_CONVERT_CHECK_MAX_LENGTH, 0);
+		if (mthConvertRealtypeBufToIntBuf(i_length, 16, 16, &source[0], &out[0]) != OKAY)
+			return(IS_FALSE);
+
+		for (int i = 0; i < i_length; i++)
+			if (out[i] != dfxBench_Saturate16(source[i]))
+				l_num_diffs++;
+
+		i_full_scale_out = out[i_length - 1];
+	}
+
+	printf("%-16s %-8s  +1.0 gives %d, samples differing from saturated truncation %ld  %s\n",
+		"convert/16bit", "mth", i_full_scale_out, l_num_diffs, (l_num_diffs == 0) ? "ok" : "FAILED");
+
+	return(l_num_diffs == 0);
+}
+
+/* A check, run returns IS_TRUE if within tolerance */
+struct dfxBenchCheck {
+	const char *name;
+	int (*run)(void);
+};
+
+static const struct dfxBenchCheck dfxBench_checks[] = {
+	{ "maxi/reference",   dfxBench_CheckMaxi },
+	{ "convert/16bit",    dfxBench_CheckConvert16 },
+};
+
+/*
+ * FUNCTION: dfxBench_RunCase()
+ * DESCRIPTION:
+ *   Times one stage for one frames/channels/rate combination and prints the result line.
+ *   Returns IS_FALSE if the combination does not apply to the stage.
+ */
+static int dfxBench_RunCase(const struct dfxBenchStage *sp_stage, int i_frames, int i_channels, int i_rate,
+									 double d_target_msecs, int i_csv)
+{
+	struct dfxBenchCase bench_case;
+	int (*prepare)(struct dfxBenchCase *) = (sp_stage->prepare != NULL) ? sp_stage->prepare : dfxBench_Refresh;
+
+	bench_case.num_frames = i_frames;
+	bench_case.num_channels = i_channels;
+	bench_case.samp_freq = i_rate;
+	bench_case.internal_rate_ratio = dfxBench_InternalRateRatio(i_rate);
+	bench_case.hp_stage = NULL;
+	memset(bench_case.hp_com, 0, sizeof(bench_case.hp_com));
+	bench_case.dfx_dsp = NULL;
+	bench_case.bits = 0;
+	bench_case.tail_frames = 0;
+
+	/* Stages called directly get the same FTZ/DAZ mode that the processing calls set */
+	CRealSampleFlushDenormals flush_denormals;
+
+	dfxBench_FillSignal(bench_case.source, i_frames, i_channels, i_rate);
+	bench_case.work = bench_case.source;
+
+	if (!sp_stage->setup(&bench_case))
+	{
+		sp_stage->teardown(&bench_case);
+		return(IS_FALSE);
+	}
+
+	for (int i = 0; i < DFX_BENCH_WARMUP_ITERATIONS; i++)
+	{
+		prepare(&bench_case);
+		sp_stage->run(&bench_case);
+	}
+
+	std::vector<double> times_ns;
+	double d_elapsed_ns = 0.0;
+	double d_min_elapsed_ns = d_target_msecs * 1.0e6;
+	int i_min_iterations = DFX_BENCH_MIN_ITERATIONS;
+	int i_status = OKAY;
+
+	/* Tail stages restart the burst and run for their full length of audio */
+	if (sp_stage->tail_secs > 0.0)
+	{
+		bench_case.tail_frames = 0;
+		d_min_elapsed_ns = 0.0;
+		i_min_iterations = (int)ceil(sp_stage->tail_secs * (double)i_rate / (double)i_frames);
+	}
+
+	while ((d_elapsed_ns < d_min_elapsed_ns) || ((int)times_ns.size() < i_min_iterations))
+	{
+		prepare(&bench_case);
+
+		auto start = std::chrono::steady_clock::now();
+		i_status |= sp_stage->run(&bench_case);
+		auto stop = std::chrono::steady_clock::now();
+
+		double d_ns = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start).count();
+		times_ns.push_back(d_ns);
+		d_elapsed_ns += d_ns;
+	}
+
+	sp_stage->teardown(&bench_case);
+
+	std::sort(times_ns.begin(), times_ns.end());
+	double d_median_ns = times_ns[times_ns.size() / 2];
+	double d_peak_ns = times_ns.back();
+	double d_period_ns = (double)i_frames * 1.0e9 / (double)i_rate;
+
+	if (i_csv)
+		printf("%s,%d,%d,%d,%.0f,%.0f,%.3f,%.4f,%s\n", sp_stage->name, i_frames, i_channels, i_rate,
+			d_median_ns, d_peak_ns, d_median_ns / (double)i_frames, 100.0 * d_median_ns / d_period_ns,
+			(i_status == OKAY) ? "ok" : "error");
+	else
+		printf("%-16s %6d %3d %7d %12.0f %12.0f %10.2f %9.4f%%%s\n", sp_stage->name, i_frames, i_channels, i_rate,
+			d_median_ns, d_peak_ns, d_median_ns / (double)i_frames, 100.0 * d_median_ns / d_period_ns,
+			(i_status == OKAY) ? "" : "  (error)");
+
+	fflush(stdout);
+
+	return(IS_TRUE);
+}
+
+static void dfxBench_Usage(void)
+{
+	fprintf(stderr, "usage: DfxBench [-quick] [-csv] [-scalar] [-denormals] [-time msecs] [stage filter]\n");
+	fprintf(stderr, "       DfxBench -check [check filter]\n");
+	fprintf(stderr, "  -quick      reduced sweep (%d buffer sizes, %d rates)\n",
+		DFX_BENCH_ARRAY_SIZE(dfxBench_quick_frames), DFX_BENCH_ARRAY_SIZE(dfxBench_quick_rates));
+	fprintf(stderr, "  -csv        machine readable output\n");
+	fprintf(stderr, "  -scalar     disable the vectorized sos cascades and spectrum filters\n");
+	fprintf(stderr, "  -denormals  process without the FTZ/DAZ mode, for comparison on the tail stages\n");
+	fprintf(stderr, "  -time msecs minimum measuring time per case (default %d)\n", DFX_BENCH_DEFAULT_MSECS);
+	fprintf(stderr, "  stage filter runs only stages whose name contains the string, stages are:\n");
+	for (int i = 0; i < DFX_BENCH_ARRAY_SIZE(dfxBench_stages); i++)
+		fprintf(stderr, "    %s\n", dfxBench_stages[i].name);
+	fprintf(stderr, "  -check      run the checks against their references, exits with 1 if one fails, checks are:\n");
+	for (int i = 0; i < DFX_BENCH_ARRAY_SIZE(dfxBench_checks); i++)
+		fprintf(stderr, "    %s\n", dfxBench_checks[i].name);
+}
+
+int main(int argc, char *argv[])
+{
+	const char *cp_filter = NULL;
+	int i_quick = IS_FALSE;
+	int i_csv = IS_FALSE;
+	int i_check = IS_FALSE;
+	double d_target_msecs = DFX_BENCH_DEFAULT_MSECS;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "-quick") == 0)
+			i_quick = IS_TRUE;
+		else if (strcmp(argv[i], "-csv") == 0)
+			i_csv = IS_TRUE;
+		else if (strcmp(argv[i], "-check") == 0)
+			i_check = IS_TRUE;
+		else if (strcmp(argv[i], "-scalar") == 0)
+			sosSetMaxSimdLevel(SOS_SIMD_NONE);
+		else if (strcmp(argv[i], "-denormals") == 0)
+			realSampleSetFlushDenormals(IS_FALSE);
+		else if ((strcmp(argv[i], "-time") == 0) && (i + 1 < argc))
+			d_target_msecs = atof(argv[++i]);
+		else if ((argv[i][0] != '-') && (cp_filter == NULL))
+			cp_filter = argv[i];
+		else
+		{
+			dfxBench_Usage();
+			return(1);
+		}
+	}
+
+	if (i_check)
+	{
+		int i_failed = IS_FALSE;
+
+		for (int c = 0; c < DFX_BENCH_ARRAY_SIZE(dfxBench_checks); c++)
+		{
+			if ((cp_filter != NULL) && (strstr(dfxBench_checks[c].name, cp_filter) == NULL))
+				continue;
+
+			/* Same FTZ/DAZ mode as the processing calls */
+			CRealSampleFlushDenormals flush_denormals;
+
+			if (!dfxBench_checks[c].run())
+				i_failed = IS_TRUE;
+		}
+
+		return(i_failed ? 1 : 0);
+	}
+
+	const int *ip_frames = i_quick ? dfxBench_quick_frames : dfxBench_frames;
+	int i_num_frames = i_quick ? DFX_BENCH_ARRAY_SIZE(dfxBench_quick_frames) : DFX_BENCH_ARRAY_SIZE(dfxBench_frames);
+	const int *ip_rates = i_quick ? dfxBench_quick_rates : dfxBench_rates;
+	int i_num_rates = i_quick ? DFX_BENCH_ARRAY_SIZE(dfxBench_quick_rates) : DFX_BENCH_ARRAY_SIZE(dfxBench_rates);
+
+	if (i_csv)
+		printf("stage,frames,channels,rate,median_ns,peak_ns,ns_per_frame,load_percent,status\n");
+	else
+		printf("%-16s %6s %3s %7s %12s %12s %10s %10s\n", "stage", "frames", "ch", "rate", "median ns", "peak ns", "ns/frame", "load");
+
+	for (int s = 0; s < DFX_BENCH_ARRAY_SIZE(dfxBench_stages); s++)
+	{
+		const struct dfxBenchStage *sp_stage = &dfxBench_stages[s];
+
+		if ((cp_filter != NULL) && (strstr(sp_stage->name, cp_filter) == NULL))
+			continue;
+
+		for (int c = 0; c < DFX_BENCH_ARRAY_SIZE(dfxBench_channels); c++)
+			for (int r = 0; r < i_num_rates; r++)
+				for (int f = 0; f < i_num_frames; f++)
+					dfxBench_RunCase(sp_stage, ip_frames[f], dfxBench_channels[c], ip_rates[r], d_target_msecs, i_csv);
+	}
+
+	return(0);
+}
@@ -0,0 +1,578 @@
+/*
+FxSound
+Copyright (C) 2025  FxSound LLC
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/* DfxConcurrency.cpp */
+
+/*
+ * Reentrancy check for the DfxDsp engine.
+ *
+ *   DfxConcurrency [-n streams] [-b frames] [-s seconds] [-r samp_freq] [-c channels] [-16]
+ *
+ * Every stream gets its own deterministic test signal. A reference output is first
+ * rendered for each stream with a single DfxDsp instance alive. The same streams are
+ * then rendered twice more with all instances alive at once:
+ *   - interleaved, one buffer of each instance in turn on the calling thread
+ *   - concurrently, one instance per thread, all threads released together
+ * Both passes must be bit-identical to the references. Any state shared between
+ * instances (file statics in the kernels, shared tables written at run time) shows
+ * up as a mismatch in one of the two passes. Vocal reduction is switched on as well,
+ * so the per handle Play state of the vocal elimination path is covered.
+ *
+ * A last pass loads two presets in turn into every instance from a separate thread while
+ * the stream threads are processing, the way the UI does. The output has to stay finite
+ * and bounded, and once the loads stop every instance has to settle on the same EQ bands
+ * as an instance that loaded the final preset while idle.
+ *
+ * Returns 0 when every stream matches, 1 otherwise.
+ */
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "codedefs.h"
+#include "pt_defs.h"
+#include "DfxDsp.h"
+
+#define DFX_CONCURRENCY_DEFAULT_STREAMS   4
+#define DFX_CONCURRENCY_MAX_STREAMS       64
+#define DFX_CONCURRENCY_DEFAULT_FRAMES    480
+#define DFX_CONCURRENCY_DEFAULT_SECONDS   5.0
+#define DFX_CONCURRENCY_DEFAULT_SAMP_FREQ 48000
+#define DFX_CONCURRENCY_DEFAULT_CHANNELS  2
+#define DFX_CONCURRENCY_EFFECT_SETTING    7.0f /* Knob value (0 to 10) applied to every effect */
+#define DFX_CONCURRENCY_SETTLE_MSECS      200  /* Well past the parameter ramps */
+#define DFX_CONCURRENCY_PRESET_MAX_PEAK   2.0f /* The limiter holds the output near 1.0 */
+#define DFX_CONCURRENCY_PRESET_TOLERANCE  0.01f
+#define DFX_CONCURRENCY_PRESET_DIR        L"."
+#define DFX_CONCURRENCY_PRESET_A          L"DfxConcurrencyA"
+#define DFX_CONCURRENCY_PRESET_B          L"DfxConcurrencyB"
+
+/* One stream, its test signal and the outputs of the three passes */
+struct dfxConcurrencyStream {
+	DfxDsp *dfx_dsp;
+	std::vector<short int> input;     /* Stored as the engine's sample type, see i_bits */
+	std::vector<short int> reference;
+	std::vector<short int> output;
+	int status;
+};
+
+/* Parameters shared by all streams */
+struct dfxConcurrencyFormat {
+	int i_bits;
+	int i_channels;
+	int i_samp_freq;
+	int i_buffer_frames;
+	long l_total_frames;
+	int i_shorts_per_frame;
+};
+
+/*
+ * FUNCTION: dfxConcurrency_MakeSignal()
+ * DESCRIPTION:
+ *   Fills the stream input with a mix of a per-stream tone sweep and LCG noise, so the
+ *   streams differ from each other and any crosstalk between instances changes the output.
+ */
+static void dfxConcurrency_MakeSignal(struct dfxConcurrencyStream *sp_stream, int i_stream, const struct dfxConcurrencyFormat *sp_fmt)
+{
+	unsigned long ul_seed = 12345UL + 7919UL * (unsigned long)i_stream;
+	double phase = 0.0;
+	double freq = 110.0 * (double)(i_stream + 1);
+
+	sp_stream->input.assign(sp_fmt->l_total_frames * sp_fmt->i_shorts_per_frame, 0);
+
+	float *fp_out = (float *)sp_stream->input.data();
+	short int *sip_out = sp_stream->input.data();
+
+	for (long l_frame = 0; l_frame < sp_fmt->l_total_frames; l_frame++)
+	{
+		/* Slow upward sweep, wraps every second */
+		double sweep_freq = freq * (1.0 + (double)(l_frame % sp_fmt->i_samp_freq) / (double)sp_fmt->i_samp_freq);
+		phase += 6.283185307179586 * sweep_freq / (double)sp_fmt->i_samp_freq;
+		if (phase > 6.283185307179586)
+			phase -= 6.283185307179586;
+
+		for (int ch = 0; ch < sp_fmt->i_channels; ch++)
+		{
+			ul_seed = (1664525UL * ul_seed + 1013904223UL) & 0xFFFFFFFFUL;
+			double noise = ((double)(ul_seed >> 8) / (double)(1UL << 24)) - 0.5;
+			double val = 0.6 * sin(phase + 0.3 * ch) + 0.15 * noise;
+			long l_index = l_frame * sp_fmt->i_channels + ch;
+
+			if (sp_fmt->i_bits == 32)
+				fp_out[l_index] = (float)val;
+			else
+				sip_out[l_index] = (short int)(val * 32767.0);
+		}
+	}
+}
+
+/*
+ * FUNCTION: dfxConcurrency_Open()
+ * DESCRIPTION:
+ *   Creates and configures the engine for one stream. All instances get the same
+ *   settings, with every effect and the EQ switched on so all kernels are exercised.
+ */
+static int dfxConcurrency_Open(struct dfxConcurrencyStream *sp_stream, const struct dfxConcurrencyFormat *sp_fmt)
+{
+	sp_stream->dfx_dsp = new DfxDsp();
+
+	sp_stream->dfx_dsp->powerOn(true);
+	sp_stream->dfx_dsp->eqOn(true);
+	for (int i = 0; i < DfxDsp::NumEffects; i++)
+		sp_stream->dfx_dsp->setEffectValue((DfxDsp::Effect)i, DFX_CONCURRENCY_EFFECT_SETTING);
+	sp_stream->dfx_dsp->vocalReductionOn(true);
+
+	if (sp_stream->dfx_dsp->setSignalFormat(sp_fmt->i_bits, sp_fmt->i_channels, sp_fmt->i_samp_freq, sp_fmt->i_bits) != OKAY)
+		return(NOT_OKAY_NO_BREAK);
+
+	return(OKAY);
+}
+
+static void dfxConcurrency_Close(struct dfxConcurrencyStream *sp_stream)
+{
+	delete sp_stream->dfx_dsp;
+	sp_stream->dfx_dsp = NULL;
+}
+
+/*
+ * FUNCTION: dfxConcurrency_ProcessBuffer()
+ * DESCRIPTION:
+ *   Runs buffer number l_buffer of the stream input into vp_dest.
+ */
+static int dfxConcurrency_ProcessBuffer(struct dfxConcurrencyStream *sp_stream, const struct dfxConcurrencyFormat *sp_fmt,
+													 long l_buffer, std::vector<short int> *vp_dest)
+{
+	long l_start_frame = l_buffer * sp_fmt->i_buffer_frames;
+	long l_frames = sp_fmt->l_total_frames - l_start_frame;
+
+	if (l_frames > sp_fmt->i_buffer_frames)
+		l_frames = sp_fmt->i_buffer_frames;
+	if (l_frames <= 0)
+		return(OKAY);
+
+	long l_offset = l_start_frame * sp_fmt->i_shorts_per_frame;
+
+	return(sp_stream->dfx_dsp->processAudio(sp_stream->input.data() + l_offset, vp_dest->data() + l_offset, (int)l_frames, IS_FALSE));
+}
+
+/*
+ * FUNCTION: dfxConcurrency_Settle()
+ * DESCRIPTION:
+ *   Runs DFX_CONCURRENCY_SETTLE_MSECS of silence through the engine, so queued settings are
+ *   picked up and their ramps finish.
+ */
+static int dfxConcurrency_Settle(DfxDsp *dfx_dsp, const struct dfxConcurrencyFormat *sp_fmt)
+{
+	long l_frames = (long)sp_fmt->i_samp_freq * DFX_CONCURRENCY_SETTLE_MSECS / 1000;
+	std::vector<short int> silence(sp_fmt->i_buffer_frames * sp_fmt->i_shorts_per_frame, 0);
+	std::vector<short int> out(silence.size(), 0);
+
+	for (long l_done = 0; l_done < l_frames; l_done += sp_fmt->i_buffer_frames)
+	{
+		if (dfx_dsp->processAudio(silence.data(), out.data(), sp_fmt->i_buffer_frames, IS_FALSE) != OKAY)
+			return(NOT_OKAY_NO_BREAK);
+	}
+
+	return(OKAY);
+}
+
+/* Full path of a preset saved by dfxConcurrency_MakePresets() */
+static std::wstring dfxConcurrency_PresetPath(const wchar_t *wcp_name)
+{
+	return(std::wstring(DFX_CONCURRENCY_PRESET_DIR) + L"\\" + wcp_name + L".fac");
+}
+
+/*
+ * FUNCTION: dfxConcurrency_MakePresets()
+ * DESCRIPTION:
+ *   Saves the two presets used by the preset pass. A has every EQ band boosted or cut and
+ *   moved up its range, B is the flat default EQ.
+ */
+static int dfxConcurrency_MakePresets(const struct dfxConcurrencyFormat *sp_fmt)
+{
+	struct dfxConcurrencyStream stream;
+	int i_status = OKAY;
+
+	if (dfxConcurrency_Open(&stream, sp_fmt) != OKAY)
+		i_status = NOT_OKAY_NO_BREAK;
+	else
+	{
+		/* Band 0 follows the bass boost knob, it is left alone */
+		for (int i = 1; i < stream.dfx_dsp->getNumEqBands(); i++)
+		{
+			float min_freq, max_freq;
+
+			stream.dfx_dsp->setEqBandBoostCut(i, (i & 1) ? 6.0f : -4.0f);
+			stream.dfx_dsp->getEqBandFrequencyRange(i, &min_freq, &max_freq);
+			stream.dfx_dsp->setEqBandFrequency(i, min_freq + 0.75f * (max_freq - min_freq));
+		}
+		if ((dfxConcurrency_Settle(stream.dfx_dsp, sp_fmt) != OKAY) ||
+			 (stream.dfx_dsp->savePreset(DFX_CONCURRENCY_PRESET_A, DFX_CONCURRENCY_PRESET_DIR) != OKAY))
+			i_status = NOT_OKAY_NO_BREAK;
+	}
+	dfxConcurrency_Close(&stream);
+
+	if (i_status != OKAY)
+		return(i_status);
+
+	if (dfxConcurrency_Open(&stream, sp_fmt) != OKAY)
+		i_status = NOT_OKAY_NO_BREAK;
+	else if ((dfxConcurrency_Settle(stream.dfx_dsp, sp_fmt) != OKAY) ||
+				(stream.dfx_dsp->savePreset(DFX_CONCURRENCY_PRESET_B, DFX_CONCURRENCY_PRESET_DIR) != OKAY))
+		i_status = NOT_OKAY_NO_BREAK;
+	dfxConcurrency_Close(&stream);
+
+	return(i_status);
+}
+
+/* Thread body for the concurrent and preset passes. Waits for the start flag so all threads overlap. */
+static void dfxConcurrency_ThreadRun(struct dfxConcurrencyStream *sp_stream, const struct dfxConcurrencyFormat *sp_fmt,
+												 long l_num_buffers, std::atomic<int> *ap_start, std::atomic<int> *ap_num_running)
+{
+	while (ap_start->load() == 0)
+		std::this_thread::yield();
+
+	sp_stream->status = OKAY;
+	for (long l_buffer = 0; l_buffer < l_num_buffers; l_buffer++)
+	{
+		if (dfxConcurrency_ProcessBuffer(sp_stream, sp_fmt, l_buffer, &(sp_stream->output)) != OKAY)
+			sp_stream->status = NOT_OKAY_NO_BREAK;
+	}
+
+	ap_num_running->fetch_sub(1);
+}
+
+/*
+ * FUNCTION: dfxConcurrency_PresetLoaderRun()
+ * DESCRIPTION:
+ *   Thread body standing in for the UI in the preset pass. Loads presets A and B in turn into
+ *   every instance until all the stream threads are done, then leaves A loaded everywhere.
+ */
+static void dfxConcurrency_PresetLoaderRun(std::vector<struct dfxConcurrencyStream> *vp_streams, std::atomic<int> *ap_start,
+														 std::atomic<int> *ap_num_running, long *lp_num_loads, int *ip_status)
+{
+	std::wstring preset_a = dfxConcurrency_PresetPath(DFX_CONCURRENCY_PRESET_A);
+	std::wstring preset_b = dfxConcurrency_PresetPath(DFX_CONCURRENCY_PRESET_B);
+	long l_load = 0;
+
+	while (ap_start->load() == 0)
+		std::this_thread::yield();
+
+	*ip_status = OKAY;
+	while (ap_num_running->load() > 0)
+	{
+		for (size_t i = 0; i < vp_streams->size(); i++)
+		{
+			if ((*vp_streams)[i].dfx_dsp->loadPreset((l_load & 1) ? preset_b : preset_a) != OKAY)
+				*ip_status = NOT_OKAY_NO_BREAK;
+		}
+		l_load++;
+	}
+
+	for (size_t i = 0; i < vp_streams->size(); i++)
+	{
+		if ((*vp_streams)[i].dfx_dsp->loadPreset(preset_a) != OKAY)
+			*ip_status = NOT_OKAY_NO_BREAK;
+	}
+
+	*lp_num_loads = l_load + 1;
+}
+
+/*
+ * FUNCTION: dfxConcurrency_Compare()
+ * DESCRIPTION:
+ *   Compares a pass output against the stream reference, reports the first differing frame.
+ *   Returns the number of mismatching streams.
+ */
+static int dfxConcurrency_Compare(std::vector<struct dfxConcurrencyStream> &streams, const struct dfxConcurrencyFormat *sp_fmt, const char *cp_pass)
+{
+	int i_num_bad = 0;
+
+	for (size_t i = 0; i < streams.size(); i++)
+	{
+		const std::vector<short int> &ref = streams[i].reference;
+		const std::vector<short int> &out = streams[i].output;
+
+		if (streams[i].status != OKAY)
+		{
+			printf("  %-12s stream %2d: processAudio failed\n", cp_pass, (int)i);
+			i_num_bad++;
+			continue;
+		}
+
+		if (memcmp(ref.data(), out.data(), ref.size() * sizeof(short int)) == 0)
+			continue;
+
+		long l_first = 0;
+		while ((l_first < (long)ref.size()) && (ref[l_first] == out[l_first]))
+			l_first++;
+
+		printf("  %-12s stream %2d: MISMATCH from frame %ld\n", cp_pass, (int)i, l_first / sp_fmt->i_shorts_per_frame);
+		i_num_bad++;
+	}
+
+	if (i_num_bad == 0)
+		printf("  %-12s all %d streams bit-identical\n", cp_pass, (int)streams.size());
+
+	return(i_num_bad);
+}
+
+/*
+ * FUNCTION: dfxConcurrency_CheckPreset()
+ * DESCRIPTION:
+ *   Checks the preset pass. The output must be finite and bounded (only checkable for float samples),
+ *   and after settling every instance must report the EQ of an instance that loaded preset A while idle.
+ *   Returns the number of failing streams.
+ */
+static int dfxConcurrency_CheckPreset(std::vector<struct dfxConcurrencyStream> &streams, const struct dfxConcurrencyFormat *sp_fmt,
+												  DfxDsp *dfx_dsp_ref)
+{
+	int i_num_bad = 0;
+
+	for (size_t i = 0; i < streams.size(); i++)
+	{
+		struct dfxConcurrencyStream *sp_stream = &(streams[i]);
+		const char *cp_problem = NULL;
+
+		if (sp_stream->status != OKAY)
+			cp_problem = "processAudio failed";
+
+		if ((cp_problem == NULL) && (sp_fmt->i_bits == 32))
+		{
+			const float *fp_out = (const float *)sp_stream->output.data();
+			long l_num_samples = sp_fmt->l_total_frames * sp_fmt->i_channels;
+
+			for (long l = 0; l < l_num_samples; l++)
+			{
+				if (!(fabsf(fp_out[l]) <= DFX_CONCURRENCY_PRESET_MAX_PEAK))
+				{
+					cp_problem = "output not finite or out of range";
+					break;
+				}
+			}
+		}
+
+		if ((cp_problem == NULL) && (dfxConcurrency_Settle(sp_stream->dfx_dsp, sp_fmt) != OKAY))
+			cp_problem = "processAudio failed while settling";
+
+		for (int band = 1; (cp_problem == NULL) && (band < dfx_dsp_ref->getNumEqBands()); band++)
+		{
+			if ((fabsf(sp_stream->dfx_dsp->getEqBandBoostCut(band) - dfx_dsp_ref->getEqBandBoostCut(band)) > DFX_CONCURRENCY_PRESET_TOLERANCE) ||
+				 (fabsf(sp_stream->dfx_dsp->getEqBandFrequency(band) - dfx_dsp_ref->getEqBandFrequency(band)) > DFX_CONCURRENCY_PRESET_TOLERANCE))
+				cp_problem = "EQ did not settle on the loaded preset";
+		}
+
+		if (cp_problem != NULL)
+		{
+			printf("  %-12s stream %2d: %s\n", "preset", (int)i, cp_problem);
+			i_num_bad++;
+		}
+	}
+
+	if (i_num_bad == 0)
+		printf("  %-12s all %d streams settled on the loaded preset\n", "preset", (int)streams.size());
+
+	return(i_num_bad);
+}
+
+static void dfxConcurrency_Usage(void)
+{
+	fprintf(stderr, "usage: DfxConcurrency [-n streams] [-b frames] [-s seconds] [-r samp_freq] [-c channels] [-16]\n");
+	fprintf(stderr, "  -n streams  number of engine instances / threads (default %d)\n", DFX_CONCURRENCY_DEFAULT_STREAMS);
+	fprintf(stderr, "  -b frames   sample sets per processAudio() call (default %d)\n", DFX_CONCURRENCY_DEFAULT_FRAMES);
+	fprintf(stderr, "  -s seconds  length of each stream (default %.1f)\n", DFX_CONCURRENCY_DEFAULT_SECONDS);
+	fprintf(stderr, "  -r freq     sampling frequency (default %d)\n", DFX_CONCURRENCY_DEFAULT_SAMP_FREQ);
+	fprintf(stderr, "  -c channels channel count (default %d)\n", DFX_CONCURRENCY_DEFAULT_CHANNELS);
+	fprintf(stderr, "  -16         use 16 bit samples instead of 32 bit float\n");
+}
+
+int main(int argc, char *argv[])
+{
+	int i_num_streams = DFX_CONCURRENCY_DEFAULT_STREAMS;
+	double seconds = DFX_CONCURRENCY_DEFAULT_SECONDS;
+	struct dfxConcurrencyFormat fmt;
+
+	fmt.i_bits = 32;
+	fmt.i_channels = DFX_CONCURRENCY_DEFAULT_CHANNELS;
+	fmt.i_samp_freq = DFX_CONCURRENCY_DEFAULT_SAMP_FREQ;
+	fmt.i_buffer_frames = DFX_CONCURRENCY_DEFAULT_FRAMES;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if ((strcmp(argv[i], "-n") == 0) && (i + 1 < argc))
+			i_num_streams = atoi(argv[++i]);
+		else if ((strcmp(argv[i], "-b") == 0) && (i + 1 < argc))
+			fmt.i_buffer_frames = atoi(argv[++i]);
+		else if ((strcmp(argv[i], "-s") == 0) && (i + 1 < argc))
+			seconds = atof(argv[++i]);
+		else if ((strcmp(argv[i], "-r") == 0) && (i + 1 < argc))
+			fmt.i_samp_freq = atoi(argv[++i]);
+		else if ((strcmp(argv[i], "-c") == 0) && (i + 1 < argc))
+			fmt.i_channels = atoi(argv[++i]);
+		else if (strcmp(argv[i], "-16") == 0)
+			fmt.i_bits = 16;
+		else
+		{
+			dfxConcurrency_Usage();
+			return(1);
+		}
+	}
+
+	if ((i_num_streams < 1) || (i_num_streams > DFX_CONCURRENCY_MAX_STREAMS) || (fmt.i_buffer_frames < 1) ||
+		 (seconds <= 0.0) || (fmt.i_samp_freq <= 0) || (fmt.i_channels < 1) || (fmt.i_channels > 8))
+	{
+		dfxConcurrency_Usage();
+		return(1);
+	}
+
+	fmt.l_total_frames = (long)(seconds * (double)fmt.i_samp_freq);
+	fmt.i_shorts_per_frame = fmt.i_channels * (fmt.i_bits / 16);
+	long l_num_buffers = (fmt.l_total_frames + fmt.i_buffer_frames - 1) / fmt.i_buffer_frames;
+
+	printf("DfxConcurrency: %d streams, %d ch, %d Hz, %d bit, %d frame buffers, %ld frames each\n",
+		i_num_streams, fmt.i_channels, fmt.i_samp_freq, fmt.i_bits, fmt.i_buffer_frames, fmt.l_total_frames);
+
+	std::vector<struct dfxConcurrencyStream> streams(i_num_streams);
+
+	/* Reference pass, one instance alive at a time */
+	for (int i = 0; i < i_num_streams; i++)
+	{
+		struct dfxConcurrencyStream *sp_stream = &(streams[i]);
+
+		dfxConcurrency_MakeSignal(sp_stream, i, &fmt);
+		sp_stream->reference.assign(sp_stream->input.size(), 0);
+		sp_stream->output.assign(sp_stream->input.size(), 0);
+
+		if (dfxConcurrency_Open(sp_stream, &fmt) != OKAY)
+		{
+			fprintf(stderr, "DfxConcurrency: engine rejected the signal format\n");
+			return(1);
+		}
+		for (long l_buffer = 0; l_buffer < l_num_buffers; l_buffer++)
+			dfxConcurrency_ProcessBuffer(sp_stream, &fmt, l_buffer, &(sp_stream->reference));
+		dfxConcurrency_Close(sp_stream);
+	}
+
+	int i_num_bad = 0;
+
+	/* Interleaved pass, all instances alive, one thread */
+	for (int i = 0; i < i_num_streams; i++)
+	{
+		if (dfxConcurrency_Open(&(streams[i]), &fmt) != OKAY)
+			return(1);
+		streams[i].status = OKAY;
+	}
+	for (long l_buffer = 0; l_buffer < l_num_buffers; l_buffer++)
+	{
+		for (int i = 0; i < i_num_streams; i++)
+		{
+			if (dfxConcurrency_ProcessBuffer(&(streams[i]), &fmt, l_buffer, &(streams[i].output)) != OKAY)
+				streams[i].status = NOT_OKAY_NO_BREAK;
+		}
+	}
+	for (int i = 0; i < i_num_streams; i++)
+		dfxConcurrency_Close(&(streams[i]));
+	i_num_bad += dfxConcurrency_Compare(streams, &fmt, "interleaved");
+
+	/* Concurrent pass, one thread per instance. Instances are created on this thread. */
+	for (int i = 0; i < i_num_streams; i++)
+	{
+		if (dfxConcurrency_Open(&(streams[i]), &fmt) != OKAY)
+			return(1);
+		streams[i].output.assign(streams[i].input.size(), 0);
+	}
+	{
+		std::atomic<int> start(0);
+		std::atomic<int> num_running(i_num_streams);
+		std::vector<std::thread> threads;
+
+		for (int i = 0; i < i_num_streams; i++)
+			threads.push_back(std::thread(dfxConcurrency_ThreadRun, &(streams[i]), &fmt, l_num_buffers, &start, &num_running));
+
+		start.store(1);
+
+		for (size_t i = 0; i < threads.size(); i++)
+			threads[i].join();
+	}
+	for (int i = 0; i < i_num_streams; i++)
+		dfxConcurrency_Close(&(streams[i]));
+	i_num_bad += dfxConcurrency_Compare(streams, &fmt, "concurrent");
+
+	/* Preset pass, one thread per instance plus one loading presets into all of them */
+	if (dfxConcurrency_MakePresets(&fmt) != OKAY)
+	{
+		fprintf(stderr, "DfxConcurrency: could not save the test presets\n");
+		return(1);
+	}
+	{
+		struct dfxConcurrencyStream ref_stream;
+		std::atomic<int> start(0);
+		std::atomic<int> num_running(i_num_streams);
+		std::vector<std::thread> threads;
+		long l_num_loads = 0;
+		int i_loader_status = OKAY;
+
+		if (dfxConcurrency_Open(&ref_stream, &fmt) != OKAY)
+			return(1);
+		if ((ref_stream.dfx_dsp->loadPreset(dfxConcurrency_PresetPath(DFX_CONCURRENCY_PRESET_A)) != OKAY) ||
+			 (dfxConcurrency_Settle(ref_stream.dfx_dsp, &fmt) != OKAY))
+		{
+			fprintf(stderr, "DfxConcurrency: could not load the test preset\n");
+			return(1);
+		}
+
+		for (int i = 0; i < i_num_streams; i++)
+		{
+			if (dfxConcurrency_Open(&(streams[i]), &fmt) != OKAY)
+				return(1);
+			streams[i].output.assign(streams[i].input.size(), 0);
+		}
+
+		for (int i = 0; i < i_num_streams; i++)
+			threads.push_back(std::thread(dfxConcurrency_ThreadRun, &(streams[i]), &fmt, l_num_buffers, &start, &num_running));
+		threads.push_back(std::thread(dfxConcurrency_PresetLoaderRun, &streams, &start, &num_running, &l_num_loads, &i_loader_status));
+
+		start.store(1);
+
+		for (size_t i = 0; i < threads.size(); i++)
+			threads[i].join();
+
+		if (i_loader_status != OKAY)
+		{
+			printf("  %-12s loadPreset failed\n", "preset");
+			i_num_bad++;
+		}
+		printf("  %-12s %ld loads per stream while processing\n", "preset", l_num_loads);
+		i_num_bad += dfxConcurrency_CheckPreset(streams, &fmt, ref_stream.dfx_dsp);
+
+		for (int i = 0; i < i_num_streams; i++)
+			dfxConcurrency_Close(&(streams[i]));
+		dfxConcurrency_Close(&ref_stream);
+	}
+	_wremove(dfxConcurrency_PresetPath(DFX_CONCURRENCY_PRESET_A).c_str());
+	_wremove(dfxConcurrency_PresetPath(DFX_CONCURRENCY_PRESET_B).c_str());
+
+	printf("DfxConcurrency: %s\n", (i_num_bad == 0) ? "PASS" : "FAIL");
+
+	return((i_num_bad == 0) ? 0 : 1);
+}
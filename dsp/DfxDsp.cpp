@@ -100,6 +100,11 @@ int DfxDsp::setSignalFormat(int i_bps, int i_nch, int i_srate, int i_valid_bits)
 	}
 }
 
+int DfxDsp::setMaxBlockSize(int i_max_sample_sets)
+{
+	return data_->setMaxBlockSize(i_max_sample_sets);
+}
+
 int DfxDsp::processAudio(short int *si_input_samples, short int *si_output_samples, int i_num_sample_sets, int i_check_for_duplicate_buffers)
 {
 	if (data_->being_destroyed_)
@@ -112,6 +117,18 @@ int DfxDsp::processAudio(short int *si_input_samples, short int *si_output_sampl
 	}
 }
 
+int DfxDsp::processAudio(float *fp_samples, int i_num_sample_sets, int i_check_for_duplicate_buffers)
+{
+	if (data_->being_destroyed_)
+	{
+		return OKAY;
+	}
+	else
+	{
+		return data_->processAudio(fp_samples, i_num_sample_sets, i_check_for_duplicate_buffers);
+	}
+}
+
 float DfxDsp::getEqBandFrequency(int band_num)
 {
 	return data_->getEqBandFrequency(band_num);
@@ -142,7 +159,52 @@ void DfxDsp::getSpectrumBandValues(float* rp_band_values, int i_array_size)
     data_->getSpectrumBandValues(rp_band_values, i_array_size);
 }
 
+int DfxDsp::setSpectrumNumBands(int num_bands)
+{
+    return data_->setSpectrumNumBands(num_bands);
+}
+
 void DfxDsp::setVolumeNormalization(float target_rms)
 {
 	data_->setVolumeNormalization(target_rms);
+}
+
+int DfxDsp::loadHrirSet(std::wstring hrir_file_full_path)
+{
+	return data_->loadHrirSet(hrir_file_full_path);
+}
+
+void DfxDsp::truePeakOn(bool on)
+{
+	data_->truePeakOn(on);
+}
+
+bool DfxDsp::isTruePeakOn()
+{
+	return data_->isTruePeakOn();
+}
+
+void DfxDsp::vocalReductionOn(bool on)
+{
+	data_->vocalReductionOn(on);
+}
+
+bool DfxDsp::isVocalReductionOn()
+{
+	return data_->isVocalReductionOn();
+}
+
+void DfxDsp::parallelSurroundOn(bool on)
+{
+	data_->parallelSurroundOn(on);
+}
+
+bool DfxDsp::isParallelSurroundOn()
+{
+	return data_->isParallelSurroundOn();
+}
+
+int DfxDsp::getLimiterLatency()
+{
+	return data_->getLimiterLatency();
 }
\ No newline at end of file
@@ -33,6 +33,8 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 *
 *  Checks if the value EQ stored in the registry has changed from what we
 *  currently think it is.  If it has changed, then update the display and DSP memory values accordingly.
+*  The "registry" values are read from the dfxp session store, so this does not touch the registry itself
+*  and is safe to call from the audio thread.
 *
 * This function only gets called in the sound card case, not in the XP dll based case that uses the winmm or dsound dll's.
 * It implements the dfxp calls required to update the EQ params in the DSP module.
@@ -99,8 +101,8 @@ int DfxDspPrivate::eqUpdateFromRegistry(int *ip_eq_changed)
 		{
 			*ip_eq_changed = IS_TRUE;
 
-			/* Set the new value */
-			if (dfxpEqSetBandBoostCut(dfxp_handle_, DFXP_STORAGE_TYPE_MEMORY, i_band_num, r_boost_cut_from_registry) != OKAY)
+			/* Ramp the processing to the new value */
+			if (dfxpParamRampEqBandBoostCut(dfxp_handle_, i_band_num, r_boost_cut_from_registry) != OKAY)
 				return(NOT_OKAY);
 
 			/* If it is band 1 that is being changed (the lowest band) then we need move the Hyperbass to match the EQ */
@@ -121,7 +123,7 @@ int DfxDspPrivate::resetEQ()
 
 	for (i_band_num = 2; i_band_num <= DFXP_GRAPHIC_EQ_NUM_BANDS; i_band_num++)
 	{
-		if (dfxpEqSetBandBoostCut(dfxp_handle_, DFXP_STORAGE_TYPE_ALL, i_band_num, (realtype)0.0) != OKAY)
+		if (dfxpParamSetEqBandBoostCut(dfxp_handle_, i_band_num, (realtype)0.0) != OKAY)
 			return(NOT_OKAY);
 	}
 
@@ -167,7 +169,7 @@ int DfxDspPrivate::getGraphicEqInfoFromVals(PT_HANDLE *hp_vals)
 			else
 				r_boost_cut = (realtype)0.0;
 
-			if (dfxpEqSetBandBoostCut(dfxp_handle_, DFXP_STORAGE_TYPE_ALL, i_band_num, r_boost_cut) != OKAY)
+			if (dfxpParamSetEqBandBoostCut(dfxp_handle_, i_band_num, r_boost_cut) != OKAY)
 				return(NOT_OKAY);
 		}
 	}
@@ -176,10 +178,7 @@ int DfxDspPrivate::getGraphicEqInfoFromVals(PT_HANDLE *hp_vals)
 		if (dfxpEqSetProcessingOn(dfxp_handle_, DFXP_STORAGE_TYPE_REGISTRY, i_eq_on) != OKAY)
 			return(NOT_OKAY);
 
-        PT_HANDLE* graphic_eq_handle;
-
-        dfxpEqGetGraphicEqHdl(dfxp_handle_, &graphic_eq_handle);
-
+		/* The bands are queued for the audio thread, which ramps to them, see dfxpParam.cpp */
 		for (i_band_num = 2; i_band_num <= DFXP_GRAPHIC_EQ_NUM_BANDS; i_band_num++)
 		{
 			r_boost_cut = (realtype)0.0;
@@ -187,21 +186,14 @@ int DfxDspPrivate::getGraphicEqInfoFromVals(PT_HANDLE *hp_vals)
 			if (GraphicEqGetBandBoostCut(hp_graphicEq, i_band_num, &r_boost_cut) != OKAY)
 				return(NOT_OKAY);
 
-			if (dfxpEqSetBandBoostCut(dfxp_handle_, DFXP_STORAGE_TYPE_ALL, i_band_num, r_boost_cut) != OKAY)
+			if (dfxpParamSetEqBandBoostCut(dfxp_handle_, i_band_num, r_boost_cut) != OKAY)
 				return(NOT_OKAY);
 
             if (GraphicEqGetBandCenterFrequency(hp_graphicEq, i_band_num, &r_freq) != OKAY)
                 return(NOT_OKAY);
 
-            if (GraphicEqSetBandFreq(graphic_eq_handle, i_band_num, r_freq) != OKAY)
+            if (dfxpParamSetEqBandFrequency(dfxp_handle_, i_band_num, r_freq) != OKAY)
                 return(NOT_OKAY);
-
-			/* If it is band 1 that is being changed (the lowest band) then we need move the Hyperbass to match the EQ */
-			if (i_band_num == 1)
-			{
-				if (eqMakeHyperBassMatchBand1(r_boost_cut) != OKAY)
-					return(NOT_OKAY);
-			}
 		}
 	}
 
@@ -210,6 +202,8 @@ int DfxDspPrivate::getGraphicEqInfoFromVals(PT_HANDLE *hp_vals)
 
 /*
  * Modeled after dfxg_EqMakeHyperBassMatchBand1() in dfxgEQ.cpp.
+ * Audio thread only, it is called from eqUpdateFromRegistry() in processTimer(), after the parameter
+ * queue has been drained. The button is sent straight on as the drain would, the knob is ramped.
  */
 int DfxDspPrivate::eqMakeHyperBassMatchBand1(realtype r_boost_cut_band1)
 {
@@ -257,7 +251,7 @@ int DfxDspPrivate::eqMakeHyperBassMatchBand1(realtype r_boost_cut_band1)
 	/* Set the new Hyperbass value.  We need to use a normalized value between 0.0 and 1.0 for this call */
 	r_normalized_hyperbass_val = r_new_hyperbass_val / (realtype)10.0;
 
-	if (dfxpSetKnobValue(dfxp_handle_, DFX_UI_KNOB_BASS_BOOST, (float)r_normalized_hyperbass_val, true) != OKAY)
+	if (dfxpParamRampKnobValue(dfxp_handle_, DFX_UI_KNOB_BASS_BOOST, (float)r_normalized_hyperbass_val) != OKAY)
 		return(NOT_OKAY);
 
 	return(OKAY);
@@ -268,10 +262,6 @@ int DfxDspPrivate::eqMakeHyperBassMatchBand1(realtype r_boost_cut_band1)
 */
 int DfxDspPrivate::eqSetProcessingOn(int i_storage_type, int i_on)
 {
-	wchar_t wcp_full_key_path[PT_MAX_PATH_STRLEN];
-	wchar_t wcp_key_value[DFXP_REGISTRY_BUFFER_LENGTH];
-
-
 	/* Store setting in memory (if requested) */
 	if ((i_storage_type == DFXP_STORAGE_TYPE_MEMORY) ||
 		(i_storage_type == DFXP_STORAGE_TYPE_ALL))
@@ -279,22 +269,11 @@ int DfxDspPrivate::eqSetProcessingOn(int i_storage_type, int i_on)
 		eq_processing_on_ = i_on;
 	}
 
-	/* Store setting in registry (if requested) */
+	/* Store setting in the dfxp session store, which saves it to the registry (if requested) */
 	if ((i_storage_type == DFXP_STORAGE_TYPE_REGISTRY) ||
 		(i_storage_type == DFXP_STORAGE_TYPE_ALL))
 	{
-		swprintf(wcp_full_key_path, L"%s\\%s\\%d\\%d\\%s\\%s\\%s",
-			DFXP_REGISTRY_TOP_WIDE,
-			product_specific_.wcp_registry_product_name,
-			product_specific_.major_version,
-			vendor_specific_.vendor_code,
-			DFXP_REGISTRY_LASTUSED_WIDE,
-			DFXP_REGISTRY_EQ_FOLDER_NAME_WIDE,
-			DFXP_REGISTRY_EQ_ON_WIDE);
-
-		swprintf(wcp_key_value, L"%d", i_on);
-
-		if (regCreateKey_Wide(REG_CURRENT_USER, wcp_full_key_path, wcp_key_value) != OKAY)
+		if (dfxpEqSetProcessingOn(dfxp_handle_, DFXP_STORAGE_TYPE_REGISTRY, i_on) != OKAY)
 			return(NOT_OKAY);
 	}
 
@@ -306,12 +285,6 @@ int DfxDspPrivate::eqSetProcessingOn(int i_storage_type, int i_on)
 */
 int DfxDspPrivate::eqGetProcessingOn(int i_storage_type, int *ip_on)
 {
-	wchar_t wcp_full_key_path[PT_MAX_PATH_STRLEN];
-	wchar_t wcp_key_value[DFXP_REGISTRY_BUFFER_LENGTH];
-	int key_exists;
-	int use_default;
-	int is_long;
-
 	*ip_on = IS_TRUE;
 
 	if (i_storage_type == DFXP_STORAGE_TYPE_MEMORY)
@@ -320,33 +293,7 @@ int DfxDspPrivate::eqGetProcessingOn(int i_storage_type, int *ip_on)
 		return(OKAY);
 	}
 
-	swprintf(wcp_full_key_path, L"%s\\%s\\%d\\%d\\%s\\%s\\%s",
-		DFXP_REGISTRY_TOP_WIDE,
-		product_specific_.wcp_registry_product_name,
-		product_specific_.major_version,
-		vendor_specific_.vendor_code,
-		DFXP_REGISTRY_LASTUSED_WIDE,
-		DFXP_REGISTRY_EQ_FOLDER_NAME_WIDE,
-		DFXP_REGISTRY_EQ_ON_WIDE);
-
-	if (regReadKey_Wide(REG_CURRENT_USER, wcp_full_key_path, &key_exists, wcp_key_value,
-		(unsigned long)DFXP_REGISTRY_BUFFER_LENGTH) != OKAY)
-		return(NOT_OKAY);
-
-	use_default = IS_TRUE;
-
-	if (key_exists)
-	{
-		if (mthIsLong_Wide(wcp_key_value, &is_long) != OKAY)
-			return(NOT_OKAY);
-		if (is_long)
-			use_default = IS_FALSE;
-	}
-
-	if (!use_default)
-		*ip_on = _wtoi(wcp_key_value);
-
-	return(OKAY);
+	return( dfxpEqGetProcessingOn(dfxp_handle_, DFXP_STORAGE_TYPE_REGISTRY, ip_on) );
 }
 
 void DfxDspPrivate::eqOn(bool on)
@@ -384,12 +331,7 @@ float DfxDspPrivate::getEqBandFrequency(int band_num)
 
 void DfxDspPrivate::setEqBandFrequency(int band_num, float freq)
 {
-
-    PT_HANDLE* graphic_eq_handle;
-
-    dfxpEqGetGraphicEqHdl(dfxp_handle_, &graphic_eq_handle);
-
-    GraphicEqSetBandFreq(graphic_eq_handle, band_num + 1, freq);
+    dfxpParamSetEqBandFrequency(dfxp_handle_, band_num + 1, freq);
 }
 
 void DfxDspPrivate::getEqBandFrequencyRange(int band_num, float* min_freq, float* max_freq)
@@ -406,18 +348,16 @@ void DfxDspPrivate::getEqBandFrequencyRange(int band_num, float* min_freq, float
 
 float DfxDspPrivate::getEqBandBoostCut(int band_num)
 {
-    PT_HANDLE* graphic_eq_handle;
-
-	float band_boost_cut = 0.0;
-
-    dfxpEqGetGraphicEqHdl(dfxp_handle_, &graphic_eq_handle);
+	realtype band_boost_cut = 0.0;
+	wchar_t wcp_boost_cut[PT_MAX_GENERIC_STRLEN];
 
-	GraphicEqGetBandBoostCut(graphic_eq_handle, band_num + 1, &band_boost_cut);
+	// The session value, the processing may still be ramping to it
+	dfxpEqGetBandBoostCut_FromRegistry(dfxp_handle_, band_num + 1, &band_boost_cut, wcp_boost_cut);
 
 	return band_boost_cut;
 }
 
 void DfxDspPrivate::setEqBandBoostCut(int band_num, float boost)
 {
-	dfxpEqSetBandBoostCut(dfxp_handle_, DFXP_STORAGE_TYPE_ALL, band_num + 1, boost);
+	dfxpParamSetEqBandBoostCut(dfxp_handle_, band_num + 1, boost);
 }
\ No newline at end of file
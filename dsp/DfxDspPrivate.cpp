@@ -73,7 +73,7 @@ DfxDspPrivate::DfxDspPrivate()
 	}
 
 	// Make sure the vocal reduction is turned off 
-	if (dfxpSetButtonValue(dfxp_handle_, DFX_UI_BUTTON_VOCAL_REDUCTION_ON, IS_FALSE) != OKAY)
+	if (dfxpParamSetButtonValue(dfxp_handle_, DFX_UI_BUTTON_VOCAL_REDUCTION_ON, IS_FALSE) != OKAY)
 	{
 		//return(NOT_OKAY);
 	}
@@ -151,25 +151,27 @@ dfxg_UpdateFromRegistryAllSettings()
 **/
 void DfxDspPrivate::processTimer()
 {
-	bool anything_changed = false;
 	int i_eq_changed = IS_FALSE;
+	unsigned long ul_generation;
 
-	if (update_from_registry_)
-	{
-		eqUpdateFromRegistry(&i_eq_changed);
-	}
+	/* Pick up the knob, button and EQ changes queued by the setters, knobs and EQ bands start ramping to their new values */
+	dfxpParamDrain(dfxp_handle_);
 
-	if (i_eq_changed)
-	{
-		anything_changed = true;
-	}
+	/* The session values only need comparing when one of them has been set since the last comparison */
+	dfxpGetSessionGeneration(dfxp_handle_, &ul_generation);
 
-	/* If any settings have been changed, communicate all the changes to the DSP module */
-	// NOTE: I find that without this if condition and call dfxpCOmmunicateAll() repeatedly will mess up the audio.
-	if (anything_changed)
+	if (update_from_registry_ && ((ul_generation == 0) || (ul_generation != session_generation_)))
 	{
-		dfxpCommunicateAll(dfxp_handle_);
+		session_generation_ = ul_generation;
+		eqUpdateFromRegistry(&i_eq_changed);
 	}
+
+	/*
+	 * EQ changes are applied to the graphic EQ directly, so only the knobs and buttons changed since
+	 * they were last sent are communicated, each to the com handles that use it.
+	 * NOTE: dfxpCommunicateAll() also resends the fixed settings, which must not be repeated while playing.
+	 */
+	dfxpCommunicateChanged(dfxp_handle_);
 }
 
 int DfxDspPrivate::processAudio(short int *si_input_samples, short int *si_output_samples, int i_num_sample_sets, int i_check_for_duplicate_buffers)
@@ -182,6 +184,16 @@ int DfxDspPrivate::processAudio(short int *si_input_samples, short int *si_outpu
 	return OKAY;
 }
 
+int DfxDspPrivate::processAudio(float *fp_samples, int i_num_sample_sets, int i_check_for_duplicate_buffers)
+{
+	processTimer();
+	// In place processing of a 32 bit float buffer, no copy from input to output.
+	if (dfxpUniversalModifyFloatSamples(dfxp_handle_, (realtype *)fp_samples, i_num_sample_sets, i_check_for_duplicate_buffers) != OKAY)
+		return(NOT_OKAY);
+
+	return OKAY;
+}
+
 int DfxDspPrivate::setSignalFormat(int i_bps, int i_nch, int i_srate, int i_valid_bits)
 {
 	if (dfxpUniversalSetSignalFormat(dfxp_handle_, i_bps, i_nch, i_srate, i_valid_bits) != OKAY)
@@ -190,18 +202,26 @@ int DfxDspPrivate::setSignalFormat(int i_bps, int i_nch, int i_srate, int i_vali
 	return OKAY;
 }
 
+int DfxDspPrivate::setMaxBlockSize(int i_max_sample_sets)
+{
+	if (dfxpUniversalSetMaxBlockSize(dfxp_handle_, i_max_sample_sets) != OKAY)
+		return(NOT_OKAY);
+
+	return OKAY;
+}
+
 
 void DfxDspPrivate::powerOn(bool on)
 {
 	if (on)
 	{
-		if (dfxpSetButtonValue(dfxp_handle_, DFX_UI_BUTTON_BYPASS, 0) != OKAY)
+		if (dfxpParamSetButtonValue(dfxp_handle_, DFX_UI_BUTTON_BYPASS, 0) != OKAY)
 		{
 		}
 	}
 	else
 	{
-		if (dfxpSetButtonValue(dfxp_handle_, DFX_UI_BUTTON_BYPASS, 1) != OKAY)
+		if (dfxpParamSetButtonValue(dfxp_handle_, DFX_UI_BUTTON_BYPASS, 1) != OKAY)
 		{
 		}
 	}
@@ -288,14 +308,14 @@ void DfxDspPrivate::setEffectValue(DfxDsp::Effect effect, float value)
 
 	if (value != 0.0)
 	{
-		dfxpSetButtonValue(dfxp_handle_, button, 1);
+		dfxpParamSetButtonValue(dfxp_handle_, button, 1);
 	}
 	else
 	{
-		dfxpSetButtonValue(dfxp_handle_, button, 0);
+		dfxpParamSetButtonValue(dfxp_handle_, button, 0);
 	}
 
-	dfxpSetKnobValue(dfxp_handle_, knob, (realtype)value / (realtype)10.0, false);
+	dfxpParamSetKnobValue(dfxp_handle_, knob, (realtype)value / (realtype)10.0);
 }
 
 unsigned long DfxDspPrivate::getTotalAudioProcessedTime()
@@ -324,156 +344,9 @@ int DfxDspPrivate::dfxpFreeAll()
 	if (cast_handle == NULL)
 		return(OKAY);
 
-	/* Free all the midi_to_dsp qnt handles */
-	if (cast_handle->midi_to_dsp.fidelity_qnt_hdl != NULL)
-	{
-		if (qntFreeUp(&(cast_handle->midi_to_dsp.fidelity_qnt_hdl)) != OKAY)
-			return(NOT_OKAY);
-	}
-
-	if (cast_handle->midi_to_dsp.spaciousness_qnt_hdl != NULL)
-	{
-		if (qntFreeUp(&(cast_handle->midi_to_dsp.spaciousness_qnt_hdl)) != OKAY)
-			return(NOT_OKAY);
-	}
-
-	if (cast_handle->midi_to_dsp.ambience_qnt_hdl != NULL)
-	{
-		if (qntFreeUp(&(cast_handle->midi_to_dsp.ambience_qnt_hdl)) != OKAY)
-			return(NOT_OKAY);
-	}
-
-	if (cast_handle->midi_to_dsp.dynamic_boost_qnt_hdl != NULL)
-	{
-		if (qntFreeUp(&(cast_handle->midi_to_dsp.dynamic_boost_qnt_hdl)) != OKAY)
-			return(NOT_OKAY);
-	}
-
-	if (cast_handle->midi_to_dsp.bass_boost_qnt_hdl != NULL)
-	{
-		if (qntFreeUp(&(cast_handle->midi_to_dsp.bass_boost_qnt_hdl)) != OKAY)
-			return(NOT_OKAY);
-	}
-
-	/* Fixed Aural Activation Specific */
-	if (cast_handle->midi_to_dsp.aural_filter_gain_qnt_hdl != NULL)
-	{
-		if (qntFreeUp(&(cast_handle->midi_to_dsp.aural_filter_gain_qnt_hdl)) != OKAY)
-			return(NOT_OKAY);
-	}
-
-	if (cast_handle->midi_to_dsp.aural_filter_a1_qnt_hdl != NULL)
-	{
-		if (qntFreeUp(&(cast_handle->midi_to_dsp.aural_filter_a1_qnt_hdl)) != OKAY)
-			return(NOT_OKAY);
-	}
-
-	if (cast_handle->midi_to_dsp.aural_filter_a0_qnt_hdl != NULL)
-	{
-		if (qntFreeUp(&(cast_handle->midi_to_dsp.aural_filter_a0_qnt_hdl)) != OKAY)
-			return(NOT_OKAY);
-	}
-
-	/* Fixed Reverb Specific */
-	if (cast_handle->midi_to_dsp.room_size_qnt_hdl != NULL)
-	{
-		if (qntFreeUp(&(cast_handle->midi_to_dsp.room_size_qnt_hdl)) != OKAY)
-			return(NOT_OKAY);
-	}
-
-	if (cast_handle->midi_to_dsp.damping_bandwidth_qnt_hdl != NULL)
-	{
-		if (qntFreeUp(&(cast_handle->midi_to_dsp.damping_bandwidth_qnt_hdl)) != OKAY)
-			return(NOT_OKAY);
-	}
-
-	if (cast_handle->midi_to_dsp.rolloff_bandwidth_qnt_hdl != NULL)
-	{
-		if (qntFreeUp(&(cast_handle->midi_to_dsp.rolloff_bandwidth_qnt_hdl)) != OKAY)
-			return(NOT_OKAY);
-	}
-
-	if (cast_handle->midi_to_dsp.motion_rate_qnt_hdl != NULL)
-	{
-		if (qntFreeUp(&(cast_handle->midi_to_dsp.motion_rate_qnt_hdl)) != OKAY)
-			return(NOT_OKAY);
-	}
-
-	if (cast_handle->midi_to_dsp.motion_depth_qnt_hdl != NULL)
-	{
-		if (qntFreeUp(&(cast_handle->midi_to_dsp.motion_depth_qnt_hdl)) != OKAY)
-			return(NOT_OKAY);
-	}
-
-	if (cast_handle->midi_to_dsp.screen_lex_main_knob3_qnt_hdl != NULL)
-	{
-		if (qntFreeUp(&(cast_handle->midi_to_dsp.screen_lex_main_knob3_qnt_hdl)) != OKAY)
-			return(NOT_OKAY);
-	}
-
-	if (cast_handle->midi_to_dsp.screen_lex_main_knob4_qnt_hdl != NULL)
-	{
-		if (qntFreeUp(&(cast_handle->midi_to_dsp.screen_lex_main_knob4_qnt_hdl)) != OKAY)
-			return(NOT_OKAY);
-	}
-
-	/* Fixed Optimizer Specific */
-	if (cast_handle->midi_to_dsp.release_time_beta_qnt_hdl != NULL)
-	{
-		if (qntFreeUp(&(cast_handle->midi_to_dsp.release_time_beta_qnt_hdl)) != OKAY)
-			return(NOT_OKAY);
-	}
-
-	if (cast_handle->midi_to_dsp.screen_opt_main_knob3_qnt_hdl != NULL)
-	{
-		if (qntFreeUp(&(cast_handle->midi_to_dsp.screen_opt_main_knob3_qnt_hdl)) != OKAY)
-			return(NOT_OKAY);
-	}
-
-	/* Fixed Widener Specific */
-	if (cast_handle->midi_to_dsp.dispersion_delay_qnt_hdl != NULL)
-	{
-		if (qntFreeUp(&(cast_handle->midi_to_dsp.dispersion_delay_qnt_hdl)) != OKAY)
-			return(NOT_OKAY);
-	}
-
-	if (cast_handle->midi_to_dsp.wid_filter_gain_qnt_hdl != NULL)
-	{
-		if (qntFreeUp(&(cast_handle->midi_to_dsp.wid_filter_gain_qnt_hdl)) != OKAY)
-			return(NOT_OKAY);
-	}
-
-	if (cast_handle->midi_to_dsp.wid_filter_a1_qnt_hdl != NULL)
-	{
-		if (qntFreeUp(&(cast_handle->midi_to_dsp.wid_filter_a1_qnt_hdl)) != OKAY)
-			return(NOT_OKAY);
-	}
-
-	if (cast_handle->midi_to_dsp.wid_filter_a0_qnt_hdl != NULL)
-	{
-		if (qntFreeUp(&(cast_handle->midi_to_dsp.wid_filter_a0_qnt_hdl)) != OKAY)
-			return(NOT_OKAY);
-	}
-
-	/* Delay specific */
-	if (cast_handle->midi_to_dsp.dly_qnt_hdl != NULL)
-	{
-		if (qntFreeUp(&(cast_handle->midi_to_dsp.dly_qnt_hdl)) != OKAY)
-			return(NOT_OKAY);
-	}
-
-	/* Free all the other qnt handles */
-	if (cast_handle->real_to_midi_qnt_hdl != NULL)
-	{
-		if (qntFreeUp(&(cast_handle->real_to_midi_qnt_hdl)) != OKAY)
-			return(NOT_OKAY);
-	}
-
-	if (cast_handle->midi_to_real_qnt_hdl != NULL)
-	{
-		if (qntFreeUp(&(cast_handle->midi_to_real_qnt_hdl)) != OKAY)
-			return(NOT_OKAY);
-	}
+	/* Release the qnt handles, which are shared with other instances */
+	if (dfxp_FreeAllQnts(dfxp_handle_) != OKAY)
+		return(NOT_OKAY);
 
 	/* Free the com handles */
 	if (cast_handle->com_hdl_front != NULL)
@@ -541,6 +414,18 @@ int DfxDspPrivate::dfxpFreeAll()
 			return(NOT_OKAY);
 	}
 
+	/* Free the internal sample buffers */
+	if (dfxp_FreeSampleBuffers(dfxp_handle_) != OKAY)
+		return(NOT_OKAY);
+
+	/* Free the parameter queue */
+	if (dfxp_ParamFree(dfxp_handle_) != OKAY)
+		return(NOT_OKAY);
+
+	/* Stop the session writer, saves any values not yet written to the registry */
+	if (dfxp_SessionStoreFree(dfxp_handle_) != OKAY)
+		return(NOT_OKAY);
+
 	return(OKAY);
 }
 
@@ -549,7 +434,74 @@ void DfxDspPrivate::getSpectrumBandValues(float* rp_band_values, int i_array_siz
     dfxpSpectrumGetBandValues(dfxp_handle_, rp_band_values, i_array_size);
 }
 
+int DfxDspPrivate::setSpectrumNumBands(int num_bands)
+{
+    return dfxpSpectrumSetNumBands(dfxp_handle_, num_bands);
+}
+
 void DfxDspPrivate::setVolumeNormalization(float target_rms)
 {
 	dfxpEqSetVolumeNormalization(dfxp_handle_, target_rms);
+}
+
+int DfxDspPrivate::loadHrirSet(std::wstring hrir_file_full_path)
+{
+	/* An empty path goes back to the built in headphone impulse responses */
+	if (hrir_file_full_path.empty())
+		return dfxpBinauralLoadHrirSet(dfxp_handle_, NULL);
+
+	return dfxpBinauralLoadHrirSet(dfxp_handle_, &hrir_file_full_path[0]);
+}
+
+void DfxDspPrivate::truePeakOn(bool on)
+{
+	dfxpSetTruePeakOn(dfxp_handle_, on ? IS_TRUE : IS_FALSE);
+}
+
+bool DfxDspPrivate::isTruePeakOn()
+{
+	int value;
+
+	dfxpGetTruePeakOn(dfxp_handle_, &value);
+
+	return (value != 0);
+}
+
+void DfxDspPrivate::vocalReductionOn(bool on)
+{
+	dfxpParamSetButtonValue(dfxp_handle_, DFX_UI_BUTTON_VOCAL_REDUCTION_ON, on ? IS_TRUE : IS_FALSE);
+}
+
+bool DfxDspPrivate::isVocalReductionOn()
+{
+	int value;
+
+	dfxpGetButtonValue(dfxp_handle_, DFX_UI_BUTTON_VOCAL_REDUCTION_ON, &value);
+
+	return (value != 0);
+}
+
+// Surround channel groups on worker threads, stays off on a single core machine
+void DfxDspPrivate::parallelSurroundOn(bool on)
+{
+	dfxpSetParallelSurround(dfxp_handle_, on ? IS_TRUE : IS_FALSE);
+}
+
+bool DfxDspPrivate::isParallelSurroundOn()
+{
+	int value;
+
+	dfxpGetParallelSurround(dfxp_handle_, &value);
+
+	return (value != 0);
+}
+
+// Sample sets the output limiter delays the signal by, larger in true peak mode
+int DfxDspPrivate::getLimiterLatency()
+{
+	int latency;
+
+	dfxpGetOptimizerLatency(dfxp_handle_, &latency);
+
+	return latency;
 }
\ No newline at end of file
@@ -0,0 +1,412 @@
+/*
+FxSound
+Copyright (C) 2025  FxSound LLC
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/* DfxRender.cpp */
+
+/*
+ * Offline file-in/file-out renderer for the DfxDsp engine.
+ *
+ *   DfxRender <input.wav> <output.wav> [preset.fac] [-b frames] [-off]
+ *
+ * The input wave is streamed through DfxDsp::processAudio() in buffers of the
+ * requested size, the processed wave is written out and the time spent inside
+ * the engine is reported as real-time factor, ns per frame and peak per-buffer time.
+ *
+ * Wave files are handled with plain stdio so no Win32 audio path is involved.
+ * 16 bit and 32 bit float files are passed to the engine as is, 24 bit files are
+ * converted to float with the pwav converters and processed on the float path.
+ *
+ * Only DfxRender.vcxproj is provided. The tool sources need nothing beyond stdio and
+ * the pwav converters, but the DfxDsp library it links still needs Win32 (registry
+ * session storage, shared memory and the WASAPI passthru), and this tree has no
+ * CMake or make build for it, so there is no Linux target yet.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "codedefs.h"
+#include "pt_defs.h"
+#include "Pwav.h"
+#include "DfxDsp.h"
+
+#define DFX_RENDER_DEFAULT_BUFFER_FRAMES 1024
+#define DFX_RENDER_MIN_BUFFER_FRAMES     16
+#define DFX_RENDER_MAX_BUFFER_FRAMES     65536
+#define DFX_RENDER_MAX_BLOCK_FRAMES      16384 /* Largest max block size the engine takes */
+
+#define DFX_RENDER_WAVE_FORMAT_PCM        0x0001
+#define DFX_RENDER_WAVE_FORMAT_IEEE_FLOAT 0x0003
+#define DFX_RENDER_WAVE_FORMAT_EXTENSIBLE 0xFFFE
+
+/* Description of the input file, filled in by dfxRender_ReadHeader() */
+struct dfxRenderWaveInfo {
+	int format_tag;
+	int num_channels;
+	long samp_freq;
+	int bits_per_sample;
+	int valid_bits;
+	int block_align;
+	long data_bytes;
+};
+
+static unsigned long dfxRender_GetLE(const unsigned char *ucp_bytes, int i_num_bytes)
+{
+	unsigned long ul_val = 0;
+
+	for (int i = i_num_bytes - 1; i >= 0; i--)
+		ul_val = (ul_val << 8) | ucp_bytes[i];
+
+	return(ul_val);
+}
+
+static void dfxRender_PutLE(unsigned char *ucp_bytes, unsigned long ul_val, int i_num_bytes)
+{
+	for (int i = 0; i < i_num_bytes; i++)
+	{
+		ucp_bytes[i] = (unsigned char)(ul_val & 0xFF);
+		ul_val >>= 8;
+	}
+}
+
+/*
+ * FUNCTION: dfxRender_ReadHeader()
+ * DESCRIPTION:
+ *   Stdio counterpart of pwavReadHeader(). Walks the RIFF chunks, fills in the
+ *   wave info and leaves the file positioned at the start of the sample data.
+ */
+static int dfxRender_ReadHeader(FILE *fp_in, struct dfxRenderWaveInfo *sp_info)
+{
+	unsigned char header[12];
+	unsigned char chunk[8];
+	unsigned char fmt[40];
+	int i_have_fmt = IS_FALSE;
+
+	memset(sp_info, 0, sizeof(struct dfxRenderWaveInfo));
+
+	if (fread(header, 1, 12, fp_in) != 12)
+		return(NOT_OKAY_NO_BREAK);
+	if ((memcmp(header, "RIFF", 4) != 0) || (memcmp(header + 8, "WAVE", 4) != 0))
+		return(NOT_OKAY_NO_BREAK);
+
+	while (fread(chunk, 1, 8, fp_in) == 8)
+	{
+		long l_chunk_size = (long)dfxRender_GetLE(chunk + 4, 4);
+
+		if (memcmp(chunk, "fmt ", 4) == 0)
+		{
+			long l_read_size = (l_chunk_size < (long)sizeof(fmt)) ? l_chunk_size : (long)sizeof(fmt);
+
+			if (l_read_size < 16)
+				return(NOT_OKAY_NO_BREAK);
+			if (fread(fmt, 1, l_read_size, fp_in) != (size_t)l_read_size)
+				return(NOT_OKAY_NO_BREAK);
+
+			sp_info->format_tag = (int)dfxRender_GetLE(fmt, 2);
+			sp_info->num_channels = (int)dfxRender_GetLE(fmt + 2, 2);
+			sp_info->samp_freq = (long)dfxRender_GetLE(fmt + 4, 4);
+			sp_info->block_align = (int)dfxRender_GetLE(fmt + 12, 2);
+			sp_info->bits_per_sample = (int)dfxRender_GetLE(fmt + 14, 2);
+			sp_info->valid_bits = sp_info->bits_per_sample;
+
+			/* WAVE_FORMAT_EXTENSIBLE carries the real format in the first 2 bytes of the sub format guid */
+			if ((sp_info->format_tag == DFX_RENDER_WAVE_FORMAT_EXTENSIBLE) && (l_read_size >= 26))
+			{
+				sp_info->valid_bits = (int)dfxRender_GetLE(fmt + 18, 2);
+				sp_info->format_tag = (int)dfxRender_GetLE(fmt + 24, 2);
+			}
+
+			if (l_chunk_size > l_read_size)
+				fseek(fp_in, l_chunk_size - l_read_size, SEEK_CUR);
+			i_have_fmt = IS_TRUE;
+		}
+		else if (memcmp(chunk, "data", 4) == 0)
+		{
+			if (!i_have_fmt)
+				return(NOT_OKAY_NO_BREAK);
+			sp_info->data_bytes = l_chunk_size;
+			return(OKAY);
+		}
+		else
+		{
+			/* Chunks are word aligned */
+			fseek(fp_in, l_chunk_size + (l_chunk_size & 1), SEEK_CUR);
+		}
+	}
+
+	return(NOT_OKAY_NO_BREAK);
+}
+
+/*
+ * FUNCTION: dfxRender_WriteHeader()
+ * DESCRIPTION:
+ *   Writes a canonical 44 byte wave header. Called once with a zero data size
+ *   before rendering and again after rendering to patch in the final sizes.
+ */
+static int dfxRender_WriteHeader(FILE *fp_out, struct dfxRenderWaveInfo *sp_info, long l_data_bytes)
+{
+	unsigned char header[44];
+	int i_format_tag = (sp_info->bits_per_sample == 32) ? DFX_RENDER_WAVE_FORMAT_IEEE_FLOAT : DFX_RENDER_WAVE_FORMAT_PCM;
+	int i_block_align = sp_info->num_channels * sp_info->bits_per_sample / 8;
+
+	memcpy(header, "RIFF", 4);
+	dfxRender_PutLE(header + 4, (unsigned long)(36 + l_data_bytes), 4);
+	memcpy(header + 8, "WAVEfmt ", 8);
+	dfxRender_PutLE(header + 16, 16, 4);
+	dfxRender_PutLE(header + 20, (unsigned long)i_format_tag, 2);
+	dfxRender_PutLE(header + 22, (unsigned long)sp_info->num_channels, 2);
+	dfxRender_PutLE(header + 24, (unsigned long)sp_info->samp_freq, 4);
+	dfxRender_PutLE(header + 28, (unsigned long)(sp_info->samp_freq * i_block_align), 4);
+	dfxRender_PutLE(header + 32, (unsigned long)i_block_align, 2);
+	dfxRender_PutLE(header + 34, (unsigned long)sp_info->bits_per_sample, 2);
+	memcpy(header + 36, "data", 4);
+	dfxRender_PutLE(header + 40, (unsigned long)l_data_bytes, 4);
+
+	if (fseek(fp_out, 0, SEEK_SET) != 0)
+		return(NOT_OKAY_NO_BREAK);
+	if (fwrite(header, 1, 44, fp_out) != 44)
+		return(NOT_OKAY_NO_BREAK);
+
+	return(OKAY);
+}
+
+static void dfxRender_Usage(void)
+{
+	fprintf(stderr, "usage: DfxRender <input.wav> <output.wav> [preset.fac] [-b frames] [-off]\n");
+	fprintf(stderr, "  -b frames  number of sample sets per processAudio() call (default %d)\n", DFX_RENDER_DEFAULT_BUFFER_FRAMES);
+	fprintf(stderr, "  -off       render with processing powered off (measures the bypass path)\n");
+}
+
+int main(int argc, char *argv[])
+{
+	const char *cp_in_path = NULL;
+	const char *cp_out_path = NULL;
+	const char *cp_preset_path = NULL;
+	int i_buffer_frames = DFX_RENDER_DEFAULT_BUFFER_FRAMES;
+	bool b_power_on = true;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if ((strcmp(argv[i], "-b") == 0) && (i + 1 < argc))
+			i_buffer_frames = atoi(argv[++i]);
+		else if (strcmp(argv[i], "-off") == 0)
+			b_power_on = false;
+		else if (cp_in_path == NULL)
+			cp_in_path = argv[i];
+		else if (cp_out_path == NULL)
+			cp_out_path = argv[i];
+		else if (cp_preset_path == NULL)
+			cp_preset_path = argv[i];
+		else
+		{
+			dfxRender_Usage();
+			return(1);
+		}
+	}
+
+	if ((cp_in_path == NULL) || (cp_out_path == NULL) ||
+		 (i_buffer_frames < DFX_RENDER_MIN_BUFFER_FRAMES) || (i_buffer_frames > DFX_RENDER_MAX_BUFFER_FRAMES))
+	{
+		dfxRender_Usage();
+		return(1);
+	}
+
+	FILE *fp_in = fopen(cp_in_path, "rb");
+	if (fp_in == NULL)
+	{
+		fprintf(stderr, "DfxRender: could not open %s\n", cp_in_path);
+		return(1);
+	}
+
+	struct dfxRenderWaveInfo in_info;
+	if (dfxRender_ReadHeader(fp_in, &in_info) != OKAY)
+	{
+		fprintf(stderr, "DfxRender: %s is not a readable wave file\n", cp_in_path);
+		fclose(fp_in);
+		return(1);
+	}
+
+	int i_is_float = (in_info.format_tag == DFX_RENDER_WAVE_FORMAT_IEEE_FLOAT);
+	if (!((in_info.format_tag == DFX_RENDER_WAVE_FORMAT_PCM) && ((in_info.bits_per_sample == 16) || (in_info.bits_per_sample == 24))) &&
+		 !(i_is_float && (in_info.bits_per_sample == 32)))
+	{
+		fprintf(stderr, "DfxRender: only 16/24 bit PCM and 32 bit float wave files are supported\n");
+		fclose(fp_in);
+		return(1);
+	}
+	if ((in_info.num_channels < 1) || (in_info.num_channels > 8) || (in_info.samp_freq <= 0))
+	{
+		fprintf(stderr, "DfxRender: unsupported channel count or sampling rate\n");
+		fclose(fp_in);
+		return(1);
+	}
+
+	FILE *fp_out = fopen(cp_out_path, "wb");
+	if (fp_out == NULL)
+	{
+		fprintf(stderr, "DfxRender: could not create %s\n", cp_out_path);
+		fclose(fp_in);
+		return(1);
+	}
+
+	/* 24 bit files are processed on the engine's float path */
+	int i_in_bytes_per_sample = in_info.bits_per_sample / 8;
+	int i_process_bits = (in_info.bits_per_sample == 24) ? 32 : in_info.bits_per_sample;
+	int i_process_valid_bits = (in_info.bits_per_sample == 24) ? 32 : in_info.valid_bits;
+	long l_total_frames = in_info.data_bytes / (in_info.num_channels * i_in_bytes_per_sample);
+
+	DfxDsp dfx_dsp;
+
+	if (cp_preset_path != NULL)
+	{
+		std::string preset_path(cp_preset_path);
+		std::wstring preset_path_wide(preset_path.begin(), preset_path.end());
+
+		if (dfx_dsp.loadPreset(preset_path_wide) != OKAY)
+		{
+			fprintf(stderr, "DfxRender: could not load preset %s\n", cp_preset_path);
+			fclose(fp_in);
+			fclose(fp_out);
+			return(1);
+		}
+	}
+	dfx_dsp.powerOn(b_power_on);
+
+	/* Longer buffers are accepted but processed in blocks, so only size for them when they fit */
+	if (i_buffer_frames <= DFX_RENDER_MAX_BLOCK_FRAMES)
+		dfx_dsp.setMaxBlockSize(i_buffer_frames);
+
+	if (dfx_dsp.setSignalFormat(i_process_bits, in_info.num_channels, (int)in_info.samp_freq, i_process_valid_bits) != OKAY)
+	{
+		fprintf(stderr, "DfxRender: engine rejected the signal format\n");
+		fclose(fp_in);
+		fclose(fp_out);
+		return(1);
+	}
+
+	if (dfxRender_WriteHeader(fp_out, &in_info, 0) != OKAY)
+	{
+		fprintf(stderr, "DfxRender: could not write %s\n", cp_out_path);
+		fclose(fp_in);
+		fclose(fp_out);
+		return(1);
+	}
+
+	int i_buffer_samples = i_buffer_frames * in_info.num_channels;
+	std::vector<char> file_buffer(i_buffer_samples * i_in_bytes_per_sample);
+	std::vector<realtype> in_float(i_buffer_samples);
+	std::vector<realtype> out_float(i_buffer_samples);
+	std::vector<char> out_buffer(i_buffer_samples * i_in_bytes_per_sample);
+
+	long l_frames_left = l_total_frames;
+	long l_frames_done = 0;
+	long l_num_buffers = 0;
+	long l_num_overruns = 0;
+	double d_total_ns = 0.0;
+	double d_peak_ns = 0.0;
+
+	while (l_frames_left > 0)
+	{
+		int i_frames = (l_frames_left > i_buffer_frames) ? i_buffer_frames : (int)l_frames_left;
+		int i_samples = i_frames * in_info.num_channels;
+		size_t bytes = (size_t)i_samples * i_in_bytes_per_sample;
+
+		if (fread(&file_buffer[0], 1, bytes, fp_in) != bytes)
+		{
+			fprintf(stderr, "DfxRender: short read, stopping after %ld frames\n", l_frames_done);
+			break;
+		}
+
+		short int *sip_in;
+		short int *sip_out;
+
+		if (in_info.bits_per_sample == 24)
+		{
+			pwav24BitToFloat(&file_buffer[0], &in_float[0], i_samples, IS_FALSE);
+			sip_in = (short int *)&in_float[0];
+			sip_out = (short int *)&out_float[0];
+		}
+		else
+		{
+			sip_in = (short int *)&file_buffer[0];
+			sip_out = (short int *)&out_buffer[0];
+		}
+
+		/* Only the engine call is timed, file I/O and format conversion are excluded */
+		auto start = std::chrono::steady_clock::now();
+		int i_status = dfx_dsp.processAudio(sip_in, sip_out, i_frames, IS_FALSE);
+		auto stop = std::chrono::steady_clock::now();
+
+		if (i_status != OKAY)
+		{
+			fprintf(stderr, "DfxRender: processAudio failed after %ld frames\n", l_frames_done);
+			break;
+		}
+
+		double d_ns = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start).count();
+		d_total_ns += d_ns;
+		if (d_ns > d_peak_ns)
+			d_peak_ns = d_ns;
+		if (d_ns > (double)i_frames * 1.0e9 / (double)in_info.samp_freq)
+			l_num_overruns++;
+
+		if (in_info.bits_per_sample == 24)
+			pwavFloatTo24Bit(&out_float[0], &out_buffer[0], i_samples, IS_FALSE);
+
+		if (fwrite(&out_buffer[0], 1, bytes, fp_out) != bytes)
+		{
+			fprintf(stderr, "DfxRender: write to %s failed\n", cp_out_path);
+			break;
+		}
+
+		l_frames_left -= i_frames;
+		l_frames_done += i_frames;
+		l_num_buffers++;
+	}
+
+	dfxRender_WriteHeader(fp_out, &in_info, l_frames_done * in_info.num_channels * i_in_bytes_per_sample);
+	fclose(fp_in);
+	fclose(fp_out);
+
+	if ((l_frames_done == 0) || (d_total_ns <= 0.0))
+	{
+		fprintf(stderr, "DfxRender: nothing was processed\n");
+		return(1);
+	}
+
+	double d_audio_secs = (double)l_frames_done / (double)in_info.samp_freq;
+	double d_process_secs = d_total_ns * 1.0e-9;
+	double d_buffer_budget_ns = (double)i_buffer_frames * 1.0e9 / (double)in_info.samp_freq;
+
+	printf("input           : %s\n", cp_in_path);
+	printf("format          : %d ch, %ld Hz, %d bit%s, %d frame buffers\n", in_info.num_channels, in_info.samp_freq,
+		in_info.bits_per_sample, i_is_float ? " float" : "", i_buffer_frames);
+	printf("preset          : %s%s\n", (cp_preset_path != NULL) ? cp_preset_path : "(default)", b_power_on ? "" : " [power off]");
+	printf("frames          : %ld in %ld buffers (%.3f s of audio)\n", l_frames_done, l_num_buffers, d_audio_secs);
+	printf("process time    : %.3f ms\n", d_process_secs * 1.0e3);
+	printf("real-time factor: %.5f (%.1fx faster than real time)\n", d_process_secs / d_audio_secs, d_audio_secs / d_process_secs);
+	printf("ns per frame    : %.2f\n", d_total_ns / (double)l_frames_done);
+	printf("peak buffer     : %.1f us (%.1f%% of the %.1f us buffer period)\n", d_peak_ns * 1.0e-3,
+		100.0 * d_peak_ns / d_buffer_budget_ns, d_buffer_budget_ns * 1.0e-3);
+	printf("overruns        : %ld\n", l_num_overruns);
+
+	return(0);
+}
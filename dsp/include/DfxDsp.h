@@ -39,7 +39,9 @@ public:
 	~DfxDsp();
 
 	int setSignalFormat(int i_bps, int i_nch, int i_srate, int i_valid_bits);
+	int setMaxBlockSize(int i_max_sample_sets);
 	int processAudio(short int *si_input_samples, short int *si_output_samples, int i_num_sample_sets, int i_check_for_duplicate_buffers);
+	int processAudio(float *fp_samples, int i_num_sample_sets, int i_check_for_duplicate_buffers);
 	int loadPreset(std::wstring preset_file_full_path);
 	int savePreset(std::wstring preset_name, std::wstring preset_file_full_path);
 	int exportPreset(std::wstring preset_source_file_full_path, std::wstring preset_name, std::wstring preset_export_path);
@@ -58,7 +60,16 @@ public:
 	unsigned long getTotalAudioProcessedTime();
 	void resetTotalAudioProcessedTime();
     void getSpectrumBandValues(float* rp_band_values, int i_array_size);
+    int setSpectrumNumBands(int num_bands);
 	void setVolumeNormalization(float target_rms);
+	int loadHrirSet(std::wstring hrir_file_full_path);
+	void truePeakOn(bool on);
+	bool isTruePeakOn();
+	void vocalReductionOn(bool on);
+	bool isVocalReductionOn();
+	void parallelSurroundOn(bool on);
+	bool isParallelSurroundOn();
+	int getLimiterLatency();
 
 private:
 	DfxDspPrivate *data_;
@@ -429,6 +429,97 @@ int COMSFTWR_DECL comSftwrZeroDspMemory(PT_HANDLE *hp_comSftwr)
 	return(OKAY);
 }
 
+/* Software dsp functions, sorted by name (strcmp order) for the binary
+ * search in comSftwrSetFunctionIndex(). The position is the order of the
+ * function in the function index array, where each position holds the
+ * 16 and 32 bit versions.
+ * dly-8, fla-2, chor-4, pitch-2, peq-8, trm-2, pan-2, rvrb-34, (62)
+ * multi-comp-1, aural-1, Max-1, lex-1, apit-1, play-1, comp-1, wide-1, proto-1 = (9)
+ * NOTE- CURRENTLY (62 + 9) * 2 = 142 FUNCTIONS.
+ * Check against setting of DSPS_MAX_NUM_PROC_FUNCTIONS
+ */
+struct comSftwrFunctionType {
+	const char *cp_name;
+	int position;
+	long memsize;
+};
+
+static const struct comSftwrFunctionType comSftwrFunctions[] = {
+	{ "R1s44r00", 44, DSPS_SOFT_MEM_REVERB_LENGTH },
+	{ "R1s44r20", 28, DSPS_SOFT_MEM_REVERB_LENGTH },
+	{ "R1s44r25", 29, DSPS_SOFT_MEM_REVERB_LENGTH },
+	{ "R1s44r30", 30, DSPS_SOFT_MEM_REVERB_LENGTH },
+	{ "R1s44r35", 31, DSPS_SOFT_MEM_REVERB_LENGTH },
+	{ "R1s44r40", 32, DSPS_SOFT_MEM_REVERB_LENGTH },
+	{ "R1s44r45", 33, DSPS_SOFT_MEM_REVERB_LENGTH },
+	{ "R1s44r50", 34, DSPS_SOFT_MEM_REVERB_LENGTH },
+	{ "R1s44r55", 35, DSPS_SOFT_MEM_REVERB_LENGTH },
+	{ "R1s44r60", 36, DSPS_SOFT_MEM_REVERB_LENGTH },
+	{ "R1s44r65", 37, DSPS_SOFT_MEM_REVERB_LENGTH },
+	{ "R1s44r70", 38, DSPS_SOFT_MEM_REVERB_LENGTH },
+	{ "R1s44r75", 39, DSPS_SOFT_MEM_REVERB_LENGTH },
+	{ "R1s44r80", 40, DSPS_SOFT_MEM_REVERB_LENGTH },
+	{ "R1s44r85", 41, DSPS_SOFT_MEM_REVERB_LENGTH },
+	{ "R1s44r90", 42, DSPS_SOFT_MEM_REVERB_LENGTH },
+	{ "R1s44r95", 43, DSPS_SOFT_MEM_REVERB_LENGTH },
+	{ "R1s48r00", 61, DSPS_SOFT_MEM_REVERB_LENGTH },
+	{ "R1s48r20", 45, DSPS_SOFT_MEM_REVERB_LENGTH },
+	{ "R1s48r25", 46, DSPS_SOFT_MEM_REVERB_LENGTH },
+	{ "R1s48r30", 47, DSPS_SOFT_MEM_REVERB_LENGTH },
+	{ "R1s48r35", 48, DSPS_SOFT_MEM_REVERB_LENGTH },
+	{ "R1s48r40", 49, DSPS_SOFT_MEM_REVERB_LENGTH },
+	{ "R1s48r45", 50, DSPS_SOFT_MEM_REVERB_LENGTH },
+	{ "R1s48r50", 51, DSPS_SOFT_MEM_REVERB_LENGTH },
+	{ "R1s48r55", 52, DSPS_SOFT_MEM_REVERB_LENGTH },
+	{ "R1s48r60", 53, DSPS_SOFT_MEM_REVERB_LENGTH },
+	{ "R1s48r65", 54, DSPS_SOFT_MEM_REVERB_LENGTH },
+	{ "R1s48r70", 55, DSPS_SOFT_MEM_REVERB_LENGTH },
+	{ "R1s48r75", 56, DSPS_SOFT_MEM_REVERB_LENGTH },
+	{ "R1s48r80", 57, DSPS_SOFT_MEM_REVERB_LENGTH },
+	{ "R1s48r85", 58, DSPS_SOFT_MEM_REVERB_LENGTH },
+	{ "R1s48r90", 59, DSPS_SOFT_MEM_REVERB_LENGTH },
+	{ "R1s48r95", 60, DSPS_SOFT_MEM_REVERB_LENGTH },
+	{ "apt0",     66, DSPS_SOFT_MEM_APIT_LENGTH },
+	{ "aural0",   63, DSPS_SOFT_MEM_AURAL_ENHANCER_LENGTH },
+	{ "chor1",    10, DSPS_SOFT_MEM_CHORUS_LENGTH },
+	{ "chor2",    11, DSPS_SOFT_MEM_CHORUS_LENGTH },
+	{ "chor3",    12, DSPS_SOFT_MEM_CHORUS_LENGTH },
+	{ "chor4",    13, DSPS_SOFT_MEM_CHORUS_LENGTH },
+	{ "cmp0",     68, DSPS_SOFT_MEM_COMP_LENGTH },
+	{ "cmp8",     62, DSPS_SOFT_MEM_MULTI_COMP_LENGTH },
+	{ "dly1",      0, DSPS_SOFT_MEM_DELAY_LENGTH },
+	{ "dly2",      1, DSPS_SOFT_MEM_DELAY_LENGTH },
+	{ "dly3",      2, DSPS_SOFT_MEM_DELAY_LENGTH },
+	{ "dly4",      3, DSPS_SOFT_MEM_DELAY_LENGTH },
+	{ "dly5",      4, DSPS_SOFT_MEM_DELAY_LENGTH },
+	{ "dly6",      5, DSPS_SOFT_MEM_DELAY_LENGTH },
+	{ "dly7",      6, DSPS_SOFT_MEM_DELAY_LENGTH },
+	{ "dly8",      7, DSPS_SOFT_MEM_DELAY_LENGTH },
+	{ "flang1",    8, DSPS_SOFT_MEM_FLANGE_LENGTH },
+	{ "flang2",    9, DSPS_SOFT_MEM_FLANGE_LENGTH },
+	{ "lex0",     65, DSPS_SOFT_MEM_LEX_LENGTH },
+	{ "max0",     64, DSPS_SOFT_MEM_MAXIMIZER_LENGTH },
+	{ "pan1",     26, DSPS_SOFT_MEM_PAN_LENGTH },
+	{ "pan2",     27, DSPS_SOFT_MEM_PAN_LENGTH },
+	{ "peq1",     16, DSPS_SOFT_MEM_PEQ_LENGTH },
+	{ "peq2",     17, DSPS_SOFT_MEM_PEQ_LENGTH },
+	{ "peq3",     18, DSPS_SOFT_MEM_PEQ_LENGTH },
+	{ "peq4",     19, DSPS_SOFT_MEM_PEQ_LENGTH },
+	{ "peq5",     20, DSPS_SOFT_MEM_PEQ_LENGTH },
+	{ "peq6",     21, DSPS_SOFT_MEM_PEQ_LENGTH },
+	{ "peq7",     22, DSPS_SOFT_MEM_PEQ_LENGTH },
+	{ "peq8",     23, DSPS_SOFT_MEM_PEQ_LENGTH },
+	{ "pitch1",   14, DSPS_SOFT_MEM_PITCH_LENGTH },
+	{ "pitch2",   15, DSPS_SOFT_MEM_PITCH_LENGTH },
+	{ "ply0",     67, DSPS_SOFT_MEM_PLAY_LENGTH },
+	{ "proto10",  70, DSPS_SOFT_MEM_PROTO1_LENGTH },
+	{ "trm1",     24, DSPS_SOFT_MEM_TREMOLO_LENGTH },
+	{ "trm2",     25, DSPS_SOFT_MEM_TREMOLO_LENGTH },
+	{ "wid0",     69, DSPS_SOFT_MEM_WIDE_LENGTH },
+};
+
+#define COMSFTWR_NUM_FUNCTIONS (int)(sizeof(comSftwrFunctions) / sizeof(comSftwrFunctions[0]))
+
 /* For software based Dsp engine, sets function index
  * to reference the desired init and processing functions.
  * This could be improved by having DSP/FX pass a defined
@@ -447,6 +538,9 @@ int COMSFTWR_DECL comSftwrSetFunctionIndex(PT_HANDLE *hp_comSftwr, char *cp_dspn
 	int index = 0;
 	long memsize = 0;
 	int offset = 0;
+	int low;
+	int high;
+	const struct comSftwrFunctionType *sp_function;
 	struct comSftwrHdlType *cast_handle;
 
 	cast_handle = (struct comSftwrHdlType *)hp_comSftwr;
@@ -467,338 +561,33 @@ int COMSFTWR_DECL comSftwrSetFunctionIndex(PT_HANDLE *hp_comSftwr, char *cp_dspn
 	if(s_bit_width == 32)
 		offset = 1;
 
-	/* Use do/while structure to enable use of break to jump
-	 * out when we match the program name.
-	 * dly-8, fla-2, chor-4, pitch-2, peq-8, trm-2, pan-2, rvrb-34, (62)
-	 * multi-comp-1, aural-1, Max-1, lex-1, apit-1, play-1, comp-1, wide-1, proto-1 = (9)
-	 * NOTE- CURRENTLY (62 + 9) * 2 = 142 FUNCTIONS.
-	 * Check against setting of DSPS_MAX_NUM_PROC_FUNCTIONS
-	 * Note that we have to skip 2 to jump over both 16 and 32 bit functions.
-	 */
-	do
+	/* Binary search of the sorted function table */
+	low = 0;
+	high = COMSFTWR_NUM_FUNCTIONS - 1;
+	sp_function = NULL;
+	while (low <= high)
 	{
-		memsize = DSPS_SOFT_MEM_DELAY_LENGTH;
-		if( strcmp(cp_dspname, "dly1") == 0 )
-			break;
-		else
-			index += 2;
-		if( strcmp(cp_dspname, "dly2") == 0 )
-			break;
-		else 
-			index += 2;
-		if( strcmp(cp_dspname, "dly3") == 0 )
-			break;
-		else
-			index += 2;
-		if( strcmp(cp_dspname, "dly4") == 0 )
-			break;
-		else
-			index += 2;
-		if( strcmp(cp_dspname, "dly5") == 0 )
-			break;
-		else
-			index += 2;
-		if( strcmp(cp_dspname, "dly6") == 0 )
-			break;
-		else
-			index += 2;
-		if( strcmp(cp_dspname, "dly7") == 0 )
-			break;
-		else
-			index += 2;
-		if( strcmp(cp_dspname, "dly8") == 0 )
-			break;
-		else
-			index += 2;
-
-		memsize = DSPS_SOFT_MEM_FLANGE_LENGTH;
-		if( strcmp(cp_dspname, "flang1") == 0 )
-			break;
-		else
-			index += 2;
-		if( strcmp(cp_dspname, "flang2") == 0 )
-			break;
-		else
-			index += 2;
-
-		memsize = DSPS_SOFT_MEM_CHORUS_LENGTH;
-		if( strcmp(cp_dspname, "chor1") == 0 )
-			break;
-		else
-			index += 2;
-		if( strcmp(cp_dspname, "chor2") == 0 )
-			break;
-		else
-			index += 2;
-		if( strcmp(cp_dspname, "chor3") == 0 )
-			break;
-		else
-			index += 2;
-		if( strcmp(cp_dspname, "chor4") == 0 )
-			break;
-		else
-			index += 2;
-
-		memsize = DSPS_SOFT_MEM_PITCH_LENGTH;
-		if( strcmp(cp_dspname, "pitch1") == 0 )
-			break;
-		else
-			index += 2;
-		if( strcmp(cp_dspname, "pitch2") == 0 )
-			break;
-		else
-			index += 2;
-
-		memsize = DSPS_SOFT_MEM_PEQ_LENGTH;
-		if( strcmp(cp_dspname, "peq1") == 0 )
-			break;
-		else
-			index += 2;
-		if( strcmp(cp_dspname, "peq2") == 0 )
-			break;
-		else
-			index += 2;
-		if( strcmp(cp_dspname, "peq3") == 0 )
-			break;
-		else
-			index += 2;
-		if( strcmp(cp_dspname, "peq4") == 0 )
-			break;
-		else
-			index += 2;
-		if( strcmp(cp_dspname, "peq5") == 0 )
-			break;
-		else
-			index += 2;
-		if( strcmp(cp_dspname, "peq6") == 0 )
-			break;
-		else
-			index += 2;
-		if( strcmp(cp_dspname, "peq7") == 0 )
-			break;
-		else
-			index += 2;
-		if( strcmp(cp_dspname, "peq8") == 0 )
-			break;
-		else
-			index += 2;
-
-		memsize = DSPS_SOFT_MEM_TREMOLO_LENGTH;
-		if( strcmp(cp_dspname, "trm1") == 0 )
-			break;
-		else
-			index += 2;
-		if( strcmp(cp_dspname, "trm2") == 0 )
-			break;
-		else
-			index += 2;
+		int mid = (low + high) / 2;
+		int cmp = strcmp(cp_dspname, comSftwrFunctions[mid].cp_name);
 
-		memsize = DSPS_SOFT_MEM_PAN_LENGTH;
-		if( strcmp(cp_dspname, "pan1") == 0 )
-			break;
-		else
-			index += 2;
-		if( strcmp(cp_dspname, "pan2") == 0 )
-			break;
-		else
-			index += 2;
-
-		memsize = DSPS_SOFT_MEM_REVERB_LENGTH;
-		if( strcmp(cp_dspname, "R1s44r20") == 0 )
-			break;
-		else
-			index += 2;
-		if( strcmp(cp_dspname, "R1s44r25") == 0 )
-			break;
-		else
-			index += 2;
-		if( strcmp(cp_dspname, "R1s44r30") == 0 )
-			break;
-		else
-			index += 2;
-		if( strcmp(cp_dspname, "R1s44r35") == 0 )
-			break;
-		else
-			index += 2;
-		if( strcmp(cp_dspname, "R1s44r40") == 0 )
-			break;
-		else
-			index += 2;
-		if( strcmp(cp_dspname, "R1s44r45") == 0 )
-			break;
-		else
-			index += 2;
-		if( strcmp(cp_dspname, "R1s44r50") == 0 )
-			break;
-		else
-			index += 2;
-		if( strcmp(cp_dspname, "R1s44r55") == 0 )
-			break;
-		else
-			index += 2;
-		if( strcmp(cp_dspname, "R1s44r60") == 0 )
-			break;
-		else
-			index += 2;
-		if( strcmp(cp_dspname, "R1s44r65") == 0 )
-			break;
-		else
-			index += 2;
-		if( strcmp(cp_dspname, "R1s44r70") == 0 )
-			break;
-		else
-			index += 2;
-		if( strcmp(cp_dspname, "R1s44r75") == 0 )
-			break;
-		else
-			index += 2;
-		if( strcmp(cp_dspname, "R1s44r80") == 0 )
-			break;
-		else
-			index += 2;
-		if( strcmp(cp_dspname, "R1s44r85") == 0 )
-			break;
-		else
-			index += 2;
-		if( strcmp(cp_dspname, "R1s44r90") == 0 )
-			break;
-		else
-			index += 2;
-		if( strcmp(cp_dspname, "R1s44r95") == 0 )
-			break;
-		else
-			index += 2;
-		if( strcmp(cp_dspname, "R1s44r00") == 0 )
-			break;
-		else
-			index += 2;
-		if( strcmp(cp_dspname, "R1s48r20") == 0 )
-			break;
-		else
-			index += 2;
-		if( strcmp(cp_dspname, "R1s48r25") == 0 )
-			break;
-		else
-			index += 2;
-		if( strcmp(cp_dspname, "R1s48r30") == 0 )
-			break;
-		else
-			index += 2;
-		if( strcmp(cp_dspname, "R1s48r35") == 0 )
-			break;
-		else
-			index += 2;
-		if( strcmp(cp_dspname, "R1s48r40") == 0 )
-			break;
-		else
-			index += 2;
-		if( strcmp(cp_dspname, "R1s48r45") == 0 )
-			break;
-		else
-			index += 2;
-		if( strcmp(cp_dspname, "R1s48r50") == 0 )
-			break;
-		else
-			index += 2;
-		if( strcmp(cp_dspname, "R1s48r55") == 0 )
-			break;
-		else
-			index += 2;
-		if( strcmp(cp_dspname, "R1s48r60") == 0 )
-			break;
-		else
-			index += 2;
-		if( strcmp(cp_dspname, "R1s48r65") == 0 )
-			break;
-		else
-			index += 2;
-		if( strcmp(cp_dspname, "R1s48r70") == 0 )
-			break;
-		else
-			index += 2;
-		if( strcmp(cp_dspname, "R1s48r75") == 0 )
-			break;
-		else
-			index += 2;
-		if( strcmp(cp_dspname, "R1s48r80") == 0 )
-			break;
-		else
-			index += 2;
-		if( strcmp(cp_dspname, "R1s48r85") == 0 )
-			break;
-		else
-			index += 2;
-		if( strcmp(cp_dspname, "R1s48r90") == 0 )
-			break;
-		else
-			index += 2;
-		if( strcmp(cp_dspname, "R1s48r95") == 0 )
-			break;
-		else
-			index += 2;
-		if( strcmp(cp_dspname, "R1s48r00") == 0 )
-			break;
-		else
-			index += 2;
-
-		memsize = DSPS_SOFT_MEM_MULTI_COMP_LENGTH;
-		if( strcmp(cp_dspname, "cmp8") == 0 )
-			break;
-		else
-			index += 2;
-
-		memsize = DSPS_SOFT_MEM_AURAL_ENHANCER_LENGTH;
-		if( strcmp(cp_dspname, "aural0") == 0 )
-			break;
-		else
-			index += 2;
-
-		memsize = DSPS_SOFT_MEM_MAXIMIZER_LENGTH;
-		if( strcmp(cp_dspname, "max0") == 0 )
-			break;
-		else
-			index += 2;
-
-		memsize = DSPS_SOFT_MEM_LEX_LENGTH;
-		if( strcmp(cp_dspname, "lex0") == 0 )
-			break;
-		else
-			index += 2;
-
-		memsize = DSPS_SOFT_MEM_APIT_LENGTH;
-		if( strcmp(cp_dspname, "apt0") == 0 )
-			break;
-		else
-			index += 2;
-
-		memsize = DSPS_SOFT_MEM_PLAY_LENGTH;
-		if( strcmp(cp_dspname, "ply0") == 0 )
-			break;
-		else
-			index += 2;
-
-		memsize = DSPS_SOFT_MEM_COMP_LENGTH;
-		if( strcmp(cp_dspname, "cmp0") == 0 )
-			break;
-		else
-			index += 2;
-
-		memsize = DSPS_SOFT_MEM_WIDE_LENGTH;
-		if( strcmp(cp_dspname, "wid0") == 0 )
+		if (cmp == 0)
+		{
+			sp_function = &(comSftwrFunctions[mid]);
 			break;
+		}
+		else if (cmp < 0)
+			high = mid - 1;
 		else
-			index += 2;
+			low = mid + 1;
+	}
 
-		memsize = DSPS_SOFT_MEM_PROTO1_LENGTH;
-		if( strcmp(cp_dspname, "proto10") == 0 )
-			break;
+	/* Fall through case, no match */
+	if (sp_function == NULL)
+		return(NOT_OKAY);
 
-		else /* Fall through case, no match */
-		{
-			return(NOT_OKAY);
-		}
-	}
-	while(0);
+	/* Skip 2 per position to jump over both 16 and 32 bit functions */
+	index = sp_function->position * 2;
+	memsize = sp_function->memsize;
 
 	/* Now point to correct 16 or 32 bit function */
 	index += offset;
@@ -197,8 +197,32 @@ DSP_FUNC_DEF void DSPS_AURAL_PROCESS(long *lp_data, int l_length,
 	 */
 	long *read_in_buf;
 	long *read_out_buf;
+	long stereo_in_dma;
 
 	int i;
+	struct dspAuralStructType *s = (struct dspAuralStructType *)(COMM_MEM_OFFSET);
+
+	/* Parameters are loaded once per buffer */
+	realtype drive = s->aural_drive;
+	realtype even = s->aural_even;
+	realtype odd = s->aural_odd;
+	realtype a0 = s->a0;
+	realtype a1 = s->a1;
+	realtype gain = s->gain;
+	realtype wet_gain = s->wet_gain;
+	realtype dry_gain = s->dry_gain;
+
+	/* Filter state, stored back at end of buffer processing */
+	realtype out1_minus1 = s->out1_minus1;
+	realtype out1_minus2 = s->out1_minus2;
+	realtype in1_minus1 = s->in1_minus1;
+	realtype in1_minus2 = s->in1_minus2;
+	realtype out2_minus1 = s->out2_minus1;
+	realtype out2_minus2 = s->out2_minus2;
+	realtype in2_minus1 = s->in2_minus1;
+	realtype in2_minus2 = s->in2_minus2;
+
+	dutilLoadStereoFlag();
 
 	/* Run one buffer full of data. Zero index and averaged meter vals. */
 
@@ -209,36 +233,20 @@ DSP_FUNC_DEF void DSPS_AURAL_PROCESS(long *lp_data, int l_length,
 	{
 		float out1, out2;
 		float in1, in2;
-		volatile long in_count = 0;
-		volatile long out_count = 0;
 		float odd1, odd2, even1, even2;
 		float filtH1, filtH2;
-		struct dspAuralStructType *s = (struct dspAuralStructType *)(COMM_MEM_OFFSET);
-		realtype drive = s->aural_drive;
-		realtype even = s->aural_even;
-		realtype odd = s->aural_odd;
-	  
-		load_parameter(); /* If its been sent, loads a parameter into memory */
-
-		/* Next line includes kerdmaru.h run loop macro (no args) */
-		#include "kerdmaru.h"
 	  
 		out1 = out2 = 0.0;
 		 
 		dutilGetInputsAndMeter( in1, in2, status);
 
 		/* Implement Highpass linear transformed 2nd order Butterworth filter */
-		/* Note using Nil's method for allowing optimizer to work well, all
-		 * parameters and internal states are in a structure that is accessed
-		 * via a pointer.
-		 */
-		filtH1 = s->out1_minus1 * s->a1 + s->out1_minus2 * s->a0;
-		s->out1_minus2 = s->out1_minus1;
-		/* Add bias to avoid zero input cpu load increases */
-		filtH1 += (in1 + (realtype)1.0e-30 - (realtype)2.0 * s->in1_minus1 + s->in1_minus2) * s->gain;
-		s->out1_minus1 = filtH1;
-		s->in1_minus2 = s->in1_minus1;
-		s->in1_minus1 = in1;
+		filtH1 = out1_minus1 * a1 + out1_minus2 * a0;
+		out1_minus2 = out1_minus1;
+		filtH1 += (in1 - (realtype)2.0 * in1_minus1 + in1_minus2) * gain;
+		out1_minus1 = filtH1;
+		in1_minus2 = in1_minus1;
+		in1_minus1 = in1;
 
 		filtH1 *= drive;
 
@@ -257,16 +265,15 @@ DSP_FUNC_DEF void DSPS_AURAL_PROCESS(long *lp_data, int l_length,
 		out1 = in1 + (even * even1 + odd * odd1);
 
 		/* Do right channel if stereo in */
-		if(s->stereo_in_flag)
+		if( stereo_in_dma )
 		{
 			/* Implement a second order lowpass filter on the signal */
-			filtH2 = s->out2_minus1 * s->a1 + s->out2_minus2 * s->a0;
-			s->out2_minus2 = s->out2_minus1;
-			/* Add bias to avoid zero input cpu load increases */
-			filtH2 += (in2  + (realtype)1.0e-30 - (realtype)2.0 * s->in2_minus1 + s->in2_minus2) * s->gain;
-			s->out2_minus1 = filtH2;
-			s->in2_minus2 = s->in2_minus1;
-			s->in2_minus1 = in2;
+			filtH2 = out2_minus1 * a1 + out2_minus2 * a0;
+			out2_minus2 = out2_minus1;
+			filtH2 += (in2 - (realtype)2.0 * in2_minus1 + in2_minus2) * gain;
+			out2_minus1 = filtH2;
+			in2_minus2 = in2_minus1;
+			in2_minus1 = in2;
 				
 			filtH2 *= drive;
 
@@ -289,7 +296,7 @@ DSP_FUNC_DEF void DSPS_AURAL_PROCESS(long *lp_data, int l_length,
 			/* Zero right input in mono case so bypass works right */
 			in2 = (realtype)0.0;
 							
-		kerWetDry(in1, in2, &(s->wet_gain), &(s->dry_gain), out1, out2);
+		kerWetDryGains(in1, in2, wet_gain, dry_gain, out1, out2);
 
 		dutilSetClipStatus(in1, in2, out1, out2, status);
 
@@ -298,6 +305,15 @@ DSP_FUNC_DEF void DSPS_AURAL_PROCESS(long *lp_data, int l_length,
 		write_meters_and_status(in_meter1, in_meter2, out_meter1, out_meter2, status, transfer_state);
 	}
 
+	s->out1_minus1 = out1_minus1;
+	s->out1_minus2 = out1_minus2;
+	s->in1_minus1 = in1_minus1;
+	s->in1_minus2 = in1_minus2;
+	s->out2_minus1 = out2_minus1;
+	s->out2_minus2 = out2_minus2;
+	s->in2_minus1 = in2_minus1;
+	s->in2_minus2 = in2_minus2;
+
 	/* Write averaged meter data temporarily writing as a float.
 	 * Will be converted to long and factored in calling function.
 	 */
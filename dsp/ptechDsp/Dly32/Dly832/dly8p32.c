@@ -304,9 +304,19 @@ DSP_FUNC_DEF void DSPS_DLY_PROCESS(long *lp_data, int l_length,
 	 */
 	long *read_in_buf;
 	long *read_out_buf;
+	long stereo_in_dma;
 
 	int i;
 
+	/* Parameters are loaded once per buffer */
+	long delay_filtered[NUM_ELEMS];
+	float feedback[NUM_ELEMS];
+	float element_gain[NUM_ELEMS];
+	float pan_left_gain[NUM_ELEMS];
+	float pan_right_gain[NUM_ELEMS];
+	float wet_gain = *(volatile float *)(WET_GAIN);
+	float dry_gain = *(volatile float *)(DRY_GAIN);
+
 	#ifdef DSP_READ_VALS
 	/* PTHACK for prototyping */
 	ReadProtoVals(8, &ReadVals);
@@ -321,6 +331,23 @@ DSP_FUNC_DEF void DSPS_DLY_PROCESS(long *lp_data, int l_length,
 	}
 	*/
 
+	{
+		unsigned j; /* Unsigned for no overhead looping */
+		for(j=0; j<NUM_ELEMS; j++)
+		{
+			/* Hardware version filters delay changes every sample below */
+			#ifndef DSP_TARGET
+			delay_filtered[j] = ((volatile long *)(ELEM0_DELAY))[j];
+			#endif
+			feedback[j] = ((volatile float *)(ELEM0_FEEDBACK))[j];
+			element_gain[j] = ((volatile float *)(ELEM0_GAIN))[j];
+			pan_left_gain[j] = ((volatile float *)(ELEM0_PAN_GAIN_LEFT))[j];
+			pan_right_gain[j] = ((volatile float *)(ELEM0_PAN_GAIN_RIGHT))[j];
+		}
+	}
+
+	dutilLoadStereoFlag();
+
 	/* Run one buffer full of data. Zero index and averaged meter vals. */
 
 	read_in_buf = lp_data;
@@ -344,14 +371,6 @@ DSP_FUNC_DEF void DSPS_DLY_PROCESS(long *lp_data, int l_length,
 	  float out1, out2;
 	  float in1, in2;
 	  float dly_out[NUM_ELEMS];
-	  long delay_filtered[NUM_ELEMS];
-	  volatile long in_count = 0;
-	  volatile long out_count = 0;
-	  
-	  load_parameter(); /* If its been sent, loads a parameter into memory */
-
-	  /* Next line includes kerdmaru.h run loop macro (no args) */
-	  #include "kerdmaru.h"
 	  
 	  out1 = out2 = 0.0;
 	    
@@ -359,21 +378,19 @@ DSP_FUNC_DEF void DSPS_DLY_PROCESS(long *lp_data, int l_length,
 	  
 	  dutilMuteInputs(in1, in2);
 	  
+	  #ifdef DSP_TARGET
 	  {	  /* Loop to filter delay settings- looping was faster */
 		  unsigned j;
 		  volatile long *delay = (volatile long *)(ELEM0_DELAY);
 		  for(j=0; j<NUM_ELEMS; j++)
 		  {
 			/* Hardware version filters delay changes, no filtering on soft dsp */
-			#ifdef DSP_TARGET
 			kerParamFiltExp(delay, old_delay[j], DELAY_CONTROL_ALPHA, delay_filtered[j]);		    
-			#else
-			delay_filtered[j] = *delay;
-			#endif
 
      		delay++;
       	  } 
       } 
+	  #endif
 
 	  /* Wrap main pointer if needed. Moved up from bottom to avoid
 	   * bad memory accesses when DSP/FX called init while DAW dll
@@ -400,7 +417,7 @@ DSP_FUNC_DEF void DSPS_DLY_PROCESS(long *lp_data, int l_length,
 			rp_MACRO = delay0_start;
 		#endif
 		dly_out[0] = *rp_MACRO; 
-		*ptr0 = in1 + *(volatile float *)(ELEM0_FEEDBACK) * dly_out[0]; 	
+		*ptr0 = in1 + feedback[0] * dly_out[0]; 	
 		
 #ifdef ELEM1
 		tmp_ptr = ptr0 + line_len; /* These LINE_LEN increments could be done on PC side */
@@ -412,7 +429,7 @@ DSP_FUNC_DEF void DSPS_DLY_PROCESS(long *lp_data, int l_length,
 			rp_MACRO = delay1_start;
 		#endif
 		dly_out[1] = *rp_MACRO; 
-		*tmp_ptr = in2 + *(volatile float *)(ELEM1_FEEDBACK) * dly_out[1]; 	
+		*tmp_ptr = in2 + feedback[1] * dly_out[1]; 	
 #endif
 		
 #ifdef ELEM2
@@ -425,7 +442,7 @@ DSP_FUNC_DEF void DSPS_DLY_PROCESS(long *lp_data, int l_length,
 			rp_MACRO = delay2_start;
 		#endif
 		dly_out[2] = *rp_MACRO; 
-		*tmp_ptr = in1 + *(volatile float *)(ELEM2_FEEDBACK) * dly_out[2]; 	
+		*tmp_ptr = in1 + feedback[2] * dly_out[2]; 	
 #endif
 		
 #ifdef ELEM3
@@ -438,7 +455,7 @@ DSP_FUNC_DEF void DSPS_DLY_PROCESS(long *lp_data, int l_length,
 			rp_MACRO = delay3_start;
 		#endif
 		dly_out[3] = *rp_MACRO; 
-		*tmp_ptr = in2 + *(volatile float *)(ELEM3_FEEDBACK) * dly_out[3]; 	
+		*tmp_ptr = in2 + feedback[3] * dly_out[3]; 	
 #endif
 		
 #ifdef ELEM4
@@ -451,7 +468,7 @@ DSP_FUNC_DEF void DSPS_DLY_PROCESS(long *lp_data, int l_length,
 			rp_MACRO = delay4_start;
 		#endif
 		dly_out[4] = *rp_MACRO; 
-		*tmp_ptr = in1 + *(volatile float *)(ELEM4_FEEDBACK) * dly_out[4]; 	
+		*tmp_ptr = in1 + feedback[4] * dly_out[4]; 	
 #endif
 		
 #ifdef ELEM5
@@ -464,7 +481,7 @@ DSP_FUNC_DEF void DSPS_DLY_PROCESS(long *lp_data, int l_length,
 			rp_MACRO = delay5_start;
 		#endif
 		dly_out[5] = *rp_MACRO; 
-		*tmp_ptr = in2 + *(volatile float *)(ELEM5_FEEDBACK) * dly_out[5]; 	
+		*tmp_ptr = in2 + feedback[5] * dly_out[5]; 	
 #endif
 
         dutilGet2ndAESInputOutput(in_meter1, in_meter2, out_meter1, out_meter2);
@@ -479,7 +496,7 @@ DSP_FUNC_DEF void DSPS_DLY_PROCESS(long *lp_data, int l_length,
 			rp_MACRO = delay6_start;
 		#endif
 		dly_out[6] = *rp_MACRO; 
-		*tmp_ptr = in1 + *(volatile float *)(ELEM6_FEEDBACK) * dly_out[6]; 	
+		*tmp_ptr = in1 + feedback[6] * dly_out[6]; 	
 #endif
 		
 #ifdef ELEM7
@@ -492,7 +509,7 @@ DSP_FUNC_DEF void DSPS_DLY_PROCESS(long *lp_data, int l_length,
 			rp_MACRO = delay7_start;
 		#endif
 		dly_out[7] = *rp_MACRO;		
-		*tmp_ptr = in2 + *(volatile float *)(ELEM7_FEEDBACK) * dly_out[7]; 	
+		*tmp_ptr = in2 + feedback[7] * dly_out[7]; 	
 #endif
 		
 		ptr0++; 	
@@ -507,21 +524,18 @@ DSP_FUNC_DEF void DSPS_DLY_PROCESS(long *lp_data, int l_length,
 	  
 	  {
 	  	unsigned j; /* Unsigned for no overhead looping */
-	  	volatile float *element_gain = (volatile float *)(ELEM0_GAIN);
-	  	volatile float *pan_left_gain = (volatile float *)(ELEM0_PAN_GAIN_LEFT);
 	  	for(j=0; j<NUM_ELEMS; j++)
 	  		out1 += (dly_out[j] *= element_gain[j]) * pan_left_gain[j];
 	  }
 	  	
 	  {
 	  	unsigned j; /* Unsigned for no overhead looping */
-	  	volatile float *pan_right_gain = (volatile float *)(ELEM0_PAN_GAIN_RIGHT);
 	  	for(j=0; j<NUM_ELEMS; j++)
 	  		out2 += dly_out[j] * pan_right_gain[j];
 	  }
 					
      /* To make mono bypass correct */
-	  if( !*(volatile int *)(DSP_STEREO_IN_FLAG) )
+	  if( !stereo_in_dma )
 		  in2 = (realtype)0.0;
 
 
@@ -542,7 +556,7 @@ DSP_FUNC_DEF void DSPS_DLY_PROCESS(long *lp_data, int l_length,
 		  kerWetDry(in1, in2, &wet_gain, &dry_gain, out1, out2);
 	  }
 	  #else
-	  kerWetDry(in1, in2, (WET_GAIN), (DRY_GAIN), out1, out2);
+	  kerWetDryGains(in1, in2, wet_gain, dry_gain, out1, out2);
 	  #endif
 
 	  dutilSetClipStatus(in1, in2, out1, out2, status);
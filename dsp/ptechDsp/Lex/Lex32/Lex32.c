@@ -283,13 +283,70 @@ DSP_FUNC_DEF void DSPS_LEX_PROCESS(long *lp_data, int l_length,
 	long *read_in_buf;
 	long *read_out_buf;
 
+	long stereo_in_dma;
+
 	int i;
 	struct dspLexStructType *s = (struct dspLexStructType *)(COMM_MEM_OFFSET);
 
-	/* Run one buffer full of data. Zero index and averaged meter vals.
-	 * Note- making local version of s->ptr, s->MasterStart, s->MasterEnd and s->MasterLen
-	 * didn't improve performance any.
+	/* Parameters are loaded once per buffer. Keeping them out of the struct
+	 * also stops every delay line write from forcing them to be reloaded.
 	 */
+	float decay = s->decay;
+	float lat1_coeff = s->lat1_coeff;
+	float lat3_coeff = s->lat3_coeff;
+	float lat5_coeff = s->lat5_coeff;
+	float lat6_coeff = s->lat6_coeff;
+	float bandwidth = s->bandwidth;
+	float one_minus_bandwidth = s->one_minus_bandwidth;
+	float damping = s->damping;
+	float one_minus_damping = s->one_minus_damping;
+	unsigned long pre_delay = s->pre_delay;
+	float wet_gain = s->wet_gain;
+	float dry_gain = s->dry_gain;
+
+	unsigned long MasterLen = s->MasterLen;
+	float *MasterStart = s->MasterStart;
+	float *MasterEnd = s->MasterEnd;
+	unsigned long pre_dly_len_l = s->pre_dly_len_l;
+	unsigned long lat1_dly_len_l = s->lat1_dly_len_l;
+	unsigned long lat2_dly_len_l = s->lat2_dly_len_l;
+	unsigned long lat3_dly_len_l = s->lat3_dly_len_l;
+	unsigned long lat4_dly_len_l = s->lat4_dly_len_l;
+	float lat5_dly_len_l = s->lat5_dly_len_l;
+	unsigned long lat5_dly_maxlen_l = s->lat5_dly_maxlen_l;
+	unsigned long D1_tap1 = s->D1_tap1;
+	unsigned long D1_tap2 = s->D1_tap2;
+	unsigned long D1_tap3 = s->D1_tap3;
+	unsigned long D1_tap4 = s->D1_tap4;
+	unsigned long lat6_tap1 = s->lat6_tap1;
+	unsigned long lat6_tap2 = s->lat6_tap2;
+	unsigned long lat6_dly_len_l = s->lat6_dly_len_l;
+	unsigned long D2_tap1 = s->D2_tap1;
+	unsigned long D2_tap2 = s->D2_tap2;
+	unsigned long D2_tap3 = s->D2_tap3;
+	float lat7_dly_len_l = s->lat7_dly_len_l;
+	unsigned long lat7_dly_maxlen_l = s->lat7_dly_maxlen_l;
+	unsigned long D3_tap1 = s->D3_tap1;
+	unsigned long D3_tap2 = s->D3_tap2;
+	unsigned long D3_tap3 = s->D3_tap3;
+	unsigned long D3_tap4 = s->D3_tap4;
+	unsigned long lat8_tap1 = s->lat8_tap1;
+	unsigned long lat8_tap2 = s->lat8_tap2;
+	unsigned long lat8_dly_len_l = s->lat8_dly_len_l;
+	unsigned long D4_tap1 = s->D4_tap1;
+	unsigned long D4_tap2 = s->D4_tap2;
+	unsigned long D4_tap3 = s->D4_tap3;
+
+	/* State, stored back at end of buffer processing */
+	float *ptr = s->ptr;
+	float D4_out = s->D4_out;
+	float old_damp_val1_l = s->old_damp_val1_l;
+	float old_damp_val2_l = s->old_damp_val2_l;
+	float old_bandwidth_val_l = s->old_bandwidth_val_l;
+
+	dutilLoadStereoFlag();
+
+	/* Run one buffer full of data. Zero index and averaged meter vals. */
 
 	read_in_buf = lp_data;
 	read_out_buf = lp_data;
@@ -301,28 +358,18 @@ DSP_FUNC_DEF void DSPS_LEX_PROCESS(long *lp_data, int l_length,
 		float tmp_a, tmp_b;
 		float tap1_out, tap2_out, tap3_out, tap4_out;
 		float input_diffuser_out;
-		volatile long in_count = 0;
-		volatile long out_count = 0;
 		float next_out;
 		#if (PT_DSP_BUILD == PT_DSP_DSPFX)
 		float delay_real;
 		float osc;
 		#endif
 
-	  	load_parameter(); /* If its been sent, loads a parameter into memory */
-
-		/* Next line includes kerdmaru.h run loop macro (no args) */
-		#include "kerdmaru.h"
-
 	  	out1 = out2 = 0.0;
 		 
 		dutilGetInputsAndMeter( in1, in2, status);
 
 		dutilMuteInputs(in1, in2);
 
-	   in1 += (float)DSP_DENORM_BIAS;
-	   in2 += (float)DSP_DENORM_BIAS;
-
 		/* kerRunDelayLineNoPop((in1 + in2), tmp_b, s->pre_delay, s->pre_dly_start_l, s->pre_dly_end_l, s->pre_ptr_l, s->pre_dly_len_l); */
 		/* Note that since this implements a delay, it doesn't need the next_out value.
 		 * next_out supplies the oldest value of the next delay line in the sequence.
@@ -330,70 +377,70 @@ DSP_FUNC_DEF void DSPS_LEX_PROCESS(long *lp_data, int l_length,
 		{
 			float *rp_MACRO;
 			/* Note- since this is the first pointer increment, need to add 1 */
-			s->ptr += s->pre_dly_len_l + 1;
-			if(s->ptr > s->MasterEnd)
-				s->ptr -= s->MasterLen;
-			rp_MACRO = (float *)(s->ptr - s->pre_delay );
-			if((long)rp_MACRO < (long)s->MasterStart)
-				rp_MACRO += s->MasterLen;
+			ptr += pre_dly_len_l + 1;
+			if(ptr > MasterEnd)
+				ptr -= MasterLen;
+			rp_MACRO = (float *)(ptr - pre_delay );
+			if((long)rp_MACRO < (long)MasterStart)
+				rp_MACRO += MasterLen;
 			tmp_b = *rp_MACRO;
-			next_out = *s->ptr;
-			*s->ptr = in1 + in2;
+			next_out = *ptr;
+			*ptr = in1 + in2;
 		}
 
 		/* One pole bandwidth lowpass. */
-		tmp_a = tmp_b * s->one_minus_bandwidth + s->bandwidth * s->old_bandwidth_val_l;
-		s->old_bandwidth_val_l = tmp_a;
+		tmp_a = tmp_b * one_minus_bandwidth + bandwidth * old_bandwidth_val_l;
+		old_bandwidth_val_l = tmp_a;
 
 		/*
-		kerLatticeAllPass(tmp_a, tmp_b, s->lat1_coeff, s->lat1_ptr_l, s->lat1_dly_start_l, s->lat1_dly_end_l);
-		kerLatticeAllPass(tmp_b, tmp_a, s->lat1_coeff, s->lat2_ptr_l, s->lat2_dly_start_l, s->lat2_dly_end_l);
-		kerLatticeAllPass(tmp_a, tmp_b, s->lat3_coeff, s->lat3_ptr_l, s->lat3_dly_start_l, s->lat3_dly_end_l);
-		kerLatticeAllPass(tmp_b, input_diffuser_out, s->lat3_coeff, s->lat4_ptr_l, s->lat4_dly_start_l, s->lat4_dly_end_l);
+		kerLatticeAllPass(tmp_a, tmp_b, lat1_coeff, s->lat1_ptr_l, s->lat1_dly_start_l, s->lat1_dly_end_l);
+		kerLatticeAllPass(tmp_b, tmp_a, lat1_coeff, s->lat2_ptr_l, s->lat2_dly_start_l, s->lat2_dly_end_l);
+		kerLatticeAllPass(tmp_a, tmp_b, lat3_coeff, s->lat3_ptr_l, s->lat3_dly_start_l, s->lat3_dly_end_l);
+		kerLatticeAllPass(tmp_b, input_diffuser_out, lat3_coeff, s->lat4_ptr_l, s->lat4_dly_start_l, s->lat4_dly_end_l);
 		*/
 		{ 
 			float D_in, D_out;
-			s->ptr += s->lat1_dly_len_l;
-			if(s->ptr > s->MasterEnd)
-				s->ptr -= s->MasterLen;
+			ptr += lat1_dly_len_l;
+			if(ptr > MasterEnd)
+				ptr -= MasterLen;
 			D_out = next_out;
-			D_in = tmp_a - s->lat1_coeff * D_out;
-			next_out = *s->ptr;
-			*s->ptr = D_in;
-			tmp_b = D_out + s->lat1_coeff * D_in;
+			D_in = tmp_a - lat1_coeff * D_out;
+			next_out = *ptr;
+			*ptr = D_in;
+			tmp_b = D_out + lat1_coeff * D_in;
 		}
 		{ 
 			float D_in, D_out;
-			s->ptr += s->lat2_dly_len_l;
-			if(s->ptr > s->MasterEnd)
-				s->ptr -= s->MasterLen;
+			ptr += lat2_dly_len_l;
+			if(ptr > MasterEnd)
+				ptr -= MasterLen;
 			D_out = next_out;
-			D_in = tmp_b - s->lat1_coeff * D_out;
-			next_out = *s->ptr;
-			*s->ptr = D_in;
-			tmp_a = D_out + s->lat1_coeff * D_in;
+			D_in = tmp_b - lat1_coeff * D_out;
+			next_out = *ptr;
+			*ptr = D_in;
+			tmp_a = D_out + lat1_coeff * D_in;
 		}
 		{
 			float D_in, D_out;
-			s->ptr += s->lat3_dly_len_l;
-			if(s->ptr > s->MasterEnd)
-				s->ptr -= s->MasterLen;
+			ptr += lat3_dly_len_l;
+			if(ptr > MasterEnd)
+				ptr -= MasterLen;
 			D_out = next_out;
-			D_in = tmp_a - s->lat3_coeff * D_out;
-			next_out = *s->ptr;
-			*s->ptr = D_in;
-			tmp_b = D_out + s->lat3_coeff * D_in;
+			D_in = tmp_a - lat3_coeff * D_out;
+			next_out = *ptr;
+			*ptr = D_in;
+			tmp_b = D_out + lat3_coeff * D_in;
 		}
 		{ 
 			float D_in, D_out;
-			s->ptr += s->lat4_dly_len_l;
-			if(s->ptr > s->MasterEnd)
-				s->ptr -= s->MasterLen;
+			ptr += lat4_dly_len_l;
+			if(ptr > MasterEnd)
+				ptr -= MasterLen;
 			D_out = next_out;
-			D_in = tmp_b - s->lat3_coeff * D_out;
+			D_in = tmp_b - lat3_coeff * D_out;
 			/* next_out = *s->ptr; Not needed for next macro */
-			*s->ptr = D_in;
-			input_diffuser_out = D_out + s->lat3_coeff * D_in;
+			*ptr = D_in;
+			input_diffuser_out = D_out + lat3_coeff * D_in;
 		}
 
 #if (PT_DSP_BUILD == PT_DSP_DSPFX)
@@ -419,10 +466,10 @@ DSP_FUNC_DEF void DSPS_LEX_PROCESS(long *lp_data, int l_length,
 #endif
 
 		/* Lattice 5 */
-		tmp_b = input_diffuser_out + s->decay * s->D4_out;
+		tmp_b = input_diffuser_out + decay * D4_out;
 
 #if (PT_DSP_BUILD == PT_DSP_DSPFX)
-		delay_real = s->lat5_dly_len_l + osc * s->modulation_depth;
+		delay_real = lat5_dly_len_l + osc * s->modulation_depth;
 #endif
 
 		/* kerLatticeDecayDiffuser(tmp_b, tmp_a, s->lat5_coeff, delay_real, s->lat5_ptr_l, s->lat5_dly_start_l, s->lat5_dly_end_l, s->lat5_dly_maxlen_l); */
@@ -436,85 +483,85 @@ DSP_FUNC_DEF void DSPS_LEX_PROCESS(long *lp_data, int l_length,
 			long idly = (long)delay_real;
 			float del = delay_real - idly;
 #else
-			long idly = (long)s->lat5_dly_len_l;
+			long idly = (long)lat5_dly_len_l;
 #endif
 
-			s->ptr += s->lat5_dly_maxlen_l;
-			if(s->ptr > s->MasterEnd)
-				s->ptr -= s->MasterLen;
-			tmp_ptr = s->ptr - idly;
-			if( (long)tmp_ptr < (long)s->MasterStart )
-				tmp_ptr += s->MasterLen;
+			ptr += lat5_dly_maxlen_l;
+			if(ptr > MasterEnd)
+				ptr -= MasterLen;
+			tmp_ptr = ptr - idly;
+			if( (long)tmp_ptr < (long)MasterStart )
+				tmp_ptr += MasterLen;
 			y1 = *(tmp_ptr);
 
 
 #if (PT_DSP_BUILD == PT_DSP_DSPFX)
 			idly++;
-			tmp_ptr = s->ptr - idly;
-			if( (long)tmp_ptr < (long)s->MasterStart )
-				tmp_ptr += s->MasterLen;
+			tmp_ptr = ptr - idly;
+			if( (long)tmp_ptr < (long)MasterStart )
+				tmp_ptr += MasterLen;
 			y2 = *(tmp_ptr);
 			dl_out = (y1 + (y2 - y1) * del);
 #else
 			dl_out = y1;
 #endif
 
-			dl_in = tmp_b + s->lat5_coeff * dl_out;
-			next_out = *s->ptr;
-			*s->ptr = dl_in;
-			tmp_a = dl_out - s->lat5_coeff * dl_in;
+			dl_in = tmp_b + lat5_coeff * dl_out;
+			next_out = *ptr;
+			*ptr = dl_in;
+			tmp_a = dl_out - lat5_coeff * dl_in;
 		}
 
 		/* kerDelay4Taps(tmp_a, s->D1_tap1, tap1_out, s->D1_tap2, tap2_out, s->D1_tap3, tap3_out, s->D1_tap4, tap4_out, s->D1_ptr_l, s->D1_dly_start_l, s->D1_dly_end_l); */
 		{ 
 			float *tmp_ptr;
-			s->ptr += s->D1_tap4;
-			if(s->ptr > s->MasterEnd)
-				s->ptr -= s->MasterLen;
+			ptr += D1_tap4;
+			if(ptr > MasterEnd)
+				ptr -= MasterLen;
 			tap4_out = next_out;
-			next_out = *s->ptr;
-			*s->ptr = tmp_a;
-			tmp_ptr = s->ptr - s->D1_tap1;
-			if( (long)tmp_ptr < (long)s->MasterStart )
-				tmp_ptr += s->MasterLen;
+			next_out = *ptr;
+			*ptr = tmp_a;
+			tmp_ptr = ptr - D1_tap1;
+			if( (long)tmp_ptr < (long)MasterStart )
+				tmp_ptr += MasterLen;
 			tap1_out = *tmp_ptr;
-			tmp_ptr = s->ptr - s->D1_tap2;
-			if( (long)tmp_ptr < (long)s->MasterStart )
-				tmp_ptr += s->MasterLen;
+			tmp_ptr = ptr - D1_tap2;
+			if( (long)tmp_ptr < (long)MasterStart )
+				tmp_ptr += MasterLen;
 			tap2_out = *tmp_ptr;
-			tmp_ptr = s->ptr - s->D1_tap3;
-			if( (long)tmp_ptr < (long)s->MasterStart )
-				tmp_ptr += s->MasterLen;
+			tmp_ptr = ptr - D1_tap3;
+			if( (long)tmp_ptr < (long)MasterStart )
+				tmp_ptr += MasterLen;
 			tap3_out = *tmp_ptr;
 		}
 		out1 = - tap2_out;
 		out2 = tap1_out + tap3_out;
 
 		/* One pole lowpass, can collapse in mult into final gain. */
-		tmp_a = tap4_out * s->one_minus_damping + s->damping * s->old_damp_val1_l;
-		s->old_damp_val1_l = tmp_a;
+		tmp_a = tap4_out * one_minus_damping + damping * old_damp_val1_l;
+		old_damp_val1_l = tmp_a;
 
-		tmp_a *= s->decay;
+		tmp_a *= decay;
 		/* Lattice 6 */
 		/* kerLatticeAllPassTapped(tmp_a, tmp_b, s->lat6_coeff, s->lat6_tap1, tap1_out, s->lat6_tap2, tap2_out, s->lat6_ptr_l, s->lat6_dly_start_l, s->lat6_dly_end_l, s->lat6_dly_len_l); */
 		{
 			float Dl_in, Dl_out;
 			float *tmp_ptr;
-			s->ptr += s->lat6_dly_len_l;
-			if(s->ptr > s->MasterEnd)
-				s->ptr -= s->MasterLen;
+			ptr += lat6_dly_len_l;
+			if(ptr > MasterEnd)
+				ptr -= MasterLen;
 			Dl_out = next_out;
-			Dl_in = tmp_a - s->lat6_coeff * Dl_out;
-			next_out = *s->ptr;
-			*s->ptr = Dl_in;
-			tmp_b = Dl_out + s->lat6_coeff * Dl_in;
-			tmp_ptr = s->ptr - s->lat6_tap1;
-			if( (long)tmp_ptr < (long)s->MasterStart )
-				tmp_ptr += s->MasterLen;
+			Dl_in = tmp_a - lat6_coeff * Dl_out;
+			next_out = *ptr;
+			*ptr = Dl_in;
+			tmp_b = Dl_out + lat6_coeff * Dl_in;
+			tmp_ptr = ptr - lat6_tap1;
+			if( (long)tmp_ptr < (long)MasterStart )
+				tmp_ptr += MasterLen;
 			tap1_out = *tmp_ptr;
-			tmp_ptr = s->ptr - s->lat6_tap2;
-			if( (long)tmp_ptr < (long)s->MasterStart )
-				tmp_ptr += s->MasterLen;
+			tmp_ptr = ptr - lat6_tap2;
+			if( (long)tmp_ptr < (long)MasterStart )
+				tmp_ptr += MasterLen;
 			tap2_out = *tmp_ptr;
 		}
 		out1 -= tap1_out;
@@ -523,29 +570,29 @@ DSP_FUNC_DEF void DSPS_LEX_PROCESS(long *lp_data, int l_length,
 		/* kerDelay3Taps(tmp_b, s->D2_tap1, tap1_out, s->D2_tap2, tap2_out, s->D2_tap3, tap3_out, s->D2_ptr_l, s->D2_dly_start_l, s->D2_dly_end_l); */
 		{ 
 			float *tmp_ptr;
-			s->ptr += s->D2_tap3;
-			if(s->ptr > s->MasterEnd)
-				s->ptr -= s->MasterLen;
+			ptr += D2_tap3;
+			if(ptr > MasterEnd)
+				ptr -= MasterLen;
 			tap3_out = next_out;
 			/* next_out = *s->ptr; Not needed for next section */
-			*s->ptr = tmp_b;
-			tmp_ptr = s->ptr - s->D2_tap1;
-			if( (long)tmp_ptr < (long)s->MasterStart )
-				tmp_ptr += s->MasterLen;
+			*ptr = tmp_b;
+			tmp_ptr = ptr - D2_tap1;
+			if( (long)tmp_ptr < (long)MasterStart )
+				tmp_ptr += MasterLen;
 			tap1_out = *tmp_ptr;
-			tmp_ptr = s->ptr - s->D2_tap2;
-			if( (long)tmp_ptr < (long)s->MasterStart )
-				tmp_ptr += s->MasterLen;
+			tmp_ptr = ptr - D2_tap2;
+			if( (long)tmp_ptr < (long)MasterStart )
+				tmp_ptr += MasterLen;
 			tap2_out = *tmp_ptr;
 		}
 		out1 -= tap1_out;
 		out2 += tap2_out;
 
 		/* Lattice 7 */
-		tmp_b = input_diffuser_out + s->decay * tap3_out;
+		tmp_b = input_diffuser_out + decay * tap3_out;
 
 #if (PT_DSP_BUILD == PT_DSP_DSPFX)
-		delay_real = s->lat7_dly_len_l - osc * s->modulation_depth;
+		delay_real = lat7_dly_len_l - osc * s->modulation_depth;
 #endif
 
 		/* kerLatticeDecayDiffuser(tmp_b, tmp_a, s->lat5_coeff, delay_real, s->lat7_ptr_l, s->lat7_dly_start_l, s->lat7_dly_end_l, s->lat7_dly_maxlen_l); */
@@ -559,84 +606,84 @@ DSP_FUNC_DEF void DSPS_LEX_PROCESS(long *lp_data, int l_length,
 			long idly = (long)delay_real;
 			float del = delay_real - idly;
 #else
-			long idly = (long)s->lat7_dly_len_l;
+			long idly = (long)lat7_dly_len_l;
 #endif
 
-			s->ptr += s->lat7_dly_maxlen_l;
-			if(s->ptr > s->MasterEnd)
-				s->ptr -= s->MasterLen;
-			tmp_ptr = s->ptr - idly;
-			if( (long)tmp_ptr < (long)s->MasterStart )
-				tmp_ptr += s->MasterLen;
+			ptr += lat7_dly_maxlen_l;
+			if(ptr > MasterEnd)
+				ptr -= MasterLen;
+			tmp_ptr = ptr - idly;
+			if( (long)tmp_ptr < (long)MasterStart )
+				tmp_ptr += MasterLen;
 			y1 = *(tmp_ptr);
 
 #if (PT_DSP_BUILD == PT_DSP_DSPFX)
 			idly++;
-			tmp_ptr = s->ptr - idly;
-			if( (long)tmp_ptr < (long)s->MasterStart )
-				tmp_ptr += s->MasterLen;
+			tmp_ptr = ptr - idly;
+			if( (long)tmp_ptr < (long)MasterStart )
+				tmp_ptr += MasterLen;
 			y2 = *(tmp_ptr);
 			dl_out = (y1 + (y2 - y1) * del);
 #else
 			dl_out = y1;
 #endif
 
-			dl_in = tmp_b + s->lat5_coeff * dl_out;
-			next_out = *s->ptr;
-			*s->ptr = dl_in;
-			tmp_a = dl_out - s->lat5_coeff * dl_in;
+			dl_in = tmp_b + lat5_coeff * dl_out;
+			next_out = *ptr;
+			*ptr = dl_in;
+			tmp_a = dl_out - lat5_coeff * dl_in;
 		}
 
 		/* kerDelay4Taps(tmp_a, s->D3_tap1, tap1_out, s->D3_tap2, tap2_out, s->D3_tap3, tap3_out, s->D3_tap4, tap4_out, s->D3_ptr_l, s->D3_dly_start_l, s->D3_dly_end_l); */
 		{
 			float *tmp_ptr;
-			s->ptr += (long)s->D3_tap4;
-			if(s->ptr > s->MasterEnd)
-				s->ptr -= s->MasterLen;
+			ptr += (long)D3_tap4;
+			if(ptr > MasterEnd)
+				ptr -= MasterLen;
 			tap4_out = next_out;
-			next_out = *s->ptr;
-			*s->ptr = tmp_a;
-			tmp_ptr = s->ptr - s->D3_tap1;
-			if( (long)tmp_ptr < (long)s->MasterStart )
-				tmp_ptr += s->MasterLen;
+			next_out = *ptr;
+			*ptr = tmp_a;
+			tmp_ptr = ptr - D3_tap1;
+			if( (long)tmp_ptr < (long)MasterStart )
+				tmp_ptr += MasterLen;
 			tap1_out = *tmp_ptr;
-			tmp_ptr = s->ptr - s->D3_tap2;
-			if( (long)tmp_ptr < (long)s->MasterStart )
-				tmp_ptr += s->MasterLen;
+			tmp_ptr = ptr - D3_tap2;
+			if( (long)tmp_ptr < (long)MasterStart )
+				tmp_ptr += MasterLen;
 			tap2_out = *tmp_ptr;
-			tmp_ptr = s->ptr - s->D3_tap3;
-			if( (long)tmp_ptr < (long)s->MasterStart )
-				tmp_ptr += s->MasterLen;
+			tmp_ptr = ptr - D3_tap3;
+			if( (long)tmp_ptr < (long)MasterStart )
+				tmp_ptr += MasterLen;
 			tap3_out = *tmp_ptr;
 		}
 		out1 += tap1_out + tap3_out;
 		out2 -= tap2_out;
 
 		/* One pole lowpass, can collapse in mult into final gain. */
-		tmp_a = tap4_out * s->one_minus_damping + s->damping * s->old_damp_val2_l;
-		s->old_damp_val2_l = tmp_a;
+		tmp_a = tap4_out * one_minus_damping + damping * old_damp_val2_l;
+		old_damp_val2_l = tmp_a;
 
-		tmp_a *= s->decay;
+		tmp_a *= decay;
 		/* Lattice 8 */
 		/* kerLatticeAllPassTapped(tmp_a, tmp_b, s->lat6_coeff, s->lat8_tap1, tap1_out, s->lat8_tap2, tap2_out, s->lat8_ptr_l, s->lat8_dly_start_l, s->lat8_dly_end_l, s->lat8_dly_len_l); */
 		{
 			float Dl_in, Dl_out;
 			float *tmp_ptr;
-			s->ptr += s->lat8_dly_len_l;
-			if(s->ptr > s->MasterEnd)
-				s->ptr -= s->MasterLen;
+			ptr += lat8_dly_len_l;
+			if(ptr > MasterEnd)
+				ptr -= MasterLen;
 			Dl_out = next_out;
-			Dl_in = tmp_a - s->lat6_coeff * Dl_out;
-			next_out = *s->ptr;
-			*s->ptr = Dl_in;
-			tmp_b = Dl_out + s->lat6_coeff * Dl_in;
-			tmp_ptr = s->ptr - s->lat8_tap1;
-			if( (long)tmp_ptr < (long)s->MasterStart )
-				tmp_ptr += s->MasterLen;
+			Dl_in = tmp_a - lat6_coeff * Dl_out;
+			next_out = *ptr;
+			*ptr = Dl_in;
+			tmp_b = Dl_out + lat6_coeff * Dl_in;
+			tmp_ptr = ptr - lat8_tap1;
+			if( (long)tmp_ptr < (long)MasterStart )
+				tmp_ptr += MasterLen;
 			tap1_out = *tmp_ptr;
-			tmp_ptr = s->ptr - s->lat8_tap2;
-			if( (long)tmp_ptr < (long)s->MasterStart )
-				tmp_ptr += s->MasterLen;
+			tmp_ptr = ptr - lat8_tap2;
+			if( (long)tmp_ptr < (long)MasterStart )
+				tmp_ptr += MasterLen;
 			tap2_out = *tmp_ptr;
 		}
 		out1 -= tap2_out;
@@ -645,35 +692,35 @@ DSP_FUNC_DEF void DSPS_LEX_PROCESS(long *lp_data, int l_length,
 		/* kerDelay3Taps(tmp_b, s->D4_tap1, tap1_out, s->D4_tap2, tap2_out, s->D4_tap3, tap3_out, s->D4_ptr_l, s->D4_dly_start_l, s->D4_dly_end_l); */
 		{ 
 			float *tmp_ptr;
-			s->ptr += (long)s->D4_tap3;
-			if(s->ptr > s->MasterEnd)
-				s->ptr -= s->MasterLen;
+			ptr += (long)D4_tap3;
+			if(ptr > MasterEnd)
+				ptr -= MasterLen;
 			tap3_out = next_out;
 			/* next_out = *s->ptr; Not needed for next section */
-			*s->ptr = tmp_b;
-			tmp_ptr = s->ptr - s->D4_tap1;
-			if( (long)tmp_ptr < (long)s->MasterStart )
-				tmp_ptr += s->MasterLen;
+			*ptr = tmp_b;
+			tmp_ptr = ptr - D4_tap1;
+			if( (long)tmp_ptr < (long)MasterStart )
+				tmp_ptr += MasterLen;
 			tap1_out = *tmp_ptr;
-			tmp_ptr = s->ptr - s->D4_tap2;
-			if( (long)tmp_ptr < (long)s->MasterStart )
-				tmp_ptr += s->MasterLen;
+			tmp_ptr = ptr - D4_tap2;
+			if( (long)tmp_ptr < (long)MasterStart )
+				tmp_ptr += MasterLen;
 			tap2_out = *tmp_ptr;
 		}
 		out1 += tap2_out;
 		out2 -= tap1_out;
-		s->D4_out = tap3_out;
+		D4_out = tap3_out;
 
 		out1 *= (realtype)(0.6 * 0.5);
 		out2 *= (realtype)(0.6 * 0.5);
 
-		if( !(s->stereo_in_flag) )
+		if( !stereo_in_dma )
 		{
 			in2 = (realtype)0.0;
 			out1 *= (realtype)0.5;
 			out2 *= (realtype)0.5;
 		}
-		kerWetDry(in1, in2, &(s->wet_gain), &(s->dry_gain), out1, out2);
+		kerWetDryGains(in1, in2, wet_gain, dry_gain, out1, out2);
 
 		dutilSetClipStatus(in1, in2, out1, out2, status);
 
@@ -682,6 +729,12 @@ DSP_FUNC_DEF void DSPS_LEX_PROCESS(long *lp_data, int l_length,
 		write_meters_and_status(in_meter1, in_meter2, out_meter1, out_meter2, status, transfer_state);
 	}
 
+	s->ptr = ptr;
+	s->D4_out = D4_out;
+	s->old_damp_val1_l = old_damp_val1_l;
+	s->old_damp_val2_l = old_damp_val2_l;
+	s->old_bandwidth_val_l = old_bandwidth_val_l;
+
 	/* Write averaged meter data temporarily writing as a float.
 	 * Will be converted to long and factored in calling function.
 	 */
@@ -56,6 +56,10 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "kerdelay.h"  /* Has wet-dry macro */
 #include "kernoise.h"
 
+#if defined(DSPSOFT_TARGET) && (defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__))
+#include <emmintrin.h>
+#endif
+
 static void DSPS_MAXI_RUN(void);
 
 #ifdef DSP_TARGET
@@ -93,13 +97,8 @@ DSP_FUNC_DEF int DSPS_MAXI_INIT(float *fp_params, float *fp_memory, long l_memsi
 		s->release_time_beta = (realtype)0.997776;
 		s->num_quant_bits = KERNOISE_QUANTIZE_16; /* Hardcoded for 16 bit quantization */
 		s->dither_type = KERNOISE_DITHER_SHAPED;
+		s->true_peak_on_flag = 0;
 
-		s->ramp_count_l = 0;
-		s->ramp_count_r = 0;
-		s->max_abs_l = (realtype)0.0;
-		s->max_abs_r = (realtype)0.0;
-		s->env_l = (realtype)0.0;
-		s->env_r = (realtype)0.0;
 		s->noise1_old = (realtype)0.0;
 		s->noise2_old = (realtype)0.0;
 
@@ -147,16 +146,9 @@ DSP_FUNC_DEF int DSPS_MAXI_INIT(float *fp_params, float *fp_memory, long l_memsi
 		dutilGetMemSizes();
 		dutilInitMem(); /* Doesn't do anything for DSPSOFT */
 		/* Now do DSPSOFT init */
-		/*  No allocated memory in this plug-in
-		for(i=0; i<l_memsize; i++)
-			fp_memory[i] = 0.0;
-		 */
-
-		/* Initialize memory pointers. Note main memsize is already
-		 * compensated for 0x400 program size
-		 */
-		s->ptr_l = s->dly_start_l;
-		s->ptr_r = s->dly_start_r;
+		/* Limiter state lives in the memory space, make sure it was sized for it */
+		if( sizeof(struct dspMaxiLimiterType) > DSPS_SOFT_MEM_MAXIMIZER_LENGTH * sizeof(float) )
+			return(NOT_OKAY);
 
  		/* Place variables into state array */
 		{
@@ -171,8 +163,14 @@ DSP_FUNC_DEF int DSPS_MAXI_INIT(float *fp_params, float *fp_memory, long l_memsi
 	/* Zero internal signal memory spaces to eliminate glitches on restarts */
 	if( (i_init_flag & DSPS_INIT_MEMORY) || (i_init_flag & DSPS_ZERO_MEMORY) )
 	{
-		for(i=0; i<MAXI_MAX_DELAY_LEN; i++)
-			s->dly_start_l[i] = s->dly_start_r[i] = (realtype)0.0;
+		/* Zeroes delay lines, envelopes and peak blocks. Zero window_len and boost_count
+		 * force a window rebuild and gain boost update on the first sample.
+		 */
+		for(i=0; i < (long)(sizeof(struct dspMaxiLimiterType)/sizeof(float)); i++)
+			fp_memory[i] = (realtype)0.0;
+
+		/* Restart the dither noise sequence, kept in the state array so handles don't share it */
+		((unsigned long *)&(fp_state[0]))[MAXIMIZE_STATE_NOISE_SEED] = MAXIMIZE_NOISE_SEED;
 	}
 
 	/* Initialize A/D and D/A converters, and set Samp Rate */
@@ -185,6 +183,352 @@ DSP_FUNC_DEF int DSPS_MAXI_INIT(float *fp_params, float *fp_memory, long l_memsi
 #endif /* DSPSOFT_32_BIT */
 
 #ifdef DSPSOFT_TARGET
+/* ITU-R BS.1770-4 true peak interpolator. Each tap holds its four polyphase branch
+ * coefficients, each one twice so a left/right pair multiplies two branches at once.
+ */
+static const float maxi_true_peak_coefs[MAXI_TRUE_PEAK_TAPS][2 * MAXI_TRUE_PEAK_OVERSAMPLE] =
+{
+	{  0.0017089843750f,  0.0017089843750f, -0.0291748046875f, -0.0291748046875f, -0.0189208984375f, -0.0189208984375f, -0.0083007812500f, -0.0083007812500f },
+	{  0.0109863281250f,  0.0109863281250f,  0.0292968750000f,  0.0292968750000f,  0.0330810546875f,  0.0330810546875f,  0.0148925781250f,  0.0148925781250f },
+	{ -0.0196533203125f, -0.0196533203125f, -0.0517578125000f, -0.0517578125000f, -0.0582275390625f, -0.0582275390625f, -0.0266113281250f, -0.0266113281250f },
+	{  0.0332031250000f,  0.0332031250000f,  0.0891113281250f,  0.0891113281250f,  0.1015625000000f,  0.1015625000000f,  0.0476074218750f,  0.0476074218750f },
+	{ -0.0594482421875f, -0.0594482421875f, -0.1665039062500f, -0.1665039062500f, -0.2003173828125f, -0.2003173828125f, -0.1022949218750f, -0.1022949218750f },
+	{  0.1373291015625f,  0.1373291015625f,  0.4650878906250f,  0.4650878906250f,  0.7797851562500f,  0.7797851562500f,  0.9721679687500f,  0.9721679687500f },
+	{  0.9721679687500f,  0.9721679687500f,  0.7797851562500f,  0.7797851562500f,  0.4650878906250f,  0.4650878906250f,  0.1373291015625f,  0.1373291015625f },
+	{ -0.1022949218750f, -0.1022949218750f, -0.2003173828125f, -0.2003173828125f, -0.1665039062500f, -0.1665039062500f, -0.0594482421875f, -0.0594482421875f },
+	{  0.0476074218750f,  0.0476074218750f,  0.1015625000000f,  0.1015625000000f,  0.0891113281250f,  0.0891113281250f,  0.0332031250000f,  0.0332031250000f },
+	{ -0.0266113281250f, -0.0266113281250f, -0.0582275390625f, -0.0582275390625f, -0.0517578125000f, -0.0517578125000f, -0.0196533203125f, -0.0196533203125f },
+	{  0.0148925781250f,  0.0148925781250f,  0.0330810546875f,  0.0330810546875f,  0.0292968750000f,  0.0292968750000f,  0.0109863281250f,  0.0109863281250f },
+	{ -0.0083007812500f, -0.0083007812500f, -0.0189208984375f, -0.0189208984375f, -0.0291748046875f, -0.0291748046875f,  0.0017089843750f,  0.0017089843750f }
+};
+
+/*
+ * FUNCTION: maxi_SetWindow()
+ * DESCRIPTION:
+ *  Rebuilds the envelope history for a new look ahead delay. Held peaks
+ *  carry over so a delay change doesn't drop the current gain reduction.
+ */
+static void maxi_SetWindow(struct dspMaxiLimiterType *m, long l_max_delay)
+{
+	int ch;
+	long i;
+
+	m->window_len = l_max_delay + 1;
+	m->hold_index = 0;
+	if( m->dly_index >= l_max_delay )
+		m->dly_index = 0;
+
+	for(ch=0; ch < 2; ch++)
+	{
+		/* Restart peak blocks, samples already in the delay line are still
+		 * limited by the delay line output check.
+		 */
+		m->block_max[ch] = (realtype)0.0;
+		for(i=0; i <= m->window_len; i++)
+			m->suffix_max[i][ch] = (realtype)0.0;
+
+		for(i=0; i < m->window_len; i++)
+			m->hold[i][ch] = m->held[ch];
+		m->hold_sum[ch] = m->held[ch] * (realtype)m->window_len;
+	}
+}
+
+/*
+ * FUNCTION: maxi_EndPeakBlock()
+ * DESCRIPTION:
+ *  Called once a peak block is full, turns its abs values into the suffix
+ *  maxes the next block's windows reach back into. Also resums the envelope
+ *  history so the running sums can't drift.
+ */
+static void maxi_EndPeakBlock(struct dspMaxiLimiterType *m, long l_window_len)
+{
+	int ch;
+	long i;
+
+	for(ch=0; ch < 2; ch++)
+	{
+		float suffix = (realtype)0.0;
+		float sum = (realtype)0.0;
+
+		for(i=l_window_len - 1; i >= 0; i--)
+		{
+			suffix = (m->suffix_max[i][ch] > suffix) ? m->suffix_max[i][ch] : suffix;
+			m->suffix_max[i][ch] = suffix;
+			sum += m->hold[i][ch];
+		}
+		m->block_max[ch] = (realtype)0.0;
+		m->hold_sum[ch] = sum;
+	}
+}
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+/* Both channels run in the low two lanes of one register */
+struct maxiLimiterRegsType
+{
+	__m128 hold_sum;
+	__m128 block_max;
+	__m128 held;
+	__m128 release_beta;
+	__m128 inv_window_len;
+	__m128 max_output;
+	__m128 abs_mask;
+};
+
+/* __m64 pointers may alias the float arrays, unlike double pointers */
+#define MAXI_LOAD_PAIR(fp) _mm_loadl_pi(_mm_setzero_ps(), (const __m64 *)(fp))
+#define MAXI_STORE_PAIR(fp, v) _mm_storel_pi((__m64 *)(fp), v)
+
+/*
+ * FUNCTION: maxi_LoadRegs()
+ * DESCRIPTION:
+ *  Moves the limiter envelope state and buffer constants into registers.
+ */
+static void maxi_LoadRegs(struct dspMaxiLimiterType *m, struct maxiLimiterRegsType *r,
+						  float r_release_beta, float r_inv_window_len, float r_max_output)
+{
+	r->hold_sum = MAXI_LOAD_PAIR(m->hold_sum);
+	r->block_max = MAXI_LOAD_PAIR(m->block_max);
+	r->held = MAXI_LOAD_PAIR(m->held);
+	r->release_beta = _mm_set1_ps(r_release_beta);
+	r->inv_window_len = _mm_set1_ps(r_inv_window_len);
+	r->max_output = _mm_set1_ps(r_max_output);
+	r->abs_mask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+}
+
+/*
+ * FUNCTION: maxi_StoreRegs()
+ * DESCRIPTION:
+ *  Stores the limiter envelope state back to the memory space.
+ */
+static void maxi_StoreRegs(struct dspMaxiLimiterType *m, struct maxiLimiterRegsType *r)
+{
+	MAXI_STORE_PAIR(m->hold_sum, r->hold_sum);
+	MAXI_STORE_PAIR(m->block_max, r->block_max);
+	MAXI_STORE_PAIR(m->held, r->held);
+}
+
+/*
+ * FUNCTION: maxi_LimitCore()
+ * DESCRIPTION:
+ *  Runs one boosted sample pair and its detected peaks through the look ahead
+ *  limiter and returns the gain limited delay line outputs.
+ */
+static void maxi_LimitCore(struct dspMaxiLimiterType *m, struct maxiLimiterRegsType *r,
+						   __m128 in, __m128 new_abs, long l_dly_index, long l_hold_index,
+						   float *rp_out1, float *rp_out2)
+{
+	__m128 dly_out = MAXI_LOAD_PAIR(m->dly[l_dly_index]);
+	__m128 abs_out = _mm_and_ps(dly_out, r->abs_mask);
+	__m128 peak;
+	__m128 env;
+	__m128 out;
+
+	MAXI_STORE_PAIR(m->dly[l_dly_index], in);
+
+	/* Window is the current block up to now plus the end of the previous block */
+	r->block_max = _mm_max_ps(r->block_max, new_abs);
+	peak = _mm_max_ps(r->block_max, MAXI_LOAD_PAIR(m->suffix_max[l_hold_index + 1]));
+	MAXI_STORE_PAIR(m->suffix_max[l_hold_index], new_abs);
+
+	/* Hold the window peak, decaying once it has passed */
+	r->held = _mm_max_ps(peak, _mm_mul_ps(r->held, r->release_beta));
+
+	/* Averaging over the window ramps the envelope up to each peak by the time
+	 * it reaches the delay line output.
+	 */
+	r->hold_sum = _mm_add_ps(r->hold_sum, _mm_sub_ps(r->held, MAXI_LOAD_PAIR(m->hold[l_hold_index])));
+	MAXI_STORE_PAIR(m->hold[l_hold_index], r->held);
+	env = _mm_max_ps(_mm_mul_ps(r->hold_sum, r->inv_window_len), abs_out);
+
+	out = _mm_mul_ps(dly_out, _mm_div_ps(r->max_output, _mm_max_ps(env, r->max_output)));
+	*rp_out1 = _mm_cvtss_f32(out);
+	*rp_out2 = _mm_cvtss_f32(_mm_shuffle_ps(out, out, _MM_SHUFFLE(1, 1, 1, 1)));
+}
+
+/*
+ * FUNCTION: maxi_LimitPair()
+ * DESCRIPTION:
+ *  Limits one boosted sample per channel using its sample peaks.
+ */
+static void maxi_LimitPair(struct dspMaxiLimiterType *m, struct maxiLimiterRegsType *r,
+						   float r_in1, float r_in2, long l_dly_index, long l_hold_index,
+						   float *rp_out1, float *rp_out2)
+{
+	__m128 in = _mm_unpacklo_ps(_mm_set_ss(r_in1), _mm_set_ss(r_in2));
+
+	maxi_LimitCore(m, r, in, _mm_and_ps(in, r->abs_mask),
+				   l_dly_index, l_hold_index, rp_out1, rp_out2);
+}
+
+/*
+ * FUNCTION: maxi_LimitPairTruePeak()
+ * DESCRIPTION:
+ *  Limits the boosted sample pair from MAXI_TRUE_PEAK_LATENCY samples back, using
+ *  the largest of that sample and the interpolated points up to the next one.
+ */
+static void maxi_LimitPairTruePeak(struct dspMaxiLimiterType *m, struct maxiLimiterRegsType *r,
+								   float r_in1, float r_in2, long l_dly_index, long l_hold_index,
+								   long l_true_peak_index, float *rp_out1, float *rp_out2)
+{
+	__m128 in = _mm_unpacklo_ps(_mm_set_ss(r_in1), _mm_set_ss(r_in2));
+	__m128 branch01 = _mm_setzero_ps();
+	__m128 branch23 = _mm_setzero_ps();
+	__m128 center;
+	__m128 peak;
+	int k;
+
+	MAXI_STORE_PAIR(m->true_peak_hist[l_true_peak_index], in);
+	MAXI_STORE_PAIR(m->true_peak_hist[l_true_peak_index + MAXI_TRUE_PEAK_TAPS], in);
+
+	/* Lanes are left and right of branches 0 and 1, then of branches 2 and 3 */
+	for(k=0; k < MAXI_TRUE_PEAK_TAPS; k++)
+	{
+		__m128 x = MAXI_LOAD_PAIR(m->true_peak_hist[l_true_peak_index + MAXI_TRUE_PEAK_TAPS - k]);
+
+		x = _mm_movelh_ps(x, x);
+		branch01 = _mm_add_ps(branch01, _mm_mul_ps(x, _mm_loadu_ps(&maxi_true_peak_coefs[k][0])));
+		branch23 = _mm_add_ps(branch23, _mm_mul_ps(x, _mm_loadu_ps(&maxi_true_peak_coefs[k][4])));
+	}
+
+	center = MAXI_LOAD_PAIR(m->true_peak_hist[l_true_peak_index + MAXI_TRUE_PEAK_TAPS - MAXI_TRUE_PEAK_LATENCY]);
+	peak = _mm_max_ps(_mm_and_ps(branch01, r->abs_mask), _mm_and_ps(branch23, r->abs_mask));
+	peak = _mm_max_ps(peak, _mm_movehl_ps(peak, peak));
+	peak = _mm_max_ps(peak, _mm_and_ps(center, r->abs_mask));
+
+	maxi_LimitCore(m, r, center, peak, l_dly_index, l_hold_index, rp_out1, rp_out2);
+}
+#else
+struct maxiLimiterRegsType
+{
+	float hold_sum[2];
+	float block_max[2];
+	float held[2];
+	float release_beta;
+	float inv_window_len;
+	float max_output;
+};
+
+static void maxi_LoadRegs(struct dspMaxiLimiterType *m, struct maxiLimiterRegsType *r,
+						  float r_release_beta, float r_inv_window_len, float r_max_output)
+{
+	int ch;
+
+	for(ch=0; ch < 2; ch++)
+	{
+		r->hold_sum[ch] = m->hold_sum[ch];
+		r->block_max[ch] = m->block_max[ch];
+		r->held[ch] = m->held[ch];
+	}
+	r->release_beta = r_release_beta;
+	r->inv_window_len = r_inv_window_len;
+	r->max_output = r_max_output;
+}
+
+static void maxi_StoreRegs(struct dspMaxiLimiterType *m, struct maxiLimiterRegsType *r)
+{
+	int ch;
+
+	for(ch=0; ch < 2; ch++)
+	{
+		m->hold_sum[ch] = r->hold_sum[ch];
+		m->block_max[ch] = r->block_max[ch];
+		m->held[ch] = r->held[ch];
+	}
+}
+
+static void maxi_LimitCore(struct dspMaxiLimiterType *m, struct maxiLimiterRegsType *r,
+						   float *rp_in, float *rp_new_abs, long l_dly_index, long l_hold_index,
+						   float *rp_out1, float *rp_out2)
+{
+	float out[2];
+	int ch;
+
+	for(ch=0; ch < 2; ch++)
+	{
+		float dly_out = m->dly[l_dly_index][ch];
+		float new_abs = rp_new_abs[ch];
+		float abs_out = (float)fabs(dly_out);
+		float peak;
+		float released;
+		float env;
+
+		m->dly[l_dly_index][ch] = rp_in[ch];
+
+		/* Window is the current block up to now plus the end of the previous block */
+		r->block_max[ch] = (new_abs > r->block_max[ch]) ? new_abs : r->block_max[ch];
+		peak = m->suffix_max[l_hold_index + 1][ch];
+		peak = (r->block_max[ch] > peak) ? r->block_max[ch] : peak;
+		m->suffix_max[l_hold_index][ch] = new_abs;
+
+		/* Hold the window peak, decaying once it has passed */
+		released = r->held[ch] * r->release_beta;
+		r->held[ch] = (peak > released) ? peak : released;
+
+		/* Averaging over the window ramps the envelope up to each peak by the time
+		 * it reaches the delay line output.
+		 */
+		r->hold_sum[ch] += r->held[ch] - m->hold[l_hold_index][ch];
+		m->hold[l_hold_index][ch] = r->held[ch];
+		env = r->hold_sum[ch] * r->inv_window_len;
+		env = (env > abs_out) ? env : abs_out;
+
+		out[ch] = dly_out * (r->max_output/((env > r->max_output) ? env : r->max_output));
+	}
+	*rp_out1 = out[0];
+	*rp_out2 = out[1];
+}
+
+static void maxi_LimitPair(struct dspMaxiLimiterType *m, struct maxiLimiterRegsType *r,
+						   float r_in1, float r_in2, long l_dly_index, long l_hold_index,
+						   float *rp_out1, float *rp_out2)
+{
+	float in[2];
+	float new_abs[2];
+
+	in[0] = r_in1;
+	in[1] = r_in2;
+	new_abs[0] = (float)fabs(r_in1);
+	new_abs[1] = (float)fabs(r_in2);
+
+	maxi_LimitCore(m, r, in, new_abs, l_dly_index, l_hold_index, rp_out1, rp_out2);
+}
+
+static void maxi_LimitPairTruePeak(struct dspMaxiLimiterType *m, struct maxiLimiterRegsType *r,
+								   float r_in1, float r_in2, long l_dly_index, long l_hold_index,
+								   long l_true_peak_index, float *rp_out1, float *rp_out2)
+{
+	float center[2];
+	float new_abs[2];
+	int ch, k, branch;
+
+	m->true_peak_hist[l_true_peak_index][0] = r_in1;
+	m->true_peak_hist[l_true_peak_index][1] = r_in2;
+	m->true_peak_hist[l_true_peak_index + MAXI_TRUE_PEAK_TAPS][0] = r_in1;
+	m->true_peak_hist[l_true_peak_index + MAXI_TRUE_PEAK_TAPS][1] = r_in2;
+
+	for(ch=0; ch < 2; ch++)
+	{
+		float peak;
+
+		center[ch] = m->true_peak_hist[l_true_peak_index + MAXI_TRUE_PEAK_TAPS - MAXI_TRUE_PEAK_LATENCY][ch];
+		peak = (float)fabs(center[ch]);
+
+		for(branch=0; branch < MAXI_TRUE_PEAK_OVERSAMPLE; branch++)
+		{
+			float sum = (realtype)0.0;
+
+			for(k=0; k < MAXI_TRUE_PEAK_TAPS; k++)
+				sum += m->true_peak_hist[l_true_peak_index + MAXI_TRUE_PEAK_TAPS - k][ch] * maxi_true_peak_coefs[k][2 * branch];
+			sum = (float)fabs(sum);
+			peak = (sum > peak) ? sum : peak;
+		}
+		new_abs[ch] = peak;
+	}
+
+	maxi_LimitCore(m, r, center, new_abs, l_dly_index, l_hold_index, rp_out1, rp_out2);
+}
+#endif
+
 DSP_FUNC_DEF void DSPS_MAXI_PROCESS(long *lp_data, int l_length,
 								   float *fp_params, float *fp_memory, float *fp_state,
 								   struct hardwareMeterValType *sp_meters,
@@ -196,6 +540,8 @@ DSP_FUNC_DEF void DSPS_MAXI_PROCESS(long *lp_data, int l_length,
 	/* Variables below must be restored from the state array and
 	 * stored back at end of buffer processing
 	 */
+	unsigned long *ulpp = (unsigned long *)&(fp_state[0]);
+	unsigned long seed = ulpp[MAXIMIZE_STATE_NOISE_SEED];
 	/*
 	float **fpp = (float **)&(fp_state[0]);
 	long *lpp  =  (long *)&(fp_state[0]);
@@ -219,15 +565,66 @@ DSP_FUNC_DEF void DSPS_MAXI_PROCESS(long *lp_data, int l_length,
 	 */
 	long *read_in_buf;
 	long *read_out_buf;
+	long stereo_in_dma;
 
 	int i;
 	struct dspMaxiStructType *s = (struct dspMaxiStructType *)(COMM_MEM_OFFSET);
+	struct dspMaxiLimiterType *m = (struct dspMaxiLimiterType *)(MEMBANK0_START);
+
+	/* Parameters are loaded once per buffer */
+	int stereo_on = s->stereo_in_flag;
+	int quantize_on = s->quantize_on_flag;
+	float wet_gain = s->wet_gain;
+	float dry_gain = s->dry_gain;
+	float max_output = s->max_output;
+	float release_beta = s->release_time_beta;
+	long max_delay = s->max_delay;
+	int true_peak_on = s->true_peak_on_flag;
+	double a0 = s->a0;
+	double filt_gain = s->filt_gain;
+	long window_len;
+	float inv_window_len;
+
+	/* Limiter and level state, stored back at end of buffer processing */
+	struct maxiLimiterRegsType r;
+	long dly_index;
+	long hold_index;
+	long boost_count;
+	long true_peak_index;
+	float gain_boost;
+	float boost_scale;
+	double level = s->level;
+
+	if( max_delay < 1 )
+		max_delay = 1;
+	else if( max_delay > MAXI_MAX_DELAY_LEN )
+		max_delay = MAXI_MAX_DELAY_LEN;
+	if( m->window_len != max_delay + 1 )
+		maxi_SetWindow(m, max_delay);
+	window_len = m->window_len;
+	inv_window_len = (realtype)1.0/(realtype)window_len;
+
+	/* Switching true peak mode on restarts the interpolator from silence */
+	if( m->true_peak_on != true_peak_on )
+	{
+		for(i=0; i < 2 * MAXI_TRUE_PEAK_TAPS; i++)
+		{
+			m->true_peak_hist[i][0] = (realtype)0.0;
+			m->true_peak_hist[i][1] = (realtype)0.0;
+		}
+		m->true_peak_index = 0;
+		m->true_peak_on = true_peak_on;
+	}
+
+	maxi_LoadRegs(m, &r, release_beta, inv_window_len, max_output);
+	dly_index = m->dly_index;
+	hold_index = m->hold_index;
+	boost_count = m->boost_count;
+	true_peak_index = m->true_peak_index;
+	gain_boost = m->gain_boost;
+	boost_scale = gain_boost * max_output;
 
-	/* For supplemental data (peak limiting info) back to the PC */
-	float peak_in1 = (float)1.0e-20;
-	float peak_in2 = (float)1.0e-20;
-	float peak_out1 = (float)1.0e-20;
-	float peak_out2 = (float)1.0e-20;
+	dutilLoadStereoFlag();
 
 	/* Run one buffer full of data. Zero index and averaged meter vals. */
 
@@ -238,21 +635,8 @@ DSP_FUNC_DEF void DSPS_MAXI_PROCESS(long *lp_data, int l_length,
 	{
 		float out1, out2;
 		float in1, in2;
-		volatile long in_count = 0;
-		volatile long out_count = 0;
-		float dly_l_out, dly_r_out;
-		float new_abs_l, new_abs_r;
 		float in_sqr;
-		float sqrt_level;
-		float gain_boost;
-
-	  	load_parameter(); /* If its been sent, loads a parameter into memory */
 
-		/* Next line includes kerdmaru.h run loop macro (no args) */
-		#include "kerdmaru.h"
-
-	  	out1 = out2 = 0.0;
-		 
 		dutilGetInputsAndMeter( in1, in2, status);
 
 		/* Use just left input for level estimate */
@@ -264,225 +648,52 @@ DSP_FUNC_DEF void DSPS_MAXI_PROCESS(long *lp_data, int l_length,
 		 * filter at this low a frequency looks like it would take both
 		 * a double precision design and coefficient and internal storage implementation.
 		 */
-		s->level = s->level * s->a0 + in_sqr * s->filt_gain;
-
-		sqrt_level = (float)sqrt(s->level);
+		level = level * a0 + in_sqr * filt_gain;
 
+		/* The level filter is far too slow to need a new boost every sample */
+		if( --boost_count <= 0 )
 		{
+			float sqrt_level = (float)sqrt(level);
 			realtype result = s->gain_boost * sqrt_level;
 
+			boost_count = MAXI_GAIN_BOOST_UPDATE_LEN;
 			if( result > s->target_level )
 			{
-				/* gain_boost = s->gain_boost * THRESH/sqrt_level; */
-				/*
-				realtype tmp_boost = THRESH/sqrt_level;
-
-				if(tmp_boost > (realtype)1.0)
-					gain_boost = THRESH/sqrt_level;
-				else
-					gain_boost = s->gain_boost;
-				 */
 				gain_boost = s->target_level/sqrt_level;
-			
+
 				/* 11/4/04 Modifications to help fix volume pumping */
 				if(gain_boost < (float)1.06)
 					gain_boost = (float)1.06;
-				
 			}
 			else
 				gain_boost = s->gain_boost;
-		}
 
-		dly_l_out = *(s->ptr_l);
-		*(s->ptr_l) = gain_boost * s->max_output * in1;
-		new_abs_l = (float)fabs(*(s->ptr_l));
-		(s->ptr_l)++;
-		if( s->ptr_l >= (s->dly_start_l + s->max_delay) )
-			s->ptr_l = s->dly_start_l;
-
-		/* Envelope Update - start by checking if we're in ramping mode to meet a peak */
-		if( s->ramp_count_l )
-		{
-			realtype tmp_delta;
-
-			/* First check if the envelope has decayed to the point where the current output
-			 * value will exceed the targeted output level.
-			 */
-			{
-				 realtype abs_out = (float)fabs(dly_l_out);
-				 if ( abs_out > s->env_l )
-					 s->env_l = abs_out;
-			}
-
-			/* Check to see if new input is higher than the ramp target */
-			if(new_abs_l > s->max_abs_l )
-			{
-				/* Reset for new higher target level */
-				s->max_abs_l = new_abs_l;
-				s->ramp_count_l = s->max_delay;
-				/* Note that since envelope ramping starts immediately on this sample,
-				 * divisor of delta calc is delay plus one.
-				 * To handle the case where the new envelope would fall under the last max
-				 * val, only change the delta if its larger.
-				 */
-				tmp_delta = (new_abs_l - s->env_l)/(realtype)(s->max_delay + 1);
-				if( tmp_delta > s->delta_l )
-					s->delta_l = tmp_delta;
-			}
-			else
-				s->ramp_count_l--;
-
-			s->env_l += s->delta_l;
+			boost_scale = gain_boost * max_output;
 		}
-		else
-		{
-			/* Not in ramp mode, first decay the envelope. */
-			 s->env_l = s->env_l * s->release_time_beta + (realtype)MAXI_ENVELOPE_BIAS;
-				
-			/* Check if the envelope has decayed to the point where the current output
-			 * value will exceed the targeted output level.
-			 */
-			{
-				 realtype abs_out = (float)fabs(dly_l_out);
-				 if ( abs_out > s->env_l )
-					 s->env_l = abs_out;
-			}
 
-			/* Check to see if we need to start ramp mode */
-			if(new_abs_l > s->env_l)
-			{
-				s->max_abs_l = new_abs_l;
-  			   /* Note that since envelope ramping starts immediately on this sample,
-				 * divisor of delta calc is delay plus one.
-				 */
-				s->delta_l = (new_abs_l - s->env_l)/(realtype)(s->max_delay + 1);
-				s->env_l += s->delta_l;
-				s->ramp_count_l = s->max_delay;
-			}
-		}
-		/* End of envelope update */
-
-		/* Calculate outputs and extra peak info to send back */
-		if( s->env_l > s->max_output )
+		/* Mono runs the pair too, the second output is dropped below */
+		if( true_peak_on )
 		{
-			/* Normalize peak */
-			out1 = dly_l_out * s->max_output/s->env_l;
-			/* Check if max peak for graph */
-			if(s->env_l > peak_in1)
-			{
-				/* Note we will later take gain boost out of input peak */
-				peak_in1 = s->env_l;
-				peak_out1 = s->max_output;
-			}
+			maxi_LimitPairTruePeak(m, &r, boost_scale * in1, boost_scale * in2, dly_index, hold_index,
+								   true_peak_index, &out1, &out2);
+			if( ++true_peak_index >= MAXI_TRUE_PEAK_TAPS )
+				true_peak_index = 0;
 		}
 		else
-		{
-			out1 = dly_l_out;
-			if(s->env_l > peak_in1)
-			{
-				peak_in1 = s->env_l;
-				peak_out1 = s->env_l;
-			}
-		}
+			maxi_LimitPair(m, &r, boost_scale * in1, boost_scale * in2, dly_index, hold_index, &out1, &out2);
 
-		if(s->stereo_in_flag)
+		if( ++dly_index >= max_delay )
+			dly_index = 0;
+		if( ++hold_index >= window_len )
 		{
-			dly_r_out = *(s->ptr_r);
-			*(s->ptr_r) = gain_boost * s->max_output * in2;
-			new_abs_r = (float)fabs(*(s->ptr_r));
-			(s->ptr_r)++;
-			if( s->ptr_r >= (s->dly_start_r + s->max_delay) )
-				s->ptr_r = s->dly_start_r;
-
-			/* Envelope Update - start by checking if we're in ramping mode to meet a peak */
-			if( s->ramp_count_r )
-			{
-				realtype tmp_delta;
-
-				/* First check if the envelope has decayed to the point where the current output
-				 * value will exceed the targeted output level.
-				 */
-				{
-					 realtype abs_out = (float)fabs(dly_r_out);
-					 if ( abs_out > s->env_r )
-						 s->env_r = abs_out;
-				}
-
-				/* Check to see if new input is higher than the ramp target */
-				if(new_abs_r > s->max_abs_r )
-				{
-					/* Reset for new higher target level */
-					s->max_abs_r = new_abs_r;
-					s->ramp_count_r = s->max_delay;
-					/* Note that since envelope ramping starts immediately on this sample,
-					 * divisor of delta calc is delay plus one.
-					 * To handle the case where the new envelope would fall under the last max
-					 * val, only change the delta if its larger.
-					 */
-					tmp_delta = (new_abs_r - s->env_r)/(realtype)(s->max_delay + 1);
-					if( tmp_delta > s->delta_r )
-						s->delta_r = tmp_delta;
-				}
-				else
-					s->ramp_count_r--;
-
-				s->env_r += s->delta_r;
-			}
-			else
-			{
-				/* Not in ramp mode, first decay the envelope. */
-				 s->env_r = s->env_r * s->release_time_beta + (realtype)MAXI_ENVELOPE_BIAS;
-					
-				/* Check if the envelope has decayed to the point where the current output
-				 * value will exceed the targeted output level.
-				 */
-				{
-					 realtype abs_out = (float)fabs(dly_r_out);
-					 if ( abs_out > s->env_r )
-						 s->env_r = abs_out;
-				}
-
-				/* Check to see if we need to start ramp mode */
-				if(new_abs_r > s->env_r)
-				{
-					s->max_abs_r = new_abs_r;
-  					/* Note that since envelope ramping starts immediately on this sample,
-					 * divisor of delta calc is delay plus one.
-					 */
-					s->delta_r = (new_abs_r - s->env_r)/(realtype)(s->max_delay + 1);
-					s->env_r += s->delta_r;
-					s->ramp_count_r = s->max_delay;
-				}
-			}
-			/* End of envelope update */
-
-			/* Calculate outputs and extra peak info to send back */
-			if( s->env_r > s->max_output )
-			{
-				/* Normalize peak */
-				out2 = dly_r_out * s->max_output/s->env_r;
-				/* Check if max peak for graph */
-				if(s->env_r > peak_in2)
-				{
-					/* Note we will later take gain boost out of input peak */
-					peak_in2 = s->env_r;
-					peak_out2 = s->max_output;
-				}
-			}
-			else
-			{
-				out2 = dly_r_out;
-				if(s->env_r > peak_in2)
-				{
-					peak_in2 = s->env_r;
-					peak_out2 = s->env_r;
-				}
-			}
+			maxi_StoreRegs(m, &r);
+			maxi_EndPeakBlock(m, window_len);
+			maxi_LoadRegs(m, &r, release_beta, inv_window_len, max_output);
+			hold_index = 0;
 		}
 
-		if( s->quantize_on_flag )
+		if( quantize_on )
 		{
-			static unsigned long seed = MAXIMIZE_NOISE_SEED;
 			realtype dither1, dither2;
 
 			switch (s->dither_type)
@@ -581,14 +792,14 @@ DSP_FUNC_DEF void DSPS_MAXI_PROCESS(long *lp_data, int l_length,
 			}
 		}
 
-		if( !(s->stereo_in_flag) )
+		if( !stereo_on )
 		{
 			in2 = (realtype)0.0;
 			out2 = (realtype)0.0;
 		}
 
-		/* WHY IS THIS NEEDED AT ALL ?? (clipping?) */
-		kerWetDry(in1, in2, &(s->wet_gain), &(s->dry_gain), out1, out2);
+		out1 = out1 * wet_gain + dry_gain * in1;
+		out2 = out2 * wet_gain + dry_gain * in2;
 
 		dutilSetClipStatus(in1, in2, out1, out2, status);
 
@@ -603,17 +814,36 @@ DSP_FUNC_DEF void DSPS_MAXI_PROCESS(long *lp_data, int l_length,
 	write_meter_average();
 
 #if defined(DSPSOFT_TARGET) & (PT_DSP_BUILD == PT_DSP_DSPFX)
-	/* Write extra graphic data. Take gain boost off of maximum input peak */
-	sp_meters->aux_vals[0] = (realtype)20.0 * log10(peak_in1/(s->gain_boost * s->max_output));
-	if( sp_meters->aux_vals[0] > (realtype)0.0)
-		sp_meters->aux_vals[0] = (realtype)0.0; 
+	{
+		/* For supplemental data (peak limiting info) back to the PC.
+		 * Uses the largest held peak of the last window.
+		 */
+		float peak_in1 = (float)1.0e-20;
+		float peak_in2 = (float)1.0e-20;
+		float peak_out1, peak_out2;
 
-	sp_meters->aux_vals[2] = (realtype)20.0 * log10(peak_in2/(s->gain_boost * s->max_output));
-	if( sp_meters->aux_vals[2] > (realtype)0.0)
-		sp_meters->aux_vals[2] = (realtype)0.0; 
+		for(i=0; i < window_len; i++)
+		{
+			if( m->hold[i][0] > peak_in1 )
+				peak_in1 = m->hold[i][0];
+			if( m->hold[i][1] > peak_in2 )
+				peak_in2 = m->hold[i][1];
+		}
+		peak_out1 = (peak_in1 > max_output) ? max_output : peak_in1;
+		peak_out2 = (peak_in2 > max_output) ? max_output : peak_in2;
+
+		/* Write extra graphic data. Take gain boost off of maximum input peak */
+		sp_meters->aux_vals[0] = (realtype)20.0 * log10(peak_in1/(s->gain_boost * s->max_output));
+		if( sp_meters->aux_vals[0] > (realtype)0.0)
+			sp_meters->aux_vals[0] = (realtype)0.0; 
+
+		sp_meters->aux_vals[2] = (realtype)20.0 * log10(peak_in2/(s->gain_boost * s->max_output));
+		if( sp_meters->aux_vals[2] > (realtype)0.0)
+			sp_meters->aux_vals[2] = (realtype)0.0; 
 
-	sp_meters->aux_vals[1] = (realtype)20.0 * log10(peak_out1);
-	sp_meters->aux_vals[3] = (realtype)20.0 * log10(peak_out2);
+		sp_meters->aux_vals[1] = (realtype)20.0 * log10(peak_out1);
+		sp_meters->aux_vals[3] = (realtype)20.0 * log10(peak_out2);
+	}
 #endif
 
 	/* Place variables into state array */
@@ -623,6 +853,16 @@ DSP_FUNC_DEF void DSPS_MAXI_PROCESS(long *lp_data, int l_length,
 		long *lpp  =  (long *)&(fp_state[0]);
 		fpp[0] = ptr0;
 		*/
+		ulpp[MAXIMIZE_STATE_NOISE_SEED] = seed;
 	}
+
+	/* Store limiter state back into the memory space */
+	maxi_StoreRegs(m, &r);
+	m->dly_index = dly_index;
+	m->hold_index = hold_index;
+	m->boost_count = boost_count;
+	m->true_peak_index = true_peak_index;
+	m->gain_boost = gain_boost;
+	s->level = level;
 } 
 #endif
@@ -159,9 +159,23 @@ DSP_FUNC_DEF void DSPS_PEQ_PROCESS(long *lp_data, int l_length,
 	 */
 	long *read_in_buf;
 	long *read_out_buf;
+	long stereo_in_dma;
 
 	int i;
 
+	/* Section on off flags and PC version gains are loaded once per buffer */
+	long section_on[2 * (DSP_MAX_NUM_OF_PEQ_ELEMENTS + 2)];
+#ifndef DSP_TARGET
+	float left_gain = *(volatile float *)(DSP_PEQ_LEFT_GAIN);
+	float right_gain = *(volatile float *)(DSP_PEQ_RIGHT_GAIN);
+	float dry_gain = *(volatile float *)(DSP_PEQ_DRY_GAIN);
+#endif
+
+	for(i=0; i < 2 * (DSP_MAX_NUM_OF_PEQ_ELEMENTS + 2); i++)
+		section_on[i] = *(volatile long *)(DSP_SECTION_STATUS + i);
+
+	dutilLoadStereoFlag();
+
 	/* Run one buffer full of data. Zero index and averaged meter vals. */
 	read_in_buf = lp_data;
 	read_out_buf = lp_data;
@@ -174,17 +188,9 @@ DSP_FUNC_DEF void DSPS_PEQ_PROCESS(long *lp_data, int l_length,
 	  unsigned k;
 #endif
 	  
-	  load_parameter(); /* If its been sent, loads a parameter into memory */
-	  
- 	  /* Next line includes kerdmaru.h run loop macro (no args) */
-	  #include "kerdmaru.h"
-	  
 	  /* Current AES split is 256 top, 232 bottom cycles. Moving below param filtering was worse. */
 	  dutilGetInputsAndMeter( in1, in2, status);
 
-	  /* Add bias to inputs to avoid zero input cpu load increases */
-	  in1 += (float)DSP_DENORM_BIAS_LARGE;
-	  in2 += (float)DSP_DENORM_BIAS_LARGE;
 	  
 	  /* Filter all floating parameters coming in */
 	  /* Adding an outside loop with 2 steps jumped cycles from 504 to 540!! */
@@ -216,7 +222,7 @@ DSP_FUNC_DEF void DSPS_PEQ_PROCESS(long *lp_data, int l_length,
 #define STATE_SKIP 2
 
 		/* if( *(volatile long *)(DSP_PEQ_SHELFS_ON) ) NO LONGER USED */
-		if( *(volatile long *)(DSP_SECTION_STATUS + 0) )
+		if( section_on[0] )
 		{
 			/* First 2 shelfs get normal, rest get para macro */
 			kerSosFiltDirectForm2TransExtState( in1, coeffs, state, outa);
@@ -229,7 +235,7 @@ DSP_FUNC_DEF void DSPS_PEQ_PROCESS(long *lp_data, int l_length,
 			outa = in1;
 		}
 
-		if( *(volatile long *)(DSP_SECTION_STATUS + 1) )
+		if( section_on[1] )
 		{
 			/* First 2 shelfs get normal, rest get para macro */
 			kerSosFiltDirectForm2TransExtState(outa, coeffs, state, outb);
@@ -243,7 +249,7 @@ DSP_FUNC_DEF void DSPS_PEQ_PROCESS(long *lp_data, int l_length,
 		}
 
 		/* Now do parametric sections */
-		if( *(volatile long *)(DSP_SECTION_STATUS + 2) )
+		if( section_on[2] )
 		{
 			kerSosFiltDirectForm2TransParaExtState(outb, coeffs, state, outa);
 		}
@@ -260,7 +266,7 @@ DSP_FUNC_DEF void DSPS_PEQ_PROCESS(long *lp_data, int l_length,
 		state  += STATE_SKIP * 7;
 		#endif
 		#if defined(ELEM2)
-		if( *(volatile long *)(DSP_SECTION_STATUS + 3) )
+		if( section_on[3] )
 		{
 			kerSosFiltDirectForm2TransParaExtState(outa, coeffs, state, outb);
 		}
@@ -278,7 +284,7 @@ DSP_FUNC_DEF void DSPS_PEQ_PROCESS(long *lp_data, int l_length,
 		#endif
 		#endif
 		#if defined(ELEM3)
-		if( *(volatile long *)(DSP_SECTION_STATUS + 4) )
+		if( section_on[4] )
 		{
 			kerSosFiltDirectForm2TransParaExtState(outb, coeffs, state, outa);
 		}
@@ -296,7 +302,7 @@ DSP_FUNC_DEF void DSPS_PEQ_PROCESS(long *lp_data, int l_length,
 		#endif
 		#endif
 		#if defined(ELEM4)
-		if( *(volatile long *)(DSP_SECTION_STATUS + 5) )
+		if( section_on[5] )
 		{
 		    kerSosFiltDirectForm2TransParaExtState(outa, coeffs, state, outb);
 		}
@@ -314,7 +320,7 @@ DSP_FUNC_DEF void DSPS_PEQ_PROCESS(long *lp_data, int l_length,
 		#endif
 		#endif
 		#if defined(ELEM5)
-		if( *(volatile long *)(DSP_SECTION_STATUS + 6) )
+		if( section_on[6] )
 		{
 			kerSosFiltDirectForm2TransParaExtState(outb, coeffs, state, outa);
 		}
@@ -336,7 +342,7 @@ DSP_FUNC_DEF void DSPS_PEQ_PROCESS(long *lp_data, int l_length,
         dutilGet2ndAESInputOutput(in_meter1, in_meter2, out_meter1, out_meter2);
 
 		#if defined(ELEM6)
-		if( *(volatile long *)(DSP_SECTION_STATUS + 7) )
+		if( section_on[7] )
 		{
 			kerSosFiltDirectForm2TransParaExtState(outa, coeffs, state, outb);
 		}
@@ -354,7 +360,7 @@ DSP_FUNC_DEF void DSPS_PEQ_PROCESS(long *lp_data, int l_length,
 		#endif
 		#endif
 		#if defined(ELEM7)
-		if( *(volatile long *)(DSP_SECTION_STATUS + 8) )
+		if( section_on[8] )
 		{
 			kerSosFiltDirectForm2TransParaExtState(outb, coeffs, state, outa);
 		}
@@ -372,7 +378,7 @@ DSP_FUNC_DEF void DSPS_PEQ_PROCESS(long *lp_data, int l_length,
 		#endif
 		#endif
 		#if defined(ELEM8)
-		if( *(volatile long *)(DSP_SECTION_STATUS + 9) )
+		if( section_on[9] )
 		{
 			kerSosFiltDirectForm2TransParaExtState(outa, coeffs, state, out1);
 		}
@@ -387,12 +393,12 @@ DSP_FUNC_DEF void DSPS_PEQ_PROCESS(long *lp_data, int l_length,
 	  }
 	  
 	  /* Only do right channel if stereo input. */
-	  if( *(volatile long *)(DSP_STEREO_IN_FLAG) )
+	  if( stereo_in_dma )
 	  {	  
 	    realtype outa, outb;
 	    
 		/* if( *(volatile long *)(DSP_PEQ_SHELFS_ON) ) NO LONGER USED */
-		if( *(volatile long *)(DSP_SECTION_STATUS + 10) )
+		if( section_on[10] )
 		{
 			/* First 2 shelfs get normal, rest get para macro */
 			kerSosFiltDirectForm2TransExtState( in2, coeffs, state, outa);
@@ -405,7 +411,7 @@ DSP_FUNC_DEF void DSPS_PEQ_PROCESS(long *lp_data, int l_length,
 			outa = in2;
 		}
 
-		if( *(volatile long *)(DSP_SECTION_STATUS + 11) )
+		if( section_on[11] )
 		{
 			/* First 2 shelfs get normal, rest get para macro */
 			kerSosFiltDirectForm2TransExtState(outa, coeffs, state, outb);
@@ -419,7 +425,7 @@ DSP_FUNC_DEF void DSPS_PEQ_PROCESS(long *lp_data, int l_length,
 		}
 
 		/* Now do parametric sections */
-		if( *(volatile long *)(DSP_SECTION_STATUS + 12) )
+		if( section_on[12] )
 		{
 			kerSosFiltDirectForm2TransParaExtState(outb, coeffs, state, outa);
 		}
@@ -434,7 +440,7 @@ DSP_FUNC_DEF void DSPS_PEQ_PROCESS(long *lp_data, int l_length,
 		out2 = outa;
 		#endif
 		#if defined(ELEM2)
-		if( *(volatile long *)(DSP_SECTION_STATUS + 13) )
+		if( section_on[13] )
 		{
 			kerSosFiltDirectForm2TransParaExtState(outa, coeffs, state, outb);
 		}
@@ -450,7 +456,7 @@ DSP_FUNC_DEF void DSPS_PEQ_PROCESS(long *lp_data, int l_length,
 		#endif
 		#endif
 		#if defined(ELEM3)
-		if( *(volatile long *)(DSP_SECTION_STATUS + 14) )
+		if( section_on[14] )
 		{
 			kerSosFiltDirectForm2TransParaExtState(outb, coeffs, state, outa);
 		}
@@ -466,7 +472,7 @@ DSP_FUNC_DEF void DSPS_PEQ_PROCESS(long *lp_data, int l_length,
 		#endif
 		#endif
 		#if defined(ELEM4)
-		if( *(volatile long *)(DSP_SECTION_STATUS + 15) )
+		if( section_on[15] )
 		{
 			kerSosFiltDirectForm2TransParaExtState(outa, coeffs, state, outb);
 		}
@@ -482,7 +488,7 @@ DSP_FUNC_DEF void DSPS_PEQ_PROCESS(long *lp_data, int l_length,
 		#endif
 		#endif
 		#if defined(ELEM5)
-		if( *(volatile long *)(DSP_SECTION_STATUS + 16) )
+		if( section_on[16] )
 		{
 			kerSosFiltDirectForm2TransParaExtState(outb, coeffs, state, outa);
 		}
@@ -498,7 +504,7 @@ DSP_FUNC_DEF void DSPS_PEQ_PROCESS(long *lp_data, int l_length,
 		#endif
 		#endif
 		#if defined(ELEM6)
-		if( *(volatile long *)(DSP_SECTION_STATUS + 17) )
+		if( section_on[17] )
 		{
 			kerSosFiltDirectForm2TransParaExtState(outa, coeffs, state, outb);
 		}
@@ -514,7 +520,7 @@ DSP_FUNC_DEF void DSPS_PEQ_PROCESS(long *lp_data, int l_length,
 		#endif
 		#endif
 		#if defined(ELEM7)
-		if( *(volatile long *)(DSP_SECTION_STATUS + 18) )
+		if( section_on[18] )
 		{
 			kerSosFiltDirectForm2TransParaExtState(outb, coeffs, state, outa);
 		}
@@ -530,7 +536,7 @@ DSP_FUNC_DEF void DSPS_PEQ_PROCESS(long *lp_data, int l_length,
 		#endif
 		#endif
 		#if defined(ELEM8)
-		if( *(volatile long *)(DSP_SECTION_STATUS + 19) )
+		if( section_on[19] )
 		{
 			kerSosFiltDirectForm2TransParaExtState(outa, coeffs, state, out2);
 		}
@@ -555,10 +561,10 @@ DSP_FUNC_DEF void DSPS_PEQ_PROCESS(long *lp_data, int l_length,
 	     out1 += in1 * *(volatile float *)(DSP_PEQ_DRY_GAIN_FILT);
 	     out2 += in2 * *(volatile float *)(DSP_PEQ_DRY_GAIN_FILT);
 #else
-		 out1 *= *(volatile float *)(DSP_PEQ_LEFT_GAIN);
-	     out2 *= *(volatile float *)(DSP_PEQ_RIGHT_GAIN); 
-	     out1 += in1 * *(volatile float *)(DSP_PEQ_DRY_GAIN);
-	     out2 += in2 * *(volatile float *)(DSP_PEQ_DRY_GAIN);
+		 out1 *= left_gain;
+	     out2 *= right_gain; 
+	     out1 += in1 * dry_gain;
+	     out2 += in2 * dry_gain;
 #endif
 	  }
 	  
@@ -68,10 +68,9 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #define NZEROS 8
 #define NPOLES 8
 
-static float xv_bs1[NZEROS+1], yv_bs1[NPOLES+1];
-static float xv_bs2[NZEROS+1], yv_bs2[NPOLES+1];
-static float xv_bp1[NZEROS+1], yv_bp1[NPOLES+1];
-static float xv_bp2[NZEROS+1], yv_bp2[NPOLES+1];
+/* Vocal eliminator filter histories are kept per handle in the state array,
+ * see struct dspPlayVocalElimStateType in c_play.h.
+ */
 
 /* PTHACK for prototyping. Declare structure here so if file open
  * fails values from last read will be present.
@@ -249,6 +248,20 @@ DSP_FUNC_DEF int DSPS_PLAY_INIT(float *fp_params, float *fp_memory, long l_memsi
 		s->out2_w2_hp = 0.0;
 		s->out2_w3_hp = 0.0;
 		s->out2_w4_hp = 0.0;
+
+		/* Zero vocal eliminator filter histories */
+		{
+			struct dspPlayVocalElimStateType *v = (struct dspPlayVocalElimStateType *)(fp_state + DSP_PLAY_VOCAL_ELIM_STATE_OFFSET);
+			int i;
+
+			for(i=0; i < DSP_PLAY_VOCAL_ELIM_NUM_TAPS; i++)
+			{
+				v->xv_bs1[i] = v->yv_bs1[i] = (realtype)0.0;
+				v->xv_bs2[i] = v->yv_bs2[i] = (realtype)0.0;
+				v->xv_bp1[i] = v->yv_bp1[i] = (realtype)0.0;
+				v->xv_bp2[i] = v->yv_bp2[i] = (realtype)0.0;
+			}
+		}
 	} /* End of signal memory zeroing */
 
 	if( dspsAuralInit(params, memory, l_memsize, state, i_init_flag, r_samp_freq) != OKAY)
@@ -456,6 +469,7 @@ DSP_FUNC_DEF void DSPS_PLAY_PROCESS(long *lp_data, int l_length,
 			unsigned data_index = 0;
 			long *read_in_buf;
 			long *read_out_buf;
+			long stereo_in_dma;
 
 			float in1_bs, in1_bp, in2_bs, in2_bp;
 			float diff, diff_gain;
@@ -464,10 +478,13 @@ DSP_FUNC_DEF void DSPS_PLAY_PROCESS(long *lp_data, int l_length,
 			void (*bs_ptr)(realtype *xv, realtype *yv, realtype in, realtype *in_bs);
 			void (*bp_ptr)(realtype *xv, realtype *yv, realtype in, realtype *in_bs);
 
+			struct dspPlayVocalElimStateType *v = (struct dspPlayVocalElimStateType *)(fp_state + DSP_PLAY_VOCAL_ELIM_STATE_OFFSET);
+
 			int i;
 
 			read_in_buf = lp_data;
 			read_out_buf = lp_data;
+			dutilLoadStereoFlag();
 
 			if( (s->vocal_elim_val != s->last_vocal_val)
 				 || (s->vocal_mode != s->last_mode) )
@@ -476,14 +493,14 @@ DSP_FUNC_DEF void DSPS_PLAY_PROCESS(long *lp_data, int l_length,
 				s->last_mode = s->vocal_mode;
 				for(i=0; i < NPOLES + 1; i++)
 				{
-					xv_bs1[i] = (realtype)0.0;
-					yv_bs1[i] = (realtype)0.0;
-					xv_bs2[i] = (realtype)0.0;
-					yv_bs2[i] = (realtype)0.0;
-					xv_bp1[i] = (realtype)0.0;
-					yv_bp1[i] = (realtype)0.0;
-					xv_bp2[i] = (realtype)0.0;
-					yv_bp2[i] = (realtype)0.0;
+					v->xv_bs1[i] = (realtype)0.0;
+					v->yv_bs1[i] = (realtype)0.0;
+					v->xv_bs2[i] = (realtype)0.0;
+					v->yv_bs2[i] = (realtype)0.0;
+					v->xv_bp1[i] = (realtype)0.0;
+					v->yv_bp1[i] = (realtype)0.0;
+					v->xv_bp2[i] = (realtype)0.0;
+					v->yv_bp2[i] = (realtype)0.0;
 				}
 			}
 
@@ -605,8 +622,6 @@ DSP_FUNC_DEF void DSPS_PLAY_PROCESS(long *lp_data, int l_length,
 			{
 				float in1, in2;
 				float out1, out2;
-				volatile long in_count = 0;
-				volatile long out_count = 0;
 
 				dutilGetInputsAndMeter( in1, in2, status);
 
@@ -616,11 +631,11 @@ DSP_FUNC_DEF void DSPS_PLAY_PROCESS(long *lp_data, int l_length,
 				   pretty well.
 				 */
 
-				bs_ptr(xv_bs1, yv_bs1, in1, &in1_bs);
-				bs_ptr(xv_bs2, yv_bs2, in2, &in2_bs);
+				bs_ptr(v->xv_bs1, v->yv_bs1, in1, &in1_bs);
+				bs_ptr(v->xv_bs2, v->yv_bs2, in2, &in2_bs);
 
-				bp_ptr(xv_bp1, yv_bp1, in1, &in1_bp);
-				bp_ptr(xv_bp2, yv_bp2, in2, &in2_bp);
+				bp_ptr(v->xv_bp1, v->yv_bp1, in1, &in1_bp);
+				bp_ptr(v->xv_bp2, v->yv_bp2, in2, &in2_bp);
 
 				diff = (in1_bp - in2_bp) * diff_gain;
 
@@ -709,18 +724,30 @@ DSP_FUNC_DEF void DSPS_PLAY_PROCESS(long *lp_data, int l_length,
 			unsigned data_index = 0;
 			long *read_in_buf;
 			long *read_out_buf;
+			long stereo_in_dma;
 
 			int i;
 
+			/* Coefficients are loaded once per buffer, filter state is
+			 * stored back at end of buffer processing.
+			 */
+			realtype b0 = s->b0;
+			realtype b1 = s->b1;
+			realtype b2 = s->b2;
+			realtype a2 = s->a2;
+			realtype in1_w1 = s->in1_w1;
+			realtype in1_w2 = s->in1_w2;
+			realtype in2_w1 = s->in2_w1;
+			realtype in2_w2 = s->in2_w2;
+
 			read_in_buf = lp_data;
 			read_out_buf = lp_data;
+			dutilLoadStereoFlag();
 
 			for(i=0; i<l_length; i++)
 			{
 				float in1, in2;
 				float out1, out2;
-				volatile long in_count = 0;
-				volatile long out_count = 0;
 
 				dutilGetInputsAndMeter( in1, in2, status);
 
@@ -729,18 +756,18 @@ DSP_FUNC_DEF void DSPS_PLAY_PROCESS(long *lp_data, int l_length,
 				 * assumes b1=a1, as in parametric boost/cut filters.
 				 * coeffs must be ordered b0, b1, b2, a2.
 				 */
-				out1 = s->in1_w1 + s->b0 * (in1 + (realtype)1.0e-30);
-				s->in1_w1 = (in1 - out1) * s->b1 + s->in1_w2;
-				s->in1_w2 = s->b2 * in1;
-				s->in1_w2 -= s->a2 * out1;				
+				out1 = in1_w1 + b0 * in1;
+				in1_w1 = (in1 - out1) * b1 + in1_w2;
+				in1_w2 = b2 * in1;
+				in1_w2 -= a2 * out1;				
 
 				/* Do right channel if stereo in */
-				if(s->stereo_in_flag)
+				if( stereo_in_dma )
 				{
-					out2 = s->in2_w1 + s->b0 * (in2 + (realtype)1.0e-30);
-					s->in2_w1 = (in2 - out2) * s->b1 + s->in2_w2;
-					s->in2_w2 = s->b2 * in2;
-					s->in2_w2 -= s->a2 * out2;				
+					out2 = in2_w1 + b0 * in2;
+					in2_w1 = (in2 - out2) * b1 + in2_w2;
+					in2_w2 = b2 * in2;
+					in2_w2 -= a2 * out2;				
 				}
 				else
 				{
@@ -756,6 +783,11 @@ DSP_FUNC_DEF void DSPS_PLAY_PROCESS(long *lp_data, int l_length,
 
 				dutilPutOutputsAndMeter(out1, out2, status);
 			}
+
+			s->in1_w1 = in1_w1;
+			s->in1_w2 = in1_w2;
+			s->in2_w1 = in2_w1;
+			s->in2_w2 = in2_w2;
 		}
 
 #if !defined( PT_DMX_BUILD )
@@ -776,6 +808,9 @@ DSP_FUNC_DEF void DSPS_PLAY_PROCESS(long *lp_data, int l_length,
 			unsigned data_index = 0;
 			long *read_in_buf;
 			long *read_out_buf;
+#ifdef PLY_DO_CROSS_FEED
+			long stereo_in_dma;
+#endif
 
 			realtype *delay_p = &(s->delay_lines);
 
@@ -784,9 +819,12 @@ DSP_FUNC_DEF void DSPS_PLAY_PROCESS(long *lp_data, int l_length,
 			read_out_buf = lp_data;
 
 #ifdef PLY_DO_CROSS_FEED
-			if(s->stereo_in_flag)
+			dutilLoadStereoFlag();
+			if( stereo_in_dma )
 			{
 				int i;
+				unsigned long head_delay = s->head_delay;
+				unsigned long delay_line_index = s->delay_line_index;
 				#ifdef DSP_READ_VALS
 				/* PTHACK for prototyping */
 				if( ReadVals.switch_vals[1] )
@@ -798,23 +836,21 @@ DSP_FUNC_DEF void DSPS_PLAY_PROCESS(long *lp_data, int l_length,
 					float out1, out2;
 					float left_delayed, right_delayed;
 					float cross_gain = (float)PLY_HEADPHONE_CROSSGAIN;
-					volatile long in_count = 0;
-					volatile long out_count = 0;
 
 					dutilGetInputsAndMeter( in1, in2, status);
 
 					{
 						realtype *rp;
 
-						rp = ( delay_p + s->delay_line_index );
+						rp = ( delay_p + delay_line_index );
 						left_delayed = *rp;
 						*rp = in1;
-						s->delay_line_index++;
+						delay_line_index++;
 						rp++;
 
 						right_delayed = *rp;
 						*rp = in2;
-						s->delay_line_index++;
+						delay_line_index++;
 					}
 
 					/* Note that the head_delay variable is initialized to twice the desired delay
@@ -822,11 +858,11 @@ DSP_FUNC_DEF void DSPS_PLAY_PROCESS(long *lp_data, int l_length,
 					 */
 					#ifdef DSP_READ_VALS_X
 					/* PTHACK for prototyping */
-					s->head_delay = ReadVals.l_vals[0];
+					head_delay = ReadVals.l_vals[0];
 					#endif
 
-					if( s->delay_line_index >= s->head_delay )
-						s->delay_line_index = 0;
+					if( delay_line_index >= head_delay )
+						delay_line_index = 0;
 
 					#ifdef DSP_READ_VALS_X
 					/* PTHACK for prototyping */
@@ -841,6 +877,8 @@ DSP_FUNC_DEF void DSPS_PLAY_PROCESS(long *lp_data, int l_length,
 
 					dutilPutOutputsAndMeter(out1, out2, status);
 				}
+
+				s->delay_line_index = delay_line_index;
 			} /* End of cross feeding part of headphone processing */
 #endif /* #ifdef PLY_DO_CROSS_FEED */
 
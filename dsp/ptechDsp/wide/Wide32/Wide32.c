@@ -187,13 +187,45 @@ DSP_FUNC_DEF void DSPS_WIDE_PROCESS(long *lp_data, int l_length,
 	 */
 	long *read_in_buf;
 	long *read_out_buf;
+	long stereo_in_dma;
 
 	int i;
+	struct dspWideStructType *s = (struct dspWideStructType *)(COMM_MEM_OFFSET);
 
-	/* Run one buffer full of data. Zero index and averaged meter vals.
-	 * Note- making local version of s->ptr, s->MasterStart, s->MasterEnd and s->MasterLen
-	 * didn't improve performance any.
-	 */
+	/* Parameters are loaded once per buffer */
+	realtype a0 = s->a0;
+	realtype a1 = s->a1;
+	realtype gain = s->gain;
+	realtype center_gain = s->center_gain;
+	long center_depth = s->center_depth;
+	realtype side_gain = (realtype)5.0 * s->intensity;
+	realtype width = s->width;
+	realtype reverse_width = s->reverse_width;
+	realtype master_gain = s->master_gain;
+	long bypass_on = s->bypass_flag;
+	realtype *dly_start_l = s->dly_start_l;
+	realtype *dly_start_r = s->dly_start_r;
+	realtype *dly_start_mono = s->dly_start_mono;
+	realtype *dly_end_l = dly_start_l + s->dispersion_l;
+	realtype *dly_end_r = dly_start_r + s->dispersion_r;
+	realtype *dly_end_mono = dly_start_mono + center_depth;
+
+	/* Delay and filter state, stored back at end of buffer processing */
+	realtype *ptr_l = s->ptr_l;
+	realtype *ptr_r = s->ptr_r;
+	realtype *ptr_mono = s->ptr_mono;
+	realtype out1_minus1 = s->out1_minus1;
+	realtype out1_minus2 = s->out1_minus2;
+	realtype in1_minus1 = s->in1_minus1;
+	realtype in1_minus2 = s->in1_minus2;
+	realtype out2_minus1 = s->out2_minus1;
+	realtype out2_minus2 = s->out2_minus2;
+	realtype in2_minus1 = s->in2_minus1;
+	realtype in2_minus2 = s->in2_minus2;
+
+	dutilLoadStereoFlag();
+
+	/* Run one buffer full of data. Zero index and averaged meter vals. */
 
 	read_in_buf = lp_data;
 	read_out_buf = lp_data;
@@ -202,18 +234,9 @@ DSP_FUNC_DEF void DSPS_WIDE_PROCESS(long *lp_data, int l_length,
 	{
 		float out1, out2;
 		float in1, in2;
-		volatile long in_count = 0;
-		volatile long out_count = 0;
 		float dly_l_out, dly_r_out, dly_mono;
-
-		struct dspWideStructType *s = (struct dspWideStructType *)(COMM_MEM_OFFSET);
 		float filtH1, filtH2;
 		float mono_sig, l_minus_mono, r_minus_mono;
-		
-	  	load_parameter(); /* If its been sent, loads a parameter into memory */
-
-		/* Next line includes kerdmaru.h run loop macro (no args) */
-		#include "kerdmaru.h"
 
 	  	out1 = out2 = (realtype)0.0;
 		 
@@ -224,67 +247,61 @@ DSP_FUNC_DEF void DSPS_WIDE_PROCESS(long *lp_data, int l_length,
 		r_minus_mono = in2 - mono_sig;
 
 		/* Implement Highpass linear transformed 2nd order Butterworth filter */
-		/* Note using Nil's method for allowing optimizer to work well, all
-		 * parameters and internal states are in a structure that is accessed
-		 * via a pointer.
-		 */
 		{
-			filtH1 = s->out1_minus1 * s->a1 + s->out1_minus2 * s->a0;
-			s->out1_minus2 = s->out1_minus1;
-			/* Add bias to avoid zero input cpu load increases */
-			filtH1 += (l_minus_mono + (realtype)1.0e-30 - (realtype)2.0 * s->in1_minus1 + s->in1_minus2) * s->gain;
-			s->out1_minus1 = filtH1;
-			s->in1_minus2 = s->in1_minus1;
-			s->in1_minus1 = l_minus_mono;
-
-			filtH2 = s->out2_minus1 * s->a1 + s->out2_minus2 * s->a0;
-			s->out2_minus2 = s->out2_minus1;
-			/* Add bias to avoid zero input cpu load increases */
-			filtH2 += (r_minus_mono  + (realtype)1.0e-30 - (realtype)2.0 * s->in2_minus1 + s->in2_minus2) * s->gain;
-			s->out2_minus1 = filtH2;
-			s->in2_minus2 = s->in2_minus1;
-			s->in2_minus1 = r_minus_mono;
+			filtH1 = out1_minus1 * a1 + out1_minus2 * a0;
+			out1_minus2 = out1_minus1;
+			filtH1 += (l_minus_mono - (realtype)2.0 * in1_minus1 + in1_minus2) * gain;
+			out1_minus1 = filtH1;
+			in1_minus2 = in1_minus1;
+			in1_minus1 = l_minus_mono;
+
+			filtH2 = out2_minus1 * a1 + out2_minus2 * a0;
+			out2_minus2 = out2_minus1;
+			filtH2 += (r_minus_mono - (realtype)2.0 * in2_minus1 + in2_minus2) * gain;
+			out2_minus1 = filtH2;
+			in2_minus2 = in2_minus1;
+			in2_minus1 = r_minus_mono;
 		}
 
-		dly_l_out = *(s->ptr_l);
-		*(s->ptr_l) = filtH1;
-		(s->ptr_l)++;
-		if( s->ptr_l >= (s->dly_start_l + s->dispersion_l) )
-			s->ptr_l = s->dly_start_l;
+		dly_l_out = *ptr_l;
+		*ptr_l = filtH1;
+		ptr_l++;
+		if( ptr_l >= dly_end_l )
+			ptr_l = dly_start_l;
 
-		dly_r_out = *(s->ptr_r);
-		*(s->ptr_r) = filtH2;
-		(s->ptr_r)++;
-		if( s->ptr_r >= (s->dly_start_r + s->dispersion_r) )
-			s->ptr_r = s->dly_start_r;
+		dly_r_out = *ptr_r;
+		*ptr_r = filtH2;
+		ptr_r++;
+		if( ptr_r >= dly_end_r )
+			ptr_r = dly_start_r;
 
 		/* Skip this section if there is no delay to the mono signal */
-		if( s->center_depth > 1 )
+		if( center_depth > 1 )
 		{
-			dly_mono = *(s->ptr_mono);
-			*(s->ptr_mono) = mono_sig;
-			(s->ptr_mono)++;
-			if( s->ptr_mono >= (s->dly_start_mono + s->center_depth) )
-				s->ptr_mono = s->dly_start_mono;
+			dly_mono = *ptr_mono;
+			*ptr_mono = mono_sig;
+			ptr_mono++;
+			if( ptr_mono >= dly_end_mono )
+				ptr_mono = dly_start_mono;
 		}
 		else
 			dly_mono = mono_sig;
 
-		dly_mono *= s->center_gain;
+		dly_mono *= center_gain;
 
-		out1 = l_minus_mono + dly_mono - (realtype)5.0 * s->intensity * (s->width * dly_r_out + s->reverse_width * dly_l_out);
-		out1 *= s->master_gain;
-		out2 = r_minus_mono + dly_mono - (realtype)5.0 * s->intensity * (s->width * dly_l_out + s->reverse_width * dly_r_out);
-		out2 *= s->master_gain;
+		out1 = l_minus_mono + dly_mono - side_gain * (width * dly_r_out + reverse_width * dly_l_out);
+		out1 *= master_gain;
+		out2 = r_minus_mono + dly_mono - side_gain * (width * dly_l_out + reverse_width * dly_r_out);
+		out2 *= master_gain;
 
-		if( !(s->stereo_in_flag) )
+		if( !stereo_in_dma )
 		{
 			in2 = (realtype)0.0;
 			out1 *= (realtype)0.5;
 			out2 *= (realtype)0.5;
 		}
 
-		if( s->bypass_flag )
+		if( bypass_on )
 		{
 			out1 = in1;
 			out2 = in2;
@@ -297,6 +314,18 @@ DSP_FUNC_DEF void DSPS_WIDE_PROCESS(long *lp_data, int l_length,
 		write_meters_and_status(in_meter1, in_meter2, out_meter1, out_meter2, status, transfer_state);
 	}
 
+	s->ptr_l = ptr_l;
+	s->ptr_r = ptr_r;
+	s->ptr_mono = ptr_mono;
+	s->out1_minus1 = out1_minus1;
+	s->out1_minus2 = out1_minus2;
+	s->in1_minus1 = in1_minus1;
+	s->in1_minus2 = in1_minus2;
+	s->out2_minus1 = out2_minus1;
+	s->out2_minus2 = out2_minus2;
+	s->in2_minus1 = in2_minus1;
+	s->in2_minus2 = in2_minus2;
+
 	/* Write averaged meter data temporarily writing as a float.
 	 * Will be converted to long and factored in calling function.
 	 */
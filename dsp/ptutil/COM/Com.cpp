@@ -113,6 +113,10 @@ int PT_DECLSPEC comInit(PT_HANDLE **hpp_com, int i_softdsp, int i_board_address,
 	cast_handle->cracked_flag = IS_FALSE;
 	cast_handle->dongle_exists = IS_FALSE;
 
+	/* Design the filters for rates above the max internal rate */
+	if (com_ResampleInit((PT_HANDLE *)cast_handle) != OKAY)
+		return(NOT_OKAY);
+
    /* 
     * Check if there is a hardware card, initializes it if it exists. 
     * If there are no cards configured, don't even check.
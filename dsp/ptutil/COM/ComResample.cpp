@@ -0,0 +1,512 @@
+/*
+FxSound
+Copyright (C) 2025  FxSound LLC
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/* Standard includes */
+
+#include <math.h>
+#include <string.h>
+#include <stdio.h> 
+#include "codedefs.h"
+
+extern "C"
+{
+#include "c_dsps.h"
+}
+#include "com.h"
+#include "u_com.h"
+
+/*
+ * Sampling rate change for data above the max internal sampling rate.
+ * Each 2x step is a polyphase half band FIR. Every other tap of a half band filter is zero and the
+ * center tap is 0.5, so the decimator only filters the even phase and adds the delayed odd phase,
+ * and the interpolator only filters the even outputs, the odd outputs are the delayed input.
+ * 4x runs a short wide transition stage at the full rate followed by the steep 2x stage.
+ *
+ * Steep filter, 63 taps: +-0.001 dB to 0.208 fs, 79 dB down from 0.292 fs (20k/28k at 96k).
+ * Wide filter, 23 taps: +-0.001 dB to 0.125 fs, 77 dB down from 0.375 fs (24k/72k at 192k).
+ */
+#define COM_HALFBAND_STEEP_TAPS   32
+#define COM_HALFBAND_WIDE_TAPS    12
+#define COM_HALFBAND_KAISER_BETA  7.86
+#define COM_HALFBAND_PI           3.14159265358979323846
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define COM_SIMD_X86
+#include <emmintrin.h>
+#endif
+
+/*
+ * FUNCTION: com_BesselI0()
+ * DESCRIPTION:
+ *   Zeroth order modified Bessel function, for the Kaiser window.
+ */
+static double com_BesselI0(double d_x)
+{
+	double d_sum = 1.0;
+	double d_term = 1.0;
+	int k;
+
+	for (k = 1; k < 50; k++)
+	{
+		d_term *= (d_x / (2.0 * k)) * (d_x / (2.0 * k));
+		d_sum += d_term;
+		if (d_term < d_sum * 1.0e-12)
+			break;
+	}
+
+	return(d_sum);
+}
+
+/*
+ * FUNCTION: com_HalfbandDesign()
+ * DESCRIPTION:
+ *   Kaiser windowed sinc half band filter with 2 * i_num_taps - 1 taps, of which only the i_num_taps
+ *   non zero side taps are stored. They are scaled so the filter has unity gain at DC.
+ */
+static void com_HalfbandDesign(struct comHalfbandFilterType *sp_filter, int i_num_taps, double d_beta)
+{
+	double d_taps[COM_HALFBAND_MAX_TAPS];
+	double d_sum = 0.0;
+	double d_center = (double)(i_num_taps - 1);
+	double d_offset;
+	double d_pos;
+	int j;
+
+	for (j = 0; j < i_num_taps; j++)
+	{
+		/* Side tap j is at full filter index 2j, an odd distance from the center */
+		d_offset = (double)(2 * j) - d_center;
+		d_pos = d_offset / d_center;
+		d_taps[j] = sin(COM_HALFBAND_PI * d_offset * 0.5) / (COM_HALFBAND_PI * d_offset) *
+						com_BesselI0(d_beta * sqrt(1.0 - d_pos * d_pos)) / com_BesselI0(d_beta);
+		d_sum += d_taps[j];
+	}
+
+	sp_filter->num_taps = i_num_taps;
+	for (j = 0; j < i_num_taps; j++)
+	{
+		sp_filter->coeffs[j] = (float)(d_taps[j] * 0.5 / d_sum);
+		sp_filter->coeffs_x2[j] = (float)(d_taps[j] / d_sum);
+	}
+}
+
+/*
+ * FUNCTION: com_HalfbandDecimDot()
+ * DESCRIPTION:
+ *   Even phase sum of the decimator. fp_x points at the oldest sample of the span, the even samples
+ *   fp_x[0], fp_x[2] .. fp_x[2 * (i_num_taps - 1)] are used. The filter is symmetric so the tap order
+ *   does not matter. The vector loads read one sample past the span.
+ */
+static float com_HalfbandDecimDot(const float *fp_x, const float *fp_coeffs, int i_num_taps)
+{
+#ifdef COM_SIMD_X86
+	__m128 acc = _mm_setzero_ps();
+	__m128 lo, hi;
+	int j;
+
+	for (j = 0; j < i_num_taps; j += 4)
+	{
+		lo = _mm_loadu_ps(fp_x + 2 * j);
+		hi = _mm_loadu_ps(fp_x + 2 * j + 4);
+		acc = _mm_add_ps(acc, _mm_mul_ps(_mm_shuffle_ps(lo, hi, _MM_SHUFFLE(2, 0, 2, 0)), _mm_loadu_ps(fp_coeffs + j)));
+	}
+	acc = _mm_add_ps(acc, _mm_movehl_ps(acc, acc));
+	acc = _mm_add_ss(acc, _mm_shuffle_ps(acc, acc, _MM_SHUFFLE(1, 1, 1, 1)));
+
+	return(_mm_cvtss_f32(acc));
+#else
+	float sum = 0.0f;
+	int j;
+
+	for (j = 0; j < i_num_taps; j++)
+		sum += fp_coeffs[j] * fp_x[2 * j];
+
+	return(sum);
+#endif
+}
+
+/*
+ * FUNCTION: com_HalfbandInterpDot()
+ * DESCRIPTION:
+ *   Even output sum of the interpolator, over i_num_taps contiguous samples starting at the oldest.
+ */
+static float com_HalfbandInterpDot(const float *fp_x, const float *fp_coeffs, int i_num_taps)
+{
+#ifdef COM_SIMD_X86
+	__m128 acc = _mm_setzero_ps();
+	int j;
+
+	for (j = 0; j < i_num_taps; j += 4)
+		acc = _mm_add_ps(acc, _mm_mul_ps(_mm_loadu_ps(fp_x + j), _mm_loadu_ps(fp_coeffs + j)));
+
+	acc = _mm_add_ps(acc, _mm_movehl_ps(acc, acc));
+	acc = _mm_add_ss(acc, _mm_shuffle_ps(acc, acc, _MM_SHUFFLE(1, 1, 1, 1)));
+
+	return(_mm_cvtss_f32(acc));
+#else
+	float sum = 0.0f;
+	int j;
+
+	for (j = 0; j < i_num_taps; j++)
+		sum += fp_coeffs[j] * fp_x[j];
+
+	return(sum);
+#endif
+}
+
+/*
+ * FUNCTION: com_HalfbandDecimate()
+ * DESCRIPTION:
+ *   Decimates interleaved data by 2 in place, returns the number of sample sets produced.
+ *   The phase is carried between calls so odd length buffers are handled without dropping samples.
+ */
+static long com_HalfbandDecimate(struct comHalfbandFilterType *sp_filter, struct comHalfbandDecimType *sp_decim,
+											float *fp_data, long l_num_sets, int i_num_channels)
+{
+	int i_num_taps = sp_filter->num_taps;
+	int i_hist_len = 2 * i_num_taps - 2;
+	long l_read_pos = 0;
+	long l_write_pos = 0;
+	int i_chunk;
+	int ch;
+	int t;
+	float *fp_x;
+
+	while (l_read_pos < l_num_sets)
+	{
+		i_chunk = (int)(l_num_sets - l_read_pos);
+		if (i_chunk > COM_HALFBAND_CHUNK_SETS)
+			i_chunk = COM_HALFBAND_CHUNK_SETS;
+
+		for (ch = 0; ch < i_num_channels; ch++)
+			for (t = 0; t < i_chunk; t++)
+				sp_decim->work[ch][i_hist_len + t] = fp_data[(l_read_pos + t) * i_num_channels + ch];
+
+		/* An output is due on every second input */
+		for (t = 1 - sp_decim->phase; t < i_chunk; t += 2)
+		{
+			for (ch = 0; ch < i_num_channels; ch++)
+			{
+				fp_x = &(sp_decim->work[ch][t]);
+				fp_data[l_write_pos * i_num_channels + ch] = com_HalfbandDecimDot(fp_x, sp_filter->coeffs, i_num_taps) +
+																			0.5f * fp_x[i_num_taps - 1];
+			}
+			l_write_pos++;
+		}
+		sp_decim->phase = (sp_decim->phase + i_chunk) & 1;
+
+		for (ch = 0; ch < i_num_channels; ch++)
+			memmove(&(sp_decim->work[ch][0]), &(sp_decim->work[ch][i_chunk]), i_hist_len * sizeof(float));
+
+		l_read_pos += i_chunk;
+	}
+
+	return(l_write_pos);
+}
+
+/*
+ * FUNCTION: com_HalfbandInterpolate()
+ * DESCRIPTION:
+ *   Interpolates interleaved data by 2 in place. Output set m is written to set l_offset + m,
+ *   sets at or past l_limit go to fp_overflow instead. Runs from the end of the buffer back
+ *   since the outputs take up more room than the inputs.
+ */
+static void com_HalfbandInterpolate(struct comHalfbandFilterType *sp_filter, struct comHalfbandInterpType *sp_interp,
+												float *fp_data, long l_num_sets, int i_num_channels,
+												long l_offset, long l_limit, float *fp_overflow)
+{
+	float new_hist[COM_RESAMPLE_MAX_CHANNELS][COM_HALFBAND_MAX_TAPS - 1];
+	int i_num_taps = sp_filter->num_taps;
+	int i_hist_len = i_num_taps - 1;
+	long l_start;
+	long l_end;
+	long l_index;
+	long l_pos;
+	int i_chunk;
+	int ch;
+	int i;
+	float *fp_x;
+	float *fp_out;
+
+	/* The inputs are overwritten as we go, so save the history for the next buffer first */
+	for (ch = 0; ch < i_num_channels; ch++)
+		for (i = 0; i < i_hist_len; i++)
+		{
+			l_index = l_num_sets - i_hist_len + i;
+			new_hist[ch][i] = (l_index >= 0) ? fp_data[l_index * i_num_channels + ch] : sp_interp->hist[ch][i_hist_len + l_index];
+		}
+
+	l_end = l_num_sets;
+	while (l_end > 0)
+	{
+		l_start = l_end - COM_HALFBAND_CHUNK_SETS;
+		if (l_start < 0)
+			l_start = 0;
+		i_chunk = (int)(l_end - l_start);
+
+		for (ch = 0; ch < i_num_channels; ch++)
+		{
+			for (i = 0; i < i_hist_len; i++)
+			{
+				l_index = l_start - i_hist_len + i;
+				sp_interp->work[ch][i] = (l_index >= 0) ? fp_data[l_index * i_num_channels + ch] : sp_interp->hist[ch][i_hist_len + l_index];
+			}
+			for (i = 0; i < i_chunk; i++)
+				sp_interp->work[ch][i_hist_len + i] = fp_data[(l_start + i) * i_num_channels + ch];
+		}
+
+		for (i = 0; i < i_chunk; i++)
+		{
+			l_pos = l_offset + 2 * (l_start + i);
+
+			for (ch = 0; ch < i_num_channels; ch++)
+			{
+				fp_x = &(sp_interp->work[ch][i]);
+
+				fp_out = (l_pos < l_limit) ? &(fp_data[l_pos * i_num_channels]) : &(fp_overflow[(l_pos - l_limit) * i_num_channels]);
+				fp_out[ch] = com_HalfbandInterpDot(fp_x, sp_filter->coeffs_x2, i_num_taps);
+
+				fp_out = (l_pos + 1 < l_limit) ? &(fp_data[(l_pos + 1) * i_num_channels]) : &(fp_overflow[(l_pos + 1 - l_limit) * i_num_channels]);
+				fp_out[ch] = fp_x[i_num_taps / 2];
+			}
+		}
+
+		l_end = l_start;
+	}
+
+	memcpy(sp_interp->hist, new_hist, sizeof(new_hist));
+}
+
+/*
+ * FUNCTION: com_ResampleStageFilter()
+ * DESCRIPTION:
+ *   Returns the filter for the passed stage, stage 0 runs at the full rate.
+ */
+static struct comHalfbandFilterType *com_ResampleStageFilter(struct comResampleType *sp_resample, int i_rate_ratio, int i_stage)
+{
+	if ((i_rate_ratio == 4) && (i_stage == 0))
+		return(&(sp_resample->wide_filter));
+
+	return(&(sp_resample->steep_filter));
+}
+
+/*
+ * FUNCTION: com_ResampleInit()
+ * DESCRIPTION:
+ *   Designs the half band filters, called from comInit().
+ */
+int com_ResampleInit(PT_HANDLE *hp_com)
+{
+	struct comHdlType *cast_handle;
+
+	cast_handle = (struct comHdlType *)hp_com;
+
+	if (cast_handle == NULL)
+		return(NOT_OKAY);
+
+	com_HalfbandDesign(&(cast_handle->resample.steep_filter), COM_HALFBAND_STEEP_TAPS, COM_HALFBAND_KAISER_BETA);
+	com_HalfbandDesign(&(cast_handle->resample.wide_filter), COM_HALFBAND_WIDE_TAPS, COM_HALFBAND_KAISER_BETA);
+
+	cast_handle->resample.down_rate_ratio = 0;
+	cast_handle->resample.up_rate_ratio = 0;
+
+	return(OKAY);
+}
+
+/*
+ * FUNCTION: comResampleDown()
+ * DESCRIPTION:
+ *   Decimates l_length interleaved sample sets in place by i_rate_ratio (1, 2 or 4) and passes back
+ *   the number of sets produced, which varies by one set between calls for lengths that are not a
+ *   multiple of the ratio. The state is reset when the ratio or channel count changes.
+ */
+int PT_DECLSPEC comResampleDown(PT_HANDLE *hp_com, float *fp_data, long l_length, int i_num_channels,
+										  int i_rate_ratio, long *lp_num_sets_out)
+{
+	struct comHdlType *cast_handle;
+	struct comResampleType *sp_resample;
+	long l_num_sets;
+	int i_stage;
+
+	cast_handle = (struct comHdlType *)hp_com;
+
+	*lp_num_sets_out = l_length;
+
+	if (cast_handle == NULL)
+		return(NOT_OKAY);
+
+	if (i_rate_ratio == 1)
+		return(OKAY);
+
+	if (((i_rate_ratio != 2) && (i_rate_ratio != 4)) || (i_num_channels < 1) || (i_num_channels > COM_RESAMPLE_MAX_CHANNELS))
+		return(NOT_OKAY);
+
+	sp_resample = &(cast_handle->resample);
+
+	if ((sp_resample->down_rate_ratio != i_rate_ratio) || (sp_resample->down_num_channels != i_num_channels))
+	{
+		memset(sp_resample->decim, 0, sizeof(sp_resample->decim));
+		sp_resample->down_rate_ratio = i_rate_ratio;
+		sp_resample->down_num_channels = i_num_channels;
+	}
+
+	l_num_sets = l_length;
+	for (i_stage = 0; (1 << i_stage) < i_rate_ratio; i_stage++)
+		l_num_sets = com_HalfbandDecimate(com_ResampleStageFilter(sp_resample, i_rate_ratio, i_stage), &(sp_resample->decim[i_stage]),
+													 fp_data, l_num_sets, i_num_channels);
+
+	*lp_num_sets_out = l_num_sets;
+
+	return(OKAY);
+}
+
+/*
+ * FUNCTION: comResampleUp()
+ * DESCRIPTION:
+ *   Interpolates l_num_sets interleaved sample sets in place by i_rate_ratio, filling exactly l_length sets.
+ *   l_num_sets must be what comResampleDown() passed back for a buffer of l_length sets. Sets left over
+ *   are held for the start of the next buffer, which is why the output is delayed by i_rate_ratio - 1 sets.
+ */
+int PT_DECLSPEC comResampleUp(PT_HANDLE *hp_com, float *fp_data, long l_num_sets, int i_num_channels,
+										int i_rate_ratio, long l_length)
+{
+	struct comHdlType *cast_handle;
+	struct comResampleType *sp_resample;
+	float old_fifo[(COM_RESAMPLE_MAX_RATIO - 1) * COM_RESAMPLE_MAX_CHANNELS];
+	float small_buf[2 * COM_RESAMPLE_MAX_RATIO * COM_RESAMPLE_MAX_CHANNELS];
+	float *fp_work;
+	float *fp_out;
+	long l_num_out;
+	long l_num_left;
+	int i_num_stages;
+	int i_stage;
+	int i_set;
+
+	cast_handle = (struct comHdlType *)hp_com;
+
+	if (cast_handle == NULL)
+		return(NOT_OKAY);
+
+	if (i_rate_ratio == 1)
+		return(OKAY);
+
+	if (((i_rate_ratio != 2) && (i_rate_ratio != 4)) || (i_num_channels < 1) || (i_num_channels > COM_RESAMPLE_MAX_CHANNELS))
+		return(NOT_OKAY);
+
+	sp_resample = &(cast_handle->resample);
+
+	if ((sp_resample->up_rate_ratio != i_rate_ratio) || (sp_resample->up_num_channels != i_num_channels))
+	{
+		memset(sp_resample->interp, 0, sizeof(sp_resample->interp));
+		memset(sp_resample->fifo, 0, sizeof(sp_resample->fifo));
+		sp_resample->num_fifo_sets = i_rate_ratio - 1;
+		sp_resample->up_rate_ratio = i_rate_ratio;
+		sp_resample->up_num_channels = i_num_channels;
+	}
+
+	/* The held sets plus the new output must cover the buffer without overflowing the fifo */
+	l_num_out = sp_resample->num_fifo_sets + l_num_sets * i_rate_ratio;
+	l_num_left = l_num_out - l_length;
+	if ((l_num_left < 0) || (l_num_left > i_rate_ratio - 1))
+		return(NOT_OKAY);
+
+	memcpy(old_fifo, sp_resample->fifo, sp_resample->num_fifo_sets * i_num_channels * sizeof(float));
+
+	/* A one set buffer has no room for the output of the intermediate 4x stage, run it in a local buffer */
+	fp_work = fp_data;
+	i_num_stages = (i_rate_ratio == 4) ? 2 : 1;
+	if ((i_num_stages > 1) && (l_num_sets * 2 > l_length))
+	{
+		memcpy(small_buf, fp_data, l_num_sets * i_num_channels * sizeof(float));
+		fp_work = small_buf;
+	}
+
+	for (i_stage = i_num_stages - 1; i_stage > 0; i_stage--)
+	{
+		com_HalfbandInterpolate(com_ResampleStageFilter(sp_resample, i_rate_ratio, i_stage), &(sp_resample->interp[i_stage]),
+										fp_work, l_num_sets, i_num_channels, 0L, 2 * l_num_sets, NULL);
+		l_num_sets *= 2;
+	}
+
+	/* The full rate stage writes after the held sets, anything past the buffer goes to the fifo */
+	com_HalfbandInterpolate(com_ResampleStageFilter(sp_resample, i_rate_ratio, 0), &(sp_resample->interp[0]),
+									fp_work, l_num_sets, i_num_channels, (long)sp_resample->num_fifo_sets, l_length, sp_resample->fifo);
+
+	if (fp_work != fp_data)
+		memcpy(fp_data, fp_work, l_length * i_num_channels * sizeof(float));
+
+	/* The held sets go first, when the buffer is shorter than them the rest are held again */
+	for (i_set = 0; i_set < sp_resample->num_fifo_sets; i_set++)
+	{
+		fp_out = (i_set < l_length) ? &(fp_data[i_set * i_num_channels]) : &(sp_resample->fifo[(i_set - l_length) * i_num_channels]);
+		memcpy(fp_out, &(old_fifo[i_set * i_num_channels]), i_num_channels * sizeof(float));
+	}
+	sp_resample->num_fifo_sets = (int)l_num_left;
+
+	return(OKAY);
+}
+
+/*
+ * FUNCTION: comResampleReset()
+ * DESCRIPTION:
+ *   Clears the resampler history, the next buffer starts from silence.
+ */
+int PT_DECLSPEC comResampleReset(PT_HANDLE *hp_com)
+{
+	struct comHdlType *cast_handle;
+
+	cast_handle = (struct comHdlType *)hp_com;
+
+	if (cast_handle == NULL)
+		return(NOT_OKAY);
+
+	cast_handle->resample.down_rate_ratio = 0;
+	cast_handle->resample.up_rate_ratio = 0;
+
+	return(OKAY);
+}
+
+/*
+ * FUNCTION: comGetResampleLatency()
+ * DESCRIPTION:
+ *   Passes back the delay in sample sets at the actual sampling rate added by a comResampleDown(),
+ *   comResampleUp() round trip, the group delay of each filter going down and coming back up.
+ *   The ratio - 1 held sets don't add to it since the decimators output on the last input of each group.
+ *   62 sets for 2x (0.65 msecs at 96k), 146 sets for 4x (0.76 msecs at 192k).
+ */
+int PT_DECLSPEC comGetResampleLatency(int i_rate_ratio, int *ip_latency_sets)
+{
+	*ip_latency_sets = 0;
+
+	if (i_rate_ratio == 1)
+		return(OKAY);
+
+	if (i_rate_ratio == 2)
+	{
+		*ip_latency_sets = 2 * (COM_HALFBAND_STEEP_TAPS - 1);
+		return(OKAY);
+	}
+
+	if (i_rate_ratio == 4)
+	{
+		*ip_latency_sets = 2 * (COM_HALFBAND_WIDE_TAPS - 1) + 2 * 2 * (COM_HALFBAND_STEEP_TAPS - 1);
+		return(OKAY);
+	}
+
+	return(NOT_OKAY);
+}
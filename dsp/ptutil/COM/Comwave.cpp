@@ -83,7 +83,7 @@ int PT_DECLSPEC comProcessBuffer(PT_HANDLE *hp_com, long *lp_data, long l_length
  *  If packed 24 bit format, uses rp_float as a temporary buffer
  *  to convert to MS floating format (-1.0 to 1.0).
  *  i_down_sample_ratio is used on data with sampling frequencies greater than 48khz to down sample the data
- *  before processing and then upsample it after processing.
+ *  before processing and then upsample it after processing, see comResample.cpp.
  *
  */
 int PT_DECLSPEC comProcessWaveBuffer(PT_HANDLE *hp_com, long *lp_data, float *rp_float, long l_length, 
@@ -94,10 +94,8 @@ int PT_DECLSPEC comProcessWaveBuffer(PT_HANDLE *hp_com, long *lp_data, float *rp
    struct comHdlType *cast_handle;
 	long *l_ptr;
 	float *f_ptr;
-	int leftover_samples;
-	int num_down_sample_sets;
+	long num_down_sample_sets;
 	int num_sample_sets_to_process;
-	int i,j;
 
    cast_handle = (struct comHdlType *)hp_com;
 
@@ -120,29 +118,13 @@ int PT_DECLSPEC comProcessWaveBuffer(PT_HANDLE *hp_com, long *lp_data, float *rp
    // since /sdl option is turned on in DfxDsp (it is turned off in original code base so this was treated as warning instead of error).
 	f_ptr = (float *)l_ptr;
    
-	// Downsample the data if needed for higher data sampling frequencies
+	// Downsample the data if needed for higher data sampling frequencies, half band filtered so nothing aliases
 	if(i_down_sample_ratio > 1)
 	{
-		f_ptr = (float *)l_ptr;
-		leftover_samples = l_length % i_down_sample_ratio;
-		num_down_sample_sets = l_length/i_down_sample_ratio;
-		num_sample_sets_to_process = num_down_sample_sets;
-
-		if(i_stereo_in_mode)
-		{
-			for(i=0; i<num_down_sample_sets; i++)
-			{
-				f_ptr[i * 2]     = f_ptr[i * 2 * i_down_sample_ratio];
-				f_ptr[i * 2 + 1] = f_ptr[i * 2 * i_down_sample_ratio + 1];
-			}
-		}
-		else // Mono case
-		{
-			for(i=0; i< num_down_sample_sets; i++)
-			{
-				f_ptr[i] = f_ptr[i * i_down_sample_ratio];
-			}
-		}
+		if (comResampleDown(hp_com, f_ptr, l_length, i_stereo_in_mode ? 2 : 1, i_down_sample_ratio, &num_down_sample_sets) != OKAY)
+			return(NOT_OKAY);
+
+		num_sample_sets_to_process = (int)num_down_sample_sets;
 	}
 
 	if (cast_handle->softdsp_mode)
@@ -162,45 +144,11 @@ int PT_DECLSPEC comProcessWaveBuffer(PT_HANDLE *hp_com, long *lp_data, float *rp
 		return(NOT_OKAY);
    }
 
-	// Upsample the data if needed for higher data sampling frequencies
+	// Upsample the data back to the full buffer length, see comGetResampleLatency() for the added delay
 	if(i_down_sample_ratio > 1)
 	{
-		if(i_stereo_out_mode)
-		{
-			for(i=(num_down_sample_sets - 1); i >= 0; i--)
-			{
-				// To be replace with sample averaging operation
-				for(j=0; j<i_down_sample_ratio; j++)
-				{
-					f_ptr[i * 2 * i_down_sample_ratio + j * 2] = f_ptr[i * 2];
-					f_ptr[i * 2 * i_down_sample_ratio + 1 + j * 2] = f_ptr[i * 2 + 1];
-				}
-			}
-			if( leftover_samples > 0 ) // Fill in leftover samples with last processed value
-				for(i=0; i<leftover_samples; i++)
-				{
-					f_ptr[ (num_down_sample_sets * i_down_sample_ratio + i) * 2 ] = 
-							f_ptr[ (num_down_sample_sets * i_down_sample_ratio - 1) * 2 ];
-
-					f_ptr[ (num_down_sample_sets * i_down_sample_ratio + i) * 2 + 1 ] = 
-							f_ptr[ (num_down_sample_sets * i_down_sample_ratio - 1) * 2 + 1 ];
-				}
-		}
-		else // Mono case
-		{
-			for(i=(num_down_sample_sets - 1); i >= 0; i--)
-			{
-				for(j=0; j<i_down_sample_ratio; j++)
-					f_ptr[i * i_down_sample_ratio + j] = f_ptr[i];
-			}
-
-			if( leftover_samples > 0 ) // Fill in leftover samples with last processed value
-				for(i=0; i<leftover_samples; i++)
-				{
-					f_ptr[ num_down_sample_sets * i_down_sample_ratio + i] = 
-							f_ptr[ num_down_sample_sets * i_down_sample_ratio - 1];
-				}
-		}
+		if (comResampleUp(hp_com, f_ptr, (long)num_sample_sets_to_process, i_stereo_out_mode ? 2 : 1, i_down_sample_ratio, l_length) != OKAY)
+			return(NOT_OKAY);
 	}
 
 	if ( i_format_flag == COM_24_BIT_SAMPLES )
@@ -23,8 +23,53 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "c_dsps.h"
 #include "slout.h"
 
+/* Half band resampler used above the max internal sampling rate, see ComResample.cpp */
+#define COM_HALFBAND_MAX_TAPS        32  /* Non zero side taps of the longest half band filter, multiple of 4 */
+#define COM_HALFBAND_CHUNK_SETS     256  /* Sample sets filtered per pass */
+#define COM_HALFBAND_PAD              4  /* Room for the vector loads reading past the last sample */
+#define COM_RESAMPLE_MAX_STAGES       2  /* Two 2x stages for 4x */
+#define COM_RESAMPLE_MAX_CHANNELS     2
+#define COM_RESAMPLE_MAX_RATIO        4
+
+/* One 2x half band filter. Only the non zero side taps are stored, the center tap is always 0.5 */
+struct comHalfbandFilterType {
+	int num_taps;                            /* Non zero side taps, 2K for a 4K-1 tap filter */
+	float coeffs[COM_HALFBAND_MAX_TAPS];     /* Side taps, symmetric */
+	float coeffs_x2[COM_HALFBAND_MAX_TAPS];  /* Side taps times 2, for the interpolator gain */
+};
+
+/* Decimator state, work holds the full rate history followed by the current chunk */
+struct comHalfbandDecimType {
+	int phase; /* Inputs since the last output, 0 or 1 */
+	float work[COM_RESAMPLE_MAX_CHANNELS][2 * COM_HALFBAND_MAX_TAPS - 2 + COM_HALFBAND_CHUNK_SETS + COM_HALFBAND_PAD];
+};
+
+/* Interpolator state, hist holds the last low rate inputs of the previous buffer */
+struct comHalfbandInterpType {
+	float hist[COM_RESAMPLE_MAX_CHANNELS][COM_HALFBAND_MAX_TAPS - 1];
+	float work[COM_RESAMPLE_MAX_CHANNELS][COM_HALFBAND_MAX_TAPS - 1 + COM_HALFBAND_CHUNK_SETS + COM_HALFBAND_PAD];
+};
+
+struct comResampleType {
+	struct comHalfbandFilterType steep_filter; /* Used alone for 2x and as the second 4x stage */
+	struct comHalfbandFilterType wide_filter;  /* First 4x stage, only needs to protect the final band */
+
+	int down_rate_ratio;    /* Ratio and channel count the decimators were reset for, 0 if never used */
+	int down_num_channels;
+	struct comHalfbandDecimType decim[COM_RESAMPLE_MAX_STAGES];   /* [0] runs at the full rate, [1] at half of it */
+
+	int up_rate_ratio;      /* Ratio and channel count the interpolators were reset for, 0 if never used */
+	int up_num_channels;
+	struct comHalfbandInterpType interp[COM_RESAMPLE_MAX_STAGES];
+
+	/* Output sets that did not fit the last buffer, primed with ratio - 1 zero sets */
+	int num_fifo_sets;
+	float fifo[(COM_RESAMPLE_MAX_RATIO - 1) * COM_RESAMPLE_MAX_CHANNELS];
+};
+
 /* Local Functions */
 int com_ReadSerialNum(PT_HANDLE *, int, unsigned long *);
+int com_ResampleInit(PT_HANDLE *);
 
 /* com handle definition */
 struct comHdlType {
@@ -62,6 +107,7 @@ struct comHdlType {
 	long buffer_size; /* Size of buffers for WAV and DAW processing */
 	int softdsp_mode; /* 1 -> software DSP, 0 -> hardware DSP */
 	PT_HANDLE *comSftwr_hdl;
+	struct comResampleType resample; /* Anti aliased rate change for sampling rates above the internal max */
 };
 
 /* 
@@ -18,6 +18,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <stdlib.h>
 
 #include "codedefs.h"
+#include "RealFft.h"
 #include "BinauralSyn.h"
 #include "u_BinauralSyn.h"
 
@@ -54,13 +55,29 @@ int PT_DECLSPEC BinauralSynNew( PT_HANDLE **hpp_BinauralSyn, int i_num_coeffs )
 		cast_handle->RSsamples[i] = (realtype)0.0;
 	}
 
-	cast_handle->last_left = (realtype)0.0;
-	cast_handle->last_right = (realtype)0.0;
 	cast_handle->sample_index = 0;
-	cast_handle->s_index = 0;
-	cast_handle->s_ratio = 1;
 	cast_handle->last_samp_freq = (int)BINAURAL_SYN_DEFAULT_SAMP_FREQ;
-	cast_handle->internal_samp_rate_flag = (int)BINAURAL_SYN_COEFF_SAMP_RATE_44_1;
+
+	if( RealFftNew(&(cast_handle->fft_hdl), BINAURAL_SYN_FFT_SIZE) != OKAY )
+		return(NOT_OKAY);
+
+	// Coeffs for the standard rates, resampled from the 44.1k and 48k sets.
+	// No hrir cache until a folder is set.
+	cast_handle->cache_folder[0] = L'\0';
+	cast_handle->bank = BinauralSyn_NewBuiltInBank(cast_handle, cast_handle->fft_hdl);
+	if( cast_handle->bank == NULL )
+		return(NOT_OKAY);
+	cast_handle->published_bank = cast_handle->bank;
+	cast_handle->prepared_samp_freq = cast_handle->last_samp_freq;
+	BinauralSyn_SelectCoeffSet(cast_handle, cast_handle->last_samp_freq);
+
+	// Other rates are built by the rate worker, off the audio thread
+	if( BinauralSyn_StartRateWorker(cast_handle) != OKAY )
+		return(NOT_OKAY);
+
+	cast_handle->processing_mode = BINAURAL_SYN_MODE_PARTITIONED;
+	cast_handle->num_active_pairs = 0;
+	BinauralSyn_ResetPartitions(cast_handle);
 
 	return(OKAY);
 }
@@ -79,6 +96,15 @@ int PT_DECLSPEC BinauralSynFreeUp(PT_HANDLE **hpp_BinauralSyn)
 	if (cast_handle == NULL)
 		return(NOT_OKAY);
 
+	// Nothing is handed over once the worker has stopped
+	BinauralSyn_StopRateWorker(cast_handle);
+
+	if( cast_handle->fft_hdl != NULL )
+		RealFftFreeUp(&(cast_handle->fft_hdl));
+
+	// Current, pending and retired coeff banks
+	BinauralSyn_FreeBanks(cast_handle);
+
 	// Free main handle
 	free(cast_handle);
 
@@ -0,0 +1,785 @@
+/*
+FxSound
+Copyright (C) 2025  FxSound LLC
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <wchar.h>
+
+#include "codedefs.h"
+#include "RealFft.h"
+#include "BinauralSyn.h"
+#include "u_BinauralSyn.h"
+
+/*
+ * Loadable hrir sets. A set is read from wav files, either one file with the responses of every
+ * speaker pair or one 2 channel file per pair, and replaces the built in coeffs in every rate.
+ * The coeff sets of the standard rates, resampled and transformed, are cached in the cache folder
+ * keyed by a hash of the file contents and the rate, so loading a set that has been used before,
+ * including after a restart, only reads the cached sets back. The set for the rate the rate worker
+ * last prepared is built with the bank when it is not a standard rate, and is not cached.
+ */
+#define BINAURAL_SYN_CACHE_MAGIC   0x43485342		// "BSHC"
+#define BINAURAL_SYN_CACHE_VERSION 1
+
+#define BINAURAL_SYN_FNV_OFFSET 14695981039346656037ULL
+#define BINAURAL_SYN_FNV_PRIME  1099511628211ULL
+
+#ifdef WIN32
+#define BINAURAL_SYN_PATH_SEPARATOR L"\\"
+#else
+#define BINAURAL_SYN_PATH_SEPARATOR L"/"
+#endif
+
+#define BINAURAL_SYN_WAVE_FORMAT_PCM        1
+#define BINAURAL_SYN_WAVE_FORMAT_FLOAT      3
+#define BINAURAL_SYN_WAVE_FORMAT_EXTENSIBLE 0xFFFE
+
+/* Header of a cached coeff set, followed by the set */
+struct BinauralSynCacheHeaderType
+{
+	unsigned int magic;
+	unsigned int version;
+	unsigned long long hash;
+	int samp_freq;
+	int set_bytes;				// sizeof(struct BinauralSynCoeffSetType) when written
+	int block_size;			// BINAURAL_SYN_BLOCK_SIZE when written
+	int reserved;
+	unsigned long long checksum;		// Of the set
+};
+
+/* Audio data of a parsed wav file */
+struct BinauralSynWavType
+{
+	int format;				// BINAURAL_SYN_WAVE_FORMAT_PCM or BINAURAL_SYN_WAVE_FORMAT_FLOAT
+	int num_channels;
+	int samp_freq;
+	int bits_per_sample;
+	int block_align;
+	int num_frames;
+	unsigned char *data;
+};
+
+/*
+ * FUNCTION: BinauralSyn_Hash()
+ * DESCRIPTION:
+ *  Continues an FNV-1a 64 bit hash over the passed bytes.
+ */
+static unsigned long long BinauralSyn_Hash(unsigned long long ull_hash, const unsigned char *ucp_bytes, long l_num_bytes)
+{
+	long i;
+
+	for(i=0; i<l_num_bytes; i++)
+	{
+		ull_hash ^= (unsigned long long)ucp_bytes[i];
+		ull_hash *= BINAURAL_SYN_FNV_PRIME;
+	}
+
+	return(ull_hash);
+}
+
+/*
+ * FUNCTION: BinauralSyn_OpenFile()
+ * DESCRIPTION:
+ *  fopen() for a wide character path.
+ */
+static FILE *BinauralSyn_OpenFile(wchar_t *wcp_path, const wchar_t *wcp_mode)
+{
+#ifdef WIN32
+	return(_wfopen(wcp_path, wcp_mode));
+#else
+	char path[PT_MAX_PATH_STRLEN];
+	char mode[8];
+
+	if( wcstombs(path, wcp_path, PT_MAX_PATH_STRLEN) >= PT_MAX_PATH_STRLEN )
+		return(NULL);
+	if( wcstombs(mode, wcp_mode, 8) >= 8 )
+		return(NULL);
+
+	return(fopen(path, mode));
+#endif
+}
+
+/*
+ * FUNCTION: BinauralSyn_ReplaceFile()
+ * DESCRIPTION:
+ *  Moves a completely written temporary file over the passed file.
+ */
+static int BinauralSyn_ReplaceFile(wchar_t *wcp_temp_path, wchar_t *wcp_path)
+{
+#ifdef WIN32
+	if( !MoveFileExW(wcp_temp_path, wcp_path, MOVEFILE_REPLACE_EXISTING) )
+		return(NOT_OKAY);
+#else
+	char temp_path[PT_MAX_PATH_STRLEN];
+	char path[PT_MAX_PATH_STRLEN];
+
+	if( wcstombs(temp_path, wcp_temp_path, PT_MAX_PATH_STRLEN) >= PT_MAX_PATH_STRLEN )
+		return(NOT_OKAY);
+	if( wcstombs(path, wcp_path, PT_MAX_PATH_STRLEN) >= PT_MAX_PATH_STRLEN )
+		return(NOT_OKAY);
+	if( rename(temp_path, path) != 0 )
+		return(NOT_OKAY);
+#endif
+
+	return(OKAY);
+}
+
+/*
+ * FUNCTION: BinauralSyn_ReadFile()
+ * DESCRIPTION:
+ *  Reads a whole file into a buffer allocated with malloc(), which the caller frees.
+ */
+static int BinauralSyn_ReadFile(wchar_t *wcp_path, unsigned char **ucpp_bytes, long *lp_num_bytes)
+{
+	FILE *fp;
+	long num_bytes;
+	unsigned char *bytes;
+
+	*ucpp_bytes = NULL;
+	*lp_num_bytes = 0;
+
+	fp = BinauralSyn_OpenFile(wcp_path, L"rb");
+	if( fp == NULL )
+		return(NOT_OKAY);
+
+	num_bytes = -1;
+	if( fseek(fp, 0, SEEK_END) == 0 )
+		num_bytes = ftell(fp);
+
+	if( (num_bytes <= 0) || (num_bytes > BINAURAL_SYN_HRIR_MAX_FILE_BYTES) || (fseek(fp, 0, SEEK_SET) != 0) )
+	{
+		fclose(fp);
+		return(NOT_OKAY);
+	}
+
+	bytes = (unsigned char *)malloc(num_bytes);
+	if( bytes == NULL )
+	{
+		fclose(fp);
+		return(NOT_OKAY);
+	}
+
+	if( fread(bytes, 1, num_bytes, fp) != (size_t)num_bytes )
+	{
+		free(bytes);
+		fclose(fp);
+		return(NOT_OKAY);
+	}
+
+	fclose(fp);
+
+	*ucpp_bytes = bytes;
+	*lp_num_bytes = num_bytes;
+
+	return(OKAY);
+}
+
+/*
+ * FUNCTION: BinauralSyn_GetLittleEndian()
+ * DESCRIPTION:
+ *  Reads a little endian unsigned value of 1 to 4 bytes.
+ */
+static unsigned long BinauralSyn_GetLittleEndian(const unsigned char *ucp_bytes, int i_num_bytes)
+{
+	unsigned long value = 0;
+	int i;
+
+	for(i=i_num_bytes-1; i>=0; i--)
+		value = (value << 8) | (unsigned long)ucp_bytes[i];
+
+	return(value);
+}
+
+/*
+ * FUNCTION: BinauralSyn_ParseWav()
+ * DESCRIPTION:
+ *  Finds the format and audio data of a wav file held in memory. Supports 16, 24 and 32 bit pcm
+ *  and 32 bit float, including the extensible format.
+ */
+static int BinauralSyn_ParseWav(unsigned char *ucp_bytes, long l_num_bytes, struct BinauralSynWavType *sp_wav)
+{
+	long pos;
+	long chunk_bytes;
+	int have_format = IS_FALSE;
+
+	if( (l_num_bytes < 12) || (memcmp(ucp_bytes, "RIFF", 4) != 0) || (memcmp(ucp_bytes + 8, "WAVE", 4) != 0) )
+		return(NOT_OKAY);
+
+	pos = 12;
+	while( (pos + 8) <= l_num_bytes )
+	{
+		chunk_bytes = (long)BinauralSyn_GetLittleEndian(ucp_bytes + pos + 4, 4);
+		if( (chunk_bytes < 0) || (chunk_bytes > (l_num_bytes - pos - 8)) )
+			chunk_bytes = l_num_bytes - pos - 8;	// Truncated file, use what is there
+
+		if( memcmp(ucp_bytes + pos, "fmt ", 4) == 0 )
+		{
+			if( chunk_bytes < 16 )
+				return(NOT_OKAY);
+
+			sp_wav->format = (int)BinauralSyn_GetLittleEndian(ucp_bytes + pos + 8, 2);
+			sp_wav->num_channels = (int)BinauralSyn_GetLittleEndian(ucp_bytes + pos + 10, 2);
+			sp_wav->samp_freq = (int)BinauralSyn_GetLittleEndian(ucp_bytes + pos + 12, 4);
+			sp_wav->block_align = (int)BinauralSyn_GetLittleEndian(ucp_bytes + pos + 20, 2);
+			sp_wav->bits_per_sample = (int)BinauralSyn_GetLittleEndian(ucp_bytes + pos + 22, 2);
+
+			// Extensible format, the sub format guid starts with the format code
+			if( (sp_wav->format == BINAURAL_SYN_WAVE_FORMAT_EXTENSIBLE) && (chunk_bytes >= 40) )
+				sp_wav->format = (int)BinauralSyn_GetLittleEndian(ucp_bytes + pos + 32, 2);
+
+			have_format = IS_TRUE;
+		}
+		else if( memcmp(ucp_bytes + pos, "data", 4) == 0 )
+		{
+			if( !have_format )
+				return(NOT_OKAY);
+
+			if( (sp_wav->num_channels <= 0) || (sp_wav->block_align != sp_wav->num_channels * (sp_wav->bits_per_sample / 8)) )
+				return(NOT_OKAY);
+
+			if( sp_wav->format == BINAURAL_SYN_WAVE_FORMAT_PCM )
+			{
+				if( (sp_wav->bits_per_sample != 16) && (sp_wav->bits_per_sample != 24) && (sp_wav->bits_per_sample != 32) )
+					return(NOT_OKAY);
+			}
+			else if( sp_wav->format == BINAURAL_SYN_WAVE_FORMAT_FLOAT )
+			{
+				if( sp_wav->bits_per_sample != 32 )
+					return(NOT_OKAY);
+			}
+			else
+				return(NOT_OKAY);
+
+			sp_wav->data = ucp_bytes + pos + 8;
+			sp_wav->num_frames = (int)(chunk_bytes / sp_wav->block_align);
+
+			return(OKAY);
+		}
+
+		// Chunks are padded to an even size
+		pos += 8 + chunk_bytes + (chunk_bytes & 1);
+	}
+
+	return(NOT_OKAY);
+}
+
+/*
+ * FUNCTION: BinauralSyn_GetWavSample()
+ * DESCRIPTION:
+ *  Returns one sample of a parsed wav file scaled to +/- 1.0.
+ */
+static realtype BinauralSyn_GetWavSample(struct BinauralSynWavType *sp_wav, int i_frame, int i_channel)
+{
+	unsigned char *bytes = sp_wav->data + i_frame * sp_wav->block_align + i_channel * (sp_wav->bits_per_sample / 8);
+	unsigned long value;
+	float float_value;
+
+	switch( sp_wav->bits_per_sample )
+	{
+	case 16 :
+		value = BinauralSyn_GetLittleEndian(bytes, 2);
+		return((realtype)((short)value) * (realtype)(1.0 / 32768.0));
+
+	case 24 :
+		value = BinauralSyn_GetLittleEndian(bytes, 3);
+		if( value & 0x800000 )
+			return((realtype)((long)value - 0x1000000L) * (realtype)(1.0 / 8388608.0));
+		return((realtype)value * (realtype)(1.0 / 8388608.0));
+
+	default :
+		value = BinauralSyn_GetLittleEndian(bytes, 4);
+		if( sp_wav->format == BINAURAL_SYN_WAVE_FORMAT_FLOAT )
+		{
+			unsigned int bits = (unsigned int)value;
+			memcpy(&float_value, &bits, sizeof(float_value));
+			return((realtype)float_value);
+		}
+		return((realtype)((double)(int)(unsigned int)value * (1.0 / 2147483648.0)));
+	}
+}
+
+/*
+ * FUNCTION: BinauralSyn_ReadHrirFile()
+ * DESCRIPTION:
+ *  Reads near and far responses from a wav file into the passed speaker pairs of a source, and
+ *  adds the file contents to the hash. i_first_channel is the near channel of the first pair,
+ *  pairs follow in order. Responses longer than the max coeff count are truncated.
+ */
+static int BinauralSyn_ReadHrirFile(wchar_t *wcp_file, struct BinauralSynImpulseType *sp_source, int i_first_pair, int i_num_pairs,
+												int i_num_channels, unsigned long long *ullp_hash)
+{
+	unsigned char *bytes;
+	long num_bytes;
+	struct BinauralSynWavType wav;
+	int q, i, ch;
+	int num_coeffs;
+
+	if( BinauralSyn_ReadFile(wcp_file, &bytes, &num_bytes) != OKAY )
+		return(NOT_OKAY);
+
+	memset(&wav, 0, sizeof(wav));
+	if( (BinauralSyn_ParseWav(bytes, num_bytes, &wav) != OKAY) || (wav.num_frames <= 0) ||
+		 (wav.samp_freq < BINAURAL_SYN_MIN_SAMP_FREQ) || (wav.samp_freq > BINAURAL_SYN_MAX_SAMP_FREQ) )
+	{
+		free(bytes);
+		return(NOT_OKAY);
+	}
+
+	// A 2 channel file can be used for any number of pairs, otherwise the channels must match
+	if( (wav.num_channels != i_num_channels) && (wav.num_channels != 2) )
+	{
+		free(bytes);
+		return(NOT_OKAY);
+	}
+
+	// Position files must all have the same rate
+	if( (sp_source->samp_freq != 0) && (sp_source->samp_freq != wav.samp_freq) )
+	{
+		free(bytes);
+		return(NOT_OKAY);
+	}
+
+	num_coeffs = wav.num_frames;
+	if( num_coeffs > BINAURAL_SYN_MAX_NUM_COEFFS )
+		num_coeffs = BINAURAL_SYN_MAX_NUM_COEFFS;
+
+	for(q=i_first_pair; q<(i_first_pair + i_num_pairs); q++)
+	{
+		ch = 0;
+		if( wav.num_channels != 2 )
+			ch = 2 * (q - i_first_pair);
+
+		for(i=0; i<BINAURAL_SYN_MAX_NUM_COEFFS; i++)
+		{
+			sp_source->near_coeffs[q][i] = (realtype)0.0;
+			sp_source->far_coeffs[q][i] = (realtype)0.0;
+		}
+		for(i=0; i<num_coeffs; i++)
+		{
+			sp_source->near_coeffs[q][i] = BinauralSyn_GetWavSample(&wav, i, ch);
+			sp_source->far_coeffs[q][i] = BinauralSyn_GetWavSample(&wav, i, ch + 1);
+		}
+	}
+
+	// Pairs from files of different lengths are zero padded to the longest
+	if( num_coeffs > sp_source->num_coeffs )
+		sp_source->num_coeffs = num_coeffs;
+	sp_source->samp_freq = wav.samp_freq;
+
+	*ullp_hash = BinauralSyn_Hash(*ullp_hash, bytes, num_bytes);
+
+	free(bytes);
+
+	return(OKAY);
+}
+
+/*
+ * FUNCTION: BinauralSyn_GetCachePath()
+ * DESCRIPTION:
+ *  Makes the hrir cache file path for a bank hash and rate.
+ */
+static int BinauralSyn_GetCachePath(struct BinauralSynHdlType *cast_handle, unsigned long long ull_hash, int i_samp_freq,
+												const wchar_t *wcp_extension, wchar_t *wcp_path)
+{
+	int len;
+
+	len = swprintf(wcp_path, PT_MAX_PATH_STRLEN, L"%ls%lshrir_%016llx_%d%ls", cast_handle->cache_folder, BINAURAL_SYN_PATH_SEPARATOR,
+						ull_hash, i_samp_freq, wcp_extension);
+	if( (len <= 0) || (len >= PT_MAX_PATH_STRLEN) )
+		return(NOT_OKAY);
+
+	return(OKAY);
+}
+
+/*
+ * FUNCTION: BinauralSyn_CheckCacheHeader()
+ * DESCRIPTION:
+ *  Checks a cache file header and set against the bank hash and rate they are read for.
+ */
+static int BinauralSyn_CheckCacheHeader(struct BinauralSynCacheHeaderType *sp_header, struct BinauralSynCoeffSetType *sp_set,
+													 unsigned long long ull_hash, int i_samp_freq)
+{
+	if( (sp_header->magic != BINAURAL_SYN_CACHE_MAGIC) || (sp_header->version != BINAURAL_SYN_CACHE_VERSION) ||
+		 (sp_header->hash != ull_hash) || (sp_header->samp_freq != i_samp_freq) ||
+		 (sp_header->set_bytes != (int)sizeof(struct BinauralSynCoeffSetType)) || (sp_header->block_size != BINAURAL_SYN_BLOCK_SIZE) )
+		return(NOT_OKAY);
+
+	if( BinauralSyn_Hash(BINAURAL_SYN_FNV_OFFSET, (const unsigned char *)sp_set, sizeof(struct BinauralSynCoeffSetType)) != sp_header->checksum )
+		return(NOT_OKAY);
+
+	if( (sp_set->impulse.samp_freq != i_samp_freq) || (sp_set->impulse.num_coeffs < 1) ||
+		 (sp_set->impulse.num_coeffs > BINAURAL_SYN_MAX_NUM_COEFFS) ||
+		 (sp_set->num_partitions < 0) || (sp_set->num_partitions > BINAURAL_SYN_MAX_PARTITIONS) )
+		return(NOT_OKAY);
+
+	return(OKAY);
+}
+
+/*
+ * FUNCTION: BinauralSyn_ReadCachedSet()
+ * DESCRIPTION:
+ *  Reads a coeff set from the hrir cache. Windows maps the file rather than reading it.
+ *  Returns NOT_OKAY if the set is not cached or the cached file does not match.
+ */
+static int BinauralSyn_ReadCachedSet(struct BinauralSynHdlType *cast_handle, unsigned long long ull_hash, int i_samp_freq,
+												 struct BinauralSynCoeffSetType *sp_set)
+{
+	wchar_t path[PT_MAX_PATH_STRLEN];
+	struct BinauralSynCacheHeaderType header;
+	size_t file_bytes = sizeof(struct BinauralSynCacheHeaderType) + sizeof(struct BinauralSynCoeffSetType);
+
+	if( BinauralSyn_GetCachePath(cast_handle, ull_hash, i_samp_freq, L".bin", path) != OKAY )
+		return(NOT_OKAY);
+
+#ifdef WIN32
+	HANDLE file;
+	HANDLE mapping;
+	LARGE_INTEGER size;
+	unsigned char *view;
+
+	file = CreateFileW(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if( file == INVALID_HANDLE_VALUE )
+		return(NOT_OKAY);
+
+	if( !GetFileSizeEx(file, &size) || (size.QuadPart != (LONGLONG)file_bytes) )
+	{
+		CloseHandle(file);
+		return(NOT_OKAY);
+	}
+
+	mapping = CreateFileMappingW(file, NULL, PAGE_READONLY, 0, 0, NULL);
+	CloseHandle(file);
+	if( mapping == NULL )
+		return(NOT_OKAY);
+
+	view = (unsigned char *)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, file_bytes);
+	CloseHandle(mapping);
+	if( view == NULL )
+		return(NOT_OKAY);
+
+	memcpy(&header, view, sizeof(header));
+	memcpy(sp_set, view + sizeof(header), sizeof(struct BinauralSynCoeffSetType));
+	UnmapViewOfFile(view);
+#else
+	FILE *fp;
+	size_t num_read;
+
+	fp = BinauralSyn_OpenFile(path, L"rb");
+	if( fp == NULL )
+		return(NOT_OKAY);
+
+	num_read = fread(&header, 1, sizeof(header), fp);
+	num_read += fread(sp_set, 1, sizeof(struct BinauralSynCoeffSetType), fp);
+	fclose(fp);
+
+	if( num_read != file_bytes )
+		return(NOT_OKAY);
+#endif
+
+	return(BinauralSyn_CheckCacheHeader(&header, sp_set, ull_hash, i_samp_freq));
+}
+
+/*
+ * FUNCTION: BinauralSyn_WriteCachedSet()
+ * DESCRIPTION:
+ *  Writes a coeff set to the hrir cache. The file is written under a temporary name and then
+ *  renamed, so a partly written file is never read back.
+ */
+static int BinauralSyn_WriteCachedSet(struct BinauralSynHdlType *cast_handle, unsigned long long ull_hash, struct BinauralSynCoeffSetType *sp_set)
+{
+	wchar_t path[PT_MAX_PATH_STRLEN];
+	wchar_t temp_path[PT_MAX_PATH_STRLEN];
+	struct BinauralSynCacheHeaderType header;
+	FILE *fp;
+	size_t num_written;
+
+	if( BinauralSyn_GetCachePath(cast_handle, ull_hash, sp_set->impulse.samp_freq, L".bin", path) != OKAY )
+		return(NOT_OKAY);
+	if( BinauralSyn_GetCachePath(cast_handle, ull_hash, sp_set->impulse.samp_freq, L".tmp", temp_path) != OKAY )
+		return(NOT_OKAY);
+
+	memset(&header, 0, sizeof(header));
+	header.magic = BINAURAL_SYN_CACHE_MAGIC;
+	header.version = BINAURAL_SYN_CACHE_VERSION;
+	header.hash = ull_hash;
+	header.samp_freq = sp_set->impulse.samp_freq;
+	header.set_bytes = (int)sizeof(struct BinauralSynCoeffSetType);
+	header.block_size = BINAURAL_SYN_BLOCK_SIZE;
+	header.checksum = BinauralSyn_Hash(BINAURAL_SYN_FNV_OFFSET, (const unsigned char *)sp_set, sizeof(struct BinauralSynCoeffSetType));
+
+	fp = BinauralSyn_OpenFile(temp_path, L"wb");
+	if( fp == NULL )
+		return(NOT_OKAY);
+
+	num_written = fwrite(&header, 1, sizeof(header), fp);
+	num_written += fwrite(sp_set, 1, sizeof(struct BinauralSynCoeffSetType), fp);
+	if( (fclose(fp) != 0) || (num_written != sizeof(header) + sizeof(struct BinauralSynCoeffSetType)) )
+		return(NOT_OKAY);
+
+	return(BinauralSyn_ReplaceFile(temp_path, path));
+}
+
+/*
+ * FUNCTION: BinauralSyn_BuildLoadedBank()
+ * DESCRIPTION:
+ *  Fills in the standard rate coeff sets of a bank whose source has been read, from the hrir cache
+ *  when they are there, otherwise by resampling and transforming the source and caching the result.
+ *  Called with bank_lock held.
+ */
+static int BinauralSyn_BuildLoadedBank(struct BinauralSynHdlType *cast_handle, struct BinauralSynBankType *sp_bank)
+{
+	int i;
+	int samp_freq;
+	int use_cache = (cast_handle->cache_folder[0] != L'\0');
+	PT_HANDLE *fft_hdl;
+	struct BinauralSynCoeffSetType *set;
+
+	// The audio thread uses the handle fft, so sets are built with their own
+	if( RealFftNew(&fft_hdl, BINAURAL_SYN_FFT_SIZE) != OKAY )
+		return(NOT_OKAY);
+
+	for(i=0; i<BINAURAL_SYN_NUM_STANDARD_RATES; i++)
+	{
+		samp_freq = BinauralSyn_StandardRate(i);
+		set = &(sp_bank->coeff_sets[i]);
+
+		if( use_cache && (BinauralSyn_ReadCachedSet(cast_handle, sp_bank->hash, samp_freq, set) == OKAY) )
+			continue;
+
+		BinauralSyn_BuildCoeffSet(fft_hdl, sp_bank, set, samp_freq);
+
+		// Not being able to write the cache only means the set is built again next time
+		if( use_cache )
+			BinauralSyn_WriteCachedSet(cast_handle, sp_bank->hash, set);
+	}
+
+	BinauralSyn_AddCoeffSet(fft_hdl, sp_bank, cast_handle->prepared_samp_freq);
+
+	RealFftFreeUp(&fft_hdl);
+
+	return(OKAY);
+}
+
+/*
+ * FUNCTION: BinauralSyn_PublishBank()
+ * DESCRIPTION:
+ *  Hands a new bank to the audio thread, which switches to it at the start of its next buffer.
+ *  Frees the bank the audio thread last replaced and any bank it has not taken yet. Called with
+ *  bank_lock held by the loads and the rate worker, so published_bank stays allocated while it is copied.
+ */
+int BinauralSyn_PublishBank(struct BinauralSynHdlType *cast_handle, struct BinauralSynBankType *sp_bank)
+{
+	struct BinauralSynBankType *old_bank;
+
+	old_bank = cast_handle->retired_bank.exchange(NULL, std::memory_order_acq_rel);
+	if( old_bank != NULL )
+		free(old_bank);
+
+	old_bank = cast_handle->pending_bank.exchange(sp_bank, std::memory_order_acq_rel);
+	if( old_bank != NULL )
+		free(old_bank);
+
+	cast_handle->published_bank = sp_bank;
+
+	return(OKAY);
+}
+
+/*
+ * FUNCTION: BinauralSyn_FreeBanks()
+ * DESCRIPTION:
+ *  Frees the current, pending and retired banks of a handle that is no longer processing.
+ */
+void BinauralSyn_FreeBanks(struct BinauralSynHdlType *cast_handle)
+{
+	struct BinauralSynBankType *old_bank;
+
+	old_bank = cast_handle->pending_bank.exchange(NULL);
+	if( old_bank != NULL )
+		free(old_bank);
+
+	old_bank = cast_handle->retired_bank.exchange(NULL);
+	if( old_bank != NULL )
+		free(old_bank);
+
+	if( cast_handle->bank != NULL )
+		free(cast_handle->bank);
+	cast_handle->bank = NULL;
+	cast_handle->published_bank = NULL;
+}
+
+/*
+ * FUNCTION: BinauralSyn_LoadFiles()
+ * DESCRIPTION:
+ *  Reads an hrir set from one file per listed group of speaker pairs, builds its bank and hands it
+ *  to the audio thread. Files for pairs without one are NULL and reuse the front pair responses.
+ */
+static int BinauralSyn_LoadFiles(struct BinauralSynHdlType *cast_handle, wchar_t **wcpp_files, int *ip_first_pair, int *ip_num_pairs,
+											int i_num_files, int i_num_channels)
+{
+	int f, q, i;
+	unsigned long long hash = BINAURAL_SYN_FNV_OFFSET;
+	struct BinauralSynBankType *bank;
+	struct BinauralSynImpulseType *source;
+
+	bank = (struct BinauralSynBankType *)calloc(1, sizeof(struct BinauralSynBankType));
+	if( bank == NULL )
+		return(NOT_OKAY);
+
+	bank->num_sources = 1;
+	source = &(bank->sources[0]);
+
+	for(f=0; f<i_num_files; f++)
+	{
+		if( (wcpp_files[f] == NULL) || (wcpp_files[f][0] == L'\0') )
+		{
+			// Pairs without a file use the front responses
+			for(q=ip_first_pair[f]; q<(ip_first_pair[f] + ip_num_pairs[f]); q++)
+				for(i=0; i<BINAURAL_SYN_MAX_NUM_COEFFS; i++)
+				{
+					source->near_coeffs[q][i] = source->near_coeffs[BINAURAL_SYN_FRONT_PAIR][i];
+					source->far_coeffs[q][i] = source->far_coeffs[BINAURAL_SYN_FRONT_PAIR][i];
+				}
+
+			hash = BinauralSyn_Hash(hash, (const unsigned char *)&f, sizeof(f));
+			continue;
+		}
+
+		if( BinauralSyn_ReadHrirFile(wcpp_files[f], source, ip_first_pair[f], ip_num_pairs[f], i_num_channels, &hash) != OKAY )
+		{
+			free(bank);
+			return(NOT_OKAY);
+		}
+	}
+
+	// 0 is kept for the built in coeffs
+	bank->hash = hash;
+	if( bank->hash == 0 )
+		bank->hash = 1;
+
+	std::lock_guard<std::mutex> lock(cast_handle->rate_worker->bank_lock);
+
+	if( BinauralSyn_BuildLoadedBank(cast_handle, bank) != OKAY )
+	{
+		free(bank);
+		return(NOT_OKAY);
+	}
+
+	return(BinauralSyn_PublishBank(cast_handle, bank));
+}
+
+/*
+ * FUNCTION: BinauralSynSetCacheFolder()
+ * DESCRIPTION:
+ *  Sets the folder the coeff sets of loaded hrir files are cached in, which must exist.
+ *  NULL or an empty string turns the cache off.
+ */
+int PT_DECLSPEC BinauralSynSetCacheFolder(PT_HANDLE *hp_BinauralSyn, wchar_t *wcp_folder)
+{
+	struct BinauralSynHdlType *cast_handle;
+
+	cast_handle = (struct BinauralSynHdlType *)(hp_BinauralSyn);
+
+	if (cast_handle == NULL)
+		return(NOT_OKAY);
+
+	cast_handle->cache_folder[0] = L'\0';
+
+	if( wcp_folder == NULL )
+		return(OKAY);
+
+	if( wcslen(wcp_folder) >= PT_MAX_PATH_STRLEN - 32 )
+		return(NOT_OKAY);
+
+	wcscpy(cast_handle->cache_folder, wcp_folder);
+
+	return(OKAY);
+}
+
+/*
+ * FUNCTION: BinauralSynLoadHrirFile()
+ * DESCRIPTION:
+ *  Replaces the coeffs with an hrir set read from a wav file. A 6 channel file has the near and far
+ *  responses of the front, rear and side speaker pairs in that order, a 2 channel file has one near
+ *  and far pair that is used for every speaker pair. The set takes effect at the start of the next
+ *  processed buffer. Must not be called from the audio thread.
+ */
+int PT_DECLSPEC BinauralSynLoadHrirFile(PT_HANDLE *hp_BinauralSyn, wchar_t *wcp_file)
+{
+	struct BinauralSynHdlType *cast_handle;
+	int first_pair = BINAURAL_SYN_FRONT_PAIR;
+	int num_pairs = BINAURAL_SYN_NUM_PAIRS;
+
+	cast_handle = (struct BinauralSynHdlType *)(hp_BinauralSyn);
+
+	if (cast_handle == NULL)
+		return(NOT_OKAY);
+
+	if( wcp_file == NULL )
+		return(NOT_OKAY);
+
+	return(BinauralSyn_LoadFiles(cast_handle, &wcp_file, &first_pair, &num_pairs, 1, 2 * BINAURAL_SYN_NUM_PAIRS));
+}
+
+/*
+ * FUNCTION: BinauralSynLoadHrirPositionFiles()
+ * DESCRIPTION:
+ *  Replaces the coeffs with an hrir set read from one 2 channel near/far wav file per speaker pair.
+ *  The files must have the same rate. The rear and side files can be NULL, those pairs then use
+ *  the front responses. Must not be called from the audio thread.
+ */
+int PT_DECLSPEC BinauralSynLoadHrirPositionFiles(PT_HANDLE *hp_BinauralSyn, wchar_t *wcp_front_file, wchar_t *wcp_rear_file, wchar_t *wcp_side_file)
+{
+	struct BinauralSynHdlType *cast_handle;
+	wchar_t *files[BINAURAL_SYN_NUM_PAIRS];
+	int first_pair[BINAURAL_SYN_NUM_PAIRS] = { BINAURAL_SYN_FRONT_PAIR, BINAURAL_SYN_REAR_PAIR, BINAURAL_SYN_SIDE_PAIR };
+	int num_pairs[BINAURAL_SYN_NUM_PAIRS] = { 1, 1, 1 };
+
+	cast_handle = (struct BinauralSynHdlType *)(hp_BinauralSyn);
+
+	if (cast_handle == NULL)
+		return(NOT_OKAY);
+
+	if( wcp_front_file == NULL )
+		return(NOT_OKAY);
+
+	files[BINAURAL_SYN_FRONT_PAIR] = wcp_front_file;
+	files[BINAURAL_SYN_REAR_PAIR] = wcp_rear_file;
+	files[BINAURAL_SYN_SIDE_PAIR] = wcp_side_file;
+
+	return(BinauralSyn_LoadFiles(cast_handle, files, first_pair, num_pairs, BINAURAL_SYN_NUM_PAIRS, 2));
+}
+
+/*
+ * FUNCTION: BinauralSynUseBuiltInHrirs()
+ * DESCRIPTION:
+ *  Goes back to the built in coeffs after an hrir set has been loaded.
+ *  Must not be called from the audio thread.
+ */
+int PT_DECLSPEC BinauralSynUseBuiltInHrirs(PT_HANDLE *hp_BinauralSyn)
+{
+	struct BinauralSynHdlType *cast_handle;
+
+	cast_handle = (struct BinauralSynHdlType *)(hp_BinauralSyn);
+
+	if (cast_handle == NULL)
+		return(NOT_OKAY);
+
+	std::lock_guard<std::mutex> lock(cast_handle->rate_worker->bank_lock);
+
+	return(BinauralSyn_PublishBuiltInBank(cast_handle));
+}
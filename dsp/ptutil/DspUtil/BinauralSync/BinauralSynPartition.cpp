@@ -0,0 +1,321 @@
+/*
+FxSound
+Copyright (C) 2025  FxSound LLC
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <stdlib.h>
+#include <string.h>
+
+#include "codedefs.h"
+#include "RealFft.h"
+#include "BinauralSyn.h"
+#include "u_BinauralSyn.h"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define BINAURAL_SYN_SIMD_X86
+#include <xmmintrin.h>
+#endif
+
+/*
+ * FUNCTION: BinauralSyn_Dot()
+ * DESCRIPTION:
+ *  Dot product of BINAURAL_SYN_BLOCK_SIZE samples with a time reversed head block.
+ */
+static realtype BinauralSyn_Dot(realtype *rp_samples, realtype *rp_head)
+{
+	int i;
+
+#ifdef BINAURAL_SYN_SIMD_X86
+	__m128 acc0 = _mm_setzero_ps();
+	__m128 acc1 = _mm_setzero_ps();
+	realtype lanes[4];
+
+	for(i=0; i<BINAURAL_SYN_BLOCK_SIZE; i+=8)
+	{
+		acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(rp_samples + i), _mm_loadu_ps(rp_head + i)));
+		acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(rp_samples + i + 4), _mm_loadu_ps(rp_head + i + 4)));
+	}
+	_mm_storeu_ps(lanes, _mm_add_ps(acc0, acc1));
+
+	return((lanes[0] + lanes[1]) + (lanes[2] + lanes[3]));
+#else
+	realtype sum = (realtype)0.0;
+
+	for(i=0; i<BINAURAL_SYN_BLOCK_SIZE; i++)
+		sum += rp_samples[i] * rp_head[i];
+
+	return(sum);
+#endif
+}
+
+/*
+ * FUNCTION: BinauralSyn_BuildPartitions()
+ * DESCRIPTION:
+ *  Builds the sum and difference head blocks and tail partition spectra of every speaker pair
+ *  from the impulse responses of the passed coeff set. The number of partitions follows the coeff
+ *  count of the set. rp_buf is BINAURAL_SYN_FFT_SIZE samples of work space.
+ */
+void BinauralSyn_BuildPartitions(PT_HANDLE *hp_fft, struct BinauralSynCoeffSetType *sp_set, realtype *rp_buf)
+{
+	int q, p, i, tap;
+	int num_coeffs;
+	realtype *near_coeffs;
+	realtype *far_coeffs;
+	realtype scale = (realtype)1.0 / (realtype)BINAURAL_SYN_FFT_SIZE;
+	struct BinauralSynFilterType *filter;
+
+	num_coeffs = sp_set->impulse.num_coeffs;
+
+	// Taps after the direct head block are split into fft partitions. Changing the count
+	// changes the input spectrum history size, so sets are only switched along with a reset.
+	sp_set->num_partitions = 0;
+	if( num_coeffs > BINAURAL_SYN_BLOCK_SIZE )
+		sp_set->num_partitions = (num_coeffs - 1) / BINAURAL_SYN_BLOCK_SIZE;
+
+	for(q=0; q<BINAURAL_SYN_NUM_PAIRS; q++)
+	{
+		filter = &(sp_set->filters[q]);
+		near_coeffs = sp_set->impulse.near_coeffs[q];
+		far_coeffs = sp_set->impulse.far_coeffs[q];
+
+		for(i=0; i<BINAURAL_SYN_BLOCK_SIZE; i++)
+		{
+			filter->sum_head[BINAURAL_SYN_BLOCK_SIZE - 1 - i] = (realtype)0.0;
+			filter->diff_head[BINAURAL_SYN_BLOCK_SIZE - 1 - i] = (realtype)0.0;
+
+			if( i < num_coeffs )
+			{
+				filter->sum_head[BINAURAL_SYN_BLOCK_SIZE - 1 - i] = (realtype)0.5 * (near_coeffs[i] + far_coeffs[i]);
+				filter->diff_head[BINAURAL_SYN_BLOCK_SIZE - 1 - i] = (realtype)0.5 * (near_coeffs[i] - far_coeffs[i]);
+			}
+		}
+
+		for(p=0; p<sp_set->num_partitions; p++)
+		{
+			// Partition taps go in the first half, the second half stays zero
+			for(i=0; i<BINAURAL_SYN_FFT_SIZE; i++)
+				rp_buf[i] = (realtype)0.0;
+			for(i=0; i<BINAURAL_SYN_BLOCK_SIZE; i++)
+			{
+				tap = (p + 1) * BINAURAL_SYN_BLOCK_SIZE + i;
+				if( tap < num_coeffs )
+					rp_buf[i] = (realtype)0.5 * scale * (near_coeffs[tap] + far_coeffs[tap]);
+			}
+			RealFftForward(hp_fft, rp_buf, filter->sum_re[p], filter->sum_im[p]);
+
+			for(i=0; i<BINAURAL_SYN_BLOCK_SIZE; i++)
+			{
+				tap = (p + 1) * BINAURAL_SYN_BLOCK_SIZE + i;
+				if( tap < num_coeffs )
+					rp_buf[i] = (realtype)0.5 * scale * (near_coeffs[tap] - far_coeffs[tap]);
+			}
+			RealFftForward(hp_fft, rp_buf, filter->diff_re[p], filter->diff_im[p]);
+		}
+	}
+}
+
+/*
+ * FUNCTION: BinauralSyn_ResetPair()
+ * DESCRIPTION:
+ *  Zeros the input history of one speaker pair.
+ */
+static void BinauralSyn_ResetPair(struct BinauralSynPairType *sp_pair)
+{
+	memset(sp_pair->sum_in, 0, sizeof(sp_pair->sum_in));
+	memset(sp_pair->diff_in, 0, sizeof(sp_pair->diff_in));
+	memset(sp_pair->sum_fdl_re, 0, sizeof(sp_pair->sum_fdl_re));
+	memset(sp_pair->sum_fdl_im, 0, sizeof(sp_pair->sum_fdl_im));
+	memset(sp_pair->diff_fdl_re, 0, sizeof(sp_pair->diff_fdl_re));
+	memset(sp_pair->diff_fdl_im, 0, sizeof(sp_pair->diff_fdl_im));
+}
+
+/*
+ * FUNCTION: BinauralSyn_ResetPartitions()
+ * DESCRIPTION:
+ *  Zeros the partitioned convolution input history and pending tail output.
+ */
+void BinauralSyn_ResetPartitions(struct BinauralSynHdlType *cast_handle)
+{
+	int q;
+
+	for(q=0; q<BINAURAL_SYN_NUM_PAIRS; q++)
+		BinauralSyn_ResetPair(&(cast_handle->pairs[q]));
+
+	memset(cast_handle->sum_tail, 0, sizeof(cast_handle->sum_tail));
+	memset(cast_handle->diff_tail, 0, sizeof(cast_handle->diff_tail));
+
+	cast_handle->block_pos = 0;
+	cast_handle->fdl_index = 0;
+}
+
+/*
+ * FUNCTION: BinauralSyn_RunTail()
+ * DESCRIPTION:
+ *  Called when an input block is complete. Transforms it, then runs the tail partitions over
+ *  the input spectra to get the tail output of the next block. The tail filters start one block
+ *  in, so the next block only needs the inputs that are already here.
+ */
+static void BinauralSyn_RunTail(struct BinauralSynHdlType *cast_handle, int i_num_pairs)
+{
+	int q, p, slot;
+	struct BinauralSynCoeffSetType *coeffs = &(cast_handle->bank->coeff_sets[cast_handle->coeff_set_index]);
+	int num_partitions = coeffs->num_partitions;
+	PT_HANDLE *fft_hdl = cast_handle->fft_hdl;
+	struct BinauralSynPairType *pair;
+	struct BinauralSynFilterType *filter;
+
+	if( num_partitions > 0 )
+	{
+		cast_handle->fdl_index++;
+		if( cast_handle->fdl_index >= num_partitions )
+			cast_handle->fdl_index = 0;
+
+		for(q=0; q<i_num_pairs; q++)
+		{
+			pair = &(cast_handle->pairs[q]);
+			RealFftForward(fft_hdl, pair->sum_in, pair->sum_fdl_re[cast_handle->fdl_index], pair->sum_fdl_im[cast_handle->fdl_index]);
+			RealFftForward(fft_hdl, pair->diff_in, pair->diff_fdl_re[cast_handle->fdl_index], pair->diff_fdl_im[cast_handle->fdl_index]);
+		}
+
+		// Sum of all pairs, each input block spectrum times the partition that is its age in blocks
+		memset(cast_handle->acc_re, 0, sizeof(cast_handle->acc_re));
+		memset(cast_handle->acc_im, 0, sizeof(cast_handle->acc_im));
+		for(q=0; q<i_num_pairs; q++)
+		{
+			pair = &(cast_handle->pairs[q]);
+			filter = &(coeffs->filters[q]);
+			slot = cast_handle->fdl_index;
+			for(p=0; p<num_partitions; p++)
+			{
+				RealFftMultiplyAccumulate_NoHandle(pair->sum_fdl_re[slot], pair->sum_fdl_im[slot], filter->sum_re[p], filter->sum_im[p],
+					cast_handle->acc_re, cast_handle->acc_im, BINAURAL_SYN_NUM_BINS);
+				if( --slot < 0 )
+					slot = num_partitions - 1;
+			}
+		}
+		RealFftInverse(fft_hdl, cast_handle->acc_re, cast_handle->acc_im, cast_handle->fft_buf);
+		memcpy(cast_handle->sum_tail, cast_handle->fft_buf + BINAURAL_SYN_BLOCK_SIZE, sizeof(cast_handle->sum_tail));
+
+		memset(cast_handle->acc_re, 0, sizeof(cast_handle->acc_re));
+		memset(cast_handle->acc_im, 0, sizeof(cast_handle->acc_im));
+		for(q=0; q<i_num_pairs; q++)
+		{
+			pair = &(cast_handle->pairs[q]);
+			filter = &(coeffs->filters[q]);
+			slot = cast_handle->fdl_index;
+			for(p=0; p<num_partitions; p++)
+			{
+				RealFftMultiplyAccumulate_NoHandle(pair->diff_fdl_re[slot], pair->diff_fdl_im[slot], filter->diff_re[p], filter->diff_im[p],
+					cast_handle->acc_re, cast_handle->acc_im, BINAURAL_SYN_NUM_BINS);
+				if( --slot < 0 )
+					slot = num_partitions - 1;
+			}
+		}
+		RealFftInverse(fft_hdl, cast_handle->acc_re, cast_handle->acc_im, cast_handle->fft_buf);
+		memcpy(cast_handle->diff_tail, cast_handle->fft_buf + BINAURAL_SYN_BLOCK_SIZE, sizeof(cast_handle->diff_tail));
+	}
+
+	// The current block becomes the previous block
+	for(q=0; q<i_num_pairs; q++)
+	{
+		pair = &(cast_handle->pairs[q]);
+		memcpy(pair->sum_in, pair->sum_in + BINAURAL_SYN_BLOCK_SIZE, BINAURAL_SYN_BLOCK_SIZE * sizeof(realtype));
+		memcpy(pair->diff_in, pair->diff_in + BINAURAL_SYN_BLOCK_SIZE, BINAURAL_SYN_BLOCK_SIZE * sizeof(realtype));
+	}
+}
+
+/*
+ * FUNCTION: BinauralSyn_ProcessPartitioned()
+ * DESCRIPTION:
+ *  Partitioned convolution version of the stereo and surround processing, same input and output
+ *  formats and same result as the direct convolution. Stereo runs the front pair, 5.1 adds the
+ *  rear pair and 7.1 the side pair. For surround, half of center plus sub is added to both
+ *  outputs and the other channels are zeroed. Processing can be performed in-place.
+ */
+int BinauralSyn_ProcessPartitioned(struct BinauralSynHdlType *cast_handle, int i_nchans, realtype *rp_input,
+							int i_num_sample_sets, realtype *rp_output)
+{
+	int j, q, c;
+	int num_pairs;
+	int pos;
+	int pair_channel[BINAURAL_SYN_NUM_PAIRS] = { 0, 4, 6 };	// Windows ordering of the left channel of each pair
+	realtype left, right;
+	realtype sum, diff;
+	realtype center_sub;
+	realtype *in;
+	realtype *out;
+	struct BinauralSynPairType *pair;
+	struct BinauralSynFilterType *filters = cast_handle->bank->coeff_sets[cast_handle->coeff_set_index].filters;
+
+	num_pairs = 1;
+	if( i_nchans == 6 )
+		num_pairs = 2;
+	else if( i_nchans == 8 )
+		num_pairs = 3;
+
+	// Pairs that were not being run have no history
+	for(q=cast_handle->num_active_pairs; q<num_pairs; q++)
+		BinauralSyn_ResetPair(&(cast_handle->pairs[q]));
+	cast_handle->num_active_pairs = num_pairs;
+
+	pos = cast_handle->block_pos;
+
+	for(j=0; j<i_num_sample_sets; j++)
+	{
+		in = rp_input + j * i_nchans;
+		out = rp_output + j * i_nchans;
+
+		sum = cast_handle->sum_tail[pos];
+		diff = cast_handle->diff_tail[pos];
+
+		for(q=0; q<num_pairs; q++)
+		{
+			pair = &(cast_handle->pairs[q]);
+			left = in[pair_channel[q]];
+			right = in[pair_channel[q] + 1];
+			pair->sum_in[BINAURAL_SYN_BLOCK_SIZE + pos] = left + right;
+			pair->diff_in[BINAURAL_SYN_BLOCK_SIZE + pos] = left - right;
+
+			sum += BinauralSyn_Dot(pair->sum_in + pos + 1, filters[q].sum_head);
+			diff += BinauralSyn_Dot(pair->diff_in + pos + 1, filters[q].diff_head);
+		}
+
+		if( i_nchans == 2 )
+		{
+			out[0] = sum + diff;
+			out[1] = sum - diff;
+		}
+		else
+		{
+			// Note in this mode only stereo channels are output, others are set to zero.
+			center_sub = (realtype)0.5 * (in[2] + in[3]);
+			out[0] = sum + diff + center_sub;
+			out[1] = sum - diff + center_sub;
+			for(c=2; c<i_nchans; c++)
+				out[c] = (realtype)0.0;
+		}
+
+		pos++;
+		if( pos >= BINAURAL_SYN_BLOCK_SIZE )
+		{
+			BinauralSyn_RunTail(cast_handle, num_pairs);
+			pos = 0;
+		}
+	}
+
+	cast_handle->block_pos = pos;
+
+	return(OKAY);
+}
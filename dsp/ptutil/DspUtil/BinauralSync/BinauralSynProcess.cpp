@@ -55,6 +55,47 @@ float SideFarCoeffs48[128];
 #include "IRC_1057_R_R0195_T165_P000TrimComp2_48.h"		// Rear coeffs declaration and initiation
 #endif // BINAURAL_SYN_FILE_BASED_COEFFS
 
+/*
+ * FUNCTION: BinauralSyn_CheckSampFreq()
+ * DESCRIPTION:
+ *  Takes over a newly loaded coeff bank, and on a bank or sampling rate change selects the coeffs
+ *  for the new rate and zeros the sample memory of both processing modes.
+ *  The replaced bank is handed back to be freed off the audio thread, a new bank is only taken
+ *  once the previous one has been freed.
+ */
+static void BinauralSyn_CheckSampFreq(struct BinauralSynHdlType *cast_handle, int i_samp_freq)
+{
+	int i;
+	struct BinauralSynBankType *new_bank = NULL;
+
+	if( cast_handle->retired_bank.load(std::memory_order_acquire) == NULL )
+		new_bank = cast_handle->pending_bank.exchange(NULL, std::memory_order_acq_rel);
+
+	if( new_bank != NULL )
+	{
+		cast_handle->retired_bank.store(cast_handle->bank, std::memory_order_release);
+		cast_handle->bank = new_bank;
+	}
+	else if( i_samp_freq == cast_handle->last_samp_freq )
+		return;
+
+	cast_handle->last_samp_freq = i_samp_freq;
+	BinauralSyn_SelectCoeffSet(cast_handle, i_samp_freq);
+
+	for(i=0; i<BINAURAL_SYN_MAX_NUM_COEFFS; i++)
+	{
+		cast_handle->LFsamples[i] = (realtype)0.0;
+		cast_handle->RFsamples[i] = (realtype)0.0;
+		cast_handle->LRsamples[i] = (realtype)0.0;
+		cast_handle->RRsamples[i] = (realtype)0.0;
+		cast_handle->LSsamples[i] = (realtype)0.0;
+		cast_handle->RSsamples[i] = (realtype)0.0;
+	}
+	cast_handle->sample_index = 0;
+
+	BinauralSyn_ResetPartitions(cast_handle);
+}
+
 /*
  * FUNCTION: BinauralSynProcessSurroundFormatWindowsOrdering()
  * DESCRIPTION:
@@ -66,6 +107,7 @@ float SideFarCoeffs48[128];
  *  Right Out = (Right In) * NearCoeffs + (Left In)  * FarCoeffs
  *  Ordering for 5.1 is: Front Left, Front Right, Front Center, Low Frequency, Back Left, Back Right
  *  Ordering for 7.1 is: Front Left, Front Right, Front Center, Low Frequency, Back Left, Back Right, Side Left, Side Right
+ *  In the default partitioned mode the convolution is done by BinauralSyn_ProcessPartitioned().
  */
 int PT_DECLSPEC BinauralSynProcessSurroundFormatWindowsOrdering(PT_HANDLE *hp_BinauralSyn,
 							int i_nchans,
@@ -83,13 +125,14 @@ int PT_DECLSPEC BinauralSynProcessSurroundFormatWindowsOrdering(PT_HANDLE *hp_Bi
 	realtype *RRsamples;
 	realtype *LSsamples;
 	realtype *RSsamples;
+	realtype *FrontNear, *FrontFar;
+	realtype *RearNear, *RearFar;
+	realtype *SideNear, *SideFar;
 	realtype left_out, right_out;
 	int mode_7_1;
 	realtype sub;
 	realtype center;
-	int s_ratio;
-	int s_index;
-	int internal_samp_rate_flag;
+	struct BinauralSynImpulseType *coeffs;
 
 	struct BinauralSynHdlType *cast_handle;
 
@@ -101,46 +144,27 @@ int PT_DECLSPEC BinauralSynProcessSurroundFormatWindowsOrdering(PT_HANDLE *hp_Bi
 	if( (i_nchans != 6) &&  (i_nchans != 8) )
 		return(NOT_OKAY);
 
-	// PTNOTE - for now, no processing is performed for samp freqs above 48khz.
-	if( i_samp_freq > BINAURAL_SYN_MAX_SAMP_FREQ )
+	// No processing is performed outside the supported rate range.
+	if( (i_samp_freq > BINAURAL_SYN_MAX_SAMP_FREQ) || (i_samp_freq < BINAURAL_SYN_MIN_SAMP_FREQ) )
 		return(OKAY);
 
-	if( i_samp_freq < BINAURAL_SYN_MIN_SAMP_FREQ ) // No processing is performed if below min samp freq.
-		return(OKAY);
+	BinauralSyn_CheckSampFreq(cast_handle, i_samp_freq);
 
-	if( i_samp_freq != cast_handle->last_samp_freq )
-	{
-		cast_handle->last_left = (realtype)0.0;
-		cast_handle->last_right = (realtype)0.0;
-		cast_handle->s_ratio = 1;
-		cast_handle->s_index = 0;
-		cast_handle->sample_index = 0;
-		cast_handle->last_samp_freq = i_samp_freq;
-		cast_handle->internal_samp_rate_flag = (int)BINAURAL_SYN_COEFF_SAMP_RATE_44_1;
-
-		if( i_samp_freq > BINAURAL_SYN_MAX_SAMP_FREQ )
-			cast_handle->s_ratio = i_samp_freq/(int)BINAURAL_SYN_DEFAULT_SAMP_FREQ; // Note this rounds down as desired.
-
-		// Check to see if sample rate is an integer multiple of 44.1hz or 48khz.
-		if( ((float)i_samp_freq / (float)((int)44100 * cast_handle->s_ratio)) > (float)1.02 )
-			cast_handle->internal_samp_rate_flag = (int)BINAURAL_SYN_COEFF_SAMP_RATE_48;
-
-		for(i=0; i<BINAURAL_SYN_MAX_NUM_COEFFS; i++)
-		{
-			cast_handle->LFsamples[i] = (realtype)0.0;
-			cast_handle->RFsamples[i] = (realtype)0.0;
-			cast_handle->LRsamples[i] = (realtype)0.0;
-			cast_handle->RRsamples[i] = (realtype)0.0;
-			cast_handle->LSsamples[i] = (realtype)0.0;
-			cast_handle->RSsamples[i] = (realtype)0.0;
-		}
-	}
+	if( cast_handle->processing_mode == BINAURAL_SYN_MODE_PARTITIONED )
+		return(BinauralSyn_ProcessPartitioned(cast_handle, i_nchans, rp_input, i_num_sample_sets, rp_output));
 
 	mode_7_1 = 0;
 	if( i_nchans == 8)
 		mode_7_1 = 1;
 
-	max = cast_handle->num_coeffs;
+	coeffs = &(cast_handle->bank->coeff_sets[cast_handle->coeff_set_index].impulse);
+	max = coeffs->num_coeffs;
+	FrontNear = coeffs->near_coeffs[BINAURAL_SYN_FRONT_PAIR];
+	FrontFar = coeffs->far_coeffs[BINAURAL_SYN_FRONT_PAIR];
+	RearNear = coeffs->near_coeffs[BINAURAL_SYN_REAR_PAIR];
+	RearFar = coeffs->far_coeffs[BINAURAL_SYN_REAR_PAIR];
+	SideNear = coeffs->near_coeffs[BINAURAL_SYN_SIDE_PAIR];
+	SideFar = coeffs->far_coeffs[BINAURAL_SYN_SIDE_PAIR];
 
 	LFsamples = cast_handle->LFsamples;
 	RFsamples = cast_handle->RFsamples;
@@ -150,131 +174,74 @@ int PT_DECLSPEC BinauralSynProcessSurroundFormatWindowsOrdering(PT_HANDLE *hp_Bi
 	RSsamples = cast_handle->RSsamples;
 
 	index = cast_handle->sample_index;
-	s_ratio = cast_handle->s_ratio;
-	s_index = cast_handle->s_index;
-	internal_samp_rate_flag = cast_handle->internal_samp_rate_flag;
 
-	// Note that s_index controls sample skipping and filling and maintains state until next buffer
-	// so odd number of sample sets are handled correctly.
 	for( j=0; j < (i_num_sample_sets * i_nchans); j += i_nchans )
 	{
-		if( s_index != 0 ) // Check to see if to process or skip and fill
+		left_out = (realtype)0.0;
+		right_out = (realtype)0.0;
+
+		// Update circular buffers, assumes index is pointing to next input location
+		// Buffer is organized with sample age increasing with index increases.
+		LFsamples[index] = rp_input[j];			// Front channels
+		RFsamples[index] = rp_input[j + 1];
+
+		center = rp_input[j + 2];
+		sub	 = rp_input[j + 3];
+
+		LRsamples[index] = rp_input[j + 4];	// Rear channels
+		RRsamples[index] = rp_input[j + 5];
+
+		if( mode_7_1 ) // Only do side channels for 7.1 case
+		{
+			LSsamples[index] = rp_input[j + 6];
+			RSsamples[index] = rp_input[j + 7];
+		}
+
+		// Do convolution with the coeffs for the current rate
+		for(i=0; i<max; i++)
 		{
-			// Note in this mode only stereo channels are output, others are set to zero.
-			rp_output[j]	  = cast_handle->last_left;
-			rp_output[j + 1] = cast_handle->last_right;
-			rp_output[j + 2] = (realtype)0.0;
-			rp_output[j + 3] = (realtype)0.0;
-			rp_output[j + 4] = (realtype)0.0;
-			rp_output[j + 5] = (realtype)0.0;
-
-			if( mode_7_1 ) // Only do side channels for 7.1 case
+			left_out  += LFsamples[index] * FrontNear[i] + RFsamples[index] * FrontFar[i];
+			left_out  += LRsamples[index] * RearNear[i]  + RRsamples[index] * RearFar[i];
+
+			right_out += RFsamples[index] * FrontNear[i] + LFsamples[index] * FrontFar[i];
+			right_out += RRsamples[index] * RearNear[i]  + LRsamples[index] * RearFar[i];
+
+			if( mode_7_1)
 			{
-				rp_output[j + 6] = (realtype)0.0;
-				rp_output[j + 7] = (realtype)0.0;
+				left_out  += LSsamples[index] * SideNear[i] + RSsamples[index] * SideFar[i];
+				right_out += RSsamples[index] * SideNear[i] + LSsamples[index] * SideFar[i];
 			}
 
-			s_index++;
-			if( s_index >= s_ratio )
-				s_index = 0;
+			index++;
+
+			// Note that this method only uses the amount of sample buffer equal to the coeff size.
+			if(index >= max)
+				index = 0;
 		}
-		else // Process
-		{
-			s_index++;
-			left_out = (realtype)0.0;
-			right_out = (realtype)0.0;
 
-			// Update circular buffers, assumes index is pointing to next input location
-			// Buffer is organized with sample age increasing with index increases.
-			LFsamples[index] = rp_input[j];			// Front channels
-			RFsamples[index] = rp_input[j + 1];
+		// Set index pointing to the oldest current sample set, which is where the next new sample set will go.
+		index--;
 
-			center = rp_input[j + 2];
-			sub	 = rp_input[j + 3];
+		if(index < 0)
+			index = max - 1;
 
-			LRsamples[index] = rp_input[j + 4];	// Rear channels
-			RRsamples[index] = rp_input[j + 5];
+		// Note in this mode only stereo channels are output, others are set to zero.
+		rp_output[j]	  = left_out  + (realtype)0.5 * (center + sub);
+		rp_output[j + 1] = right_out + (realtype)0.5 * (center + sub);
 
-			if( mode_7_1 ) // Only do side channels for 7.1 case
-			{
-				LSsamples[index] = rp_input[j + 6];
-				RSsamples[index] = rp_input[j + 7];
-			}
+		rp_output[j + 2] = (realtype)0.0;
+		rp_output[j + 3] = (realtype)0.0;
+		rp_output[j + 4] = (realtype)0.0;
+		rp_output[j + 5] = (realtype)0.0;
 
-			// Do convolution, use either 44.1 or 48khz coeffs
-			if( internal_samp_rate_flag == BINAURAL_SYN_COEFF_SAMP_RATE_44_1 )
-				for(i=0; i<max; i++) // 44.1khz case
-				{
-					left_out  += LFsamples[index] * FrontNearCoeffs[i] + RFsamples[index] * FrontFarCoeffs[i];
-					left_out  += LRsamples[index] * RearNearCoeffs[i]  + RRsamples[index] * RearFarCoeffs[i];
-
-					right_out += RFsamples[index] * FrontNearCoeffs[i] + LFsamples[index] * FrontFarCoeffs[i];
-					right_out += RRsamples[index] * RearNearCoeffs[i]  + LRsamples[index] * RearFarCoeffs[i];
-
-					if( mode_7_1)
-					{
-						left_out  += LSsamples[index] * SideNearCoeffs[i] + RSsamples[index] * SideFarCoeffs[i];
-						right_out += RSsamples[index] * SideNearCoeffs[i] + LSsamples[index] * SideFarCoeffs[i];
-					}
-
-					index++;
-
-					// Note that this method only uses the amount of sample buffer equal to the coeff size.
-					if(index >= max)
-						index = 0;
-				}
-			else
-				for(i=0; i<max; i++) // 48khz case
-				{
-					left_out  += LFsamples[index] * FrontNearCoeffs48[i] + RFsamples[index] * FrontFarCoeffs48[i];
-					left_out  += LRsamples[index] * RearNearCoeffs48[i]  + RRsamples[index] * RearFarCoeffs48[i];
-
-					right_out += RFsamples[index] * FrontNearCoeffs48[i] + LFsamples[index] * FrontFarCoeffs48[i];
-					right_out += RRsamples[index] * RearNearCoeffs48[i]  + LRsamples[index] * RearFarCoeffs48[i];
-
-					if( mode_7_1)
-					{
-						left_out  += LSsamples[index] * SideNearCoeffs48[i] + RSsamples[index] * SideFarCoeffs48[i];
-						right_out += RSsamples[index] * SideNearCoeffs48[i] + LSsamples[index] * SideFarCoeffs48[i];
-					}
-
-					index++;
-
-					// Note that this method only uses the amount of sample buffer equal to the coeff size.
-					if(index >= max)
-						index = 0;
-				}
-
-			// Set index pointing to the oldest current sample set, which is where the next new sample set will go.
-			index--;
-
-			if(index < 0)
-				index = max - 1;
-
-			// Note in this mode only stereo channels are output, others are set to zero.
-			rp_output[j]	  = left_out  + (realtype)0.5 * (center + sub);
-			rp_output[j + 1] = right_out + (realtype)0.5 * (center + sub);
-
-			cast_handle->last_left = rp_output[j];
-			cast_handle->last_right = rp_output[j + 1];
-
-			rp_output[j + 2] = (realtype)0.0;
-			rp_output[j + 3] = (realtype)0.0;
-			rp_output[j + 4] = (realtype)0.0;
-			rp_output[j + 5] = (realtype)0.0;
-
-			if( mode_7_1 ) // Only do side channels for 7.1 case
-			{
-				rp_output[j + 6] = (realtype)0.0;
-				rp_output[j + 7] = (realtype)0.0;
-			}
+		if( mode_7_1 ) // Only do side channels for 7.1 case
+		{
+			rp_output[j + 6] = (realtype)0.0;
+			rp_output[j + 7] = (realtype)0.0;
 		}
 	}
 
 	cast_handle->sample_index = index;
-	cast_handle->s_ratio = s_ratio;
-	cast_handle->s_index = s_index;	
-	cast_handle->internal_samp_rate_flag = internal_samp_rate_flag;
 
 	return(OKAY);
 }
@@ -288,6 +255,7 @@ int PT_DECLSPEC BinauralSynProcessSurroundFormatWindowsOrdering(PT_HANDLE *hp_Bi
  *  to place the left channel and are swapped over to place the right channel:
  *  Left Out  = (Left In)  * NearCoeffs + (Right In) * FarCoeffs
  *  Right Out = (Right In) * NearCoeffs + (Left In)  * FarCoeffs
+ *  In the default partitioned mode the convolution is done by BinauralSyn_ProcessPartitioned().
  */
 int PT_DECLSPEC BinauralSynProcessStereoFormat(PT_HANDLE *hp_BinauralSyn,
 							realtype *rp_stereo_in,
@@ -300,10 +268,9 @@ int PT_DECLSPEC BinauralSynProcessStereoFormat(PT_HANDLE *hp_BinauralSyn,
 	int index;
 	realtype *Lsamples;
 	realtype *Rsamples;
+	realtype *NearCoeffs, *FarCoeffs;
 	realtype left_out, right_out;
-	int s_ratio;
-	int s_index;
-	int internal_samp_rate_flag;
+	struct BinauralSynImpulseType *coeffs;
 
 	struct BinauralSynHdlType *cast_handle;
 
@@ -312,115 +279,59 @@ int PT_DECLSPEC BinauralSynProcessStereoFormat(PT_HANDLE *hp_BinauralSyn,
 	if (cast_handle == NULL)
 		return(NOT_OKAY);
 
-	// PTNOTE - for now, no processing is performed for samp freqs above 48khz.
-	if( i_samp_freq > BINAURAL_SYN_MAX_SAMP_FREQ )
+	// No processing is performed outside the supported rate range.
+	if( (i_samp_freq > BINAURAL_SYN_MAX_SAMP_FREQ) || (i_samp_freq < BINAURAL_SYN_MIN_SAMP_FREQ) )
 		return(OKAY);
 
-	if( i_samp_freq < BINAURAL_SYN_MIN_SAMP_FREQ ) // No processing is performed if below min samp freq.
-		return(OKAY);
+	BinauralSyn_CheckSampFreq(cast_handle, i_samp_freq);
 
-	if( i_samp_freq != cast_handle->last_samp_freq )
-	{
-		cast_handle->last_left = (realtype)0.0;
-		cast_handle->last_right = (realtype)0.0;
-		cast_handle->s_ratio = 1;
-		cast_handle->s_index = 0;
-		cast_handle->sample_index = 0;
-		cast_handle->last_samp_freq = i_samp_freq;
-		cast_handle->internal_samp_rate_flag = (int)BINAURAL_SYN_COEFF_SAMP_RATE_44_1;
-
-		if( i_samp_freq > BINAURAL_SYN_MAX_SAMP_FREQ )
-			cast_handle->s_ratio = i_samp_freq/(int)BINAURAL_SYN_DEFAULT_SAMP_FREQ; // Note this rounds down as desired.
-
-		// Check to see if sample rate is an integer multiple of 44.1hz or 48khz.
-		if( ((float)i_samp_freq / (float)((int)44100 * cast_handle->s_ratio)) > (float)1.02 )
-			cast_handle->internal_samp_rate_flag = (int)BINAURAL_SYN_COEFF_SAMP_RATE_48;
-
-		for(i=0; i<BINAURAL_SYN_MAX_NUM_COEFFS; i++)
-		{
-			cast_handle->LFsamples[i] = (realtype)0.0;
-			cast_handle->RFsamples[i] = (realtype)0.0;
-		}
-	}
+	if( cast_handle->processing_mode == BINAURAL_SYN_MODE_PARTITIONED )
+		return(BinauralSyn_ProcessPartitioned(cast_handle, 2, rp_stereo_in, i_num_sample_sets, rp_stereo_out));
+
+	coeffs = &(cast_handle->bank->coeff_sets[cast_handle->coeff_set_index].impulse);
+	max = coeffs->num_coeffs;
+	NearCoeffs = coeffs->near_coeffs[BINAURAL_SYN_FRONT_PAIR];
+	FarCoeffs = coeffs->far_coeffs[BINAURAL_SYN_FRONT_PAIR];
 
-	max = cast_handle->num_coeffs;
 	Lsamples = cast_handle->LFsamples;
 	Rsamples = cast_handle->RFsamples;
 	index = cast_handle->sample_index;
-	s_ratio = cast_handle->s_ratio;
-	s_index = cast_handle->s_index;
-	internal_samp_rate_flag = cast_handle->internal_samp_rate_flag;
 
-	// Note that s_index controls sample skipping and filling and maintains state until next buffer
-	// so odd number of sample sets are handled correctly.
 	for(j=0; j< i_num_sample_sets * 2; j += 2)
 	{
-		if( s_index != 0 ) // Check to see if to process or skip and fill
-		{
-			rp_stereo_out[j]		= cast_handle->last_left;
-			rp_stereo_out[j + 1] = cast_handle->last_right;
-
-			s_index++;
-			if( s_index >= s_ratio )
-				s_index = 0;
-		}
-		else // Process
-		{
-			s_index++;
-			left_out = (realtype)0.0;
-			right_out = (realtype)0.0;
-
-			// Update circular buffer, assumes index is pointing to next input location
-			// Buffer is organized with sample age increasing with index increases.
-			Lsamples[index] = rp_stereo_in[j];
-			Rsamples[index] = rp_stereo_in[j + 1];
+		left_out = (realtype)0.0;
+		right_out = (realtype)0.0;
 
-			// Do convolution, use either 44.1 or 48khz coeffs
-			if( internal_samp_rate_flag == BINAURAL_SYN_COEFF_SAMP_RATE_44_1 )
-				for(i=0; i<max; i++)	// 44.1khz case
-				{
-					left_out  += Lsamples[index] * FrontNearCoeffs[i] + Rsamples[index] * FrontFarCoeffs[i];
+		// Update circular buffer, assumes index is pointing to next input location
+		// Buffer is organized with sample age increasing with index increases.
+		Lsamples[index] = rp_stereo_in[j];
+		Rsamples[index] = rp_stereo_in[j + 1];
 
-					right_out += Rsamples[index] * FrontNearCoeffs[i] + Lsamples[index] * FrontFarCoeffs[i];
-
-					index++;
-
-					// Note that this method only uses the amount of sample buffer equal to the coeff size.
-					if(index >= max)
-						index = 0;
-				}
-			else
-				for(i=0; i<max; i++)	// 48khz case
-				{
-					left_out  += Lsamples[index] * FrontNearCoeffs48[i] + Rsamples[index] * FrontFarCoeffs48[i];
-
-					right_out += Rsamples[index] * FrontNearCoeffs48[i] + Lsamples[index] * FrontFarCoeffs48[i];
+		// Do convolution with the coeffs for the current rate
+		for(i=0; i<max; i++)
+		{
+			left_out  += Lsamples[index] * NearCoeffs[i] + Rsamples[index] * FarCoeffs[i];
 
-					index++;
+			right_out += Rsamples[index] * NearCoeffs[i] + Lsamples[index] * FarCoeffs[i];
 
-					// Note that this method only uses the amount of sample buffer equal to the coeff size.
-					if(index >= max)
-						index = 0;
-				}
+			index++;
 
-			// Set index pointing to the oldest current sample pair, which is where the next new sample pair will go.
-			index--;
+			// Note that this method only uses the amount of sample buffer equal to the coeff size.
+			if(index >= max)
+				index = 0;
+		}
 
-			if(index < 0)
-				index = max - 1;
+		// Set index pointing to the oldest current sample set, which is where the next new sample set will go.
+		index--;
 
-			rp_stereo_out[j] = left_out;
-			rp_stereo_out[j + 1] = right_out;
+		if(index < 0)
+			index = max - 1;
 
-			cast_handle->last_left	= left_out;
-			cast_handle->last_right = right_out;
-		}
+		rp_stereo_out[j]		= left_out;
+		rp_stereo_out[j + 1] = right_out;
 	}
 
 	cast_handle->sample_index = index;
-	cast_handle->s_ratio = s_ratio;
-	cast_handle->s_index = s_index;
-	cast_handle->internal_samp_rate_flag = internal_samp_rate_flag;
 
 	return(OKAY);
 }
@@ -0,0 +1,483 @@
+/*
+FxSound
+Copyright (C) 2025  FxSound LLC
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <stdlib.h>
+#include <math.h>
+
+#include <chrono>
+#include <new>
+
+#include "codedefs.h"
+#include "RealFft.h"
+#include "BinauralSyn.h"
+#include "u_BinauralSyn.h"
+
+#define BINAURAL_SYN_PI 3.14159265358979323846
+
+// Global coefficients
+extern float FrontNearCoeffs[]; // 44.1k hz coeffs
+extern float FrontFarCoeffs[];
+extern float RearNearCoeffs[];
+extern float RearFarCoeffs[];
+extern float SideNearCoeffs[];
+extern float SideFarCoeffs[];
+
+extern float FrontNearCoeffs48[];  // 48k hz coeffs
+extern float FrontFarCoeffs48[];
+extern float RearNearCoeffs48[];
+extern float RearFarCoeffs48[];
+extern float SideNearCoeffs48[];
+extern float SideFarCoeffs48[];
+
+/* Rates built with every bank, in coeff set order */
+static const int binauralSyn_standard_rates[BINAURAL_SYN_NUM_STANDARD_RATES] =
+	{ 44100, 48000, 88200, 96000, 176400, 192000 };
+
+/*
+ * FUNCTION: BinauralSyn_GetPairCoeffs()
+ * DESCRIPTION:
+ *  Gets the near and far global coefficient arrays of a speaker pair for the passed coeff rate.
+ */
+static void BinauralSyn_GetPairCoeffs(int i_pair, int i_samp_rate_flag, float **fpp_near, float **fpp_far)
+{
+	int use_48 = (i_samp_rate_flag == BINAURAL_SYN_COEFF_SAMP_RATE_48);
+
+	switch ( i_pair )
+	{
+	case BINAURAL_SYN_REAR_PAIR :
+		*fpp_near = use_48 ? RearNearCoeffs48 : RearNearCoeffs;
+		*fpp_far = use_48 ? RearFarCoeffs48 : RearFarCoeffs;
+		break;
+
+	case BINAURAL_SYN_SIDE_PAIR :
+		*fpp_near = use_48 ? SideNearCoeffs48 : SideNearCoeffs;
+		*fpp_far = use_48 ? SideFarCoeffs48 : SideFarCoeffs;
+		break;
+
+	default :
+		*fpp_near = use_48 ? FrontNearCoeffs48 : FrontNearCoeffs;
+		*fpp_far = use_48 ? FrontFarCoeffs48 : FrontFarCoeffs;
+		break;
+	}
+}
+
+/*
+ * FUNCTION: BinauralSyn_BesselI0()
+ * DESCRIPTION:
+ *   Zeroth order modified Bessel function, for the Kaiser window.
+ */
+static double BinauralSyn_BesselI0(double d_x)
+{
+	double d_sum = 1.0;
+	double d_term = 1.0;
+	int k;
+
+	for(k=1; k<50; k++)
+	{
+		d_term *= (d_x / (2.0 * k)) * (d_x / (2.0 * k));
+		d_sum += d_term;
+		if( d_term < d_sum * 1.0e-12 )
+			break;
+	}
+
+	return(d_sum);
+}
+
+/*
+ * FUNCTION: BinauralSyn_Resample()
+ * DESCRIPTION:
+ *  Resamples an impulse response with Kaiser windowed sinc interpolation. The cutoff is the
+ *  nyquist frequency of the lower rate, and the result is scaled by the rate ratio so the
+ *  frequency response keeps its gain.
+ */
+static void BinauralSyn_Resample(realtype *rp_src, int i_num_src, int i_src_freq, realtype *rp_dst, int i_num_dst, int i_dst_freq)
+{
+	int n, m, m_first, m_last;
+	double ratio = (double)i_dst_freq / (double)i_src_freq;
+	double cutoff = (ratio < 1.0) ? ratio : 1.0;		// Relative to the source nyquist frequency
+	double half_width = (double)BINAURAL_SYN_RESAMPLE_HALF_WIDTH / cutoff;	// In source samples
+	double window_norm = 1.0 / BinauralSyn_BesselI0(BINAURAL_SYN_RESAMPLE_KAISER_BETA);
+	double t, x, r, sinc, sum;
+
+	for(n=0; n<i_num_dst; n++)
+	{
+		t = (double)n / ratio;	// Position in source samples
+		m_first = (int)ceil(t - half_width);
+		m_last = (int)floor(t + half_width);
+		if( m_first < 0 )
+			m_first = 0;
+		if( m_last > i_num_src - 1 )
+			m_last = i_num_src - 1;
+
+		sum = 0.0;
+		for(m=m_first; m<=m_last; m++)
+		{
+			x = t - (double)m;
+			r = x / half_width;
+			if( fabs(r) >= 1.0 )
+				continue;
+
+			sinc = 1.0;
+			if( x != 0.0 )
+				sinc = sin(BINAURAL_SYN_PI * cutoff * x) / (BINAURAL_SYN_PI * cutoff * x);
+
+			sum += (double)rp_src[m] * cutoff * sinc *
+				BinauralSyn_BesselI0(BINAURAL_SYN_RESAMPLE_KAISER_BETA * sqrt(1.0 - r * r)) * window_norm;
+		}
+
+		rp_dst[n] = (realtype)(sum / ratio);
+	}
+}
+
+/*
+ * FUNCTION: BinauralSyn_StandardRate()
+ * DESCRIPTION:
+ *  Returns the rate of the passed standard coeff set.
+ */
+int BinauralSyn_StandardRate(int i_index)
+{
+	return(binauralSyn_standard_rates[i_index]);
+}
+
+/*
+ * FUNCTION: BinauralSyn_BuildCoeffSet()
+ * DESCRIPTION:
+ *  Builds the coeffs of every speaker pair for the passed rate from the bank sources, along with
+ *  their partitioned filters. A source at the same rate is used as it is, otherwise the source in
+ *  the same rate family, or the first source, is resampled.
+ */
+void BinauralSyn_BuildCoeffSet(PT_HANDLE *hp_fft, struct BinauralSynBankType *sp_bank, struct BinauralSynCoeffSetType *sp_set, int i_samp_freq)
+{
+	int q, i;
+	int num_coeffs;
+	struct BinauralSynImpulseType *src;
+	struct BinauralSynImpulseType *dst = &(sp_set->impulse);
+	realtype buf[BINAURAL_SYN_FFT_SIZE];
+
+	src = NULL;
+	for(i=0; i<sp_bank->num_sources; i++)
+		if( sp_bank->sources[i].samp_freq == i_samp_freq )
+			src = &(sp_bank->sources[i]);
+
+	// 88.2k and 176.4k come from the 44.1k source, everything else from the 48k source
+	for(i=0; (i<sp_bank->num_sources) && (src == NULL); i++)
+		if( ((sp_bank->sources[i].samp_freq % 11025) == 0) == ((i_samp_freq % 11025) == 0) )
+			src = &(sp_bank->sources[i]);
+
+	if( src == NULL )
+		src = &(sp_bank->sources[0]);
+
+	num_coeffs = (int)((double)src->num_coeffs * (double)i_samp_freq / (double)src->samp_freq + 0.5);
+	if( num_coeffs > BINAURAL_SYN_MAX_NUM_COEFFS )
+		num_coeffs = BINAURAL_SYN_MAX_NUM_COEFFS;
+	if( num_coeffs < 1 )
+		num_coeffs = 1;
+
+	for(q=0; q<BINAURAL_SYN_NUM_PAIRS; q++)
+	{
+		if( i_samp_freq == src->samp_freq )
+		{
+			for(i=0; i<num_coeffs; i++)
+			{
+				dst->near_coeffs[q][i] = src->near_coeffs[q][i];
+				dst->far_coeffs[q][i] = src->far_coeffs[q][i];
+			}
+		}
+		else
+		{
+			BinauralSyn_Resample(src->near_coeffs[q], src->num_coeffs, src->samp_freq, dst->near_coeffs[q], num_coeffs, i_samp_freq);
+			BinauralSyn_Resample(src->far_coeffs[q], src->num_coeffs, src->samp_freq, dst->far_coeffs[q], num_coeffs, i_samp_freq);
+		}
+
+		for(i=num_coeffs; i<BINAURAL_SYN_MAX_NUM_COEFFS; i++)
+		{
+			dst->near_coeffs[q][i] = (realtype)0.0;
+			dst->far_coeffs[q][i] = (realtype)0.0;
+		}
+	}
+
+	dst->num_coeffs = num_coeffs;
+	dst->samp_freq = i_samp_freq;
+
+	BinauralSyn_BuildPartitions(hp_fft, sp_set, buf);
+}
+
+/*
+ * FUNCTION: BinauralSyn_GetBuiltInSources()
+ * DESCRIPTION:
+ *  Copies the global 44.1k and 48k coefficients into the sources of the passed bank.
+ */
+static void BinauralSyn_GetBuiltInSources(struct BinauralSynHdlType *cast_handle, struct BinauralSynBankType *sp_bank)
+{
+	int s, q, i;
+	int samp_rate_flag[BINAURAL_SYN_MAX_NUM_SOURCES] = { BINAURAL_SYN_COEFF_SAMP_RATE_44_1, BINAURAL_SYN_COEFF_SAMP_RATE_48 };
+	int samp_freq[BINAURAL_SYN_MAX_NUM_SOURCES] = { 44100, 48000 };
+	float *near_coeffs;
+	float *far_coeffs;
+	struct BinauralSynImpulseType *src;
+
+	sp_bank->hash = 0;
+	sp_bank->num_sources = BINAURAL_SYN_MAX_NUM_SOURCES;
+
+	for(s=0; s<BINAURAL_SYN_MAX_NUM_SOURCES; s++)
+	{
+		src = &(sp_bank->sources[s]);
+		src->samp_freq = samp_freq[s];
+		src->num_coeffs = cast_handle->num_coeffs;
+
+		for(q=0; q<BINAURAL_SYN_NUM_PAIRS; q++)
+		{
+			BinauralSyn_GetPairCoeffs(q, samp_rate_flag[s], &near_coeffs, &far_coeffs);
+			for(i=0; i<cast_handle->num_coeffs; i++)
+			{
+				src->near_coeffs[q][i] = (realtype)near_coeffs[i];
+				src->far_coeffs[q][i] = (realtype)far_coeffs[i];
+			}
+		}
+	}
+}
+
+/*
+ * FUNCTION: BinauralSyn_NewBuiltInBank()
+ * DESCRIPTION:
+ *  Allocates a bank with the coeff sets of the standard rates built from the global coefficients.
+ *  Returns NULL if the allocation fails.
+ */
+struct BinauralSynBankType *BinauralSyn_NewBuiltInBank(struct BinauralSynHdlType *cast_handle, PT_HANDLE *hp_fft)
+{
+	int i;
+	struct BinauralSynBankType *bank;
+
+	bank = (struct BinauralSynBankType *)calloc(1, sizeof(struct BinauralSynBankType));
+	if( bank == NULL )
+		return(NULL);
+
+	BinauralSyn_GetBuiltInSources(cast_handle, bank);
+
+	for(i=0; i<BINAURAL_SYN_NUM_STANDARD_RATES; i++)
+		BinauralSyn_BuildCoeffSet(hp_fft, bank, &(bank->coeff_sets[i]), binauralSyn_standard_rates[i]);
+
+	return(bank);
+}
+
+/*
+ * FUNCTION: BinauralSyn_AddCoeffSet()
+ * DESCRIPTION:
+ *  Builds the coeff set of the passed rate into a spare set of a bank the audio thread does not have
+ *  yet, unless the bank already has it. The spare sets are reused in turn.
+ */
+void BinauralSyn_AddCoeffSet(PT_HANDLE *hp_fft, struct BinauralSynBankType *sp_bank, int i_samp_freq)
+{
+	int i;
+
+	if( i_samp_freq <= 0 )
+		return;
+
+	for(i=0; i<BINAURAL_SYN_NUM_COEFF_SETS; i++)
+		if( sp_bank->coeff_sets[i].impulse.samp_freq == i_samp_freq )
+			return;
+
+	i = BINAURAL_SYN_NUM_STANDARD_RATES + sp_bank->next_spare_set;
+	sp_bank->next_spare_set++;
+	if( sp_bank->next_spare_set >= (BINAURAL_SYN_NUM_COEFF_SETS - BINAURAL_SYN_NUM_STANDARD_RATES) )
+		sp_bank->next_spare_set = 0;
+
+	BinauralSyn_BuildCoeffSet(hp_fft, sp_bank, &(sp_bank->coeff_sets[i]), i_samp_freq);
+}
+
+/*
+ * FUNCTION: BinauralSyn_SelectCoeffSet()
+ * DESCRIPTION:
+ *  Makes the coeff set of the passed rate in the current bank current. Runs on the audio thread, so
+ *  nothing is built here. A rate without a set uses the standard set of the nearest rate until the
+ *  bank the rate worker builds for it is taken over.
+ */
+void BinauralSyn_SelectCoeffSet(struct BinauralSynHdlType *cast_handle, int i_samp_freq)
+{
+	int i;
+	int nearest;
+	struct BinauralSynBankType *bank = cast_handle->bank;
+
+	for(i=0; i<BINAURAL_SYN_NUM_COEFF_SETS; i++)
+		if( bank->coeff_sets[i].impulse.samp_freq == i_samp_freq )
+		{
+			cast_handle->coeff_set_index = i;
+			return;
+		}
+
+	nearest = 0;
+	for(i=1; i<BINAURAL_SYN_NUM_STANDARD_RATES; i++)
+		if( abs(binauralSyn_standard_rates[i] - i_samp_freq) < abs(binauralSyn_standard_rates[nearest] - i_samp_freq) )
+			nearest = i;
+
+	cast_handle->coeff_set_index = nearest;
+}
+
+/*
+ * FUNCTION: BinauralSyn_PublishBuiltInBank()
+ * DESCRIPTION:
+ *  Builds a bank from the global coefficients, including the set of the prepared rate, and hands it
+ *  to the audio thread. Called with bank_lock held, never from the audio thread.
+ */
+int BinauralSyn_PublishBuiltInBank(struct BinauralSynHdlType *cast_handle)
+{
+	struct BinauralSynBankType *bank;
+	PT_HANDLE *fft_hdl;
+
+	// The audio thread uses the handle fft, so banks are built with their own
+	if( RealFftNew(&fft_hdl, BINAURAL_SYN_FFT_SIZE) != OKAY )
+		return(NOT_OKAY);
+
+	bank = BinauralSyn_NewBuiltInBank(cast_handle, fft_hdl);
+	if( bank != NULL )
+		BinauralSyn_AddCoeffSet(fft_hdl, bank, cast_handle->prepared_samp_freq);
+
+	RealFftFreeUp(&fft_hdl);
+
+	if( bank == NULL )
+		return(NOT_OKAY);
+
+	return(BinauralSyn_PublishBank(cast_handle, bank));
+}
+
+/*
+ * FUNCTION: BinauralSyn_RebuildCoeffSets()
+ * DESCRIPTION:
+ *  Hands over a new built in bank after the global coefficients have changed. A loaded bank does not
+ *  use them, the new values are picked up when the built in bank is next used. Called with bank_lock held.
+ */
+int BinauralSyn_RebuildCoeffSets(struct BinauralSynHdlType *cast_handle)
+{
+	if( cast_handle->published_bank->hash != 0 )
+		return(OKAY);
+
+	return(BinauralSyn_PublishBuiltInBank(cast_handle));
+}
+
+/*
+ * FUNCTION: BinauralSyn_PrepareSampFreq()
+ * DESCRIPTION:
+ *  Makes sure the bank the audio thread uses next has a coeff set for the passed rate. If the last
+ *  handed over bank does not have one, a copy of it with the set added is handed over instead.
+ *  Runs on the rate worker with bank_lock held.
+ */
+int BinauralSyn_PrepareSampFreq(struct BinauralSynHdlType *cast_handle, int i_samp_freq)
+{
+	int i;
+	struct BinauralSynBankType *bank;
+	PT_HANDLE *fft_hdl;
+
+	cast_handle->prepared_samp_freq = i_samp_freq;
+
+	for(i=0; i<BINAURAL_SYN_NUM_COEFF_SETS; i++)
+		if( cast_handle->published_bank->coeff_sets[i].impulse.samp_freq == i_samp_freq )
+			return(OKAY);
+
+	// The audio thread only reads a bank once it has it, and bank_lock keeps it from being freed
+	bank = (struct BinauralSynBankType *)malloc(sizeof(struct BinauralSynBankType));
+	if( bank == NULL )
+		return(NOT_OKAY);
+	*bank = *(cast_handle->published_bank);
+
+	if( RealFftNew(&fft_hdl, BINAURAL_SYN_FFT_SIZE) != OKAY )
+	{
+		free(bank);
+		return(NOT_OKAY);
+	}
+
+	BinauralSyn_AddCoeffSet(fft_hdl, bank, i_samp_freq);
+	RealFftFreeUp(&fft_hdl);
+
+	return(BinauralSyn_PublishBank(cast_handle, bank));
+}
+
+/*
+ * FUNCTION: BinauralSyn_RateWorkerThread()
+ * DESCRIPTION:
+ *  Builds the coeff set of each rate set with BinauralSynSetSampFreq() until the handle is freed.
+ */
+static void BinauralSyn_RateWorkerThread(struct BinauralSynHdlType *cast_handle)
+{
+	struct BinauralSynRateWorkerType *worker = cast_handle->rate_worker;
+	std::unique_lock<std::mutex> lock(worker->bank_lock);
+	int samp_freq;
+
+	while( !worker->stop )
+	{
+		samp_freq = cast_handle->requested_samp_freq.load(std::memory_order_acquire);
+
+		// A failed build is not retried, the audio thread keeps the set of the nearest standard rate
+		if( samp_freq != cast_handle->prepared_samp_freq )
+			BinauralSyn_PrepareSampFreq(cast_handle, samp_freq);
+		else
+			worker->wake.wait_for(lock, std::chrono::milliseconds(BINAURAL_SYN_RATE_WORKER_POLL_MSECS));
+	}
+}
+
+/*
+ * FUNCTION: BinauralSyn_StartRateWorker()
+ * DESCRIPTION:
+ *  Starts the thread that builds the coeff sets of newly set rates.
+ */
+int BinauralSyn_StartRateWorker(struct BinauralSynHdlType *cast_handle)
+{
+	struct BinauralSynRateWorkerType *worker;
+
+	worker = new (std::nothrow) struct BinauralSynRateWorkerType();
+	if( worker == NULL )
+		return(NOT_OKAY);
+
+	worker->stop = false;
+	cast_handle->requested_samp_freq.store(cast_handle->prepared_samp_freq);
+	cast_handle->rate_worker = worker;
+
+	try
+	{
+		worker->thread = std::thread(BinauralSyn_RateWorkerThread, cast_handle);
+	}
+	catch( ... )
+	{
+		cast_handle->rate_worker = NULL;
+		delete worker;
+		return(NOT_OKAY);
+	}
+
+	return(OKAY);
+}
+
+/*
+ * FUNCTION: BinauralSyn_StopRateWorker()
+ * DESCRIPTION:
+ *  Ends the rate worker thread, waiting for a build in progress to finish.
+ */
+void BinauralSyn_StopRateWorker(struct BinauralSynHdlType *cast_handle)
+{
+	struct BinauralSynRateWorkerType *worker = cast_handle->rate_worker;
+
+	if( worker == NULL )
+		return;
+
+	{
+		std::lock_guard<std::mutex> lock(worker->bank_lock);
+		worker->stop = true;
+	}
+	worker->wake.notify_one();
+	worker->thread.join();
+
+	cast_handle->rate_worker = NULL;
+	delete worker;
+}
@@ -41,7 +41,7 @@ extern float SideFarCoeffs48[];
  * DESCRIPTION:
  *  Sets the filter coefficient values for the specified channels. Input coefficients are a stereo
  *  array of left/right coefficient pairs, i_num_coeffs specifies the number of pairs.
- *
+ *  Must not be called from the audio thread.
  */
 int PT_DECLSPEC BinauralSynSetCoeffs(PT_HANDLE *hp_BinauralSyn, int i_channels_to_set, realtype *rp_coeff_pairs, int i_num_coeffs, int i_samp_rate_flag)
 {
@@ -56,6 +56,9 @@ int PT_DECLSPEC BinauralSynSetCoeffs(PT_HANDLE *hp_BinauralSyn, int i_channels_t
 	if( (i_num_coeffs <= 0) || (i_num_coeffs > BINAURAL_SYN_MAX_NUM_COEFFS) )
 		return(NOT_OKAY);
 
+	// The rate worker builds from the global coeffs too
+	std::lock_guard<std::mutex> lock(cast_handle->rate_worker->bank_lock);
+
 	switch ( i_channels_to_set )
 	{
 	case BINAURAL_SYN_FRONT_CHANNELS :
@@ -107,6 +110,29 @@ int PT_DECLSPEC BinauralSynSetCoeffs(PT_HANDLE *hp_BinauralSyn, int i_channels_t
 		break;
 	}
 
+	// The built in bank is rebuilt from the new coeffs and handed to the audio thread
+	return(BinauralSyn_RebuildCoeffSets(cast_handle));
+}
+
+/*
+ * FUNCTION: BinauralSynSetSampFreq()
+ * DESCRIPTION:
+ *  Sets the rate the following buffers will be processed at, so its coeff set can be built before
+ *  they arrive. Only records the rate and wakes the rate worker, which builds the set and hands over
+ *  the bank, so it can be called from the audio thread. Until then the nearest standard rate is used.
+ */
+int PT_DECLSPEC BinauralSynSetSampFreq(PT_HANDLE *hp_BinauralSyn, int i_samp_freq)
+{
+	struct BinauralSynHdlType *cast_handle;
+
+	cast_handle = (struct BinauralSynHdlType *)(hp_BinauralSyn);
+ 
+	if (cast_handle == NULL)
+		return(NOT_OKAY);
+
+	cast_handle->requested_samp_freq.store(i_samp_freq, std::memory_order_release);
+	cast_handle->rate_worker->wake.notify_one();
+
 	return(OKAY);
 }
 
@@ -126,8 +152,8 @@ int PT_DECLSPEC BinauralSynSetMemoryToZero(PT_HANDLE *hp_BinauralSyn)
 	if (cast_handle == NULL)
 		return(NOT_OKAY);
 
-	// Zero the sample memory
-	for(i=0; i<cast_handle->num_coeffs; i++)
+	// Zero the sample memory, resampled coeff sets can use all of it
+	for(i=0; i<BINAURAL_SYN_MAX_NUM_COEFFS; i++)
 	{
 		cast_handle->LFsamples[i] = (realtype)0.0;
 		cast_handle->RFsamples[i] = (realtype)0.0;
@@ -139,5 +165,35 @@ int PT_DECLSPEC BinauralSynSetMemoryToZero(PT_HANDLE *hp_BinauralSyn)
 
 	cast_handle->sample_index = 0;
 
+	BinauralSyn_ResetPartitions(cast_handle);
+
+	return(OKAY);
+}
+
+/*
+ * FUNCTION: BinauralSynSetProcessingMode()
+ * DESCRIPTION:
+ *  Selects partitioned fft convolution or the original per sample direct convolution.
+ *  Both give the same output, the direct mode is kept for reference and benchmarking.
+ *  Sample memory is zeroed when the mode changes.
+ */
+int PT_DECLSPEC BinauralSynSetProcessingMode(PT_HANDLE *hp_BinauralSyn, int i_mode)
+{
+	struct BinauralSynHdlType *cast_handle;
+
+	cast_handle = (struct BinauralSynHdlType *)(hp_BinauralSyn);
+ 
+	if (cast_handle == NULL)
+		return(NOT_OKAY);
+
+	if( (i_mode != BINAURAL_SYN_MODE_DIRECT) && (i_mode != BINAURAL_SYN_MODE_PARTITIONED) )
+		return(NOT_OKAY);
+
+	if( i_mode != cast_handle->processing_mode )
+	{
+		cast_handle->processing_mode = i_mode;
+		return(BinauralSynSetMemoryToZero(hp_BinauralSyn));
+	}
+
 	return(OKAY);
 }
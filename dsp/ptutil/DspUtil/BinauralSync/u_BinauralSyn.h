@@ -14,26 +14,144 @@
 #ifndef _U_BINAURAL_SYN_H_
 #define _U_BINAURAL_SYN_H_
 
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "pt_defs.h"
 #include "BinauralSyn.h"
 
+/*
+ * Partitioned convolution. The first BINAURAL_SYN_BLOCK_SIZE taps of each filter are run directly,
+ * so there is no added latency, and the rest are run as uniform partitions of the same size with
+ * overlap-save fft convolution. Each speaker pair is run as sum and difference signals, which
+ * turns the four near/far crossover filters into two.
+ */
+#define BINAURAL_SYN_BLOCK_SIZE 32
+#define BINAURAL_SYN_FFT_SIZE (2 * BINAURAL_SYN_BLOCK_SIZE)
+#define BINAURAL_SYN_NUM_BINS (BINAURAL_SYN_BLOCK_SIZE + 1)
+#define BINAURAL_SYN_MAX_PARTITIONS ((BINAURAL_SYN_MAX_NUM_COEFFS - 1) / BINAURAL_SYN_BLOCK_SIZE)
+
+#define BINAURAL_SYN_FRONT_PAIR 0
+#define BINAURAL_SYN_REAR_PAIR  1
+#define BINAURAL_SYN_SIDE_PAIR  2
+#define BINAURAL_SYN_NUM_PAIRS  3
+
+/* Partitioned convolution filters for one left/right speaker pair */
+struct BinauralSynFilterType
+{
+	realtype sum_head[BINAURAL_SYN_BLOCK_SIZE];		// Head taps of (near + far)/2, time reversed
+	realtype diff_head[BINAURAL_SYN_BLOCK_SIZE];		// Head taps of (near - far)/2, time reversed
+
+	// Spectra of the tail partitions, scaled by 1/BINAURAL_SYN_FFT_SIZE for the unscaled inverse
+	realtype sum_re[BINAURAL_SYN_MAX_PARTITIONS][BINAURAL_SYN_NUM_BINS];
+	realtype sum_im[BINAURAL_SYN_MAX_PARTITIONS][BINAURAL_SYN_NUM_BINS];
+	realtype diff_re[BINAURAL_SYN_MAX_PARTITIONS][BINAURAL_SYN_NUM_BINS];
+	realtype diff_im[BINAURAL_SYN_MAX_PARTITIONS][BINAURAL_SYN_NUM_BINS];
+};
+
+/* Partitioned convolution input history for one left/right speaker pair */
+struct BinauralSynPairType
+{
+	// Left + right and left - right input, previous block followed by the current block
+	realtype sum_in[BINAURAL_SYN_FFT_SIZE];
+	realtype diff_in[BINAURAL_SYN_FFT_SIZE];
+
+	// Spectra of past input blocks, one per partition, fdl_index in the handle is the newest
+	realtype sum_fdl_re[BINAURAL_SYN_MAX_PARTITIONS][BINAURAL_SYN_NUM_BINS];
+	realtype sum_fdl_im[BINAURAL_SYN_MAX_PARTITIONS][BINAURAL_SYN_NUM_BINS];
+	realtype diff_fdl_re[BINAURAL_SYN_MAX_PARTITIONS][BINAURAL_SYN_NUM_BINS];
+	realtype diff_fdl_im[BINAURAL_SYN_MAX_PARTITIONS][BINAURAL_SYN_NUM_BINS];
+};
+
+/*
+ * Coeffs are kept per sampling rate. A bank of coeff sets is built from one or two source impulse
+ * response sets. A source is used as it is at its own rate and resampled for other rates, from the
+ * source in the same family (multiples of 11025 hz or not) when there is one. The built in bank has
+ * the 44.1k and 48k sources, a loaded bank has the one source read from the hrir file(s).
+ * The common device rates are built with the bank. Another rate is asked for with BinauralSynSetSampFreq(),
+ * which can be called from the audio thread, and added to a copy of the bank by the handle's rate worker.
+ * The audio thread never builds a set, it only takes over the bank the worker or a load hands over.
+ */
+#define BINAURAL_SYN_NUM_STANDARD_RATES 6
+#define BINAURAL_SYN_NUM_COEFF_SETS (BINAURAL_SYN_NUM_STANDARD_RATES + 2)
+#define BINAURAL_SYN_MAX_NUM_SOURCES 2
+
+/* The rate worker also checks for a new rate this often, in case it was asked for just before it waited */
+#define BINAURAL_SYN_RATE_WORKER_POLL_MSECS 100
+
+/* Windowed sinc interpolation used to resample the coeffs */
+#define BINAURAL_SYN_RESAMPLE_HALF_WIDTH  16		// In samples at the lower of the two rates
+#define BINAURAL_SYN_RESAMPLE_KAISER_BETA 8.0
+
+/* Near and far impulse responses of every speaker pair at one rate */
+struct BinauralSynImpulseType
+{
+	int samp_freq;		// 0 if not set
+	int num_coeffs;	// Scales with the rate, so the impulse responses keep their length in time
+
+	realtype near_coeffs[BINAURAL_SYN_NUM_PAIRS][BINAURAL_SYN_MAX_NUM_COEFFS];
+	realtype far_coeffs[BINAURAL_SYN_NUM_PAIRS][BINAURAL_SYN_MAX_NUM_COEFFS];
+};
+
+/*
+ * Coeffs for one sampling rate, the impulse responses for the direct mode and their partitioned
+ * filters. Has no pointers, loaded bank sets are written to and read from the hrir cache as they are.
+ */
+struct BinauralSynCoeffSetType
+{
+	struct BinauralSynImpulseType impulse;		// impulse.samp_freq is 0 for an unused set
+
+	int num_partitions;		// Fft partitions after the direct head block
+	struct BinauralSynFilterType filters[BINAURAL_SYN_NUM_PAIRS];
+};
+
+/* Coeff sets built from one hrir set */
+struct BinauralSynBankType
+{
+	unsigned long long hash;		// Of the hrir file contents, 0 for the built in coeffs
+
+	int num_sources;
+	struct BinauralSynImpulseType sources[BINAURAL_SYN_MAX_NUM_SOURCES];
+
+	struct BinauralSynCoeffSetType coeff_sets[BINAURAL_SYN_NUM_COEFF_SETS];
+	int next_spare_set;	// Set after the standard rates to reuse next
+};
+
+/* Thread that builds the coeff sets of newly set rates, see BinauralSynSetSampFreq() */
+struct BinauralSynRateWorkerType
+{
+	std::mutex bank_lock;		// Held by everything that builds a bank or hands one over
+	std::condition_variable wake;
+	std::thread thread;
+	bool stop;						// Set with bank_lock held to end the thread
+};
+
 /* BinauralSyn Handle definition */
 struct BinauralSynHdlType
 {
-	int num_coeffs;
+	int num_coeffs;		// Coeffs used by the built in bank at the 44.1k and 48k rates
 
 	int sample_index;		// Holds internal sample circular buffer index, higher index means older samples
 
-	int s_ratio;			// Holds sample skipping ratio used for high sampling frequencies
-
-	int s_index;			// Holds sample skipping index used for high sampling frequencies
-
 	int last_samp_freq;  // Holds the last used sampling frequency, used to detect rate changes
 
-	int internal_samp_rate_flag;	// The actual internally used sampling rate, sets the coeffs to use.
-											// Either BINAURAL_SYN_COEFF_SAMP_RATE_44_1 or BINAURAL_SYN_COEFF_SAMP_RATE_48
+	// Banks are built off the audio thread and handed over through pending_bank. The audio thread
+	// takes it at the start of a buffer and hands back the bank it replaced through retired_bank,
+	// which is freed by the next load. Only the audio thread uses bank once processing has started.
+	struct BinauralSynBankType *bank;
+	std::atomic<struct BinauralSynBankType *> pending_bank;
+	std::atomic<struct BinauralSynBankType *> retired_bank;
+	// Only used with rate_worker->bank_lock held. The bank last handed over, which is not freed before
+	// the next one is, and the rate the worker last built for, which every new bank is built for.
+	struct BinauralSynBankType *published_bank;
+	int prepared_samp_freq;
+	std::atomic<int> requested_samp_freq;	// Rate last set with BinauralSynSetSampFreq()
+	struct BinauralSynRateWorkerType *rate_worker;
+	int coeff_set_index;	// Set for last_samp_freq
 
-	realtype last_left;	// Used for sample repeating
-	realtype last_right;
+	wchar_t cache_folder[PT_MAX_PATH_STRLEN];		// Hrir cache location, empty for no cache
 
 	realtype LFsamples[BINAURAL_SYN_MAX_NUM_COEFFS];	// Used for left front channel
 	realtype RFsamples[BINAURAL_SYN_MAX_NUM_COEFFS];	// Used for right front channel
@@ -41,6 +159,44 @@ struct BinauralSynHdlType
 	realtype RRsamples[BINAURAL_SYN_MAX_NUM_COEFFS];	// Used for right rear channel
 	realtype LSsamples[BINAURAL_SYN_MAX_NUM_COEFFS];	// Used for left side channel
 	realtype RSsamples[BINAURAL_SYN_MAX_NUM_COEFFS];	// Used for right side channel
+
+	int processing_mode;		// BINAURAL_SYN_MODE_PARTITIONED or BINAURAL_SYN_MODE_DIRECT
+
+	// Partitioned convolution
+	PT_HANDLE *fft_hdl;
+	int num_active_pairs;	// Speaker pairs run by the last buffer
+	int block_pos;				// Position of the next sample set in the current block
+	int fdl_index;				// Newest input block spectrum
+
+	struct BinauralSynPairType pairs[BINAURAL_SYN_NUM_PAIRS];
+
+	realtype sum_tail[BINAURAL_SYN_BLOCK_SIZE];		// Tail partition output for the current block
+	realtype diff_tail[BINAURAL_SYN_BLOCK_SIZE];
+	realtype acc_re[BINAURAL_SYN_NUM_BINS];			// Work buffers
+	realtype acc_im[BINAURAL_SYN_NUM_BINS];
+	realtype fft_buf[BINAURAL_SYN_FFT_SIZE];
 };
 
+/* BinauralSynRate.cpp */
+struct BinauralSynBankType *BinauralSyn_NewBuiltInBank(struct BinauralSynHdlType *cast_handle, PT_HANDLE *hp_fft);
+void BinauralSyn_BuildCoeffSet(PT_HANDLE *hp_fft, struct BinauralSynBankType *sp_bank, struct BinauralSynCoeffSetType *sp_set, int i_samp_freq);
+void BinauralSyn_AddCoeffSet(PT_HANDLE *hp_fft, struct BinauralSynBankType *sp_bank, int i_samp_freq);
+void BinauralSyn_SelectCoeffSet(struct BinauralSynHdlType *cast_handle, int i_samp_freq);
+int BinauralSyn_PublishBuiltInBank(struct BinauralSynHdlType *cast_handle);
+int BinauralSyn_RebuildCoeffSets(struct BinauralSynHdlType *cast_handle);
+int BinauralSyn_PrepareSampFreq(struct BinauralSynHdlType *cast_handle, int i_samp_freq);
+int BinauralSyn_StandardRate(int i_index);
+int BinauralSyn_StartRateWorker(struct BinauralSynHdlType *cast_handle);
+void BinauralSyn_StopRateWorker(struct BinauralSynHdlType *cast_handle);
+
+/* BinauralSynLoad.cpp */
+int BinauralSyn_PublishBank(struct BinauralSynHdlType *cast_handle, struct BinauralSynBankType *sp_bank);
+void BinauralSyn_FreeBanks(struct BinauralSynHdlType *cast_handle);
+
+/* BinauralSynPartition.cpp */
+void BinauralSyn_BuildPartitions(PT_HANDLE *hp_fft, struct BinauralSynCoeffSetType *sp_set, realtype *rp_buf);
+void BinauralSyn_ResetPartitions(struct BinauralSynHdlType *cast_handle);
+int BinauralSyn_ProcessPartitioned(struct BinauralSynHdlType *cast_handle, int i_nchans, realtype *rp_input,
+							int i_num_sample_sets, realtype *rp_output);
+
 #endif /* _U_BINAURAL_SYN_H_ */
\ No newline at end of file
@@ -0,0 +1,152 @@
+/*
+FxSound
+Copyright (C) 2025  FxSound LLC
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <stdlib.h>
+#include <math.h>
+
+#include "codedefs.h"
+#include "RealFft.h"
+#include "u_RealFft.h"
+
+#define REAL_FFT_PI 3.14159265358979323846
+
+/*
+ * FUNCTION: RealFftNew()
+ * DESCRIPTION:
+ *  Allocates and initializes a real transform handle of the passed size, which must be
+ *  a power of two. All tables and work buffers are allocated here so the transforms
+ *  themselves never allocate.
+ */
+int PT_DECLSPEC RealFftNew(PT_HANDLE **hpp_RealFft, int i_size)
+{
+	int i, j, n;
+	int num_bits;
+	double angle;
+	struct RealFftHdlType *cast_handle;
+
+	*hpp_RealFft = NULL;
+
+	if( (i_size < REAL_FFT_MIN_SIZE) || (i_size > REAL_FFT_MAX_SIZE) || ((i_size & (i_size - 1)) != 0) )
+		return(NOT_OKAY);
+
+	/* Allocate the handle */
+	cast_handle = (struct RealFftHdlType *)calloc(1, sizeof(struct RealFftHdlType));
+	if (cast_handle == NULL)
+		return(NOT_OKAY);
+
+	*hpp_RealFft = (PT_HANDLE *)cast_handle;
+
+	cast_handle->size = i_size;
+	cast_handle->half_size = i_size / 2;
+	n = cast_handle->half_size;
+
+	cast_handle->bit_reverse = (int *)calloc(n, sizeof(int));
+	cast_handle->stage_re = (realtype *)calloc(n, sizeof(realtype));
+	cast_handle->stage_im = (realtype *)calloc(n, sizeof(realtype));
+	cast_handle->split_re = (realtype *)calloc(n/2 + 1, sizeof(realtype));
+	cast_handle->split_im = (realtype *)calloc(n/2 + 1, sizeof(realtype));
+	cast_handle->work_re = (realtype *)calloc(n, sizeof(realtype));
+	cast_handle->work_im = (realtype *)calloc(n, sizeof(realtype));
+
+	if( (cast_handle->bit_reverse == NULL) || (cast_handle->stage_re == NULL) || (cast_handle->stage_im == NULL) ||
+		 (cast_handle->split_re == NULL) || (cast_handle->split_im == NULL) ||
+		 (cast_handle->work_re == NULL) || (cast_handle->work_im == NULL) )
+	{
+		RealFftFreeUp(hpp_RealFft);
+		return(NOT_OKAY);
+	}
+
+	num_bits = 0;
+	while( (1 << num_bits) < n )
+		num_bits++;
+
+	for(i=0; i<n; i++)
+	{
+		int rev = 0;
+		for(j=0; j<num_bits; j++)
+			if( i & (1 << j) )
+				rev |= 1 << (num_bits - 1 - j);
+		cast_handle->bit_reverse[i] = rev;
+	}
+
+	// Stage with span j uses exp(-i*pi*k/j) for k < j, stored starting at j - 1.
+	for(j=1; j<n; j *= 2)
+		for(i=0; i<j; i++)
+		{
+			angle = -REAL_FFT_PI * (double)i / (double)j;
+			cast_handle->stage_re[j - 1 + i] = (realtype)cos(angle);
+			cast_handle->stage_im[j - 1 + i] = (realtype)sin(angle);
+		}
+
+	for(i=0; i<=n/2; i++)
+	{
+		angle = -2.0 * REAL_FFT_PI * (double)i / (double)i_size;
+		cast_handle->split_re[i] = (realtype)cos(angle);
+		cast_handle->split_im[i] = (realtype)sin(angle);
+	}
+
+	return(OKAY);
+}
+
+/*
+ * FUNCTION: RealFftFreeUp()
+ * DESCRIPTION:
+ *   Frees the passed RealFft handle and sets to NULL.
+ */
+int PT_DECLSPEC RealFftFreeUp(PT_HANDLE **hpp_RealFft)
+{
+	struct RealFftHdlType *cast_handle;
+
+	cast_handle = (struct RealFftHdlType *)(*hpp_RealFft);
+
+	if (cast_handle == NULL)
+		return(NOT_OKAY);
+
+	free(cast_handle->bit_reverse);
+	free(cast_handle->stage_re);
+	free(cast_handle->stage_im);
+	free(cast_handle->split_re);
+	free(cast_handle->split_im);
+	free(cast_handle->work_re);
+	free(cast_handle->work_im);
+
+	// Free main handle
+	free(cast_handle);
+
+	*hpp_RealFft = NULL;
+
+	return(OKAY);
+}
+
+/*
+ * FUNCTION: RealFftGetSize()
+ * DESCRIPTION:
+ *   Gets the number of real samples transformed by the handle.
+ */
+int PT_DECLSPEC RealFftGetSize(PT_HANDLE *hp_RealFft, int *ip_size)
+{
+	struct RealFftHdlType *cast_handle;
+
+	cast_handle = (struct RealFftHdlType *)(hp_RealFft);
+
+	if (cast_handle == NULL)
+		return(NOT_OKAY);
+
+	*ip_size = cast_handle->size;
+
+	return(OKAY);
+}
@@ -0,0 +1,278 @@
+/*
+FxSound
+Copyright (C) 2025  FxSound LLC
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <stdlib.h>
+
+#include "codedefs.h"
+#include "RealFft.h"
+#include "u_RealFft.h"
+
+/*
+ * A real transform of size N is done as a complex radix 2 transform of size N/2, with the even
+ * samples in the real part and the odd samples in the imaginary part, followed by a split pass
+ * that separates the two. The inverse joins the spectrum back into N/2 complex values first.
+ * The complex transform works on separate real and imaginary arrays, which lets every stage with
+ * a span of 4 or more run 4 butterflies at a time with plain SSE, and the inverse reuses it by
+ * swapping the real and imaginary arrays.
+ */
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define REAL_FFT_SIMD_X86
+#include <xmmintrin.h>
+#endif
+
+/*
+ * FUNCTION: RealFft_Butterflies()
+ * DESCRIPTION:
+ *   In place decimation in time complex transform of the half_size values, which must already be
+ *   in bit reversed order.
+ */
+static void RealFft_Butterflies(struct RealFftHdlType *cast_handle, realtype *rp_re, realtype *rp_im)
+{
+	int i, k;
+	int span;
+	int n = cast_handle->half_size;
+	realtype tr, ti;
+	realtype *wr, *wi;
+
+	// Span 1, twiddle is 1
+	for(i=0; i<n; i+=2)
+	{
+		tr = rp_re[i + 1];
+		ti = rp_im[i + 1];
+		rp_re[i + 1] = rp_re[i] - tr;
+		rp_im[i + 1] = rp_im[i] - ti;
+		rp_re[i] += tr;
+		rp_im[i] += ti;
+	}
+
+	// Span 2, twiddles are 1 and -i
+	for(i=0; i<n; i+=4)
+	{
+		tr = rp_re[i + 2];
+		ti = rp_im[i + 2];
+		rp_re[i + 2] = rp_re[i] - tr;
+		rp_im[i + 2] = rp_im[i] - ti;
+		rp_re[i] += tr;
+		rp_im[i] += ti;
+
+		tr = rp_im[i + 3];
+		ti = -rp_re[i + 3];
+		rp_re[i + 3] = rp_re[i + 1] - tr;
+		rp_im[i + 3] = rp_im[i + 1] - ti;
+		rp_re[i + 1] += tr;
+		rp_im[i + 1] += ti;
+	}
+
+	for(span=4; span<n; span *= 2)
+	{
+		wr = cast_handle->stage_re + span - 1;
+		wi = cast_handle->stage_im + span - 1;
+
+		for(i=0; i<n; i += 2 * span)
+		{
+			realtype *ar = rp_re + i;
+			realtype *ai = rp_im + i;
+			realtype *br = rp_re + i + span;
+			realtype *bi = rp_im + i + span;
+
+#ifdef REAL_FFT_SIMD_X86
+			for(k=0; k<span; k+=4)
+			{
+				__m128 w_re = _mm_loadu_ps(wr + k);
+				__m128 w_im = _mm_loadu_ps(wi + k);
+				__m128 b_re = _mm_loadu_ps(br + k);
+				__m128 b_im = _mm_loadu_ps(bi + k);
+				__m128 a_re = _mm_loadu_ps(ar + k);
+				__m128 a_im = _mm_loadu_ps(ai + k);
+				__m128 t_re = _mm_sub_ps(_mm_mul_ps(b_re, w_re), _mm_mul_ps(b_im, w_im));
+				__m128 t_im = _mm_add_ps(_mm_mul_ps(b_re, w_im), _mm_mul_ps(b_im, w_re));
+
+				_mm_storeu_ps(br + k, _mm_sub_ps(a_re, t_re));
+				_mm_storeu_ps(bi + k, _mm_sub_ps(a_im, t_im));
+				_mm_storeu_ps(ar + k, _mm_add_ps(a_re, t_re));
+				_mm_storeu_ps(ai + k, _mm_add_ps(a_im, t_im));
+			}
+#else
+			for(k=0; k<span; k++)
+			{
+				tr = br[k] * wr[k] - bi[k] * wi[k];
+				ti = br[k] * wi[k] + bi[k] * wr[k];
+				br[k] = ar[k] - tr;
+				bi[k] = ai[k] - ti;
+				ar[k] += tr;
+				ai[k] += ti;
+			}
+#endif
+		}
+	}
+}
+
+/*
+ * FUNCTION: RealFftForward()
+ * DESCRIPTION:
+ *  Transforms size real samples into the size/2 + 1 bin spectrum rp_re, rp_im.
+ *  The input is not modified.
+ */
+int PT_DECLSPEC RealFftForward(PT_HANDLE *hp_RealFft, realtype *rp_in, realtype *rp_re, realtype *rp_im)
+{
+	int k, n;
+	int *bit_reverse;
+	realtype *zr, *zi;
+	realtype er, ei, or_, oi, tr, ti;
+	struct RealFftHdlType *cast_handle;
+
+	cast_handle = (struct RealFftHdlType *)(hp_RealFft);
+
+	if (cast_handle == NULL)
+		return(NOT_OKAY);
+
+	n = cast_handle->half_size;
+	bit_reverse = cast_handle->bit_reverse;
+	zr = cast_handle->work_re;
+	zi = cast_handle->work_im;
+
+	for(k=0; k<n; k++)
+	{
+		zr[bit_reverse[k]] = rp_in[2 * k];
+		zi[bit_reverse[k]] = rp_in[2 * k + 1];
+	}
+
+	RealFft_Butterflies(cast_handle, zr, zi);
+
+	rp_re[0] = zr[0] + zi[0];
+	rp_im[0] = (realtype)0.0;
+	rp_re[n] = zr[0] - zi[0];
+	rp_im[n] = (realtype)0.0;
+
+	// Bins k and n - k come from the same pair of complex values
+	for(k=1; k<=n/2; k++)
+	{
+		er  = (realtype)0.5 * (zr[k] + zr[n - k]);
+		ei  = (realtype)0.5 * (zi[k] - zi[n - k]);
+		or_ = (realtype)0.5 * (zi[k] + zi[n - k]);
+		oi  = (realtype)0.5 * (zr[n - k] - zr[k]);
+
+		tr = cast_handle->split_re[k] * or_ - cast_handle->split_im[k] * oi;
+		ti = cast_handle->split_re[k] * oi  + cast_handle->split_im[k] * or_;
+
+		rp_re[n - k] = er - tr;
+		rp_im[n - k] = ti - ei;
+		rp_re[k] = er + tr;
+		rp_im[k] = ei + ti;
+	}
+
+	return(OKAY);
+}
+
+/*
+ * FUNCTION: RealFftInverse()
+ * DESCRIPTION:
+ *  Transforms a size/2 + 1 bin spectrum back into size real samples. The result is not scaled,
+ *  it is size times the signal the spectrum came from. The imaginary parts of the dc and nyquist
+ *  bins are ignored. The input spectrum is not modified.
+ */
+int PT_DECLSPEC RealFftInverse(PT_HANDLE *hp_RealFft, realtype *rp_re, realtype *rp_im, realtype *rp_out)
+{
+	int k, n;
+	int *bit_reverse;
+	realtype *zr, *zi;
+	realtype er, ei, dr, di, or_, oi;
+	struct RealFftHdlType *cast_handle;
+
+	cast_handle = (struct RealFftHdlType *)(hp_RealFft);
+
+	if (cast_handle == NULL)
+		return(NOT_OKAY);
+
+	n = cast_handle->half_size;
+	bit_reverse = cast_handle->bit_reverse;
+	zr = cast_handle->work_re;
+	zi = cast_handle->work_im;
+
+	// Join the spectrum back into n complex values. The inverse transform is done with the
+	// forward butterflies by swapping real and imaginary parts going in and coming out, so the
+	// real parts are loaded into zi and the imaginary parts into zr.
+	// Index 0 bit reverses to itself
+	zi[0] = rp_re[0] + rp_re[n];
+	zr[0] = rp_re[0] - rp_re[n];
+
+	for(k=1; k<=n/2; k++)
+	{
+		er = rp_re[k] + rp_re[n - k];
+		ei = rp_im[k] - rp_im[n - k];
+		dr = rp_re[k] - rp_re[n - k];
+		di = rp_im[k] + rp_im[n - k];
+
+		// Odd part is the difference times the conjugate twiddle
+		or_ = dr * cast_handle->split_re[k] + di * cast_handle->split_im[k];
+		oi  = di * cast_handle->split_re[k] - dr * cast_handle->split_im[k];
+
+		// Z[k] = E + i*O, Z[n - k] = conj(E) + i*conj(O)
+		zi[bit_reverse[k]] = er - oi;
+		zr[bit_reverse[k]] = ei + or_;
+		zi[bit_reverse[n - k]] = er + oi;
+		zr[bit_reverse[n - k]] = or_ - ei;
+	}
+
+	RealFft_Butterflies(cast_handle, zr, zi);
+
+	for(k=0; k<n; k++)
+	{
+		rp_out[2 * k] = zi[k];
+		rp_out[2 * k + 1] = zr[k];
+	}
+
+	return(OKAY);
+}
+
+/*
+ * FUNCTION: RealFftMultiplyAccumulate_NoHandle()
+ * DESCRIPTION:
+ *  Adds the complex product of spectra a and b to the acc spectrum, bin by bin.
+ *  Used by fast convolution to sum filtered partitions in the frequency domain.
+ */
+int PT_DECLSPEC RealFftMultiplyAccumulate_NoHandle(realtype *rp_a_re, realtype *rp_a_im, realtype *rp_b_re, realtype *rp_b_im,
+							realtype *rp_acc_re, realtype *rp_acc_im, int i_num_bins)
+{
+	int k = 0;
+
+#ifdef REAL_FFT_SIMD_X86
+	for(; k <= i_num_bins - 4; k += 4)
+	{
+		__m128 a_re = _mm_loadu_ps(rp_a_re + k);
+		__m128 a_im = _mm_loadu_ps(rp_a_im + k);
+		__m128 b_re = _mm_loadu_ps(rp_b_re + k);
+		__m128 b_im = _mm_loadu_ps(rp_b_im + k);
+		__m128 acc_re = _mm_loadu_ps(rp_acc_re + k);
+		__m128 acc_im = _mm_loadu_ps(rp_acc_im + k);
+
+		acc_re = _mm_add_ps(acc_re, _mm_sub_ps(_mm_mul_ps(a_re, b_re), _mm_mul_ps(a_im, b_im)));
+		acc_im = _mm_add_ps(acc_im, _mm_add_ps(_mm_mul_ps(a_re, b_im), _mm_mul_ps(a_im, b_re)));
+
+		_mm_storeu_ps(rp_acc_re + k, acc_re);
+		_mm_storeu_ps(rp_acc_im + k, acc_im);
+	}
+#endif
+
+	for(; k < i_num_bins; k++)
+	{
+		rp_acc_re[k] += rp_a_re[k] * rp_b_re[k] - rp_a_im[k] * rp_b_im[k];
+		rp_acc_im[k] += rp_a_re[k] * rp_b_im[k] + rp_a_im[k] * rp_b_re[k];
+	}
+
+	return(OKAY);
+}
@@ -0,0 +1,41 @@
+/*
+FxSound
+Copyright (C) 2025  FxSound LLC
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef _U_REAL_FFT_H_
+#define _U_REAL_FFT_H_
+
+#include "RealFft.h"
+
+/* RealFft Handle definition */
+struct RealFftHdlType
+{
+	int size;				// Number of real samples transformed
+	int half_size;			// Size of the complex transform the real transform is built on
+
+	int *bit_reverse;		// Bit reversed index for each of the half_size complex inputs
+
+	realtype *stage_re;	// Complex transform twiddles, stored per stage so each stage reads them in order.
+	realtype *stage_im;	// The stage with span n holds its n twiddles starting at index n - 1.
+
+	realtype *split_re;	// Twiddles used to split and join the real spectrum, half_size/2 + 1 of them
+	realtype *split_im;
+
+	realtype *work_re;	// Complex transform work buffers, half_size each
+	realtype *work_im;
+};
+
+#endif /* _U_REAL_FFT_H_ */
@@ -0,0 +1,289 @@
+/*
+FxSound
+Copyright (C) 2025  FxSound LLC
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "codedefs.h"
+#include "RealFft.h"
+#include "spectrum.h"
+#include "u_spectrum.h"
+
+#define SPECTRUM_PI 3.14159265358979323846
+
+/* Filter bank band sensitivity warps, fft bands use the warp of the filter bank band they fall in */
+static const realtype spectrum_band_warps[SPECTRUM_MAX_NUM_BANDS] =
+{
+	(realtype)SPECTRUM_BAND_1_WARP, (realtype)SPECTRUM_BAND_2_WARP, (realtype)SPECTRUM_BAND_3_WARP,
+	(realtype)SPECTRUM_BAND_4_WARP, (realtype)SPECTRUM_BAND_5_WARP, (realtype)SPECTRUM_BAND_6_WARP,
+	(realtype)SPECTRUM_BAND_7_WARP, (realtype)SPECTRUM_BAND_8_WARP, (realtype)SPECTRUM_BAND_9_WARP,
+	(realtype)SPECTRUM_BAND_10_WARP
+};
+
+/*
+ * FUNCTION: spectrum_AllocateRing()
+ * DESCRIPTION:
+ *  Allocates the fft mode sample ring for the longest delay, so a later delay or rate change
+ *  never has to grow it. Must not be called while spectrumProcess() runs on another thread.
+ */
+int spectrum_AllocateRing(struct spectrumHdlType *cast_handle)
+{
+	int needed;
+	int size;
+
+	needed = (int)(((realtype)SPECTRUM_MAX_DELAY_SECS + (realtype)SPECTRUM_FFT_RING_MARGIN_SECS) * (realtype)SPECTRUM_MAXIMUM_INTERNAL_SAMP_FREQ)
+				+ SPECTRUM_FFT_SIZE;
+
+	size = SPECTRUM_FFT_SIZE;
+	while( size < needed )
+		size *= 2;
+
+	if( size <= cast_handle->ring_size )
+		return(OKAY);
+
+	if( cast_handle->ring != NULL )
+		free(cast_handle->ring);
+	cast_handle->ring_size = 0;
+
+	cast_handle->ring = (realtype *)calloc(size, sizeof(realtype));
+	if( cast_handle->ring == NULL )
+		return(NOT_OKAY);
+
+	cast_handle->ring_size = size;
+	cast_handle->ring_write_count.store(0);
+	cast_handle->ring_reset_count.store(0);
+	cast_handle->last_analysis_count = 0;
+	cast_handle->analysis_reset_count = 0;
+
+	return(OKAY);
+}
+
+/*
+ * FUNCTION: spectrum_ResetRing()
+ * DESCRIPTION:
+ *  Discards the fft mode samples written so far. spectrumAnalyze() may be copying from the ring on
+ *  another thread, so the memory is left alone and the analysis reads samples older than the reset
+ *  count as zero instead.
+ */
+void spectrum_ResetRing(struct spectrumHdlType *cast_handle)
+{
+	cast_handle->ring_reset_count.store(cast_handle->ring_write_count.load(std::memory_order_relaxed), std::memory_order_release);
+}
+
+/*
+ * FUNCTION: spectrum_WriteRing()
+ * DESCRIPTION:
+ *  Fft mode part of spectrumProcess(), stores the channel sum of every i_loop_inc'th sample set,
+ *  or silence when processing is off. This is all the work done on the audio thread.
+ */
+void spectrum_WriteRing(struct spectrumHdlType *cast_handle, realtype *rp_signal, int i_num_sample_sets, int i_num_channels,
+								int i_loop_inc, int i_processing_on)
+{
+	int i;
+	unsigned int count;
+	unsigned int mask;
+	realtype *ring = cast_handle->ring;
+
+	if( ring == NULL )
+		return;
+
+	count = cast_handle->ring_write_count.load(std::memory_order_relaxed);
+	mask = (unsigned int)cast_handle->ring_size - 1;
+
+	for(i=0; i<i_num_sample_sets; i += i_loop_inc)
+	{
+		realtype in = (realtype)0.0;
+
+		if( i_processing_on )
+		{
+			if(i_num_channels == 2)
+				in = rp_signal[i * 2] + rp_signal[i * 2 + 1];
+			else
+				in = rp_signal[i];
+		}
+
+		ring[count & mask] = in;
+		count++;
+	}
+
+	cast_handle->ring_write_count.store(count, std::memory_order_release);
+}
+
+/*
+ * FUNCTION: spectrum_SetupBands()
+ * DESCRIPTION:
+ *  Sets the fft bins of each band for the current internal rate and band count. Bands narrower
+ *  than a bin use the bin nearest their center, bands above the nyquist frequency have no bins.
+ */
+static int spectrum_SetupBands(struct spectrumHdlType *cast_handle, realtype r_samp_freq)
+{
+	int b, k;
+	int num_bands = cast_handle->num_bands;
+	double ratio = SPECTRUM_FFT_MAX_FREQ / SPECTRUM_FFT_MIN_FREQ;
+	double bin_freq = (double)r_samp_freq / (double)SPECTRUM_FFT_SIZE;
+	double low, high, center;
+	int first, last;
+
+	if( cast_handle->fft_hdl == NULL )
+	{
+		if( RealFftNew(&(cast_handle->fft_hdl), SPECTRUM_FFT_SIZE) != OKAY )
+			return(NOT_OKAY);
+
+		// Hann window
+		cast_handle->fft_window_power = (realtype)0.0;
+		for(k=0; k<SPECTRUM_FFT_SIZE; k++)
+		{
+			cast_handle->fft_window[k] = (realtype)(0.5 - 0.5 * cos(2.0 * SPECTRUM_PI * (double)k / (double)SPECTRUM_FFT_SIZE));
+			cast_handle->fft_window_power += cast_handle->fft_window[k] * cast_handle->fft_window[k];
+		}
+	}
+
+	for(b=0; b<num_bands; b++)
+	{
+		low = SPECTRUM_FFT_MIN_FREQ * pow(ratio, (double)b / (double)num_bands);
+		high = SPECTRUM_FFT_MIN_FREQ * pow(ratio, (double)(b + 1) / (double)num_bands);
+		center = sqrt(low * high);
+
+		first = (int)ceil(low / bin_freq);
+		last = (int)ceil(high / bin_freq) - 1;
+		if( first > last )
+			first = last = (int)(center / bin_freq + 0.5);
+
+		if( last > SPECTRUM_FFT_NUM_BINS - 2 )
+			last = SPECTRUM_FFT_NUM_BINS - 2;		// Nyquist bin is not used
+		if( first < 1 )
+			first = 1;
+
+		cast_handle->band_first_bin[b] = first;
+		cast_handle->band_last_bin[b] = last;		// Less than first above nyquist
+
+		cast_handle->band_warp[b] = spectrum_band_warps[(b * SPECTRUM_MAX_NUM_BANDS) / num_bands];
+		cast_handle->band_power[b] = (realtype)0.0;
+	}
+
+	cast_handle->analysis_samp_freq = r_samp_freq;
+	cast_handle->analysis_num_bands = num_bands;
+
+	return(OKAY);
+}
+
+/*
+ * FUNCTION: spectrumAnalyze()
+ * DESCRIPTION:
+ *  Fft mode analysis, updates the band values from the audio written by spectrumProcess() since
+ *  the last call. Runs a windowed fft of the latest SPECTRUM_FFT_SIZE samples before the spectrum
+ *  delay, and applies the time constant to the band mean squares over the audio time that has
+ *  passed. Band values have the same scaling as the filter bank. Does nothing in filter bank mode.
+ *  Call from the thread that reads the band values, not from the audio thread.
+ */
+int PT_DECLSPEC spectrumAnalyze(PT_HANDLE *hp_spectrum)
+{
+	struct spectrumHdlType *cast_handle;
+	int b, k;
+	unsigned int end_count, start_count, new_samples, mask;
+	unsigned int reset_count;
+	realtype samp_freq;
+	realtype power, mean_square, level;
+	realtype scale;
+	double elapsed_secs;
+	double attack, release;
+
+	cast_handle = (struct spectrumHdlType *)(hp_spectrum);
+
+	if (cast_handle == NULL)
+		return(NOT_OKAY);
+
+	if( (cast_handle->mode != SPECTRUM_MODE_FFT) || (cast_handle->ring == NULL) )
+		return(OKAY);
+
+	samp_freq = cast_handle->internal_samp_freq;
+	if( (samp_freq != cast_handle->analysis_samp_freq) || (cast_handle->num_bands != cast_handle->analysis_num_bands) )
+		if( spectrum_SetupBands(cast_handle, samp_freq) != OKAY )
+			return(NOT_OKAY);
+
+	reset_count = cast_handle->ring_reset_count.load(std::memory_order_acquire);
+	end_count = cast_handle->ring_write_count.load(std::memory_order_acquire);
+	new_samples = end_count - cast_handle->last_analysis_count;
+	if( new_samples == 0 )
+		return(OKAY);
+
+	// The levels start again from silence after a reset
+	if( reset_count != cast_handle->analysis_reset_count )
+	{
+		for(b=0; b<SPECTRUM_FFT_MAX_NUM_BANDS; b++)
+			cast_handle->band_power[b] = (realtype)0.0;
+		cast_handle->analysis_reset_count = reset_count;
+	}
+
+	// Window of the latest samples before the delay, zeros before the first samples
+	end_count -= (unsigned int)(cast_handle->delay_secs * samp_freq + (realtype)0.5);
+	start_count = end_count - SPECTRUM_FFT_SIZE;
+	mask = (unsigned int)cast_handle->ring_size - 1;
+
+	// Samples from before the last reset count as silence, the counts wrap so the test is on the signed distance
+	for(k=0; k<SPECTRUM_FFT_SIZE; k++)
+	{
+		if( (int)(start_count + k - reset_count) < 0 )
+			cast_handle->fft_in[k] = (realtype)0.0;
+		else
+			cast_handle->fft_in[k] = cast_handle->ring[(start_count + k) & mask] * cast_handle->fft_window[k];
+	}
+
+	// The window was overwritten while it was copied if the audio thread got more than a ring ahead,
+	// or is stale if it was reset meanwhile, the next call tries again
+	if( ((cast_handle->ring_write_count.load(std::memory_order_acquire) - start_count) > (unsigned int)cast_handle->ring_size) ||
+		 (cast_handle->ring_reset_count.load(std::memory_order_acquire) != reset_count) )
+		return(OKAY);
+
+	cast_handle->last_analysis_count += new_samples;
+
+	RealFftForward(cast_handle->fft_hdl, cast_handle->fft_in, cast_handle->fft_re, cast_handle->fft_im);
+
+	// One sided power to the mean square of the signal in the band
+	scale = (realtype)2.0 / ((realtype)SPECTRUM_FFT_SIZE * cast_handle->fft_window_power);
+
+	elapsed_secs = (double)new_samples / (double)samp_freq;
+	release = exp(-elapsed_secs * (double)cast_handle->time_constant);
+	attack = exp(-elapsed_secs * (double)cast_handle->time_constant * SPECTRUM_FFT_ATTACK_FACTOR);
+
+	for(b=0; b<cast_handle->num_bands; b++)
+	{
+		power = (realtype)0.0;
+		for(k=cast_handle->band_first_bin[b]; k<=cast_handle->band_last_bin[b]; k++)
+			power += cast_handle->fft_re[k] * cast_handle->fft_re[k] + cast_handle->fft_im[k] * cast_handle->fft_im[k];
+		mean_square = power * scale;
+
+		if( mean_square > cast_handle->band_power[b] )
+			cast_handle->band_power[b] = mean_square + (realtype)attack * (cast_handle->band_power[b] - mean_square);
+		else
+			cast_handle->band_power[b] = mean_square + (realtype)release * (cast_handle->band_power[b] - mean_square);
+
+		// Same level as the filter bank, which scales the channel sum by the sensitivity and warp
+		level = cast_handle->sensitivity * cast_handle->band_warp[b] * (realtype)sqrt(cast_handle->band_power[b]) /
+				  (realtype)cast_handle->num_channels;
+
+		if( level > (realtype)SPECTRUM_MAX_OUTPUT_VALUE )
+			level = (realtype)SPECTRUM_MAX_OUTPUT_VALUE;
+
+		cast_handle->band_values[b] = level;
+	}
+
+	spectrum_PublishBandValues(cast_handle);
+
+	return(OKAY);
+}
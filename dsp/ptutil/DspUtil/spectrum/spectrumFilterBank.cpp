@@ -0,0 +1,232 @@
+/*
+FxSound
+Copyright (C) 2025  FxSound LLC
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "codedefs.h"
+#include "spectrum.h"
+#include "u_spectrum.h"
+
+/*
+ * Filter bank mode resonant filters. The filter states are kept as a structure of arrays so
+ * the SSE2 version can run 4 bands per register, with all bands updated in one pass over the
+ * buffer. Each lane does exactly the same operations, in the same order, as the scalar code so
+ * the band values are bit identical. The level square root only depends on the last squared
+ * value, so it is done once per buffer instead of once per sample.
+ * The instruction set follows the sos module level, so sosSetMaxSimdLevel() also selects the
+ * scalar code here.
+ */
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define SPECTRUM_SIMD_X86
+#include <emmintrin.h>
+#endif
+
+/*
+ * FUNCTION: spectrum_ResetFilters()
+ * DESCRIPTION:
+ *  Zeros the filter states, the coefficients are left alone.
+ */
+void spectrum_ResetFilters(struct spectrumFiltBankType *sp_filt)
+{
+	memset(sp_filt->y1, 0, sizeof(sp_filt->y1));
+	memset(sp_filt->y2, 0, sizeof(sp_filt->y2));
+	memset(sp_filt->squared_filtered, 0, sizeof(sp_filt->squared_filtered));
+	memset(sp_filt->level, 0, sizeof(sp_filt->level));
+}
+
+/*
+ * FUNCTION: spectrum_UpdateLevels()
+ * DESCRIPTION:
+ *  Sets the band levels from the filtered squared values.
+ */
+static void spectrum_UpdateLevels(struct spectrumFiltBankType *sp_filt)
+{
+	int j;
+
+	for(j=0; j<SPECTRUM_FILT_NUM_LANES; j++)
+	{
+		if( sp_filt->squared_filtered[j] > (realtype)SPECTRUM_MAX_OUTPUT_VALUE )
+			sp_filt->level[j] = (realtype)SPECTRUM_MAX_OUTPUT_VALUE;
+		else
+		{
+			// Using an inlined version of a square root approximation from the mth module.
+			// This approximation can improve performance as much as 10 times for signals smaller than zero.
+			// Error is typically no more than 6%
+			union
+			{
+				int tmp;
+				float x;
+			} u;
+			u.x = sp_filt->squared_filtered[j];
+			u.tmp -= 1<<23; /* Remove last bit so 1.0 gives 1.0 */
+			/* tmp is now an approximation to logbase2(r_x) */
+			u.tmp >>= 1; /* divide by 2 */
+			u.tmp += 1<<29; /* add 64 to exponent: (e+127)/2 =(e/2)+63, */
+			/* that represents (e/2)-64 but we want e/2 */
+			sp_filt->level[j] = u.x;
+		}
+	}
+}
+
+/*
+ * FUNCTION: spectrum_ProcessFiltersScalar()
+ * DESCRIPTION:
+ *  Runs every band filter over the buffer, one band at a time per sample.
+ */
+static void spectrum_ProcessFiltersScalar(struct spectrumHdlType *cast_handle, realtype *rp_signal, int i_num_sample_sets,
+														int i_num_channels, int i_loop_inc, int i_processing_on)
+{
+	struct spectrumFiltBankType *sp_filt = &(cast_handle->filt);
+	realtype alpha = cast_handle->alpha;
+	realtype one_minus_alpha = cast_handle->one_minus_alpha;
+	int i, j;
+
+	for(i=0; i<i_num_sample_sets; i += i_loop_inc)
+	{
+		realtype in;
+		realtype input_sum;
+
+		if(i_num_channels == 2)
+			in = rp_signal[i * 2] + rp_signal[i * 2 + 1];
+		else
+			in = rp_signal[i];
+
+		// Note all filters use same in and in_2, filter needs them as a difference (see design notes).
+		// If processing is currently off, then set input to filter to 0.0
+		if (i_processing_on)
+			input_sum = in - cast_handle->in_2;
+		else
+			input_sum = (realtype)0.0;
+
+		for(j=0; j<SPECTRUM_FILT_NUM_LANES; j++)
+		{
+			realtype out;
+
+			// Implements a simple 2 pole resonant filter
+			out = input_sum + sp_filt->a1[j] * sp_filt->y1[j] + sp_filt->a2[j] * sp_filt->y2[j];
+			sp_filt->y2[j] = sp_filt->y1[j];
+			sp_filt->y1[j] = out;
+			out *= sp_filt->gain[j];
+
+			sp_filt->squared_filtered[j] = one_minus_alpha * (out * out) + alpha * sp_filt->squared_filtered[j];
+		}
+
+		// Shift input signals
+		cast_handle->in_2 = cast_handle->in_1;
+		cast_handle->in_1 = in;
+	}
+}
+
+#ifdef SPECTRUM_SIMD_X86
+
+/*
+ * FUNCTION: spectrum_ProcessFiltersSse()
+ * DESCRIPTION:
+ *  Same as spectrum_ProcessFiltersScalar(), with the bands in the lanes of three registers.
+ *  The states are kept in registers for the whole buffer so the handle alignment does not matter.
+ */
+static void spectrum_ProcessFiltersSse(struct spectrumHdlType *cast_handle, realtype *rp_signal, int i_num_sample_sets,
+													int i_num_channels, int i_loop_inc, int i_processing_on)
+{
+	struct spectrumFiltBankType *sp_filt = &(cast_handle->filt);
+	realtype in_1 = cast_handle->in_1;
+	realtype in_2 = cast_handle->in_2;
+	int i;
+
+	const __m128 alpha = _mm_set1_ps(cast_handle->alpha);
+	const __m128 one_minus_alpha = _mm_set1_ps(cast_handle->one_minus_alpha);
+
+	__m128 a1_0 = _mm_loadu_ps(sp_filt->a1), a1_1 = _mm_loadu_ps(sp_filt->a1 + 4), a1_2 = _mm_loadu_ps(sp_filt->a1 + 8);
+	__m128 a2_0 = _mm_loadu_ps(sp_filt->a2), a2_1 = _mm_loadu_ps(sp_filt->a2 + 4), a2_2 = _mm_loadu_ps(sp_filt->a2 + 8);
+	__m128 g_0 = _mm_loadu_ps(sp_filt->gain), g_1 = _mm_loadu_ps(sp_filt->gain + 4), g_2 = _mm_loadu_ps(sp_filt->gain + 8);
+	__m128 y1_0 = _mm_loadu_ps(sp_filt->y1), y1_1 = _mm_loadu_ps(sp_filt->y1 + 4), y1_2 = _mm_loadu_ps(sp_filt->y1 + 8);
+	__m128 y2_0 = _mm_loadu_ps(sp_filt->y2), y2_1 = _mm_loadu_ps(sp_filt->y2 + 4), y2_2 = _mm_loadu_ps(sp_filt->y2 + 8);
+	__m128 sq_0 = _mm_loadu_ps(sp_filt->squared_filtered);
+	__m128 sq_1 = _mm_loadu_ps(sp_filt->squared_filtered + 4);
+	__m128 sq_2 = _mm_loadu_ps(sp_filt->squared_filtered + 8);
+
+	for(i=0; i<i_num_sample_sets; i += i_loop_inc)
+	{
+		realtype in;
+		__m128 x, out_0, out_1, out_2;
+
+		if(i_num_channels == 2)
+			in = rp_signal[i * 2] + rp_signal[i * 2 + 1];
+		else
+			in = rp_signal[i];
+
+		if (i_processing_on)
+			x = _mm_set1_ps(in - in_2);
+		else
+			x = _mm_setzero_ps();
+
+		out_0 = _mm_add_ps(_mm_add_ps(x, _mm_mul_ps(a1_0, y1_0)), _mm_mul_ps(a2_0, y2_0));
+		out_1 = _mm_add_ps(_mm_add_ps(x, _mm_mul_ps(a1_1, y1_1)), _mm_mul_ps(a2_1, y2_1));
+		out_2 = _mm_add_ps(_mm_add_ps(x, _mm_mul_ps(a1_2, y1_2)), _mm_mul_ps(a2_2, y2_2));
+		y2_0 = y1_0; y2_1 = y1_1; y2_2 = y1_2;
+		y1_0 = out_0; y1_1 = out_1; y1_2 = out_2;
+		out_0 = _mm_mul_ps(out_0, g_0);
+		out_1 = _mm_mul_ps(out_1, g_1);
+		out_2 = _mm_mul_ps(out_2, g_2);
+
+		sq_0 = _mm_add_ps(_mm_mul_ps(one_minus_alpha, _mm_mul_ps(out_0, out_0)), _mm_mul_ps(alpha, sq_0));
+		sq_1 = _mm_add_ps(_mm_mul_ps(one_minus_alpha, _mm_mul_ps(out_1, out_1)), _mm_mul_ps(alpha, sq_1));
+		sq_2 = _mm_add_ps(_mm_mul_ps(one_minus_alpha, _mm_mul_ps(out_2, out_2)), _mm_mul_ps(alpha, sq_2));
+
+		in_2 = in_1;
+		in_1 = in;
+	}
+
+	_mm_storeu_ps(sp_filt->y1, y1_0); _mm_storeu_ps(sp_filt->y1 + 4, y1_1); _mm_storeu_ps(sp_filt->y1 + 8, y1_2);
+	_mm_storeu_ps(sp_filt->y2, y2_0); _mm_storeu_ps(sp_filt->y2 + 4, y2_1); _mm_storeu_ps(sp_filt->y2 + 8, y2_2);
+	_mm_storeu_ps(sp_filt->squared_filtered, sq_0);
+	_mm_storeu_ps(sp_filt->squared_filtered + 4, sq_1);
+	_mm_storeu_ps(sp_filt->squared_filtered + 8, sq_2);
+
+	cast_handle->in_1 = in_1;
+	cast_handle->in_2 = in_2;
+}
+
+#endif //SPECTRUM_SIMD_X86
+
+/*
+ * FUNCTION: spectrum_ProcessFilters()
+ * DESCRIPTION:
+ *  Runs the band filters over the buffer and updates the band levels.
+ */
+void spectrum_ProcessFilters(struct spectrumHdlType *cast_handle, realtype *rp_signal, int i_num_sample_sets,
+									  int i_num_channels, int i_loop_inc, int i_processing_on)
+{
+	int simd_level;
+
+	// Levels are left as they are if no samples were filtered
+	if( i_num_sample_sets <= 0 )
+		return;
+
+	sosGetSimdLevel(&simd_level);
+
+#ifdef SPECTRUM_SIMD_X86
+	if( simd_level >= SOS_SIMD_SSE2 )
+		spectrum_ProcessFiltersSse(cast_handle, rp_signal, i_num_sample_sets, i_num_channels, i_loop_inc, i_processing_on);
+	else
+#endif
+		spectrum_ProcessFiltersScalar(cast_handle, rp_signal, i_num_sample_sets, i_num_channels, i_loop_inc, i_processing_on);
+
+	spectrum_UpdateLevels(&(cast_handle->filt));
+}
@@ -25,13 +25,15 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 /*
  * FUNCTION: spectrumGetBandValues()
  * DESCRIPTION:
- *  Fills in the passed array with the previously calculated band values.
+ *  Fills in the passed array with the latest complete set of band values. Can be called from
+ *  any single thread while spectrumProcess() runs on the audio thread, never waits for it.
  */
 int PT_DECLSPEC spectrumGetBandValues(PT_HANDLE *hp_spectrum,
 							                 realtype *rp_band_values,
                                       int i_array_size)
 {
 	struct spectrumHdlType *cast_handle;
+	struct spectrumFrameType *sp_frame;
 	int band_index;
 
 	cast_handle = (struct spectrumHdlType *)(hp_spectrum);
@@ -42,14 +44,76 @@ int PT_DECLSPEC spectrumGetBandValues(PT_HANDLE *hp_spectrum,
 	if (rp_band_values == NULL)
 		return(NOT_OKAY);
 
+	/* Take the newest frame if one was published since the last call */
+	if (cast_handle->frame_exchange.load(std::memory_order_relaxed) & SPECTRUM_FRAME_NEW)
+		cast_handle->frame_read_index = cast_handle->frame_exchange.exchange(cast_handle->frame_read_index,
+																		std::memory_order_acq_rel) & SPECTRUM_FRAME_INDEX_MASK;
+
+	sp_frame = &(cast_handle->frames[cast_handle->frame_read_index]);
+
 	/* Make sure the array size is correct */
-	if (i_array_size != cast_handle->num_bands)
+	if (i_array_size != sp_frame->num_bands)
 		return(NOT_OKAY);
 
-	for (band_index = 0; band_index < cast_handle->num_bands; band_index++)
+	for (band_index = 0; band_index < sp_frame->num_bands; band_index++)
 	{
-		rp_band_values[band_index] = cast_handle->band_values[band_index];
+		rp_band_values[band_index] = sp_frame->band_values[band_index];
 	}
 
+	return(OKAY);
+}
+
+/*
+ * FUNCTION: spectrum_PublishBandValues()
+ * DESCRIPTION:
+ *  Hands the current band values to spectrumGetBandValues() as one frame. Only called by the
+ *  thread producing the band values.
+ */
+void spectrum_PublishBandValues(struct spectrumHdlType *cast_handle)
+{
+	struct spectrumFrameType *sp_frame;
+	int band_index;
+
+	sp_frame = &(cast_handle->frames[cast_handle->frame_write_index]);
+
+	for (band_index = 0; band_index < cast_handle->num_bands; band_index++)
+		sp_frame->band_values[band_index] = cast_handle->band_values[band_index];
+	sp_frame->num_bands = cast_handle->num_bands;
+
+	cast_handle->frame_write_index = cast_handle->frame_exchange.exchange(cast_handle->frame_write_index | SPECTRUM_FRAME_NEW,
+																	std::memory_order_acq_rel) & SPECTRUM_FRAME_INDEX_MASK;
+}
+
+/*
+ * FUNCTION: spectrum_ClearBandValues()
+ * DESCRIPTION:
+ *  Zeros the band values and publishes them. Same thread rules as spectrum_PublishBandValues().
+ */
+void spectrum_ClearBandValues(struct spectrumHdlType *cast_handle)
+{
+	int band_index;
+
+	for (band_index = 0; band_index < cast_handle->num_bands; band_index++)
+		cast_handle->band_values[band_index] = (realtype)0.0;
+
+	spectrum_PublishBandValues(cast_handle);
+}
+
+/*
+ * FUNCTION: spectrumGetNumBands()
+ * DESCRIPTION:
+ *  Passes back the number of band values.
+ */
+int PT_DECLSPEC spectrumGetNumBands(PT_HANDLE *hp_spectrum, int *ip_num_bands)
+{
+	struct spectrumHdlType *cast_handle;
+
+	cast_handle = (struct spectrumHdlType *)(hp_spectrum);
+ 
+	if (cast_handle == NULL)
+		return(NOT_OKAY);
+
+	*ip_num_bands = cast_handle->num_bands;
+
 	return(OKAY);
 }
\ No newline at end of file
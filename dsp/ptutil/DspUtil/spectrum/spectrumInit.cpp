@@ -22,6 +22,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "codedefs.h"
 #include "slout.h"
+#include "RealFft.h"
 #include "spectrum.h"
 #include "u_spectrum.h"
 
@@ -33,26 +34,46 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 int PT_DECLSPEC spectrumNew( PT_HANDLE **hpp_spectrum, int i_num_bands, realtype r_delay_secs, realtype r_refresh_rate_secs, CSlout *hp_slout, int i_trace_mode)
 {
 	struct spectrumHdlType *cast_handle;
+	PT_HANDLE *hp_new;
+
+	/* Check the arguments before anything is allocated */
+	if ((i_num_bands <= 0) || (r_refresh_rate_secs <= (realtype)0.0))
+		return(NOT_OKAY);
 
 	/* Allocate the handle */
 	cast_handle = (struct spectrumHdlType *)calloc( 1, sizeof(struct spectrumHdlType) );
 	if( cast_handle == NULL)
 		return(NOT_OKAY);
+	hp_new = (PT_HANDLE *)cast_handle;
+
+	/* Band value frames, one each for the producer, the exchange slot and the reader */
+	cast_handle->frame_write_index = 0;
+	cast_handle->frame_exchange.store(1);
+	cast_handle->frame_read_index = 2;
 
 	/* Store the slout */
 	cast_handle->slout_hdl = hp_slout;
 	cast_handle->trace_mode = i_trace_mode;
     
- 	if (i_num_bands <= 0)
-		return(NOT_OKAY);
-
 	cast_handle->num_bands = i_num_bands;
 
 	cast_handle->buffer_index = 0;
 	cast_handle->refresh_rate_secs = r_refresh_rate_secs;
 
+	/* The band delay line is sized for the longest delay, so spectrumSetDelay() never allocates */
+	cast_handle->band_buf_num_sets = (int)( (realtype)SPECTRUM_MAX_DELAY_SECS/r_refresh_rate_secs + (float)0.5 ) + 1;
+	cast_handle->band_buf = (realtype *)calloc( SPECTRUM_MAX_NUM_BANDS * cast_handle->band_buf_num_sets, sizeof(realtype) );
+	if( cast_handle->band_buf == NULL )
+	{
+		spectrumFreeUp(&hp_new);
+		return(NOT_OKAY);
+	}
+
 	if( spectrumSetDelay((PT_HANDLE *)cast_handle, r_delay_secs) != OKAY )
+	{
+		spectrumFreeUp(&hp_new);
 		return(NOT_OKAY);
+	}
 	
 	/* Set default values */
 	cast_handle->num_channels = 2;
@@ -60,7 +81,10 @@ int PT_DECLSPEC spectrumNew( PT_HANDLE **hpp_spectrum, int i_num_bands, realtype
 
 	// This function also calls spectrumReset(), initializing internal settings to default values
 	if( spectrumSetSensitivity((PT_HANDLE *)cast_handle, (realtype)(SPECTRUM_DEFAULT_SENSITIVITY)) != OKAY)
+	{
+		spectrumFreeUp(&hp_new);
 		return(NOT_OKAY);
+	}
 
    *hpp_spectrum = (PT_HANDLE *)cast_handle;
 
@@ -81,6 +105,17 @@ int PT_DECLSPEC spectrumFreeUp(PT_HANDLE **hpp_spectrum)
 	if (cast_handle == NULL)
 		return(NOT_OKAY);
 
+	/* Free the band delay line */
+	if (cast_handle->band_buf != NULL)
+		free(cast_handle->band_buf);
+
+	/* Free the fft mode ring and fft */
+	if (cast_handle->ring != NULL)
+		free(cast_handle->ring);
+
+	if (cast_handle->fft_hdl != NULL)
+		RealFftFreeUp(&(cast_handle->fft_hdl));
+
 	/* Now free main handle */
 	free(cast_handle);
 
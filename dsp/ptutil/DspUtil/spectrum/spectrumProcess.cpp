@@ -26,7 +26,8 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 /*
  * FUNCTION: spectrumProcess()
  * DESCRIPTION:
- *  Calculates the spectrum values for the passed buffer.
+ *  Calculates the spectrum values for the passed buffer. In SPECTRUM_MODE_FFT the buffer is
+ *  only stored for spectrumAnalyze().
  */
 int PT_DECLSPEC spectrumProcess(PT_HANDLE *hp_spectrum,
 							/* Input Signal Info */
@@ -38,7 +39,7 @@ int PT_DECLSPEC spectrumProcess(PT_HANDLE *hp_spectrum,
 					 	)
 {
 	struct spectrumHdlType *cast_handle;
-	int i, j;
+	int i;
 	int delay_index;
 	int loop_inc;
 
@@ -60,36 +61,15 @@ int PT_DECLSPEC spectrumProcess(PT_HANDLE *hp_spectrum,
 	// Increment thru data based on current sampling frequency determined data reduction rate
 	loop_inc = cast_handle->internal_rate_ratio;
 
-	for(i=0; i<i_num_sample_sets; i += loop_inc)
+	// In fft mode the samples are only stored, spectrumAnalyze() does the rest off the audio thread
+	if( cast_handle->mode == SPECTRUM_MODE_FFT )
 	{
-		realtype in;
-		realtype input_sum;
-
-		if(i_num_channels == 2)
-			in = rp_signal[i * 2] + rp_signal[i * 2 + 1];
-		else
-			in = rp_signal[i];
-
-		if (i_processing_on)
-		{
-			// Note all filters use same in and in_2, filter needs them as a difference (see design notes)
-			input_sum = in - cast_handle->in_2;
-		}
-		else
-		{
-			// If processing is currently off, then set input to filter to 0.0
-			input_sum = (realtype)0.0;
-		}
-
-		for(j=0; j<SPECTRUM_MAX_NUM_BANDS; j++)
-			spectrum_UpdateFilter(input_sum, &(cast_handle->sFilt[j]),
-			                      cast_handle->alpha, cast_handle->one_minus_alpha );
-
-		// Shift input signals
-		cast_handle->in_2 = cast_handle->in_1;
-		cast_handle->in_1 = in;
+		spectrum_WriteRing(cast_handle, rp_signal, i_num_sample_sets, i_num_channels, loop_inc, i_processing_on);
+		return(OKAY);
 	}
 
+	spectrum_ProcessFilters(cast_handle, rp_signal, i_num_sample_sets, i_num_channels, loop_inc, i_processing_on);
+
 	// Check to see if its time to do a buffer update cycle
 	// On average this will be done at the period set by cast_handle->
 	cast_handle->time_since_last_buffer_store += cast_handle->internal_samp_period * i_num_sample_sets/loop_inc;
@@ -100,103 +80,31 @@ int PT_DECLSPEC spectrumProcess(PT_HANDLE *hp_spectrum,
 
 		// Store band values in delay buffer
 		for(i=0; i<SPECTRUM_MAX_NUM_BANDS; i++)
-			cast_handle->band_buf[ cast_handle->buffer_index + i ] = cast_handle->sFilt[i].level;
+			cast_handle->band_buf[ cast_handle->buffer_index + i ] = cast_handle->filt.level[i];
 
 		delay_index = (cast_handle->buffer_index - cast_handle->delay_count * SPECTRUM_MAX_NUM_BANDS);
 
 		if(delay_index < 0)
-			delay_index += SPECTRUM_MAX_NUM_BANDS * (int)SPECTRUM_MAX_BAND_BUFFER_LEN;
+			delay_index += SPECTRUM_MAX_NUM_BANDS * cast_handle->band_buf_num_sets;
 
 		// Protect against index still being too small
 		if(delay_index < 0)
 			delay_index = 0;
 
-		// If processing is off, zero all buffer values behind just stored values
-		if( !i_processing_on )
-		{
-			int next_buffer_index;
-
-			next_buffer_index = cast_handle->buffer_index + SPECTRUM_MAX_NUM_BANDS;
-
-			if( cast_handle->buffer_index > delay_index )
-			{
-				// Check to see if only one set remains at end of buffer
-				if( next_buffer_index < (int)(SPECTRUM_MAX_BAND_BUFFER_LEN) * SPECTRUM_MAX_NUM_BANDS )
-				{
-					// Zero values ahead of buffer_index
-					for( i= next_buffer_index; i<(int)(SPECTRUM_MAX_BAND_BUFFER_LEN) * SPECTRUM_MAX_NUM_BANDS; i++)
-						cast_handle->band_values[i] = 0;
-				}
-
-				// Zero values behind delay_index
-				for(i=0; i<delay_index; i++)
-					cast_handle->band_values[i] = 0;
-			}
-			else
-			{
-				// Zero values between buffer_index and delay_index
-				if( next_buffer_index < (int)(SPECTRUM_MAX_BAND_BUFFER_LEN) * SPECTRUM_MAX_NUM_BANDS )
-					for(i=next_buffer_index; i<delay_index; i++)
-						cast_handle->band_values[i] = 0;
-			}
-		}
+		// Note - the set read back is always the one stored delay_count refreshes ago, or zeros
+		// after a reset, so nothing needs zeroing when processing is off. The levels decay
+		// to zero on their own since the filters are fed silence in that case.
 
 		// Assign delayed band values
 		for(i=0; i<SPECTRUM_MAX_NUM_BANDS; i++)
 			cast_handle->band_values[i] = cast_handle->band_buf[delay_index + i];
 
+		spectrum_PublishBandValues(cast_handle);
+
 		cast_handle->buffer_index += SPECTRUM_MAX_NUM_BANDS;
-		if(cast_handle->buffer_index >= ( (int)(SPECTRUM_MAX_BAND_BUFFER_LEN) * SPECTRUM_MAX_NUM_BANDS ) )
+		if(cast_handle->buffer_index >= ( cast_handle->band_buf_num_sets * SPECTRUM_MAX_NUM_BANDS ) )
 			cast_handle->buffer_index = 0;
 	}
 
 	return(OKAY);
 }
-
-inline void spectrum_UpdateFilter(realtype r_input_sum, struct spectrumFiltType *sFilt, realtype r_alpha, realtype r_one_minus_alpha)
-{
-	realtype tmp;
-
-	// Implements a simple 2 pole resonant filter
-	// Include bias to eliminate Intel underflow problems.
-	sFilt->out = r_input_sum + sFilt->a1 * sFilt->y1 + sFilt->a2 * sFilt->y2 + (float)1.0e-5;
-	sFilt->y2 = sFilt->y1;
-	sFilt->y1 = sFilt->out;
-	sFilt->out *= sFilt->gain;
-
-	tmp = sFilt->out * sFilt->out;
-
-	// Bias above appears to eliminate the need for bias on the next calculation
-	// sFilt->squared_filtered = r_one_minus_alpha * tmp + r_alpha * sFilt->squared_filtered + (float)1.0e-5;
-	sFilt->squared_filtered = r_one_minus_alpha * tmp + r_alpha * sFilt->squared_filtered;
-
-	if( sFilt->squared_filtered > (realtype)SPECTRUM_MAX_OUTPUT_VALUE )
-		sFilt->level = (realtype)SPECTRUM_MAX_OUTPUT_VALUE;
-	else
-	{
-		// Using an inlined version of a square root approximation from the mth module.
-		// This approximation can improve performance as much as 10 times for signals smaller than zero.
-		// Error is typically no more than 6%
-        union
-        {
-                int tmp;
-                float x;
-        } u;
-        u.x = sFilt->squared_filtered;
-        u.tmp -= 1<<23; /* Remove last bit so 1.0 gives 1.0 */
-        /* tmp is now an approximation to logbase2(r_x) */
-        u.tmp >>= 1; /* divide by 2 */
-        u.tmp += 1<<29; /* add 64 to exponent: (e+127)/2 =(e/2)+63, */
-        /* that represents (e/2)-64 but we want e/2 */
-        sFilt->level = u.x;
-	}
-}
-
-void spectrum_ResetFilter(struct spectrumFiltType *sFilt)
-{
-	sFilt->out = (realtype)0.0;
-	sFilt->y2 = (realtype)0.0;
-	sFilt->y1 = (realtype)0.0;
-	sFilt->level = (realtype)0.0;
-	sFilt->squared_filtered = (realtype)0.0;
-}
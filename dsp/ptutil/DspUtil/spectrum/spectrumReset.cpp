@@ -41,8 +41,10 @@ int PT_DECLSPEC spectrumReset( PT_HANDLE *hp_spectrum )
 	if (cast_handle == NULL)
 		return(NOT_OKAY);
 
-	// For now only supports a single fixed number of bands
-	if( cast_handle->num_bands != SPECTRUM_MAX_NUM_BANDS )
+	// The filter bank only supports a single fixed number of bands
+	if( ((cast_handle->mode == SPECTRUM_MODE_FILTER_BANK) && (cast_handle->num_bands != SPECTRUM_MAX_NUM_BANDS)) ||
+		 ((cast_handle->mode == SPECTRUM_MODE_FFT) &&
+		  ((cast_handle->num_bands < SPECTRUM_FFT_MIN_NUM_BANDS) || (cast_handle->num_bands > SPECTRUM_FFT_MAX_NUM_BANDS))) )
 	{
 		sprintf(cast_handle->msg1, "Illegal number of bands (%d) in spectrumReset", cast_handle->num_bands);
 		(cast_handle->slout_hdl)->Message(FIRST_LINE, cast_handle->msg1);
@@ -89,14 +91,18 @@ int PT_DECLSPEC spectrumReset( PT_HANDLE *hp_spectrum )
 	cast_handle->in_1 = (realtype)0.0;
 	cast_handle->in_2 = (realtype)0.0;
 
-	for(i=0; i<cast_handle->num_bands; i++)
-	{
-		cast_handle->band_values[i] = (realtype)0.0;
-		spectrum_ResetFilter( &(cast_handle->sFilt[i]) );
-	}
+	spectrum_ResetFilters( &(cast_handle->filt) );
+
+	// Discard the fft mode samples, the analysis picks up the new rate on its next call. The band
+	// values belong to the analysis thread in fft mode, so they are only cleared for the filter bank.
+	if( cast_handle->mode == SPECTRUM_MODE_FFT )
+		spectrum_ResetRing(cast_handle);
+	else
+		spectrum_ClearBandValues(cast_handle);
 
-	for(i=0; i<(SPECTRUM_MAX_NUM_BANDS * (int)SPECTRUM_MAX_BAND_BUFFER_LEN); i++)
+	for(i=0; i<(SPECTRUM_MAX_NUM_BANDS * cast_handle->band_buf_num_sets); i++)
 		cast_handle->band_buf[i] = (realtype)0.0;
+	cast_handle->buffer_index = 0;
 
 	// Bands are logarithmically spaced from 100 hz. to 10,000 hz.
 	// ORIGINAL 5 BAND LOCATIONS
@@ -115,54 +121,54 @@ int PT_DECLSPEC spectrumReset( PT_HANDLE *hp_spectrum )
 	// See design results below.
 
 	// First band
-	cast_handle->sFilt[0].a1 = (realtype)1.9952707978;
-	cast_handle->sFilt[0].a2 = (realtype)-0.9953348411;
-	cast_handle->sFilt[0].gain = (cast_handle->sensitivity * (realtype)SPECTRUM_BAND_1_WARP)/((realtype)cast_handle->num_channels * (realtype)4.245657595e+02);
+	cast_handle->filt.a1[0] = (realtype)1.9952707978;
+	cast_handle->filt.a2[0] = (realtype)-0.9953348411;
+	cast_handle->filt.gain[0] = (cast_handle->sensitivity * (realtype)SPECTRUM_BAND_1_WARP)/((realtype)cast_handle->num_channels * (realtype)4.245657595e+02);
 	
 	// Second band
-	cast_handle->sFilt[1].a1 = (realtype)1.9915173377;
-	cast_handle->sFilt[1].a2 = (realtype)-0.9917194870;
-	cast_handle->sFilt[1].gain = (cast_handle->sensitivity * (realtype)SPECTRUM_BAND_2_WARP)/((realtype)cast_handle->num_channels * (realtype)2.391965397e+02);
+	cast_handle->filt.a1[1] = (realtype)1.9915173377;
+	cast_handle->filt.a2[1] = (realtype)-0.9917194870;
+	cast_handle->filt.gain[1] = (cast_handle->sensitivity * (realtype)SPECTRUM_BAND_2_WARP)/((realtype)cast_handle->num_channels * (realtype)2.391965397e+02);
 	
 	// Third band
-	cast_handle->sFilt[2].a1 = (realtype)1.9846835136;
-	cast_handle->sFilt[2].a2 = (realtype)-0.9853206989;
-	cast_handle->sFilt[2].gain = (cast_handle->sensitivity * (realtype)SPECTRUM_BAND_3_WARP)/((realtype)cast_handle->num_channels * (realtype)1.349296378e+02);
+	cast_handle->filt.a1[2] = (realtype)1.9846835136;
+	cast_handle->filt.a2[2] = (realtype)-0.9853206989;
+	cast_handle->filt.gain[2] = (cast_handle->sensitivity * (realtype)SPECTRUM_BAND_3_WARP)/((realtype)cast_handle->num_channels * (realtype)1.349296378e+02);
 
 	// Fourth band
-	cast_handle->sFilt[3].a1 = (realtype)1.9720410075;
-	cast_handle->sFilt[3].a2 = (realtype)-0.9740444157;
-	cast_handle->sFilt[3].gain = (cast_handle->sensitivity * (realtype)SPECTRUM_BAND_4_WARP)/((realtype)cast_handle->num_channels * (realtype)7.631087758e+01);
+	cast_handle->filt.a1[3] = (realtype)1.9720410075;
+	cast_handle->filt.a2[3] = (realtype)-0.9740444157;
+	cast_handle->filt.gain[3] = (cast_handle->sensitivity * (realtype)SPECTRUM_BAND_4_WARP)/((realtype)cast_handle->num_channels * (realtype)7.631087758e+01);
 
 	// Fifth band
-	cast_handle->sFilt[4].a1 = (realtype)1.9480305935;
-	cast_handle->sFilt[4].a2 = (realtype)-0.9543009461;
-	cast_handle->sFilt[4].gain = (cast_handle->sensitivity * (realtype)SPECTRUM_BAND_5_WARP)/((realtype)cast_handle->num_channels * (realtype)4.334342216e+01);
+	cast_handle->filt.a1[4] = (realtype)1.9480305935;
+	cast_handle->filt.a2[4] = (realtype)-0.9543009461;
+	cast_handle->filt.gain[4] = (cast_handle->sensitivity * (realtype)SPECTRUM_BAND_5_WARP)/((realtype)cast_handle->num_channels * (realtype)4.334342216e+01);
 
 	// Sixth band
-	cast_handle->sFilt[5].a1 = (realtype)1.9006550741;
-	cast_handle->sFilt[5].a2 = (realtype)-0.9201218454;
-	cast_handle->sFilt[5].gain = (cast_handle->sensitivity * (realtype)SPECTRUM_BAND_6_WARP)/((realtype)cast_handle->num_channels * (realtype)2.479951362e+01);
+	cast_handle->filt.a1[5] = (realtype)1.9006550741;
+	cast_handle->filt.a2[5] = (realtype)-0.9201218454;
+	cast_handle->filt.gain[5] = (cast_handle->sensitivity * (realtype)SPECTRUM_BAND_6_WARP)/((realtype)cast_handle->num_channels * (realtype)2.479951362e+01);
 
 	// Seventh band
-	cast_handle->sFilt[6].a1 = (realtype)1.8025225345;
-	cast_handle->sFilt[6].a2 = (realtype)-0.8620772515;
-	cast_handle->sFilt[6].gain = (cast_handle->sensitivity * (realtype)SPECTRUM_BAND_7_WARP)/((realtype)cast_handle->num_channels * (realtype)1.436694455e+01);
+	cast_handle->filt.a1[6] = (realtype)1.8025225345;
+	cast_handle->filt.a2[6] = (realtype)-0.8620772515;
+	cast_handle->filt.gain[6] = (cast_handle->sensitivity * (realtype)SPECTRUM_BAND_7_WARP)/((realtype)cast_handle->num_channels * (realtype)1.436694455e+01);
 
 	// Eighth band
-	cast_handle->sFilt[7].a1 = (realtype)1.5891186613;
-	cast_handle->sFilt[7].a2 = (realtype)-0.7664106181;
-	cast_handle->sFilt[7].gain = (cast_handle->sensitivity * (realtype)SPECTRUM_BAND_8_WARP)/((realtype)cast_handle->num_channels * (realtype)8.490790030e+00);
+	cast_handle->filt.a1[7] = (realtype)1.5891186613;
+	cast_handle->filt.a2[7] = (realtype)-0.7664106181;
+	cast_handle->filt.gain[7] = (cast_handle->sensitivity * (realtype)SPECTRUM_BAND_8_WARP)/((realtype)cast_handle->num_channels * (realtype)8.490790030e+00);
 
 	// Nineth band
-	cast_handle->sFilt[8].a1 = (realtype)1.1149497494;
-	cast_handle->sFilt[8].a2 = (realtype)-0.6153052550;
-	cast_handle->sFilt[8].gain = (cast_handle->sensitivity * (realtype)SPECTRUM_BAND_9_WARP)/((realtype)cast_handle->num_channels * (realtype)5.169741233e+00);
+	cast_handle->filt.a1[8] = (realtype)1.1149497494;
+	cast_handle->filt.a2[8] = (realtype)-0.6153052550;
+	cast_handle->filt.gain[8] = (cast_handle->sensitivity * (realtype)SPECTRUM_BAND_9_WARP)/((realtype)cast_handle->num_channels * (realtype)5.169741233e+00);
 
 	// Tenth band
-	cast_handle->sFilt[9].a1 = (realtype)0.1311997923;
-	cast_handle->sFilt[9].a2 = (realtype)-0.3874425954;
-	cast_handle->sFilt[9].gain = (cast_handle->sensitivity * (realtype)SPECTRUM_BAND_10_WARP)/((realtype)cast_handle->num_channels * (realtype)3.264452631e+00);
+	cast_handle->filt.a1[9] = (realtype)0.1311997923;
+	cast_handle->filt.a2[9] = (realtype)-0.3874425954;
+	cast_handle->filt.gain[9] = (cast_handle->sensitivity * (realtype)SPECTRUM_BAND_10_WARP)/((realtype)cast_handle->num_channels * (realtype)3.264452631e+00);
 
 	return(OKAY);
 }
@@ -103,5 +103,66 @@ int PT_DECLSPEC spectrumSetDelay(PT_HANDLE *hp_spectrum, realtype r_delay_secs)
 
 	cast_handle->delay_count = (int)( r_delay_secs/cast_handle->refresh_rate_secs + (float)0.5 );
 
+	// The band delay line and the fft mode ring are sized for SPECTRUM_MAX_DELAY_SECS by spectrumNew()
+	// and spectrumSetMode(), so this is safe on the audio thread from spectrumReset()
+	if( (cast_handle->delay_count + 1) > cast_handle->band_buf_num_sets )
+		return(NOT_OKAY);
+
+	return(OKAY);
+}
+
+/*
+ * FUNCTION: spectrumSetMode()
+ * DESCRIPTION:
+ *  Selects the resonant filter bank, run per sample by spectrumProcess(), or the fft analysis run by
+ *  spectrumAnalyze(), and the number of bands. The filter bank only supports SPECTRUM_MAX_NUM_BANDS,
+ *  the fft analysis supports SPECTRUM_FFT_MIN_NUM_BANDS to SPECTRUM_FFT_MAX_NUM_BANDS log spaced bands.
+ *  Changing the mode must not be done while spectrumProcess() runs on another thread. In fft mode the
+ *  band count can be changed at any time from the thread that calls spectrumAnalyze().
+ */
+int PT_DECLSPEC spectrumSetMode(PT_HANDLE *hp_spectrum, int i_mode, int i_num_bands)
+{
+	struct spectrumHdlType *cast_handle;
+
+	cast_handle = (struct spectrumHdlType *)(hp_spectrum);
+ 
+	if (cast_handle == NULL)
+		return(NOT_OKAY);
+
+	if( i_mode == SPECTRUM_MODE_FILTER_BANK )
+	{
+		if( i_num_bands != SPECTRUM_MAX_NUM_BANDS )
+			return(NOT_OKAY);
+	}
+	else if( i_mode == SPECTRUM_MODE_FFT )
+	{
+		if( (i_num_bands < SPECTRUM_FFT_MIN_NUM_BANDS) || (i_num_bands > SPECTRUM_FFT_MAX_NUM_BANDS) )
+			return(NOT_OKAY);
+	}
+	else
+		return(NOT_OKAY);
+
+	// Only the analysis uses the band count in fft mode, it sets itself up again on its next call
+	if( (i_mode == SPECTRUM_MODE_FFT) && (cast_handle->mode == SPECTRUM_MODE_FFT) )
+	{
+		cast_handle->num_bands = i_num_bands;
+		spectrum_ClearBandValues(cast_handle);
+		return(OKAY);
+	}
+
+	cast_handle->mode = i_mode;
+	cast_handle->num_bands = i_num_bands;
+
+	if( i_mode == SPECTRUM_MODE_FFT )
+		if( spectrum_AllocateRing(cast_handle) != OKAY )
+			return(NOT_OKAY);
+
+	if( spectrumReset(hp_spectrum) != OKAY )
+		return(NOT_OKAY);
+
+	// Readers get the new band count straight away, not after the first analysis
+	if( i_mode == SPECTRUM_MODE_FFT )
+		spectrum_ClearBandValues(cast_handle);
+
 	return(OKAY);
 }
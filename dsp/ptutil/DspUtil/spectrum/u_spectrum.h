@@ -18,6 +18,8 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #ifndef _U_SPECTRUM_H_
 #define _U_SPECTRUM_H_
 
+#include <atomic>
+
 #include "spectrum.h"
 #include "slout.h"
 #include "sos.h"
@@ -30,22 +32,46 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #define SPECTRUM_MAXIMUM_SAMP_FREQ				192000.0
 #define SPECTRUM_MAXIMUM_INTERNAL_SAMP_FREQ  48000.0
 
+/*
+ * Fft analysis. The audio thread only writes the decimated mono signal into a ring, the
+ * analysis is done by spectrumAnalyze() on the thread that reads the band values. Bands are
+ * log spaced over the range covered by the filter bank bands.
+ */
+#define SPECTRUM_FFT_SIZE            4096
+#define SPECTRUM_FFT_NUM_BINS        (SPECTRUM_FFT_SIZE / 2 + 1)
+#define SPECTRUM_FFT_MIN_FREQ        42.17		// Lower -3db point of the first filter bank band
+#define SPECTRUM_FFT_MAX_FREQ        13335.21	// Upper -3db point of the last filter bank band
+#define SPECTRUM_FFT_ATTACK_FACTOR   4.0		// Rising levels follow this many times faster than the time constant
+#define SPECTRUM_FFT_RING_MARGIN_SECS 0.25	// Audio that can be written while the analysis copies its window
+
+/* Triple buffer exchange slot, index of the frame plus a flag set when it holds a frame not yet read */
+#define SPECTRUM_FRAME_INDEX_MASK 0x3
+#define SPECTRUM_FRAME_NEW        0x4
+
 /* Bit location used for true silence flag in LPARAM message word */
 #define SPECTRUM_TRUE_SILENCE_BIT_LOCATION 0x2000000
 
-#define SPECTRUM_MIN_BUFFER_SIZE 128
-#define SPECTRUM_MAX_BAND_BUFFER_LEN ( ((SPECTRUM_MAXIMUM_SAMP_FREQ * SPECTRUM_MAX_DELAY_SECS)/SPECTRUM_MIN_BUFFER_SIZE) + 1)
 
-struct spectrumFiltType
+/* Filter bank bands rounded up to a whole number of SSE registers, the extra lanes have zero gain */
+#define SPECTRUM_FILT_NUM_LANES 12
+
+/* Filter bank resonant filters as a structure of arrays, element j of each array is band j */
+struct spectrumFiltBankType
 {
-	realtype a1;
-	realtype a2;
-	realtype gain;
-	realtype y1;
-	realtype y2;
-	realtype out;
-	realtype level;
-	realtype squared_filtered;
+	realtype a1[SPECTRUM_FILT_NUM_LANES];
+	realtype a2[SPECTRUM_FILT_NUM_LANES];
+	realtype gain[SPECTRUM_FILT_NUM_LANES];
+	realtype y1[SPECTRUM_FILT_NUM_LANES];
+	realtype y2[SPECTRUM_FILT_NUM_LANES];
+	realtype squared_filtered[SPECTRUM_FILT_NUM_LANES];
+	realtype level[SPECTRUM_FILT_NUM_LANES];
+};
+
+/* One complete set of band values handed to the reader */
+struct spectrumFrameType
+{
+	realtype band_values[SPECTRUM_FFT_MAX_NUM_BANDS];
+	int num_bands;
 };
 
 /* Configuration Handle definition */
@@ -55,7 +81,7 @@ struct spectrumHdlType
    char msg1[1024]; /* String for messages */
 	int trace_mode;
 
-	struct spectrumFiltType sFilt[SPECTRUM_MAX_NUM_BANDS];
+	struct spectrumFiltBankType filt;
 
 	int num_bands;
 	int num_channels;
@@ -76,9 +102,12 @@ struct spectrumHdlType
 	realtype refresh_rate_secs;
 	realtype time_since_last_buffer_store;
 
-	realtype band_values[SPECTRUM_MAX_NUM_BANDS];
+	realtype band_values[SPECTRUM_FFT_MAX_NUM_BANDS];
 
-	realtype band_buf[SPECTRUM_MAX_NUM_BANDS * (int)(SPECTRUM_MAX_BAND_BUFFER_LEN)];
+	// Delay line of stored band value sets, one set per refresh. Allocated by spectrumNew()
+	// to hold the sets of SPECTRUM_MAX_DELAY_SECS, only delay_count + 1 of them are used.
+	realtype *band_buf;
+	int band_buf_num_sets;
 
 	// Since filters run in parallel they can share common input vals
 	realtype in_1, in_2;
@@ -87,10 +116,51 @@ struct spectrumHdlType
 	realtype time_constant;
 	realtype alpha;
 	realtype one_minus_alpha;
+
+	int mode;		// SPECTRUM_MODE_FILTER_BANK or SPECTRUM_MODE_FFT
+
+	// Fft mode sample ring, written only by spectrumProcess(). Allocated by spectrumSetMode()
+	// to hold the longest delay, one fft and the margin at the max internal rate.
+	realtype *ring;
+	int ring_size;		// Power of 2
+	std::atomic<unsigned int> ring_write_count;	// Samples written, the ring index is this masked by ring_size - 1
+	std::atomic<unsigned int> ring_reset_count;	// ring_write_count at the last spectrumReset(), older samples read as zero
+
+	// Fft mode analysis, only used by spectrumAnalyze()
+	PT_HANDLE *fft_hdl;
+	realtype fft_window[SPECTRUM_FFT_SIZE];
+	realtype fft_window_power;		// Sum of the squared window
+	realtype fft_in[SPECTRUM_FFT_SIZE];
+	realtype fft_re[SPECTRUM_FFT_NUM_BINS];
+	realtype fft_im[SPECTRUM_FFT_NUM_BINS];
+	realtype analysis_samp_freq;	// Rate and band count the band bins were set up for
+	int analysis_num_bands;
+	int band_first_bin[SPECTRUM_FFT_MAX_NUM_BANDS];
+	int band_last_bin[SPECTRUM_FFT_MAX_NUM_BANDS];
+	realtype band_warp[SPECTRUM_FFT_MAX_NUM_BANDS];
+	realtype band_power[SPECTRUM_FFT_MAX_NUM_BANDS];	// Mean square after the ballistics
+	unsigned int last_analysis_count;	// ring_write_count at the last analysis
+	unsigned int analysis_reset_count;	// ring_reset_count the band powers were built after
+
+	// Triple buffer of band value frames. The thread producing the band values, spectrumProcess() in
+	// filter bank mode and spectrumAnalyze() in fft mode, fills the write frame and swaps it with the
+	// exchange slot. spectrumGetBandValues() swaps its read frame with the exchange slot when that
+	// holds a new frame. Neither side ever waits, and the reader always gets a complete frame.
+	struct spectrumFrameType frames[3];
+	std::atomic<int> frame_exchange;
+	int frame_write_index;	// Only used by the producing thread
+	int frame_read_index;	// Only used by spectrumGetBandValues()
 };
 
 // Local functions
-inline void spectrum_UpdateFilter(realtype r_input_sum, struct spectrumFiltType *sFilt, realtype r_alpha, realtype r_one_minus_alpha);
-void spectrum_ResetFilter(struct spectrumFiltType *sFilt);
+void spectrum_PublishBandValues(struct spectrumHdlType *cast_handle);
+void spectrum_ClearBandValues(struct spectrumHdlType *cast_handle);
+void spectrum_ResetFilters(struct spectrumFiltBankType *sp_filt);
+void spectrum_ProcessFilters(struct spectrumHdlType *cast_handle, realtype *rp_signal, int i_num_sample_sets, int i_num_channels,
+									  int i_loop_inc, int i_processing_on);
+int spectrum_AllocateRing(struct spectrumHdlType *cast_handle);
+void spectrum_ResetRing(struct spectrumHdlType *cast_handle);
+void spectrum_WriteRing(struct spectrumHdlType *cast_handle, realtype *rp_signal, int i_num_sample_sets, int i_num_channels,
+								int i_loop_inc, int i_processing_on);
 
 #endif /* _U_SPECTRUM_H_ */
\ No newline at end of file
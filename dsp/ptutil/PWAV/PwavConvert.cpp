@@ -47,7 +47,7 @@ int PT_DECLSPEC pwav24BitToFloat(char *cp_24_bit, realtype *rp_float,
 							int i_length, int i_stereo_flag)
 {
 	int i;
-	long itmp;
+	int itmp = 0; /* 32 bits on every target, long is 64 bits on LP64 */
    
 	if (i_stereo_flag)
 		i_length *= 2;
@@ -73,7 +73,7 @@ int PT_DECLSPEC pwavFloatTo24Bit(realtype *rp_float, char *cp_24_bit,
 							int i_length, int i_stereo_flag)
 {
 	int i;
-	long itmp;
+	int itmp = 0;
    
 	if (i_stereo_flag)
 		i_length *= 2;
@@ -36,9 +36,10 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
  * DESCRIPTION:
  *   Processes the passed in buffer using the current sos handle settings.
  *   This function is for mono or stereo signals only.
- *   This version uses a DC bias component to avoid underflow problems.
+ *   Underflow is handled by the FTZ/DAZ mode set around the processing calls, see realSampleDenormals.cpp.
  *   PTNOTE- this appears to have a serious problem with shelf functions, the processing
  *   method uses a form specific to the coeff symmetry that occurs with parametric filters.
+ *   Stereo buffers use the vectorized cascade in SosProcessSimd.cpp when the cpu supports it.
  */
 int PT_DECLSPEC sosProcessBuffer(PT_HANDLE *hp_sos, realtype *rp_in_buf, realtype *rp_out_buf, int i_num_sample_sets, int i_num_channels)
 {
@@ -56,8 +57,31 @@ int PT_DECLSPEC sosProcessBuffer(PT_HANDLE *hp_sos, realtype *rp_in_buf, realtyp
 	if( (i_num_channels != 1) && (i_num_channels != 2) )
 		return(NOT_OKAY);
 
-	k = 0;
-	for(j=0; j<i_num_sample_sets; j++)
+	/* Sample sets already handled by the vectorized cascade */
+	int i_num_simd_sets = 0;
+
+#ifndef SOS_DO_DC_BLOCKING
+	if( (i_num_channels == 2) && (sos_GetSimdLevel() >= SOS_SIMD_SSE2) )
+	{
+		if( sos_ProcessStereoCascadeSimd(cast_handle, rp_in_buf, rp_out_buf, i_num_sample_sets) != OKAY )
+			return(NOT_OKAY);
+
+		for(j=0, k=0; j<i_num_sample_sets; j++, k+=2)
+		{
+			rp_out_buf[k] = rp_out_buf[k] * cast_handle->master_gain;
+			rp_out_buf[k+1] = rp_out_buf[k+1] * cast_handle->master_gain;
+
+			if (cast_handle->target_rms != 0.0f)
+			{
+				sum_squares += (rp_out_buf[k] * rp_out_buf[k]) + (rp_out_buf[k + 1] * rp_out_buf[k + 1]);
+			}
+		}
+		i_num_simd_sets = i_num_sample_sets;
+	}
+#endif //SOS_DO_DC_BLOCKING
+
+	k = i_num_simd_sets * i_num_channels;
+	for(j=i_num_simd_sets; j<i_num_sample_sets; j++)
 	{
 		realtype in1, in2, out1, out2;
 		int active_flag;
@@ -88,7 +112,7 @@ int PT_DECLSPEC sosProcessBuffer(PT_HANDLE *hp_sos, realtype *rp_in_buf, realtyp
 					s = &((cast_handle->sections)[i]);
 
 					/* Processing derived from macro kerSosFiltDirectForm2TransParaExtState */
-					out1 = s->state1 + s->b0 * in1 + (realtype)SOS_FLOAT_BIAS;
+					out1 = s->state1 + s->b0 * in1;
 					s->state1 = (in1 - out1) * s->b1 + s->state2;
 					s->state2 = s->b2 * in1 - s->a2 * out1;
 
@@ -131,13 +155,13 @@ int PT_DECLSPEC sosProcessBuffer(PT_HANDLE *hp_sos, realtype *rp_in_buf, realtyp
 					s = &((cast_handle->sections)[i]);
 
 					/* Processing derived from macro kerSosFiltDirectForm2TransParaExtState */
-					out1 = s->state1 + s->b0 * in1 + (realtype)SOS_FLOAT_BIAS;
+					out1 = s->state1 + s->b0 * in1;
 					s->state1 = (in1 - out1) * s->b1 + s->state2;
 					s->state2 = s->b2 * in1 - s->a2 * out1;
 
 					in1 = out1;
 
-					out2 = s->state3 + s->b0 * in2 + (realtype)SOS_FLOAT_BIAS;
+					out2 = s->state3 + s->b0 * in2;
 					s->state3 = (in2 - out2) * s->b1 + s->state4;
 					s->state4 = s->b2 * in2 - s->a2 * out2;
 
@@ -316,6 +340,11 @@ int PT_DECLSPEC sosProcessSurroundBuffer(PT_HANDLE *hp_sos, realtype *rp_in_buf,
 	if( (i_num_channels != 6) && (i_num_channels != 8) )
 		return(NOT_OKAY);
 
+	/* Vectorized version, lanes are the channels of a frame */
+	int i_simd_level = sos_GetSimdLevel();
+	if( i_simd_level >= SOS_SIMD_SSE2 )
+		return( sos_ProcessSurroundCascadeSimd(cast_handle, rp_in_buf, rp_out_buf, i_num_sample_sets, i_num_channels, i_simd_level) );
+
 	//Ordering for 5.1 is: Front Left, Front Right, Front Center, Low Frequency, Back Left, Back Right
 	//Ordering for 7.1 is: Front Left, Front Right, Front Center, Low Frequency, Back Left, Back Right, Side Left, Side Right
 	//Note - LFE channel only gets bands 0,1 others only get bands 2->max
@@ -353,7 +382,7 @@ int PT_DECLSPEC sosProcessSurroundBuffer(PT_HANDLE *hp_sos, realtype *rp_in_buf,
 					s = &((cast_handle->sections)[i]);
 
 					/* Processing derived from macro kerSosFiltDirectForm2TransParaExtState */
-					out = s->state_1[k] + s->b0 * in  + (realtype)SOS_FLOAT_BIAS;
+					out = s->state_1[k] + s->b0 * in;
 					s->state_1[k] = (in - out) * s->b1 + s->state_2[k];
 					s->state_2[k] = s->b2 * in - s->a2 * out;
 
@@ -0,0 +1,407 @@
+/*
+FxSound
+Copyright (C) 2025  FxSound LLC
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/* Standard includes */
+#include <math.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "codedefs.h"
+#include "slout.h"
+#include "vals.h"
+#include "mry.h"
+#include "filt.h"
+#include "sos.h"
+#include "u_sos.h"
+
+/*
+ * Vectorized versions of the sos cascades. The cascade is run one section at a time over the
+ * whole buffer so the coefficients and filter states stay in registers, with the channels of a
+ * frame sharing one register. Each lane does exactly the same transposed form operations, in the
+ * same order, as the scalar code in SosProcess.cpp, so the results are bit identical.
+ * Only built for x86/x64, other targets always use the scalar code.
+ */
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define SOS_SIMD_X86
+#endif
+
+#ifdef SOS_SIMD_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define SOS_AVX_FUNCTION
+#else
+#include <cpuid.h>
+#define SOS_AVX_FUNCTION __attribute__((target("avx")))
+#endif
+#endif
+
+/* Level supported by the cpu, -1 until first queried */
+static int sos_cpu_simd_level = -1;
+
+/* Highest level callers allow, lowered by benchmarks to compare against the scalar code */
+static int sos_max_simd_level = SOS_SIMD_AVX;
+
+/*
+ * FUNCTION: sos_DetectCpuSimdLevel()
+ * DESCRIPTION:
+ *   Returns the highest instruction set level usable on this cpu. AVX also requires the OS
+ *   to save the ymm registers, which is checked through xgetbv.
+ */
+static int sos_DetectCpuSimdLevel(void)
+{
+	int level = SOS_SIMD_NONE;
+
+#ifdef SOS_SIMD_X86
+	unsigned int ecx, edx;
+
+#ifdef _MSC_VER
+	int info[4];
+	__cpuid(info, 1);
+	ecx = (unsigned int)info[2];
+	edx = (unsigned int)info[3];
+#else
+	unsigned int eax, ebx;
+	if( !__get_cpuid(1, &eax, &ebx, &ecx, &edx) )
+		return(SOS_SIMD_NONE);
+#endif
+
+	/* SSE2 */
+	if( edx & (1u << 26) )
+		level = SOS_SIMD_SSE2;
+
+	/* OSXSAVE and AVX */
+	if( (level == SOS_SIMD_SSE2) && (ecx & (1u << 27)) && (ecx & (1u << 28)) )
+	{
+		unsigned long long xcr0;
+#ifdef _MSC_VER
+		xcr0 = _xgetbv(0);
+#else
+		unsigned int lo, hi;
+		__asm__ __volatile__("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+		xcr0 = ((unsigned long long)hi << 32) | lo;
+#endif
+		/* xmm and ymm state enabled */
+		if( (xcr0 & 0x6) == 0x6 )
+			level = SOS_SIMD_AVX;
+	}
+#endif
+
+	return(level);
+}
+
+/*
+ * FUNCTION: sos_GetSimdLevel()
+ * DESCRIPTION:
+ *   Returns the level the processing functions should use, the cpu level limited by the
+ *   level set with sosSetMaxSimdLevel().
+ */
+int sos_GetSimdLevel(void)
+{
+	/* Detection always gives the same answer, so a race on the first call is harmless */
+	if( sos_cpu_simd_level < 0 )
+		sos_cpu_simd_level = sos_DetectCpuSimdLevel();
+
+	if( sos_cpu_simd_level < sos_max_simd_level )
+		return(sos_cpu_simd_level);
+
+	return(sos_max_simd_level);
+}
+
+/*
+ * FUNCTION: sosSetMaxSimdLevel()
+ * DESCRIPTION:
+ *   Limits the instruction set used by the sos processing functions for all handles,
+ *   SOS_SIMD_NONE forces the scalar code. Intended for benchmarking and verification.
+ */
+int PT_DECLSPEC sosSetMaxSimdLevel(int i_level)
+{
+	if( (i_level < SOS_SIMD_NONE) || (i_level > SOS_SIMD_AVX) )
+		return(NOT_OKAY);
+
+	sos_max_simd_level = i_level;
+
+	return(OKAY);
+}
+
+/*
+ * FUNCTION: sosGetSimdLevel()
+ * DESCRIPTION:
+ *   Gets the instruction set level the sos processing functions are currently using.
+ */
+int PT_DECLSPEC sosGetSimdLevel(int *ip_level)
+{
+	*ip_level = sos_GetSimdLevel();
+
+	return(OKAY);
+}
+
+#ifdef SOS_SIMD_X86
+
+/*
+ * FUNCTION: sos_ProcessStereoCascadeSimd()
+ * DESCRIPTION:
+ *   Runs the active sections over an interleaved stereo buffer, left and right in lanes 0 and 1.
+ *   The master gain and normalization are left to the caller.
+ */
+int sos_ProcessStereoCascadeSimd(struct sosHdlType *cast_handle, realtype *rp_in_buf, realtype *rp_out_buf, int i_num_sample_sets)
+{
+	struct sosSectionType *s;
+	realtype *rp_src = rp_in_buf;
+	int i, j, k;
+
+	for(i=0; i<cast_handle->num_active_sections; i++)
+	{
+		int active_flag = cast_handle->section_on_flag[i];
+		if( (i == 0) && cast_handle->disable_band_1 )
+			active_flag = 0;
+
+		if( !active_flag )
+			continue;
+
+		s = &((cast_handle->sections)[i]);
+
+		const __m128 b0 = _mm_set1_ps(s->b0);
+		const __m128 b1 = _mm_set1_ps(s->b1);
+		const __m128 b2 = _mm_set1_ps(s->b2);
+		const __m128 a2 = _mm_set1_ps(s->a2);
+		__m128 st1 = _mm_setr_ps(s->state1, s->state3, 0.0f, 0.0f);
+		__m128 st2 = _mm_setr_ps(s->state2, s->state4, 0.0f, 0.0f);
+
+		for(j=0, k=0; j<i_num_sample_sets; j++, k+=2)
+		{
+			__m128 in = _mm_loadl_pi(_mm_setzero_ps(), (const __m64 *)&(rp_src[k]));
+
+			/* Same operations as the scalar kerSosFiltDirectForm2TransParaExtState form */
+			__m128 out = _mm_add_ps(st1, _mm_mul_ps(b0, in));
+			st1 = _mm_add_ps(_mm_mul_ps(_mm_sub_ps(in, out), b1), st2);
+			st2 = _mm_sub_ps(_mm_mul_ps(b2, in), _mm_mul_ps(a2, out));
+
+			_mm_storel_pi((__m64 *)&(rp_out_buf[k]), out);
+		}
+
+		s->state1 = _mm_cvtss_f32(st1);
+		s->state3 = _mm_cvtss_f32(_mm_shuffle_ps(st1, st1, _MM_SHUFFLE(1, 1, 1, 1)));
+		s->state2 = _mm_cvtss_f32(st2);
+		s->state4 = _mm_cvtss_f32(_mm_shuffle_ps(st2, st2, _MM_SHUFFLE(1, 1, 1, 1)));
+
+		/* Later sections run in place on the output */
+		rp_src = rp_out_buf;
+	}
+
+	/* All sections off */
+	if( (rp_src != rp_out_buf) )
+		memmove(rp_out_buf, rp_in_buf, i_num_sample_sets * 2 * sizeof(realtype));
+
+	return(OKAY);
+}
+
+/*
+ * FUNCTION: sos_ProcessSurroundSectionSse()
+ * DESCRIPTION:
+ *   Runs one of the upper band sections over a 6 or 8 channel buffer, channels 0-3 in one
+ *   register and 4-7 in a second. The LFE lane is given unity coefficients so it passes
+ *   through unchanged, its state slots are left as they were.
+ */
+static void sos_ProcessSurroundSectionSse(struct sosSectionType *s, realtype *rp_src, realtype *rp_out_buf, int i_num_sample_sets, int i_num_channels)
+{
+	int j, k;
+	realtype tmp[4];
+
+	const __m128 b0_lo = _mm_setr_ps(s->b0, s->b0, s->b0, 1.0f);
+	const __m128 b1_lo = _mm_setr_ps(s->b1, s->b1, s->b1, 0.0f);
+	const __m128 b2_lo = _mm_setr_ps(s->b2, s->b2, s->b2, 0.0f);
+	const __m128 a2_lo = _mm_setr_ps(s->a2, s->a2, s->a2, 0.0f);
+	const __m128 b0_hi = _mm_set1_ps(s->b0);
+	const __m128 b1_hi = _mm_set1_ps(s->b1);
+	const __m128 b2_hi = _mm_set1_ps(s->b2);
+	const __m128 a2_hi = _mm_set1_ps(s->a2);
+
+	__m128 st1_lo = _mm_setr_ps(s->state_1[0], s->state_1[1], s->state_1[2], 0.0f);
+	__m128 st2_lo = _mm_setr_ps(s->state_2[0], s->state_2[1], s->state_2[2], 0.0f);
+	__m128 st1_hi = _mm_loadu_ps(&(s->state_1[4]));
+	__m128 st2_hi = _mm_loadu_ps(&(s->state_2[4]));
+
+	for(j=0, k=0; j<i_num_sample_sets; j++, k+=i_num_channels)
+	{
+		__m128 in_lo = _mm_loadu_ps(&(rp_src[k]));
+		__m128 in_hi;
+
+		if( i_num_channels == 8 )
+			in_hi = _mm_loadu_ps(&(rp_src[k + 4]));
+		else
+			in_hi = _mm_loadl_pi(_mm_setzero_ps(), (const __m64 *)&(rp_src[k + 4]));
+
+		__m128 out_lo = _mm_add_ps(st1_lo, _mm_mul_ps(b0_lo, in_lo));
+		st1_lo = _mm_add_ps(_mm_mul_ps(_mm_sub_ps(in_lo, out_lo), b1_lo), st2_lo);
+		st2_lo = _mm_sub_ps(_mm_mul_ps(b2_lo, in_lo), _mm_mul_ps(a2_lo, out_lo));
+
+		__m128 out_hi = _mm_add_ps(st1_hi, _mm_mul_ps(b0_hi, in_hi));
+		st1_hi = _mm_add_ps(_mm_mul_ps(_mm_sub_ps(in_hi, out_hi), b1_hi), st2_hi);
+		st2_hi = _mm_sub_ps(_mm_mul_ps(b2_hi, in_hi), _mm_mul_ps(a2_hi, out_hi));
+
+		_mm_storeu_ps(&(rp_out_buf[k]), out_lo);
+		if( i_num_channels == 8 )
+			_mm_storeu_ps(&(rp_out_buf[k + 4]), out_hi);
+		else
+			_mm_storel_pi((__m64 *)&(rp_out_buf[k + 4]), out_hi);
+	}
+
+	/* Store states back, skipping the LFE slot and the unused 7.1 slots in the 5.1 case */
+	_mm_storeu_ps(tmp, st1_lo);
+	s->state_1[0] = tmp[0]; s->state_1[1] = tmp[1]; s->state_1[2] = tmp[2];
+	_mm_storeu_ps(tmp, st2_lo);
+	s->state_2[0] = tmp[0]; s->state_2[1] = tmp[1]; s->state_2[2] = tmp[2];
+
+	if( i_num_channels == 8 )
+	{
+		_mm_storeu_ps(&(s->state_1[4]), st1_hi);
+		_mm_storeu_ps(&(s->state_2[4]), st2_hi);
+	}
+	else
+	{
+		_mm_storel_pi((__m64 *)&(s->state_1[4]), st1_hi);
+		_mm_storel_pi((__m64 *)&(s->state_2[4]), st2_hi);
+	}
+}
+
+/*
+ * FUNCTION: sos_ProcessSurroundSectionAvx()
+ * DESCRIPTION:
+ *   7.1 version of sos_ProcessSurroundSectionSse() with the whole frame in one ymm register.
+ */
+SOS_AVX_FUNCTION
+static void sos_ProcessSurroundSectionAvx(struct sosSectionType *s, realtype *rp_src, realtype *rp_out_buf, int i_num_sample_sets)
+{
+	int j, k;
+	realtype tmp[8];
+
+	const __m256 b0 = _mm256_setr_ps(s->b0, s->b0, s->b0, 1.0f, s->b0, s->b0, s->b0, s->b0);
+	const __m256 b1 = _mm256_setr_ps(s->b1, s->b1, s->b1, 0.0f, s->b1, s->b1, s->b1, s->b1);
+	const __m256 b2 = _mm256_setr_ps(s->b2, s->b2, s->b2, 0.0f, s->b2, s->b2, s->b2, s->b2);
+	const __m256 a2 = _mm256_setr_ps(s->a2, s->a2, s->a2, 0.0f, s->a2, s->a2, s->a2, s->a2);
+
+	__m256 st1 = _mm256_setr_ps(s->state_1[0], s->state_1[1], s->state_1[2], 0.0f,
+										 s->state_1[4], s->state_1[5], s->state_1[6], s->state_1[7]);
+	__m256 st2 = _mm256_setr_ps(s->state_2[0], s->state_2[1], s->state_2[2], 0.0f,
+										 s->state_2[4], s->state_2[5], s->state_2[6], s->state_2[7]);
+
+	for(j=0, k=0; j<i_num_sample_sets; j++, k+=8)
+	{
+		__m256 in = _mm256_loadu_ps(&(rp_src[k]));
+
+		__m256 out = _mm256_add_ps(st1, _mm256_mul_ps(b0, in));
+		st1 = _mm256_add_ps(_mm256_mul_ps(_mm256_sub_ps(in, out), b1), st2);
+		st2 = _mm256_sub_ps(_mm256_mul_ps(b2, in), _mm256_mul_ps(a2, out));
+
+		_mm256_storeu_ps(&(rp_out_buf[k]), out);
+	}
+
+	/* Store states back, skipping the LFE slot */
+	_mm256_storeu_ps(tmp, st1);
+	for(k=0; k<8; k++)
+		if( k != 3 )
+			s->state_1[k] = tmp[k];
+	_mm256_storeu_ps(tmp, st2);
+	for(k=0; k<8; k++)
+		if( k != 3 )
+			s->state_2[k] = tmp[k];
+
+	/* Avoid the AVX to SSE transition penalty in the caller */
+	_mm256_zeroupper();
+}
+
+/*
+ * FUNCTION: sos_ProcessSurroundCascadeSimd()
+ * DESCRIPTION:
+ *   Vectorized version of the sosProcessSurroundBuffer() cascade. The upper band sections run on
+ *   all the non LFE channels together, then the LFE channel gets its bottom two bands.
+ */
+int sos_ProcessSurroundCascadeSimd(struct sosHdlType *cast_handle, realtype *rp_in_buf, realtype *rp_out_buf, int i_num_sample_sets, int i_num_channels, int i_simd_level)
+{
+	struct sosSectionType *s;
+	realtype *rp_src = rp_in_buf;
+	int i, j;
+
+	for(i=2; i<cast_handle->num_active_sections; i++)
+	{
+		if( !(cast_handle->section_on_flag[i]) )
+			continue;
+
+		s = &((cast_handle->sections)[i]);
+
+		if( (i_num_channels == 8) && (i_simd_level >= SOS_SIMD_AVX) )
+			sos_ProcessSurroundSectionAvx(s, rp_src, rp_out_buf, i_num_sample_sets);
+		else
+			sos_ProcessSurroundSectionSse(s, rp_src, rp_out_buf, i_num_sample_sets, i_num_channels);
+
+		/* Later sections run in place on the output */
+		rp_src = rp_out_buf;
+	}
+
+	/* All upper sections off */
+	if( rp_src != rp_out_buf )
+		memmove(rp_out_buf, rp_in_buf, i_num_sample_sets * i_num_channels * sizeof(realtype));
+
+	/* LFE channel, scalar since it is a single lane */
+	for(i=0; i<2; i++)
+	{
+		int active_flag = cast_handle->section_on_flag[i];
+		if( (i == 0) && cast_handle->disable_band_1 )
+			active_flag = 0;
+
+		if( !active_flag )
+			continue;
+
+		s = &((cast_handle->sections)[i]);
+
+		realtype state1 = s->state_1[3];
+		realtype state2 = s->state_2[3];
+		realtype *rp_lfe = rp_out_buf + 3;
+
+		for(j=0; j<i_num_sample_sets; j++, rp_lfe += i_num_channels)
+		{
+			realtype in = *rp_lfe;
+			realtype out = state1 + s->b0 * in;
+			state1 = (in - out) * s->b1 + state2;
+			state2 = s->b2 * in - s->a2 * out;
+			*rp_lfe = out;
+		}
+
+		s->state_1[3] = state1;
+		s->state_2[3] = state2;
+	}
+
+	return(OKAY);
+}
+
+#else
+
+/* Never called, sos_GetSimdLevel() always returns SOS_SIMD_NONE on these targets */
+int sos_ProcessStereoCascadeSimd(struct sosHdlType *cast_handle, realtype *rp_in_buf, realtype *rp_out_buf, int i_num_sample_sets)
+{
+	return(NOT_OKAY);
+}
+
+int sos_ProcessSurroundCascadeSimd(struct sosHdlType *cast_handle, realtype *rp_in_buf, realtype *rp_out_buf, int i_num_sample_sets, int i_num_channels, int i_simd_level)
+{
+	return(NOT_OKAY);
+}
+
+#endif //SOS_SIMD_X86
@@ -22,7 +22,6 @@
 
 #include "slout.h"
 
-#define SOS_FLOAT_BIAS 1.0e-30 // Was 1.0e-5 Thru 7/11/15, then changed to 1.0e-30 values that was being used in Hyperbass.
 #define SOS_DCBLOCK_ALPHA 0.999	// See http://peabody.sapp.org/class/dmp2/lab/dcblock/ for freq response curves for differen values, 0.999 is good for 44.1 and 48khz.
 
 /* Section type definition */
@@ -72,4 +71,9 @@ struct sosHdlType {
 	bool disable_band_1;
 };
 
+/* SosProcessSimd.cpp */
+int sos_GetSimdLevel(void);
+int sos_ProcessStereoCascadeSimd(struct sosHdlType *, realtype *, realtype *, int);
+int sos_ProcessSurroundCascadeSimd(struct sosHdlType *, realtype *, realtype *, int, int, int);
+
 #endif //_U_SOS_H_
@@ -0,0 +1,113 @@
+/*
+FxSound
+Copyright (C) 2025  FxSound LLC
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/* dfxpBinaural.cpp */
+
+#include "codedefs.h"
+
+#include <windows.h>
+#include <stdio.h>
+#include <wchar.h>
+
+/* For SHGetFolderPathW */
+#include <shlobj.h>
+
+#include "u_dfxp.h" 
+
+#include "dfxp.h"
+#include "BinauralSyn.h"
+
+/* Hrir cache folder, under the product folder in the local app data folder */
+#define DFXP_BINAURAL_CACHE_FOLDER_NAME L"HrirCache"
+
+/*
+ * FUNCTION: dfxpBinaural_SetCacheFolder() 
+ * DESCRIPTION:
+ *  Creates the hrir cache folder if needed and passes it to BinauralSyn. Hrir sets are loaded
+ *  without a cache if the folder can not be made.
+ */
+static int dfxpBinaural_SetCacheFolder(struct dfxpHdlType *cast_handle)
+{
+	wchar_t wcp_folder[PT_MAX_PATH_STRLEN];
+	int len;
+
+	if (SHGetFolderPathW(NULL, CSIDL_LOCAL_APPDATA, NULL, SHGFP_TYPE_CURRENT, wcp_folder) != S_OK)
+		return(NOT_OKAY);
+
+	len = (int)wcslen(wcp_folder);
+	if (_snwprintf(wcp_folder + len, PT_MAX_PATH_STRLEN - len, L"\\%s", cast_handle->wcp_product_name) < 0)
+		return(NOT_OKAY);
+	if ( !CreateDirectoryW(wcp_folder, NULL) && (GetLastError() != ERROR_ALREADY_EXISTS) )
+		return(NOT_OKAY);
+
+	len = (int)wcslen(wcp_folder);
+	if (_snwprintf(wcp_folder + len, PT_MAX_PATH_STRLEN - len, L"\\%s", DFXP_BINAURAL_CACHE_FOLDER_NAME) < 0)
+		return(NOT_OKAY);
+	if ( !CreateDirectoryW(wcp_folder, NULL) && (GetLastError() != ERROR_ALREADY_EXISTS) )
+		return(NOT_OKAY);
+
+	return(BinauralSynSetCacheFolder(cast_handle->BinauralSyn_hdl, wcp_folder));
+}
+
+/*
+ * FUNCTION: dfxpBinauralLoadHrirSet() 
+ * DESCRIPTION:
+ *  Loads the impulse responses used for headphone processing from a 6 channel or 2 channel wav file,
+ *  see BinauralSynLoadHrirFile(). NULL or an empty path goes back to the built in responses.
+ *  Resampled and transformed responses are cached, so a set that has been used before loads quickly.
+ *  Must not be called from the audio thread, the new set is used from the next processed buffer.
+ */
+int dfxpBinauralLoadHrirSet(PT_HANDLE *hp_dfxp, wchar_t *wcp_file)
+{
+	struct dfxpHdlType *cast_handle;
+
+	cast_handle = (struct dfxpHdlType *)(hp_dfxp);
+
+	if (cast_handle == NULL)
+		return(NOT_OKAY);
+
+	if ((wcp_file == NULL) || (wcp_file[0] == L'\0'))
+		return(BinauralSynUseBuiltInHrirs(cast_handle->BinauralSyn_hdl));
+
+	if (dfxpBinaural_SetCacheFolder(cast_handle) != OKAY)
+		BinauralSynSetCacheFolder(cast_handle->BinauralSyn_hdl, NULL);
+
+	return(BinauralSynLoadHrirFile(cast_handle->BinauralSyn_hdl, wcp_file));
+}
+
+/*
+ * FUNCTION: dfxpBinauralLoadHrirPositionSet() 
+ * DESCRIPTION:
+ *  Loads the impulse responses used for headphone processing from one 2 channel near/far wav file
+ *  per speaker pair, see BinauralSynLoadHrirPositionFiles(). The rear and side files can be NULL.
+ *  Must not be called from the audio thread, the new set is used from the next processed buffer.
+ */
+int dfxpBinauralLoadHrirPositionSet(PT_HANDLE *hp_dfxp, wchar_t *wcp_front_file, wchar_t *wcp_rear_file, wchar_t *wcp_side_file)
+{
+	struct dfxpHdlType *cast_handle;
+
+	cast_handle = (struct dfxpHdlType *)(hp_dfxp);
+
+	if (cast_handle == NULL)
+		return(NOT_OKAY);
+
+	if (dfxpBinaural_SetCacheFolder(cast_handle) != OKAY)
+		BinauralSynSetCacheFolder(cast_handle->BinauralSyn_hdl, NULL);
+
+	return(BinauralSynLoadHrirPositionFiles(cast_handle->BinauralSyn_hdl, wcp_front_file, wcp_rear_file, wcp_side_file));
+}
@@ -49,6 +49,14 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 #define DFXP_MIN_EFFECTIVE_MIDI_AMBIENCE 12
 
+/*
+ * Writes of the user controlled parameters to the rear, side, center and subwoofer com handles
+ * go through these. In stereo and mono those handles are not run, so the writes are skipped,
+ * dfxpBeginProcess() sends everything again with dfxpCommunicateAll() when the channel count changes.
+ */
+static int dfxp_ComSurroundRealWrite(struct dfxpHdlType *, PT_HANDLE *, long, realtype);
+static int dfxp_ComSurroundLongIntWrite(struct dfxpHdlType *, PT_HANDLE *, long, long);
+
 /*
  * FUNCTION: dfxp_CommunicateInit() 
  * DESCRIPTION:
@@ -183,6 +191,16 @@ int dfxp_ComLoadAndRun(PT_HANDLE *hp_dfxp)
  */
 int dfxpCommunicateAll(PT_HANDLE *hp_dfxp)
 {
+	struct dfxpHdlType *cast_handle;
+
+	cast_handle = (struct dfxpHdlType *)(hp_dfxp);
+
+	if (cast_handle == NULL)
+		return(OKAY);
+
+	/* Everything is sent below, cleared first so a change made while sending is not lost */
+	InterlockedExchange(&(cast_handle->comm_changed), 0);
+
 	/* Communicate all the parameters that can change based on user controls */
 	if (dfxpCommunicateAllNonFixed(hp_dfxp, IS_FALSE) != OKAY)
 		return(NOT_OKAY);
@@ -194,6 +212,77 @@ int dfxpCommunicateAll(PT_HANDLE *hp_dfxp)
 	return(OKAY);
 }
 
+/*
+ * FUNCTION: dfxpCommunicateChanged() 
+ * DESCRIPTION:
+ *   Communicate to the DSP only the parameters whose session values have changed since they were
+ *   last sent, each to the com handles that use it. Costs nothing when nothing has changed, so it
+ *   can be called with every buffer.
+ */
+int dfxpCommunicateChanged(PT_HANDLE *hp_dfxp)
+{
+	struct dfxpHdlType *cast_handle;
+	LONG l_changed;
+
+	cast_handle = (struct dfxpHdlType *)(hp_dfxp);
+
+	if (cast_handle == NULL)
+		return(OKAY);
+
+	if (cast_handle->comm_changed == 0)
+		return(OKAY);
+
+	l_changed = InterlockedExchange(&(cast_handle->comm_changed), 0);
+
+	/* The bypass settings include the dynamic boost */
+	if (l_changed & DFXP_COMM_BYPASS)
+	{
+		if (dfxp_CommunicateBypassSettings(hp_dfxp) != OKAY)
+			return(NOT_OKAY);
+		l_changed &= ~DFXP_COMM_DYNAMIC_BOOST;
+	}
+
+	/* The music mode warps all the knobs but surround */
+	if (l_changed & DFXP_COMM_MUSIC_MODE)
+	{
+		if (dfxp_CommunicateMusicMode(hp_dfxp) != OKAY)
+			return(NOT_OKAY);
+		l_changed &= ~(DFXP_COMM_FIDELITY | DFXP_COMM_AMBIENCE | DFXP_COMM_DYNAMIC_BOOST | DFXP_COMM_BASS_BOOST);
+	}
+
+	if (l_changed & DFXP_COMM_FIDELITY)
+	{
+		if (dfxp_CommunicateFidelity(hp_dfxp) != OKAY)
+			return(NOT_OKAY);
+	}
+
+	if (l_changed & DFXP_COMM_AMBIENCE)
+	{
+		if (dfxp_CommunicateAmbience(hp_dfxp) != OKAY)
+			return(NOT_OKAY);
+	}
+
+	if (l_changed & DFXP_COMM_DYNAMIC_BOOST)
+	{
+		if (dfxp_CommunicateDynamicBoost(hp_dfxp) != OKAY)
+			return(NOT_OKAY);
+	}
+
+	if (l_changed & DFXP_COMM_SPACIOUSNESS)
+	{
+		if (dfxp_CommunicateSpaciousness(hp_dfxp) != OKAY)
+			return(NOT_OKAY);
+	}
+
+	if (l_changed & DFXP_COMM_BASS_BOOST)
+	{
+		if (dfxp_CommunicateBassBoost(hp_dfxp) != OKAY)
+			return(NOT_OKAY);
+	}
+
+	return(OKAY);
+}
+
 /*
  * FUNCTION: dfxpCommunicateAllNonFixed() 
  * DESCRIPTION:
@@ -287,7 +376,7 @@ int dfxpCommunicateAllNonFixed(PT_HANDLE *hp_dfxp, int i_communicate_slowly_flag
 					if( dfxpEqGetBandBoostCut_FromRegistry(hp_dfxp, i, &boostCut, wcp_boost_cut) != OKAY)
 						return(NOT_OKAY);
 
-					if( dfxpEqSetBandBoostCut(hp_dfxp, DFXP_STORAGE_TYPE_MEMORY, i, boostCut) != OKAY)
+					if( dfxpParamRampEqBandBoostCut(hp_dfxp, i, boostCut) != OKAY)
 						return(NOT_OKAY);
 				}
 			}
@@ -414,42 +503,47 @@ int dfxp_CommunicateBypassSettings(PT_HANDLE *hp_dfxp)
 		surround_sound_flag = 1;
 	}
 
-	/* Send the master bypass */
+	/* 
+	 * The master bypass is applied in dfxp_ModifySamples(), which keeps the com handles running until
+	 * the processed signal has been crossfaded out, so it is not sent to them here.
+	 */
+	cast_handle->bypass_fade.bypass_all = bypass_all;
+
 	// Force master bypass on SurroundSound channels when in stereo or mono mode.
-	if (comLongIntWrite(cast_handle->com_hdl_front, DSP_PLAY_BYPASS_ON, bypass_all) != OKAY)
+	if (comLongIntWrite(cast_handle->com_hdl_front, DSP_PLAY_BYPASS_ON, 0) != OKAY)
 		return(NOT_OKAY);
-	if (comLongIntWrite(cast_handle->com_hdl_rear, DSP_PLAY_BYPASS_ON, (bypass_all | stereo_or_mono_flag) ) != OKAY)
+	if (dfxp_ComSurroundLongIntWrite(cast_handle, cast_handle->com_hdl_rear, DSP_PLAY_BYPASS_ON, stereo_or_mono_flag) != OKAY)
 		return(NOT_OKAY);
-	if (comLongIntWrite(cast_handle->com_hdl_side, DSP_PLAY_BYPASS_ON, (bypass_all | stereo_or_mono_flag) ) != OKAY)
+	if (dfxp_ComSurroundLongIntWrite(cast_handle, cast_handle->com_hdl_side, DSP_PLAY_BYPASS_ON, stereo_or_mono_flag) != OKAY)
 		return(NOT_OKAY);
-	if (comLongIntWrite(cast_handle->com_hdl_center, DSP_PLAY_BYPASS_ON, (bypass_all | stereo_or_mono_flag) ) != OKAY)
+	if (dfxp_ComSurroundLongIntWrite(cast_handle, cast_handle->com_hdl_center, DSP_PLAY_BYPASS_ON, stereo_or_mono_flag) != OKAY)
 		return(NOT_OKAY);
-	if (comLongIntWrite(cast_handle->com_hdl_subwoofer, DSP_PLAY_BYPASS_ON, (bypass_all | stereo_or_mono_flag) ) != OKAY)
+	if (dfxp_ComSurroundLongIntWrite(cast_handle, cast_handle->com_hdl_subwoofer, DSP_PLAY_BYPASS_ON, stereo_or_mono_flag) != OKAY)
 		return(NOT_OKAY);
 
 	/* Send the individual knob bypass settings */
 	// Activator is always off on subwoofer channel
 	if (comLongIntWrite(cast_handle->com_hdl_front, DSP_PLAY_ACTIVATOR_ON, !(bypass_fidelity)) != OKAY)
 		return(NOT_OKAY);
-	if (comLongIntWrite(cast_handle->com_hdl_rear, DSP_PLAY_ACTIVATOR_ON, !(bypass_fidelity)) != OKAY)
+	if (dfxp_ComSurroundLongIntWrite(cast_handle, cast_handle->com_hdl_rear, DSP_PLAY_ACTIVATOR_ON, !(bypass_fidelity)) != OKAY)
 		return(NOT_OKAY);
-	if (comLongIntWrite(cast_handle->com_hdl_side, DSP_PLAY_ACTIVATOR_ON, !(bypass_fidelity)) != OKAY)
+	if (dfxp_ComSurroundLongIntWrite(cast_handle, cast_handle->com_hdl_side, DSP_PLAY_ACTIVATOR_ON, !(bypass_fidelity)) != OKAY)
 		return(NOT_OKAY);
-	if (comLongIntWrite(cast_handle->com_hdl_center, DSP_PLAY_ACTIVATOR_ON, !(bypass_fidelity)) != OKAY)
+	if (dfxp_ComSurroundLongIntWrite(cast_handle, cast_handle->com_hdl_center, DSP_PLAY_ACTIVATOR_ON, !(bypass_fidelity)) != OKAY)
 		return(NOT_OKAY);
-	if (comLongIntWrite(cast_handle->com_hdl_subwoofer, DSP_PLAY_ACTIVATOR_ON, 0) != OKAY)
+	if (dfxp_ComSurroundLongIntWrite(cast_handle, cast_handle->com_hdl_subwoofer, DSP_PLAY_ACTIVATOR_ON, 0) != OKAY)
 		return(NOT_OKAY);
 
 	// Widener is always off in center and subwoofer channels
 	if (comLongIntWrite(cast_handle->com_hdl_front, DSP_PLAY_WIDENER_ON, !(bypass_surround)) != OKAY)
 		return(NOT_OKAY);
-	if (comLongIntWrite(cast_handle->com_hdl_rear, DSP_PLAY_WIDENER_ON, !(bypass_surround)) != OKAY)
+	if (dfxp_ComSurroundLongIntWrite(cast_handle, cast_handle->com_hdl_rear, DSP_PLAY_WIDENER_ON, !(bypass_surround)) != OKAY)
 		return(NOT_OKAY);
-	if (comLongIntWrite(cast_handle->com_hdl_side, DSP_PLAY_WIDENER_ON, !(bypass_surround)) != OKAY)
+	if (dfxp_ComSurroundLongIntWrite(cast_handle, cast_handle->com_hdl_side, DSP_PLAY_WIDENER_ON, !(bypass_surround)) != OKAY)
 		return(NOT_OKAY);
-	if (comLongIntWrite(cast_handle->com_hdl_center, DSP_PLAY_WIDENER_ON, 0) != OKAY)
+	if (dfxp_ComSurroundLongIntWrite(cast_handle, cast_handle->com_hdl_center, DSP_PLAY_WIDENER_ON, 0) != OKAY)
 		return(NOT_OKAY);
-	if (comLongIntWrite(cast_handle->com_hdl_subwoofer, DSP_PLAY_WIDENER_ON, 0) != OKAY)
+	if (dfxp_ComSurroundLongIntWrite(cast_handle, cast_handle->com_hdl_subwoofer, DSP_PLAY_WIDENER_ON, 0) != OKAY)
 		return(NOT_OKAY);
 
 	// For Surround Sound mode, bass boost is only on in subwoofer channel
@@ -457,25 +551,25 @@ int dfxp_CommunicateBypassSettings(PT_HANDLE *hp_dfxp)
 	//if (comLongIntWrite(cast_handle->com_hdl_front, DSP_PLAY_BASS_BOOST_ON, (!(bypass_bass_boost) & stereo_or_mono_flag) ) != OKAY)
 	if (comLongIntWrite(cast_handle->com_hdl_front, DSP_PLAY_BASS_BOOST_ON, !(bypass_bass_boost)) != OKAY)
 		return(NOT_OKAY);
-	if (comLongIntWrite(cast_handle->com_hdl_rear, DSP_PLAY_BASS_BOOST_ON, 0) != OKAY)
+	if (dfxp_ComSurroundLongIntWrite(cast_handle, cast_handle->com_hdl_rear, DSP_PLAY_BASS_BOOST_ON, 0) != OKAY)
 		return(NOT_OKAY);
-	if (comLongIntWrite(cast_handle->com_hdl_side, DSP_PLAY_BASS_BOOST_ON, 0) != OKAY)
+	if (dfxp_ComSurroundLongIntWrite(cast_handle, cast_handle->com_hdl_side, DSP_PLAY_BASS_BOOST_ON, 0) != OKAY)
 		return(NOT_OKAY);
-	if (comLongIntWrite(cast_handle->com_hdl_center, DSP_PLAY_BASS_BOOST_ON, 0) != OKAY)
+	if (dfxp_ComSurroundLongIntWrite(cast_handle, cast_handle->com_hdl_center, DSP_PLAY_BASS_BOOST_ON, 0) != OKAY)
 		return(NOT_OKAY);
-	if (comLongIntWrite(cast_handle->com_hdl_subwoofer, DSP_PLAY_BASS_BOOST_ON, (!(bypass_bass_boost) & surround_sound_flag)) != OKAY)
+	if (dfxp_ComSurroundLongIntWrite(cast_handle, cast_handle->com_hdl_subwoofer, DSP_PLAY_BASS_BOOST_ON, (!(bypass_bass_boost) & surround_sound_flag)) != OKAY)
 		return(NOT_OKAY);
 
 	// Vocal reduction only in in front channels
 	if (comLongIntWrite(cast_handle->com_hdl_front, DSP_PLAY_VOCAL_REDUCTION_ON, !(bypass_vocal_reduction)) != OKAY)
 		return(NOT_OKAY);
-	if (comLongIntWrite(cast_handle->com_hdl_rear, DSP_PLAY_VOCAL_REDUCTION_ON, 0) != OKAY)
+	if (dfxp_ComSurroundLongIntWrite(cast_handle, cast_handle->com_hdl_rear, DSP_PLAY_VOCAL_REDUCTION_ON, 0) != OKAY)
 		return(NOT_OKAY);
-	if (comLongIntWrite(cast_handle->com_hdl_side, DSP_PLAY_VOCAL_REDUCTION_ON, 0) != OKAY)
+	if (dfxp_ComSurroundLongIntWrite(cast_handle, cast_handle->com_hdl_side, DSP_PLAY_VOCAL_REDUCTION_ON, 0) != OKAY)
 		return(NOT_OKAY);
-	if (comLongIntWrite(cast_handle->com_hdl_center, DSP_PLAY_VOCAL_REDUCTION_ON, 0) != OKAY)
+	if (dfxp_ComSurroundLongIntWrite(cast_handle, cast_handle->com_hdl_center, DSP_PLAY_VOCAL_REDUCTION_ON, 0) != OKAY)
 		return(NOT_OKAY);
-	if (comLongIntWrite(cast_handle->com_hdl_subwoofer, DSP_PLAY_VOCAL_REDUCTION_ON, 0) != OKAY)
+	if (dfxp_ComSurroundLongIntWrite(cast_handle, cast_handle->com_hdl_subwoofer, DSP_PLAY_VOCAL_REDUCTION_ON, 0) != OKAY)
 		return(NOT_OKAY);
 
 	/* Do special calculation for Ambience bypass */
@@ -499,13 +593,13 @@ int dfxp_CommunicateBypassSettings(PT_HANDLE *hp_dfxp)
 		return(NOT_OKAY);
 
 	// These channels always had the older headphone technology off
-	if (comLongIntWrite(cast_handle->com_hdl_rear, DSP_PLAY_HEADPHONE_ON, 0) != OKAY)
+	if (dfxp_ComSurroundLongIntWrite(cast_handle, cast_handle->com_hdl_rear, DSP_PLAY_HEADPHONE_ON, 0) != OKAY)
 		return(NOT_OKAY);
-	if (comLongIntWrite(cast_handle->com_hdl_side, DSP_PLAY_HEADPHONE_ON, 0) != OKAY)
+	if (dfxp_ComSurroundLongIntWrite(cast_handle, cast_handle->com_hdl_side, DSP_PLAY_HEADPHONE_ON, 0) != OKAY)
 		return(NOT_OKAY);
-	if (comLongIntWrite(cast_handle->com_hdl_center, DSP_PLAY_HEADPHONE_ON, 0) != OKAY)
+	if (dfxp_ComSurroundLongIntWrite(cast_handle, cast_handle->com_hdl_center, DSP_PLAY_HEADPHONE_ON, 0) != OKAY)
 		return(NOT_OKAY);
-	if (comLongIntWrite(cast_handle->com_hdl_subwoofer, DSP_PLAY_HEADPHONE_ON, 0) != OKAY)
+	if (dfxp_ComSurroundLongIntWrite(cast_handle, cast_handle->com_hdl_subwoofer, DSP_PLAY_HEADPHONE_ON, 0) != OKAY)
 		return(NOT_OKAY);
 
 	return(OKAY);
@@ -551,14 +645,14 @@ int dfxp_CommunicateFidelity(PT_HANDLE *hp_dfxp)
 	if (comRealWrite(cast_handle->com_hdl_front, AURAL_DRIVE + DSP_PLAY_AURAL_PARAM_OFFSET, 
 		              dsp_fidelity) != OKAY)
 		return(NOT_OKAY);
-	if (comRealWrite(cast_handle->com_hdl_rear, AURAL_DRIVE + DSP_PLAY_AURAL_PARAM_OFFSET, 
-		              dsp_fidelity) != OKAY)
+	if (dfxp_ComSurroundRealWrite(cast_handle, cast_handle->com_hdl_rear, AURAL_DRIVE + DSP_PLAY_AURAL_PARAM_OFFSET, 
+		                                        dsp_fidelity) != OKAY)
 		return(NOT_OKAY);
-	if (comRealWrite(cast_handle->com_hdl_side, AURAL_DRIVE + DSP_PLAY_AURAL_PARAM_OFFSET, 
-		              dsp_fidelity) != OKAY)
+	if (dfxp_ComSurroundRealWrite(cast_handle, cast_handle->com_hdl_side, AURAL_DRIVE + DSP_PLAY_AURAL_PARAM_OFFSET, 
+		                                        dsp_fidelity) != OKAY)
 		return(NOT_OKAY);
-	if (comRealWrite(cast_handle->com_hdl_center, AURAL_DRIVE + DSP_PLAY_AURAL_PARAM_OFFSET, 
-		              dsp_fidelity) != OKAY)
+	if (dfxp_ComSurroundRealWrite(cast_handle, cast_handle->com_hdl_center, AURAL_DRIVE + DSP_PLAY_AURAL_PARAM_OFFSET, 
+		                                        dsp_fidelity) != OKAY)
 		return(NOT_OKAY);
 
 	return(OKAY);
@@ -634,38 +728,38 @@ int dfxp_CommunicateAmbience(PT_HANDLE *hp_dfxp)
 	// Ambience will always be bypassed on subwoofer channel, so don't send to that one
 	if (comRealWrite(cast_handle->com_hdl_front, DRY_GAIN + DSP_PLAY_LEX_PARAM_OFFSET, dry_gain) != OKAY)
 		return(NOT_OKAY);
-	if (comRealWrite(cast_handle->com_hdl_rear, DRY_GAIN + DSP_PLAY_LEX_PARAM_OFFSET, dry_gain) != OKAY)
+	if (dfxp_ComSurroundRealWrite(cast_handle, cast_handle->com_hdl_rear, DRY_GAIN + DSP_PLAY_LEX_PARAM_OFFSET, dry_gain) != OKAY)
 		return(NOT_OKAY);
-	if (comRealWrite(cast_handle->com_hdl_side, DRY_GAIN + DSP_PLAY_LEX_PARAM_OFFSET, dry_gain) != OKAY)
+	if (dfxp_ComSurroundRealWrite(cast_handle, cast_handle->com_hdl_side, DRY_GAIN + DSP_PLAY_LEX_PARAM_OFFSET, dry_gain) != OKAY)
 		return(NOT_OKAY);
-	if (comRealWrite(cast_handle->com_hdl_center, DRY_GAIN + DSP_PLAY_LEX_PARAM_OFFSET, dry_gain) != OKAY)
+	if (dfxp_ComSurroundRealWrite(cast_handle, cast_handle->com_hdl_center, DRY_GAIN + DSP_PLAY_LEX_PARAM_OFFSET, dry_gain) != OKAY)
 		return(NOT_OKAY);
 
 	if (comRealWrite(cast_handle->com_hdl_front, WET_GAIN + DSP_PLAY_LEX_PARAM_OFFSET, wet_gain) != OKAY)
 		return(NOT_OKAY);
-	if (comRealWrite(cast_handle->com_hdl_rear, WET_GAIN + DSP_PLAY_LEX_PARAM_OFFSET, wet_gain) != OKAY)
+	if (dfxp_ComSurroundRealWrite(cast_handle, cast_handle->com_hdl_rear, WET_GAIN + DSP_PLAY_LEX_PARAM_OFFSET, wet_gain) != OKAY)
 		return(NOT_OKAY);
-	if (comRealWrite(cast_handle->com_hdl_side, WET_GAIN + DSP_PLAY_LEX_PARAM_OFFSET, wet_gain) != OKAY)
+	if (dfxp_ComSurroundRealWrite(cast_handle, cast_handle->com_hdl_side, WET_GAIN + DSP_PLAY_LEX_PARAM_OFFSET, wet_gain) != OKAY)
 		return(NOT_OKAY);
-	if (comRealWrite(cast_handle->com_hdl_center, WET_GAIN + DSP_PLAY_LEX_PARAM_OFFSET, wet_gain) != OKAY)
+	if (dfxp_ComSurroundRealWrite(cast_handle, cast_handle->com_hdl_center, WET_GAIN + DSP_PLAY_LEX_PARAM_OFFSET, wet_gain) != OKAY)
 		return(NOT_OKAY);
 
 	if (comRealWrite(cast_handle->com_hdl_front, LEX_DECAY + DSP_PLAY_LEX_PARAM_OFFSET, dsp_decay) != OKAY)
 		return(NOT_OKAY);
-	if (comRealWrite(cast_handle->com_hdl_rear, LEX_DECAY + DSP_PLAY_LEX_PARAM_OFFSET, dsp_decay) != OKAY)
+	if (dfxp_ComSurroundRealWrite(cast_handle, cast_handle->com_hdl_rear, LEX_DECAY + DSP_PLAY_LEX_PARAM_OFFSET, dsp_decay) != OKAY)
 		return(NOT_OKAY);
-	if (comRealWrite(cast_handle->com_hdl_side, LEX_DECAY + DSP_PLAY_LEX_PARAM_OFFSET, dsp_decay) != OKAY)
+	if (dfxp_ComSurroundRealWrite(cast_handle, cast_handle->com_hdl_side, LEX_DECAY + DSP_PLAY_LEX_PARAM_OFFSET, dsp_decay) != OKAY)
 		return(NOT_OKAY);
-	if (comRealWrite(cast_handle->com_hdl_center, LEX_DECAY + DSP_PLAY_LEX_PARAM_OFFSET, dsp_decay) != OKAY)
+	if (dfxp_ComSurroundRealWrite(cast_handle, cast_handle->com_hdl_center, LEX_DECAY + DSP_PLAY_LEX_PARAM_OFFSET, dsp_decay) != OKAY)
 		return(NOT_OKAY);
 
 	if (comRealWrite(cast_handle->com_hdl_front, LEX_LAT6_COEFF + DSP_PLAY_LEX_PARAM_OFFSET, dsp_lat6_coeff) != OKAY)
 		return(NOT_OKAY);
-	if (comRealWrite(cast_handle->com_hdl_rear, LEX_LAT6_COEFF + DSP_PLAY_LEX_PARAM_OFFSET, dsp_lat6_coeff) != OKAY)
+	if (dfxp_ComSurroundRealWrite(cast_handle, cast_handle->com_hdl_rear, LEX_LAT6_COEFF + DSP_PLAY_LEX_PARAM_OFFSET, dsp_lat6_coeff) != OKAY)
 		return(NOT_OKAY);
-	if (comRealWrite(cast_handle->com_hdl_side, LEX_LAT6_COEFF + DSP_PLAY_LEX_PARAM_OFFSET, dsp_lat6_coeff) != OKAY)
+	if (dfxp_ComSurroundRealWrite(cast_handle, cast_handle->com_hdl_side, LEX_LAT6_COEFF + DSP_PLAY_LEX_PARAM_OFFSET, dsp_lat6_coeff) != OKAY)
 		return(NOT_OKAY);
-	if (comRealWrite(cast_handle->com_hdl_center, LEX_LAT6_COEFF + DSP_PLAY_LEX_PARAM_OFFSET, dsp_lat6_coeff) != OKAY)
+	if (dfxp_ComSurroundRealWrite(cast_handle, cast_handle->com_hdl_center, LEX_LAT6_COEFF + DSP_PLAY_LEX_PARAM_OFFSET, dsp_lat6_coeff) != OKAY)
 		return(NOT_OKAY);
 	
 	/* 
@@ -748,17 +842,17 @@ int dfxp_CommunicateDynamicBoost(PT_HANDLE *hp_dfxp)
 	if (comRealWrite(cast_handle->com_hdl_front, MAXIMIZE_GAIN_BOOST + DSP_PLAY_OPTIMIZER_PARAM_OFFSET, 
 		              dsp_gain_boost) != OKAY)
 		return(NOT_OKAY);
-	if (comRealWrite(cast_handle->com_hdl_rear, MAXIMIZE_GAIN_BOOST + DSP_PLAY_OPTIMIZER_PARAM_OFFSET, 
-		              dsp_gain_boost) != OKAY)
+	if (dfxp_ComSurroundRealWrite(cast_handle, cast_handle->com_hdl_rear, MAXIMIZE_GAIN_BOOST + DSP_PLAY_OPTIMIZER_PARAM_OFFSET, 
+		                                        dsp_gain_boost) != OKAY)
 		return(NOT_OKAY);
-	if (comRealWrite(cast_handle->com_hdl_side, MAXIMIZE_GAIN_BOOST + DSP_PLAY_OPTIMIZER_PARAM_OFFSET, 
-		              dsp_gain_boost) != OKAY)
+	if (dfxp_ComSurroundRealWrite(cast_handle, cast_handle->com_hdl_side, MAXIMIZE_GAIN_BOOST + DSP_PLAY_OPTIMIZER_PARAM_OFFSET, 
+		                                        dsp_gain_boost) != OKAY)
 		return(NOT_OKAY);
-	if (comRealWrite(cast_handle->com_hdl_center, MAXIMIZE_GAIN_BOOST + DSP_PLAY_OPTIMIZER_PARAM_OFFSET, 
-		              dsp_gain_boost) != OKAY)
+	if (dfxp_ComSurroundRealWrite(cast_handle, cast_handle->com_hdl_center, MAXIMIZE_GAIN_BOOST + DSP_PLAY_OPTIMIZER_PARAM_OFFSET, 
+		                                        dsp_gain_boost) != OKAY)
 		return(NOT_OKAY);
-	if (comRealWrite(cast_handle->com_hdl_subwoofer, MAXIMIZE_GAIN_BOOST + DSP_PLAY_OPTIMIZER_PARAM_OFFSET, 
-		              dsp_gain_boost) != OKAY)
+	if (dfxp_ComSurroundRealWrite(cast_handle, cast_handle->com_hdl_subwoofer, MAXIMIZE_GAIN_BOOST + DSP_PLAY_OPTIMIZER_PARAM_OFFSET, 
+		                                        dsp_gain_boost) != OKAY)
 		return(NOT_OKAY);
 
 	/* Set delay to desired lookahead time. Needs special init in PC code. */
@@ -766,13 +860,13 @@ int dfxp_CommunicateDynamicBoost(PT_HANDLE *hp_dfxp)
 
 	if (comLongIntWrite(cast_handle->com_hdl_front, MAXIMIZE_MAX_DELAY + DSP_PLAY_OPTIMIZER_PARAM_OFFSET, max_delay) != OKAY)
 		return(NOT_OKAY);
-	if (comLongIntWrite(cast_handle->com_hdl_rear, MAXIMIZE_MAX_DELAY + DSP_PLAY_OPTIMIZER_PARAM_OFFSET, max_delay) != OKAY)
+	if (dfxp_ComSurroundLongIntWrite(cast_handle, cast_handle->com_hdl_rear, MAXIMIZE_MAX_DELAY + DSP_PLAY_OPTIMIZER_PARAM_OFFSET, max_delay) != OKAY)
 		return(NOT_OKAY);
-	if (comLongIntWrite(cast_handle->com_hdl_side, MAXIMIZE_MAX_DELAY + DSP_PLAY_OPTIMIZER_PARAM_OFFSET, max_delay) != OKAY)
+	if (dfxp_ComSurroundLongIntWrite(cast_handle, cast_handle->com_hdl_side, MAXIMIZE_MAX_DELAY + DSP_PLAY_OPTIMIZER_PARAM_OFFSET, max_delay) != OKAY)
 		return(NOT_OKAY);
-	if (comLongIntWrite(cast_handle->com_hdl_center, MAXIMIZE_MAX_DELAY + DSP_PLAY_OPTIMIZER_PARAM_OFFSET, max_delay) != OKAY)
+	if (dfxp_ComSurroundLongIntWrite(cast_handle, cast_handle->com_hdl_center, MAXIMIZE_MAX_DELAY + DSP_PLAY_OPTIMIZER_PARAM_OFFSET, max_delay) != OKAY)
 		return(NOT_OKAY);
-	if (comLongIntWrite(cast_handle->com_hdl_subwoofer, MAXIMIZE_MAX_DELAY + DSP_PLAY_OPTIMIZER_PARAM_OFFSET, max_delay) != OKAY)
+	if (dfxp_ComSurroundLongIntWrite(cast_handle, cast_handle->com_hdl_subwoofer, MAXIMIZE_MAX_DELAY + DSP_PLAY_OPTIMIZER_PARAM_OFFSET, max_delay) != OKAY)
 		return(NOT_OKAY);
 
 	return(OKAY);
@@ -807,11 +901,11 @@ int dfxp_CommunicateSpaciousness(PT_HANDLE *hp_dfxp)
 	if (comRealWrite(cast_handle->com_hdl_front, DSP_WID_INTENSITY + DSP_PLAY_WIDENER_PARAM_OFFSET, 
 		              dsp_intensity) != OKAY)
 		return(NOT_OKAY);
-	if (comRealWrite(cast_handle->com_hdl_rear, DSP_WID_INTENSITY + DSP_PLAY_WIDENER_PARAM_OFFSET, 
-		              dsp_intensity) != OKAY)
+	if (dfxp_ComSurroundRealWrite(cast_handle, cast_handle->com_hdl_rear, DSP_WID_INTENSITY + DSP_PLAY_WIDENER_PARAM_OFFSET, 
+		                                        dsp_intensity) != OKAY)
 		return(NOT_OKAY);
-	if (comRealWrite(cast_handle->com_hdl_side, DSP_WID_INTENSITY + DSP_PLAY_WIDENER_PARAM_OFFSET, 
-		              dsp_intensity) != OKAY)
+	if (dfxp_ComSurroundRealWrite(cast_handle, cast_handle->com_hdl_side, DSP_WID_INTENSITY + DSP_PLAY_WIDENER_PARAM_OFFSET, 
+		                                        dsp_intensity) != OKAY)
 		return(NOT_OKAY);
 
 	return(OKAY);
@@ -1011,6 +1105,10 @@ int dfxp_CommunicateFixedQnts_Opt(PT_HANDLE *hp_dfxp)
    if (dfxp_MaxCommunicateReleaseTime(hp_dfxp) != OKAY)
 		return(NOT_OKAY);
 
+	/* Send the peak detection mode */
+   if (dfxp_MaxCommunicateTruePeak(hp_dfxp) != OKAY)
+		return(NOT_OKAY);
+
 	/* Write the setting for the target boosted output level. Note that this
 	 * doesn't use a quant function now, but likely will be enhanced to use
 	 * a quant function in the DSP-FX version of the new optimizer.
@@ -1551,6 +1649,36 @@ int dfxp_MaxCommunicateReleaseTime(PT_HANDLE *hp_dfxp)
 	return(OKAY);
 }
 
+/*
+ * FUNCTION: dfxp_MaxCommunicateTruePeak()
+ * DESCRIPTION:
+ *   Communicates to the dsp card whether the optimizer limits true peaks.
+ */
+int dfxp_MaxCommunicateTruePeak(PT_HANDLE *hp_dfxp)
+{
+	struct dfxpHdlType *cast_handle;
+
+	cast_handle = (struct dfxpHdlType *)(hp_dfxp);
+
+	if (cast_handle == NULL)
+		return(OKAY);
+
+	long true_peak_on = (long)cast_handle->true_peak_on;
+
+	if (comLongIntWrite(cast_handle->com_hdl_front, MAXIMIZE_TRUE_PEAK_ON + DSP_PLAY_OPTIMIZER_PARAM_OFFSET, true_peak_on) != OKAY)
+		return(NOT_OKAY);
+	if (comLongIntWrite(cast_handle->com_hdl_rear, MAXIMIZE_TRUE_PEAK_ON + DSP_PLAY_OPTIMIZER_PARAM_OFFSET, true_peak_on) != OKAY)
+		return(NOT_OKAY);
+	if (comLongIntWrite(cast_handle->com_hdl_side, MAXIMIZE_TRUE_PEAK_ON + DSP_PLAY_OPTIMIZER_PARAM_OFFSET, true_peak_on) != OKAY)
+		return(NOT_OKAY);
+	if (comLongIntWrite(cast_handle->com_hdl_center, MAXIMIZE_TRUE_PEAK_ON + DSP_PLAY_OPTIMIZER_PARAM_OFFSET, true_peak_on) != OKAY)
+		return(NOT_OKAY);
+	if (comLongIntWrite(cast_handle->com_hdl_subwoofer, MAXIMIZE_TRUE_PEAK_ON + DSP_PLAY_OPTIMIZER_PARAM_OFFSET, true_peak_on) != OKAY)
+		return(NOT_OKAY);
+
+	return(OKAY);
+}
+
 /*
  * FUNCTION: dfxp_WidCommunicateDispersion()
  * DESCRIPTION:
@@ -1696,13 +1824,13 @@ int dfxp_CommAmbienceBypass(PT_HANDLE *hp_dfxp)
 	// Ambience for subwoofer is always bypassed
 	if (comLongIntWrite(cast_handle->com_hdl_front, DSP_PLAY_AMBIENCE_ON, (!ambience_bypass)) != OKAY)
 		return(NOT_OKAY);
-	if (comLongIntWrite(cast_handle->com_hdl_rear, DSP_PLAY_AMBIENCE_ON, (!ambience_bypass)) != OKAY)
+	if (dfxp_ComSurroundLongIntWrite(cast_handle, cast_handle->com_hdl_rear, DSP_PLAY_AMBIENCE_ON, (!ambience_bypass)) != OKAY)
 		return(NOT_OKAY);
-	if (comLongIntWrite(cast_handle->com_hdl_side, DSP_PLAY_AMBIENCE_ON, (!ambience_bypass)) != OKAY)
+	if (dfxp_ComSurroundLongIntWrite(cast_handle, cast_handle->com_hdl_side, DSP_PLAY_AMBIENCE_ON, (!ambience_bypass)) != OKAY)
 		return(NOT_OKAY);
-	if (comLongIntWrite(cast_handle->com_hdl_center, DSP_PLAY_AMBIENCE_ON, (!ambience_bypass)) != OKAY)
+	if (dfxp_ComSurroundLongIntWrite(cast_handle, cast_handle->com_hdl_center, DSP_PLAY_AMBIENCE_ON, (!ambience_bypass)) != OKAY)
 		return(NOT_OKAY);
-	if (comLongIntWrite(cast_handle->com_hdl_subwoofer, DSP_PLAY_AMBIENCE_ON, 0) != OKAY)
+	if (dfxp_ComSurroundLongIntWrite(cast_handle, cast_handle->com_hdl_subwoofer, DSP_PLAY_AMBIENCE_ON, 0) != OKAY)
 		return(NOT_OKAY);
 
 	return(OKAY);
@@ -1738,4 +1866,182 @@ int dfxp_CommunicateMusicMode(PT_HANDLE *hp_dfxp)
 		return(NOT_OKAY);
 
 	return(OKAY);
+}
+
+/*
+ * FUNCTION: dfxp_CommunicateKnob()
+ * DESCRIPTION:
+ *   Sends the current value of the specified knob to the processing.
+ */
+int dfxp_CommunicateKnob(PT_HANDLE *hp_dfxp, int i_knob_type)
+{
+	struct dfxpHdlType *cast_handle;
+
+	cast_handle = (struct dfxpHdlType *)(hp_dfxp);
+
+	if (cast_handle == NULL)
+		return(OKAY);
+
+	/* Cleared before the value is read, a change made after that is sent again */
+	if (dfxp_CommunicateClearChanged(hp_dfxp, dfxp_CommunicateKnobFlags(i_knob_type)) != OKAY)
+		return(NOT_OKAY);
+
+	if (i_knob_type == DFX_UI_KNOB_FIDELITY)
+		return( dfxp_CommunicateFidelity(hp_dfxp) );
+	else if (i_knob_type == DFX_UI_KNOB_AMBIENCE)
+		return( dfxp_CommunicateAmbience(hp_dfxp) );
+	else if (i_knob_type == DFX_UI_KNOB_DYNAMIC_BOOST)
+		return( dfxp_CommunicateDynamicBoost(hp_dfxp) );
+	else if (i_knob_type == DFX_UI_KNOB_SURROUND)
+		return( dfxp_CommunicateSpaciousness(hp_dfxp) );
+	else if (i_knob_type == DFX_UI_KNOB_BASS_BOOST)
+		return( dfxp_CommunicateBassBoost(hp_dfxp) );
+
+	return(OKAY);
+}
+
+/*
+ * FUNCTION: dfxp_CommunicateButton()
+ * DESCRIPTION:
+ *   Sends the current value of the specified button to the processing.
+ */
+int dfxp_CommunicateButton(PT_HANDLE *hp_dfxp, int i_button_type)
+{
+	struct dfxpHdlType *cast_handle;
+
+	cast_handle = (struct dfxpHdlType *)(hp_dfxp);
+
+	if (cast_handle == NULL)
+		return(OKAY);
+
+	if (dfxp_CommunicateClearChanged(hp_dfxp, dfxp_CommunicateButtonFlags(i_button_type)) != OKAY)
+		return(NOT_OKAY);
+
+	if (i_button_type == DFX_UI_BUTTON_MUSIC_MODE)
+		return( dfxp_CommunicateMusicMode(hp_dfxp) );
+
+	if ( (i_button_type == DFX_UI_BUTTON_BYPASS) ||
+		  (i_button_type == DFX_UI_BUTTON_FIDELITY) ||
+		  (i_button_type == DFX_UI_BUTTON_AMBIENCE) ||
+		  (i_button_type == DFX_UI_BUTTON_DYNAMIC_BOOST) ||
+		  (i_button_type == DFX_UI_BUTTON_SURROUND) ||
+		  (i_button_type == DFX_UI_BUTTON_BASS_BOOST) ||
+		  (i_button_type == DFX_UI_BUTTON_HEADPHONE) ||
+		  (i_button_type == DFX_UI_BUTTON_VOCAL_REDUCTION_ON) ||
+		  (i_button_type == DFX_UI_BUTTON_REMIX_BYPASS) )
+		return( dfxp_CommunicateBypassSettings(hp_dfxp) );
+
+	return(OKAY);
+}
+
+/*
+ * FUNCTION: dfxp_CommunicateKnobFlags()
+ * DESCRIPTION:
+ *   Returns the DFXP_COMM_ flags of the parameters that depend on the specified knob.
+ */
+LONG dfxp_CommunicateKnobFlags(int i_knob_type)
+{
+	if (i_knob_type == DFX_UI_KNOB_FIDELITY)
+		return(DFXP_COMM_FIDELITY);
+	else if (i_knob_type == DFX_UI_KNOB_AMBIENCE)
+		return(DFXP_COMM_AMBIENCE);
+	else if (i_knob_type == DFX_UI_KNOB_DYNAMIC_BOOST)
+		return(DFXP_COMM_DYNAMIC_BOOST);
+	else if (i_knob_type == DFX_UI_KNOB_SURROUND)
+		return(DFXP_COMM_SPACIOUSNESS);
+	else if (i_knob_type == DFX_UI_KNOB_BASS_BOOST)
+		return(DFXP_COMM_BASS_BOOST);
+
+	return(0);
+}
+
+/*
+ * FUNCTION: dfxp_CommunicateButtonFlags()
+ * DESCRIPTION:
+ *   Returns the DFXP_COMM_ flags of the parameters that depend on the specified button.
+ */
+LONG dfxp_CommunicateButtonFlags(int i_button_type)
+{
+	if (i_button_type == DFX_UI_BUTTON_MUSIC_MODE)
+		return(DFXP_COMM_MUSIC_MODE | DFXP_COMM_FIDELITY | DFXP_COMM_AMBIENCE | DFXP_COMM_DYNAMIC_BOOST | DFXP_COMM_BASS_BOOST);
+
+	if ( (i_button_type == DFX_UI_BUTTON_BYPASS) ||
+		  (i_button_type == DFX_UI_BUTTON_FIDELITY) ||
+		  (i_button_type == DFX_UI_BUTTON_AMBIENCE) ||
+		  (i_button_type == DFX_UI_BUTTON_DYNAMIC_BOOST) ||
+		  (i_button_type == DFX_UI_BUTTON_SURROUND) ||
+		  (i_button_type == DFX_UI_BUTTON_BASS_BOOST) ||
+		  (i_button_type == DFX_UI_BUTTON_HEADPHONE) ||
+		  (i_button_type == DFX_UI_BUTTON_VOCAL_REDUCTION_ON) ||
+		  (i_button_type == DFX_UI_BUTTON_REMIX_BYPASS) )
+		return(DFXP_COMM_BYPASS | DFXP_COMM_DYNAMIC_BOOST);
+
+	return(0);
+}
+
+/*
+ * FUNCTION: dfxp_CommunicateSetChanged()
+ * DESCRIPTION:
+ *   Flags the passed parameters as changed, dfxpCommunicateChanged() sends them.
+ *   Called after the new session value has been written.
+ */
+int dfxp_CommunicateSetChanged(PT_HANDLE *hp_dfxp, LONG l_flags)
+{
+	struct dfxpHdlType *cast_handle;
+
+	cast_handle = (struct dfxpHdlType *)(hp_dfxp);
+
+	if (cast_handle == NULL)
+		return(OKAY);
+
+	if (l_flags != 0)
+		InterlockedOr(&(cast_handle->comm_changed), l_flags);
+
+	return(OKAY);
+}
+
+/*
+ * FUNCTION: dfxp_CommunicateClearChanged()
+ * DESCRIPTION:
+ *   Clears the changed flags of the passed parameters, called before they are sent.
+ */
+int dfxp_CommunicateClearChanged(PT_HANDLE *hp_dfxp, LONG l_flags)
+{
+	struct dfxpHdlType *cast_handle;
+
+	cast_handle = (struct dfxpHdlType *)(hp_dfxp);
+
+	if (cast_handle == NULL)
+		return(OKAY);
+
+	if ((cast_handle->comm_changed & l_flags) != 0)
+		InterlockedAnd(&(cast_handle->comm_changed), ~l_flags);
+
+	return(OKAY);
+}
+
+/*
+ * FUNCTION: dfxp_ComSurroundRealWrite()
+ * DESCRIPTION:
+ *   comRealWrite() to a surround com handle, skipped when the signal is stereo or mono.
+ */
+static int dfxp_ComSurroundRealWrite(struct dfxpHdlType *cast_handle, PT_HANDLE *com_hdl, long l_param, realtype r_value)
+{
+	if (cast_handle->num_channels_out <= 2)
+		return(OKAY);
+
+	return( comRealWrite(com_hdl, l_param, r_value) );
+}
+
+/*
+ * FUNCTION: dfxp_ComSurroundLongIntWrite()
+ * DESCRIPTION:
+ *   comLongIntWrite() to a surround com handle, skipped when the signal is stereo or mono.
+ */
+static int dfxp_ComSurroundLongIntWrite(struct dfxpHdlType *cast_handle, PT_HANDLE *com_hdl, long l_param, long l_value)
+{
+	if (cast_handle->num_channels_out <= 2)
+		return(OKAY);
+
+	return( comLongIntWrite(com_hdl, l_param, l_value) );
 }
\ No newline at end of file
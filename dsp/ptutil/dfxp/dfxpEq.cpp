@@ -102,6 +102,7 @@ int dfxpEqSetEqType(PT_HANDLE *hp_dfxp, int i_eq_type)
 int dfxpEqSetProcessingOn(PT_HANDLE *hp_dfxp, int i_storage_type, int i_on)
 {
 	struct dfxpHdlType *cast_handle;
+	wchar_t wcp_keyname[PT_MAX_GENERIC_STRLEN];
 	wchar_t wcp_full_key_path[PT_MAX_PATH_STRLEN];
 	wchar_t wcp_key_value[DFXP_REGISTRY_BUFFER_LENGTH];
 
@@ -121,6 +122,12 @@ int dfxpEqSetProcessingOn(PT_HANDLE *hp_dfxp, int i_storage_type, int i_on)
 	if ((i_storage_type == DFXP_STORAGE_TYPE_REGISTRY) ||
 		 (i_storage_type == DFXP_STORAGE_TYPE_ALL))
 	{
+		/* When the session store is running the session writer thread saves it */
+		if (cast_handle->session_store != NULL)
+		{
+			return( dfxp_SessionStoreWriteInteger(hp_dfxp, DFXP_SESSION_KEY_EQ_ON, i_on) );
+		}
+
 		swprintf(wcp_full_key_path, L"%s\\%s\\%d\\%d\\%s\\%s\\%s", 
 									DFXP_REGISTRY_TOP_WIDE, 
 									cast_handle->wcp_product_name, 
@@ -221,6 +228,7 @@ int dfxpEqSetVolumeNormalization(PT_HANDLE* hp_dfxp, realtype r_target_rms)
 int dfxpEqGetProcessingOn(PT_HANDLE *hp_dfxp, int i_storage_type, int *ip_on)
 {
 	struct dfxpHdlType *cast_handle;
+	wchar_t wcp_keyname[PT_MAX_GENERIC_STRLEN];
 	wchar_t wcp_full_key_path[PT_MAX_PATH_STRLEN];
 	wchar_t wcp_key_value[DFXP_REGISTRY_BUFFER_LENGTH];
 	int key_exists;
@@ -240,6 +248,12 @@ int dfxpEqGetProcessingOn(PT_HANDLE *hp_dfxp, int i_storage_type, int *ip_on)
 		return(OKAY);
 	}
 
+	/* Read from memory when the session store is running, this is called from the audio thread */
+	if (cast_handle->session_store != NULL)
+	{
+		return( dfxp_SessionStoreReadInteger(hp_dfxp, DFXP_SESSION_KEY_EQ_ON, IS_TRUE, ip_on) );
+	}
+
 	swprintf(wcp_full_key_path, L"%s\\%s\\%d\\%d\\%s\\%s\\%s", 
 									DFXP_REGISTRY_TOP_WIDE, 
 									cast_handle->wcp_product_name, 
@@ -330,6 +344,12 @@ int dfxpEqSetBandBoostCut(PT_HANDLE *hp_dfxp, int i_storage_type, int i_band_num
 	if ((i_storage_type == DFXP_STORAGE_TYPE_REGISTRY)  ||
 		 (i_storage_type == DFXP_STORAGE_TYPE_ALL))
 	{
+		/* When the session store is running the session writer thread saves it */
+		if (cast_handle->session_store != NULL)
+		{
+			return( dfxp_SessionStoreWriteReal(hp_dfxp, DFXP_SESSION_KEY_EQ_BAND(i_band_num), r_boost_cut) );
+		}
+
 		/* Save the new setting in the registry */
 		swprintf(wcp_keyname, L"%s%d", DFXP_REGISTRY_EQ_BAND_NAME_WIDE, i_band_num);
 
@@ -356,6 +376,7 @@ int dfxpEqSetBandBoostCut(PT_HANDLE *hp_dfxp, int i_storage_type, int i_band_num
  * DESCRIPTION:
  *
  *  Gets the currently utilized boost cut setting for the specified band.
+ *  If the band is ramping to a new setting it is the setting it is ramping to, audio thread only in that case.
  *
  */
 int dfxpEqGetBandBoostCut_FromProcessing(PT_HANDLE *hp_dfxp, int i_band_num, realtype *rp_boost_cut, wchar_t *wcp_boost_cut)
@@ -379,6 +400,10 @@ int dfxpEqGetBandBoostCut_FromProcessing(PT_HANDLE *hp_dfxp, int i_band_num, rea
    if (GraphicEqGetBandBoostCut(cast_handle->eq.graphicEq_hdl, i_band_num, rp_boost_cut) != OKAY)
 		return(NOT_OKAY);
 
+	/* A band that is ramping already has its new setting */
+	if (dfxp_ParamGetEqRampTarget(hp_dfxp, i_band_num, rp_boost_cut) != OKAY)
+		return(NOT_OKAY);
+
 	swprintf(wcp_boost_cut, L"%.2f", *rp_boost_cut);
 
 	return(OKAY);
@@ -414,6 +439,23 @@ int dfxpEqGetBandBoostCut_FromRegistry(PT_HANDLE *hp_dfxp, int i_band_num, realt
 	if ((i_band_num < 1) || (i_band_num > DFXP_GRAPHIC_EQ_NUM_BANDS))
 		return(NOT_OKAY);
 
+	/* Read from memory when the session store is running, this is called from the audio thread */
+	if (cast_handle->session_store != NULL)
+	{
+		if (dfxp_SessionStoreReadReal(hp_dfxp, DFXP_SESSION_KEY_EQ_BAND(i_band_num), (realtype)0.0, rp_boost_cut) != OKAY)
+			return(NOT_OKAY);
+
+		if (*rp_boost_cut < DFXP_GRAPHIC_EQ_MIN_BOOST_OR_CUT_DB) 
+			*rp_boost_cut = DFXP_GRAPHIC_EQ_MIN_BOOST_OR_CUT_DB;
+		else if (*rp_boost_cut > DFXP_GRAPHIC_EQ_MAX_BOOST_OR_CUT_DB)
+			*rp_boost_cut = DFXP_GRAPHIC_EQ_MAX_BOOST_OR_CUT_DB;
+
+		/* Stored values are always written with two decimals, same as the processing string */
+		swprintf(wcp_boost_cut, L"%.2f", *rp_boost_cut);
+
+		return(OKAY);
+	}
+
 	/* Calculate name the registry */
 	swprintf(wcp_keyname, L"%s%d", DFXP_REGISTRY_EQ_BAND_NAME_WIDE, i_band_num);
 
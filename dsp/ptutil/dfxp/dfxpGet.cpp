@@ -29,6 +29,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "DfxSdk.h"
 #include "qnt.h"
 #include "spectrum.h"
+#include "c_max.h"
 
 /*
  * FUNCTION: dfxpGetKnobValue() 
@@ -49,7 +50,7 @@ int dfxpGetKnobValue(PT_HANDLE *hp_dfxp, int i_knob_type, float *fp_value)
 
 	*fp_value = (float)0.0;
 
-	if (dfxp_GetKnobValue_MIDI(hp_dfxp, i_knob_type, &i_midi_value) != OKAY)
+	if (dfxp_GetKnobSessionValue_MIDI(hp_dfxp, i_knob_type, &i_midi_value) != OKAY)
 		return(NOT_OKAY);
 
 	/* Calulate the real value */
@@ -64,9 +65,31 @@ int dfxpGetKnobValue(PT_HANDLE *hp_dfxp, int i_knob_type, float *fp_value)
 /*
  * FUNCTION: dfxp_GetKnobValue_MIDI() 
  * DESCRIPTION:
- *  Passes back the value of the specified knob in MIDI representation.
+ *  Passes back the value of the specified knob in MIDI representation, as it should be sent to the processing.
+ *  While the knob is ramping to a new setting this is the ramp value rather than the session value.
  */
 int dfxp_GetKnobValue_MIDI(PT_HANDLE *hp_dfxp, int i_knob_type, int *ip_midi_value)
+{
+	int i_ramping;
+
+   if (ip_midi_value == NULL)
+		return(NOT_OKAY);
+
+	if (dfxp_ParamGetKnobRamp(hp_dfxp, i_knob_type, ip_midi_value, &i_ramping) != OKAY)
+		return(NOT_OKAY);
+
+	if (i_ramping)
+		return(OKAY);
+
+	return( dfxp_GetKnobSessionValue_MIDI(hp_dfxp, i_knob_type, ip_midi_value) );
+}
+
+/*
+ * FUNCTION: dfxp_GetKnobSessionValue_MIDI() 
+ * DESCRIPTION:
+ *  Passes back the session value of the specified knob in MIDI representation.
+ */
+int dfxp_GetKnobSessionValue_MIDI(PT_HANDLE *hp_dfxp, int i_knob_type, int *ip_midi_value)
 {
 	struct dfxpHdlType *cast_handle;
 
@@ -75,7 +98,7 @@ int dfxp_GetKnobValue_MIDI(PT_HANDLE *hp_dfxp, int i_knob_type, int *ip_midi_val
 	if (cast_handle == NULL)
 		return(OKAY);
 
-	wchar_t wcp_key_name[128];
+	int i_key;
 	int default_value;
 
    if (ip_midi_value == NULL)
@@ -100,33 +123,33 @@ int dfxp_GetKnobValue_MIDI(PT_HANDLE *hp_dfxp, int i_knob_type, int *ip_midi_val
 	if (i_knob_type == DFX_UI_KNOB_FIDELITY)
 	{
 		default_value = DFXP_INIT_FIDELITY_MIDI_VAL;
-		swprintf(wcp_key_name, L"%s", DFXP_REGISTRY_VALUE_FIDELITY_WIDE);
+		i_key = DFXP_SESSION_KEY_VALUE_FIDELITY;
 	}
 	else if (i_knob_type == DFX_UI_KNOB_AMBIENCE)
 	{
 		default_value = DFXP_INIT_AMBIENCE_MIDI_VAL;
-		swprintf(wcp_key_name, L"%s", DFXP_REGISTRY_VALUE_AMBIENCE_WIDE);
+		i_key = DFXP_SESSION_KEY_VALUE_AMBIENCE;
 	}
 	else if (i_knob_type == DFX_UI_KNOB_DYNAMIC_BOOST)
 	{
 		default_value = DFXP_INIT_DYNAMIC_BOOST_MIDI_VAL;
-		swprintf(wcp_key_name, L"%s", DFXP_REGISTRY_VALUE_DYNAMIC_BOOST_WIDE);
+		i_key = DFXP_SESSION_KEY_VALUE_DYNAMIC_BOOST;
 	}
 	else if (i_knob_type == DFX_UI_KNOB_SURROUND)
 	{
 		default_value = DFXP_INIT_SURROUND_MIDI_VAL;
-		swprintf(wcp_key_name, L"%s", DFXP_REGISTRY_VALUE_SURROUND_WIDE);
+		i_key = DFXP_SESSION_KEY_VALUE_SURROUND;
 	}
 	else if (i_knob_type == DFX_UI_KNOB_BASS_BOOST)
 	{
 		default_value = DFXP_INIT_BASS_BOOST_MIDI_VAL;
-		swprintf(wcp_key_name, L"%s", DFXP_REGISTRY_VALUE_BASS_BOOST_WIDE);
+		i_key = DFXP_SESSION_KEY_VALUE_BASS_BOOST;
 	}
 	else 
 		return(OKAY);
 
 	/* Get the midi value */
-   if (dfxp_SessionReadIntegerValue(hp_dfxp, wcp_key_name, default_value, ip_midi_value) != OKAY)
+   if (dfxp_SessionReadIntegerValue(hp_dfxp, i_key, default_value, ip_midi_value) != OKAY)
 		return(NOT_OKAY);
 
 	return(OKAY);
@@ -143,7 +166,7 @@ int dfxpGetButtonValue(PT_HANDLE *hp_dfxp, int i_button_type, int *ip_value)
 	int default_bypass_value;
 	int default_music_mode;
 	int registry_value;
-	wchar_t wcp_key_name[256];
+	int i_key;
 	int use_opposite_of_registy_value;
 
 	cast_handle = (struct dfxpHdlType *)(hp_dfxp);
@@ -167,7 +190,7 @@ int dfxpGetButtonValue(PT_HANDLE *hp_dfxp, int i_button_type, int *ip_value)
 	{
 		default_music_mode = DFX_UI_MUSIC_MODE_MUSIC2;
 
-		if (dfxp_SessionReadIntegerValue(hp_dfxp, DFXP_REGISTRY_MODE_MUSIC_MODE_WIDE, default_music_mode, ip_value) != OKAY)
+		if (dfxp_SessionReadIntegerValue(hp_dfxp, DFXP_SESSION_KEY_MODE_MUSIC_MODE, default_music_mode, ip_value) != OKAY)
 			return(NOT_OKAY);
 
 		return(OKAY);
@@ -177,58 +200,58 @@ int dfxpGetButtonValue(PT_HANDLE *hp_dfxp, int i_button_type, int *ip_value)
 	if (i_button_type == DFX_UI_BUTTON_BYPASS)
 	{
 		default_bypass_value = IS_FALSE;
-		swprintf(wcp_key_name, L"%s", DFXP_REGISTRY_BYPASS_ALL_WIDE);
+		i_key = DFXP_SESSION_KEY_BYPASS_ALL;
 		use_opposite_of_registy_value = IS_FALSE;
 	}
 	else if (i_button_type == DFX_UI_BUTTON_FIDELITY)
 	{
 		default_bypass_value = IS_FALSE;
-		swprintf(wcp_key_name, L"%s", DFXP_REGISTRY_BYPASS_FIDELITY_WIDE);
+		i_key = DFXP_SESSION_KEY_BYPASS_FIDELITY;
 		use_opposite_of_registy_value = IS_TRUE;
 	}
 	else if (i_button_type == DFX_UI_BUTTON_AMBIENCE)
 	{
 		default_bypass_value = IS_FALSE;
-		swprintf(wcp_key_name, L"%s", DFXP_REGISTRY_BYPASS_AMBIENCE_WIDE);
+		i_key = DFXP_SESSION_KEY_BYPASS_AMBIENCE;
 		use_opposite_of_registy_value = IS_TRUE;
 	}
 	else if (i_button_type == DFX_UI_BUTTON_DYNAMIC_BOOST)
 	{
 		default_bypass_value = IS_FALSE;
 
-		swprintf(wcp_key_name, L"%s", DFXP_REGISTRY_BYPASS_DYNAMIC_BOOST_WIDE);
+		i_key = DFXP_SESSION_KEY_BYPASS_DYNAMIC_BOOST;
 		use_opposite_of_registy_value = IS_TRUE;
 	}
 	else if (i_button_type == DFX_UI_BUTTON_SURROUND)
 	{
 		default_bypass_value = IS_FALSE;
 
-		swprintf(wcp_key_name, L"%s", DFXP_REGISTRY_BYPASS_SURROUND_WIDE);
+		i_key = DFXP_SESSION_KEY_BYPASS_SURROUND;
 		use_opposite_of_registy_value = IS_TRUE;
 	}
 	else if (i_button_type == DFX_UI_BUTTON_BASS_BOOST)
 	{
 		default_bypass_value = IS_FALSE;
-		swprintf(wcp_key_name, L"%s", DFXP_REGISTRY_BYPASS_BASS_BOOST_WIDE);
+		i_key = DFXP_SESSION_KEY_BYPASS_BASS_BOOST;
 		use_opposite_of_registy_value = IS_TRUE;
 	}
 	else if (i_button_type == DFX_UI_BUTTON_HEADPHONE)
 	{
 		default_bypass_value = IS_TRUE;
-		swprintf(wcp_key_name, L"%s", DFXP_REGISTRY_BYPASS_HEADPHONE_WIDE);
+		i_key = DFXP_SESSION_KEY_BYPASS_HEADPHONE;
 		use_opposite_of_registy_value = IS_TRUE;
 	}
 	else if (i_button_type == DFX_UI_BUTTON_REMIX_BYPASS)
 	{
 		default_bypass_value = IS_FALSE;
-		swprintf(wcp_key_name, L"%s", DFXP_REGISTRY_REMIX_BYPASS_ALL_WIDE);
+		i_key = DFXP_SESSION_KEY_REMIX_BYPASS_ALL;
 		use_opposite_of_registy_value = IS_FALSE;;
 	}
 	else
 		return(NOT_OKAY);
 
 	/* Read the value from the registry */
-	if (dfxp_SessionReadIntegerValue(hp_dfxp, wcp_key_name, default_bypass_value, &registry_value) != OKAY)
+	if (dfxp_SessionReadIntegerValue(hp_dfxp, i_key, default_bypass_value, &registry_value) != OKAY)
 		return(NOT_OKAY);
 
 	if (use_opposite_of_registy_value)
@@ -321,7 +344,7 @@ int dfxpGetTemporaryBypassAll(PT_HANDLE *hp_dfxp, int *ip_temporary_bypass_all)
 
 	i_default_temporary_bypass_all = IS_FALSE;
 
-	if (dfxp_SessionReadIntegerValue(hp_dfxp, DFXP_REGISTRY_TEMPORARY_BYPASS_ALL_WIDE, 
+	if (dfxp_SessionReadIntegerValue(hp_dfxp, DFXP_SESSION_KEY_TEMPORARY_BYPASS_ALL, 
 											   i_default_temporary_bypass_all, ip_temporary_bypass_all) != OKAY)
 		return(NOT_OKAY);
 
@@ -347,7 +370,7 @@ int dfxpGetDfxTunedTrackPlaying(PT_HANDLE *hp_dfxp, int *ip_dfx_tuned_track_play
 
 	i_default_dfx_tuned_track_playing = IS_FALSE;
 
-	if (dfxp_SessionReadIntegerValue(hp_dfxp, DFXP_REGISTRY_DFX_TUNED_TRACK_PLAYING_WIDE, 
+	if (dfxp_SessionReadIntegerValue(hp_dfxp, DFXP_SESSION_KEY_DFX_TUNED_TRACK_PLAYING, 
 												i_default_dfx_tuned_track_playing, ip_dfx_tuned_track_playing) != OKAY)
 		return(NOT_OKAY);
 
@@ -378,5 +401,59 @@ int dfxpGetTotalAudioProcessedTime(PT_HANDLE *hp_dfxp, unsigned long *ul_msec_au
 
 	*ul_msec_audio_processed_time = cast_handle->ul_total_msecs_audio_processed_time;
 
+	return(OKAY);
+}
+
+/*
+ * FUNCTION: dfxpGetTruePeakOn()
+ * DESCRIPTION:
+ *   Passes back whether the optimizer limits true peaks, see dfxpSetTruePeakOn().
+ */
+int dfxpGetTruePeakOn(PT_HANDLE *hp_dfxp, int *ip_true_peak_on)
+{
+	struct dfxpHdlType *cast_handle;
+
+	cast_handle = (struct dfxpHdlType *)(hp_dfxp);
+
+	*ip_true_peak_on = IS_FALSE;
+
+	if (cast_handle == NULL)
+		return(OKAY);
+
+	*ip_true_peak_on = cast_handle->true_peak_on;
+
+	return(OKAY);
+}
+
+/*
+ * FUNCTION: dfxpGetOptimizerLatency()
+ * DESCRIPTION:
+ *   Passes back the delay the optimizer adds, in sample sets at the signal's sampling
+ *   frequency. This is the look ahead delay, plus the interpolator delay in true peak mode.
+ */
+int dfxpGetOptimizerLatency(PT_HANDLE *hp_dfxp, int *ip_latency)
+{
+	struct dfxpHdlType *cast_handle;
+	int max_delay;
+
+	cast_handle = (struct dfxpHdlType *)(hp_dfxp);
+
+	*ip_latency = 0;
+
+	if (cast_handle == NULL)
+		return(OKAY);
+
+	/* Same look ahead as dfxp_CommunicateDynamicBoost() sends, and the kernel's range for it */
+	max_delay = (int)(cast_handle->internal_sampling_freq * (realtype)MAXI_LOOK_AHEAD_DELAY);
+	if (max_delay < 1)
+		max_delay = 1;
+	else if (max_delay > MAXI_MAX_DELAY_LEN)
+		max_delay = MAXI_MAX_DELAY_LEN;
+
+	if (cast_handle->true_peak_on)
+		max_delay += MAXI_TRUE_PEAK_LATENCY;
+
+	*ip_latency = max_delay * cast_handle->internal_rate_ratio;
+
 	return(OKAY);
 }
\ No newline at end of file
@@ -85,9 +85,23 @@ int dfxpInit(PT_HANDLE **hpp_dfxp,
 	
 	cast_handle->major_version = (int)DFX_VERSION;
 
+	/* Read the session values into memory, from here on the registry is only written by the session writer thread */
+	if (dfxp_SessionStoreInit((PT_HANDLE *)cast_handle) != OKAY)
+		return(NOT_OKAY);
+
+	/* Queue for parameter changes made from the UI thread */
+	if (dfxp_ParamInit((PT_HANDLE *)cast_handle) != OKAY)
+		return(NOT_OKAY);
+
 	/* Init the processing override */
 	cast_handle->processing_override = DFXP_PROCESSING_OVERRIDE_NONE;
 
+	/* Optimizer starts out limiting sample peaks, see dfxpSetTruePeakOn() */
+	cast_handle->true_peak_on = IS_FALSE;
+
+	/* Surround workers are only started by dfxpSetParallelSurround() */
+	cast_handle->surround_pool.store(NULL);
+
 	/* Calculates if this is the first time DFX has been run since installation. */
    if (dfxp_InitFirstTimeRunFlag((PT_HANDLE *)cast_handle) != OKAY)
 		return(NOT_OKAY);
@@ -0,0 +1,776 @@
+/*
+FxSound
+Copyright (C) 2025  FxSound LLC
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/* dfxpParam.cpp */
+
+#include "codedefs.h"
+
+#include <windows.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <atomic>
+#include <new>
+
+#include "u_dfxp.h"
+
+#include "dfxp.h"
+#include "DfxSdk.h"
+#include "qnt.h"
+#include "midi.h"
+#include "GraphicEq.h"
+
+/*
+ * Parameter queue.
+ * The UI thread used to set knobs, buttons and EQ bands by writing straight into the processing
+ * state while the audio thread was running it, and a knob drag stepped the processing in jumps.
+ * The dfxpParamSet...() calls below still write the session right away, so reads and presets see
+ * the new value at once, but the processing change is pushed onto a single producer single consumer
+ * queue. The audio thread drains it once per buffer in dfxpParamDrain(), sends the buttons on and
+ * starts a short linear ramp for each knob and EQ band that changed. dfxp_ParamRampStep() advances
+ * the active ramps between sub-blocks of the buffer, so the cost per buffer is in the order of the
+ * number of parameters changed.
+ *
+ * The queue only carries which parameter changed, the value is read back from the session (or the
+ * requested frequency) when it is drained. If the queue is ever full every parameter is resent.
+ */
+#define DFXP_PARAM_QUEUE_SIZE    64 /* Commands, must be a power of two */
+#define DFXP_PARAM_RAMP_MSECS    30
+#define DFXP_PARAM_NUM_KNOBS     10 /* Knob types are numbered from 1 to DFX_UI_KNOB_VIDEO_PROCESS_VIDEO */
+
+#define DFXP_PARAM_KNOB          1
+#define DFXP_PARAM_BUTTON        2
+#define DFXP_PARAM_EQ_BOOST_CUT  3
+#define DFXP_PARAM_EQ_FREQ       4
+
+/* Ramp slots, the knobs followed by the EQ band boost/cuts and the EQ band frequencies */
+#define DFXP_PARAM_RAMP_EQ_BOOST_CUT  DFXP_PARAM_NUM_KNOBS
+#define DFXP_PARAM_RAMP_EQ_FREQ       (DFXP_PARAM_NUM_KNOBS + DFXP_GRAPHIC_EQ_NUM_BANDS)
+#define DFXP_PARAM_NUM_RAMPS          (DFXP_PARAM_NUM_KNOBS + 2 * DFXP_GRAPHIC_EQ_NUM_BANDS)
+
+struct dfxpParamCommandType {
+	int type;
+	int index;       /* Knob type, button type or EQ band number */
+	realtype from;   /* Knob value before the change, in MIDI representation */
+};
+
+struct dfxpParamRampType {
+	int active;
+	realtype current;
+	realtype target;
+	long remaining;  /* Sample sets left until the target is reached */
+	int applied;     /* Knobs only, MIDI value last sent to the processing */
+};
+
+struct dfxpParamType {
+	struct dfxpParamCommandType queue[DFXP_PARAM_QUEUE_SIZE];
+	std::atomic<unsigned long> write_count;  /* Only written by the UI thread */
+	std::atomic<unsigned long> read_count;   /* Only written by the audio thread */
+	std::atomic<int> overflow;               /* A command was dropped, everything is resent */
+
+	/* Requested EQ band frequencies, 0 until a band has been moved */
+	std::atomic<float> eq_freq[DFXP_GRAPHIC_EQ_NUM_BANDS];
+
+	/* Knob value the processing is ramping through, -1 when not ramping */
+	std::atomic<int> knob_ramp_midi[DFXP_PARAM_NUM_KNOBS];
+
+	/* Audio thread only */
+	struct dfxpParamRampType ramps[DFXP_PARAM_NUM_RAMPS];
+	int active[DFXP_PARAM_NUM_RAMPS];
+	int num_active;
+};
+
+static int dfxp_ParamPush(struct dfxpHdlType *, int, int, realtype);
+static int dfxp_ParamRampStart(struct dfxpHdlType *, int, realtype, realtype);
+static int dfxp_ParamRampApply(struct dfxpHdlType *, int);
+static int dfxp_ParamResendAll(struct dfxpHdlType *);
+
+/*
+ * FUNCTION: dfxp_ParamInit()
+ * DESCRIPTION:
+ *   Creates the parameter queue. If it can not be allocated the dfxpParamSet...() calls fall back
+ *   to setting the processing directly.
+ */
+int dfxp_ParamInit(PT_HANDLE *hp_dfxp)
+{
+	struct dfxpHdlType *cast_handle;
+	struct dfxpParamType *sp_param;
+	int i;
+
+	cast_handle = (struct dfxpHdlType *)(hp_dfxp);
+
+	if (cast_handle == NULL)
+		return(OKAY);
+
+	if (cast_handle->param != NULL)
+		return(OKAY);
+
+	sp_param = new (std::nothrow) struct dfxpParamType;
+	if (sp_param == NULL)
+		return(OKAY);
+
+	sp_param->write_count.store(0);
+	sp_param->read_count.store(0);
+	sp_param->overflow.store(IS_FALSE);
+
+	for (i = 0; i < DFXP_GRAPHIC_EQ_NUM_BANDS; i++)
+		sp_param->eq_freq[i].store(0.0f);
+
+	for (i = 0; i < DFXP_PARAM_NUM_KNOBS; i++)
+		sp_param->knob_ramp_midi[i].store(-1);
+
+	for (i = 0; i < DFXP_PARAM_NUM_RAMPS; i++)
+	{
+		sp_param->ramps[i].active = IS_FALSE;
+		sp_param->ramps[i].current = (realtype)0.0;
+		sp_param->ramps[i].target = (realtype)0.0;
+		sp_param->ramps[i].remaining = 0;
+		sp_param->ramps[i].applied = -1;
+	}
+	sp_param->num_active = 0;
+
+	cast_handle->param = sp_param;
+
+	return(OKAY);
+}
+
+/*
+ * FUNCTION: dfxp_ParamFree()
+ * DESCRIPTION:
+ *   Frees the parameter queue, processing must have stopped.
+ */
+int dfxp_ParamFree(PT_HANDLE *hp_dfxp)
+{
+	struct dfxpHdlType *cast_handle;
+
+	cast_handle = (struct dfxpHdlType *)(hp_dfxp);
+
+	if (cast_handle == NULL)
+		return(OKAY);
+
+	if (cast_handle->param == NULL)
+		return(OKAY);
+
+	delete cast_handle->param;
+	cast_handle->param = NULL;
+
+	return(OKAY);
+}
+
+/*
+ * FUNCTION: dfxpParamSetKnobValue()
+ * DESCRIPTION:
+ *   Sets the passed knob to the specified value (in float representation), the processing
+ *   ramps to it on the audio thread. Called from the UI thread.
+ */
+int dfxpParamSetKnobValue(PT_HANDLE *hp_dfxp, int i_knob_type, float f_value)
+{
+	struct dfxpHdlType *cast_handle;
+
+	cast_handle = (struct dfxpHdlType *)(hp_dfxp);
+
+	if (cast_handle == NULL)
+		return(OKAY);
+
+	int midi_val;
+	int old_midi_val;
+	realtype r_eq_setting_db;
+
+	if (cast_handle->param == NULL)
+		return( dfxpSetKnobValue(hp_dfxp, i_knob_type, f_value, false) );
+
+   if (!(cast_handle->fully_initialized))
+		return(NOT_OKAY);
+
+	if ((i_knob_type < 1) || (i_knob_type >= DFXP_PARAM_NUM_KNOBS))
+		return(NOT_OKAY);
+
+	/* Make sure it is in the proper range */
+	if ((f_value < DFX_UI_MIN_VALUE) || (f_value > DFX_UI_MAX_VALUE))
+		return(NOT_OKAY);
+
+	/* Convert the passed real value to the proper MIDI value */
+	if (qntRToICalc(cast_handle->real_to_midi_qnt_hdl, (realtype)f_value, &midi_val) != OKAY)
+		return(NOT_OKAY);
+
+	if (dfxp_GetKnobSessionValue_MIDI(hp_dfxp, i_knob_type, &old_midi_val) != OKAY)
+		return(NOT_OKAY);
+
+	if (dfxp_SessionWriteKnobValue_MIDI(hp_dfxp, i_knob_type, midi_val) != OKAY)
+		return(NOT_OKAY);
+
+	if (dfxp_ParamPush(cast_handle, DFXP_PARAM_KNOB, i_knob_type, (realtype)old_midi_val) != OKAY)
+		return(NOT_OKAY);
+
+	/* EQ band 1 follows HyperBass, see dfxp_SetKnobValue_MIDI() */
+	if (i_knob_type == DFX_UI_KNOB_BASS_BOOST)
+	{
+		if (dfxp_CalcBassBoostEqBand1(hp_dfxp, midi_val, &r_eq_setting_db) != OKAY)
+			return(NOT_OKAY);
+
+		if (dfxpParamSetEqBandBoostCut(hp_dfxp, 1, r_eq_setting_db) != OKAY)
+			return(NOT_OKAY);
+	}
+
+	return(OKAY);
+}
+
+/*
+ * FUNCTION: dfxpParamSetButtonValue()
+ * DESCRIPTION:
+ *   Sets the passed button on or off, the processing picks it up on the audio thread.
+ *   Called from the UI thread.
+ */
+int dfxpParamSetButtonValue(PT_HANDLE *hp_dfxp, int i_button_type, int i_value)
+{
+	struct dfxpHdlType *cast_handle;
+
+	cast_handle = (struct dfxpHdlType *)(hp_dfxp);
+
+	if (cast_handle == NULL)
+		return(OKAY);
+
+	if (cast_handle->param == NULL)
+		return( dfxpSetButtonValue(hp_dfxp, i_button_type, i_value) );
+
+   if (!(cast_handle->fully_initialized))
+		return(NOT_OKAY);
+
+	if (dfxp_SessionWriteButtonValue(hp_dfxp, i_button_type, i_value) != OKAY)
+		return(NOT_OKAY);
+
+	return( dfxp_ParamPush(cast_handle, DFXP_PARAM_BUTTON, i_button_type, (realtype)0.0) );
+}
+
+/*
+ * FUNCTION: dfxpParamSetEqBandBoostCut()
+ * DESCRIPTION:
+ *   Sets the boost or cut of the passed EQ band in dB, the processing ramps to it on the audio
+ *   thread. Called from the UI thread.
+ */
+int dfxpParamSetEqBandBoostCut(PT_HANDLE *hp_dfxp, int i_band_num, realtype r_boost_cut)
+{
+	struct dfxpHdlType *cast_handle;
+
+	cast_handle = (struct dfxpHdlType *)(hp_dfxp);
+
+	if (cast_handle == NULL)
+		return(OKAY);
+
+	if (cast_handle->param == NULL)
+		return( dfxpEqSetBandBoostCut(hp_dfxp, DFXP_STORAGE_TYPE_ALL, i_band_num, r_boost_cut) );
+
+	if ((i_band_num < 1) || (i_band_num > DFXP_GRAPHIC_EQ_NUM_BANDS))
+		return(NOT_OKAY);
+
+	if (dfxpEqSetBandBoostCut(hp_dfxp, DFXP_STORAGE_TYPE_REGISTRY, i_band_num, r_boost_cut) != OKAY)
+		return(NOT_OKAY);
+
+	return( dfxp_ParamPush(cast_handle, DFXP_PARAM_EQ_BOOST_CUT, i_band_num, (realtype)0.0) );
+}
+
+/*
+ * FUNCTION: dfxpParamSetEqBandFrequency()
+ * DESCRIPTION:
+ *   Sets the center frequency of the passed EQ band, the processing ramps to it on the audio
+ *   thread. Called from the UI thread.
+ */
+int dfxpParamSetEqBandFrequency(PT_HANDLE *hp_dfxp, int i_band_num, realtype r_band_freq)
+{
+	struct dfxpHdlType *cast_handle;
+	PT_HANDLE *hp_graphicEq;
+
+	cast_handle = (struct dfxpHdlType *)(hp_dfxp);
+
+	if (cast_handle == NULL)
+		return(OKAY);
+
+	if ((i_band_num < 1) || (i_band_num > DFXP_GRAPHIC_EQ_NUM_BANDS))
+		return(NOT_OKAY);
+
+	if (cast_handle->param == NULL)
+	{
+		if (dfxpEqGetGraphicEqHdl(hp_dfxp, &hp_graphicEq) != OKAY)
+			return(NOT_OKAY);
+
+		return( GraphicEqSetBandFreq(hp_graphicEq, i_band_num, r_band_freq) );
+	}
+
+	if (r_band_freq <= (realtype)0.0)
+		return(NOT_OKAY);
+
+	cast_handle->param->eq_freq[i_band_num - 1].store((float)r_band_freq);
+
+	return( dfxp_ParamPush(cast_handle, DFXP_PARAM_EQ_FREQ, i_band_num, (realtype)0.0) );
+}
+
+/*
+ * FUNCTION: dfxp_ParamPush()
+ * DESCRIPTION:
+ *   Adds a command to the queue. When the queue is full the command is dropped and the audio
+ *   thread resends every parameter instead.
+ */
+static int dfxp_ParamPush(struct dfxpHdlType *cast_handle, int i_type, int i_index, realtype r_from)
+{
+	struct dfxpParamType *sp_param = cast_handle->param;
+	unsigned long ul_write;
+	struct dfxpParamCommandType *sp_command;
+
+	ul_write = sp_param->write_count.load(std::memory_order_relaxed);
+
+	if ((ul_write - sp_param->read_count.load(std::memory_order_acquire)) >= DFXP_PARAM_QUEUE_SIZE)
+	{
+		sp_param->overflow.store(IS_TRUE, std::memory_order_release);
+		return(OKAY);
+	}
+
+	sp_command = &(sp_param->queue[ul_write & (DFXP_PARAM_QUEUE_SIZE - 1)]);
+	sp_command->type = i_type;
+	sp_command->index = i_index;
+	sp_command->from = r_from;
+
+	sp_param->write_count.store(ul_write + 1, std::memory_order_release);
+
+	return(OKAY);
+}
+
+/*
+ * FUNCTION: dfxpParamDrain()
+ * DESCRIPTION:
+ *   Takes the queued commands off the queue, sends the button changes on to the processing and
+ *   starts the ramps for the knob and EQ changes. Called from the audio thread once per buffer.
+ */
+int dfxpParamDrain(PT_HANDLE *hp_dfxp)
+{
+	struct dfxpHdlType *cast_handle;
+	struct dfxpParamType *sp_param;
+	struct dfxpParamCommandType command;
+	unsigned long ul_read;
+	unsigned long ul_write;
+	realtype r_start;
+	realtype r_target;
+	wchar_t wcp_boost_cut[PT_MAX_GENERIC_STRLEN];
+	int i_midi_value;
+
+	cast_handle = (struct dfxpHdlType *)(hp_dfxp);
+
+	if (cast_handle == NULL)
+		return(OKAY);
+
+	sp_param = cast_handle->param;
+	if (sp_param == NULL)
+		return(OKAY);
+
+	ul_read = sp_param->read_count.load(std::memory_order_relaxed);
+	ul_write = sp_param->write_count.load(std::memory_order_acquire);
+
+	for ( ; ul_read != ul_write; ul_read++)
+	{
+		command = sp_param->queue[ul_read & (DFXP_PARAM_QUEUE_SIZE - 1)];
+		sp_param->read_count.store(ul_read + 1, std::memory_order_release);
+
+		if (command.type == DFXP_PARAM_BUTTON)
+		{
+			if (dfxp_CommunicateButton(hp_dfxp, command.index) != OKAY)
+				return(NOT_OKAY);
+		}
+		else if (command.type == DFXP_PARAM_KNOB)
+		{
+			if (dfxp_GetKnobSessionValue_MIDI(hp_dfxp, command.index, &i_midi_value) != OKAY)
+				return(NOT_OKAY);
+
+			if (dfxp_ParamRampStart(cast_handle, command.index, command.from, (realtype)i_midi_value) != OKAY)
+				return(NOT_OKAY);
+
+			/* The ramp sends the knob, dfxpCommunicateChanged() does not need to */
+			if (dfxp_CommunicateClearChanged(hp_dfxp, dfxp_CommunicateKnobFlags(command.index)) != OKAY)
+				return(NOT_OKAY);
+		}
+		else if (command.type == DFXP_PARAM_EQ_BOOST_CUT)
+		{
+			if (dfxpEqGetBandBoostCut_FromRegistry(hp_dfxp, command.index, &r_target, wcp_boost_cut) != OKAY)
+				return(NOT_OKAY);
+
+			if (dfxpParamRampEqBandBoostCut(hp_dfxp, command.index, r_target) != OKAY)
+				return(NOT_OKAY);
+		}
+		else if (command.type == DFXP_PARAM_EQ_FREQ)
+		{
+			if (dfxpEqGetBandCenterFrequency(hp_dfxp, command.index, &r_start) != OKAY)
+				return(NOT_OKAY);
+
+			r_target = (realtype)sp_param->eq_freq[command.index - 1].load();
+
+			if (dfxp_ParamRampStart(cast_handle, DFXP_PARAM_RAMP_EQ_FREQ + command.index - 1, r_start, r_target) != OKAY)
+				return(NOT_OKAY);
+		}
+	}
+
+	if (sp_param->overflow.exchange(IS_FALSE, std::memory_order_acquire))
+	{
+		if (dfxp_ParamResendAll(cast_handle) != OKAY)
+			return(NOT_OKAY);
+	}
+
+	return(OKAY);
+}
+
+/*
+ * FUNCTION: dfxpParamRampEqBandBoostCut()
+ * DESCRIPTION:
+ *   Ramps the processing of the passed EQ band to the specified boost or cut, without changing
+ *   the session value. A ramp already running for the band is retargeted. Audio thread only.
+ */
+int dfxpParamRampEqBandBoostCut(PT_HANDLE *hp_dfxp, int i_band_num, realtype r_boost_cut)
+{
+	struct dfxpHdlType *cast_handle;
+	realtype r_current;
+
+	cast_handle = (struct dfxpHdlType *)(hp_dfxp);
+
+	if (cast_handle == NULL)
+		return(OKAY);
+
+	if (cast_handle->param == NULL)
+		return( dfxpEqSetBandBoostCut(hp_dfxp, DFXP_STORAGE_TYPE_MEMORY, i_band_num, r_boost_cut) );
+
+	if ((i_band_num < 1) || (i_band_num > DFXP_GRAPHIC_EQ_NUM_BANDS))
+		return(NOT_OKAY);
+
+	if (cast_handle->eq.graphicEq_hdl == NULL)
+		return(NOT_OKAY);
+
+	if (r_boost_cut < DFXP_GRAPHIC_EQ_MIN_BOOST_OR_CUT_DB)
+		r_boost_cut = DFXP_GRAPHIC_EQ_MIN_BOOST_OR_CUT_DB;
+	else if (r_boost_cut > DFXP_GRAPHIC_EQ_MAX_BOOST_OR_CUT_DB)
+		r_boost_cut = DFXP_GRAPHIC_EQ_MAX_BOOST_OR_CUT_DB;
+
+	if (GraphicEqGetBandBoostCut(cast_handle->eq.graphicEq_hdl, i_band_num, &r_current) != OKAY)
+		return(NOT_OKAY);
+
+	return( dfxp_ParamRampStart(cast_handle, DFXP_PARAM_RAMP_EQ_BOOST_CUT + i_band_num - 1, r_current, r_boost_cut) );
+}
+
+/*
+ * FUNCTION: dfxpParamRampKnobValue()
+ * DESCRIPTION:
+ *   Sets the passed knob to the specified value (in float representation) and ramps the processing
+ *   to it, without going through the queue. Used when EQ band 1 moves HyperBass, so band 1 is left
+ *   where it is. Audio thread only.
+ */
+int dfxpParamRampKnobValue(PT_HANDLE *hp_dfxp, int i_knob_type, float f_value)
+{
+	struct dfxpHdlType *cast_handle;
+	int midi_val;
+	int old_midi_val;
+
+	cast_handle = (struct dfxpHdlType *)(hp_dfxp);
+
+	if (cast_handle == NULL)
+		return(OKAY);
+
+	if (cast_handle->param == NULL)
+		return( dfxpSetKnobValue(hp_dfxp, i_knob_type, f_value, true) );
+
+   if (!(cast_handle->fully_initialized))
+		return(NOT_OKAY);
+
+	if ((i_knob_type < 1) || (i_knob_type >= DFXP_PARAM_NUM_KNOBS))
+		return(NOT_OKAY);
+
+	if ((f_value < DFX_UI_MIN_VALUE) || (f_value > DFX_UI_MAX_VALUE))
+		return(NOT_OKAY);
+
+	if (qntRToICalc(cast_handle->real_to_midi_qnt_hdl, (realtype)f_value, &midi_val) != OKAY)
+		return(NOT_OKAY);
+
+	if (dfxp_GetKnobSessionValue_MIDI(hp_dfxp, i_knob_type, &old_midi_val) != OKAY)
+		return(NOT_OKAY);
+
+	if (dfxp_SessionWriteKnobValue_MIDI(hp_dfxp, i_knob_type, midi_val) != OKAY)
+		return(NOT_OKAY);
+
+	if (dfxp_ParamRampStart(cast_handle, i_knob_type, (realtype)old_midi_val, (realtype)midi_val) != OKAY)
+		return(NOT_OKAY);
+
+	/* The ramp sends the knob, as in dfxpParamDrain() */
+	return( dfxp_CommunicateClearChanged(hp_dfxp, dfxp_CommunicateKnobFlags(i_knob_type)) );
+}
+
+/*
+ * FUNCTION: dfxp_ParamRampStart()
+ * DESCRIPTION:
+ *   Starts the passed ramp slot from r_start towards r_target. A ramp that is already running
+ *   carries on from where it is.
+ */
+static int dfxp_ParamRampStart(struct dfxpHdlType *cast_handle, int i_ramp, realtype r_start, realtype r_target)
+{
+	struct dfxpParamType *sp_param = cast_handle->param;
+	struct dfxpParamRampType *sp_ramp = &(sp_param->ramps[i_ramp]);
+
+	if (!sp_ramp->active)
+	{
+		if (r_start == r_target)
+			return(OKAY);
+
+		sp_ramp->current = r_start;
+		sp_ramp->active = IS_TRUE;
+		sp_param->active[sp_param->num_active] = i_ramp;
+		(sp_param->num_active)++;
+
+		if (i_ramp < DFXP_PARAM_NUM_KNOBS)
+		{
+			sp_ramp->applied = (int)(r_start + (realtype)0.5);
+			sp_param->knob_ramp_midi[i_ramp].store(sp_ramp->applied);
+		}
+	}
+
+	sp_ramp->target = r_target;
+	sp_ramp->remaining = (long)(cast_handle->universal.last_called_srate / 1000) * DFXP_PARAM_RAMP_MSECS;
+
+	return(OKAY);
+}
+
+/*
+ * FUNCTION: dfxp_ParamRamping()
+ * DESCRIPTION:
+ *   Passes back whether any ramp is running, the buffer is then processed in sub-blocks of
+ *   DFXP_PARAM_RAMP_BLOCK_SIZE sample sets.
+ */
+int dfxp_ParamRamping(PT_HANDLE *hp_dfxp, int *ip_ramping)
+{
+	struct dfxpHdlType *cast_handle;
+
+	cast_handle = (struct dfxpHdlType *)(hp_dfxp);
+
+	*ip_ramping = IS_FALSE;
+
+	if (cast_handle == NULL)
+		return(OKAY);
+
+	if (cast_handle->param == NULL)
+		return(OKAY);
+
+	*ip_ramping = (cast_handle->param->num_active > 0);
+
+	return(OKAY);
+}
+
+/*
+ * FUNCTION: dfxp_ParamRampStep()
+ * DESCRIPTION:
+ *   Moves the running ramps on by the passed number of sample sets and sends the new values
+ *   to the processing. Called before each sub-block.
+ */
+int dfxp_ParamRampStep(PT_HANDLE *hp_dfxp, int i_num_sample_sets)
+{
+	struct dfxpHdlType *cast_handle;
+	struct dfxpParamType *sp_param;
+	struct dfxpParamRampType *sp_ramp;
+	int i;
+	int i_ramp;
+
+	cast_handle = (struct dfxpHdlType *)(hp_dfxp);
+
+	if (cast_handle == NULL)
+		return(OKAY);
+
+	sp_param = cast_handle->param;
+	if (sp_param == NULL)
+		return(OKAY);
+
+	i = 0;
+	while (i < sp_param->num_active)
+	{
+		i_ramp = sp_param->active[i];
+		sp_ramp = &(sp_param->ramps[i_ramp]);
+
+		if (sp_ramp->remaining <= i_num_sample_sets)
+		{
+			sp_ramp->current = sp_ramp->target;
+			sp_ramp->remaining = 0;
+		}
+		else
+		{
+			sp_ramp->current += (sp_ramp->target - sp_ramp->current) * (realtype)i_num_sample_sets / (realtype)sp_ramp->remaining;
+			sp_ramp->remaining -= i_num_sample_sets;
+		}
+
+		if (dfxp_ParamRampApply(cast_handle, i_ramp) != OKAY)
+			return(NOT_OKAY);
+
+		/* Finished ramps are swapped out of the active list */
+		if (sp_ramp->remaining == 0)
+		{
+			sp_ramp->active = IS_FALSE;
+			(sp_param->num_active)--;
+			sp_param->active[i] = sp_param->active[sp_param->num_active];
+		}
+		else
+			i++;
+	}
+
+	return(OKAY);
+}
+
+/*
+ * FUNCTION: dfxp_ParamRampApply()
+ * DESCRIPTION:
+ *   Sends the current value of the passed ramp slot to the processing.
+ */
+static int dfxp_ParamRampApply(struct dfxpHdlType *cast_handle, int i_ramp)
+{
+	struct dfxpParamType *sp_param = cast_handle->param;
+	struct dfxpParamRampType *sp_ramp = &(sp_param->ramps[i_ramp]);
+	PT_HANDLE *hp_dfxp = (PT_HANDLE *)cast_handle;
+	int i_midi_value;
+
+	if (i_ramp < DFXP_PARAM_NUM_KNOBS)
+	{
+		/* Knobs are sent in whole MIDI steps, only when the step changes */
+		i_midi_value = (int)(sp_ramp->current + (realtype)0.5);
+
+		if (sp_ramp->remaining == 0)
+			sp_param->knob_ramp_midi[i_ramp].store(-1);
+		else
+			sp_param->knob_ramp_midi[i_ramp].store(i_midi_value);
+
+		if (i_midi_value != sp_ramp->applied)
+		{
+			sp_ramp->applied = i_midi_value;
+			if (dfxp_CommunicateKnob(hp_dfxp, i_ramp) != OKAY)
+				return(NOT_OKAY);
+		}
+	}
+	else if (i_ramp < DFXP_PARAM_RAMP_EQ_FREQ)
+	{
+		if (dfxpEqSetBandBoostCut(hp_dfxp, DFXP_STORAGE_TYPE_MEMORY, i_ramp - DFXP_PARAM_RAMP_EQ_BOOST_CUT + 1, sp_ramp->current) != OKAY)
+			return(NOT_OKAY);
+	}
+	else
+	{
+		if (cast_handle->eq.graphicEq_hdl == NULL)
+			return(NOT_OKAY);
+
+		if (GraphicEqSetBandFreq(cast_handle->eq.graphicEq_hdl, i_ramp - DFXP_PARAM_RAMP_EQ_FREQ + 1, sp_ramp->current) != OKAY)
+			return(NOT_OKAY);
+	}
+
+	return(OKAY);
+}
+
+/*
+ * FUNCTION: dfxp_ParamResendAll()
+ * DESCRIPTION:
+ *   Called when a command was dropped from a full queue. Ends all the ramps and sends every
+ *   parameter to the processing from the session and the requested frequencies.
+ */
+static int dfxp_ParamResendAll(struct dfxpHdlType *cast_handle)
+{
+	struct dfxpParamType *sp_param = cast_handle->param;
+	PT_HANDLE *hp_dfxp = (PT_HANDLE *)cast_handle;
+	realtype r_boost_cut;
+	realtype r_band_freq;
+	wchar_t wcp_boost_cut[PT_MAX_GENERIC_STRLEN];
+	int i;
+
+	for (i = 0; i < sp_param->num_active; i++)
+		sp_param->ramps[sp_param->active[i]].active = IS_FALSE;
+	sp_param->num_active = 0;
+
+	for (i = 0; i < DFXP_PARAM_NUM_KNOBS; i++)
+		sp_param->knob_ramp_midi[i].store(-1);
+
+	/* dfxpCommunicateChanged() sends the knobs and buttons, after the drain */
+	if (dfxp_CommunicateSetChanged(hp_dfxp, DFXP_COMM_FIDELITY | DFXP_COMM_AMBIENCE | DFXP_COMM_DYNAMIC_BOOST |
+	                                        DFXP_COMM_SPACIOUSNESS | DFXP_COMM_BASS_BOOST | DFXP_COMM_BYPASS | DFXP_COMM_MUSIC_MODE) != OKAY)
+		return(NOT_OKAY);
+
+	for (i = 1; i <= DFXP_GRAPHIC_EQ_NUM_BANDS; i++)
+	{
+		if (dfxpEqGetBandBoostCut_FromRegistry(hp_dfxp, i, &r_boost_cut, wcp_boost_cut) != OKAY)
+			return(NOT_OKAY);
+		if (dfxpEqSetBandBoostCut(hp_dfxp, DFXP_STORAGE_TYPE_MEMORY, i, r_boost_cut) != OKAY)
+			return(NOT_OKAY);
+
+		r_band_freq = (realtype)sp_param->eq_freq[i - 1].load();
+		if ((r_band_freq > (realtype)0.0) && (cast_handle->eq.graphicEq_hdl != NULL))
+		{
+			if (GraphicEqSetBandFreq(cast_handle->eq.graphicEq_hdl, i, r_band_freq) != OKAY)
+				return(NOT_OKAY);
+		}
+	}
+
+	return(OKAY);
+}
+
+/*
+ * FUNCTION: dfxp_ParamGetKnobRamp()
+ * DESCRIPTION:
+ *   Passes back the value the processing is ramping the passed knob through, and whether it is ramping.
+ */
+int dfxp_ParamGetKnobRamp(PT_HANDLE *hp_dfxp, int i_knob_type, int *ip_midi_value, int *ip_ramping)
+{
+	struct dfxpHdlType *cast_handle;
+	int i_midi_value;
+
+	cast_handle = (struct dfxpHdlType *)(hp_dfxp);
+
+	*ip_ramping = IS_FALSE;
+
+	if (cast_handle == NULL)
+		return(OKAY);
+
+	if ((cast_handle->param == NULL) || (i_knob_type < 1) || (i_knob_type >= DFXP_PARAM_NUM_KNOBS))
+		return(OKAY);
+
+	i_midi_value = cast_handle->param->knob_ramp_midi[i_knob_type].load();
+	if (i_midi_value >= 0)
+	{
+		*ip_midi_value = i_midi_value;
+		*ip_ramping = IS_TRUE;
+	}
+
+	return(OKAY);
+}
+
+/*
+ * FUNCTION: dfxp_ParamGetEqRampTarget()
+ * DESCRIPTION:
+ *   If the passed EQ band is ramping, replaces the passed boost or cut with the value it is ramping to.
+ *   Audio thread only.
+ */
+int dfxp_ParamGetEqRampTarget(PT_HANDLE *hp_dfxp, int i_band_num, realtype *rp_boost_cut)
+{
+	struct dfxpHdlType *cast_handle;
+	struct dfxpParamRampType *sp_ramp;
+
+	cast_handle = (struct dfxpHdlType *)(hp_dfxp);
+
+	if (cast_handle == NULL)
+		return(OKAY);
+
+	if ((cast_handle->param == NULL) || (i_band_num < 1) || (i_band_num > DFXP_GRAPHIC_EQ_NUM_BANDS))
+		return(OKAY);
+
+	sp_ramp = &(cast_handle->param->ramps[DFXP_PARAM_RAMP_EQ_BOOST_CUT + i_band_num - 1]);
+	if (sp_ramp->active)
+		*rp_boost_cut = sp_ramp->target;
+
+	return(OKAY);
+}
@@ -22,6 +22,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <windows.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <time.h>
 
 #include "u_dfxp.h" 
@@ -29,6 +30,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "mth.h"
 #include "realSample.h"
 #include "spectrum.h"
+#include "BinauralSyn.h"
 #include "com.h"
 #include "DfxSdk.h"
 
@@ -131,6 +133,44 @@ int dfxpBeginProcess(PT_HANDLE *hp_dfxp, int i_bits_per_sample, int i_num_channe
 	else
 		cast_handle->unsupported_format_flag = IS_FALSE;
 
+	/* Size the internal sample buffers for the longest buffer the host passes, so the processing path never allocates */
+	{
+		int i_buffer_flags;
+		int i_block_sets;
+
+		i_buffer_flags = DFXP_SAMPLE_BUFFER_CONVERT | DFXP_SAMPLE_BUFFER_DRY;
+		if (i_num_channels > 2)
+			i_buffer_flags |= DFXP_SAMPLE_BUFFER_REORDER;
+
+		i_block_sets = cast_handle->universal.max_block_sets;
+		if (i_block_sets <= 0)
+			i_block_sets = (int)DAW_MAX_BUFFER_SIZE;
+
+		if (dfxp_SizeSampleBuffers(hp_dfxp, i_block_sets, i_buffer_flags) != OKAY)
+			return(NOT_OKAY);
+
+		cast_handle->universal.block_sets = i_block_sets;
+	}
+
+	/* The delay line that lines the crossfade's dry signal up with the chain, long enough for true peak mode */
+	{
+		int i_max_latency_sets;
+
+		if (dfxp_BypassDelayLatency(hp_dfxp, IS_TRUE, &i_max_latency_sets) != OKAY)
+			return(NOT_OKAY);
+
+		if (dfxp_SizeSampleBuffers(hp_dfxp, i_max_latency_sets, DFXP_SAMPLE_BUFFER_DELAY) != OKAY)
+			return(NOT_OKAY);
+
+		cast_handle->bypass_fade.delay_sets = 0;
+		cast_handle->bypass_fade.delay_pos = 0;
+		cast_handle->bypass_fade.delay_fed = IS_FALSE;
+	}
+
+	/* Ask for the binaural coeffs of the new rate, they are built by the BinauralSyn rate worker */
+	if (BinauralSynSetSampFreq(cast_handle->BinauralSyn_hdl, (int)r_sample_rate) != OKAY)
+		return(NOT_OKAY);
+
 	/* Reinitialize the dynamic qnt handles */
    if (dfxp_InitDynamicQnts(hp_dfxp) != OKAY)
 		return(NOT_OKAY);
@@ -176,6 +216,152 @@ int dfxpSetValidBits(PT_HANDLE *hp_dfxp, int i_valid_bits)
 	return(OKAY);
 }
 
+/*
+ * FUNCTION: dfxp_SizeSampleBuffers() 
+ * DESCRIPTION:
+ *   Makes sure the internal sample buffers selected by i_buffer_flags can hold i_num_sample_sets
+ *   sample sets of the current output channel count. A buffer is only reallocated when it has to grow.
+ *   Contents are not preserved. Only called from dfxpBeginProcess(), the processing path uses
+ *   dfxp_SampleBuffersFit().
+ */
+int dfxp_SizeSampleBuffers(PT_HANDLE *hp_dfxp, int i_num_sample_sets, int i_buffer_flags)
+{
+	struct dfxpHdlType *cast_handle;
+	long l_needed_len;
+
+	cast_handle = (struct dfxpHdlType *)(hp_dfxp);
+
+	if (cast_handle == NULL)
+		return(OKAY);
+
+	l_needed_len = (long)cast_handle->num_channels_out * (long)i_num_sample_sets;
+
+	if ((i_buffer_flags & DFXP_SAMPLE_BUFFER_CONVERT) && (l_needed_len > cast_handle->l_samples_len))
+	{
+		if (cast_handle->r_samples != NULL)
+			free(cast_handle->r_samples);
+		cast_handle->l_samples_len = 0;
+
+		cast_handle->r_samples = (realtype *)calloc(l_needed_len, sizeof(realtype));
+		if (cast_handle->r_samples == NULL)
+			return(NOT_OKAY);
+		cast_handle->l_samples_len = l_needed_len;
+	}
+
+	if ((i_buffer_flags & DFXP_SAMPLE_BUFFER_REORDER) && (l_needed_len > cast_handle->l_samples_reordered_len))
+	{
+		if (cast_handle->r_samples_reordered != NULL)
+			free(cast_handle->r_samples_reordered);
+		cast_handle->l_samples_reordered_len = 0;
+
+		cast_handle->r_samples_reordered = (realtype *)calloc(l_needed_len, sizeof(realtype));
+		if (cast_handle->r_samples_reordered == NULL)
+			return(NOT_OKAY);
+		cast_handle->l_samples_reordered_len = l_needed_len;
+	}
+
+	if ((i_buffer_flags & DFXP_SAMPLE_BUFFER_DRY) && (l_needed_len > cast_handle->l_samples_dry_len))
+	{
+		if (cast_handle->r_samples_dry != NULL)
+			free(cast_handle->r_samples_dry);
+		cast_handle->l_samples_dry_len = 0;
+
+		cast_handle->r_samples_dry = (realtype *)calloc(l_needed_len, sizeof(realtype));
+		if (cast_handle->r_samples_dry == NULL)
+			return(NOT_OKAY);
+		cast_handle->l_samples_dry_len = l_needed_len;
+	}
+
+	if ((i_buffer_flags & DFXP_SAMPLE_BUFFER_DELAY) && (l_needed_len > cast_handle->l_samples_delay_len))
+	{
+		if (cast_handle->r_samples_delay != NULL)
+			free(cast_handle->r_samples_delay);
+		cast_handle->l_samples_delay_len = 0;
+
+		cast_handle->r_samples_delay = (realtype *)calloc(l_needed_len, sizeof(realtype));
+		if (cast_handle->r_samples_delay == NULL)
+			return(NOT_OKAY);
+		cast_handle->l_samples_delay_len = l_needed_len;
+	}
+
+	return(OKAY);
+}
+
+/*
+ * FUNCTION: dfxp_SampleBuffersFit() 
+ * DESCRIPTION:
+ *   Returns IS_TRUE if the internal sample buffers selected by i_buffer_flags hold i_num_sample_sets
+ *   sample sets of the current output channel count. Never allocates, safe on the audio thread.
+ */
+int dfxp_SampleBuffersFit(PT_HANDLE *hp_dfxp, int i_num_sample_sets, int i_buffer_flags)
+{
+	struct dfxpHdlType *cast_handle;
+	long l_needed_len;
+
+	cast_handle = (struct dfxpHdlType *)(hp_dfxp);
+
+	if (cast_handle == NULL)
+		return(IS_FALSE);
+
+	l_needed_len = (long)cast_handle->num_channels_out * (long)i_num_sample_sets;
+
+	if ((i_buffer_flags & DFXP_SAMPLE_BUFFER_CONVERT) && (l_needed_len > cast_handle->l_samples_len))
+		return(IS_FALSE);
+	if ((i_buffer_flags & DFXP_SAMPLE_BUFFER_REORDER) && (l_needed_len > cast_handle->l_samples_reordered_len))
+		return(IS_FALSE);
+	if ((i_buffer_flags & DFXP_SAMPLE_BUFFER_DRY) && (l_needed_len > cast_handle->l_samples_dry_len))
+		return(IS_FALSE);
+	if ((i_buffer_flags & DFXP_SAMPLE_BUFFER_DELAY) && (l_needed_len > cast_handle->l_samples_delay_len))
+		return(IS_FALSE);
+
+	return(IS_TRUE);
+}
+
+/*
+ * FUNCTION: dfxp_FreeSampleBuffers() 
+ * DESCRIPTION:
+ *   Frees the internal sample buffers allocated by dfxp_SizeSampleBuffers().
+ */
+int dfxp_FreeSampleBuffers(PT_HANDLE *hp_dfxp)
+{
+	struct dfxpHdlType *cast_handle;
+
+	cast_handle = (struct dfxpHdlType *)(hp_dfxp);
+
+	if (cast_handle == NULL)
+		return(OKAY);
+
+	if (cast_handle->r_samples != NULL)
+	{
+		free(cast_handle->r_samples);
+		cast_handle->r_samples = NULL;
+	}
+	cast_handle->l_samples_len = 0;
+
+	if (cast_handle->r_samples_reordered != NULL)
+	{
+		free(cast_handle->r_samples_reordered);
+		cast_handle->r_samples_reordered = NULL;
+	}
+	cast_handle->l_samples_reordered_len = 0;
+
+	if (cast_handle->r_samples_dry != NULL)
+	{
+		free(cast_handle->r_samples_dry);
+		cast_handle->r_samples_dry = NULL;
+	}
+	cast_handle->l_samples_dry_len = 0;
+
+	if (cast_handle->r_samples_delay != NULL)
+	{
+		free(cast_handle->r_samples_delay);
+		cast_handle->r_samples_delay = NULL;
+	}
+	cast_handle->l_samples_delay_len = 0;
+
+	return(OKAY);
+}
+
 /*
  * FUNCTION: dfxp_UpdateBufferLengthInfo() 
  * DESCRIPTION:
@@ -202,7 +388,7 @@ int dfxp_UpdateBufferLengthInfo(PT_HANDLE *hp_dfxp, int i_num_sample_sets, int *
 	*ip_current_buffer_msecs = (int)((i_num_sample_sets * cast_handle->sampling_period) * (realtype)1000.0);
 
 	/* Get the length of longest buffer in msecs so far */
-	if (dfxp_SessionReadIntegerValue(hp_dfxp, DFXP_REGISTRY_LONGEST_BUFFER_MSECS_WIDE, 0, 
+	if (dfxp_SessionReadIntegerValue(hp_dfxp, DFXP_SESSION_KEY_LONGEST_BUFFER_MSECS, 0, 
 												&i_longest_buffer_msecs) != OKAY)
 		return(NOT_OKAY);
 
@@ -237,7 +423,7 @@ int dfxp_StoreLongestBufferSize(PT_HANDLE *hp_dfxp, int i_longest_buffer_msecs)
 	 * NOTE: THIS SHOULD BE MOVED TO SHARED MEMORY.  RIGHT NOW IT MAY FAIL IF RUNNING IN EXE LIKE
 	 *		   INTERNET EXPLORER WHICH DOES NOT ALLOW REGISTRY WRITES.
 	 */
-	if (dfxp_SessionWriteIntegerValue(hp_dfxp, DFXP_REGISTRY_LONGEST_BUFFER_MSECS_WIDE, i_longest_buffer_msecs) != OKAY)
+	if (dfxp_SessionWriteIntegerValue(hp_dfxp, DFXP_SESSION_KEY_LONGEST_BUFFER_MSECS, i_longest_buffer_msecs) != OKAY)
 		return(OKAY);
 
 	return(OKAY);
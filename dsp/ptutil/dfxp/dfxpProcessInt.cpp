@@ -50,6 +50,7 @@ int dfxpModifyShortIntSamples(PT_HANDLE *hp_dfxp, short int *sip_input_samples,
 	struct dfxpHdlType *cast_handle;
 	int total_num_samples;
 	int i_reorder;
+	struct dfxp_surround_int_io_type int_io;
 	int i;
 
 	cast_handle = (struct dfxpHdlType *)(hp_dfxp);
@@ -79,53 +80,71 @@ int dfxpModifyShortIntSamples(PT_HANDLE *hp_dfxp, short int *sip_input_samples,
 
 	//If buffer is bigger than max size or format is unsupported, just copy input to output
 	//Note buffer is sized to account for multiple channels, so test below is correct
-	if( (i_num_sample_sets > DAW_MAX_BUFFER_SIZE) || (cast_handle->unsupported_format_flag == IS_TRUE) )
+	if( (i_num_sample_sets > DAW_MAX_BUFFER_SIZE) || (cast_handle->unsupported_format_flag == IS_TRUE) ||
+		 (!dfxp_SampleBuffersFit(hp_dfxp, i_num_sample_sets, DFXP_SAMPLE_BUFFER_CONVERT)) )
 	{
 		for(i=0;i<total_num_samples;i++)
 			sip_output_samples[i] = sip_input_samples[i];
 		return(OKAY);
 	}
 
-	if ((cast_handle->trace.mode) && (!cast_handle->trace.i_process_int_samples_done))
-		(cast_handle->slout1)->Message_Wide(FIRST_LINE, L"dfxpModifyShortIntSamples(): Calling mthConvertIntBufToRealtype()");
-
-	/* Convert incoming 8 bit, 16 bit, 20 bit, 24 bit or 32 bit int buffer to 32 bit floats */
-	if (mthConvertIntBufToRealtype(total_num_samples, cast_handle->bits_per_sample, 
-		                            cast_handle->valid_bits, sip_input_samples, 
-											 cast_handle->r_samples) != OKAY)
-	   return(NOT_OKAY);
-
 	// If surround sound, set sample reorder flag
 	if ( (cast_handle->num_channels_out == 6) || (cast_handle->num_channels_out == 8) )
 		i_reorder = IS_TRUE;
 	else
 		i_reorder = IS_FALSE;
 
-	if ((cast_handle->trace.mode) && (!cast_handle->trace.i_process_int_samples_done))
+	/* Surround is converted straight into and out of the channel groups, see dfxpSurround.cpp */
+	if (i_reorder)
 	{
-		swprintf(cast_handle->wcp_msg1, L"dfxpModifyShortIntSamples(): Calling dfxpModifyRealtypeSamples(), i_reorder = %d", i_reorder);
-		(cast_handle->slout1)->Message_Wide(FIRST_LINE, cast_handle->wcp_msg1);
-	}
+		int_io.sip_in = sip_input_samples;
+		int_io.sip_out = sip_output_samples;
+		int_io.bit_width = cast_handle->bits_per_sample;
+		int_io.bits_valid = cast_handle->valid_bits;
 
-	if (dfxpModifyRealtypeSamples(hp_dfxp, cast_handle->r_samples, i_num_sample_sets, i_reorder) != OKAY)
-		return(NOT_OKAY);
+		if ((cast_handle->trace.mode) && (!cast_handle->trace.i_process_int_samples_done))
+			(cast_handle->slout1)->Message_Wide(FIRST_LINE, L"dfxpModifyShortIntSamples(): Calling dfxp_ModifySamples()");
 
-	/* Convert processed buffer back to int buffer format. Note that this
-	 * version of the function doesn't clip the real data and thus assumes that
-	 * the realtype buffer is +/- 1.0
-	 */
-	if ((cast_handle->trace.mode) && (!cast_handle->trace.i_process_int_samples_done))
+		if (dfxp_ModifySamples(hp_dfxp, cast_handle->r_samples, i_num_sample_sets, i_reorder, &int_io) != OKAY)
+			return(NOT_OKAY);
+	}
+	else
 	{
-		(cast_handle->slout1)->Message_Wide(FIRST_LINE, L"dfxpModifyShortIntSamples(): Calling mthConvertRealtypeBufToIntBuf()");
-		swprintf(cast_handle->wcp_msg1, L"   bps = %d, valid_bits = %d", cast_handle->bits_per_sample, cast_handle->valid_bits);
-		(cast_handle->slout1)->Message_Wide(FIRST_LINE, cast_handle->wcp_msg1);
+		if ((cast_handle->trace.mode) && (!cast_handle->trace.i_process_int_samples_done))
+			(cast_handle->slout1)->Message_Wide(FIRST_LINE, L"dfxpModifyShortIntSamples(): Calling mthConvertIntBufToRealtype()");
+
+		/* Convert incoming 8 bit, 16 bit, 20 bit, 24 bit or 32 bit int buffer to 32 bit floats */
+		if (mthConvertIntBufToRealtype(total_num_samples, cast_handle->bits_per_sample, 
+											    cast_handle->valid_bits, sip_input_samples, 
+												 cast_handle->r_samples) != OKAY)
+		   return(NOT_OKAY);
+
+		if ((cast_handle->trace.mode) && (!cast_handle->trace.i_process_int_samples_done))
+		{
+			swprintf(cast_handle->wcp_msg1, L"dfxpModifyShortIntSamples(): Calling dfxpModifyRealtypeSamples(), i_reorder = %d", i_reorder);
+			(cast_handle->slout1)->Message_Wide(FIRST_LINE, cast_handle->wcp_msg1);
+		}
+
+		if (dfxpModifyRealtypeSamples(hp_dfxp, cast_handle->r_samples, i_num_sample_sets, i_reorder) != OKAY)
+			return(NOT_OKAY);
+
+		/* Convert processed buffer back to int buffer format. Note that this
+		 * version of the function doesn't clip the real data and thus assumes that
+		 * the realtype buffer is +/- 1.0
+		 */
+		if ((cast_handle->trace.mode) && (!cast_handle->trace.i_process_int_samples_done))
+		{
+			(cast_handle->slout1)->Message_Wide(FIRST_LINE, L"dfxpModifyShortIntSamples(): Calling mthConvertRealtypeBufToIntBuf()");
+			swprintf(cast_handle->wcp_msg1, L"   bps = %d, valid_bits = %d", cast_handle->bits_per_sample, cast_handle->valid_bits);
+			(cast_handle->slout1)->Message_Wide(FIRST_LINE, cast_handle->wcp_msg1);
+		}
+
+		if (mthConvertRealtypeBufToIntBuf(total_num_samples, cast_handle->bits_per_sample, 
+											       cast_handle->valid_bits, cast_handle->r_samples, 
+													 sip_output_samples) != OKAY)
+			return(NOT_OKAY);
 	}
 
-	if (mthConvertRealtypeBufToIntBuf(total_num_samples, cast_handle->bits_per_sample, 
-		                               cast_handle->valid_bits, cast_handle->r_samples, 
-												 sip_output_samples) != OKAY)
-		return(NOT_OKAY);
-
 	if ((cast_handle->trace.mode) && (!cast_handle->trace.i_process_int_samples_done))
 		(cast_handle->slout1)->Message_Wide(FIRST_LINE, L"dfxpModifyShortIntSamples(): Success");
 
@@ -20,6 +20,8 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <windows.h>
 #include <stdio.h>
+#include <string.h>
+#include <math.h>
 #include <time.h>
 
 #include "u_dfxp.h" /* Must go before codedefs.h due to mmgr */
@@ -34,6 +36,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "DfxSdk.h"
 #include "BinauralSyn.h"
 #include "GraphicEq.h"
+#include "c_max.h"
 
 extern "C" {
 #include "comSftwr.h"
@@ -47,30 +50,47 @@ extern "C" {
  *   NOTE: This processing is always done in-place.
  */
 int dfxpModifyRealtypeSamples(PT_HANDLE *hp_dfxp, realtype *rp_samples, int i_num_sample_sets, int i_reorder)
+{
+	return( dfxp_ModifySamples(hp_dfxp, rp_samples, i_num_sample_sets, i_reorder, NULL) );
+}
+
+/*
+ * FUNCTION: dfxp_ModifySamples() 
+ * DESCRIPTION:
+ *   Does the work of dfxpModifyRealtypeSamples(). For a 4, 6 or 8 channel buffer with i_reorder set,
+ *   sp_int_io can pass the host's integer buffers instead. rp_samples is then only used if a stage
+ *   needs the signal interleaved, otherwise the input is converted straight into the channel groups
+ *   and the output straight out of them (see dfxpSurround.cpp).
+ */
+int dfxp_ModifySamples(PT_HANDLE *hp_dfxp, realtype *rp_samples, int i_num_sample_sets, int i_reorder,
+							  struct dfxp_surround_int_io_type *sp_int_io)
 {
 	struct dfxpHdlType *cast_handle;
    int stereo_in_mode;
 	int stereo_out_mode;
 	int total_buffer_length;
 	realtype tmp_float;
-	realtype *rp_channels;
    int bypass_all;
 	int input_slipped;
 	realtype *rp_buf;
-	int i,j,k;
 	int spectrum_process_num_channels;
 	int i_current_buffer_msecs;
 	int i_dfx_tuned_track_playing;
-	int center_nonzero, sub_nonzero, side_nonzero, rear_nonzero;
-	realtype ftmp;
+	int i_surround_reorder;
+	int i_int_input_pending;
+	int surround_nonzero;
 	BOOL b_lean_and_mean;
 	int i_eq_on;
+	int i_bypass_fading;
 
 	cast_handle = (struct dfxpHdlType *)(hp_dfxp);
 
 	if (cast_handle == NULL)
 		return(OKAY);
 
+	/* Denormals are flushed while processing, the caller's mode is restored on every return */
+	CRealSampleFlushDenormals flush_denormals;
+
 	/* 
 	 * Set whether we are going to do lean and mean processing which is necessary for the new
 	 * DFX 11 style which uses the virtual soundcard.
@@ -107,6 +127,14 @@ int dfxpModifyRealtypeSamples(PT_HANDLE *hp_dfxp, realtype *rp_samples, int i_nu
 	if( (i_num_sample_sets > DAW_MAX_BUFFER_SIZE ) || (cast_handle->unsupported_format_flag == IS_TRUE) )
 		return(OKAY);
 
+	i_surround_reorder = (i_reorder) &&
+		((cast_handle->num_channels_out == 4) || (cast_handle->num_channels_out == 6) || (cast_handle->num_channels_out == 8));
+	surround_nonzero = 0;
+
+	/* The reorder buffer is sized in dfxpBeginProcess(), pass the buffer through if it could not be allocated */
+	if ((i_surround_reorder) && (!dfxp_SampleBuffersFit(hp_dfxp, i_num_sample_sets, DFXP_SAMPLE_BUFFER_REORDER)))
+		return(OKAY);
+
 	if ((cast_handle->trace.mode) && (!cast_handle->trace.i_process_real_samples_done))
 		(cast_handle->slout1)->Message_Wide(FIRST_LINE, L"dfxpModifyRealtypeSamples(): Calling dfxp_ClearBuffersIfSongStart()");
 
@@ -120,9 +148,8 @@ int dfxpModifyRealtypeSamples(PT_HANDLE *hp_dfxp, realtype *rp_samples, int i_nu
 	if ((cast_handle->trace.mode) && (!cast_handle->trace.i_process_real_samples_done))
 		(cast_handle->slout1)->Message_Wide(FIRST_LINE, L"dfxpModifyRealtypeSamples(): Calling dfxpGetButtonValue()");
 
-	/* Get the bypass all setting */;
-	if (dfxpGetButtonValue(hp_dfxp, DFX_UI_BUTTON_BYPASS, &bypass_all) != OKAY)
-		return(NOT_OKAY);
+	/* Get the bypass all setting, as last communicated by dfxp_CommunicateBypassSettings() */;
+	bypass_all = cast_handle->bypass_fade.bypass_all;
 
 	/* 
 	 * Check if a DFX printed track (iDFX) is playing.  
@@ -136,14 +163,52 @@ int dfxpModifyRealtypeSamples(PT_HANDLE *hp_dfxp, realtype *rp_samples, int i_nu
 	if (i_dfx_tuned_track_playing)
 		bypass_all = IS_TRUE;
 
-	// Do EQ processing
+	/* While crossfading to or from bypass the chain keeps running, the unprocessed input is kept for the fade */
+	if (dfxp_BypassFadeUpdate(hp_dfxp, bypass_all, &i_bypass_fading) != OKAY)
+		return(NOT_OKAY);
+	if ((i_bypass_fading) && (!dfxp_SampleBuffersFit(hp_dfxp, i_num_sample_sets, DFXP_SAMPLE_BUFFER_DRY)))
+		i_bypass_fading = IS_FALSE; /* No dry buffer to fade with, switch without the fade */
+	if (i_bypass_fading)
+		bypass_all = IS_FALSE;
+
+	i_eq_on = IS_FALSE;
 	if (!bypass_all)
 	{
 		if (dfxpEqGetProcessingOn(hp_dfxp, DFXP_STORAGE_TYPE_MEMORY, &i_eq_on) != OKAY)
 			return(NOT_OKAY);
+	}
+
+	// Integer input only skips the interleaved buffer if nothing below works on it before the reorder
+	i_int_input_pending = (sp_int_io != NULL);
+	if ( (i_int_input_pending) && (!bypass_all) && (i_eq_on || cast_handle->binaural_headphone_on_flag || i_bypass_fading) )
+	{
+		if (mthConvertIntBufToRealtype(total_buffer_length, sp_int_io->bit_width, sp_int_io->bits_valid,
+												 sp_int_io->sip_in, rp_samples) != OKAY)
+			return(NOT_OKAY);
+
+		i_int_input_pending = IS_FALSE;
+	}
+
+	if (i_bypass_fading)
+	{
+		memcpy(cast_handle->r_samples_dry, rp_samples, total_buffer_length * sizeof(realtype));
 
-		if ((i_eq_on) &&
-			(cast_handle->num_channels_out <= 2) || (cast_handle->num_channels_out == 6) || (cast_handle->num_channels_out == 8) )
+		/* Line the unprocessed input up with the chain's output so the crossfade doesn't comb filter */
+		if (dfxp_BypassDelayDry(hp_dfxp, cast_handle->r_samples_dry, i_num_sample_sets) != OKAY)
+			return(NOT_OKAY);
+	}
+	else
+	{
+		/* Keep the last chain latency of input for the next crossfade */
+		if (dfxp_BypassDelayFeed(hp_dfxp, rp_samples, i_int_input_pending ? sp_int_io : NULL, i_num_sample_sets) != OKAY)
+			return(NOT_OKAY);
+	}
+
+	// Do EQ processing
+	if (!bypass_all)
+	{
+		if ( (i_eq_on) &&
+			((cast_handle->num_channels_out <= 2) || (cast_handle->num_channels_out == 6) || (cast_handle->num_channels_out == 8)) )
 		{
 			if (GraphicEqProcess(cast_handle->eq.graphicEq_hdl, 
 										 rp_samples, rp_samples, i_num_sample_sets, cast_handle->num_channels_out,
@@ -154,9 +219,8 @@ int dfxpModifyRealtypeSamples(PT_HANDLE *hp_dfxp, realtype *rp_samples, int i_nu
 
 	// Binaural processing to map 6/8 channel signal to stereo for headphone usage.
 	// For stereo input, adds depth to stereo output.
-	//
-	// PTNOTE - currently binaural headphone processing is only implemented for 48k and lower sampling rates
-	if( cast_handle->binaural_headphone_on_flag && (!bypass_all) && (cast_handle->sampling_freq <= (realtype)48000.0) )
+	// Runs at the device rate, the coeffs are resampled to it by BinauralSyn.
+	if( cast_handle->binaural_headphone_on_flag && (!bypass_all) )
 	{
 		if ( cast_handle->num_channels_out == 2 )
 		{
@@ -203,121 +267,20 @@ int dfxpModifyRealtypeSamples(PT_HANDLE *hp_dfxp, realtype *rp_samples, int i_nu
 	//Ordering for 5.1 is: Front Left, Front Right, Front Center, Low Frequency, Back Left, Back Right
 	//Ordering for 7.1 is: Front Left, Front Right, Front Center, Low Frequency, Back Left, Back Right, Side Left, Side Right
  
-	// Zero "zero check" flags
-	center_nonzero = 0;
-	sub_nonzero = 0;
-	side_nonzero = 0;
-	rear_nonzero = 0;
-
-	// Handle quad case
-	if ( (cast_handle->num_channels_out == 4) && (i_reorder) )
+	// Reorder into the planar channel groups, noting which groups have any signal
+	if (i_surround_reorder)
 	{
 		rp_buf = cast_handle->r_samples_reordered;
 
-		for(i=0; i<i_num_sample_sets; i++)
+		if (i_int_input_pending)
 		{
-			j = i * 2;
-			k = i * 4;
-
-			// Front channels
-		   rp_buf[j] = rp_samples[k];
-		   rp_buf[j + 1] = rp_samples[k+1];
-
-			// Rear channels
-		   ftmp = rp_samples[k+2];
-			if( ftmp != (realtype)0.0 )
-				rear_nonzero = 1;
-		   rp_buf[i_num_sample_sets * 2 + j] = ftmp;
-
-		   ftmp = rp_samples[k+3];
-			if( ftmp != (realtype)0.0 )
-				rear_nonzero = 1;
-		   rp_buf[i_num_sample_sets * 2 + j + 1] = ftmp;
-		}
-	}
-	else if ( (cast_handle->num_channels_out == 6) && (i_reorder) )
-	{
-		rp_buf = cast_handle->r_samples_reordered;
-
-		for(i=0; i<i_num_sample_sets; i++)
-		{
-			j = i * 2;
-			k = i * 6;
-
-			// Front channels
-		   rp_buf[j] = rp_samples[k];
-		   rp_buf[j + 1] = rp_samples[k+1];
-
-			// Center channel
-		   ftmp = rp_samples[k+2];
-			if( ftmp != (realtype)0.0 )
-				center_nonzero = 1;
-		   rp_buf[i_num_sample_sets * 2 + i] = ftmp;
-
-			// Subwoofer channel
-		   ftmp = rp_samples[k+3];
-			if( ftmp != (realtype)0.0 )
-				sub_nonzero = 1;
-		   rp_buf[i_num_sample_sets * 3 + i] = ftmp;
-
-			// Rear channels
-		   ftmp = rp_samples[k+4];
-			if( ftmp != (realtype)0.0 )
-				rear_nonzero = 1;
-		   rp_buf[i_num_sample_sets * 4 + j] = ftmp;
-
-		   ftmp = rp_samples[k+5];
-			if( ftmp != (realtype)0.0 )
-				rear_nonzero = 1;
-		   rp_buf[i_num_sample_sets * 4 + j + 1] = ftmp;
+			if (dfxp_SurroundScatterInt(hp_dfxp, sp_int_io, i_num_sample_sets, rp_buf, &surround_nonzero) != OKAY)
+				return(NOT_OKAY);
 		}
-	}
-	else if ( (cast_handle->num_channels_out == 8) && (i_reorder) )
-	{
-		rp_buf = cast_handle->r_samples_reordered;
-
-		for(i=0; i<i_num_sample_sets; i++)
+		else
 		{
-			j = i * 2;
-			k = i * 8;
-
-			// Front channels
-		   rp_buf[j] = rp_samples[k];
-		   rp_buf[j + 1] = rp_samples[k+1];
-
-			// Center channel
-		   ftmp = rp_samples[k+2];
-			if( ftmp != (realtype)0.0 )
-				center_nonzero = 1;
-		   rp_buf[i_num_sample_sets * 2 + i] = ftmp;
-
-			// Subwoofer channel
-		   ftmp = rp_samples[k+3];
-			if( ftmp != (realtype)0.0 )
-				sub_nonzero = 1;
-		   rp_buf[i_num_sample_sets * 3 + i] = ftmp;
-
-			// Rear channels
-		   ftmp = rp_samples[k+4];
-			if( ftmp != (realtype)0.0 )
-				rear_nonzero = 1;
-		   rp_buf[i_num_sample_sets * 4 + j] = ftmp;
-
-		   ftmp = rp_samples[k+5];
-			if( ftmp != (realtype)0.0 )
-				rear_nonzero = 1;
-		   rp_buf[i_num_sample_sets * 4 + j + 1] = ftmp;
-
-			// Side channels
-		   ftmp = rp_samples[k+6];
-			if( ftmp != (realtype)0.0 )
-				side_nonzero = 1;
-		   rp_buf[i_num_sample_sets * 6 + j] = ftmp;
-
-		   ftmp = rp_samples[k+7];
-			if( ftmp != (realtype)0.0 )
-				side_nonzero = 1;
-		   rp_buf[i_num_sample_sets * 6 + j + 1] = ftmp;
+			if (dfxp_SurroundScatter(hp_dfxp, rp_samples, i_num_sample_sets, rp_buf, &surround_nonzero) != OKAY)
+				return(NOT_OKAY);
 		}
 	}
 	else
@@ -352,103 +315,14 @@ int dfxpModifyRealtypeSamples(PT_HANDLE *hp_dfxp, realtype *rp_samples, int i_nu
 			
 			break;
 
-		case 4:
-			rp_channels = rp_buf;
-
+		case 4: case 6: case 8:
 			if ((cast_handle->trace.mode) && (!cast_handle->trace.i_process_real_samples_done))
-				(cast_handle->slout1)->Message_Wide(FIRST_LINE, L"dfxpModifyRealtypeSamples(): Calling comProcessWaveBuffer() : Case 4");
+				(cast_handle->slout1)->Message_Wide(FIRST_LINE, L"dfxpModifyRealtypeSamples(): Calling dfxp_SurroundProcessGroups()");
 
-			if (comProcessWaveBuffer(cast_handle->com_hdl_front, (long *)rp_channels, &tmp_float, (long)i_num_sample_sets, 
-                               IS_TRUE, IS_TRUE, cast_handle->internal_rate_ratio, (int)COM_32_BIT_FLOAT_SAMPLES) != OKAY)
+			/* One com handle per channel group, run on the surround workers when parallel surround is on */
+			if (dfxp_SurroundProcessGroups(hp_dfxp, rp_buf, i_num_sample_sets, surround_nonzero) != OKAY)
 				return(NOT_OKAY);
 
-			rp_channels += 2 * i_num_sample_sets;
-			if( rear_nonzero )
-			{
-				if (comProcessWaveBuffer(cast_handle->com_hdl_rear, (long *)rp_channels, &tmp_float, (long)i_num_sample_sets, 
-											 IS_TRUE, IS_TRUE, cast_handle->internal_rate_ratio, (int)COM_32_BIT_FLOAT_SAMPLES) != OKAY)
-					return(NOT_OKAY);
-			}
-			break;
-
-		case 6:
-			rp_channels = rp_buf;
-
-			if ((cast_handle->trace.mode) && (!cast_handle->trace.i_process_real_samples_done))
-				(cast_handle->slout1)->Message_Wide(FIRST_LINE, L"dfxpModifyRealtypeSamples(): Calling comProcessWaveBuffer() : Case 6");
-
-			if (comProcessWaveBuffer(cast_handle->com_hdl_front, (long *)rp_channels, &tmp_float, (long)i_num_sample_sets, 
-                               IS_TRUE, IS_TRUE, cast_handle->internal_rate_ratio, (int)COM_32_BIT_FLOAT_SAMPLES) != OKAY)
-				return(NOT_OKAY);
-
-			rp_channels += 2 * i_num_sample_sets;
-			if( center_nonzero )
-			{
-				if (comProcessWaveBuffer(cast_handle->com_hdl_center, (long *)rp_channels, &tmp_float, (long)i_num_sample_sets, 
-											 IS_FALSE, IS_FALSE, cast_handle->internal_rate_ratio, (int)COM_32_BIT_FLOAT_SAMPLES) != OKAY)
-					return(NOT_OKAY);
-			}
-
-			rp_channels += i_num_sample_sets;
-			if( sub_nonzero )
-			{
-				if (comProcessWaveBuffer(cast_handle->com_hdl_subwoofer, (long *)rp_channels, &tmp_float, (long)i_num_sample_sets, 
-											 IS_FALSE, IS_FALSE, cast_handle->internal_rate_ratio, (int)COM_32_BIT_FLOAT_SAMPLES) != OKAY)
-					return(NOT_OKAY);
-			}
-
-			rp_channels += i_num_sample_sets;
-			if( rear_nonzero )
-			{
-				if (comProcessWaveBuffer(cast_handle->com_hdl_rear, (long *)rp_channels, &tmp_float, (long)i_num_sample_sets, 
-											 IS_TRUE, IS_TRUE, cast_handle->internal_rate_ratio, (int)COM_32_BIT_FLOAT_SAMPLES) != OKAY)
-					return(NOT_OKAY);
-			}
-
-			break;
-
-		case 8:
-			rp_channels = rp_buf;
-
-			if ((cast_handle->trace.mode) && (!cast_handle->trace.i_process_real_samples_done))
-				(cast_handle->slout1)->Message_Wide(FIRST_LINE, L"dfxpModifyRealtypeSamples(): Calling comProcessWaveBuffer() : Case 8");
-
-			if (comProcessWaveBuffer(cast_handle->com_hdl_front, (long *)rp_channels, &tmp_float, (long)i_num_sample_sets, 
-                               IS_TRUE, IS_TRUE, cast_handle->internal_rate_ratio, (int)COM_32_BIT_FLOAT_SAMPLES) != OKAY)
-				return(NOT_OKAY);
-
-			rp_channels += 2 * i_num_sample_sets;
-			if( center_nonzero )
-			{
-				if (comProcessWaveBuffer(cast_handle->com_hdl_center, (long *)rp_channels, &tmp_float, (long)i_num_sample_sets, 
-											 IS_FALSE, IS_FALSE, cast_handle->internal_rate_ratio, (int)COM_32_BIT_FLOAT_SAMPLES) != OKAY)
-					return(NOT_OKAY);
-			}
-
-			rp_channels += i_num_sample_sets;
-			if( sub_nonzero )
-			{
-				if (comProcessWaveBuffer(cast_handle->com_hdl_subwoofer, (long *)rp_channels, &tmp_float, (long)i_num_sample_sets, 
-											 IS_FALSE, IS_FALSE, cast_handle->internal_rate_ratio, (int)COM_32_BIT_FLOAT_SAMPLES) != OKAY)
-					return(NOT_OKAY);
-			}
-
-			rp_channels += i_num_sample_sets;
-			if( rear_nonzero )
-			{
-				if (comProcessWaveBuffer(cast_handle->com_hdl_rear, (long *)rp_channels, &tmp_float, (long)i_num_sample_sets, 
-											 IS_TRUE, IS_TRUE, cast_handle->internal_rate_ratio, (int)COM_32_BIT_FLOAT_SAMPLES) != OKAY)
-					return(NOT_OKAY);
-			}
-
-			rp_channels += 2 * i_num_sample_sets;
-			if( side_nonzero )
-			{
-				if (comProcessWaveBuffer(cast_handle->com_hdl_side, (long *)rp_channels, &tmp_float, (long)i_num_sample_sets, 
-											 IS_TRUE, IS_TRUE, cast_handle->internal_rate_ratio, (int)COM_32_BIT_FLOAT_SAMPLES) != OKAY)
-					return(NOT_OKAY);
-			}
-
 			break;
 		}
    }
@@ -468,100 +342,451 @@ int dfxpModifyRealtypeSamples(PT_HANDLE *hp_dfxp, realtype *rp_samples, int i_nu
 		if ((cast_handle->trace.mode) && (!cast_handle->trace.i_process_real_samples_done))
 			(cast_handle->slout1)->Message_Wide(FIRST_LINE, L"dfxpModifyRealtypeSamples(): Calling spectrumProcess()");
 
+		/*
+		 * The spectrum module hands complete sets of band values to the GUI through its own
+		 * triple buffer, read by dfxpSpectrumGetBandValues(), so nothing else is sent from here.
+		 */
 		if (spectrumProcess(cast_handle->spectrum.spectrum_hdl, rp_buf, i_num_sample_sets, 
 								  spectrum_process_num_channels, cast_handle->sampling_freq,
 								  (!bypass_all)) != OKAY)
 			return(NOT_OKAY);
+	}
 
-		/*
-		 * Send the spectrum to the GUI.
-		 * Note: In case of small buffers, it only write once every time a specified number
-		 *       of samples sets have been processed.
-		 */
-		cast_handle->spectrum.sample_sets_since_last_spectrum_save = 
-			cast_handle->spectrum.sample_sets_since_last_spectrum_save + i_num_sample_sets;
-
-		if (cast_handle->spectrum.sample_sets_since_last_spectrum_save > DFXP_SAMPLE_SETS_PER_SAVE_SPECTRUM)
+	// Put the output back in the interleaved order, converting to the host's integer format if that is what it passed
+	if (i_surround_reorder)
+	{
+		if ( (sp_int_io != NULL) && (!i_bypass_fading) )
 		{
-			if ((cast_handle->trace.mode) && (!cast_handle->trace.i_process_real_samples_done))
-				(cast_handle->slout1)->Message_Wide(FIRST_LINE, L"dfxpModifyRealtypeSamples(): Calling dfxp_SpectrumSaveToFile()");
-
-			if (dfxp_SpectrumStoreCurrentValuesInSharedMemory(hp_dfxp, IS_FALSE) != OKAY)
+			if (dfxp_SurroundGatherInt(hp_dfxp, rp_buf, i_num_sample_sets, sp_int_io) != OKAY)
+				return(NOT_OKAY);
+		}
+		else
+		{
+			if (dfxp_SurroundGather(hp_dfxp, rp_buf, i_num_sample_sets, rp_samples) != OKAY)
 				return(NOT_OKAY);
-
-			cast_handle->spectrum.sample_sets_since_last_spectrum_save = 0;
 		}
 	}
 
-	// If input is Quad
-	if ( (cast_handle->num_channels_out == 4) && (i_reorder) )
-		for(i=0; i<i_num_sample_sets; i++)
+	/* Crossfade with the unprocessed input, then convert if the host's integer output was not written above */
+	if (i_bypass_fading)
+	{
+		if (dfxp_BypassCrossfade(hp_dfxp, rp_samples, cast_handle->r_samples_dry, i_num_sample_sets, 
+										 cast_handle->bypass_fade.bypass_all || i_dfx_tuned_track_playing) != OKAY)
+			return(NOT_OKAY);
+
+		if ( (i_surround_reorder) && (sp_int_io != NULL) )
 		{
-			j = i * 2;
-			k = i * 4;
+			if (mthConvertRealtypeBufToIntBuf(total_buffer_length, sp_int_io->bit_width, sp_int_io->bits_valid,
+														 rp_samples, sp_int_io->sip_out) != OKAY)
+				return(NOT_OKAY);
+		}
+	}
+
+	/* Take care of recording */
+	if ((cast_handle->trace.mode) && (!cast_handle->trace.i_process_real_samples_done))
+		(cast_handle->slout1)->Message_Wide(FIRST_LINE, L"dfxpModifyShortIntSamples(): Calling dfxp_RecordBufferProcessed()");
 
-			// Front channels
-			rp_samples[k]   = rp_buf[j];
-			rp_samples[k+1] = rp_buf[j+1];
+	if ((cast_handle->trace.mode) && (!cast_handle->trace.i_process_real_samples_done))
+		(cast_handle->slout1)->Message_Wide(FIRST_LINE, L"dfxpModifyRealtypeSamples(): Success");
 
-			// Rear channels
-			rp_samples[k+2] = rp_buf[i_num_sample_sets * 2 + j];
-			rp_samples[k+3] = rp_buf[i_num_sample_sets * 2 + j + 1];
+	cast_handle->trace.i_process_real_samples_done = IS_TRUE;
+
+	return(OKAY);
+}
+
+/*
+ * FUNCTION: dfxp_BypassFadeUpdate() 
+ * DESCRIPTION:
+ *   Sizes the bypass crossfade for the current sampling rate and passes back whether the output
+ *   still has to move towards the passed bypass all setting.
+ */
+int dfxp_BypassFadeUpdate(PT_HANDLE *hp_dfxp, int i_bypass_all, int *ip_fading)
+{
+	struct dfxpHdlType *cast_handle;
+	int i_fade_len;
+
+	cast_handle = (struct dfxpHdlType *)(hp_dfxp);
+
+	*ip_fading = IS_FALSE;
+
+	if (cast_handle == NULL)
+		return(OKAY);
+
+	i_fade_len = (int)(cast_handle->sampling_freq * (realtype)DFXP_BYPASS_FADE_MSECS * (realtype)0.001);
+	if (i_fade_len < 1)
+		i_fade_len = 1;
+
+	/* Keep the position of a fade in progress if the rate changes, the first buffer starts settled */
+	if (i_fade_len != cast_handle->bypass_fade.fade_len)
+	{
+		if (cast_handle->bypass_fade.fade_len > 0)
+			cast_handle->bypass_fade.wet_pos = (int)(((long)cast_handle->bypass_fade.wet_pos * (long)i_fade_len) / (long)cast_handle->bypass_fade.fade_len);
+		else if (i_bypass_all)
+			cast_handle->bypass_fade.wet_pos = 0;
+		else
+			cast_handle->bypass_fade.wet_pos = i_fade_len;
+
+		cast_handle->bypass_fade.fade_len = i_fade_len;
+		cast_handle->bypass_fade.step_cos = (realtype)cos(MTH_PI * 0.5 / (double)i_fade_len);
+		cast_handle->bypass_fade.step_sin = (realtype)sin(MTH_PI * 0.5 / (double)i_fade_len);
+	}
+
+	if (i_bypass_all)
+		*ip_fading = (cast_handle->bypass_fade.wet_pos != 0);
+	else
+		*ip_fading = (cast_handle->bypass_fade.wet_pos != cast_handle->bypass_fade.fade_len);
+
+	return(OKAY);
+}
+
+/*
+ * FUNCTION: dfxp_BypassCrossfade() 
+ * DESCRIPTION:
+ *   Equal power crossfade between the processed signal in rp_samples and the unprocessed input in rp_dry,
+ *   one step per sample set towards the passed bypass all setting. Toggling again part way through turns
+ *   the fade around from where it is. The result is left in rp_samples. rp_dry has been delayed by
+ *   the chain latency with dfxp_BypassDelayDry(). The gains are set from the position once per buffer
+ *   and rotated by a step of the fade angle per sample set after that.
+ */
+int dfxp_BypassCrossfade(PT_HANDLE *hp_dfxp, realtype *rp_samples, realtype *rp_dry, int i_num_sample_sets, int i_bypass_all)
+{
+	struct dfxpHdlType *cast_handle;
+	int i_target_pos;
+	int i_num_channels;
+	int i, j;
+	realtype r_angle;
+	realtype r_wet_gain;
+	realtype r_dry_gain;
+	realtype r_step_cos;
+	realtype r_step_sin;
+	realtype r_tmp;
+
+	cast_handle = (struct dfxpHdlType *)(hp_dfxp);
+
+	if (cast_handle == NULL)
+		return(OKAY);
+
+	if (cast_handle->bypass_fade.fade_len <= 0)
+		return(NOT_OKAY);
+
+	i_target_pos = i_bypass_all ? 0 : cast_handle->bypass_fade.fade_len;
+	i_num_channels = cast_handle->num_channels_out;
+	r_step_cos = cast_handle->bypass_fade.step_cos;
+	r_step_sin = cast_handle->bypass_fade.step_sin;
+
+	r_angle = (realtype)(MTH_PI * 0.5) * (realtype)cast_handle->bypass_fade.wet_pos / (realtype)cast_handle->bypass_fade.fade_len;
+	r_wet_gain = (realtype)sin(r_angle);
+	r_dry_gain = (realtype)cos(r_angle);
+
+	for (i = 0; i < i_num_sample_sets; i++)
+	{
+		if (cast_handle->bypass_fade.wet_pos < i_target_pos)
+		{
+			(cast_handle->bypass_fade.wet_pos)++;
+			r_tmp = r_wet_gain * r_step_cos + r_dry_gain * r_step_sin;
+			r_dry_gain = r_dry_gain * r_step_cos - r_wet_gain * r_step_sin;
+			r_wet_gain = r_tmp;
 		}
-	// If input is SurroundSound in standard Windows format, put output back in that order
-	else if ( (cast_handle->num_channels_out == 6) && (i_reorder) )
-		for(i=0; i<i_num_sample_sets; i++)
+		else if (cast_handle->bypass_fade.wet_pos > i_target_pos)
 		{
-			j = i * 2;
-			k = i * 6;
+			(cast_handle->bypass_fade.wet_pos)--;
+			r_tmp = r_wet_gain * r_step_cos - r_dry_gain * r_step_sin;
+			r_dry_gain = r_dry_gain * r_step_cos + r_wet_gain * r_step_sin;
+			r_wet_gain = r_tmp;
+		}
 
-			// Front channels
-			rp_samples[k]   = rp_buf[j];
-			rp_samples[k+1] = rp_buf[j+1];
+		/* Exact at the ends, so a finished fade leaves the signal untouched */
+		if (cast_handle->bypass_fade.wet_pos == 0)
+		{
+			r_wet_gain = (realtype)0.0;
+			r_dry_gain = (realtype)1.0;
+		}
+		else if (cast_handle->bypass_fade.wet_pos == cast_handle->bypass_fade.fade_len)
+		{
+			r_wet_gain = (realtype)1.0;
+			r_dry_gain = (realtype)0.0;
+		}
 
-			// Center channel
-			rp_samples[k+2] = rp_buf[i_num_sample_sets * 2 + i];
+		for (j = 0; j < i_num_channels; j++)
+			rp_samples[j] = r_wet_gain * rp_samples[j] + r_dry_gain * rp_dry[j];
 
-			// Subwoofer channel
-			rp_samples[k+3] = rp_buf[i_num_sample_sets * 3 + i];
+		rp_samples += i_num_channels;
+		rp_dry += i_num_channels;
+	}
 
-			// Rear channels
-			rp_samples[k+4] = rp_buf[i_num_sample_sets * 4 + j];
-			rp_samples[k+5] = rp_buf[i_num_sample_sets * 4 + j + 1];
-		}
-	else	if ( (cast_handle->num_channels_out == 8) && (i_reorder) )
-		for(i=0; i<i_num_sample_sets; i++)
+	return(OKAY);
+}
+
+/*
+ * FUNCTION: dfxp_BypassDelayLatency() 
+ * DESCRIPTION:
+ *   Passes back the delay the processing chain adds, in sample sets at the signal's sampling frequency.
+ *   This is the resampler round trip plus the optimizer look ahead, see dfxpGetOptimizerLatency().
+ *   With i_max set it is the latency in true peak mode whatever the current mode, for sizing the delay line.
+ */
+int dfxp_BypassDelayLatency(PT_HANDLE *hp_dfxp, int i_max, int *ip_latency_sets)
+{
+	struct dfxpHdlType *cast_handle;
+	int i_resample_sets;
+	int i_optimizer_sets;
+
+	cast_handle = (struct dfxpHdlType *)(hp_dfxp);
+
+	*ip_latency_sets = 0;
+
+	if (cast_handle == NULL)
+		return(OKAY);
+
+	if (comGetResampleLatency(cast_handle->internal_rate_ratio, &i_resample_sets) != OKAY)
+		return(NOT_OKAY);
+
+	if (dfxpGetOptimizerLatency(hp_dfxp, &i_optimizer_sets) != OKAY)
+		return(NOT_OKAY);
+
+	if ((i_max) && (!cast_handle->true_peak_on))
+		i_optimizer_sets += MAXI_TRUE_PEAK_LATENCY * cast_handle->internal_rate_ratio;
+
+	*ip_latency_sets = i_resample_sets + i_optimizer_sets;
+
+	return(OKAY);
+}
+
+/*
+ * FUNCTION: dfxp_BypassDelaySets() 
+ * DESCRIPTION:
+ *   Passes back the current chain latency, or 0 if r_samples_delay could not be sized for it,
+ *   in which case the dry signal is crossfaded without the delay.
+ */
+static int dfxp_BypassDelaySets(PT_HANDLE *hp_dfxp, int *ip_delay_sets)
+{
+	if (dfxp_BypassDelayLatency(hp_dfxp, IS_FALSE, ip_delay_sets) != OKAY)
+		return(NOT_OKAY);
+
+	if (!dfxp_SampleBuffersFit(hp_dfxp, *ip_delay_sets, DFXP_SAMPLE_BUFFER_DELAY))
+		*ip_delay_sets = 0;
+
+	return(OKAY);
+}
+
+/*
+ * FUNCTION: dfxp_BypassDelayFeed() 
+ * DESCRIPTION:
+ *   Writes the input into the crossfade's delay line while no crossfade is running, so the last chain
+ *   latency of unprocessed input is at hand when one starts. Only the end of the buffer that stays in
+ *   the delay line is copied. Takes the host's integer input from sp_int_io if it is not NULL.
+ */
+int dfxp_BypassDelayFeed(PT_HANDLE *hp_dfxp, realtype *rp_in, struct dfxp_surround_int_io_type *sp_int_io, int i_num_sample_sets)
+{
+	struct dfxpHdlType *cast_handle;
+	int i_delay_sets;
+	int i_num_channels;
+	int i_first;
+	int i_pos;
+	int i_len;
+
+	cast_handle = (struct dfxpHdlType *)(hp_dfxp);
+
+	if (cast_handle == NULL)
+		return(OKAY);
+
+	if (dfxp_BypassDelaySets(hp_dfxp, &i_delay_sets) != OKAY)
+		return(NOT_OKAY);
+	if (i_delay_sets <= 0)
+		return(OKAY);
+
+	i_num_channels = cast_handle->num_channels_out;
+
+	/* A changed latency starts again from silence */
+	if (i_delay_sets != cast_handle->bypass_fade.delay_sets)
+	{
+		memset(cast_handle->r_samples_delay, 0, (size_t)i_delay_sets * i_num_channels * sizeof(realtype));
+		cast_handle->bypass_fade.delay_sets = i_delay_sets;
+		cast_handle->bypass_fade.delay_pos = 0;
+	}
+
+	i_first = 0;
+	if (i_num_sample_sets > i_delay_sets)
+		i_first = i_num_sample_sets - i_delay_sets;
+	i_pos = (cast_handle->bypass_fade.delay_pos + i_first) % i_delay_sets;
+
+	/* At most two copies, up to the end of the delay line then from its start */
+	while (i_first < i_num_sample_sets)
+	{
+		i_len = i_num_sample_sets - i_first;
+		if (i_len > i_delay_sets - i_pos)
+			i_len = i_delay_sets - i_pos;
+
+		if (sp_int_io != NULL)
 		{
-			j = i * 2;
-			k = i * 8;
+			if (mthConvertIntBufToRealtype(i_len * i_num_channels, sp_int_io->bit_width, sp_int_io->bits_valid,
+													 (short int *)((unsigned char *)sp_int_io->sip_in + (long)i_first * i_num_channels * (sp_int_io->bit_width / 8)),
+													 cast_handle->r_samples_delay + (long)i_pos * i_num_channels) != OKAY)
+				return(NOT_OKAY);
+		}
+		else
+			memcpy(cast_handle->r_samples_delay + (long)i_pos * i_num_channels, rp_in + (long)i_first * i_num_channels,
+					 (size_t)i_len * i_num_channels * sizeof(realtype));
+
+		i_first += i_len;
+		i_pos += i_len;
+		if (i_pos == i_delay_sets)
+			i_pos = 0;
+	}
 
-			// Front channels
-			rp_samples[k]   = rp_buf[j];
-			rp_samples[k+1] = rp_buf[j+1];
+	cast_handle->bypass_fade.delay_pos = i_pos;
+	cast_handle->bypass_fade.delay_fed = IS_TRUE;
 
-			// Center channel
-			rp_samples[k+2] = rp_buf[i_num_sample_sets * 2 + i];
+	return(OKAY);
+}
 
-			// Subwoofer channel
-			rp_samples[k+3] = rp_buf[i_num_sample_sets * 3 + i];
+/*
+ * FUNCTION: dfxp_BypassDelayInPlace() 
+ * DESCRIPTION:
+ *   Runs rp_buf through r_samples_delay, swapping each sample set with the one written i_delay_sets
+ *   sample sets earlier. Before the delay line holds the current latency, on the first buffer or after
+ *   the latency changed, it is filled with the first sample set so the signal holds instead of
+ *   jumping to stale input.
+ */
+static void dfxp_BypassDelayInPlace(struct dfxpHdlType *cast_handle, realtype *rp_buf, int i_num_sample_sets, int i_delay_sets)
+{
+	realtype *rp_slot;
+	realtype r_tmp;
+	int i_num_channels;
+	int i_pos;
+	int i, j;
 
-			// Rear channels
-			rp_samples[k+4] = rp_buf[i_num_sample_sets * 4 + j];
-			rp_samples[k+5] = rp_buf[i_num_sample_sets * 4 + j + 1];
+	i_num_channels = cast_handle->num_channels_out;
 
-			// Rear channels
-			rp_samples[k+6] = rp_buf[i_num_sample_sets * 6 + j];
-			rp_samples[k+7] = rp_buf[i_num_sample_sets * 6 + j + 1];
+	if ((!cast_handle->bypass_fade.delay_fed) || (i_delay_sets != cast_handle->bypass_fade.delay_sets))
+	{
+		for (i = 0; i < i_delay_sets; i++)
+			memcpy(cast_handle->r_samples_delay + (long)i * i_num_channels, rp_buf, i_num_channels * sizeof(realtype));
+
+		cast_handle->bypass_fade.delay_sets = i_delay_sets;
+		cast_handle->bypass_fade.delay_pos = 0;
+	}
+
+	i_pos = cast_handle->bypass_fade.delay_pos;
+	rp_slot = cast_handle->r_samples_delay + (long)i_pos * i_num_channels;
+
+	for (i = 0; i < i_num_sample_sets; i++)
+	{
+		for (j = 0; j < i_num_channels; j++)
+		{
+			r_tmp = rp_slot[j];
+			rp_slot[j] = rp_buf[j];
+			rp_buf[j] = r_tmp;
 		}
 
-	/* Take care of recording */
-	if ((cast_handle->trace.mode) && (!cast_handle->trace.i_process_real_samples_done))
-		(cast_handle->slout1)->Message_Wide(FIRST_LINE, L"dfxpModifyShortIntSamples(): Calling dfxp_RecordBufferProcessed()");
+		rp_buf += i_num_channels;
 
-	if ((cast_handle->trace.mode) && (!cast_handle->trace.i_process_real_samples_done))
-		(cast_handle->slout1)->Message_Wide(FIRST_LINE, L"dfxpModifyRealtypeSamples(): Success");
+		if (++i_pos == i_delay_sets)
+		{
+			i_pos = 0;
+			rp_slot = cast_handle->r_samples_delay;
+		}
+		else
+			rp_slot += i_num_channels;
+	}
 
-	cast_handle->trace.i_process_real_samples_done = IS_TRUE;
+	cast_handle->bypass_fade.delay_pos = i_pos;
+	cast_handle->bypass_fade.delay_fed = IS_TRUE;
+}
+
+/*
+ * FUNCTION: dfxp_BypassDelayDry() 
+ * DESCRIPTION:
+ *   Delays the unprocessed input in rp_dry in place by the chain latency, so it lines up with the
+ *   processed signal it is crossfaded with. Both the feed and the bypassed pass through keep the
+ *   delay line current, so the dry signal carries on from the output before the fade started.
+ */
+int dfxp_BypassDelayDry(PT_HANDLE *hp_dfxp, realtype *rp_dry, int i_num_sample_sets)
+{
+	struct dfxpHdlType *cast_handle;
+	int i_delay_sets;
+
+	cast_handle = (struct dfxpHdlType *)(hp_dfxp);
+
+	if (cast_handle == NULL)
+		return(OKAY);
+
+	if (dfxp_BypassDelaySets(hp_dfxp, &i_delay_sets) != OKAY)
+		return(NOT_OKAY);
+	if (i_delay_sets <= 0)
+		return(OKAY);
+
+	dfxp_BypassDelayInPlace(cast_handle, rp_dry, i_num_sample_sets, i_delay_sets);
+
+	return(OKAY);
+}
+
+/*
+ * FUNCTION: dfxp_BypassDelayPassThrough() 
+ * DESCRIPTION:
+ *   Passes a bypassed buffer of the host's format through r_samples_delay, so the output keeps the
+ *   latency of the processing chain and neither end of a crossfade skips or repeats audio. Float
+ *   buffers are delayed in place in the output, integer buffers go through r_samples in blocks it
+ *   was sized for. Without a delay line the buffer is passed straight through.
+ */
+int dfxp_BypassDelayPassThrough(PT_HANDLE *hp_dfxp, short int *sip_in, short int *sip_out, int i_num_sample_sets)
+{
+	struct dfxpHdlType *cast_handle;
+	int i_delay_sets;
+	int i_num_channels;
+	int i_bytes_per_sample;
+	int i_block_sets;
+	int i_len;
+	int i;
+
+	cast_handle = (struct dfxpHdlType *)(hp_dfxp);
+
+	if (cast_handle == NULL)
+		return(OKAY);
+
+	i_num_channels = cast_handle->num_channels_out;
+	i_bytes_per_sample = cast_handle->universal.last_called_bps / 8;
+
+	if (dfxp_BypassDelaySets(hp_dfxp, &i_delay_sets) != OKAY)
+		return(NOT_OKAY);
+
+	i_block_sets = cast_handle->universal.block_sets;
+	if ((cast_handle->universal.last_called_bps != 32) && (!dfxp_SampleBuffersFit(hp_dfxp, i_block_sets, DFXP_SAMPLE_BUFFER_CONVERT)))
+		i_delay_sets = 0;
+
+	if (i_delay_sets <= 0)
+	{
+		if (sip_out != sip_in)
+			memmove(sip_out, sip_in, (size_t)i_num_sample_sets * i_num_channels * i_bytes_per_sample);
+		return(OKAY);
+	}
+
+	if (cast_handle->universal.last_called_bps == 32)
+	{
+		if (sip_out != sip_in)
+			memmove(sip_out, sip_in, (size_t)i_num_sample_sets * i_num_channels * sizeof(realtype));
+
+		dfxp_BypassDelayInPlace(cast_handle, (realtype *)sip_out, i_num_sample_sets, i_delay_sets);
+		return(OKAY);
+	}
+
+	for (i = 0; i < i_num_sample_sets; i += i_len)
+	{
+		i_len = i_num_sample_sets - i;
+		if (i_len > i_block_sets)
+			i_len = i_block_sets;
+
+		if (mthConvertIntBufToRealtype(i_len * i_num_channels, cast_handle->bits_per_sample, cast_handle->valid_bits,
+												 (short int *)((unsigned char *)sip_in + (long)i * i_num_channels * i_bytes_per_sample),
+												 cast_handle->r_samples) != OKAY)
+			return(NOT_OKAY);
+
+		dfxp_BypassDelayInPlace(cast_handle, cast_handle->r_samples, i_len, i_delay_sets);
+
+		if (mthConvertRealtypeBufToIntBuf(i_len * i_num_channels, cast_handle->bits_per_sample, cast_handle->valid_bits,
+													 cast_handle->r_samples,
+													 (short int *)((unsigned char *)sip_out + (long)i * i_num_channels * i_bytes_per_sample)) != OKAY)
+			return(NOT_OKAY);
+	}
 
 	return(OKAY);
 }
\ No newline at end of file
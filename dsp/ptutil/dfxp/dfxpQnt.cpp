@@ -20,6 +20,10 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <windows.h>
 #include <stdio.h>
+#include <string.h>
+
+#include <mutex>
+#include <new>
 
 #include "u_dfxp.h" /* Must go before codedefs.h due to mmgr */
 #include "codedefs.h"
@@ -38,8 +42,41 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "DfxSdk.h"
 #include "midi.h"
 
+
+/* The qnt handles are read only once built, so one copy of them is shared by all
+ * the instances in the process. The static set only depends on fixed ranges, the
+ * rate sets depend on the internal sampling freq and are built once per rate, so
+ * a format change to a rate another instance already runs at costs no table
+ * builds. A set is freed when the last instance using it lets go.
+ * Shared handles are built without a slout handle since they can outlive the
+ * instance that built them.
+ */
+struct dfxpQntSetType {
+	int ref_count;
+	realtype internal_sampling_freq;   /* Rate sets only */
+	realtype internal_sampling_period; /* Rate sets only */
+	struct midi_to_dsp_qnt_hdls midi_to_dsp;
+	PT_HANDLE *real_to_midi_qnt_hdl;   /* Static set only */
+	PT_HANDLE *midi_to_real_qnt_hdl;   /* Static set only */
+	struct dfxpQntSetType *next;
+};
+
+static std::mutex dfxp_qnt_set_lock;
+static struct dfxpQntSetType *dfxp_qnt_static_set = NULL;
+static struct dfxpQntSetType *dfxp_qnt_rate_sets = NULL;
+
+static int dfxp_BuildStaticQnts(struct dfxpQntSetType *);
+static int dfxp_BuildRateQnts_Aural(struct dfxpQntSetType *);
+static int dfxp_BuildRateQnts_Lex(struct dfxpQntSetType *);
+static int dfxp_BuildRateQnts_Opt(struct dfxpQntSetType *);
+static int dfxp_BuildRateQnts_Wid(struct dfxpQntSetType *);
+static int dfxp_BuildRateQnts_Play(struct dfxpQntSetType *);
+static int dfxp_BuildRateQnts_Delay(struct dfxpQntSetType *);
+static void dfxp_FreeQntSet(struct dfxpQntSetType *);
+static void dfxp_ReleaseQntSet(struct dfxpQntSetType **);
+
 /*
- * FUNCTION: dfxp_InitAllQnts() 
+ * FUNCTION: dfxp_InitAllQnts()
  * DESCRIPTION:
  *   Called one time to initialize all the qnt handles.
  */
@@ -55,35 +92,10 @@ int dfxp_InitAllQnts(PT_HANDLE *hp_dfxp)
 	/* Set all qnts to NULL */
  	cast_handle->real_to_midi_qnt_hdl = NULL;
  	cast_handle->midi_to_real_qnt_hdl = NULL;
+	memset(&(cast_handle->midi_to_dsp), 0, sizeof(struct midi_to_dsp_qnt_hdls));
 
-   cast_handle->midi_to_dsp.fidelity_qnt_hdl = NULL;
-	cast_handle->midi_to_dsp.spaciousness_qnt_hdl = NULL;
-	cast_handle->midi_to_dsp.ambience_qnt_hdl = NULL;
-	cast_handle->midi_to_dsp.dynamic_boost_qnt_hdl = NULL;
-	cast_handle->midi_to_dsp.bass_boost_qnt_hdl = NULL;
-
-	cast_handle->midi_to_dsp.aural_filter_gain_qnt_hdl = NULL;
-	cast_handle->midi_to_dsp.aural_filter_a1_qnt_hdl = NULL;
-	cast_handle->midi_to_dsp.aural_filter_a0_qnt_hdl = NULL;
-
-	cast_handle->midi_to_dsp.room_size_qnt_hdl = NULL;
-	cast_handle->midi_to_dsp.damping_bandwidth_qnt_hdl = NULL;
-   cast_handle->midi_to_dsp.rolloff_bandwidth_qnt_hdl = NULL;
-	cast_handle->midi_to_dsp.motion_rate_qnt_hdl = NULL;
-	cast_handle->midi_to_dsp.motion_depth_qnt_hdl = NULL;
-	cast_handle->midi_to_dsp.screen_lex_main_knob3_qnt_hdl = NULL;
-	cast_handle->midi_to_dsp.screen_lex_main_knob4_qnt_hdl = NULL;
-
-	cast_handle->midi_to_dsp.release_time_beta_qnt_hdl = NULL;
-	cast_handle->midi_to_dsp.screen_opt_main_knob3_qnt_hdl = NULL;
-
-	cast_handle->midi_to_dsp.dispersion_delay_qnt_hdl = NULL;
-	cast_handle->midi_to_dsp.wid_filter_gain_qnt_hdl = NULL;
-   cast_handle->midi_to_dsp.wid_filter_a1_qnt_hdl = NULL;
-	cast_handle->midi_to_dsp.wid_filter_a0_qnt_hdl = NULL;
-
-	/* Delay Specific */
-	cast_handle->midi_to_dsp.dly_qnt_hdl = NULL;
+	cast_handle->qnt_static_set = NULL;
+	cast_handle->qnt_rate_set = NULL;
 
 	/* Initialize the static qnt handle */
    if (dfxp_InitStaticQnts(hp_dfxp) != OKAY)
@@ -97,29 +109,271 @@ int dfxp_InitAllQnts(PT_HANDLE *hp_dfxp)
 }
 
 /*
- * FUNCTION: dfxp_InitStaticQnts() 
+ * FUNCTION: dfxp_InitStaticQnts()
  * DESCRIPTION:
- *   Called one time to initialize all the static qnt handles.
+ *   Called one time to point the instance at the shared static qnt handles,
+ *   building them if this is the first instance.
  */
 int dfxp_InitStaticQnts(PT_HANDLE *hp_dfxp)
 {
 	struct dfxpHdlType *cast_handle;
+	struct dfxpQntSetType *sp_set;
 
 	cast_handle = (struct dfxpHdlType *)(hp_dfxp);
 
 	if (cast_handle == NULL)
 		return(OKAY);
 
+	std::lock_guard<std::mutex> lock(dfxp_qnt_set_lock);
+
+	if (cast_handle->qnt_static_set != NULL)
+		return(OKAY);
+
+	sp_set = dfxp_qnt_static_set;
+	if (sp_set == NULL)
+	{
+		sp_set = new (std::nothrow) struct dfxpQntSetType();
+		if (sp_set == NULL)
+			return(NOT_OKAY);
+
+		if (dfxp_BuildStaticQnts(sp_set) != OKAY)
+		{
+			dfxp_FreeQntSet(sp_set);
+			return(NOT_OKAY);
+		}
+
+		dfxp_qnt_static_set = sp_set;
+	}
+
+	sp_set->ref_count++;
+	cast_handle->qnt_static_set = sp_set;
+
+	cast_handle->real_to_midi_qnt_hdl = sp_set->real_to_midi_qnt_hdl;
+	cast_handle->midi_to_real_qnt_hdl = sp_set->midi_to_real_qnt_hdl;
+	cast_handle->midi_to_dsp.fidelity_qnt_hdl = sp_set->midi_to_dsp.fidelity_qnt_hdl;
+	cast_handle->midi_to_dsp.ambience_qnt_hdl = sp_set->midi_to_dsp.ambience_qnt_hdl;
+	cast_handle->midi_to_dsp.dynamic_boost_qnt_hdl = sp_set->midi_to_dsp.dynamic_boost_qnt_hdl;
+	cast_handle->midi_to_dsp.spaciousness_qnt_hdl = sp_set->midi_to_dsp.spaciousness_qnt_hdl;
+	cast_handle->midi_to_dsp.room_size_qnt_hdl = sp_set->midi_to_dsp.room_size_qnt_hdl;
+
+	return(OKAY);
+}
+
+/*
+ * FUNCTION: dfxp_InitDynamicQnts()
+ * DESCRIPTION:
+ *   Initialize the qnt handles which change depending on other
+ *   settings such as sampling_freq.  This function can be called
+ *   repeatedly, the handles for a rate are only built once.
+ */
+int dfxp_InitDynamicQnts(PT_HANDLE *hp_dfxp)
+{
+	struct dfxpHdlType *cast_handle;
+	struct dfxpQntSetType *sp_set;
+	struct dfxpQntSetType *sp_old_set;
+
+	cast_handle = (struct dfxpHdlType *)(hp_dfxp);
+
+	if (cast_handle == NULL)
+		return(OKAY);
+
+	std::lock_guard<std::mutex> lock(dfxp_qnt_set_lock);
+
+	sp_old_set = cast_handle->qnt_rate_set;
+	if ((sp_old_set != NULL) && (sp_old_set->internal_sampling_freq == cast_handle->internal_sampling_freq))
+		return(OKAY);
+
+	for (sp_set = dfxp_qnt_rate_sets; sp_set != NULL; sp_set = sp_set->next)
+	{
+		if (sp_set->internal_sampling_freq == cast_handle->internal_sampling_freq)
+			break;
+	}
+
+	if (sp_set == NULL)
+	{
+		sp_set = new (std::nothrow) struct dfxpQntSetType();
+		if (sp_set == NULL)
+			return(NOT_OKAY);
+
+		sp_set->internal_sampling_freq = cast_handle->internal_sampling_freq;
+		sp_set->internal_sampling_period = cast_handle->internal_sampling_period;
+
+		if ((dfxp_BuildRateQnts_Aural(sp_set) != OKAY) ||
+			 (dfxp_BuildRateQnts_Lex(sp_set) != OKAY) ||
+			 (dfxp_BuildRateQnts_Opt(sp_set) != OKAY) ||
+			 (dfxp_BuildRateQnts_Wid(sp_set) != OKAY) ||
+			 (dfxp_BuildRateQnts_Play(sp_set) != OKAY) ||
+			 (dfxp_BuildRateQnts_Delay(sp_set) != OKAY))
+		{
+			dfxp_FreeQntSet(sp_set);
+			return(NOT_OKAY);
+		}
+
+		sp_set->next = dfxp_qnt_rate_sets;
+		dfxp_qnt_rate_sets = sp_set;
+	}
+
+	sp_set->ref_count++;
+	cast_handle->qnt_rate_set = sp_set;
+
+	cast_handle->midi_to_dsp.bass_boost_qnt_hdl = sp_set->midi_to_dsp.bass_boost_qnt_hdl;
+	cast_handle->midi_to_dsp.aural_filter_gain_qnt_hdl = sp_set->midi_to_dsp.aural_filter_gain_qnt_hdl;
+	cast_handle->midi_to_dsp.aural_filter_a1_qnt_hdl = sp_set->midi_to_dsp.aural_filter_a1_qnt_hdl;
+	cast_handle->midi_to_dsp.aural_filter_a0_qnt_hdl = sp_set->midi_to_dsp.aural_filter_a0_qnt_hdl;
+	cast_handle->midi_to_dsp.damping_bandwidth_qnt_hdl = sp_set->midi_to_dsp.damping_bandwidth_qnt_hdl;
+	cast_handle->midi_to_dsp.rolloff_bandwidth_qnt_hdl = sp_set->midi_to_dsp.rolloff_bandwidth_qnt_hdl;
+	cast_handle->midi_to_dsp.motion_rate_qnt_hdl = sp_set->midi_to_dsp.motion_rate_qnt_hdl;
+	cast_handle->midi_to_dsp.motion_depth_qnt_hdl = sp_set->midi_to_dsp.motion_depth_qnt_hdl;
+	cast_handle->midi_to_dsp.screen_lex_main_knob3_qnt_hdl = sp_set->midi_to_dsp.screen_lex_main_knob3_qnt_hdl;
+	cast_handle->midi_to_dsp.screen_lex_main_knob4_qnt_hdl = sp_set->midi_to_dsp.screen_lex_main_knob4_qnt_hdl;
+	cast_handle->midi_to_dsp.release_time_beta_qnt_hdl = sp_set->midi_to_dsp.release_time_beta_qnt_hdl;
+	cast_handle->midi_to_dsp.screen_opt_main_knob3_qnt_hdl = sp_set->midi_to_dsp.screen_opt_main_knob3_qnt_hdl;
+	cast_handle->midi_to_dsp.dispersion_delay_qnt_hdl = sp_set->midi_to_dsp.dispersion_delay_qnt_hdl;
+	cast_handle->midi_to_dsp.wid_filter_gain_qnt_hdl = sp_set->midi_to_dsp.wid_filter_gain_qnt_hdl;
+	cast_handle->midi_to_dsp.wid_filter_a1_qnt_hdl = sp_set->midi_to_dsp.wid_filter_a1_qnt_hdl;
+	cast_handle->midi_to_dsp.wid_filter_a0_qnt_hdl = sp_set->midi_to_dsp.wid_filter_a0_qnt_hdl;
+	cast_handle->midi_to_dsp.dly_qnt_hdl = sp_set->midi_to_dsp.dly_qnt_hdl;
+
+	/* Let go of the previous rate only once the instance points at the new one */
+	dfxp_ReleaseQntSet(&sp_old_set);
+
+	return(OKAY);
+}
+
+/*
+ * FUNCTION: dfxp_FreeAllQnts()
+ * DESCRIPTION:
+ *   Lets go of the shared qnt handles used by the instance, freeing any
+ *   set no other instance is using, and sets the instance handles to NULL.
+ */
+int dfxp_FreeAllQnts(PT_HANDLE *hp_dfxp)
+{
+	struct dfxpHdlType *cast_handle;
+
+	cast_handle = (struct dfxpHdlType *)(hp_dfxp);
+
+	if (cast_handle == NULL)
+		return(OKAY);
+
+	std::lock_guard<std::mutex> lock(dfxp_qnt_set_lock);
+
+ 	cast_handle->real_to_midi_qnt_hdl = NULL;
+ 	cast_handle->midi_to_real_qnt_hdl = NULL;
+	memset(&(cast_handle->midi_to_dsp), 0, sizeof(struct midi_to_dsp_qnt_hdls));
+
+	dfxp_ReleaseQntSet(&(cast_handle->qnt_static_set));
+	dfxp_ReleaseQntSet(&(cast_handle->qnt_rate_set));
+
+	return(OKAY);
+}
+
+/*
+ * FUNCTION: dfxp_ReleaseQntSet()
+ * DESCRIPTION:
+ *   Drops one reference to the passed set, freeing it with the last one.
+ *   Must be called with dfxp_qnt_set_lock held.
+ */
+static void dfxp_ReleaseQntSet(struct dfxpQntSetType **spp_set)
+{
+	struct dfxpQntSetType *sp_set;
+	struct dfxpQntSetType **spp_link;
+
+	sp_set = *spp_set;
+	*spp_set = NULL;
+
+	if (sp_set == NULL)
+		return;
+
+	sp_set->ref_count--;
+	if (sp_set->ref_count > 0)
+		return;
+
+	if (sp_set == dfxp_qnt_static_set)
+	{
+		dfxp_qnt_static_set = NULL;
+	}
+	else
+	{
+		for (spp_link = &dfxp_qnt_rate_sets; *spp_link != NULL; spp_link = &((*spp_link)->next))
+		{
+			if (*spp_link == sp_set)
+			{
+				*spp_link = sp_set->next;
+				break;
+			}
+		}
+	}
+
+	dfxp_FreeQntSet(sp_set);
+}
+
+/*
+ * FUNCTION: dfxp_FreeQntSet()
+ * DESCRIPTION:
+ *   Frees the qnt handles of the passed set and the set itself.
+ */
+static void dfxp_FreeQntSet(struct dfxpQntSetType *sp_set)
+{
+	if (sp_set == NULL)
+		return;
+
+	qntFreeUp(&(sp_set->midi_to_dsp.fidelity_qnt_hdl));
+	qntFreeUp(&(sp_set->midi_to_dsp.spaciousness_qnt_hdl));
+	qntFreeUp(&(sp_set->midi_to_dsp.ambience_qnt_hdl));
+	qntFreeUp(&(sp_set->midi_to_dsp.dynamic_boost_qnt_hdl));
+	qntFreeUp(&(sp_set->midi_to_dsp.bass_boost_qnt_hdl));
+
+	/* Fixed Aural Activation Specific */
+	qntFreeUp(&(sp_set->midi_to_dsp.aural_filter_gain_qnt_hdl));
+	qntFreeUp(&(sp_set->midi_to_dsp.aural_filter_a1_qnt_hdl));
+	qntFreeUp(&(sp_set->midi_to_dsp.aural_filter_a0_qnt_hdl));
+
+	/* Fixed Reverb Specific */
+	qntFreeUp(&(sp_set->midi_to_dsp.room_size_qnt_hdl));
+	qntFreeUp(&(sp_set->midi_to_dsp.damping_bandwidth_qnt_hdl));
+	qntFreeUp(&(sp_set->midi_to_dsp.rolloff_bandwidth_qnt_hdl));
+	qntFreeUp(&(sp_set->midi_to_dsp.motion_rate_qnt_hdl));
+	qntFreeUp(&(sp_set->midi_to_dsp.motion_depth_qnt_hdl));
+	qntFreeUp(&(sp_set->midi_to_dsp.screen_lex_main_knob3_qnt_hdl));
+	qntFreeUp(&(sp_set->midi_to_dsp.screen_lex_main_knob4_qnt_hdl));
+
+	/* Fixed Optimizer Specific */
+	qntFreeUp(&(sp_set->midi_to_dsp.release_time_beta_qnt_hdl));
+	qntFreeUp(&(sp_set->midi_to_dsp.screen_opt_main_knob3_qnt_hdl));
+
+	/* Fixed Widener Specific */
+	qntFreeUp(&(sp_set->midi_to_dsp.dispersion_delay_qnt_hdl));
+	qntFreeUp(&(sp_set->midi_to_dsp.wid_filter_gain_qnt_hdl));
+	qntFreeUp(&(sp_set->midi_to_dsp.wid_filter_a1_qnt_hdl));
+	qntFreeUp(&(sp_set->midi_to_dsp.wid_filter_a0_qnt_hdl));
+
+	/* Delay specific */
+	qntFreeUp(&(sp_set->midi_to_dsp.dly_qnt_hdl));
+
+	/* Free all the other qnt handles */
+	qntFreeUp(&(sp_set->real_to_midi_qnt_hdl));
+	qntFreeUp(&(sp_set->midi_to_real_qnt_hdl));
+
+	delete sp_set;
+}
+
+/*
+ * FUNCTION: dfxp_BuildStaticQnts()
+ * DESCRIPTION:
+ *   Builds the qnt handles which only depend on fixed ranges.
+ */
+static int dfxp_BuildStaticQnts(struct dfxpQntSetType *sp_set)
+{
    /* Real to MIDI qnt */
-	if (qntRToIInit(&(cast_handle->real_to_midi_qnt_hdl), cast_handle->slout1,
-                   DFX_UI_MIN_VALUE, DFX_UI_MAX_VALUE, 
+	if (qntRToIInit(&(sp_set->real_to_midi_qnt_hdl), NULL,
+                   DFX_UI_MIN_VALUE, DFX_UI_MAX_VALUE,
                    MIDI_MIN_VALUE, MIDI_MAX_VALUE,
 	                IS_TRUE, (MIDI_MAX_VALUE - MIDI_MIN_VALUE + 1),
 	                IS_FALSE) != OKAY)
       return(NOT_OKAY);
 
 	/* Midi to Real qnt */
-	if (qntIToRInit(&(cast_handle->midi_to_real_qnt_hdl), cast_handle->slout1,
+	if (qntIToRInit(&(sp_set->midi_to_real_qnt_hdl), NULL,
 		             MIDI_MIN_VALUE, MIDI_MAX_VALUE,
 						 (realtype)DFX_UI_MIN_VALUE,
 						 (realtype)DFX_UI_MAX_VALUE,
@@ -129,9 +383,9 @@ int dfxp_InitStaticQnts(PT_HANDLE *hp_dfxp)
 		return(NOT_OKAY);
 
 	/* Fidelity */
-	if (qntIToRInit(&(cast_handle->midi_to_dsp.fidelity_qnt_hdl), cast_handle->slout1,
+	if (qntIToRInit(&(sp_set->midi_to_dsp.fidelity_qnt_hdl), NULL,
 					  MIDI_MIN_VALUE, MIDI_MAX_VALUE,
-					  (realtype)DSP_AURAL_DRIVE_MIN_VALUE, 
+					  (realtype)DSP_AURAL_DRIVE_MIN_VALUE,
 					  (realtype)DSP_AURAL_DRIVE_MAX_VALUE * (realtype)PLY_FIDELITY_INTENSITY_MAX_SCALE,
 					  IS_FALSE, 0,
 					  IS_FALSE, 0,
@@ -141,9 +395,9 @@ int dfxp_InitStaticQnts(PT_HANDLE *hp_dfxp)
 	/* Ambience - Note that an exponential curve is used instead of the linear
 	 * from the Studioverb, to push heavy decays more to the end.
 	 */
-	if (qntIToRInit(&(cast_handle->midi_to_dsp.ambience_qnt_hdl), cast_handle->slout1,
+	if (qntIToRInit(&(sp_set->midi_to_dsp.ambience_qnt_hdl), NULL,
 					  MIDI_MIN_VALUE, MIDI_MAX_VALUE,
-					  (realtype)PLY_DECAY_MIN_VALUE, 
+					  (realtype)PLY_DECAY_MIN_VALUE,
 					  (realtype)PLY_DECAY_MAX_VALUE,
 					  IS_FALSE, 0,
 					  IS_FALSE, 0,
@@ -151,9 +405,9 @@ int dfxp_InitStaticQnts(PT_HANDLE *hp_dfxp)
 		return(NOT_OKAY);
 
 	/* Dynamic Boost */
-	if (qntIToRInit(&(cast_handle->midi_to_dsp.dynamic_boost_qnt_hdl), cast_handle->slout1,
+	if (qntIToRInit(&(sp_set->midi_to_dsp.dynamic_boost_qnt_hdl), NULL,
 					  MIDI_MIN_VALUE, MIDI_MAX_VALUE,
-					  (realtype)DSP_MAXIMIZE_GAIN_BOOST_MIN_VALUE, 
+					  (realtype)DSP_MAXIMIZE_GAIN_BOOST_MIN_VALUE,
 					  (realtype)DSP_MAXIMIZE_GAIN_BOOST_MAX_VALUE,
 					  IS_FALSE, 0,
 					  IS_FALSE, 0,
@@ -161,22 +415,22 @@ int dfxp_InitStaticQnts(PT_HANDLE *hp_dfxp)
 		return(NOT_OKAY);
 
 	/* Spaciousness */
-	if (qntIToRInit(&(cast_handle->midi_to_dsp.spaciousness_qnt_hdl), cast_handle->slout1,
+	if (qntIToRInit(&(sp_set->midi_to_dsp.spaciousness_qnt_hdl), NULL,
 					  MIDI_MIN_VALUE, MIDI_MAX_VALUE,
-					  (realtype)DSP_WID_INTENSITY_MIN_VALUE, 
+					  (realtype)DSP_WID_INTENSITY_MIN_VALUE,
 					  (realtype)(DSP_WID_INTENSITY_MAX_VALUE * PLY_WIDENER_BOOST_MAX_SCALE),
 					  IS_FALSE, 0,
 					  IS_FALSE, 0,
 					  IS_FALSE, QNT_RESPONSE_LINEAR) != OKAY)
 		return(NOT_OKAY);
 
-	/* 
+	/*
 	 * Room Size (Special Case: This one is fixed and does not change
 	 *            with the sampling freq.)
 	 */
-	if (qntIToRInit(&(cast_handle->midi_to_dsp.room_size_qnt_hdl), cast_handle->slout1,
+	if (qntIToRInit(&(sp_set->midi_to_dsp.room_size_qnt_hdl), NULL,
 					  MIDI_MIN_VALUE, MIDI_MAX_VALUE,
-					  (realtype)DSP_LEX_ROOM_SIZE_MIN_VALUE, 
+					  (realtype)DSP_LEX_ROOM_SIZE_MIN_VALUE,
 					  (realtype)DSP_LEX_ROOM_SIZE_MAX_VALUE,
 					  IS_FALSE, 0,
 					  IS_FALSE, 0,
@@ -187,77 +441,22 @@ int dfxp_InitStaticQnts(PT_HANDLE *hp_dfxp)
 }
 
 /*
- * FUNCTION: dfxp_InitDynamicQnts() 
+ * FUNCTION: dfxp_BuildRateQnts_Aural()
  * DESCRIPTION:
- *   Initialize the qnt handles which change depending on other
- *   settings such as sampling_freq.  This function can be called
- *   repeatedly.
+ *   Builds the Aural qnt handles for the internal sampling freq of the set.
  */
-int dfxp_InitDynamicQnts(PT_HANDLE *hp_dfxp)
+static int dfxp_BuildRateQnts_Aural(struct dfxpQntSetType *sp_set)
 {
-	struct dfxpHdlType *cast_handle;
-
-	cast_handle = (struct dfxpHdlType *)(hp_dfxp);
-
-	if (cast_handle == NULL)
-		return(OKAY);
-
-	/* Initialize Dynamic qnts */
-	if (dfxp_InitDynamicQnts_Aural(hp_dfxp) != OKAY)
-		return(NOT_OKAY);
-	if (dfxp_InitDynamicQnts_Lex(hp_dfxp) != OKAY)
-		return(NOT_OKAY);
-	if (dfxp_InitDynamicQnts_Opt(hp_dfxp) != OKAY)
-		return(NOT_OKAY);
-	if (dfxp_InitDynamicQnts_Wid(hp_dfxp) != OKAY)
-		return(NOT_OKAY);
-	if (dfxp_InitDynamicQnts_Play(hp_dfxp) != OKAY)
-		return(NOT_OKAY);
-	if (dfxp_InitDynamicQnts_Delay(hp_dfxp) != OKAY)
-		return(NOT_OKAY);
-
-	return(OKAY);
-}
-
-/*
- * FUNCTION: dfxp_InitDynamicQnts_Aural() 
- * DESCRIPTION:
- */
-int dfxp_InitDynamicQnts_Aural(PT_HANDLE *hp_dfxp)
-{
-	struct dfxpHdlType *cast_handle;
-
-	cast_handle = (struct dfxpHdlType *)(hp_dfxp);
-
-	if (cast_handle == NULL)
-		return(OKAY);
-
 	/* This feeds the highpass filter with the -3db point in normalized radian frequency */
 	realtype omega_min, omega_max;
 
-	omega_min = (realtype)TWO_PI * (realtype) DFXP_AURAL_CONTROL_HERTZ_MIN_VAL * cast_handle->internal_sampling_period;
-	omega_max = (realtype)TWO_PI * (realtype) DFXP_AURAL_CONTROL_HERTZ_MAX_VAL * cast_handle->internal_sampling_period;
-
-	if (cast_handle->midi_to_dsp.aural_filter_gain_qnt_hdl != NULL)
-	{
-	   if (qntFreeUp(&(cast_handle->midi_to_dsp.aural_filter_gain_qnt_hdl)) != OKAY)
-	      return(NOT_OKAY);
-	}
-	if (cast_handle->midi_to_dsp.aural_filter_a1_qnt_hdl != NULL)
-	{
-	   if (qntFreeUp(&(cast_handle->midi_to_dsp.aural_filter_a1_qnt_hdl)) != OKAY)
-	      return(NOT_OKAY);
-	}
-	if (cast_handle->midi_to_dsp.aural_filter_a0_qnt_hdl != NULL)
-	{
-	   if (qntFreeUp(&(cast_handle->midi_to_dsp.aural_filter_a0_qnt_hdl)) != OKAY)
-	      return(NOT_OKAY);
-	}
+	omega_min = (realtype)TWO_PI * (realtype) DFXP_AURAL_CONTROL_HERTZ_MIN_VAL * sp_set->internal_sampling_period;
+	omega_max = (realtype)TWO_PI * (realtype) DFXP_AURAL_CONTROL_HERTZ_MAX_VAL * sp_set->internal_sampling_period;
 
-	if (qnt2ndOrderButterworthInit(&(cast_handle->midi_to_dsp.aural_filter_gain_qnt_hdl),
-												&(cast_handle->midi_to_dsp.aural_filter_a1_qnt_hdl),
-												&(cast_handle->midi_to_dsp.aural_filter_a0_qnt_hdl),
-												cast_handle->slout1, MIDI_MIN_VALUE, MIDI_MAX_VALUE,
+	if (qnt2ndOrderButterworthInit(&(sp_set->midi_to_dsp.aural_filter_gain_qnt_hdl),
+												&(sp_set->midi_to_dsp.aural_filter_a1_qnt_hdl),
+												&(sp_set->midi_to_dsp.aural_filter_a0_qnt_hdl),
+												NULL, MIDI_MIN_VALUE, MIDI_MAX_VALUE,
 												omega_min, omega_max, QNT_RESPONSE_LINEAR) != OKAY)
 		return(NOT_OKAY);
 
@@ -265,33 +464,21 @@ int dfxp_InitDynamicQnts_Aural(PT_HANDLE *hp_dfxp)
 }
 
 /*
- * FUNCTION: dfxp_InitDynamicQnts_Lex() 
+ * FUNCTION: dfxp_BuildRateQnts_Lex()
  * DESCRIPTION:
+ *   Builds the Lex qnt handles for the internal sampling freq of the set.
  */
-int dfxp_InitDynamicQnts_Lex(PT_HANDLE *hp_dfxp)
+static int dfxp_BuildRateQnts_Lex(struct dfxpQntSetType *sp_set)
 {
-	struct dfxpHdlType *cast_handle;
-
-	cast_handle = (struct dfxpHdlType *)(hp_dfxp);
-
-	if (cast_handle == NULL)
-		return(OKAY);
-
    realtype dsp_motion_rate_min_value;
    realtype dsp_motion_rate_max_value;
    realtype dsp_motion_depth_max_value;
 
-   if (cast_handle->midi_to_dsp.screen_lex_main_knob3_qnt_hdl != NULL)
-	{
-	   if (qntFreeUp(&(cast_handle->midi_to_dsp.screen_lex_main_knob3_qnt_hdl)) != OKAY)
-	      return(NOT_OKAY);
-	}
-
 	/* Note - this qnt handle is set up like the Lexicon plug-in knob3 screen
 	 * display qnt handle, to allow proper initialization of the
 	 * damping_bandwidth_qnt_hdl qnt handle.
 	 */
-	if (qntIToRInit(&(cast_handle->midi_to_dsp.screen_lex_main_knob3_qnt_hdl), cast_handle->slout1,
+	if (qntIToRInit(&(sp_set->midi_to_dsp.screen_lex_main_knob3_qnt_hdl), NULL,
 					    MIDI_MIN_VALUE, MIDI_MAX_VALUE,
 					    (realtype)LEX_HIGH_FREQ_ROLLOFF_MIN_VAL, 
 					    (realtype)LEX_HIGH_FREQ_ROLLOFF_MAX_VAL,
@@ -300,28 +487,16 @@ int dfxp_InitDynamicQnts_Lex(PT_HANDLE *hp_dfxp)
 					    IS_TRUE, QNT_RESPONSE_EXP) != OKAY)
       return(NOT_OKAY);
 
-	if (cast_handle->midi_to_dsp.damping_bandwidth_qnt_hdl != NULL)
-	{
-	   if (qntFreeUp(&(cast_handle->midi_to_dsp.damping_bandwidth_qnt_hdl)) != OKAY)
-	      return(NOT_OKAY);
-	}
-
-	if (qntIToRSimpleLowpassInit(&(cast_handle->midi_to_dsp.damping_bandwidth_qnt_hdl),
-						cast_handle->midi_to_dsp.screen_lex_main_knob3_qnt_hdl, cast_handle->slout1,
-						cast_handle->internal_sampling_period, 1.0e3) != OKAY)
+	if (qntIToRSimpleLowpassInit(&(sp_set->midi_to_dsp.damping_bandwidth_qnt_hdl),
+						sp_set->midi_to_dsp.screen_lex_main_knob3_qnt_hdl, NULL,
+						sp_set->internal_sampling_period, 1.0e3) != OKAY)
 		return(NOT_OKAY);
 
-   if (cast_handle->midi_to_dsp.screen_lex_main_knob4_qnt_hdl != NULL)
-	{
-	   if (qntFreeUp(&(cast_handle->midi_to_dsp.screen_lex_main_knob4_qnt_hdl)) != OKAY)
-	      return(NOT_OKAY);
-	}
-
 	/* Note - this qnt handle is set up like the Lexicon plug-in knob4 screen
 	 * display qnt handle, to allow proper initialization of the
 	 * damping_bandwidth_qnt_hdl qnt handle.
 	 */
-	if (qntIToRInit(&(cast_handle->midi_to_dsp.screen_lex_main_knob4_qnt_hdl), cast_handle->slout1,
+	if (qntIToRInit(&(sp_set->midi_to_dsp.screen_lex_main_knob4_qnt_hdl), NULL,
 					  MIDI_MIN_VALUE, MIDI_MAX_VALUE,
 					  (realtype)LEX_HIGH_FREQ_DECAY_MIN_VAL, 
 					  (realtype)LEX_HIGH_FREQ_DECAY_MAX_VAL,
@@ -330,32 +505,21 @@ int dfxp_InitDynamicQnts_Lex(PT_HANDLE *hp_dfxp)
 					  IS_TRUE, QNT_RESPONSE_EXP) != OKAY)
 		return(NOT_OKAY);
 
-	if (cast_handle->midi_to_dsp.rolloff_bandwidth_qnt_hdl != NULL)
-	{
-	   if (qntFreeUp(&(cast_handle->midi_to_dsp.rolloff_bandwidth_qnt_hdl)) != OKAY)
-	      return(NOT_OKAY);
-	}
-
-	if (qntIToRSimpleLowpassInit(&(cast_handle->midi_to_dsp.rolloff_bandwidth_qnt_hdl),
-						cast_handle->midi_to_dsp.screen_lex_main_knob4_qnt_hdl, cast_handle->slout1,
-						cast_handle->internal_sampling_period, 1.0e3) != OKAY)
+	if (qntIToRSimpleLowpassInit(&(sp_set->midi_to_dsp.rolloff_bandwidth_qnt_hdl),
+						sp_set->midi_to_dsp.screen_lex_main_knob4_qnt_hdl, NULL,
+						sp_set->internal_sampling_period, 1.0e3) != OKAY)
 		return(NOT_OKAY);
   
 	/* Calculate the min and max dsp values for motion rate.
 	 * Note the compensation for the repeated point on the oscillator.
 	 */
 	{
-		realtype tmp_r = (realtype)(LEX_NUM_OSC_PTS - 1) * cast_handle->internal_sampling_period;
+		realtype tmp_r = (realtype)(LEX_NUM_OSC_PTS - 1) * sp_set->internal_sampling_period;
 		dsp_motion_rate_min_value = (realtype)(DSP_LEX_MOTION_RATE_MIN_VALUE) * tmp_r;
 		dsp_motion_rate_max_value = (realtype)(DSP_LEX_MOTION_RATE_MAX_VALUE) * tmp_r;
 	}
 
-	if (cast_handle->midi_to_dsp.motion_rate_qnt_hdl != NULL)
-	{
-	   if (qntFreeUp(&(cast_handle->midi_to_dsp.motion_rate_qnt_hdl)) != OKAY)
-	      return(NOT_OKAY);
-	}
-	if (qntIToRInit(&(cast_handle->midi_to_dsp.motion_rate_qnt_hdl), cast_handle->slout1,
+	if (qntIToRInit(&(sp_set->midi_to_dsp.motion_rate_qnt_hdl), NULL,
 					  MIDI_MIN_VALUE, MIDI_MAX_VALUE,
 					  (realtype)dsp_motion_rate_min_value, 
 					  (realtype)dsp_motion_rate_max_value,
@@ -364,14 +528,9 @@ int dfxp_InitDynamicQnts_Lex(PT_HANDLE *hp_dfxp)
 					  IS_FALSE, QNT_RESPONSE_LINEAR) != OKAY)
 		return(NOT_OKAY);
 
-	dsp_motion_depth_max_value = (realtype)(LEX_MODULATION_DELAY_MAX_MS/1000.0) * cast_handle->internal_sampling_freq;
+	dsp_motion_depth_max_value = (realtype)(LEX_MODULATION_DELAY_MAX_MS/1000.0) * sp_set->internal_sampling_freq;
 
-	if (cast_handle->midi_to_dsp.motion_depth_qnt_hdl != NULL)
-	{
-	   if (qntFreeUp(&(cast_handle->midi_to_dsp.motion_depth_qnt_hdl)) != OKAY)
-	      return(NOT_OKAY);
-	}
-	if (qntIToRInit(&(cast_handle->midi_to_dsp.motion_depth_qnt_hdl), cast_handle->slout1,
+	if (qntIToRInit(&(sp_set->midi_to_dsp.motion_depth_qnt_hdl), NULL,
 					  MIDI_MIN_VALUE, MIDI_MAX_VALUE,
 					  (realtype)0.0, 
 					  dsp_motion_depth_max_value,
@@ -384,29 +543,17 @@ int dfxp_InitDynamicQnts_Lex(PT_HANDLE *hp_dfxp)
 }
 
 /*
- * FUNCTION: dfxp_InitDynamicQnts_Opt() 
+ * FUNCTION: dfxp_BuildRateQnts_Opt()
  * DESCRIPTION:
+ *   Builds the Opt qnt handles for the internal sampling freq of the set.
  */
-int dfxp_InitDynamicQnts_Opt(PT_HANDLE *hp_dfxp)
+static int dfxp_BuildRateQnts_Opt(struct dfxpQntSetType *sp_set)
 {
-	struct dfxpHdlType *cast_handle;
-
-	cast_handle = (struct dfxpHdlType *)(hp_dfxp);
-
-	if (cast_handle == NULL)
-		return(OKAY);
-
-   if (cast_handle->midi_to_dsp.screen_opt_main_knob3_qnt_hdl != NULL)
-	{
-	   if (qntFreeUp(&(cast_handle->midi_to_dsp.screen_opt_main_knob3_qnt_hdl)) != OKAY)
-	      return(NOT_OKAY);
-   }
-
 	/* Note - this qnt handle is set up like the Optimizer plug-in knob3 screen
 	 * display qnt handle, to allow proper initialization of the
 	 * release_time_beta_qnt_hdl qnt handle.
 	 */
-	if (qntIToRInit(&(cast_handle->midi_to_dsp.screen_opt_main_knob3_qnt_hdl), cast_handle->slout1,
+	if (qntIToRInit(&(sp_set->midi_to_dsp.screen_opt_main_knob3_qnt_hdl), NULL,
 					    MIDI_MIN_VALUE, MIDI_MAX_VALUE,
 					    (realtype)MAXIMIZE_MIN_TIME_CONST, 
 					    (realtype)MAXIMIZE_MAX_TIME_CONST,
@@ -415,35 +562,24 @@ int dfxp_InitDynamicQnts_Opt(PT_HANDLE *hp_dfxp)
 					    IS_TRUE, QNT_RESPONSE_EXP) != OKAY)
       return(NOT_OKAY);
 
-	if (cast_handle->midi_to_dsp.release_time_beta_qnt_hdl != NULL)
-	{
-	   if (qntFreeUp(&(cast_handle->midi_to_dsp.release_time_beta_qnt_hdl)) != OKAY)
-	      return(NOT_OKAY);
-	}
 	/* Uses a qnt handle with desired settings in millisecs to create a qnt handle
 	 * with the corresponding exponential beta values.
 	 */
-	if (qntIToRTimeConstantBeta(&(cast_handle->midi_to_dsp.release_time_beta_qnt_hdl), 
-		                         cast_handle->midi_to_dsp.screen_opt_main_knob3_qnt_hdl, cast_handle->slout1,
-                               cast_handle->internal_sampling_freq) != OKAY)
+	if (qntIToRTimeConstantBeta(&(sp_set->midi_to_dsp.release_time_beta_qnt_hdl), 
+		                         sp_set->midi_to_dsp.screen_opt_main_knob3_qnt_hdl, NULL,
+                               sp_set->internal_sampling_freq) != OKAY)
 		return(NOT_OKAY);
 
    return(OKAY);
 }
 
 /*
- * FUNCTION: dfxp_InitDynamicQnts_Wid() 
+ * FUNCTION: dfxp_BuildRateQnts_Wid()
  * DESCRIPTION:
+ *   Builds the Wid qnt handles for the internal sampling freq of the set.
  */
-int dfxp_InitDynamicQnts_Wid(PT_HANDLE *hp_dfxp)
+static int dfxp_BuildRateQnts_Wid(struct dfxpQntSetType *sp_set)
 {
-	struct dfxpHdlType *cast_handle;
-
-	cast_handle = (struct dfxpHdlType *)(hp_dfxp);
-
-	if (cast_handle == NULL)
-		return(OKAY);
-
 	long dsp_dispersion_min_value;
 	long dsp_dispersion_max_value;
    realtype dsp_threshold_min_value;
@@ -455,16 +591,11 @@ int dfxp_InitDynamicQnts_Wid(PT_HANDLE *hp_dfxp)
 	 * Note delay line method requires minimum delay of 1.
 	 */
 	dsp_dispersion_min_value = 
-	   1 + (long)((float)(WID_DISPERSION_MIN_MS * 0.001) * cast_handle->internal_sampling_freq);
+	   1 + (long)((float)(WID_DISPERSION_MIN_MS * 0.001) * sp_set->internal_sampling_freq);
 	dsp_dispersion_max_value = 
-	   (long)((float)(WID_DISPERSION_MAX_MS * 0.001) * cast_handle->internal_sampling_freq);
+	   (long)((float)(WID_DISPERSION_MAX_MS * 0.001) * sp_set->internal_sampling_freq);
 
-	if (cast_handle->midi_to_dsp.dispersion_delay_qnt_hdl != NULL)
-	{
-	   if (qntFreeUp(&(cast_handle->midi_to_dsp.dispersion_delay_qnt_hdl)) != OKAY)
-	      return(NOT_OKAY);
-	}
-	if (qntIToLInit(&(cast_handle->midi_to_dsp.dispersion_delay_qnt_hdl), cast_handle->slout1,
+	if (qntIToLInit(&(sp_set->midi_to_dsp.dispersion_delay_qnt_hdl), NULL,
 					  MIDI_MIN_VALUE, MIDI_MAX_VALUE,
 					  dsp_dispersion_min_value, 
 					  dsp_dispersion_max_value,
@@ -473,34 +604,18 @@ int dfxp_InitDynamicQnts_Wid(PT_HANDLE *hp_dfxp)
 
    /* Calculate the min and max dsp values of threshold */
    dsp_threshold_min_value = 
-		(realtype)(WID_FREQ_THRESHOLD_MIN) * cast_handle->internal_sampling_period;
+		(realtype)(WID_FREQ_THRESHOLD_MIN) * sp_set->internal_sampling_period;
    dsp_threshold_max_value = 
-	   (realtype)(WID_FREQ_THRESHOLD_MAX) * cast_handle->internal_sampling_period;
+	   (realtype)(WID_FREQ_THRESHOLD_MAX) * sp_set->internal_sampling_period;
 
 	/* This feeds the highpass filter with the -3db point in normalized radian frequency */
-	omega_min = (realtype)TWO_PI * (realtype) WID_FREQ_THRESHOLD_MIN * cast_handle->internal_sampling_period;
-	omega_max = (realtype)TWO_PI * (realtype) WID_FREQ_THRESHOLD_MAX * cast_handle->internal_sampling_period;
-
-	if (cast_handle->midi_to_dsp.wid_filter_gain_qnt_hdl != NULL)
-	{
-	   if (qntFreeUp(&(cast_handle->midi_to_dsp.wid_filter_gain_qnt_hdl)) != OKAY)
-	      return(NOT_OKAY);
-	}
-	if (cast_handle->midi_to_dsp.wid_filter_a1_qnt_hdl != NULL)
-	{
-	   if (qntFreeUp(&(cast_handle->midi_to_dsp.wid_filter_a1_qnt_hdl)) != OKAY)
-	      return(NOT_OKAY);
-	}
-	if (cast_handle->midi_to_dsp.wid_filter_a0_qnt_hdl != NULL)
-	{
-	   if (qntFreeUp(&(cast_handle->midi_to_dsp.wid_filter_a0_qnt_hdl)) != OKAY)
-	      return(NOT_OKAY);
-	}
+	omega_min = (realtype)TWO_PI * (realtype) WID_FREQ_THRESHOLD_MIN * sp_set->internal_sampling_period;
+	omega_max = (realtype)TWO_PI * (realtype) WID_FREQ_THRESHOLD_MAX * sp_set->internal_sampling_period;
 
-	if (qnt2ndOrderButterworthInit(&(cast_handle->midi_to_dsp.wid_filter_gain_qnt_hdl),
-												&(cast_handle->midi_to_dsp.wid_filter_a1_qnt_hdl),
-												&(cast_handle->midi_to_dsp.wid_filter_a0_qnt_hdl),
-												cast_handle->slout1, MIDI_MIN_VALUE, MIDI_MAX_VALUE,
+	if (qnt2ndOrderButterworthInit(&(sp_set->midi_to_dsp.wid_filter_gain_qnt_hdl),
+												&(sp_set->midi_to_dsp.wid_filter_a1_qnt_hdl),
+												&(sp_set->midi_to_dsp.wid_filter_a0_qnt_hdl),
+												NULL, MIDI_MIN_VALUE, MIDI_MAX_VALUE,
 												omega_min, omega_max, QNT_RESPONSE_LINEAR) != OKAY)
 		return(NOT_OKAY);
 
@@ -508,31 +623,19 @@ int dfxp_InitDynamicQnts_Wid(PT_HANDLE *hp_dfxp)
 }
 
 /*
- * FUNCTION: dfxp_InitDynamicQnts_Play() 
+ * FUNCTION: dfxp_BuildRateQnts_Play()
  * DESCRIPTION:
+ *   Builds the Play qnt handles for the internal sampling freq of the set.
  */
-int dfxp_InitDynamicQnts_Play(PT_HANDLE *hp_dfxp)
+static int dfxp_BuildRateQnts_Play(struct dfxpQntSetType *sp_set)
 {
-	struct dfxpHdlType *cast_handle;
-
-	cast_handle = (struct dfxpHdlType *)(hp_dfxp);
-
-	if (cast_handle == NULL)
-		return(OKAY);
-
-	if (cast_handle->midi_to_dsp.bass_boost_qnt_hdl != NULL)
-	{
-	   if (qntFreeUp(&(cast_handle->midi_to_dsp.bass_boost_qnt_hdl)) != OKAY)
-	      return(NOT_OKAY);
-	}
-
 	/* Bass Boost component of Play dsp function */
-	if (qntIToBoostCutInit(&(cast_handle->midi_to_dsp.bass_boost_qnt_hdl), cast_handle->slout1,
+	if (qntIToBoostCutInit(&(sp_set->midi_to_dsp.bass_boost_qnt_hdl), NULL,
 					  MIDI_MIN_VALUE, MIDI_MAX_VALUE,
 					  (realtype)DSP_PLY_BASSBOOST_MIN_VALUE, 
 					  (realtype)DSP_PLY_BASSBOOST_MAX_VALUE,
 					  (realtype)DSP_PLY_BASSBOOST_CENTER_FREQ,
-					  cast_handle->internal_sampling_freq,
+					  sp_set->internal_sampling_freq,
 					  (realtype)DSP_PLY_BASSBOOST_Q,
 					  FILT_BOOST_CUT) != OKAY)
 		return(NOT_OKAY);
@@ -541,18 +644,12 @@ int dfxp_InitDynamicQnts_Play(PT_HANDLE *hp_dfxp)
 }
 
 /*
- * FUNCTION: dfxp_InitDynamicQnts_Delay() 
+ * FUNCTION: dfxp_BuildRateQnts_Delay()
  * DESCRIPTION:
+ *   Builds the Delay qnt handles for the internal sampling freq of the set.
  */
-int dfxp_InitDynamicQnts_Delay(PT_HANDLE *hp_dfxp)
+static int dfxp_BuildRateQnts_Delay(struct dfxpQntSetType *sp_set)
 {
-	struct dfxpHdlType *cast_handle;
-
-	cast_handle = (struct dfxpHdlType *)(hp_dfxp);
-
-	if (cast_handle == NULL)
-		return(OKAY);
-
 	/* Delay qnt */
    long dsp_delay_max_value;
    realtype max_total_dly_msecs;
@@ -560,15 +657,9 @@ int dfxp_InitDynamicQnts_Delay(PT_HANDLE *hp_dfxp)
 
    max_total_dly_msecs = DSP_PLY_MAX_ELEMENT_DELAY;
    max_total_dly_secs = (max_total_dly_msecs) / (realtype) 1000.0;
-   dsp_delay_max_value = (long)((cast_handle->internal_sampling_freq)*(max_total_dly_secs));
+   dsp_delay_max_value = (long)((sp_set->internal_sampling_freq)*(max_total_dly_secs));
    
-	if (cast_handle->midi_to_dsp.dly_qnt_hdl != NULL)
-	{
-	   if (qntFreeUp(&(cast_handle->midi_to_dsp.dly_qnt_hdl)) != OKAY)
-	      return(NOT_OKAY);
-	}
-
-   if (qntRToLInit(&(cast_handle->midi_to_dsp.dly_qnt_hdl), cast_handle->slout1,
+   if (qntRToLInit(&(sp_set->midi_to_dsp.dly_qnt_hdl), NULL,
 					  0, max_total_dly_msecs,
 					  DSP_DELAY_MIN_VALUE, dsp_delay_max_value,
 					  IS_FALSE, 0) != OKAY)
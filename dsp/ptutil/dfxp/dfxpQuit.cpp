@@ -75,156 +75,13 @@ int dfxp_FreeAll(PT_HANDLE *hp_dfxp)
 	if (cast_handle == NULL)
 		return(OKAY);
 
-   /* Free all the midi_to_dsp qnt handles */
-   if (cast_handle->midi_to_dsp.fidelity_qnt_hdl != NULL)
-   {
-      if (qntFreeUp(&(cast_handle->midi_to_dsp.fidelity_qnt_hdl)) != OKAY)
-         return(NOT_OKAY);
-   }   
-
-   if (cast_handle->midi_to_dsp.spaciousness_qnt_hdl != NULL)
-   {
-      if (qntFreeUp(&(cast_handle->midi_to_dsp.spaciousness_qnt_hdl)) != OKAY)
-         return(NOT_OKAY);
-   } 
-
-   if (cast_handle->midi_to_dsp.ambience_qnt_hdl != NULL)
-   {
-      if (qntFreeUp(&(cast_handle->midi_to_dsp.ambience_qnt_hdl)) != OKAY)
-         return(NOT_OKAY);
-   } 
-
-   if (cast_handle->midi_to_dsp.dynamic_boost_qnt_hdl != NULL)
-   {
-      if (qntFreeUp(&(cast_handle->midi_to_dsp.dynamic_boost_qnt_hdl)) != OKAY)
-         return(NOT_OKAY);
-   } 
-
-   if (cast_handle->midi_to_dsp.bass_boost_qnt_hdl != NULL)
-   {
-      if (qntFreeUp(&(cast_handle->midi_to_dsp.bass_boost_qnt_hdl)) != OKAY)
-         return(NOT_OKAY);
-   } 
-
-	/* Fixed Aural Activation Specific */
-   if (cast_handle->midi_to_dsp.aural_filter_gain_qnt_hdl != NULL)
-   {
-      if (qntFreeUp(&(cast_handle->midi_to_dsp.aural_filter_gain_qnt_hdl)) != OKAY)
-         return(NOT_OKAY);
-   } 
-
-   if (cast_handle->midi_to_dsp.aural_filter_a1_qnt_hdl != NULL)
-   {
-      if (qntFreeUp(&(cast_handle->midi_to_dsp.aural_filter_a1_qnt_hdl)) != OKAY)
-         return(NOT_OKAY);
-   } 
-
-   if (cast_handle->midi_to_dsp.aural_filter_a0_qnt_hdl != NULL)
-   {
-      if (qntFreeUp(&(cast_handle->midi_to_dsp.aural_filter_a0_qnt_hdl)) != OKAY)
-         return(NOT_OKAY);
-   } 
-   
-	/* Fixed Reverb Specific */
-   if (cast_handle->midi_to_dsp.room_size_qnt_hdl != NULL)
-   {
-      if (qntFreeUp(&(cast_handle->midi_to_dsp.room_size_qnt_hdl)) != OKAY)
-         return(NOT_OKAY);
-   } 
-
-   if (cast_handle->midi_to_dsp.damping_bandwidth_qnt_hdl != NULL)
-   {
-      if (qntFreeUp(&(cast_handle->midi_to_dsp.damping_bandwidth_qnt_hdl)) != OKAY)
-         return(NOT_OKAY);
-   } 
-
-   if (cast_handle->midi_to_dsp.rolloff_bandwidth_qnt_hdl != NULL)
-   {
-      if (qntFreeUp(&(cast_handle->midi_to_dsp.rolloff_bandwidth_qnt_hdl)) != OKAY)
-         return(NOT_OKAY);
-   } 
-
-   if (cast_handle->midi_to_dsp.motion_rate_qnt_hdl != NULL)
-   {
-      if (qntFreeUp(&(cast_handle->midi_to_dsp.motion_rate_qnt_hdl)) != OKAY)
-         return(NOT_OKAY);
-   } 
-
-   if (cast_handle->midi_to_dsp.motion_depth_qnt_hdl != NULL)
-   {
-      if (qntFreeUp(&(cast_handle->midi_to_dsp.motion_depth_qnt_hdl)) != OKAY)
-         return(NOT_OKAY);
-   } 
-
-   if (cast_handle->midi_to_dsp.screen_lex_main_knob3_qnt_hdl != NULL)
-   {
-      if (qntFreeUp(&(cast_handle->midi_to_dsp.screen_lex_main_knob3_qnt_hdl)) != OKAY)
-         return(NOT_OKAY);
-   } 
-
-   if (cast_handle->midi_to_dsp.screen_lex_main_knob4_qnt_hdl != NULL)
-   {
-      if (qntFreeUp(&(cast_handle->midi_to_dsp.screen_lex_main_knob4_qnt_hdl)) != OKAY)
-         return(NOT_OKAY);
-   } 
-
-	/* Fixed Optimizer Specific */
-   if (cast_handle->midi_to_dsp.release_time_beta_qnt_hdl != NULL)
-   {
-      if (qntFreeUp(&(cast_handle->midi_to_dsp.release_time_beta_qnt_hdl)) != OKAY)
-         return(NOT_OKAY);
-   } 
-
-   if (cast_handle->midi_to_dsp.screen_opt_main_knob3_qnt_hdl != NULL)
-   {
-      if (qntFreeUp(&(cast_handle->midi_to_dsp.screen_opt_main_knob3_qnt_hdl)) != OKAY)
-         return(NOT_OKAY);
-   } 
-
-	/* Fixed Widener Specific */
-   if (cast_handle->midi_to_dsp.dispersion_delay_qnt_hdl != NULL)
-   {
-      if (qntFreeUp(&(cast_handle->midi_to_dsp.dispersion_delay_qnt_hdl)) != OKAY)
-         return(NOT_OKAY);
-   } 
-
-   if (cast_handle->midi_to_dsp.wid_filter_gain_qnt_hdl != NULL)
-   {
-      if (qntFreeUp(&(cast_handle->midi_to_dsp.wid_filter_gain_qnt_hdl)) != OKAY)
-         return(NOT_OKAY);
-   } 
-
-   if (cast_handle->midi_to_dsp.wid_filter_a1_qnt_hdl != NULL)
-   {
-      if (qntFreeUp(&(cast_handle->midi_to_dsp.wid_filter_a1_qnt_hdl)) != OKAY)
-         return(NOT_OKAY);
-   } 
-
-   if (cast_handle->midi_to_dsp.wid_filter_a0_qnt_hdl != NULL)
-   {
-      if (qntFreeUp(&(cast_handle->midi_to_dsp.wid_filter_a0_qnt_hdl)) != OKAY)
-         return(NOT_OKAY);
-   }
-
-	/* Delay specific */
-   if (cast_handle->midi_to_dsp.dly_qnt_hdl != NULL)
-   {
-      if (qntFreeUp(&(cast_handle->midi_to_dsp.dly_qnt_hdl)) != OKAY)
-         return(NOT_OKAY);
-   }
-
-	/* Free all the other qnt handles */
-   if (cast_handle->real_to_midi_qnt_hdl != NULL)
-   {
-      if (qntFreeUp(&(cast_handle->real_to_midi_qnt_hdl)) != OKAY)
-         return(NOT_OKAY);
-   }
+	/* Release the qnt handles, which are shared with other instances */
+	if (dfxp_FreeAllQnts(hp_dfxp) != OKAY)
+		return(NOT_OKAY);
 
-   if (cast_handle->midi_to_real_qnt_hdl != NULL)
-   {
-      if (qntFreeUp(&(cast_handle->midi_to_real_qnt_hdl)) != OKAY)
-         return(NOT_OKAY);
-   }
+	/* Stop the surround workers before the com handles they process are freed */
+	if (dfxp_SurroundFree(hp_dfxp) != OKAY)
+		return(NOT_OKAY);
 
 	/* Free the com handles */
 	if (cast_handle->com_hdl_front != NULL)
@@ -299,5 +156,17 @@ int dfxp_FreeAll(PT_HANDLE *hp_dfxp)
 			return(NOT_OKAY);
 	}
 
+	/* Free the internal sample buffers */
+	if (dfxp_FreeSampleBuffers(hp_dfxp) != OKAY)
+		return(NOT_OKAY);
+
+	/* Free the parameter queue */
+	if (dfxp_ParamFree(hp_dfxp) != OKAY)
+		return(NOT_OKAY);
+
+	/* Stop the session writer, saves any values not yet written to the registry */
+	if (dfxp_SessionStoreFree(hp_dfxp) != OKAY)
+		return(NOT_OKAY);
+
 	return(OKAY);
 }
\ No newline at end of file
@@ -24,6 +24,9 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <stdio.h>
 #include <stdlib.h>
 
+#include <atomic>
+#include <new>
+
 #include "u_dfxp.h" 
 
 #include "dfxp.h"
@@ -31,14 +34,103 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "DfxSdk.h"
 #include "mth.h"
 
+/*
+ * Session store.
+ * Session values used to be read from the registry every time they were needed, which included the
+ * audio thread on every buffer (bypass settings, the EQ poll, parameter communication). They are now
+ * read from the registry once when the store is created and kept in memory. Every value has a fixed
+ * slot, indexed by its DFXP_SESSION_KEY_ number, so reads never search, lock or make a system call.
+ * Writes update the memory copy and are written to the registry by a background thread.
+ *
+ * Each slot keeps two copies of its value. A write fills the copy that is not current and then
+ * moves the version on, so a reader always copies a value that is not being written and only reads
+ * again if two writes finished while it was copying. Writers to the same slot take turns on the
+ * slot's write claim, the readers never wait on it.
+ */
+#define DFXP_SESSION_KEY_LEN         64
+#define DFXP_SESSION_PERSIST_MSECS   100
+
+/* How a value is written back to the registry, matches the old direct registry writes */
+#define DFXP_SESSION_FORMAT_INTEGER  0  /* "%d" */
+#define DFXP_SESSION_FORMAT_REAL     1  /* "%.2f" */
+
+struct dfxpSessionValueType {
+	int i_is_long;   /* Stored string is a valid long, integer reads use the default otherwise */
+	int i_value;
+	int i_is_set;    /* Stored string is not empty, real reads use the default otherwise */
+	float r_value;
+	int i_format;
+};
+
+struct dfxpSessionEntryType {
+	wchar_t wcp_key_name[DFXP_SESSION_KEY_LEN]; /* Relative to the LASTUSED folder, ex. L"byAll" or L"EQ\\Band3" */
+	struct dfxpSessionValueType values[2];      /* values[version & 1] is the current value */
+	std::atomic<unsigned long> version;         /* Moved on once the other copy holds the new value */
+	std::atomic<int> write_claim;               /* Set while a writer fills the other copy */
+	std::atomic<int> i_dirty;                   /* Changed since it was last written to the registry */
+};
+
+struct dfxpSessionStoreType {
+	struct dfxpSessionEntryType entries[DFXP_SESSION_NUM_KEYS];
+	std::atomic<unsigned long> generation; /* Incremented on every value change */
+	HANDLE h_stop_event;
+	HANDLE h_writer_thread;
+};
+
+/* Registry names of the session keys ahead of the EQ keys, in DFXP_SESSION_KEY_ order */
+static wchar_t *dfxp_session_key_names[DFXP_SESSION_KEY_EQ_ON] = {
+	DFXP_REGISTRY_VALUE_FIDELITY_WIDE,
+	DFXP_REGISTRY_VALUE_AMBIENCE_WIDE,
+	DFXP_REGISTRY_VALUE_DYNAMIC_BOOST_WIDE,
+	DFXP_REGISTRY_VALUE_SURROUND_WIDE,
+	DFXP_REGISTRY_VALUE_BASS_BOOST_WIDE,
+	DFXP_REGISTRY_BYPASS_ALL_WIDE,
+	DFXP_REGISTRY_BYPASS_FIDELITY_WIDE,
+	DFXP_REGISTRY_BYPASS_AMBIENCE_WIDE,
+	DFXP_REGISTRY_BYPASS_DYNAMIC_BOOST_WIDE,
+	DFXP_REGISTRY_BYPASS_SURROUND_WIDE,
+	DFXP_REGISTRY_BYPASS_BASS_BOOST_WIDE,
+	DFXP_REGISTRY_BYPASS_HEADPHONE_WIDE,
+	DFXP_REGISTRY_REMIX_BYPASS_ALL_WIDE,
+	DFXP_REGISTRY_MODE_MUSIC_MODE_WIDE,
+	DFXP_REGISTRY_TEMPORARY_BYPASS_ALL_WIDE,
+	DFXP_REGISTRY_DFX_TUNED_TRACK_PLAYING_WIDE,
+	DFXP_REGISTRY_LONGEST_BUFFER_MSECS_WIDE
+};
+
+static DWORD WINAPI dfxp_SessionWriterThread(LPVOID lpParam);
+static int dfxp_SessionStoreWrite(struct dfxpHdlType *, int, wchar_t *, int);
+
+/*
+ * FUNCTION: dfxp_SessionKeyName() 
+ * DESCRIPTION:
+ *   Passes back the registry name of a DFXP_SESSION_KEY_ key, relative to the LASTUSED folder.
+ */
+static int dfxp_SessionKeyName(int i_key, wchar_t *wcp_key_name)
+{
+	if ((i_key >= 0) && (i_key < DFXP_SESSION_KEY_EQ_ON))
+		swprintf(wcp_key_name, L"%s", dfxp_session_key_names[i_key]);
+	else if (i_key == DFXP_SESSION_KEY_EQ_ON)
+		swprintf(wcp_key_name, L"%s\\%s", DFXP_REGISTRY_EQ_FOLDER_NAME_WIDE, DFXP_REGISTRY_EQ_ON_WIDE);
+	else if ((i_key >= DFXP_SESSION_KEY_EQ_BAND_1) && (i_key < DFXP_SESSION_NUM_KEYS))
+		swprintf(wcp_key_name, L"%s\\%s%d", DFXP_REGISTRY_EQ_FOLDER_NAME_WIDE, DFXP_REGISTRY_EQ_BAND_NAME_WIDE,
+					i_key - DFXP_SESSION_KEY_EQ_BAND_1 + 1);
+	else
+		return(NOT_OKAY);
+
+	return(OKAY);
+}
+
 /*
  * FUNCTION: dfxp_SessionWriteIntegerValue() 
  * DESCRIPTION:
  *   Saves the passed integer session value in the registry.
+ *   Once the session store is up the registry write is done by its writer thread.
  */
-int dfxp_SessionWriteIntegerValue(PT_HANDLE *hp_dfxp, wchar_t *wcp_key_name, int i_value)
+int dfxp_SessionWriteIntegerValue(PT_HANDLE *hp_dfxp, int i_key, int i_value)
 {
 	struct dfxpHdlType *cast_handle;
+	wchar_t wcp_key_name[DFXP_SESSION_KEY_LEN];
 	wchar_t wcp_key_value[DFXP_REGISTRY_BUFFER_LENGTH];
 	wchar_t wcp_full_key_path[PT_MAX_PATH_STRLEN];
 
@@ -56,6 +148,13 @@ int dfxp_SessionWriteIntegerValue(PT_HANDLE *hp_dfxp, wchar_t *wcp_key_name, int
 	if (cast_handle->vendor_code == 0)
       return(OKAY);
 
+	/* Persisted by the session store writer thread */
+	if (cast_handle->session_store != NULL)
+		return( dfxp_SessionStoreWriteInteger(hp_dfxp, i_key, i_value) );
+
+	if (dfxp_SessionKeyName(i_key, wcp_key_name) != OKAY)
+		return(NOT_OKAY);
+
 	swprintf(wcp_full_key_path, L"%s\\%s\\%d\\%d\\%s\\%s", 
 									DFXP_REGISTRY_TOP_WIDE, 
 									cast_handle->wcp_product_name, 
@@ -84,15 +183,16 @@ int dfxp_SessionWriteIntegerValue(PT_HANDLE *hp_dfxp, wchar_t *wcp_key_name, int
 /*
  * FUNCTION: dfxp_SessionReadIntegerValue() 
  * DESCRIPTION:
- *   Reads the session integer value from the registry.
+ *   Reads the session integer value from the registry, or from the session store once it is up.
  *
  *   If the last session info does not exist or if this is the first time
  *   run since installation, set to the default values.
  */
-int dfxp_SessionReadIntegerValue(PT_HANDLE *hp_dfxp, wchar_t *wcp_key_name, int i_default_value, int *ip_value)
+int dfxp_SessionReadIntegerValue(PT_HANDLE *hp_dfxp, int i_key, int i_default_value, int *ip_value)
 {
 	struct dfxpHdlType *cast_handle;
 
+	wchar_t wcp_key_name[DFXP_SESSION_KEY_LEN];
 	wchar_t wcp_key_value[DFXP_REGISTRY_BUFFER_LENGTH];
 	wchar_t wcp_full_key_path[PT_MAX_PATH_STRLEN];
 	int key_exists;
@@ -104,9 +204,6 @@ int dfxp_SessionReadIntegerValue(PT_HANDLE *hp_dfxp, wchar_t *wcp_key_name, int
 	if (cast_handle == NULL)
 		return(OKAY);
 
-	if (wcp_key_name == NULL)
-		return(NOT_OKAY);
-
 	/* If vendor code is 0, then just use the default value */
 	if (cast_handle->vendor_code == 0)
 	{
@@ -114,6 +211,13 @@ int dfxp_SessionReadIntegerValue(PT_HANDLE *hp_dfxp, wchar_t *wcp_key_name, int
       return(OKAY);
 	}
 
+	/* Memory copy, safe to call from the audio thread */
+	if (cast_handle->session_store != NULL)
+		return( dfxp_SessionStoreReadInteger(hp_dfxp, i_key, i_default_value, ip_value) );
+
+	if (dfxp_SessionKeyName(i_key, wcp_key_name) != OKAY)
+		return(NOT_OKAY);
+
 	/* Create the registry full path */
 	swprintf(wcp_full_key_path, L"%s\\%s\\%d\\%d\\%s\\%s", 
 									DFXP_REGISTRY_TOP_WIDE, 
@@ -149,10 +253,12 @@ int dfxp_SessionReadIntegerValue(PT_HANDLE *hp_dfxp, wchar_t *wcp_key_name, int
  * FUNCTION: dfxp_SessionWriteRealValue() 
  * DESCRIPTION:
  *   Saves the passed real session value in the registry.
+ *   Once the session store is up the registry write is done by its writer thread.
  */
-int dfxp_SessionWriteRealValue(PT_HANDLE *hp_dfxp, wchar_t *wcp_key_name, realtype r_value)
+int dfxp_SessionWriteRealValue(PT_HANDLE *hp_dfxp, int i_key, realtype r_value)
 {
 	struct dfxpHdlType *cast_handle;
+	wchar_t wcp_key_name[DFXP_SESSION_KEY_LEN];
 	wchar_t wcp_key_value[DFXP_REGISTRY_BUFFER_LENGTH];
 	wchar_t wcp_full_key_path[PT_MAX_PATH_STRLEN];
 
@@ -164,6 +270,13 @@ int dfxp_SessionWriteRealValue(PT_HANDLE *hp_dfxp, wchar_t *wcp_key_name, realty
 	if (cast_handle->vendor_code == 0)
       return(OKAY);
 
+	/* Persisted by the session store writer thread */
+	if (cast_handle->session_store != NULL)
+		return( dfxp_SessionStoreWriteReal(hp_dfxp, i_key, r_value) );
+
+	if (dfxp_SessionKeyName(i_key, wcp_key_name) != OKAY)
+		return(NOT_OKAY);
+
 	swprintf(wcp_full_key_path, L"%s\\%s\\%d\\%d\\%s\\%s", 
 									DFXP_REGISTRY_TOP_WIDE, 
 									cast_handle->wcp_product_name, 
@@ -183,15 +296,16 @@ int dfxp_SessionWriteRealValue(PT_HANDLE *hp_dfxp, wchar_t *wcp_key_name, realty
 /*
  * FUNCTION: dfxp_SessionReadRealValue() 
  * DESCRIPTION:
- *   Reads the session real value from the registry.
+ *   Reads the session real value from the registry, or from the session store once it is up.
  *
  *   If the last session info does not exist or if this is the first time
  *   run since installation, set to the default values.
  */
-int dfxp_SessionReadRealValue(PT_HANDLE *hp_dfxp, wchar_t *wcp_key_name, realtype r_default_value, realtype *rp_value)
+int dfxp_SessionReadRealValue(PT_HANDLE *hp_dfxp, int i_key, realtype r_default_value, realtype *rp_value)
 {
 	struct dfxpHdlType *cast_handle;
 
+	wchar_t wcp_key_name[DFXP_SESSION_KEY_LEN];
 	wchar_t wcp_key_value[DFXP_REGISTRY_BUFFER_LENGTH];
 	wchar_t wcp_full_key_path[PT_MAX_PATH_STRLEN];
 	int key_exists;
@@ -202,9 +316,6 @@ int dfxp_SessionReadRealValue(PT_HANDLE *hp_dfxp, wchar_t *wcp_key_name, realtyp
 	if (cast_handle == NULL)
 		return(OKAY);
 
-	if (wcp_key_name == NULL)
-		return(NOT_OKAY);
-
 	/* If vendor code is 0, then just use the default value */
 	if (cast_handle->vendor_code == 0)
 	{
@@ -212,6 +323,13 @@ int dfxp_SessionReadRealValue(PT_HANDLE *hp_dfxp, wchar_t *wcp_key_name, realtyp
       return(OKAY);
 	}
 
+	/* Memory copy, safe to call from the audio thread */
+	if (cast_handle->session_store != NULL)
+		return( dfxp_SessionStoreReadReal(hp_dfxp, i_key, r_default_value, rp_value) );
+
+	if (dfxp_SessionKeyName(i_key, wcp_key_name) != OKAY)
+		return(NOT_OKAY);
+
 	/* Create the registry full path */
 	swprintf(wcp_full_key_path, L"%s\\%s\\%d\\%d\\%s\\%s", 
 									DFXP_REGISTRY_TOP_WIDE, 
@@ -242,3 +360,421 @@ int dfxp_SessionReadRealValue(PT_HANDLE *hp_dfxp, wchar_t *wcp_key_name, realtyp
 }
 
 
+
+/*
+ * FUNCTION: dfxp_SessionStoreFullKeyPath() 
+ * DESCRIPTION:
+ *   Creates the full registry path for a session store key.
+ */
+static void dfxp_SessionStoreFullKeyPath(struct dfxpHdlType *cast_handle, wchar_t *wcp_key_name, wchar_t *wcp_full_key_path)
+{
+	swprintf(wcp_full_key_path, L"%s\\%s\\%d\\%d\\%s\\%s", 
+									DFXP_REGISTRY_TOP_WIDE, 
+									cast_handle->wcp_product_name, 
+									cast_handle->major_version,
+									cast_handle->vendor_code,
+		                     DFXP_REGISTRY_LASTUSED_WIDE, 
+									wcp_key_name);
+}
+
+/*
+ * FUNCTION: dfxp_SessionStoreParseValue() 
+ * DESCRIPTION:
+ *   Fills in a value from a registry string the same way the old direct reads interpreted it.
+ *   The format is left to the caller.
+ */
+static void dfxp_SessionStoreParseValue(wchar_t *wcp_key_value, int i_key_exists, struct dfxpSessionValueType *sp_value)
+{
+	int is_long = IS_FALSE;
+
+	sp_value->i_is_long = IS_FALSE;
+	sp_value->i_value = 0;
+	sp_value->i_is_set = IS_FALSE;
+	sp_value->r_value = 0.0f;
+
+	if (!i_key_exists)
+		return;
+
+	if (mthIsLong_Wide(wcp_key_value, &is_long) != OKAY)
+		is_long = IS_FALSE;
+
+	if (is_long)
+	{
+		sp_value->i_is_long = IS_TRUE;
+		sp_value->i_value = _wtoi(wcp_key_value);
+	}
+
+	if (wcslen(wcp_key_value) > 0)
+	{
+		sp_value->i_is_set = IS_TRUE;
+		sp_value->r_value = (float)_wtof(wcp_key_value);
+	}
+}
+
+/*
+ * FUNCTION: dfxp_SessionStoreGetValue() 
+ * DESCRIPTION:
+ *   Copies the current value of the entry. Never waits on a writer, the copy is only taken again
+ *   if two writes finished while it was being made and the copy read was written over.
+ */
+static void dfxp_SessionStoreGetValue(struct dfxpSessionEntryType *sp_entry, struct dfxpSessionValueType *sp_value)
+{
+	unsigned long ul_version;
+
+	do
+	{
+		ul_version = sp_entry->version.load(std::memory_order_acquire);
+		*sp_value = sp_entry->values[ul_version & 1];
+		std::atomic_thread_fence(std::memory_order_acquire);
+	} while (sp_entry->version.load(std::memory_order_relaxed) - ul_version >= 2);
+}
+
+/*
+ * FUNCTION: dfxp_SessionStoreSetValue() 
+ * DESCRIPTION:
+ *   Publishes the passed value as the entry's current value, all of its fields at once.
+ *   Passes back IS_TRUE in ip_changed if anything differs from the previous value.
+ */
+static void dfxp_SessionStoreSetValue(struct dfxpSessionEntryType *sp_entry, struct dfxpSessionValueType *sp_value, int *ip_changed)
+{
+	struct dfxpSessionValueType *sp_current;
+	unsigned long ul_version;
+
+	/* Only another write to this key holds the claim, and only for the copy below */
+	while (sp_entry->write_claim.exchange(IS_TRUE, std::memory_order_acquire))
+		;
+
+	ul_version = sp_entry->version.load(std::memory_order_relaxed);
+	sp_current = &(sp_entry->values[ul_version & 1]);
+
+	*ip_changed = (sp_current->i_is_long != sp_value->i_is_long) || (sp_current->i_value != sp_value->i_value) ||
+					  (sp_current->i_is_set != sp_value->i_is_set) || (sp_current->r_value != sp_value->r_value) ||
+					  (sp_current->i_format != sp_value->i_format);
+
+	if (*ip_changed)
+	{
+		sp_entry->values[(ul_version + 1) & 1] = *sp_value;
+		sp_entry->version.store(ul_version + 1, std::memory_order_release);
+	}
+
+	sp_entry->write_claim.store(IS_FALSE, std::memory_order_release);
+}
+
+/*
+ * FUNCTION: dfxp_SessionStoreInit() 
+ * DESCRIPTION:
+ *   Creates the session store, reads every session key from the registry and starts the writer thread.
+ *   If the store can't be created the session functions keep using the registry directly.
+ */
+int dfxp_SessionStoreInit(PT_HANDLE *hp_dfxp)
+{
+	struct dfxpHdlType *cast_handle;
+	struct dfxpSessionStoreType *sp_store;
+	struct dfxpSessionEntryType *sp_entry;
+	wchar_t wcp_full_key_path[PT_MAX_PATH_STRLEN];
+	wchar_t wcp_key_value[DFXP_REGISTRY_BUFFER_LENGTH];
+	int key_exists;
+	int i;
+
+	cast_handle = (struct dfxpHdlType *)(hp_dfxp);
+
+	if (cast_handle == NULL)
+		return(OKAY);
+
+	if (cast_handle->session_store != NULL)
+		return(OKAY);
+
+	sp_store = new (std::nothrow) struct dfxpSessionStoreType;
+	if (sp_store == NULL)
+		return(OKAY);
+
+	for (i = 0; i < DFXP_SESSION_NUM_KEYS; i++)
+	{
+		sp_entry = &(sp_store->entries[i]);
+
+		dfxp_SessionKeyName(i, sp_entry->wcp_key_name);
+		dfxp_SessionStoreFullKeyPath(cast_handle, sp_entry->wcp_key_name, wcp_full_key_path);
+
+		if (regReadKey_Wide(REG_CURRENT_USER, wcp_full_key_path, &key_exists, wcp_key_value,
+		   (unsigned long)DFXP_REGISTRY_BUFFER_LENGTH) != OKAY)
+			key_exists = IS_FALSE;
+
+		dfxp_SessionStoreParseValue(wcp_key_value, key_exists, &(sp_entry->values[0]));
+		sp_entry->values[0].i_format = (i >= DFXP_SESSION_KEY_EQ_BAND_1) ? DFXP_SESSION_FORMAT_REAL : DFXP_SESSION_FORMAT_INTEGER;
+		sp_entry->values[1] = sp_entry->values[0];
+
+		sp_entry->version.store(0);
+		sp_entry->write_claim.store(IS_FALSE);
+		sp_entry->i_dirty.store(IS_FALSE);
+	}
+	sp_store->generation.store(1);
+	sp_store->h_stop_event = NULL;
+	sp_store->h_writer_thread = NULL;
+
+	/* Filled in before it is published, the processing only ever sees a complete store */
+	cast_handle->session_store = sp_store;
+
+	sp_store->h_stop_event = CreateEvent(NULL, TRUE, FALSE, NULL);
+	if (sp_store->h_stop_event != NULL)
+		sp_store->h_writer_thread = CreateThread(NULL, 0, dfxp_SessionWriterThread, (LPVOID)cast_handle, 0, NULL);
+
+	/* Without a writer nothing would be saved, fall back to the registry */
+	if (sp_store->h_writer_thread == NULL)
+		return( dfxp_SessionStoreFree(hp_dfxp) );
+
+	SetThreadPriority(sp_store->h_writer_thread, THREAD_PRIORITY_BELOW_NORMAL);
+
+	return(OKAY);
+}
+
+/*
+ * FUNCTION: dfxp_SessionStoreFree() 
+ * DESCRIPTION:
+ *   Stops the writer thread, writes any remaining changes to the registry and frees the store.
+ */
+int dfxp_SessionStoreFree(PT_HANDLE *hp_dfxp)
+{
+	struct dfxpHdlType *cast_handle;
+	struct dfxpSessionStoreType *sp_store;
+
+	cast_handle = (struct dfxpHdlType *)(hp_dfxp);
+
+	if (cast_handle == NULL)
+		return(OKAY);
+
+	sp_store = cast_handle->session_store;
+	if (sp_store == NULL)
+		return(OKAY);
+
+	if (sp_store->h_writer_thread != NULL)
+	{
+		SetEvent(sp_store->h_stop_event);
+		WaitForSingleObject(sp_store->h_writer_thread, INFINITE);
+		CloseHandle(sp_store->h_writer_thread);
+	}
+	if (sp_store->h_stop_event != NULL)
+		CloseHandle(sp_store->h_stop_event);
+
+	dfxp_SessionStoreFlush(hp_dfxp);
+
+	cast_handle->session_store = NULL;
+
+	delete sp_store;
+
+	return(OKAY);
+}
+
+/*
+ * FUNCTION: dfxp_SessionStoreFlush() 
+ * DESCRIPTION:
+ *   Writes all the changed entries to the registry. Called from the writer thread and when freeing the store.
+ */
+int dfxp_SessionStoreFlush(PT_HANDLE *hp_dfxp)
+{
+	struct dfxpHdlType *cast_handle;
+	struct dfxpSessionStoreType *sp_store;
+	struct dfxpSessionEntryType *sp_entry;
+	struct dfxpSessionValueType value;
+	wchar_t wcp_full_key_path[PT_MAX_PATH_STRLEN];
+	wchar_t wcp_key_value[DFXP_REGISTRY_BUFFER_LENGTH];
+	int i;
+	int status = OKAY;
+
+	cast_handle = (struct dfxpHdlType *)(hp_dfxp);
+
+	if (cast_handle == NULL)
+		return(OKAY);
+
+	sp_store = cast_handle->session_store;
+	if (sp_store == NULL)
+		return(OKAY);
+
+	for (i = 0; i < DFXP_SESSION_NUM_KEYS; i++)
+	{
+		sp_entry = &(sp_store->entries[i]);
+
+		/* Cleared before reading the value, a change made during the write is picked up next time */
+		if (!sp_entry->i_dirty.exchange(IS_FALSE))
+			continue;
+
+		dfxp_SessionStoreGetValue(sp_entry, &value);
+
+		if (value.i_format == DFXP_SESSION_FORMAT_REAL)
+			swprintf(wcp_key_value, L"%.2f", value.r_value);
+		else
+			swprintf(wcp_key_value, L"%d", value.i_value);
+
+		dfxp_SessionStoreFullKeyPath(cast_handle, sp_entry->wcp_key_name, wcp_full_key_path);
+
+		if (regCreateKey_Wide(REG_CURRENT_USER, wcp_full_key_path, wcp_key_value) != OKAY)
+			status = NOT_OKAY;
+	}
+
+	return(status);
+}
+
+/*
+ * FUNCTION: dfxp_SessionWriterThread() 
+ * DESCRIPTION:
+ *   Writes changed session values to the registry a few times a second until the stop event is set.
+ */
+static DWORD WINAPI dfxp_SessionWriterThread(LPVOID lpParam)
+{
+	struct dfxpHdlType *cast_handle = (struct dfxpHdlType *)lpParam;
+
+	while (WaitForSingleObject(cast_handle->session_store->h_stop_event, DFXP_SESSION_PERSIST_MSECS) == WAIT_TIMEOUT)
+		dfxp_SessionStoreFlush((PT_HANDLE *)cast_handle);
+
+	return(0);
+}
+
+/*
+ * FUNCTION: dfxp_SessionStoreWrite() 
+ * DESCRIPTION:
+ *   Stores the passed registry string in memory and marks it to be written out by the writer thread.
+ *   Safe to call from the audio thread.
+ */
+static int dfxp_SessionStoreWrite(struct dfxpHdlType *cast_handle, int i_key, wchar_t *wcp_key_value, int i_format)
+{
+	struct dfxpSessionEntryType *sp_entry;
+	struct dfxpSessionValueType value;
+	int changed;
+
+	if ((i_key < 0) || (i_key >= DFXP_SESSION_NUM_KEYS))
+		return(NOT_OKAY);
+
+	sp_entry = &(cast_handle->session_store->entries[i_key]);
+
+	dfxp_SessionStoreParseValue(wcp_key_value, IS_TRUE, &value);
+	value.i_format = i_format;
+
+	dfxp_SessionStoreSetValue(sp_entry, &value, &changed);
+
+	if (changed)
+	{
+		sp_entry->i_dirty.store(IS_TRUE);
+		cast_handle->session_store->generation.fetch_add(1);
+	}
+
+	return(OKAY);
+}
+
+/*
+ * FUNCTION: dfxp_SessionStoreWriteInteger() 
+ * DESCRIPTION:
+ *   Session store version of an integer registry write.
+ */
+int dfxp_SessionStoreWriteInteger(PT_HANDLE *hp_dfxp, int i_key, int i_value)
+{
+	struct dfxpHdlType *cast_handle;
+	wchar_t wcp_key_value[DFXP_REGISTRY_BUFFER_LENGTH];
+
+	cast_handle = (struct dfxpHdlType *)(hp_dfxp);
+
+	if ((cast_handle == NULL) || (cast_handle->session_store == NULL))
+		return(NOT_OKAY);
+
+	swprintf(wcp_key_value, L"%d", i_value);
+
+	return( dfxp_SessionStoreWrite(cast_handle, i_key, wcp_key_value, DFXP_SESSION_FORMAT_INTEGER) );
+}
+
+/*
+ * FUNCTION: dfxp_SessionStoreWriteReal() 
+ * DESCRIPTION:
+ *   Session store version of a real registry write, the value is rounded to the 2 decimals stored in the registry.
+ */
+int dfxp_SessionStoreWriteReal(PT_HANDLE *hp_dfxp, int i_key, realtype r_value)
+{
+	struct dfxpHdlType *cast_handle;
+	wchar_t wcp_key_value[DFXP_REGISTRY_BUFFER_LENGTH];
+
+	cast_handle = (struct dfxpHdlType *)(hp_dfxp);
+
+	if ((cast_handle == NULL) || (cast_handle->session_store == NULL))
+		return(NOT_OKAY);
+
+	swprintf(wcp_key_value, L"%.2f", r_value);
+
+	return( dfxp_SessionStoreWrite(cast_handle, i_key, wcp_key_value, DFXP_SESSION_FORMAT_REAL) );
+}
+
+/*
+ * FUNCTION: dfxp_SessionStoreReadInteger() 
+ * DESCRIPTION:
+ *   Session store version of an integer registry read, uses the default if the value is missing or not a long.
+ */
+int dfxp_SessionStoreReadInteger(PT_HANDLE *hp_dfxp, int i_key, int i_default_value, int *ip_value)
+{
+	struct dfxpHdlType *cast_handle;
+	struct dfxpSessionValueType value;
+
+	cast_handle = (struct dfxpHdlType *)(hp_dfxp);
+
+	*ip_value = i_default_value;
+
+	if ((cast_handle == NULL) || (cast_handle->session_store == NULL))
+		return(NOT_OKAY);
+
+	if ((i_key < 0) || (i_key >= DFXP_SESSION_NUM_KEYS))
+		return(NOT_OKAY);
+
+	dfxp_SessionStoreGetValue(&(cast_handle->session_store->entries[i_key]), &value);
+
+	if (value.i_is_long)
+		*ip_value = value.i_value;
+
+	return(OKAY);
+}
+
+/*
+ * FUNCTION: dfxp_SessionStoreReadReal() 
+ * DESCRIPTION:
+ *   Session store version of a real registry read, uses the default if the value is missing or empty.
+ */
+int dfxp_SessionStoreReadReal(PT_HANDLE *hp_dfxp, int i_key, realtype r_default_value, realtype *rp_value)
+{
+	struct dfxpHdlType *cast_handle;
+	struct dfxpSessionValueType value;
+
+	cast_handle = (struct dfxpHdlType *)(hp_dfxp);
+
+	*rp_value = r_default_value;
+
+	if ((cast_handle == NULL) || (cast_handle->session_store == NULL))
+		return(NOT_OKAY);
+
+	if ((i_key < 0) || (i_key >= DFXP_SESSION_NUM_KEYS))
+		return(NOT_OKAY);
+
+	dfxp_SessionStoreGetValue(&(cast_handle->session_store->entries[i_key]), &value);
+
+	if (value.i_is_set)
+		*rp_value = (realtype)value.r_value;
+
+	return(OKAY);
+}
+
+/*
+ * FUNCTION: dfxpGetSessionGeneration() 
+ * DESCRIPTION:
+ *   Passes back a count that changes every time a session value changes, so a caller polling the settings
+ *   can skip comparing them when nothing has been set. Passes back 0 when there is no session store, in
+ *   which case the settings must always be compared.
+ */
+int dfxpGetSessionGeneration(PT_HANDLE *hp_dfxp, unsigned long *ulp_generation)
+{
+	struct dfxpHdlType *cast_handle;
+
+	cast_handle = (struct dfxpHdlType *)(hp_dfxp);
+
+	*ulp_generation = 0;
+
+	if (cast_handle == NULL)
+		return(OKAY);
+
+	if (cast_handle->session_store != NULL)
+		*ulp_generation = cast_handle->session_store->generation.load();
+
+	return(OKAY);
+}
@@ -80,7 +80,6 @@ int dfxp_SetKnobValue_MIDI(PT_HANDLE *hp_dfxp, int i_knob_type, int i_midi_value
 	if (cast_handle == NULL)
 		return(OKAY);
 
-	realtype r_eq_setting_normalized;
 	realtype r_eq_setting_db;
 
    if (!(cast_handle->fully_initialized))
@@ -90,61 +89,103 @@ int dfxp_SetKnobValue_MIDI(PT_HANDLE *hp_dfxp, int i_knob_type, int i_midi_value
 	if ((i_midi_value < MIDI_MIN_VALUE) || (i_midi_value > MIDI_MAX_VALUE))
 		return(NOT_OKAY);
 
+	if (dfxp_SessionWriteKnobValue_MIDI(hp_dfxp, i_knob_type, i_midi_value) != OKAY)
+		return(NOT_OKAY);
+
+	/* Flag the knob for dfxpCommunicateChanged() */
+	if (dfxp_CommunicateSetChanged(hp_dfxp, dfxp_CommunicateKnobFlags(i_knob_type)) != OKAY)
+		return(NOT_OKAY);
+
+	if (dfxp_CommunicateKnob(hp_dfxp, i_knob_type) != OKAY)
+		return(NOT_OKAY);
+
+	/* 
+	 * Move the EQ setting of band 1 to match the new HyperBass setting. 
+	 * NOTE: Make sure not to do this if this call came as a result of a change to EQ band1 trying to move the
+	 *       the HyperBass slider to match the EQ.  Otherwise, we will end up in an endless loop.
+	 */
+	if ((i_knob_type == DFX_UI_KNOB_BASS_BOOST) && (!b_from_eq_change))
+	{
+		if (dfxp_CalcBassBoostEqBand1(hp_dfxp, i_midi_value, &r_eq_setting_db) != OKAY)
+			return(NOT_OKAY);
+
+		if (dfxpEqSetBandBoostCut(hp_dfxp, DFXP_STORAGE_TYPE_ALL, 1, r_eq_setting_db) != OKAY)
+			return(NOT_OKAY);
+	}
+
+	return(OKAY);
+}
+
+/*
+ * FUNCTION: dfxp_SessionWriteKnobValue_MIDI() 
+ * DESCRIPTION:
+ *   Stores the passed knob value (in MIDI representation) in the session, without sending it on to
+ *   the processing. The knob is not flagged as changed either: the queued setter leaves it to the
+ *   ramp the drain starts, a flag set before the push would let dfxpCommunicateChanged() send the new
+ *   value unramped. dfxp_SetKnobValue_MIDI() flags and sends it itself.
+ */
+int dfxp_SessionWriteKnobValue_MIDI(PT_HANDLE *hp_dfxp, int i_knob_type, int i_midi_value)
+{
+	struct dfxpHdlType *cast_handle;
+
+	cast_handle = (struct dfxpHdlType *)(hp_dfxp);
+
+	if (cast_handle == NULL)
+		return(OKAY);
+
 	/* Take care of the specific knobs */
    if (i_knob_type == DFX_UI_KNOB_FIDELITY)
 	{
-		if (dfxp_SessionWriteIntegerValue(hp_dfxp, DFXP_REGISTRY_VALUE_FIDELITY_WIDE, i_midi_value) != OKAY)
+		if (dfxp_SessionWriteIntegerValue(hp_dfxp, DFXP_SESSION_KEY_VALUE_FIDELITY, i_midi_value) != OKAY)
 			return(NOT_OKAY);
-      if (dfxp_CommunicateFidelity(hp_dfxp) != OKAY)
-         return(NOT_OKAY);
 	}
 	else if (i_knob_type == DFX_UI_KNOB_AMBIENCE)
 	{   
-		if (dfxp_SessionWriteIntegerValue(hp_dfxp, DFXP_REGISTRY_VALUE_AMBIENCE_WIDE, i_midi_value) != OKAY)
+		if (dfxp_SessionWriteIntegerValue(hp_dfxp, DFXP_SESSION_KEY_VALUE_AMBIENCE, i_midi_value) != OKAY)
 			return(NOT_OKAY);
-      if (dfxp_CommunicateAmbience(hp_dfxp) != OKAY)
-         return(NOT_OKAY);
 	}
 	else if (i_knob_type == DFX_UI_KNOB_DYNAMIC_BOOST)
 	{
-		if (dfxp_SessionWriteIntegerValue(hp_dfxp, DFXP_REGISTRY_VALUE_DYNAMIC_BOOST_WIDE, i_midi_value) != OKAY)
+		if (dfxp_SessionWriteIntegerValue(hp_dfxp, DFXP_SESSION_KEY_VALUE_DYNAMIC_BOOST, i_midi_value) != OKAY)
 			return(NOT_OKAY);
-      if (dfxp_CommunicateDynamicBoost(hp_dfxp) != OKAY)
-         return(NOT_OKAY);
 	}
 	else if (i_knob_type == DFX_UI_KNOB_SURROUND)
 	{
-		if (dfxp_SessionWriteIntegerValue(hp_dfxp, DFXP_REGISTRY_VALUE_SURROUND_WIDE, i_midi_value) != OKAY)
+		if (dfxp_SessionWriteIntegerValue(hp_dfxp, DFXP_SESSION_KEY_VALUE_SURROUND, i_midi_value) != OKAY)
 			return(NOT_OKAY);
-      if (dfxp_CommunicateSpaciousness(hp_dfxp) != OKAY)
-         return(NOT_OKAY);
 	}
 	else if (i_knob_type == DFX_UI_KNOB_BASS_BOOST)
 	{
-		if (dfxp_SessionWriteIntegerValue(hp_dfxp, DFXP_REGISTRY_VALUE_BASS_BOOST_WIDE, i_midi_value) != OKAY)
+		if (dfxp_SessionWriteIntegerValue(hp_dfxp, DFXP_SESSION_KEY_VALUE_BASS_BOOST, i_midi_value) != OKAY)
 			return(NOT_OKAY);
-      if (dfxp_CommunicateBassBoost(hp_dfxp) != OKAY)
-         return(NOT_OKAY);
-
-		/* 
-		 * Move the EQ setting of band 1 to match the new HyperBass setting. 
-		 * NOTE: Make sure not to do this if this call came as a result of a change to EQ band1 trying to move the
-		 *       the HyperBass slider to match the EQ.  Otherwise, we will end up in an endless loop.
-		 */
-		if (!b_from_eq_change)
-		{
-			/* Convert the midi setting to a real value between 0.0 and 1.0 */
-			if (qntIToRCalc(cast_handle->midi_to_real_qnt_hdl, i_midi_value, &r_eq_setting_normalized) != OKAY)
-				return(NOT_OKAY);
-
-			/* Convert normalized value to dB (maxed out at 10) */
-			r_eq_setting_db = r_eq_setting_normalized * (realtype)10.0;
-
-			if (dfxpEqSetBandBoostCut(hp_dfxp, DFXP_STORAGE_TYPE_ALL, 1, r_eq_setting_db) != OKAY)
-				return(NOT_OKAY);
-		}
 	}
-	
+
+	return(OKAY);
+}
+
+/*
+ * FUNCTION: dfxp_CalcBassBoostEqBand1() 
+ * DESCRIPTION:
+ *   Calculates the EQ band 1 boost in dB that matches the passed HyperBass knob value (in MIDI representation).
+ */
+int dfxp_CalcBassBoostEqBand1(PT_HANDLE *hp_dfxp, int i_midi_value, realtype *rp_eq_setting_db)
+{
+	struct dfxpHdlType *cast_handle;
+
+	cast_handle = (struct dfxpHdlType *)(hp_dfxp);
+
+	if (cast_handle == NULL)
+		return(OKAY);
+
+	realtype r_eq_setting_normalized;
+
+	/* Convert the midi setting to a real value between 0.0 and 1.0 */
+	if (qntIToRCalc(cast_handle->midi_to_real_qnt_hdl, i_midi_value, &r_eq_setting_normalized) != OKAY)
+		return(NOT_OKAY);
+
+	/* Convert normalized value to dB (maxed out at 10) */
+	*rp_eq_setting_db = r_eq_setting_normalized * (realtype)10.0;
+
 	return(OKAY);
 }
 
@@ -165,71 +206,81 @@ int dfxpSetButtonValue(PT_HANDLE *hp_dfxp, int i_button_type, int i_value)
    if (!(cast_handle->fully_initialized))
 		return(NOT_OKAY);
 
+	if (dfxp_SessionWriteButtonValue(hp_dfxp, i_button_type, i_value) != OKAY)
+		return(NOT_OKAY);
+
+	if (dfxp_CommunicateButton(hp_dfxp, i_button_type) != OKAY)
+		return(NOT_OKAY);
+
+	return(OKAY);
+}
+
+/*
+ * FUNCTION: dfxp_SessionWriteButtonValue()
+ * DESCRIPTION:
+ *   Stores the passed button value in the session, without sending it on to the processing.
+ *   dfxp_CommunicateButton() does that part.
+ */
+int dfxp_SessionWriteButtonValue(PT_HANDLE *hp_dfxp, int i_button_type, int i_value)
+{
+	struct dfxpHdlType *cast_handle;
+
+	cast_handle = (struct dfxpHdlType *)(hp_dfxp);
+
+	if (cast_handle == NULL)
+		return(OKAY);
+
 	/* Take care of the non-bypass type buttons */
 	if (i_button_type == DFX_UI_BUTTON_MUSIC_MODE)
 	{
-		if (dfxp_SessionWriteIntegerValue(hp_dfxp, DFXP_REGISTRY_MODE_MUSIC_MODE_WIDE, i_value) != OKAY)
+		if (dfxp_SessionWriteIntegerValue(hp_dfxp, DFXP_SESSION_KEY_MODE_MUSIC_MODE, i_value) != OKAY)
 			return(NOT_OKAY);
-      if (dfxp_CommunicateMusicMode(hp_dfxp) != OKAY)
-         return(NOT_OKAY);
 	}
 	else if (i_button_type == DFX_UI_BUTTON_BYPASS)
 	{
-      if (dfxp_SessionWriteIntegerValue(hp_dfxp, DFXP_REGISTRY_BYPASS_ALL_WIDE, i_value) != OKAY)
+      if (dfxp_SessionWriteIntegerValue(hp_dfxp, DFXP_SESSION_KEY_BYPASS_ALL, i_value) != OKAY)
 	      return(NOT_OKAY);
-		if (dfxp_CommunicateBypassSettings(hp_dfxp) != OKAY)
-			return(NOT_OKAY);
 	}
 	else if (i_button_type == DFX_UI_BUTTON_FIDELITY)
 	{
-	   if (dfxp_SessionWriteIntegerValue(hp_dfxp, DFXP_REGISTRY_BYPASS_FIDELITY_WIDE, !(i_value)) != OKAY)
+	   if (dfxp_SessionWriteIntegerValue(hp_dfxp, DFXP_SESSION_KEY_BYPASS_FIDELITY, !(i_value)) != OKAY)
 	      return(NOT_OKAY);
-		if (dfxp_CommunicateBypassSettings(hp_dfxp) != OKAY)
-			return(NOT_OKAY);
 	}
 	else if (i_button_type == DFX_UI_BUTTON_AMBIENCE)
 	{   
-	   if (dfxp_SessionWriteIntegerValue(hp_dfxp, DFXP_REGISTRY_BYPASS_AMBIENCE_WIDE, !(i_value)) != OKAY)
+	   if (dfxp_SessionWriteIntegerValue(hp_dfxp, DFXP_SESSION_KEY_BYPASS_AMBIENCE, !(i_value)) != OKAY)
 	      return(NOT_OKAY);
-		if (dfxp_CommunicateBypassSettings(hp_dfxp) != OKAY)
-			return(NOT_OKAY);
 	}
 	else if (i_button_type == DFX_UI_BUTTON_DYNAMIC_BOOST)
 	{
-	   if (dfxp_SessionWriteIntegerValue(hp_dfxp, DFXP_REGISTRY_BYPASS_DYNAMIC_BOOST_WIDE, !(i_value)) != OKAY)
+	   if (dfxp_SessionWriteIntegerValue(hp_dfxp, DFXP_SESSION_KEY_BYPASS_DYNAMIC_BOOST, !(i_value)) != OKAY)
 	      return(NOT_OKAY);
-		if (dfxp_CommunicateBypassSettings(hp_dfxp) != OKAY)
-			return(NOT_OKAY);
 	}
 	else if (i_button_type == DFX_UI_BUTTON_SURROUND)
 	{
-	   if (dfxp_SessionWriteIntegerValue(hp_dfxp, DFXP_REGISTRY_BYPASS_SURROUND_WIDE, !(i_value)) != OKAY)
+	   if (dfxp_SessionWriteIntegerValue(hp_dfxp, DFXP_SESSION_KEY_BYPASS_SURROUND, !(i_value)) != OKAY)
 	      return(NOT_OKAY);
-		if (dfxp_CommunicateBypassSettings(hp_dfxp) != OKAY)
-			return(NOT_OKAY);
 	}
 	else if (i_button_type == DFX_UI_BUTTON_BASS_BOOST)
 	{
-	   if (dfxp_SessionWriteIntegerValue(hp_dfxp, DFXP_REGISTRY_BYPASS_BASS_BOOST_WIDE, !(i_value)) != OKAY)
+	   if (dfxp_SessionWriteIntegerValue(hp_dfxp, DFXP_SESSION_KEY_BYPASS_BASS_BOOST, !(i_value)) != OKAY)
 	      return(NOT_OKAY);
-		if (dfxp_CommunicateBypassSettings(hp_dfxp) != OKAY)
-			return(NOT_OKAY);
 	}
 	else if (i_button_type == DFX_UI_BUTTON_HEADPHONE)
 	{
-      if (dfxp_SessionWriteIntegerValue(hp_dfxp, DFXP_REGISTRY_BYPASS_HEADPHONE_WIDE, !(i_value)) != OKAY)
+      if (dfxp_SessionWriteIntegerValue(hp_dfxp, DFXP_SESSION_KEY_BYPASS_HEADPHONE, !(i_value)) != OKAY)
 	      return(NOT_OKAY);
-		if (dfxp_CommunicateBypassSettings(hp_dfxp) != OKAY)
-			return(NOT_OKAY);
 	}
 	else if (i_button_type == DFX_UI_BUTTON_REMIX_BYPASS)
 	{
-      if (dfxp_SessionWriteIntegerValue(hp_dfxp, DFXP_REGISTRY_REMIX_BYPASS_ALL_WIDE, i_value) != OKAY)
+      if (dfxp_SessionWriteIntegerValue(hp_dfxp, DFXP_SESSION_KEY_REMIX_BYPASS_ALL, i_value) != OKAY)
 	      return(NOT_OKAY);
-		if (dfxp_CommunicateBypassSettings(hp_dfxp) != OKAY)
-			return(NOT_OKAY);
 	}
 
+	/* Flag the button for dfxpCommunicateChanged() */
+	if (dfxp_CommunicateSetChanged(hp_dfxp, dfxp_CommunicateButtonFlags(i_button_type)) != OKAY)
+		return(NOT_OKAY);
+
 	return(OKAY);
 }
 
@@ -403,7 +454,7 @@ int dfxpSetTemporaryBypassAll(PT_HANDLE *hp_dfxp, int i_temporary_bypass_all)
 		return(NOT_OKAY);
 
 	/* THIS MIGHT FAIL FOR INTERNET EXPLORER */
-	if (dfxp_SessionWriteIntegerValue(hp_dfxp, DFXP_REGISTRY_TEMPORARY_BYPASS_ALL_WIDE, i_temporary_bypass_all) != OKAY)
+	if (dfxp_SessionWriteIntegerValue(hp_dfxp, DFXP_SESSION_KEY_TEMPORARY_BYPASS_ALL, i_temporary_bypass_all) != OKAY)
 		return(OKAY);
 
 	return(OKAY);
@@ -437,7 +488,7 @@ int dfxpSetDfxTunedTrackPlaying(PT_HANDLE *hp_dfxp, int i_dfx_tuned_track_playin
 	   (cast_handle->slout1)->Message_Wide(FIRST_LINE, cast_handle->wcp_msg1);
    }
 
-	if (dfxp_SessionWriteIntegerValue(hp_dfxp, DFXP_REGISTRY_DFX_TUNED_TRACK_PLAYING_WIDE, i_dfx_tuned_track_playing) != OKAY)
+	if (dfxp_SessionWriteIntegerValue(hp_dfxp, DFXP_SESSION_KEY_DFX_TUNED_TRACK_PLAYING, i_dfx_tuned_track_playing) != OKAY)
 		return(NOT_OKAY);
 
 	return(OKAY);
@@ -465,5 +516,38 @@ int dfxpSetTotalAudioProcessedTime(PT_HANDLE *hp_dfxp, unsigned long ul_msec_aud
 
 	cast_handle->ul_total_msecs_audio_processed_time = ul_msec_audio_processed_time;
 
+	return(OKAY);
+}
+
+/*
+ * FUNCTION: dfxpSetTruePeakOn()
+ * DESCRIPTION:
+ *
+ *  Sets whether the optimizer limits interpolated true peaks (ITU-R BS.1770 style 4x
+ *  oversampled detection) instead of sample peaks. True peak mode adds a fixed
+ *  delay, see dfxpGetOptimizerLatency(). Switching it restarts the detector, so it
+ *  is meant to be set once per deployment rather than toggled while playing.
+ */
+int dfxpSetTruePeakOn(PT_HANDLE *hp_dfxp, int i_true_peak_on)
+{
+	struct dfxpHdlType *cast_handle;
+
+	cast_handle = (struct dfxpHdlType *)(hp_dfxp);
+
+	if (cast_handle == NULL)
+		return(OKAY);
+
+	if (cast_handle->trace.mode)
+		(cast_handle->slout1)->Message_Wide(FIRST_LINE, L"dfxpSetTruePeakOn: Entered");
+
+	i_true_peak_on = i_true_peak_on ? IS_TRUE : IS_FALSE;
+	if (i_true_peak_on == cast_handle->true_peak_on)
+		return(OKAY);
+
+	cast_handle->true_peak_on = i_true_peak_on;
+
+	if (dfxp_MaxCommunicateTruePeak(hp_dfxp) != OKAY)
+		return(NOT_OKAY);
+
 	return(OKAY);
 }
\ No newline at end of file
@@ -64,7 +64,9 @@ int dfxp_SpectrumInit(PT_HANDLE *hp_dfxp)
                                cast_handle->trace.mode) != OKAY)
         return(NOT_OKAY);
 
-    cast_handle->spectrum.sample_sets_since_last_spectrum_save = 0;
+    /* Analyse with an fft when the values are read, the audio thread only stores the samples */
+    if (spectrumSetMode(cast_handle->spectrum.spectrum_hdl, SPECTRUM_MODE_FFT, DFXP_SPECTRUM_NUM_BANDS) != OKAY)
+        return(NOT_OKAY);
 
     if (dfxpSpectrumSendClearValues((PT_HANDLE *)cast_handle) != OKAY)
         return(NOT_OKAY);
@@ -89,7 +91,7 @@ int dfxpSpectrumSendClearValues(PT_HANDLE *hp_dfxp)
         return(OKAY);
 
     /* Clear the spectrum file */
-    if (dfxp_SpectrumStoreCurrentValuesInSharedMemory(hp_dfxp, IS_TRUE) != OKAY)
+    if (dfxp_SpectrumStoreCurrentValuesInSharedMemory(hp_dfxp, NULL, DFXP_SPECTRUM_NUM_BANDS) != OKAY)
         return(NOT_OKAY);
 
     return(OKAY);
@@ -99,7 +101,9 @@ int dfxpSpectrumSendClearValues(PT_HANDLE *hp_dfxp)
  * FUNCTION: dfxpSpectrumGetBandValues()
  * DESCRIPTION:
  *
- *  Get the array with the previously calculated band values
+ *  Get the array with the latest complete set of band values. In fft mode this also runs the
+ *  analysis of the audio processed since the last call. Call from a single reader thread, it
+ *  never waits for the audio thread. The values are also copied to the shared memory.
  *
  */
 int dfxpSpectrumGetBandValues(PT_HANDLE* hp_dfxp, realtype* rp_band_values, int i_array_size)
@@ -114,9 +118,43 @@ int dfxpSpectrumGetBandValues(PT_HANDLE* hp_dfxp, realtype* rp_band_values, int
     if (cast_handle->spectrum.spectrum_hdl == NULL)
         return(OKAY);
 
+    /* Bring the band values up to date with the audio processed since the last call */
+    if (spectrumAnalyze(cast_handle->spectrum.spectrum_hdl) != OKAY)
+        return(NOT_OKAY);
+
     if (spectrumGetBandValues(cast_handle->spectrum.spectrum_hdl, rp_band_values, i_array_size) != OKAY)
         return(NOT_OKAY);
 
+    if (dfxp_SpectrumStoreCurrentValuesInSharedMemory(hp_dfxp, rp_band_values, i_array_size) != OKAY)
+        return(NOT_OKAY);
+
+    return(OKAY);
+}
+
+/*
+ * FUNCTION: dfxpSpectrumSetNumBands()
+ * DESCRIPTION:
+ *
+ *  Sets the number of log spaced band values, SPECTRUM_FFT_MIN_NUM_BANDS to SPECTRUM_FFT_MAX_NUM_BANDS.
+ *  Call from the thread that reads the band values. The shared memory values are only kept up to date
+ *  with the default DFXP_SPECTRUM_NUM_BANDS bands.
+ *
+ */
+int dfxpSpectrumSetNumBands(PT_HANDLE* hp_dfxp, int i_num_bands)
+{
+    struct dfxpHdlType *cast_handle;
+
+    cast_handle = (struct dfxpHdlType *)(hp_dfxp);
+
+    if (cast_handle == NULL)
+        return(OKAY);
+
+    if (cast_handle->spectrum.spectrum_hdl == NULL)
+        return(OKAY);
+
+    if (spectrumSetMode(cast_handle->spectrum.spectrum_hdl, SPECTRUM_MODE_FFT, i_num_bands) != OKAY)
+        return(NOT_OKAY);
+
     return(OKAY);
 }
 
@@ -124,10 +162,11 @@ int dfxpSpectrumGetBandValues(PT_HANDLE* hp_dfxp, realtype* rp_band_values, int
  * FUNCTION: dfxp_SpectrumStoreCurrentValuesInSharedMemory() 
  * DESCRIPTION:
  *
- *  Stores the current spectrum values in the shared memory so they can be sent to the UI.
+ *  Stores the passed spectrum values in the shared memory for other processes, NULL stores zeros.
+ *  Only the default number of bands fits in the shared memory, other band counts are not stored.
  *
  */
-int dfxp_SpectrumStoreCurrentValuesInSharedMemory(PT_HANDLE *hp_dfxp, int i_clear_values)
+int dfxp_SpectrumStoreCurrentValuesInSharedMemory(PT_HANDLE *hp_dfxp, realtype *rp_values, int i_num_bands)
 {
     struct dfxpHdlType *cast_handle;
 
@@ -139,23 +178,19 @@ int dfxp_SpectrumStoreCurrentValuesInSharedMemory(PT_HANDLE *hp_dfxp, int i_clea
    realtype rp_band_values[DFXP_SPECTRUM_NUM_BANDS];
     int index;
 
-    if (cast_handle->spectrum.spectrum_hdl == NULL)
+    /* Shared memory only has room for the default bands */
+    if (i_num_bands != DFXP_SPECTRUM_NUM_BANDS)
         return(OKAY);
     
     if (cast_handle->hp_sharedUtil == NULL)
         return(OKAY);
 
-    if (i_clear_values)
+    for (index = 0; index < DFXP_SPECTRUM_NUM_BANDS; index++)
     {
-        for (index = 0; index < DFXP_SPECTRUM_NUM_BANDS; index++)
-        {
+        if (rp_values == NULL)
             rp_band_values[index] = (realtype)0.0;
-        }
-    }
-    else
-    {
-        if (spectrumGetBandValues(cast_handle->spectrum.spectrum_hdl, rp_band_values, DFXP_SPECTRUM_NUM_BANDS) != OKAY)
-            return(NOT_OKAY);
+        else
+            rp_band_values[index] = rp_values[index];
     }
 
     /* Store the values in shared memory */
@@ -0,0 +1,1133 @@
+/*
+FxSound
+Copyright (C) 2025  FxSound LLC
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/* dfxpSurround.cpp */
+
+#include "codedefs.h"
+
+#include <windows.h>
+#include <avrt.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <atomic>
+#include <new>
+
+#include "u_dfxp.h"
+
+#include "dfxp.h"
+#include "com.h"
+extern "C" {
+#include "comSftwr.h"
+}
+#include "mth.h"
+#include "realSample.h"
+#include "sos.h"
+
+#pragma comment(lib, "avrt.lib")
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define DFXP_SURROUND_SIMD_X86
+#include <emmintrin.h>
+#endif
+
+/*
+ * Surround channel groups.
+ * In the 4, 6 and 8 channel formats dfxpModifyRealtypeSamples() reorders the signal into planar
+ * channel groups (front pair, center, sub, rear pair, side pair) and runs each through its own com
+ * handle. The reorder, the integer conversion when the host passes integer samples and the test
+ * for silent groups are done together in one pass over the buffer, and the same on the way back.
+ *
+ * The groups share no state, so with parallel surround on they are spread over a small pool
+ * of worker threads, the audio thread running the front pair itself, and joined again before the
+ * spectrum and the reorder back. Workers register with MMCSS as "Pro Audio", the same class
+ * hosts use for their render thread, and are left to the scheduler rather than pinned.
+ *
+ * A worker only spins for a few microseconds after each buffer, enough to catch the back to back
+ * calls made for a host buffer longer than the max block size, then sleeps on its event until the
+ * next one, so an idle pool costs nothing between host buffers. The audio thread spins a little
+ * longer on the join, where the work is known to be in flight.
+ */
+#define DFXP_SURROUND_MAX_GROUPS    5
+#define DFXP_SURROUND_MAX_WORKERS   3
+#define DFXP_SURROUND_IDLE_SPIN_COUNT  2000  /* Worker polls before sleeping, a few usecs */
+#define DFXP_SURROUND_JOIN_SPIN_COUNT  20000 /* Audio thread polls before waiting, in the order of 50 usecs */
+#define DFXP_SURROUND_BLOCK_FRAMES  64    /* Frames converted at a time by the integer versions */
+
+/* Start of each channel group in the planar buffer */
+struct dfxpSurroundPlanarType {
+	realtype *rp_front;
+	realtype *rp_center;
+	realtype *rp_sub;
+	realtype *rp_rear;
+	realtype *rp_side;
+};
+
+/* One channel group and its com handle */
+struct dfxpSurroundGroupType {
+	PT_HANDLE *com_hdl;
+	realtype *rp_channels;
+	int stereo;
+	int weight; /* Relative cost, stereo groups count double */
+};
+
+struct dfxpSurroundWorkerType {
+	struct dfxpSurroundPoolType *sp_pool;
+
+	/* Work for the current buffer, only written while the worker is idle */
+	struct dfxpSurroundGroupType groups[DFXP_SURROUND_MAX_GROUPS];
+	int num_groups;
+	long num_sample_sets;
+	int internal_rate_ratio;
+	int status;
+
+	std::atomic<unsigned long> request_count; /* Buffers handed to the worker */
+	std::atomic<unsigned long> done_count;    /* Buffers it has finished */
+	std::atomic<int> sleeping;
+	HANDLE h_wake_event;
+	HANDLE h_thread;
+};
+
+struct dfxpSurroundPoolType {
+	struct dfxpSurroundWorkerType workers[DFXP_SURROUND_MAX_WORKERS];
+	int num_workers;
+	std::atomic<int> enabled;
+	std::atomic<int> stop;
+	std::atomic<int> waiting; /* Audio thread is blocked on h_done_event */
+	HANDLE h_done_event;
+};
+
+static DWORD WINAPI dfxp_SurroundWorkerThread(LPVOID lpParam);
+static int dfxp_SurroundPoolStop(struct dfxpSurroundPoolType *);
+
+/*
+ * FUNCTION: dfxp_SurroundSetPlanar()
+ * DESCRIPTION:
+ *   Sets where each channel group starts in the planar buffer. Groups a format does not have
+ *   are set to NULL.
+ */
+static void dfxp_SurroundSetPlanar(int i_num_channels, realtype *rp_planar, int i_num_sample_sets, struct dfxpSurroundPlanarType *sp_planar)
+{
+	sp_planar->rp_front = rp_planar;
+	sp_planar->rp_center = NULL;
+	sp_planar->rp_sub = NULL;
+	sp_planar->rp_side = NULL;
+
+	if (i_num_channels == 4)
+	{
+		sp_planar->rp_rear = rp_planar + 2 * i_num_sample_sets;
+	}
+	else
+	{
+		sp_planar->rp_center = rp_planar + 2 * i_num_sample_sets;
+		sp_planar->rp_sub = rp_planar + 3 * i_num_sample_sets;
+		sp_planar->rp_rear = rp_planar + 4 * i_num_sample_sets;
+		if (i_num_channels == 8)
+			sp_planar->rp_side = rp_planar + 6 * i_num_sample_sets;
+	}
+}
+
+/*
+ * FUNCTION: dfxp_SurroundScatterFrames()
+ * DESCRIPTION:
+ *   Copies interleaved frames, starting at frame i_first of the buffer, into the channel groups
+ *   and returns the DFXP_SURROUND_XXX_NONZERO flags of the groups that have signal.
+ */
+static int dfxp_SurroundScatterFrames(int i_num_channels, realtype *rp_in, int i_first, int i_num_frames,
+												  struct dfxpSurroundPlanarType *sp_planar)
+{
+	int i_nonzero = 0;
+	int i, j;
+
+	for (i = i_first; i < i_first + i_num_frames; i++, rp_in += i_num_channels)
+	{
+		j = i * 2;
+
+		sp_planar->rp_front[j] = rp_in[0];
+		sp_planar->rp_front[j + 1] = rp_in[1];
+
+		if (i_num_channels == 4)
+		{
+			sp_planar->rp_rear[j] = rp_in[2];
+			sp_planar->rp_rear[j + 1] = rp_in[3];
+			if ((rp_in[2] != (realtype)0.0) || (rp_in[3] != (realtype)0.0))
+				i_nonzero |= DFXP_SURROUND_REAR_NONZERO;
+			continue;
+		}
+
+		sp_planar->rp_center[i] = rp_in[2];
+		if (rp_in[2] != (realtype)0.0)
+			i_nonzero |= DFXP_SURROUND_CENTER_NONZERO;
+
+		sp_planar->rp_sub[i] = rp_in[3];
+		if (rp_in[3] != (realtype)0.0)
+			i_nonzero |= DFXP_SURROUND_SUB_NONZERO;
+
+		sp_planar->rp_rear[j] = rp_in[4];
+		sp_planar->rp_rear[j + 1] = rp_in[5];
+		if ((rp_in[4] != (realtype)0.0) || (rp_in[5] != (realtype)0.0))
+			i_nonzero |= DFXP_SURROUND_REAR_NONZERO;
+
+		if (i_num_channels == 8)
+		{
+			sp_planar->rp_side[j] = rp_in[6];
+			sp_planar->rp_side[j + 1] = rp_in[7];
+			if ((rp_in[6] != (realtype)0.0) || (rp_in[7] != (realtype)0.0))
+				i_nonzero |= DFXP_SURROUND_SIDE_NONZERO;
+		}
+	}
+
+	return(i_nonzero);
+}
+
+/*
+ * FUNCTION: dfxp_SurroundGatherFrames()
+ * DESCRIPTION:
+ *   Inverse of dfxp_SurroundScatterFrames(), interleaves frames of the channel groups into rp_out.
+ */
+static void dfxp_SurroundGatherFrames(int i_num_channels, struct dfxpSurroundPlanarType *sp_planar,
+												  int i_first, int i_num_frames, realtype *rp_out)
+{
+	int i, j;
+
+	for (i = i_first; i < i_first + i_num_frames; i++, rp_out += i_num_channels)
+	{
+		j = i * 2;
+
+		rp_out[0] = sp_planar->rp_front[j];
+		rp_out[1] = sp_planar->rp_front[j + 1];
+
+		if (i_num_channels == 4)
+		{
+			rp_out[2] = sp_planar->rp_rear[j];
+			rp_out[3] = sp_planar->rp_rear[j + 1];
+			continue;
+		}
+
+		rp_out[2] = sp_planar->rp_center[i];
+		rp_out[3] = sp_planar->rp_sub[i];
+		rp_out[4] = sp_planar->rp_rear[j];
+		rp_out[5] = sp_planar->rp_rear[j + 1];
+
+		if (i_num_channels == 8)
+		{
+			rp_out[6] = sp_planar->rp_side[j];
+			rp_out[7] = sp_planar->rp_side[j + 1];
+		}
+	}
+}
+
+#ifdef DFXP_SURROUND_SIMD_X86
+
+/*
+ * FUNCTION: dfxp_SurroundScatterFramesSse()
+ * DESCRIPTION:
+ *   SSE version of dfxp_SurroundScatterFrames(), four frames per pass. The nonzero tests are
+ *   ordered compares against zero, so -0.0 is zero and NaN is not, as in the scalar code.
+ */
+static int dfxp_SurroundScatterFramesSse(int i_num_channels, realtype *rp_in, int i_first, int i_num_frames,
+													  struct dfxpSurroundPlanarType *sp_planar)
+{
+	__m128 zero = _mm_setzero_ps();
+	__m128 center_nonzero = zero;
+	__m128 sub_nonzero = zero;
+	__m128 rear_nonzero = zero;
+	__m128 side_nonzero = zero;
+	realtype *rp_front = sp_planar->rp_front + 2 * i_first;
+	realtype *rp_rear = sp_planar->rp_rear + 2 * i_first;
+	int i_nonzero = 0;
+	int i = 0;
+
+	if (i_num_channels == 4)
+	{
+		for (; i + 4 <= i_num_frames; i += 4, rp_in += 16, rp_front += 8, rp_rear += 8)
+		{
+			/* [FL FR RL RR] per frame */
+			__m128 v0 = _mm_loadu_ps(rp_in);
+			__m128 v1 = _mm_loadu_ps(rp_in + 4);
+			__m128 v2 = _mm_loadu_ps(rp_in + 8);
+			__m128 v3 = _mm_loadu_ps(rp_in + 12);
+			__m128 rear0 = _mm_movehl_ps(v1, v0);
+			__m128 rear1 = _mm_movehl_ps(v3, v2);
+
+			_mm_storeu_ps(rp_front, _mm_movelh_ps(v0, v1));
+			_mm_storeu_ps(rp_front + 4, _mm_movelh_ps(v2, v3));
+			_mm_storeu_ps(rp_rear, rear0);
+			_mm_storeu_ps(rp_rear + 4, rear1);
+
+			rear_nonzero = _mm_or_ps(rear_nonzero, _mm_or_ps(_mm_cmpneq_ps(rear0, zero), _mm_cmpneq_ps(rear1, zero)));
+		}
+	}
+	else if (i_num_channels == 6)
+	{
+		realtype *rp_center = sp_planar->rp_center + i_first;
+		realtype *rp_sub = sp_planar->rp_sub + i_first;
+
+		for (; i + 4 <= i_num_frames; i += 4, rp_in += 24, rp_front += 8, rp_rear += 8, rp_center += 4, rp_sub += 4)
+		{
+			/* [FL0 FR0 C0 S0] [RL0 RR0 FL1 FR1] [C1 S1 RL1 RR1] and the same for frames 2 and 3 */
+			__m128 v0 = _mm_loadu_ps(rp_in);
+			__m128 v1 = _mm_loadu_ps(rp_in + 4);
+			__m128 v2 = _mm_loadu_ps(rp_in + 8);
+			__m128 v3 = _mm_loadu_ps(rp_in + 12);
+			__m128 v4 = _mm_loadu_ps(rp_in + 16);
+			__m128 v5 = _mm_loadu_ps(rp_in + 20);
+			__m128 rear0 = _mm_shuffle_ps(v1, v2, _MM_SHUFFLE(3, 2, 1, 0));
+			__m128 rear1 = _mm_shuffle_ps(v4, v5, _MM_SHUFFLE(3, 2, 1, 0));
+			__m128 cs01 = _mm_shuffle_ps(v0, v2, _MM_SHUFFLE(1, 0, 3, 2));
+			__m128 cs23 = _mm_shuffle_ps(v3, v5, _MM_SHUFFLE(1, 0, 3, 2));
+			__m128 center = _mm_shuffle_ps(cs01, cs23, _MM_SHUFFLE(2, 0, 2, 0));
+			__m128 sub = _mm_shuffle_ps(cs01, cs23, _MM_SHUFFLE(3, 1, 3, 1));
+
+			_mm_storeu_ps(rp_front, _mm_shuffle_ps(v0, v1, _MM_SHUFFLE(3, 2, 1, 0)));
+			_mm_storeu_ps(rp_front + 4, _mm_shuffle_ps(v3, v4, _MM_SHUFFLE(3, 2, 1, 0)));
+			_mm_storeu_ps(rp_rear, rear0);
+			_mm_storeu_ps(rp_rear + 4, rear1);
+			_mm_storeu_ps(rp_center, center);
+			_mm_storeu_ps(rp_sub, sub);
+
+			center_nonzero = _mm_or_ps(center_nonzero, _mm_cmpneq_ps(center, zero));
+			sub_nonzero = _mm_or_ps(sub_nonzero, _mm_cmpneq_ps(sub, zero));
+			rear_nonzero = _mm_or_ps(rear_nonzero, _mm_or_ps(_mm_cmpneq_ps(rear0, zero), _mm_cmpneq_ps(rear1, zero)));
+		}
+	}
+	else
+	{
+		realtype *rp_center = sp_planar->rp_center + i_first;
+		realtype *rp_sub = sp_planar->rp_sub + i_first;
+		realtype *rp_side = sp_planar->rp_side + 2 * i_first;
+
+		for (; i + 4 <= i_num_frames; i += 4, rp_in += 32, rp_front += 8, rp_rear += 8, rp_side += 8, rp_center += 4, rp_sub += 4)
+		{
+			/* [FL FR C S] [RL RR SL SR] per frame */
+			__m128 a0 = _mm_loadu_ps(rp_in);
+			__m128 b0 = _mm_loadu_ps(rp_in + 4);
+			__m128 a1 = _mm_loadu_ps(rp_in + 8);
+			__m128 b1 = _mm_loadu_ps(rp_in + 12);
+			__m128 a2 = _mm_loadu_ps(rp_in + 16);
+			__m128 b2 = _mm_loadu_ps(rp_in + 20);
+			__m128 a3 = _mm_loadu_ps(rp_in + 24);
+			__m128 b3 = _mm_loadu_ps(rp_in + 28);
+			__m128 cs01 = _mm_movehl_ps(a1, a0);
+			__m128 cs23 = _mm_movehl_ps(a3, a2);
+			__m128 center = _mm_shuffle_ps(cs01, cs23, _MM_SHUFFLE(2, 0, 2, 0));
+			__m128 sub = _mm_shuffle_ps(cs01, cs23, _MM_SHUFFLE(3, 1, 3, 1));
+			__m128 rear0 = _mm_movelh_ps(b0, b1);
+			__m128 rear1 = _mm_movelh_ps(b2, b3);
+			__m128 side0 = _mm_movehl_ps(b1, b0);
+			__m128 side1 = _mm_movehl_ps(b3, b2);
+
+			_mm_storeu_ps(rp_front, _mm_movelh_ps(a0, a1));
+			_mm_storeu_ps(rp_front + 4, _mm_movelh_ps(a2, a3));
+			_mm_storeu_ps(rp_rear, rear0);
+			_mm_storeu_ps(rp_rear + 4, rear1);
+			_mm_storeu_ps(rp_side, side0);
+			_mm_storeu_ps(rp_side + 4, side1);
+			_mm_storeu_ps(rp_center, center);
+			_mm_storeu_ps(rp_sub, sub);
+
+			center_nonzero = _mm_or_ps(center_nonzero, _mm_cmpneq_ps(center, zero));
+			sub_nonzero = _mm_or_ps(sub_nonzero, _mm_cmpneq_ps(sub, zero));
+			rear_nonzero = _mm_or_ps(rear_nonzero, _mm_or_ps(_mm_cmpneq_ps(rear0, zero), _mm_cmpneq_ps(rear1, zero)));
+			side_nonzero = _mm_or_ps(side_nonzero, _mm_or_ps(_mm_cmpneq_ps(side0, zero), _mm_cmpneq_ps(side1, zero)));
+		}
+	}
+
+	if (_mm_movemask_ps(center_nonzero))
+		i_nonzero |= DFXP_SURROUND_CENTER_NONZERO;
+	if (_mm_movemask_ps(sub_nonzero))
+		i_nonzero |= DFXP_SURROUND_SUB_NONZERO;
+	if (_mm_movemask_ps(rear_nonzero))
+		i_nonzero |= DFXP_SURROUND_REAR_NONZERO;
+	if (_mm_movemask_ps(side_nonzero))
+		i_nonzero |= DFXP_SURROUND_SIDE_NONZERO;
+
+	/* Leftover frames */
+	i_nonzero |= dfxp_SurroundScatterFrames(i_num_channels, rp_in, i_first + i, i_num_frames - i, sp_planar);
+
+	return(i_nonzero);
+}
+
+/*
+ * FUNCTION: dfxp_SurroundGatherFramesSse()
+ * DESCRIPTION:
+ *   SSE version of dfxp_SurroundGatherFrames(), the same shuffles as the scatter run backwards.
+ */
+static void dfxp_SurroundGatherFramesSse(int i_num_channels, struct dfxpSurroundPlanarType *sp_planar,
+													  int i_first, int i_num_frames, realtype *rp_out)
+{
+	realtype *rp_front = sp_planar->rp_front + 2 * i_first;
+	realtype *rp_rear = sp_planar->rp_rear + 2 * i_first;
+	int i = 0;
+
+	if (i_num_channels == 4)
+	{
+		for (; i + 4 <= i_num_frames; i += 4, rp_out += 16, rp_front += 8, rp_rear += 8)
+		{
+			__m128 front0 = _mm_loadu_ps(rp_front);
+			__m128 front1 = _mm_loadu_ps(rp_front + 4);
+			__m128 rear0 = _mm_loadu_ps(rp_rear);
+			__m128 rear1 = _mm_loadu_ps(rp_rear + 4);
+
+			_mm_storeu_ps(rp_out, _mm_movelh_ps(front0, rear0));
+			_mm_storeu_ps(rp_out + 4, _mm_movehl_ps(rear0, front0));
+			_mm_storeu_ps(rp_out + 8, _mm_movelh_ps(front1, rear1));
+			_mm_storeu_ps(rp_out + 12, _mm_movehl_ps(rear1, front1));
+		}
+	}
+	else if (i_num_channels == 6)
+	{
+		realtype *rp_center = sp_planar->rp_center + i_first;
+		realtype *rp_sub = sp_planar->rp_sub + i_first;
+
+		for (; i + 4 <= i_num_frames; i += 4, rp_out += 24, rp_front += 8, rp_rear += 8, rp_center += 4, rp_sub += 4)
+		{
+			__m128 front0 = _mm_loadu_ps(rp_front);
+			__m128 front1 = _mm_loadu_ps(rp_front + 4);
+			__m128 rear0 = _mm_loadu_ps(rp_rear);
+			__m128 rear1 = _mm_loadu_ps(rp_rear + 4);
+			__m128 center = _mm_loadu_ps(rp_center);
+			__m128 sub = _mm_loadu_ps(rp_sub);
+			__m128 cs01 = _mm_unpacklo_ps(center, sub);
+			__m128 cs23 = _mm_unpackhi_ps(center, sub);
+
+			_mm_storeu_ps(rp_out, _mm_shuffle_ps(front0, cs01, _MM_SHUFFLE(1, 0, 1, 0)));
+			_mm_storeu_ps(rp_out + 4, _mm_shuffle_ps(rear0, front0, _MM_SHUFFLE(3, 2, 1, 0)));
+			_mm_storeu_ps(rp_out + 8, _mm_shuffle_ps(cs01, rear0, _MM_SHUFFLE(3, 2, 3, 2)));
+			_mm_storeu_ps(rp_out + 12, _mm_shuffle_ps(front1, cs23, _MM_SHUFFLE(1, 0, 1, 0)));
+			_mm_storeu_ps(rp_out + 16, _mm_shuffle_ps(rear1, front1, _MM_SHUFFLE(3, 2, 1, 0)));
+			_mm_storeu_ps(rp_out + 20, _mm_shuffle_ps(cs23, rear1, _MM_SHUFFLE(3, 2, 3, 2)));
+		}
+	}
+	else
+	{
+		realtype *rp_center = sp_planar->rp_center + i_first;
+		realtype *rp_sub = sp_planar->rp_sub + i_first;
+		realtype *rp_side = sp_planar->rp_side + 2 * i_first;
+
+		for (; i + 4 <= i_num_frames; i += 4, rp_out += 32, rp_front += 8, rp_rear += 8, rp_side += 8, rp_center += 4, rp_sub += 4)
+		{
+			__m128 front0 = _mm_loadu_ps(rp_front);
+			__m128 front1 = _mm_loadu_ps(rp_front + 4);
+			__m128 rear0 = _mm_loadu_ps(rp_rear);
+			__m128 rear1 = _mm_loadu_ps(rp_rear + 4);
+			__m128 side0 = _mm_loadu_ps(rp_side);
+			__m128 side1 = _mm_loadu_ps(rp_side + 4);
+			__m128 center = _mm_loadu_ps(rp_center);
+			__m128 sub = _mm_loadu_ps(rp_sub);
+			__m128 cs01 = _mm_unpacklo_ps(center, sub);
+			__m128 cs23 = _mm_unpackhi_ps(center, sub);
+
+			_mm_storeu_ps(rp_out, _mm_movelh_ps(front0, cs01));
+			_mm_storeu_ps(rp_out + 4, _mm_movelh_ps(rear0, side0));
+			_mm_storeu_ps(rp_out + 8, _mm_movehl_ps(cs01, front0));
+			_mm_storeu_ps(rp_out + 12, _mm_movehl_ps(side0, rear0));
+			_mm_storeu_ps(rp_out + 16, _mm_movelh_ps(front1, cs23));
+			_mm_storeu_ps(rp_out + 20, _mm_movelh_ps(rear1, side1));
+			_mm_storeu_ps(rp_out + 24, _mm_movehl_ps(cs23, front1));
+			_mm_storeu_ps(rp_out + 28, _mm_movehl_ps(side1, rear1));
+		}
+	}
+
+	dfxp_SurroundGatherFrames(i_num_channels, sp_planar, i_first + i, i_num_frames - i, rp_out);
+}
+
+/*
+ * FUNCTION: dfxp_Surround16BitToRealtypeSse()
+ * DESCRIPTION:
+ *   SSE2 version of the 16 bit case of mthConvertIntBufToRealtype(), same scaling so the
+ *   values are identical.
+ */
+static void dfxp_Surround16BitToRealtypeSse(int i_length, short int *sp_buf, realtype *rp_buf)
+{
+	__m128 scale = _mm_set1_ps((float)(1.0/MTH_16_BIT_REAL_CONVERSION_FACTOR));
+	int i;
+
+	for (i = 0; i + 8 <= i_length; i += 8)
+	{
+		__m128i samples = _mm_loadu_si128((__m128i *)(sp_buf + i));
+		__m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(samples, samples), 16);
+		__m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(samples, samples), 16);
+
+		_mm_storeu_ps(rp_buf + i, _mm_mul_ps(_mm_cvtepi32_ps(lo), scale));
+		_mm_storeu_ps(rp_buf + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(hi), scale));
+	}
+
+	for (; i < i_length; i++)
+		rp_buf[i] = (float)(sp_buf[i]) * (float)(1.0/MTH_16_BIT_REAL_CONVERSION_FACTOR);
+}
+
+/*
+ * FUNCTION: dfxp_SurroundRealtypeTo16BitSse()
+ * DESCRIPTION:
+ *   SSE2 version of the 16 bit case of mthConvertRealtypeBufToIntBuf(). Truncates and saturates
+ *   the same way, a full scale +1.0 gives 32767, and the tail is left to it so the bits match.
+ */
+static void dfxp_SurroundRealtypeTo16BitSse(int i_length, realtype *rp_buf, short int *sp_buf)
+{
+	__m128 scale = _mm_set1_ps((float)MTH_16_BIT_REAL_CONVERSION_FACTOR);
+	int i;
+
+	for (i = 0; i + 8 <= i_length; i += 8)
+	{
+		__m128i lo = _mm_cvttps_epi32(_mm_mul_ps(_mm_loadu_ps(rp_buf + i), scale));
+		__m128i hi = _mm_cvttps_epi32(_mm_mul_ps(_mm_loadu_ps(rp_buf + i + 4), scale));
+
+		_mm_storeu_si128((__m128i *)(sp_buf + i), _mm_packs_epi32(lo, hi));
+	}
+
+	if (i < i_length)
+		mthConvertRealtypeBufToIntBuf(i_length - i, 16, 16, rp_buf + i, sp_buf + i);
+}
+
+#endif //DFXP_SURROUND_SIMD_X86
+
+/*
+ * FUNCTION: dfxp_SurroundUseSimd()
+ * DESCRIPTION:
+ *   The instruction set follows the sos module level, so sosSetMaxSimdLevel() also selects the
+ *   scalar code here.
+ */
+static int dfxp_SurroundUseSimd(void)
+{
+#ifdef DFXP_SURROUND_SIMD_X86
+	int simd_level;
+
+	sosGetSimdLevel(&simd_level);
+
+	return(simd_level >= SOS_SIMD_SSE2);
+#else
+	return(IS_FALSE);
+#endif
+}
+
+/*
+ * FUNCTION: dfxp_SurroundScatter()
+ * DESCRIPTION:
+ *   Reorders an interleaved realtype buffer into the planar channel groups in rp_planar and
+ *   passes back the DFXP_SURROUND_XXX_NONZERO flags, in a single pass.
+ */
+int dfxp_SurroundScatter(PT_HANDLE *hp_dfxp, realtype *rp_in, int i_num_sample_sets, realtype *rp_planar, int *ip_nonzero)
+{
+	struct dfxpHdlType *cast_handle;
+	struct dfxpSurroundPlanarType planar;
+
+	cast_handle = (struct dfxpHdlType *)(hp_dfxp);
+
+	*ip_nonzero = 0;
+
+	if (cast_handle == NULL)
+		return(OKAY);
+
+	dfxp_SurroundSetPlanar(cast_handle->num_channels_out, rp_planar, i_num_sample_sets, &planar);
+
+#ifdef DFXP_SURROUND_SIMD_X86
+	if (dfxp_SurroundUseSimd())
+	{
+		*ip_nonzero = dfxp_SurroundScatterFramesSse(cast_handle->num_channels_out, rp_in, 0, i_num_sample_sets, &planar);
+		return(OKAY);
+	}
+#endif
+
+	*ip_nonzero = dfxp_SurroundScatterFrames(cast_handle->num_channels_out, rp_in, 0, i_num_sample_sets, &planar);
+
+	return(OKAY);
+}
+
+/*
+ * FUNCTION: dfxp_SurroundScatterInt()
+ * DESCRIPTION:
+ *   Same as dfxp_SurroundScatter() for an interleaved integer buffer, converting on the way.
+ *   Blocks of frames are converted into a small local buffer that stays in cache and scattered
+ *   from there, so the full size interleaved realtype buffer is never written.
+ */
+int dfxp_SurroundScatterInt(PT_HANDLE *hp_dfxp, struct dfxp_surround_int_io_type *sp_io, int i_num_sample_sets,
+									 realtype *rp_planar, int *ip_nonzero)
+{
+	struct dfxpHdlType *cast_handle;
+	struct dfxpSurroundPlanarType planar;
+	realtype r_block[DFXP_SURROUND_BLOCK_FRAMES * DAW_MAX_NUM_CHANNELS];
+	unsigned char *ucp_in;
+	int num_channels;
+	int num_frames;
+	int use_simd;
+	int i;
+
+	cast_handle = (struct dfxpHdlType *)(hp_dfxp);
+
+	*ip_nonzero = 0;
+
+	if (cast_handle == NULL)
+		return(OKAY);
+
+	num_channels = cast_handle->num_channels_out;
+	use_simd = dfxp_SurroundUseSimd();
+	ucp_in = (unsigned char *)sp_io->sip_in;
+
+	dfxp_SurroundSetPlanar(num_channels, rp_planar, i_num_sample_sets, &planar);
+
+	for (i = 0; i < i_num_sample_sets; i += num_frames)
+	{
+		num_frames = i_num_sample_sets - i;
+		if (num_frames > DFXP_SURROUND_BLOCK_FRAMES)
+			num_frames = DFXP_SURROUND_BLOCK_FRAMES;
+
+#ifdef DFXP_SURROUND_SIMD_X86
+		if (use_simd)
+		{
+			if (sp_io->bit_width == 16)
+				dfxp_Surround16BitToRealtypeSse(num_frames * num_channels, (short int *)ucp_in, r_block);
+			else if (mthConvertIntBufToRealtype(num_frames * num_channels, sp_io->bit_width, sp_io->bits_valid,
+														   (short int *)ucp_in, r_block) != OKAY)
+				return(NOT_OKAY);
+
+			*ip_nonzero |= dfxp_SurroundScatterFramesSse(num_channels, r_block, i, num_frames, &planar);
+		}
+		else
+#endif
+		{
+			if (mthConvertIntBufToRealtype(num_frames * num_channels, sp_io->bit_width, sp_io->bits_valid,
+														(short int *)ucp_in, r_block) != OKAY)
+				return(NOT_OKAY);
+
+			*ip_nonzero |= dfxp_SurroundScatterFrames(num_channels, r_block, i, num_frames, &planar);
+		}
+
+		ucp_in += num_frames * num_channels * (sp_io->bit_width / 8);
+	}
+
+	return(OKAY);
+}
+
+/*
+ * FUNCTION: dfxp_SurroundGather()
+ * DESCRIPTION:
+ *   Puts the planar channel groups back into the interleaved order of the passed buffer.
+ */
+int dfxp_SurroundGather(PT_HANDLE *hp_dfxp, realtype *rp_planar, int i_num_sample_sets, realtype *rp_out)
+{
+	struct dfxpHdlType *cast_handle;
+	struct dfxpSurroundPlanarType planar;
+
+	cast_handle = (struct dfxpHdlType *)(hp_dfxp);
+
+	if (cast_handle == NULL)
+		return(OKAY);
+
+	dfxp_SurroundSetPlanar(cast_handle->num_channels_out, rp_planar, i_num_sample_sets, &planar);
+
+#ifdef DFXP_SURROUND_SIMD_X86
+	if (dfxp_SurroundUseSimd())
+	{
+		dfxp_SurroundGatherFramesSse(cast_handle->num_channels_out, &planar, 0, i_num_sample_sets, rp_out);
+		return(OKAY);
+	}
+#endif
+
+	dfxp_SurroundGatherFrames(cast_handle->num_channels_out, &planar, 0, i_num_sample_sets, rp_out);
+
+	return(OKAY);
+}
+
+/*
+ * FUNCTION: dfxp_SurroundGatherInt()
+ * DESCRIPTION:
+ *   Same as dfxp_SurroundGather() for an interleaved integer buffer, converting on the way.
+ *   As with mthConvertRealtypeBufToIntBuf() the values are assumed to be within +/- 1.0.
+ */
+int dfxp_SurroundGatherInt(PT_HANDLE *hp_dfxp, realtype *rp_planar, int i_num_sample_sets, struct dfxp_surround_int_io_type *sp_io)
+{
+	struct dfxpHdlType *cast_handle;
+	struct dfxpSurroundPlanarType planar;
+	realtype r_block[DFXP_SURROUND_BLOCK_FRAMES * DAW_MAX_NUM_CHANNELS];
+	unsigned char *ucp_out;
+	int num_channels;
+	int num_frames;
+	int use_simd;
+	int status;
+	int i;
+
+	cast_handle = (struct dfxpHdlType *)(hp_dfxp);
+
+	if (cast_handle == NULL)
+		return(OKAY);
+
+	num_channels = cast_handle->num_channels_out;
+	use_simd = dfxp_SurroundUseSimd();
+	ucp_out = (unsigned char *)sp_io->sip_out;
+	status = OKAY;
+
+	dfxp_SurroundSetPlanar(num_channels, rp_planar, i_num_sample_sets, &planar);
+
+	for (i = 0; i < i_num_sample_sets; i += num_frames)
+	{
+		num_frames = i_num_sample_sets - i;
+		if (num_frames > DFXP_SURROUND_BLOCK_FRAMES)
+			num_frames = DFXP_SURROUND_BLOCK_FRAMES;
+
+#ifdef DFXP_SURROUND_SIMD_X86
+		if (use_simd)
+		{
+			dfxp_SurroundGatherFramesSse(num_channels, &planar, i, num_frames, r_block);
+
+			if (sp_io->bit_width == 16)
+				dfxp_SurroundRealtypeTo16BitSse(num_frames * num_channels, r_block, (short int *)ucp_out);
+			else if (mthConvertRealtypeBufToIntBuf(num_frames * num_channels, sp_io->bit_width, sp_io->bits_valid,
+																r_block, (short int *)ucp_out) != OKAY)
+				status = NOT_OKAY;
+		}
+		else
+#endif
+		{
+			dfxp_SurroundGatherFrames(num_channels, &planar, i, num_frames, r_block);
+
+			if (mthConvertRealtypeBufToIntBuf(num_frames * num_channels, sp_io->bit_width, sp_io->bits_valid,
+														 r_block, (short int *)ucp_out) != OKAY)
+				status = NOT_OKAY;
+		}
+
+		ucp_out += num_frames * num_channels * (sp_io->bit_width / 8);
+	}
+
+	/* Every block is written even if one fails, as the single buffer conversion did */
+	return(status);
+}
+
+/*
+ * FUNCTION: dfxp_SurroundAddGroup()
+ * DESCRIPTION:
+ *   Adds a channel group to the list, stereo groups cost about twice a mono one.
+ */
+static void dfxp_SurroundAddGroup(struct dfxpSurroundGroupType *sp_groups, int *ip_num_groups,
+											 PT_HANDLE *hp_com, realtype *rp_channels, int i_stereo)
+{
+	struct dfxpSurroundGroupType *sp_group = &(sp_groups[*ip_num_groups]);
+
+	sp_group->com_hdl = hp_com;
+	sp_group->rp_channels = rp_channels;
+	sp_group->stereo = i_stereo;
+	sp_group->weight = i_stereo ? 2 : 1;
+
+	(*ip_num_groups)++;
+}
+
+/*
+ * FUNCTION: dfxp_SurroundRunGroups()
+ * DESCRIPTION:
+ *   Runs the passed channel groups through their com handles, in order.
+ */
+static int dfxp_SurroundRunGroups(struct dfxpSurroundGroupType *sp_groups, int i_num_groups, long l_num_sample_sets, int i_internal_rate_ratio)
+{
+	realtype tmp_float;
+	int i;
+
+	for (i = 0; i < i_num_groups; i++)
+	{
+		if (comProcessWaveBuffer(sp_groups[i].com_hdl, (long *)sp_groups[i].rp_channels, &tmp_float, l_num_sample_sets,
+		                         sp_groups[i].stereo, sp_groups[i].stereo, i_internal_rate_ratio, (int)COM_32_BIT_FLOAT_SAMPLES) != OKAY)
+			return(NOT_OKAY);
+	}
+
+	return(OKAY);
+}
+
+/*
+ * FUNCTION: dfxp_SurroundProcessGroups()
+ * DESCRIPTION:
+ *   Processes the reordered 4, 6 or 8 channel buffer, one com handle per channel group.
+ *   Groups without their flag in i_nonzero were all zeros on input and are skipped. With parallel surround on, the groups are
+ *   shared between the audio thread and the workers, longest first onto the least loaded thread,
+ *   and the call returns once all of them are done.
+ */
+int dfxp_SurroundProcessGroups(PT_HANDLE *hp_dfxp, realtype *rp_buf, int i_num_sample_sets, int i_nonzero)
+{
+	struct dfxpHdlType *cast_handle;
+	struct dfxpSurroundPoolType *sp_pool;
+	struct dfxpSurroundPlanarType planar;
+	struct dfxpSurroundGroupType groups[DFXP_SURROUND_MAX_GROUPS];
+	struct dfxpSurroundGroupType local_groups[DFXP_SURROUND_MAX_GROUPS];
+	int loads[DFXP_SURROUND_MAX_WORKERS + 1];
+	unsigned long requests[DFXP_SURROUND_MAX_WORKERS];
+	int num_groups;
+	int num_local_groups;
+	long l_num_sample_sets;
+	int status;
+	int i, w;
+
+	cast_handle = (struct dfxpHdlType *)(hp_dfxp);
+
+	if (cast_handle == NULL)
+		return(OKAY);
+
+	l_num_sample_sets = (long)i_num_sample_sets;
+
+	dfxp_SurroundSetPlanar(cast_handle->num_channels_out, rp_buf, i_num_sample_sets, &planar);
+
+	/* Front pair always processed, then the groups with signal, in the serial order */
+	num_groups = 0;
+	dfxp_SurroundAddGroup(groups, &num_groups, cast_handle->com_hdl_front, planar.rp_front, IS_TRUE);
+
+	if ((planar.rp_center != NULL) && (i_nonzero & DFXP_SURROUND_CENTER_NONZERO))
+		dfxp_SurroundAddGroup(groups, &num_groups, cast_handle->com_hdl_center, planar.rp_center, IS_FALSE);
+
+	if ((planar.rp_sub != NULL) && (i_nonzero & DFXP_SURROUND_SUB_NONZERO))
+		dfxp_SurroundAddGroup(groups, &num_groups, cast_handle->com_hdl_subwoofer, planar.rp_sub, IS_FALSE);
+
+	if (i_nonzero & DFXP_SURROUND_REAR_NONZERO)
+		dfxp_SurroundAddGroup(groups, &num_groups, cast_handle->com_hdl_rear, planar.rp_rear, IS_TRUE);
+
+	if ((planar.rp_side != NULL) && (i_nonzero & DFXP_SURROUND_SIDE_NONZERO))
+		dfxp_SurroundAddGroup(groups, &num_groups, cast_handle->com_hdl_side, planar.rp_side, IS_TRUE);
+
+	sp_pool = cast_handle->surround_pool.load(std::memory_order_acquire);
+
+	if ((num_groups == 1) || (sp_pool == NULL) || (!sp_pool->enabled.load(std::memory_order_acquire)))
+		return( dfxp_SurroundRunGroups(groups, num_groups, l_num_sample_sets, cast_handle->internal_rate_ratio) );
+
+	/* Load 0 is the audio thread, which keeps the front pair */
+	for (w = 0; w <= sp_pool->num_workers; w++)
+		loads[w] = 0;
+	for (w = 0; w < sp_pool->num_workers; w++)
+		sp_pool->workers[w].num_groups = 0;
+
+	local_groups[0] = groups[0];
+	num_local_groups = 1;
+	loads[0] = groups[0].weight;
+
+	/* Stereo groups first, a stable pass per weight keeps the serial order within each weight */
+	for (int weight = 2; weight >= 1; weight--)
+	{
+		for (i = 1; i < num_groups; i++)
+		{
+			int least = 0;
+
+			if (groups[i].weight != weight)
+				continue;
+
+			for (w = 1; w <= sp_pool->num_workers; w++)
+				if (loads[w] < loads[least])
+					least = w;
+
+			loads[least] += groups[i].weight;
+
+			if (least == 0)
+				local_groups[num_local_groups++] = groups[i];
+			else
+			{
+				struct dfxpSurroundWorkerType *sp_worker = &(sp_pool->workers[least - 1]);
+				sp_worker->groups[sp_worker->num_groups++] = groups[i];
+			}
+		}
+	}
+
+	/* Hand the groups over, the flag is read after the request so a worker going to sleep still sees it */
+	for (w = 0; w < sp_pool->num_workers; w++)
+	{
+		struct dfxpSurroundWorkerType *sp_worker = &(sp_pool->workers[w]);
+
+		requests[w] = sp_worker->done_count.load(std::memory_order_relaxed);
+		if (sp_worker->num_groups == 0)
+			continue;
+
+		sp_worker->num_sample_sets = l_num_sample_sets;
+		sp_worker->internal_rate_ratio = cast_handle->internal_rate_ratio;
+		sp_worker->status = OKAY;
+
+		requests[w]++;
+		sp_worker->request_count.store(requests[w]);
+		if (sp_worker->sleeping.load())
+			SetEvent(sp_worker->h_wake_event);
+	}
+
+	status = dfxp_SurroundRunGroups(local_groups, num_local_groups, l_num_sample_sets, cast_handle->internal_rate_ratio);
+
+	/* Join, the groups reference this buffer so the wait is unconditional */
+	for (w = 0; w < sp_pool->num_workers; w++)
+	{
+		struct dfxpSurroundWorkerType *sp_worker = &(sp_pool->workers[w]);
+		int spins = 0;
+
+		while (sp_worker->done_count.load(std::memory_order_acquire) != requests[w])
+		{
+			if (++spins < DFXP_SURROUND_JOIN_SPIN_COUNT)
+			{
+				YieldProcessor();
+				continue;
+			}
+
+			sp_pool->waiting.store(IS_TRUE);
+			if (sp_worker->done_count.load() != requests[w])
+				WaitForSingleObject(sp_pool->h_done_event, INFINITE);
+			sp_pool->waiting.store(IS_FALSE);
+		}
+
+		if ((sp_worker->num_groups > 0) && (sp_worker->status != OKAY))
+			status = NOT_OKAY;
+	}
+
+	return(status);
+}
+
+/*
+ * FUNCTION: dfxp_SurroundWorkerThread()
+ * DESCRIPTION:
+ *   Runs the channel groups handed to one worker, buffer after buffer, until the pool is stopped.
+ */
+static DWORD WINAPI dfxp_SurroundWorkerThread(LPVOID lpParam)
+{
+	struct dfxpSurroundWorkerType *sp_worker = (struct dfxpSurroundWorkerType *)lpParam;
+	struct dfxpSurroundPoolType *sp_pool = sp_worker->sp_pool;
+	unsigned long ul_done = 0;
+	DWORD task_index = 0;
+	HANDLE h_task;
+
+	/* Runs under the same scheduling class as the host's render thread, carries on without it if refused */
+	h_task = AvSetMmThreadCharacteristicsW(L"Pro Audio", &task_index);
+
+	for (;;)
+	{
+		int spins = 0;
+
+		while (sp_worker->request_count.load(std::memory_order_acquire) == ul_done)
+		{
+			if (sp_pool->stop.load())
+			{
+				if (h_task != NULL)
+					AvRevertMmThreadCharacteristics(h_task);
+				return(0);
+			}
+
+			if (++spins < DFXP_SURROUND_IDLE_SPIN_COUNT)
+			{
+				YieldProcessor();
+				continue;
+			}
+
+			/* Flag is set before the last check so a request made after it always sets the event */
+			sp_worker->sleeping.store(IS_TRUE);
+			if ((sp_worker->request_count.load() == ul_done) && (!sp_pool->stop.load()))
+				WaitForSingleObject(sp_worker->h_wake_event, INFINITE);
+			sp_worker->sleeping.store(IS_FALSE);
+			spins = 0;
+		}
+
+		ul_done = sp_worker->request_count.load(std::memory_order_acquire);
+
+		{
+			/* Same floating point mode as the audio thread, see realSampleDenormals.cpp */
+			CRealSampleFlushDenormals flush_denormals;
+
+			sp_worker->status = dfxp_SurroundRunGroups(sp_worker->groups, sp_worker->num_groups,
+																	 sp_worker->num_sample_sets, sp_worker->internal_rate_ratio);
+		}
+
+		sp_worker->done_count.store(ul_done);
+		if (sp_pool->waiting.load())
+			SetEvent(sp_pool->h_done_event);
+	}
+}
+
+/*
+ * FUNCTION: dfxp_SurroundPoolCreate()
+ * DESCRIPTION:
+ *   Starts one worker per core beyond the first, up to DFXP_SURROUND_MAX_WORKERS. Passes back
+ *   NULL on a single core machine or if a thread could not be started.
+ */
+static int dfxp_SurroundPoolCreate(struct dfxpSurroundPoolType **spp_pool)
+{
+	struct dfxpSurroundPoolType *sp_pool;
+	SYSTEM_INFO system_info;
+	int num_cpus;
+	int num_workers;
+	int w;
+
+	*spp_pool = NULL;
+
+	GetSystemInfo(&system_info);
+	num_cpus = (int)system_info.dwNumberOfProcessors;
+
+	num_workers = num_cpus - 1;
+	if (num_workers > DFXP_SURROUND_MAX_WORKERS)
+		num_workers = DFXP_SURROUND_MAX_WORKERS;
+	if (num_workers < 1)
+		return(OKAY);
+
+	sp_pool = new (std::nothrow) struct dfxpSurroundPoolType;
+	if (sp_pool == NULL)
+		return(NOT_OKAY);
+
+	sp_pool->num_workers = 0;
+	sp_pool->enabled.store(IS_FALSE);
+	sp_pool->stop.store(IS_FALSE);
+	sp_pool->waiting.store(IS_FALSE);
+	sp_pool->h_done_event = CreateEvent(NULL, FALSE, FALSE, NULL);
+	if (sp_pool->h_done_event == NULL)
+	{
+		delete sp_pool;
+		return(NOT_OKAY);
+	}
+
+	for (w = 0; w < num_workers; w++)
+	{
+		struct dfxpSurroundWorkerType *sp_worker = &(sp_pool->workers[w]);
+
+		sp_worker->sp_pool = sp_pool;
+		sp_worker->num_groups = 0;
+		sp_worker->status = OKAY;
+		sp_worker->request_count.store(0);
+		sp_worker->done_count.store(0);
+		sp_worker->sleeping.store(IS_FALSE);
+		sp_worker->h_thread = NULL;
+		sp_worker->h_wake_event = CreateEvent(NULL, FALSE, FALSE, NULL);
+		if (sp_worker->h_wake_event != NULL)
+			sp_worker->h_thread = CreateThread(NULL, 0, dfxp_SurroundWorkerThread, (LPVOID)sp_worker, 0, NULL);
+
+		if (sp_worker->h_thread == NULL)
+		{
+			if (sp_worker->h_wake_event != NULL)
+				CloseHandle(sp_worker->h_wake_event);
+			break;
+		}
+
+		sp_pool->num_workers++;
+	}
+
+	if (sp_pool->num_workers < num_workers)
+	{
+		dfxp_SurroundPoolStop(sp_pool);
+		return(NOT_OKAY);
+	}
+
+	*spp_pool = sp_pool;
+
+	return(OKAY);
+}
+
+/*
+ * FUNCTION: dfxp_SurroundPoolStop()
+ * DESCRIPTION:
+ *   Stops the worker threads and frees the pool.
+ */
+static int dfxp_SurroundPoolStop(struct dfxpSurroundPoolType *sp_pool)
+{
+	int w;
+
+	if (sp_pool == NULL)
+		return(OKAY);
+
+	sp_pool->stop.store(IS_TRUE);
+
+	for (w = 0; w < sp_pool->num_workers; w++)
+		SetEvent(sp_pool->workers[w].h_wake_event);
+
+	for (w = 0; w < sp_pool->num_workers; w++)
+	{
+		WaitForSingleObject(sp_pool->workers[w].h_thread, INFINITE);
+		CloseHandle(sp_pool->workers[w].h_thread);
+		CloseHandle(sp_pool->workers[w].h_wake_event);
+	}
+
+	CloseHandle(sp_pool->h_done_event);
+	delete sp_pool;
+
+	return(OKAY);
+}
+
+/*
+ * FUNCTION: dfxp_SurroundFree()
+ * DESCRIPTION:
+ *   Stops the surround workers, must be called before the com handles are freed.
+ */
+int dfxp_SurroundFree(PT_HANDLE *hp_dfxp)
+{
+	struct dfxpHdlType *cast_handle;
+	struct dfxpSurroundPoolType *sp_pool;
+
+	cast_handle = (struct dfxpHdlType *)(hp_dfxp);
+
+	if (cast_handle == NULL)
+		return(OKAY);
+
+	sp_pool = cast_handle->surround_pool.exchange(NULL);
+
+	return( dfxp_SurroundPoolStop(sp_pool) );
+}
+
+/*
+ * FUNCTION: dfxpSetParallelSurround()
+ * DESCRIPTION:
+ *
+ *  Sets whether the surround channel groups are processed in parallel on worker threads.
+ *  The workers are started the first time it is turned on and kept until dfxpQuit(), turning
+ *  it off only stops handing them buffers, so this can be called while audio is playing.
+ *  Stays off on a single core machine.
+ */
+int dfxpSetParallelSurround(PT_HANDLE *hp_dfxp, int i_parallel_on)
+{
+	struct dfxpHdlType *cast_handle;
+	struct dfxpSurroundPoolType *sp_pool;
+
+	cast_handle = (struct dfxpHdlType *)(hp_dfxp);
+
+	if (cast_handle == NULL)
+		return(OKAY);
+
+	if (cast_handle->trace.mode)
+		(cast_handle->slout1)->Message_Wide(FIRST_LINE, L"dfxpSetParallelSurround: Entered");
+
+	sp_pool = cast_handle->surround_pool.load(std::memory_order_acquire);
+
+	if (i_parallel_on && (sp_pool == NULL))
+	{
+		if (dfxp_SurroundPoolCreate(&sp_pool) != OKAY)
+			return(NOT_OKAY);
+
+		/* Written once, the release makes the started workers visible to the audio thread */
+		if (sp_pool != NULL)
+			cast_handle->surround_pool.store(sp_pool, std::memory_order_release);
+	}
+
+	if (sp_pool != NULL)
+		sp_pool->enabled.store(i_parallel_on ? IS_TRUE : IS_FALSE, std::memory_order_release);
+
+	return(OKAY);
+}
+
+/*
+ * FUNCTION: dfxpGetParallelSurround()
+ * DESCRIPTION:
+ *   Passes back whether the surround channel groups are processed on worker threads.
+ */
+int dfxpGetParallelSurround(PT_HANDLE *hp_dfxp, int *ip_parallel_on)
+{
+	struct dfxpHdlType *cast_handle;
+	struct dfxpSurroundPoolType *sp_pool;
+
+	cast_handle = (struct dfxpHdlType *)(hp_dfxp);
+
+	*ip_parallel_on = IS_FALSE;
+
+	if (cast_handle == NULL)
+		return(OKAY);
+
+	sp_pool = cast_handle->surround_pool.load(std::memory_order_acquire);
+	if (sp_pool != NULL)
+		*ip_parallel_on = sp_pool->enabled.load();
+
+	return(OKAY);
+}
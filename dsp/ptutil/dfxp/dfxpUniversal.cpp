@@ -23,6 +23,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <Windows.h>
 #include <math.h>
 #include <stdio.h>
+#include <string.h>
 
 #include "u_dfxp.h" 
 
@@ -93,11 +94,12 @@ int dfxpUniversalSetSignalFormat(PT_HANDLE *hp_dfxp, int i_bps, int i_nch, int i
 	if (cast_handle == NULL)
 		return(OKAY);
 
-	/* Check if the format has changed */  
+	/* Check if the format or the host's max block size has changed */  
 	if ((i_bps != cast_handle->universal.last_called_bps) || 
 		 (i_nch != cast_handle->universal.last_called_nch) || 
 		 (i_srate != cast_handle->universal.last_called_srate) || 
-		 (i_valid_bits != cast_handle->universal.last_called_valid_bits))
+		 (i_valid_bits != cast_handle->universal.last_called_valid_bits) ||
+		 (cast_handle->universal.max_block_sets != cast_handle->universal.last_called_max_block_sets))
 	{
 	   /* Note call is always set up for 32 bit processing since conversion is done
 		 * before and after processing calls
@@ -106,17 +108,47 @@ int dfxpUniversalSetSignalFormat(PT_HANDLE *hp_dfxp, int i_bps, int i_nch, int i
 		cast_handle->universal.last_called_nch = i_nch;
 		cast_handle->universal.last_called_srate = i_srate;
 		cast_handle->universal.last_called_valid_bits = i_valid_bits;
+		cast_handle->universal.last_called_max_block_sets = cast_handle->universal.max_block_sets;
 
 		if (dfxpBeginProcess(hp_dfxp, i_bps, i_nch, i_srate) != OKAY)
 			return(NOT_OKAY);
 
 		if (dfxpSetValidBits(hp_dfxp, i_valid_bits) != OKAY)
 			return(NOT_OKAY);
+
+		cast_handle->universal.tail_decayed_sample_sets = 0;
 	}
 
 	return(OKAY);
 }
 
+/*
+ * FUNCTION: dfxpUniversalSetMaxBlockSize()
+ * DESCRIPTION:
+ *
+ *   Sets the most sample sets the host will pass in one call, the internal sample buffers are sized
+ *   for it rather than for DAW_MAX_BUFFER_SIZE. 0 goes back to DAW_MAX_BUFFER_SIZE. Takes effect on
+ *   the next dfxpUniversalSetSignalFormat(), so call it from the same thread. A longer buffer is still
+ *   processed, in blocks of this size.
+ *
+ */
+int dfxpUniversalSetMaxBlockSize(PT_HANDLE *hp_dfxp, int i_max_sample_sets)
+{
+	struct dfxpHdlType *cast_handle;
+
+	cast_handle = (struct dfxpHdlType *)(hp_dfxp);
+
+	if (cast_handle == NULL)
+		return(OKAY);
+
+	if ((i_max_sample_sets < 0) || (i_max_sample_sets > (int)DAW_MAX_BUFFER_SIZE))
+		return(NOT_OKAY);
+
+	cast_handle->universal.max_block_sets = i_max_sample_sets;
+
+	return(OKAY);
+}
+
 /*
  * FUNCTION: dfxpUniversalModifySamples()
  * DESCRIPTION:
@@ -135,12 +167,9 @@ int dfxpUniversalModifySamples(PT_HANDLE *hp_dfxp, short int *si_input_samples,
 		return(OKAY);
 
 	realtype *r_in, *r_out;
-	int index;
 	int i;
-	int process_count;				// The number of processing loops used to process buffer
-	int leftover_sample_sets;		// The number of sample sets not processed in loop calls
 	int num_process_loop;			// The number of sample sets that will be processed per loop
-	int total_bytes_to_increment;	// Used to increment sample pointers
+	int bytes_per_sample_set;		// Used to increment sample pointers
 	int i_reorder;
 	BYTE *bp_in;						// Will be used to implement processing loops
 	BYTE *bp_out;
@@ -151,6 +180,10 @@ int dfxpUniversalModifySamples(PT_HANDLE *hp_dfxp, short int *si_input_samples,
 	int hash_index;
 	BOOL b_lean_and_mean;
 	int i_is_all_zeros;
+	int i_skip_processing;
+	int i_tail_decayed;
+	int i_ramping;
+	int i_block_sets;
 
 /*
 	if (cast_handle->trace.mode)
@@ -170,9 +203,29 @@ int dfxpUniversalModifySamples(PT_HANDLE *hp_dfxp, short int *si_input_samples,
 		b_lean_and_mean = TRUE;
 	}
 
+	/* Longer buffers are processed in blocks of the length the internal buffers were sized for */
+	i_block_sets = cast_handle->universal.block_sets;
+	if (i_block_sets <= 0)
+		i_block_sets = (int)DAW_MAX_BUFFER_SIZE;
+
 	/* Calculate the total number of bytes in the input buffer */
 	bytes_total = i_num_sample_sets * cast_handle->universal.last_called_nch *cast_handle->universal.last_called_bps / 8;
 
+	/* Powered off and the crossfade to bypass has finished, the buffer only goes through the chain's latency */
+	if ( (cast_handle->bypass_fade.bypass_all) && (cast_handle->bypass_fade.wet_pos == 0) )
+	{
+		if (dfxp_BypassDelayPassThrough(hp_dfxp, si_input_samples, si_output_samples, i_num_sample_sets) != OKAY)
+			return(NOT_OKAY);
+
+		cast_handle->universal.tail_decayed_sample_sets = 0;
+
+		/* Let any knob or EQ ramps run to their end */
+		if (dfxp_ParamRampStep(hp_dfxp, i_num_sample_sets) != OKAY)
+			return(NOT_OKAY);
+
+		return(OKAY);
+	}
+
 	i_do_not_process = IS_FALSE;
 
 	// If surround sound, set sample reorder flag
@@ -183,30 +236,56 @@ int dfxpUniversalModifySamples(PT_HANDLE *hp_dfxp, short int *si_input_samples,
 
 	// Note that dfxForWmp.cpp already forces a buffer size that works well for metering.
 	// Here we just need a protection against a buffer that is too large, we process it in chunks.
-	// Break processing into multiple calls if number of samples sets is above our desired size, but only in stereo or mono case
-	// Original calc below is thus no longer needed, kept for reference.
-	//
-	// desired_sample_set_size = (int)( (realtype)i_srate * (realtype)DFX_FOR_WMP_MAX_BUFFER_SIZE_MS * (realtype)0.001 );
-
-	if( i_num_sample_sets > (int)DAW_MAX_BUFFER_SIZE )
-	{
-		process_count = i_num_sample_sets/(int)DAW_MAX_BUFFER_SIZE;
-		leftover_sample_sets = i_num_sample_sets - (process_count * (int)DAW_MAX_BUFFER_SIZE);
-		num_process_loop = (int)DAW_MAX_BUFFER_SIZE;
-	}
-	else
-	{	// This is the case were the number of sample sets is smaller than or equal to our max size
-		process_count = 1;
-		leftover_sample_sets = 0;
-		num_process_loop = i_num_sample_sets;
-	}
+	bytes_per_sample_set = cast_handle->universal.last_called_nch * (cast_handle->universal.last_called_bps/8);
 
 	bp_in = (BYTE *)si_input_samples;
 	bp_out = (BYTE *)si_output_samples;
-	total_bytes_to_increment = num_process_loop * cast_handle->universal.last_called_nch * (cast_handle->universal.last_called_bps/8); // Calculate the pointer increment in bytes
 
-	for(i=0; i<process_count; i++)	// Loop to process sub-buffers
+	/* 
+	 * For some strange reason, some players like the windows media player continually play 
+	 * all zero (silent) buffers.  We don't want to count these buffers for the purpose of trial
+	 * version processing time limit, and once the tails of the last audible buffer have died away
+	 * there is no need to run the chain on them either.
+	 */
+	if (dfxp_UniversalIsBufferAllSilence(hp_dfxp, si_input_samples, i_num_sample_sets, 
+												  cast_handle->universal.last_called_nch, cast_handle->universal.last_called_bps, &i_is_all_zeros) != OKAY)
+		return(NOT_OKAY);
+
+	i_skip_processing = IS_FALSE;
+	if (!i_is_all_zeros)
+		cast_handle->universal.tail_decayed_sample_sets = 0;
+	else if (cast_handle->universal.tail_decayed_sample_sets >= (cast_handle->universal.last_called_srate / 1000) * DFXP_UNIVERSAL_TAIL_HOLD_MSECS)
+		i_skip_processing = IS_TRUE;
+
+	// The skipped buffer passes through unchanged, all of the filter and delay states are already below the tail floor
+	if (i_skip_processing)
+	{
+		if (si_output_samples != si_input_samples)
+			memmove(si_output_samples, si_input_samples, bytes_total);
+
+		if (dfxp_ParamRampStep(hp_dfxp, i_num_sample_sets) != OKAY)
+			return(NOT_OKAY);
+	}
+
+	for (i = 0; (!i_skip_processing) && (i < i_num_sample_sets); i += num_process_loop)	// Loop to process sub-buffers
 	{
+		num_process_loop = i_num_sample_sets - i;
+		if (num_process_loop > i_block_sets)
+			num_process_loop = i_block_sets;
+
+		/* While knobs or EQ bands are ramping the buffer is processed in short sub-blocks, with the ramps moved on before each */
+		if (dfxp_ParamRamping(hp_dfxp, &i_ramping) != OKAY)
+			return(NOT_OKAY);
+
+		if (i_ramping)
+		{
+			if (num_process_loop > DFXP_PARAM_RAMP_BLOCK_SIZE)
+				num_process_loop = DFXP_PARAM_RAMP_BLOCK_SIZE;
+
+			if (dfxp_ParamRampStep(hp_dfxp, num_process_loop) != OKAY)
+				return(NOT_OKAY);
+		}
+
 		if ( (cast_handle->universal.last_called_bps == 8) || (cast_handle->universal.last_called_bps == 16) || (cast_handle->universal.last_called_bps == 24) )
 		{
 			if (dfxpModifyShortIntSamples(hp_dfxp, (short int *)bp_in, (short int *)bp_out, num_process_loop) != OKAY)
@@ -214,40 +293,31 @@ int dfxpUniversalModifySamples(PT_HANDLE *hp_dfxp, short int *si_input_samples,
 		}
 		else if ( cast_handle->universal.last_called_bps == 32 )
 		{
-			// Real processing does processing in place, first copy output to input
+			// Real processing is done in place, so unless the caller passed the same buffer for both first copy input to output
 			r_in = (realtype *)bp_in;
 			r_out = (realtype *)bp_out;
 
-			for(index=0; index < (num_process_loop * cast_handle->universal.last_called_nch); index++)
-				r_out[index] = r_in[index];
+			if (r_out != r_in)
+				memmove(r_out, r_in, num_process_loop * cast_handle->universal.last_called_nch * sizeof(realtype));
 
 			if (dfxpModifyRealtypeSamples(hp_dfxp, r_out, num_process_loop, i_reorder) != OKAY)
 				return(NOT_OKAY);
 		}
 
-		bp_in += total_bytes_to_increment;	// Increment sample pointers
-		bp_out += total_bytes_to_increment;
+		bp_in += num_process_loop * bytes_per_sample_set;	// Increment sample pointers
+		bp_out += num_process_loop * bytes_per_sample_set;
 	}
 
-	if( leftover_sample_sets > 0 ) // If there are any leftover samples, process them
+	/* Silent input, count how long the output has stayed below the tail floor */
+	if ( (i_is_all_zeros) && (!i_skip_processing) )
 	{
-		if ( (cast_handle->universal.last_called_bps == 8) || (cast_handle->universal.last_called_bps == 16) || (cast_handle->universal.last_called_bps == 24) )
-		{
-			if (dfxpModifyShortIntSamples(hp_dfxp, (short int *)bp_in, (short int *)bp_out, leftover_sample_sets) != OKAY)
-				return(NOT_OKAY);
-		}
-		else if ( cast_handle->universal.last_called_bps == 32 )
-		{
-			// Real processing does processing in place, first copy output to input
-			r_in = (realtype *)bp_in;
-			r_out = (realtype *)bp_out;
-
-			for(index=0; index < (leftover_sample_sets * cast_handle->universal.last_called_nch); index++)
-				r_out[index] = r_in[index];
+		if (dfxp_UniversalIsTailDecayed(hp_dfxp, si_output_samples, i_num_sample_sets, &i_tail_decayed) != OKAY)
+			return(NOT_OKAY);
 
-			if (dfxpModifyRealtypeSamples(hp_dfxp, r_out, leftover_sample_sets, i_reorder) != OKAY)
-				return(NOT_OKAY);
-		}
+		if (i_tail_decayed)
+			cast_handle->universal.tail_decayed_sample_sets += i_num_sample_sets;
+		else
+			cast_handle->universal.tail_decayed_sample_sets = 0;
 	}
 
 	/* Calculate the hash for the processed buffer */
@@ -272,15 +342,6 @@ int dfxpUniversalModifySamples(PT_HANDLE *hp_dfxp, short int *si_input_samples,
 		}
 	}
 
-	/* 
-	 * For some strange reason, some players like the windows media player continually play 
-	 * all zero (silent) buffers.  We don't want to count these buffers for the purpose of trial
-	 * version processing time limit.
-	 */
-	if (dfxp_UniversalIsBufferAllSilence(hp_dfxp, si_input_samples, i_num_sample_sets, 
-												  cast_handle->universal.last_called_nch, cast_handle->universal.last_called_valid_bits, &i_is_all_zeros) != OKAY)
-		return(NOT_OKAY);
-
 	if (!i_is_all_zeros)
 	{
 		/* Update the total processed time in shared memory which will eventually be sent to the UI */
@@ -291,6 +352,30 @@ int dfxpUniversalModifySamples(PT_HANDLE *hp_dfxp, short int *si_input_samples,
 	return(OKAY);
 }
 
+/*
+ * FUNCTION: dfxpUniversalModifyFloatSamples()
+ * DESCRIPTION:
+ *
+ *   Processes a 32 bit float buffer in place, the same as calling dfxpUniversalModifySamples() with
+ *   the buffer as both input and output, which skips the copy. The signal format must be set to
+ *   32 bits per sample.
+ *
+ */
+int dfxpUniversalModifyFloatSamples(PT_HANDLE *hp_dfxp, realtype *rp_samples, int i_num_sample_sets, int i_check_for_duplicate_buffers)
+{
+	struct dfxpHdlType *cast_handle;
+
+	cast_handle = (struct dfxpHdlType *)(hp_dfxp);
+
+	if (cast_handle == NULL)
+		return(OKAY);
+
+	if (cast_handle->universal.last_called_bps != 32)
+		return(NOT_OKAY);
+
+	return( dfxpUniversalModifySamples(hp_dfxp, (short int *)rp_samples, (short int *)rp_samples, i_num_sample_sets, i_check_for_duplicate_buffers) );
+}
+
 /*
  * FUNCTION: dfxp_UniversalIsBufferAllSilence()
  * DESCRIPTION:
@@ -333,7 +418,7 @@ int dfxp_UniversalIsBufferAllSilence(PT_HANDLE *hp_dfxp, short int *si_input_sam
 		total_bytes = (i_num_bits/8) * i_max_index;
 		bytes = (BYTE *)si_input_samples;
 
-		for(i=0; i<i_max_index; i++)
+		for(i=0; i<total_bytes; i++)
 		{
 			if (bytes[i] != 0)
 			{
@@ -359,6 +444,48 @@ int dfxp_UniversalIsBufferAllSilence(PT_HANDLE *hp_dfxp, short int *si_input_sam
 	return(OKAY);
 }
 
+/*
+ * FUNCTION: dfxp_UniversalIsTailDecayed()
+ * DESCRIPTION:
+ *
+ *   Passes back whether every sample of the processed buffer is below the tail floor, DFXP_UNIVERSAL_TAIL_FLOOR.
+ *   Integer samples have to be zero, the smallest step is taken as above the floor.
+ *
+ */
+int dfxp_UniversalIsTailDecayed(PT_HANDLE *hp_dfxp, short int *si_output_samples, int i_num_sample_sets, int *ip_tail_decayed)
+{	
+	struct dfxpHdlType *cast_handle;
+
+	cast_handle = (struct dfxpHdlType *)(hp_dfxp);
+
+	if (cast_handle == NULL)
+		return(OKAY);
+
+	int i_max_index;
+	realtype *rpArray;
+	int i;
+
+	if (cast_handle->universal.last_called_bps < 32)
+		return( dfxp_UniversalIsBufferAllSilence(hp_dfxp, si_output_samples, i_num_sample_sets,
+															  cast_handle->universal.last_called_nch, cast_handle->universal.last_called_bps, ip_tail_decayed) );
+
+	*ip_tail_decayed = IS_TRUE;
+
+	i_max_index = i_num_sample_sets * cast_handle->universal.last_called_nch;
+	rpArray = (realtype *)si_output_samples;
+
+	for(i=0; i<i_max_index; i++)
+	{
+		if ( fabs(rpArray[i]) >= (realtype)DFXP_UNIVERSAL_TAIL_FLOOR )
+		{
+			*ip_tail_decayed = IS_FALSE;
+			break;
+		}
+	}
+
+	return(OKAY);
+}
+
 /*
  * FUNCTION: dfxp_UniversalUpdateTotalTimeProcessed()
  * DESCRIPTION:
@@ -18,6 +18,8 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #ifndef _U_DFXP_H_
 #define _U_DFXP_H_ 
 
+#include <atomic>
+
 #include "pt_defs.h"
 //#include "CWaveFile.h" // This must come first because it must come before any codedefs.h due to the mmgr module */
 #include "slout.h"
@@ -50,8 +52,60 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #define DAW_MAX_NUM_CHANNELS            8
 
 
-// Make buffer large enough to handle 7.1 8 channel surround sound
-#define DFXP_SAMPLE_BUFFER_SIZE (DAW_MAX_BUFFER_SIZE * 8)
+// Internal sample buffers are allocated from the signal format in dfxpBeginProcess(), for the
+// host's max block size (dfxpUniversalSetMaxBlockSize()) or DAW_MAX_BUFFER_SIZE sample sets of the
+// channel count when it gave none. The universal entry processes longer buffers in blocks of that
+// size, the processing path only checks the length with dfxp_SampleBuffersFit().
+
+// Flags for dfxp_SizeSampleBuffers(), select which internal buffers must hold the passed length
+#define DFXP_SAMPLE_BUFFER_CONVERT 0x1 // r_samples, used to convert integer buffers to realtype
+#define DFXP_SAMPLE_BUFFER_REORDER 0x2 // r_samples_reordered, used to group surround channels
+#define DFXP_SAMPLE_BUFFER_DRY 0x4     // r_samples_dry, unprocessed copy of the input during a bypass crossfade
+#define DFXP_SAMPLE_BUFFER_DELAY 0x8   // r_samples_delay, the input of the last chain latency, sized in sample sets of latency
+
+// Length of the equal power crossfade when the power (bypass all) button is toggled
+#define DFXP_BYPASS_FADE_MSECS 20
+
+// Sub-block length while a knob or EQ ramp is running, see dfxpParam.cpp
+#define DFXP_PARAM_RAMP_BLOCK_SIZE 64
+
+// Session values, each has a fixed slot in the session store, see dfxpSession.cpp
+#define DFXP_SESSION_KEY_VALUE_FIDELITY          0
+#define DFXP_SESSION_KEY_VALUE_AMBIENCE          1
+#define DFXP_SESSION_KEY_VALUE_DYNAMIC_BOOST     2
+#define DFXP_SESSION_KEY_VALUE_SURROUND          3
+#define DFXP_SESSION_KEY_VALUE_BASS_BOOST        4
+#define DFXP_SESSION_KEY_BYPASS_ALL              5
+#define DFXP_SESSION_KEY_BYPASS_FIDELITY         6
+#define DFXP_SESSION_KEY_BYPASS_AMBIENCE         7
+#define DFXP_SESSION_KEY_BYPASS_DYNAMIC_BOOST    8
+#define DFXP_SESSION_KEY_BYPASS_SURROUND         9
+#define DFXP_SESSION_KEY_BYPASS_BASS_BOOST       10
+#define DFXP_SESSION_KEY_BYPASS_HEADPHONE        11
+#define DFXP_SESSION_KEY_REMIX_BYPASS_ALL        12
+#define DFXP_SESSION_KEY_MODE_MUSIC_MODE         13
+#define DFXP_SESSION_KEY_TEMPORARY_BYPASS_ALL    14
+#define DFXP_SESSION_KEY_DFX_TUNED_TRACK_PLAYING 15
+#define DFXP_SESSION_KEY_LONGEST_BUFFER_MSECS    16
+#define DFXP_SESSION_KEY_EQ_ON                   17
+#define DFXP_SESSION_KEY_EQ_BAND_1               18 // Followed by the other EQ bands, see DFXP_SESSION_KEY_EQ_BAND()
+#define DFXP_SESSION_NUM_KEYS                    (DFXP_SESSION_KEY_EQ_BAND_1 + DFXP_GRAPHIC_EQ_NUM_BANDS)
+#define DFXP_SESSION_KEY_EQ_BAND(band_num)       (DFXP_SESSION_KEY_EQ_BAND_1 + (band_num) - 1)
+
+// Parameters whose session value has changed since they were last sent to the com handles, see dfxpCommunicateChanged()
+#define DFXP_COMM_FIDELITY      0x01
+#define DFXP_COMM_AMBIENCE      0x02
+#define DFXP_COMM_DYNAMIC_BOOST 0x04
+#define DFXP_COMM_SPACIOUSNESS  0x08
+#define DFXP_COMM_BASS_BOOST    0x10
+#define DFXP_COMM_BYPASS        0x20 // All the on/off buttons, also sends the dynamic boost and the ambience bypass
+#define DFXP_COMM_MUSIC_MODE    0x40 // Also sends fidelity, ambience, dynamic boost and bass boost
+
+// Surround channel groups found to have signal when reordered, the front pair is always processed
+#define DFXP_SURROUND_CENTER_NONZERO 0x1
+#define DFXP_SURROUND_SUB_NONZERO    0x2
+#define DFXP_SURROUND_REAR_NONZERO   0x4
+#define DFXP_SURROUND_SIDE_NONZERO   0x8
 
 #define DFXP_AURAL_CONTROL_HERTZ_MIN_VAL 500.0
 #define DFXP_AURAL_CONTROL_HERTZ_MAX_VAL 10000.0 
@@ -100,6 +154,14 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 /* Size of the array of previous buffer hash values */
 #define DFXP_UNIVERSAL_HASH_QUEUE_SIZE 10
 
+/* 
+ * Processing is skipped on silent input once the output has stayed below the tail floor (-120 dBFS)
+ * for the hold time. The hold covers the longest recirculating delay in the chain, the lex reverb loop
+ * at maximum room size, so energy still inside a delay line has had time to show in the output.
+ */
+#define DFXP_UNIVERSAL_TAIL_FLOOR 1.0e-6
+#define DFXP_UNIVERSAL_TAIL_HOLD_MSECS 1500
+
 /**************************/
 /* Structure definitions  */
 /**************************/
@@ -162,7 +224,6 @@ struct dfxp_trace_info_type {
 /* Spectrum info */
 struct dfxp_spectrum_info_type {
 	PT_HANDLE *spectrum_hdl;
-	int sample_sets_since_last_spectrum_save;
 };
 
 
@@ -180,9 +241,7 @@ struct dfxp_universal_type {
    int last_called_bps;
    int last_called_srate;
    int last_called_valid_bits;
-
-	/* For internal float buffer, MAX times 8 for 7.1 surround sound signals. */
-	realtype f_samples[DAW_MAX_BUFFER_SIZE * 8];
+   int last_called_max_block_sets;
 
 	wchar_t wcp_dfx_ui_path[PT_MAX_PATH_STRLEN]; /* C:\Program Files\DFX\dfx.exe" */
 
@@ -190,6 +249,15 @@ struct dfxp_universal_type {
 	int hash_queue_vals[DFXP_UNIVERSAL_HASH_QUEUE_SIZE];
 	int hash_queue_index;
 
+	/* Sample sets of silent input whose output has been below the tail floor */
+	int tail_decayed_sample_sets;
+
+	/* Longest buffer the host passes, from dfxpUniversalSetMaxBlockSize(), 0 when it gave none */
+	int max_block_sets;
+
+	/* Sample sets the internal buffers were last sized for by dfxpBeginProcess() */
+	int block_sets;
+
 	/* Allcaps version of fullpath to parent exe */
 	wchar_t wcp_parent_exe_path_uppercase[PT_MAX_PATH_STRLEN];
 
@@ -197,6 +265,26 @@ struct dfxp_universal_type {
 	int i_found_incompatable_website_for_processing;
 };
 
+/* Crossfade between the processed and unprocessed signal when bypass all is toggled */
+struct dfxp_bypass_fade_type {
+	int bypass_all;   /* Last communicated bypass all setting, read on the audio thread */
+	int fade_len;     /* Crossfade length in sample sets at the current sampling rate, 0 until the first buffer */
+	int wet_pos;      /* Position in the crossfade, 0 is fully bypassed and fade_len fully processed */
+	realtype step_cos; /* Rotation of the gains by one position, set with fade_len */
+	realtype step_sin;
+	int delay_sets;   /* Chain latency r_samples_delay currently holds, see dfxp_BypassDelayDry() */
+	int delay_pos;    /* Next sample set written in r_samples_delay */
+	int delay_fed;    /* Cleared by dfxpBeginProcess until r_samples_delay has been written */
+};
+
+/* Interleaved integer buffers converted straight to and from the surround channel groups */
+struct dfxp_surround_int_io_type {
+	short int *sip_in;
+	short int *sip_out;
+	int bit_width;
+	int bits_valid;
+};
+
 /**************************
  *  Main DFXP Handle Type *
  **************************/
@@ -225,15 +313,23 @@ struct dfxpHdlType {
 	long l_host_buffer_delay_msecs;
 	int processing_only;
 
-	// Buffers for internal signal manipulations
-	realtype r_samples[DFXP_SAMPLE_BUFFER_SIZE];
-	realtype r_samples_reordered[DFXP_SAMPLE_BUFFER_SIZE];
+	// Buffers for internal signal manipulations, sized by dfxp_SizeSampleBuffers()
+	realtype *r_samples;
+	realtype *r_samples_reordered;
+	realtype *r_samples_dry;
+	realtype *r_samples_delay;
+	long l_samples_len;           // Allocated length of r_samples in realtype values
+	long l_samples_reordered_len; // Allocated length of r_samples_reordered, 0 until a surround signal is seen
+	long l_samples_dry_len;       // Allocated length of r_samples_dry
+	long l_samples_delay_len;     // Allocated length of r_samples_delay
 
 
-	/* Qnt handles */
+	/* Qnt handles, shared with the other instances in the process, see dfxpQnt.cpp */
 	struct midi_to_dsp_qnt_hdls midi_to_dsp;
 	PT_HANDLE *real_to_midi_qnt_hdl;
 	PT_HANDLE *midi_to_real_qnt_hdl;
+	struct dfxpQntSetType *qnt_static_set;
+	struct dfxpQntSetType *qnt_rate_set;
 
 	/* Spectrum info */
 	struct dfxp_spectrum_info_type spectrum;
@@ -273,6 +369,12 @@ struct dfxpHdlType {
 
 	int processing_override;
 
+	/* Optimizer limits interpolated true peaks instead of sample peaks */
+	int true_peak_on;
+
+	/* Power (bypass all) crossfade state, see dfxp_BypassCrossfade() */
+	struct dfxp_bypass_fade_type bypass_fade;
+
 	/* Eq info */
 	struct dfxp_eq_info_type eq;
 
@@ -282,6 +384,9 @@ struct dfxpHdlType {
 	/* The function dfxpCommunicateAllNonFixed() can be slowed down and utilize this count (see function for details) */
 	int i_communicate_slowly_count;
 
+	/* DFXP_COMM_ flags of the parameters changed since they were last sent, set from any thread */
+	volatile LONG comm_changed;
+
 	/* Total audio processed time in the session in milliseconds */
 	unsigned long ul_total_msecs_audio_processed_time;
 
@@ -290,6 +395,16 @@ struct dfxpHdlType {
 
 	/* Settings when using the universal ui */
 	struct dfxp_universal_type universal;
+
+	/* In memory copy of the session registry values, see dfxpSession.cpp */
+	struct dfxpSessionStoreType *session_store;
+
+	/* Worker threads for the surround channel groups, see dfxpSurround.cpp. Set on the ui thread
+	 * and read by the audio thread, so published with release and loaded with acquire. */
+	std::atomic<struct dfxpSurroundPoolType *> surround_pool;
+
+	/* Knob, button and EQ changes queued for the audio thread, see dfxpParam.cpp */
+	struct dfxpParamType *param;
 };
 
 /************************ 
@@ -320,25 +435,53 @@ int dfxp_LexCommunicateDamping(PT_HANDLE *);
 int dfxp_LexCommunicateDepth(PT_HANDLE *);
 int dfxp_LexCommunicateRate(PT_HANDLE *);
 int dfxp_MaxCommunicateReleaseTime(PT_HANDLE *);
+int dfxp_MaxCommunicateTruePeak(PT_HANDLE *);
 int dfxp_WidCommunicateDispersion(PT_HANDLE *);
 int dfxp_WidCommunicateFreqThreshold(PT_HANDLE *);
 int dfxp_CommAmbienceBypass(PT_HANDLE *);
 int dfxp_CommunicateMusicMode(PT_HANDLE *);
 int dfxp_CommunicateAllFixed(PT_HANDLE *);
+int dfxp_CommunicateKnob(PT_HANDLE *, int);
+int dfxp_CommunicateButton(PT_HANDLE *, int);
+int dfxp_CommunicateSetChanged(PT_HANDLE *, LONG);
+int dfxp_CommunicateClearChanged(PT_HANDLE *, LONG);
+LONG dfxp_CommunicateKnobFlags(int);
+LONG dfxp_CommunicateButtonFlags(int);
 
 /* dfxpEq.cpp */
 int dfxp_EqInit(PT_HANDLE *);
 
 /* dfxpGet.cpp */
 int dfxp_GetKnobValue_MIDI(PT_HANDLE *, int, int *);
+int dfxp_GetKnobSessionValue_MIDI(PT_HANDLE *, int, int *);
 
 /* dfxpInit.cpp */
 int dfxp_InitFirstTimeRunFlag(PT_HANDLE *);
 
+/* dfxpParam.cpp */
+int dfxp_ParamInit(PT_HANDLE *);
+int dfxp_ParamFree(PT_HANDLE *);
+int dfxp_ParamRamping(PT_HANDLE *, int *);
+int dfxp_ParamRampStep(PT_HANDLE *, int);
+int dfxp_ParamGetKnobRamp(PT_HANDLE *, int, int *, int *);
+int dfxp_ParamGetEqRampTarget(PT_HANDLE *, int, realtype *);
+
+/* dfxpProcessReal.cpp */
+int dfxp_ModifySamples(PT_HANDLE *, realtype *, int, int, struct dfxp_surround_int_io_type *);
+int dfxp_BypassFadeUpdate(PT_HANDLE *, int, int *);
+int dfxp_BypassCrossfade(PT_HANDLE *, realtype *, realtype *, int, int);
+int dfxp_BypassDelayLatency(PT_HANDLE *, int, int *);
+int dfxp_BypassDelayFeed(PT_HANDLE *, realtype *, struct dfxp_surround_int_io_type *, int);
+int dfxp_BypassDelayDry(PT_HANDLE *, realtype *, int);
+int dfxp_BypassDelayPassThrough(PT_HANDLE *, short int *, short int *, int);
+
 /* dfxpProcess.cpp */
 int dfxp_CalcMsecsSinceLastBufferProcessed(PT_HANDLE *, int *);
 int dfxp_UpdateBufferLengthInfo(PT_HANDLE *, int, int *);
 int dfxp_StoreLongestBufferSize(PT_HANDLE *, int);
+int dfxp_SizeSampleBuffers(PT_HANDLE *, int, int);
+int dfxp_SampleBuffersFit(PT_HANDLE *, int, int);
+int dfxp_FreeSampleBuffers(PT_HANDLE *);
 
 /* dfxpProcessClear.cpp */
 int dfxp_ClearBuffersIfSongStart(PT_HANDLE *);
@@ -347,12 +490,7 @@ int dfxp_ClearBuffersIfSongStart(PT_HANDLE *);
 int dfxp_InitAllQnts(PT_HANDLE *);
 int dfxp_InitStaticQnts(PT_HANDLE *);
 int dfxp_InitDynamicQnts(PT_HANDLE *);
-int dfxp_InitDynamicQnts_Aural(PT_HANDLE *);
-int dfxp_InitDynamicQnts_Lex(PT_HANDLE *);
-int dfxp_InitDynamicQnts_Opt(PT_HANDLE *);
-int dfxp_InitDynamicQnts_Wid(PT_HANDLE *);
-int dfxp_InitDynamicQnts_Play(PT_HANDLE *);
-int dfxp_InitDynamicQnts_Delay(PT_HANDLE *);
+int dfxp_FreeAllQnts(PT_HANDLE *);
 
 /* dfxpQuit.cpp */
 int dfxp_FreeAll(PT_HANDLE *);
@@ -365,21 +503,40 @@ int dfxp_RegistryGetDfxUniversalUiFullpath(PT_HANDLE *, wchar_t *);
 
 
 /* dfxpSession.cpp */
-int dfxp_SessionWriteIntegerValue(PT_HANDLE *, wchar_t *, int);
-int dfxp_SessionReadIntegerValue(PT_HANDLE *, wchar_t *, int, int *);
-int dfxp_SessionWriteRealValue(PT_HANDLE *, wchar_t *, realtype);
-int dfxp_SessionReadRealValue(PT_HANDLE *, wchar_t *, realtype, realtype *);
+int dfxp_SessionWriteIntegerValue(PT_HANDLE *, int, int);
+int dfxp_SessionReadIntegerValue(PT_HANDLE *, int, int, int *);
+int dfxp_SessionWriteRealValue(PT_HANDLE *, int, realtype);
+int dfxp_SessionReadRealValue(PT_HANDLE *, int, realtype, realtype *);
+int dfxp_SessionStoreInit(PT_HANDLE *);
+int dfxp_SessionStoreFree(PT_HANDLE *);
+int dfxp_SessionStoreFlush(PT_HANDLE *);
+int dfxp_SessionStoreWriteInteger(PT_HANDLE *, int, int);
+int dfxp_SessionStoreWriteReal(PT_HANDLE *, int, realtype);
+int dfxp_SessionStoreReadInteger(PT_HANDLE *, int, int, int *);
+int dfxp_SessionStoreReadReal(PT_HANDLE *, int, realtype, realtype *);
+
 int dfxp_CalcHowManyTimesRun(PT_HANDLE *, int *);
 int dfxp_CheckIfFirstTimeRun(PT_HANDLE *, int *);
 
+/* dfxpSurround.cpp */
+int dfxp_SurroundScatter(PT_HANDLE *, realtype *, int, realtype *, int *);
+int dfxp_SurroundScatterInt(PT_HANDLE *, struct dfxp_surround_int_io_type *, int, realtype *, int *);
+int dfxp_SurroundGather(PT_HANDLE *, realtype *, int, realtype *);
+int dfxp_SurroundGatherInt(PT_HANDLE *, realtype *, int, struct dfxp_surround_int_io_type *);
+int dfxp_SurroundProcessGroups(PT_HANDLE *, realtype *, int, int);
+int dfxp_SurroundFree(PT_HANDLE *);
+
 /* dfxpSet.cpp */
 int dfxp_SetKnobValue_MIDI(PT_HANDLE *, int, int, bool);
+int dfxp_SessionWriteKnobValue_MIDI(PT_HANDLE *, int, int);
+int dfxp_CalcBassBoostEqBand1(PT_HANDLE *, int, realtype *);
+int dfxp_SessionWriteButtonValue(PT_HANDLE *, int, int);
 int dfxpConvertIntToFaderRealValue(PT_HANDLE *, int, realtype *);
 int dfxp_DfxForWmpSetEnabledBasedOnBypass(PT_HANDLE *);
 
 /* dfxpSpectrum.cpp */
 int dfxp_SpectrumInit(PT_HANDLE *);
-int dfxp_SpectrumStoreCurrentValuesInSharedMemory(PT_HANDLE *, int);
+int dfxp_SpectrumStoreCurrentValuesInSharedMemory(PT_HANDLE *, realtype *, int);
 
 
 /* dfxpUniversal.cpp */
@@ -389,6 +546,7 @@ int dfxp_UniversalCheckIfIncompatableWebsiteForProcessing(PT_HANDLE *, int *);
 BOOL CALLBACK dfxp_UniversalEnumWindowsProc(HWND, LPARAM);
 int dfxp_UniversalUpdateTotalTimeProcessed(PT_HANDLE *, int);
 int dfxp_UniversalIsBufferAllSilence(PT_HANDLE *, short int *, int, int, int, int *);
+int dfxp_UniversalIsTailDecayed(PT_HANDLE *, short int *, int, int *);
 
 
 
@@ -21,7 +21,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "codedefs.h"
 
 /* Defines */
-#define BINAURAL_SYN_MAX_SAMP_FREQ 48000
+#define BINAURAL_SYN_MAX_SAMP_FREQ 192000
 #define BINAURAL_SYN_MIN_SAMP_FREQ 32000
 #define BINAURAL_SYN_DEFAULT_SAMP_FREQ 44100
 #define BINAURAL_SYN_MAX_NUM_COEFFS 512
@@ -34,6 +34,13 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #define BINAURAL_SYN_COEFF_SAMP_RATE_44_1 0
 #define BINAURAL_SYN_COEFF_SAMP_RATE_48	1
 
+/* Processing modes for BinauralSynSetProcessingMode() */
+#define BINAURAL_SYN_MODE_DIRECT      0	// Per sample direct convolution, kept as the reference
+#define BINAURAL_SYN_MODE_PARTITIONED 1	// Zero latency partitioned fft convolution, the default
+
+/* Largest hrir wav file read by the BinauralSynLoad functions */
+#define BINAURAL_SYN_HRIR_MAX_FILE_BYTES (16 * 1024 * 1024)
+
 /* BinauralSynInit.cpp */
 int PT_DECLSPEC BinauralSynNew(PT_HANDLE **hpp_BinauralSyn, int i_num_coeffs);
 int PT_DECLSPEC BinauralSynFreeUp(PT_HANDLE **hpp_BinauralSyn);
@@ -41,6 +48,14 @@ int PT_DECLSPEC BinauralSynFreeUp(PT_HANDLE **hpp_BinauralSyn);
 /* BinauralSynSet.cpp */
 int PT_DECLSPEC BinauralSynSetCoeffs(PT_HANDLE *hp_BinauralSyn, int i_channels_to_set, realtype *rp_coeff_pairs, int i_num_coeffs, int i_samp_rate_flag);
 int PT_DECLSPEC BinauralSynSetMemoryToZero(PT_HANDLE *hp_BinauralSyn);
+int PT_DECLSPEC BinauralSynSetProcessingMode(PT_HANDLE *hp_BinauralSyn, int i_mode);
+int PT_DECLSPEC BinauralSynSetSampFreq(PT_HANDLE *hp_BinauralSyn, int i_samp_freq);
+
+/* BinauralSynLoad.cpp */
+int PT_DECLSPEC BinauralSynSetCacheFolder(PT_HANDLE *hp_BinauralSyn, wchar_t *wcp_folder);
+int PT_DECLSPEC BinauralSynLoadHrirFile(PT_HANDLE *hp_BinauralSyn, wchar_t *wcp_file);
+int PT_DECLSPEC BinauralSynLoadHrirPositionFiles(PT_HANDLE *hp_BinauralSyn, wchar_t *wcp_front_file, wchar_t *wcp_rear_file, wchar_t *wcp_side_file);
+int PT_DECLSPEC BinauralSynUseBuiltInHrirs(PT_HANDLE *hp_BinauralSyn);
 
 /* BinauralSynGet.cpp */
 int PT_DECLSPEC BinauralSynGetNumCoeffs(PT_HANDLE *hp_BinauralSyn, int *ip_num_coeffs);
@@ -20,6 +20,9 @@
 #define PWAV_MIN_BUFFER_SIZE 2048
 #define PWAV_MAX_BUFFER_SIZE 10666
 
+/* The reader/player and IO functions are built on mmio and waveIn/waveOut, so they are left out of the non-Windows (__ANDROID__) builds */
+#ifndef __ANDROID__
+
 /* pwav.cpp */
 int PT_DECLSPEC pwavNew(PT_HANDLE **, CSlout *, long, DWORD, int); 
 int PT_DECLSPEC pwavResetBufferSize(PT_HANDLE *, long, int);
@@ -34,6 +37,8 @@ int PT_DECLSPEC pwavCheckLegalFiles(PT_HANDLE *, wchar_t *, wchar_t *, int, int
 int PT_DECLSPEC pwavFreeUp(PT_HANDLE **);
 int PT_DECLSPEC pwavDump(PT_HANDLE *); 
 
+#endif //__ANDROID__
+
 /* pwavConvert.cpp */
 int PT_DECLSPEC pwav24BitToFloat(char *cp_24_bit, realtype *rp_float,
 							int i_length, int i_stereo_flag);
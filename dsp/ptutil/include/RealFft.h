@@ -0,0 +1,44 @@
+/*
+FxSound
+Copyright (C) 2025  FxSound LLC
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef _REAL_FFT_H_
+#define _REAL_FFT_H_
+
+#include "codedefs.h"
+
+/* Defines */
+#define REAL_FFT_MIN_SIZE 8
+#define REAL_FFT_MAX_SIZE 65536
+
+/*
+ * Spectra are stored split, as separate real and imaginary arrays of size/2 + 1 bins each,
+ * bin 0 is dc and bin size/2 is the nyquist frequency.
+ * The inverse transform is unscaled, a forward and inverse pass returns the input times size.
+ */
+
+/* RealFftInit.cpp */
+int PT_DECLSPEC RealFftNew(PT_HANDLE **hpp_RealFft, int i_size);
+int PT_DECLSPEC RealFftFreeUp(PT_HANDLE **hpp_RealFft);
+int PT_DECLSPEC RealFftGetSize(PT_HANDLE *hp_RealFft, int *ip_size);
+
+/* RealFftProcess.cpp */
+int PT_DECLSPEC RealFftForward(PT_HANDLE *hp_RealFft, realtype *rp_in, realtype *rp_re, realtype *rp_im);
+int PT_DECLSPEC RealFftInverse(PT_HANDLE *hp_RealFft, realtype *rp_re, realtype *rp_im, realtype *rp_out);
+int PT_DECLSPEC RealFftMultiplyAccumulate_NoHandle(realtype *rp_a_re, realtype *rp_a_im, realtype *rp_b_re, realtype *rp_b_im,
+							realtype *rp_acc_re, realtype *rp_acc_im, int i_num_bins);
+
+#endif //_REAL_FFT_H_
@@ -79,7 +79,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #define DSPS_SOFT_MEM_AUTO_PITCH_LENGTH (32768 * 2)
 #define DSPS_SOFT_MEM_MULTI_COMP_LENGTH (32768 * 2)
 #define DSPS_SOFT_MEM_AURAL_ENHANCER_LENGTH 0
-#define DSPS_SOFT_MEM_MAXIMIZER_LENGTH 0
+#define DSPS_SOFT_MEM_MAXIMIZER_LENGTH 1024 /* Holds struct dspMaxiLimiterType */
 #define DSPS_SOFT_MEM_APIT_LENGTH (32768 * 2)
 #define DSPS_SOFT_MEM_COMP_LENGTH 0
 
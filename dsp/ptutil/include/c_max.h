@@ -32,6 +32,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #define MAXIMIZE_DITHER_NAME_ABRIVIATED_3 "Shaped"
 
 #define MAXIMIZE_NOISE_SEED 10322234L
+#define MAXIMIZE_STATE_NOISE_SEED 0 /* Index of the dither noise seed in the state array */
 
 /* Constants */
 /* Used to set both display values and to set DSP qnt handle. */
@@ -48,6 +49,16 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #define MAXI_ENVELOPE_BIAS 1.0e-24 /* Bias on envelope to avoid under flow */
 #define MAXI_LOOK_AHEAD_DELAY 0.00075 /* Look ahead delay */
 
+/* Look ahead window is the delay plus the sample entering it */
+#define MAXI_MAX_WINDOW_LEN (MAXI_MAX_DELAY_LEN + 1)
+/* Number of samples between auto gain boost updates */
+#define MAXI_GAIN_BOOST_UPDATE_LEN 16
+
+/* True peak detection, ITU-R BS.1770 style 4x polyphase interpolation of the boosted input */
+#define MAXI_TRUE_PEAK_OVERSAMPLE 4 /* Interpolated points per input sample */
+#define MAXI_TRUE_PEAK_TAPS 12      /* Taps per polyphase branch */
+#define MAXI_TRUE_PEAK_LATENCY 6    /* Delay added in true peak mode, centers the interpolator */
+
 /* Targeted boosted output level */
 /* #define MAXIMIZE_TARGET_LEVEL_SETTING 0.32 */
 #define MAXIMIZE_TARGET_LEVEL_SETTING 0.32
@@ -96,20 +107,13 @@ struct dspMaxiStructType
 	int quantize_on_flag;
 	/* Added for auto mode, the max desired boosted output level */
 	realtype target_level;
+	/* Detect peaks between samples too, adds MAXI_TRUE_PEAK_LATENCY samples of delay */
+	int true_peak_on_flag;
 
 	/* Algorithm state variables */
-	float dly_start_l[MAXI_MAX_DELAY_LEN];
-	float dly_start_r[MAXI_MAX_DELAY_LEN];
-	float *ptr_l;
-	float *ptr_r;
-	float max_abs_l;
-	float max_abs_r;
-	float delta_l;
-	float delta_r;
-	float env_l;
-	float env_r;
-	int ramp_count_l;
-	int ramp_count_r;
+	/* Look ahead delay lines and envelopes are in struct dspMaxiLimiterType
+	 * in the maximizer memory space.
+	 */
 	float noise1_old;
 	float noise2_old;
 	/* New variables for auto mode */
@@ -126,6 +130,34 @@ struct dspMaxiStructType
 
 };
 
+/* Look ahead limiter working memory, overlays fp_memory.
+ * The envelope is the moving average over the look ahead window of the
+ * released window peak, which ramps it linearly up to each peak by the
+ * time that peak leaves the delay line. Window peaks use the van Herk/Gil-Werman
+ * method: time is cut into window length blocks, and the peak is the larger
+ * of the current block's running max and the previous block's suffix max.
+ * Left and right are interleaved so a channel pair runs in one SIMD register.
+ */
+struct dspMaxiLimiterType
+{
+	float dly[MAXI_MAX_DELAY_LEN][2];   /* Boosted input look ahead delay lines */
+	float hold[MAXI_MAX_WINDOW_LEN][2]; /* Released window peaks being averaged */
+	float suffix_max[MAXI_MAX_WINDOW_LEN + 1][2]; /* Previous block suffix maxes, zero last entry. Passed
+												   * entries hold the current block's abs values.
+												   */
+	float hold_sum[2];  /* Running sums of hold[], resummed every block */
+	float block_max[2]; /* Max abs values of the current block so far */
+	float held[2];      /* Last released window peaks */
+	float true_peak_hist[2 * MAXI_TRUE_PEAK_TAPS][2]; /* Interpolator input, written twice so the taps never wrap */
+	float gain_boost;
+	long dly_index;
+	long hold_index;    /* Position in both hold[] and the current peak block */
+	long window_len;    /* Window the history was built for, 0 to rebuild */
+	long boost_count;   /* Samples left before the next gain boost update */
+	long true_peak_index;
+	long true_peak_on;  /* Mode the interpolator history was built for */
+};
+
 /* Algorithm specific parameters */
 #define MAXIMIZE_GAIN_BOOST        20L + COMM_MEM_OFFSET
 #define MAXIMIZE_MAX_OUTPUT        21L + COMM_MEM_OFFSET
@@ -135,5 +167,6 @@ struct dspMaxiStructType
 #define MAXIMIZE_MAX_DELAY         25L + COMM_MEM_OFFSET
 #define MAXIMIZE_QUANTIZE_ON       26L + COMM_MEM_OFFSET
 #define MAXIMIZE_TARGET_LEVEL      27L + COMM_MEM_OFFSET
+#define MAXIMIZE_TRUE_PEAK_ON      28L + COMM_MEM_OFFSET
 
 #endif /* _C_MAX_H_ */
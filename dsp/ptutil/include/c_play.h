@@ -74,6 +74,13 @@ void play32_no_filt(realtype *xv, realtype *yv, realtype in, realtype *in_bs);
 #define DSP_PLAY_DELAY_PARAM_OFFSET			(3 * DSPS_MAX_NUM_PARAMS * 2)
 #define DSP_PLAY_OPTIMIZER_PARAM_OFFSET	(4 * DSPS_MAX_NUM_PARAMS * 2)
 
+/* Offset into the handle's state array for the vocal eliminator filter histories.
+ * Placed after the state blocks used by the aural, lex, widener, delay and maximizer
+ * sub-functions so every handle carries its own copy (previously file statics).
+ */
+#define DSP_PLAY_VOCAL_ELIM_STATE_OFFSET	(5 * DSPS_NUM_STATE_VARS)
+#define DSP_PLAY_VOCAL_ELIM_NUM_TAPS		9 /* 8th order filters, NZEROS+1 */
+
 /* Used to transfer stereo mode to all dsp parameter sets */
 #define DSP_PLAY_STEREO_MODE_INDEX 4
 
@@ -346,4 +353,17 @@ struct dspPlayStructType
 	realtype delay_lines;
 };
 
+/* Vocal eliminator filter histories, stored in the state array at DSP_PLAY_VOCAL_ELIM_STATE_OFFSET */
+struct dspPlayVocalElimStateType
+{
+	realtype xv_bs1[DSP_PLAY_VOCAL_ELIM_NUM_TAPS];
+	realtype yv_bs1[DSP_PLAY_VOCAL_ELIM_NUM_TAPS];
+	realtype xv_bs2[DSP_PLAY_VOCAL_ELIM_NUM_TAPS];
+	realtype yv_bs2[DSP_PLAY_VOCAL_ELIM_NUM_TAPS];
+	realtype xv_bp1[DSP_PLAY_VOCAL_ELIM_NUM_TAPS];
+	realtype yv_bp1[DSP_PLAY_VOCAL_ELIM_NUM_TAPS];
+	realtype xv_bp2[DSP_PLAY_VOCAL_ELIM_NUM_TAPS];
+	realtype yv_bp2[DSP_PLAY_VOCAL_ELIM_NUM_TAPS];
+};
+
 #endif /* _C_PLAY_H_ */
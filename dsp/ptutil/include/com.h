@@ -117,6 +117,12 @@ int PT_DECLSPEC comProcessBuffer(PT_HANDLE *hp_com, long *lp_data, long l_length
                          int i_stereo_in_mode, int i_stereo_out_mode,
 								 int i_buffer_type);
 
+/* comResample.cpp */
+int PT_DECLSPEC comResampleDown(PT_HANDLE *, float *, long, int, int, long *);
+int PT_DECLSPEC comResampleUp(PT_HANDLE *, float *, long, int, int, long);
+int PT_DECLSPEC comResampleReset(PT_HANDLE *);
+int PT_DECLSPEC comGetResampleLatency(int, int *);
+
 /* comMem.cpp */
 int PT_DECLSPEC comMemReInitialize(PT_HANDLE *hp_com, realtype r_sampling_freq);
 int PT_DECLSPEC comCheckOutProcessor(char *cp_dsp_function, int i_checkout_flag, int *ip_processor_num);
@@ -21,9 +21,14 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "dfxpDefs.h"
 #include "slout.h"
 
+/* dfxpBinaural */
+int dfxpBinauralLoadHrirSet(PT_HANDLE *, wchar_t *);
+int dfxpBinauralLoadHrirPositionSet(PT_HANDLE *, wchar_t *, wchar_t *, wchar_t *);
+
 /* dfxpComm.cpp */
 int dfxpCommunicateAll(PT_HANDLE *);
 int dfxpCommunicateAllNonFixed(PT_HANDLE *, int);
+int dfxpCommunicateChanged(PT_HANDLE *);
 
 /* dfxpEq */
 int dfxpEqSetProcessingOn(PT_HANDLE *, int, int);
@@ -47,10 +52,21 @@ int dfxpGetTemporaryBypassAll(PT_HANDLE *, int *);
 int dfxpGetDfxTunedTrackPlaying(PT_HANDLE *, int *);
 int dfxpSetDfxTunedTrackPlaying(PT_HANDLE *, int);
 int dfxpGetTotalAudioProcessedTime(PT_HANDLE *, unsigned long *);
+int dfxpGetTruePeakOn(PT_HANDLE *, int *);
+int dfxpGetOptimizerLatency(PT_HANDLE *, int *);
 
 /* dfxpInit */
 int dfxpInit(PT_HANDLE **, wchar_t *, int, int, int, int, int, long, int, int, int, CSlout *);
 
+/* dfxpParam */
+int dfxpParamSetKnobValue(PT_HANDLE *, int, float);
+int dfxpParamSetButtonValue(PT_HANDLE *, int, int);
+int dfxpParamSetEqBandBoostCut(PT_HANDLE *, int, realtype);
+int dfxpParamSetEqBandFrequency(PT_HANDLE *, int, realtype);
+int dfxpParamDrain(PT_HANDLE *);
+int dfxpParamRampEqBandBoostCut(PT_HANDLE *, int, realtype);
+int dfxpParamRampKnobValue(PT_HANDLE *, int, float);
+
 /* dfxpProcess */
 int dfxpSetValidBits(PT_HANDLE *, int);
 int dfxpModifyRealtypeSamples(PT_HANDLE *, realtype *, int, int);
@@ -64,6 +80,13 @@ int dfxpGetInstallationDate(PT_HANDLE *, long *, int *);
 int dfxpGetLastUsedDate(PT_HANDLE *, long *, int *);
 int dfxpGetInstallationDate_NoHandle(wchar_t *, int, long *, int *);
 
+/* dfxpSession */
+int dfxpGetSessionGeneration(PT_HANDLE *, unsigned long *);
+
+/* dfxpSurround */
+int dfxpSetParallelSurround(PT_HANDLE *, int);
+int dfxpGetParallelSurround(PT_HANDLE *, int *);
+
 /* dfxpSet */
 int dfxpSetKnobValue(PT_HANDLE *, int, float, bool);
 int dfxpSetButtonValue(PT_HANDLE *, int, int);
@@ -71,6 +94,7 @@ int dfxpConvertFaderRealValueToInt(PT_HANDLE *, realtype, int *, int);
 int dfxpSetProcessingOverride(PT_HANDLE *, int);
 int dfxpSetTemporaryBypassAll(PT_HANDLE *, int);
 int dfxpSetTotalAudioProcessedTime(PT_HANDLE *, unsigned long);
+int dfxpSetTruePeakOn(PT_HANDLE *, int);
 
 /* dfxpSharedMemory */
 int dfxpSharedMemorySetFlag(PT_HANDLE *, int, int);
@@ -81,12 +105,15 @@ int dfxpSharedMemoryStoreCurrentSpectrumValues_FromArray(PT_HANDLE *, realtype *
 /* dfxpSpectrum */
 int dfxpSpectrumSendClearValues(PT_HANDLE *);
 int dfxpSpectrumGetBandValues(PT_HANDLE *, realtype *, int);
+int dfxpSpectrumSetNumBands(PT_HANDLE *, int);
 
 
 /* dfxpUniversal */
 int dfxpUniversalInit(PT_HANDLE **, long, int, CSlout *);
 int dfxpUniversalSetSignalFormat(PT_HANDLE *, int, int, int, int);
+int dfxpUniversalSetMaxBlockSize(PT_HANDLE *, int);
 int dfxpUniversalModifySamples(PT_HANDLE *, short int *, short int *, int, int);
+int dfxpUniversalModifyFloatSamples(PT_HANDLE *, realtype *, int, int);
 int dfxpUniversalCheckParentCompatibility(PT_HANDLE *, int, int *);
 
 #endif //_DFXP_H_
\ No newline at end of file
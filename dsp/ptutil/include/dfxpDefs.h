@@ -151,16 +151,8 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #define DFXP_SPECTRUM_NUM_BANDS						10
 #define DFXP_SPECTRUM_NUM_VALUES						40
 
-/* Number of samples per each save of the spectrum to the registry */
-/* Note - up to DFX release 9.204, this was set at 512 */
-/* It was raised to 1024 to reduce the number of registry writes required */
-#define DFXP_SAMPLE_SETS_PER_SAVE_SPECTRUM 1024
-
 /* 
- * This number should be based on the DFXP_SAMPLE_SETS_PER_SAVE_SPECTRUM using 
- * roughly the following formula:
- * refresh in ms = (num_sample_sets * 1000 ) / 44100.0 = num_sample_sets/44.1 ms
- *
+ * Period at which the filter bank spectrum publishes a new set of band values.
  * Note: We don't want to refesh faster than 40 msec
  */
 #define DFXP_SPECTRUM_REFRESH_RATE_MSECS		40
@@ -168,10 +168,16 @@ else\
 
 /* PC DFX software version  */
 /* Only need to handle 32 bit float case. */
+/* The stereo flag can only change between buffers, so the kernel latches it
+ * into its stereo_in_dma local with dutilLoadStereoFlag() before the sample loop.
+ */
 #if defined(DSPSOFT_TARGET)
 #if (PT_DSP_BUILD == PT_DSP_DFX)
+#define dutilLoadStereoFlag() \
+stereo_in_dma = *(volatile long *)(DSP_STEREO_IN_FLAG);
+
 #define dutilGetInputsAndMeter(in1, in2, status)\
-if( *(volatile long *)(DSP_STEREO_IN_FLAG) )\
+if( stereo_in_dma )\
 {\
   in1 = ((float *)read_in_buf)[data_index];\
   in2 = ((float *)read_in_buf)[data_index + 1];\
@@ -183,6 +189,11 @@ else\
 #endif
 #endif /* DSPSOFT_TARGET, DFX CASE */
 
+/* Other versions read the stereo flag every sample */
+#ifndef dutilLoadStereoFlag
+#define dutilLoadStereoFlag() ;
+#endif
+
 #ifdef DUIO_BA
 /* Pure buffered signal in, analog out version (sound card, wave process direct)
  * Input read is done to sync to A/D clock
@@ -413,7 +424,7 @@ else\
 /* Note that we only need to handle 32 float case. */
 #if defined(DSPSOFT_TARGET) & (PT_DSP_BUILD == PT_DSP_DFX)
 #define dutilPutOutputsAndMeter(r_val1, r_val2, status)\
-if( *(volatile long *)(DSP_STEREO_IN_FLAG) )\
+if( stereo_in_dma )\
 {\
 	 ((float *)read_out_buf)[data_index++] = r_val1;\
 	 ((float *)read_out_buf)[data_index++] = r_val2;\
@@ -208,6 +208,13 @@
 	  r_right_out *= *(volatile float *)(rp_wet); \
 	  r_left_out  += *(volatile float *)(rp_dry) * r_left_dry; \
 	  r_right_out += *(volatile float *)(rp_dry) * r_right_dry;
+/* Same as above, with the gains already loaded into locals once per buffer */
+#define kerWetDryGains(r_left_dry, r_right_dry, r_wet, r_dry, \
+								r_left_out, r_right_out) \
+	  r_left_out  *= r_wet; \
+	  r_right_out *= r_wet; \
+	  r_left_out  += r_dry * r_left_dry; \
+	  r_right_out += r_dry * r_right_dry;
 
 /*
  * MACRO: kerFilteredFdbkDelay
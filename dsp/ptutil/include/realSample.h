@@ -37,6 +37,11 @@ int PT_DECLSPEC realSampleCopy(PT_HANDLE *, PT_HANDLE **);
 /* realSampleForceLegalValues.cpp */
 int PT_DECLSPEC realSampleForceLegalValues_ArrayOnly(realtype *, long);
 
+/* realSampleDenormals.cpp */
+int PT_DECLSPEC realSampleFlushDenormalsBegin(unsigned int *);
+int PT_DECLSPEC realSampleFlushDenormalsEnd(unsigned int);
+int PT_DECLSPEC realSampleSetFlushDenormals(int);
+
 /* realSampleGet.cpp */
 int PT_DECLSPEC realSampleGetAttributes(PT_HANDLE *, int *, long *);
 int PT_DECLSPEC realSampleGetSampleSegment(PT_HANDLE *, realtype **, long *);
@@ -65,4 +70,21 @@ int PT_DECLSPEC realSampleConvertRate(PT_HANDLE *, long);
 int PT_DECLSPEC realSampleSpecialRemixScaleOriginal_NoHandle(realtype *, int, realtype, realtype);
 int PT_DECLSPEC realSampleSpecialRemixScaledSumBeats_NoHandle(realtype *, int, realtype *, int, realtype, realtype, realtype);
 
+/*
+ * Scoped FTZ/DAZ mode for a processing call, the caller's mode is restored when it goes
+ * out of scope so every return path is covered.
+ */
+class CRealSampleFlushDenormals
+{
+public:
+	CRealSampleFlushDenormals() { realSampleFlushDenormalsBegin(&saved_mode); }
+	~CRealSampleFlushDenormals() { realSampleFlushDenormalsEnd(saved_mode); }
+
+private:
+	CRealSampleFlushDenormals(const CRealSampleFlushDenormals &);
+	CRealSampleFlushDenormals &operator=(const CRealSampleFlushDenormals &);
+
+	unsigned int saved_mode;
+};
+
 #endif //_REALSAMPLE_H_
\ No newline at end of file
@@ -29,6 +29,11 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #define SOS_PARA  1
 #define SOS_SHELF SOS_GENERIC
 
+/* Instruction set levels for the processing functions */
+#define SOS_SIMD_NONE 0
+#define SOS_SIMD_SSE2 1
+#define SOS_SIMD_AVX  2
+
 /* sos.cpp */
 int PT_DECLSPEC sosNew(PT_HANDLE **, CSlout *, int);
 int PT_DECLSPEC sosFreeUp(PT_HANDLE **);
@@ -66,4 +71,8 @@ int PT_DECLSPEC sosProcessBuffer(PT_HANDLE *hp_sos, realtype *rp_in_buf, realtyp
 int PT_DECLSPEC sosProcessBufferNoBias(PT_HANDLE *hp_sos, realtype *rp_in_buf, realtype *rp_out_buf, int i_num_sample_sets, int i_num_channels);
 int PT_DECLSPEC sosProcessSurroundBuffer(PT_HANDLE *hp_sos, realtype *rp_in_buf, realtype *rp_out_buf, int i_num_sample_sets, int i_num_channels);
 
+/* sosProcessSimd.cpp */
+int PT_DECLSPEC sosSetMaxSimdLevel(int i_level);
+int PT_DECLSPEC sosGetSimdLevel(int *ip_level);
+
 #endif //_SOS_H
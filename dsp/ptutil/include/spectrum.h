@@ -24,6 +24,14 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #define SPECTRUM_MAX_NUM_BANDS 10
 
+/* Analysis modes for spectrumSetMode() */
+#define SPECTRUM_MODE_FILTER_BANK 0	// spectrumProcess() runs a resonant filter per band, SPECTRUM_MAX_NUM_BANDS bands
+#define SPECTRUM_MODE_FFT         1	// spectrumProcess() only stores samples, spectrumAnalyze() does an fft
+
+// Band count range in SPECTRUM_MODE_FFT, ex. 10, 31 or 64
+#define SPECTRUM_FFT_MIN_NUM_BANDS 1
+#define SPECTRUM_FFT_MAX_NUM_BANDS 64
+
 // For warping relative band sensitivities
 #define SPECTRUM_BAND_1_WARP  0.6
 #define SPECTRUM_BAND_2_WARP  0.6
@@ -62,8 +70,12 @@ int PT_DECLSPEC spectrumFreeUp(PT_HANDLE **hpp_spectrum);
 /* spectrumProcess.cpp */
 int PT_DECLSPEC spectrumProcess(PT_HANDLE *, realtype *,	int, int, realtype, int);
 
+/* spectrumFft.cpp */
+int PT_DECLSPEC spectrumAnalyze(PT_HANDLE *);
+
 /* spectrumGet.cpp */
 int PT_DECLSPEC spectrumGetBandValues(PT_HANDLE *, realtype *,	int);
+int PT_DECLSPEC spectrumGetNumBands(PT_HANDLE *, int *);
 
 /* spectrumMessageValues.cpp */
 int PT_DECLSPEC spectrumGetMessageValuesFromBandValues_NoHandle(realtype *, int, WPARAM *, LPARAM *);
@@ -74,5 +86,6 @@ int PT_DECLSPEC spectrumSetBandValuesFromMessageValues_NoHandle(WPARAM, LPARAM,
 int PT_DECLSPEC spectrumSetTimeConstant(PT_HANDLE *, realtype);
 int PT_DECLSPEC spectrumSetSensitivity(PT_HANDLE *, realtype);
 int PT_DECLSPEC spectrumSetDelay(PT_HANDLE *, realtype);
+int PT_DECLSPEC spectrumSetMode(PT_HANDLE *, int, int);
 
 #endif /* _SPECTRUM_H_*/
@@ -0,0 +1,137 @@
+/*
+FxSound
+Copyright (C) 2025  FxSound LLC
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+ * Flush to zero (FTZ) and denormals are zero (DAZ) handling for the processing calls.
+ *
+ * Recursive filters and reverb tails decay into the denormal range once the input goes
+ * silent, and every operation on a denormal costs the cpu a microcode assist. The mode bits
+ * are per thread, so they are set on entry to each processing call and the caller's mode
+ * restored on exit, which keeps the host's own floating point behaviour untouched.
+ */
+
+/* Standard includes */
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "codedefs.h"
+#include "slout.h"
+#include "u_realSample.h"
+#include "realSample.h"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define REALSAMPLE_DENORMALS_X86
+#endif
+
+#ifdef REALSAMPLE_DENORMALS_X86
+#include <xmmintrin.h>
+
+/* MXCSR mode bits */
+#define REALSAMPLE_MXCSR_FTZ 0x8000
+#define REALSAMPLE_MXCSR_DAZ 0x0040
+#endif
+
+/* Mode bits to set on entry, 0 until first queried */
+static unsigned int realSample_denormal_mode_bits = 0;
+
+/* Cleared by benchmarks to measure the processing with denormals left on */
+static int realSample_flush_denormals_on = IS_TRUE;
+
+/*
+ * FUNCTION: realSample_GetDenormalModeBits()
+ * DESCRIPTION:
+ *   Returns the MXCSR bits to set. FTZ is always available with SSE, DAZ is missing on the
+ *   earliest SSE2 cpus and setting it there faults, so it is checked in the fxsave mask.
+ */
+static unsigned int realSample_GetDenormalModeBits(void)
+{
+#ifdef REALSAMPLE_DENORMALS_X86
+	/* Detection always gives the same answer, so a race on the first call is harmless */
+	if( realSample_denormal_mode_bits == 0 )
+	{
+		unsigned int mode_bits = REALSAMPLE_MXCSR_FTZ;
+		unsigned int mxcsr_mask;
+
+#ifdef _MSC_VER
+		__declspec(align(16)) unsigned char fxsave_area[512];
+		_fxsave(fxsave_area);
+#else
+		unsigned char fxsave_area[512] __attribute__((aligned(16)));
+		__asm__ __volatile__("fxsave %0" : "=m"(fxsave_area));
+#endif
+		/* A zero mask means the default mask, which has no DAZ */
+		mxcsr_mask = *(unsigned int *)(fxsave_area + 28);
+		if( mxcsr_mask & REALSAMPLE_MXCSR_DAZ )
+			mode_bits |= REALSAMPLE_MXCSR_DAZ;
+
+		realSample_denormal_mode_bits = mode_bits;
+	}
+#endif
+
+	return(realSample_denormal_mode_bits);
+}
+
+/*
+ * FUNCTION: realSampleFlushDenormalsBegin()
+ * DESCRIPTION:
+ *   Turns on FTZ and DAZ for the calling thread and returns the previous mode in
+ *   uip_saved_mode, to be passed to realSampleFlushDenormalsEnd().
+ */
+int PT_DECLSPEC realSampleFlushDenormalsBegin(unsigned int *uip_saved_mode)
+{
+	if (uip_saved_mode == NULL)
+		return(NOT_OKAY);
+
+#ifdef REALSAMPLE_DENORMALS_X86
+	*uip_saved_mode = _mm_getcsr();
+
+	if( realSample_flush_denormals_on )
+		_mm_setcsr(*uip_saved_mode | realSample_GetDenormalModeBits());
+#else
+	*uip_saved_mode = 0;
+#endif
+
+	return(OKAY);
+}
+
+/*
+ * FUNCTION: realSampleFlushDenormalsEnd()
+ * DESCRIPTION:
+ *   Restores the mode saved by realSampleFlushDenormalsBegin().
+ */
+int PT_DECLSPEC realSampleFlushDenormalsEnd(unsigned int ui_saved_mode)
+{
+#ifdef REALSAMPLE_DENORMALS_X86
+	_mm_setcsr(ui_saved_mode);
+#endif
+
+	return(OKAY);
+}
+
+/*
+ * FUNCTION: realSampleSetFlushDenormals()
+ * DESCRIPTION:
+ *   Enables or disables the FTZ/DAZ mode for all processing calls. Intended for benchmarking
+ *   and verification.
+ */
+int PT_DECLSPEC realSampleSetFlushDenormals(int i_on)
+{
+	realSample_flush_denormals_on = i_on ? IS_TRUE : IS_FALSE;
+
+	return(OKAY);
+}
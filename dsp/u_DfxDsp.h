@@ -16,6 +16,7 @@ You should have received a copy of the GNU Affero General Public License
 along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 #pragma once
+#include <atomic>
 #include <string>
 #include "AudioPassthru.h"
 #include "codedefs.h"
@@ -78,7 +79,9 @@ public:
 	DfxDspPrivate();
 	~DfxDspPrivate();
 	int processAudio(short int *si_input_samples, short int *si_output_samples, int i_num_sample_sets, int i_check_for_duplicate_buffers);
+	int processAudio(float *fp_samples, int i_num_sample_sets, int i_check_for_duplicate_buffers);
 	int setSignalFormat(int i_bps, int i_nch, int i_srate, int i_valid_bits);
+	int setMaxBlockSize(int i_max_sample_sets);
 	int loadPreset(std::wstring preset_file_full_path);
 	int savePreset(std::wstring preset_name, std::wstring preset_file_full_path);
 	int exportPreset(std::wstring preset_source_file_full_path, std::wstring preset_name, std::wstring preset_export_path);
@@ -98,7 +101,16 @@ public:
 	unsigned long getTotalAudioProcessedTime();
 	void resetTotalAudioProcessedTime();
     void getSpectrumBandValues(float* rp_band_values, int i_array_size);
+    int setSpectrumNumBands(int num_bands);
 	void setVolumeNormalization(float target_rms);
+	int loadHrirSet(std::wstring hrir_file_full_path);
+	void truePeakOn(bool on);
+	bool isTruePeakOn();
+	void vocalReductionOn(bool on);
+	bool isVocalReductionOn();
+	void parallelSurroundOn(bool on);
+	bool isParallelSurroundOn();
+	int getLimiterLatency();
 
 	bool being_destroyed_ = false;
 private:
@@ -134,7 +146,8 @@ private:
 	struct dfxg_section_type dynamic_boost_;
 	struct dfxg_section_type bass_boost_;
 
-	bool update_from_registry_ = true;
+	std::atomic<bool> update_from_registry_{ true }; /* Cleared by loadPreset() on the UI thread, read by processTimer() */
+	unsigned long session_generation_ = 0;
 	int headphone_on_;
 	int music_mode_;     /* DFXP_MUSIC_MODE_MUSIC1, DFXP_MUSIC_MODE_MUSIC2, DFXP_MUSIC_MODE_SPEECH */
 
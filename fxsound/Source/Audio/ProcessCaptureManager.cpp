@@ -20,6 +20,8 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "DfxDsp.h"
 #include <atlbase.h>
 #include <avrt.h>
+#include <ksmedia.h>
+#include <mmreg.h>
 #include <iostream>
 
 #define MIXER_BUFFER_SIZE 204800 // 200KB buffer
@@ -163,6 +165,11 @@ void ProcessCaptureManager::RenderThreadImpl()
     hr = m_renderClient->GetBufferSize(&bufferFrameCount);
     if (FAILED(hr)) return;
 
+    // The shared mode mix format is normally 32 bit float, which is processed in place without a copy
+    bool renderIsFloat = (m_renderWaveFormat->wFormatTag == WAVE_FORMAT_IEEE_FLOAT) ||
+        ((m_renderWaveFormat->wFormatTag == WAVE_FORMAT_EXTENSIBLE) &&
+         IsEqualGUID(reinterpret_cast<WAVEFORMATEXTENSIBLE*>(m_renderWaveFormat)->SubFormat, KSDATAFORMAT_SUBTYPE_IEEE_FLOAT));
+
     bool stillPlaying = true;
     while (stillPlaying)
     {
@@ -197,8 +204,10 @@ void ProcessCaptureManager::RenderThreadImpl()
                     if (m_dspModule && FxModel::getModel().getPowerState())
                     {
                         int numSampleSets = bytesToProcess / m_renderWaveFormat->nBlockAlign;
-                        // Assuming the DSP works in-place on a buffer of short ints
-                        m_dspModule->processAudio((short int*)pData, (short int*)pData, numSampleSets, false);
+                        if (renderIsFloat)
+                            m_dspModule->processAudio(reinterpret_cast<float*>(pData), numSampleSets, false);
+                        else
+                            m_dspModule->processAudio((short int*)pData, (short int*)pData, numSampleSets, false);
                     }
 
                     m_mixerBufferReadPosition += bytesToProcess;
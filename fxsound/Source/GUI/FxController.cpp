@@ -1613,6 +1613,8 @@ void FxController::getSpectrumBandValues(Array<float>& band_values)
 {
     float values[NUM_SPECTRUM_BANDS] = { 0 };
 
+    // Latest complete frame handed over by the engine, never waits on the audio thread.
+    // Only called from the message thread, the engine supports a single reader.
     dfx_dsp_.getSpectrumBandValues(values, NUM_SPECTRUM_BANDS);
 
     band_values.clearQuick();